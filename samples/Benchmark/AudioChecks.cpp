@@ -0,0 +1,316 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "Benchmark.h"
+#include "FlowCtrlCallbacks.h"
+
+#include "sdk/transports/transport-amd/AudioRedundancy.h"
+#include "sdk/transports/transport-amd/messages/audio/AudioData.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ssdk;
+using namespace ssdk::transport_amd;
+
+//-------------------------------------------------------------------------------------------------
+// AudioRedundancy - redundant audio frames over a loss trace and the order of audio messages
+//-------------------------------------------------------------------------------------------------
+namespace
+{
+    //  Client end of the audio loss trace: runs AUDIO_OUT data messages through AudioLossRecovery
+    //  as ClientTransportImpl::OnAudioOutData() does and records the frames played, in order
+    class AudioFramePlayer :
+        public FlowCtrlProtocol::ProcessIncomingCallback
+    {
+    public:
+        virtual void OnCompleteMessage(FlowCtrlProtocol::MessageID /*msgID*/, const void* buf, size_t size, const net::Socket::Address& /*receivedFrom*/, uint8_t /*optional*/) override
+        {
+            AudioData audioData;
+            if (audioData.ParseBuffer(buf, size) == false)
+            {
+                ++m_Invalid;
+                return;
+            }
+            std::vector<int64_t> redundantSequenceNumbers;
+            for (const AudioData::RedundantBlock& block : audioData.GetRedundantBlocks())
+            {
+                redundantSequenceNumbers.push_back(block.sequenceNumber);
+            }
+            std::vector<size_t> recover;
+            bool deliverPrimary = m_Recovery.OnFrame(audioData.GetSequenceNumber(), audioData.GetDiscontinuity(), redundantSequenceNumbers, recover);
+            for (size_t idx : recover)
+            {
+                m_Played.push_back(redundantSequenceNumbers[idx]);
+            }
+            if (deliverPrimary == true)
+            {
+                m_Played.push_back(audioData.GetSequenceNumber());
+            }
+        }
+        //  Retransmissions are never answered, at 20 ms frames they would come too late to be played anyway
+        virtual net::Socket::Result OnRequestFragment(const FlowCtrlProtocol::Fragment& /*fragment*/) override { ++m_Requests; return net::Socket::Result::OK; }
+
+        AudioLossRecovery       m_Recovery;
+        std::vector<int64_t>    m_Played;
+        int64_t                 m_Invalid = 0;
+        int64_t                 m_Requests = 0;
+    };
+
+    //  Records the second byte of every message delivered, the first one is the opcode
+    class MessageOrderRecorder :
+        public FlowCtrlProtocol::ProcessIncomingCallback
+    {
+    public:
+        virtual void OnCompleteMessage(FlowCtrlProtocol::MessageID /*msgID*/, const void* buf, size_t size, const net::Socket::Address& /*receivedFrom*/, uint8_t /*optional*/) override
+        {
+            m_Delivered.push_back(size > 1 ? static_cast<const uint8_t*>(buf)[1] : 0xFF);
+        }
+        virtual net::Socket::Result OnRequestFragment(const FlowCtrlProtocol::Fragment& /*fragment*/) override { return net::Socket::Result::OK; }
+
+        std::vector<uint8_t>    m_Delivered;
+    };
+}
+
+//  Audio frames with two redundant copies each, sent through the flow control over a Gilbert-Elliott loss trace.
+//  Every frame that arrives must be played right away instead of waiting out the gap in front of it,
+//  and every lost frame within the redundancy depth of the next frame that arrives must be recovered
+static void CheckAudioRedundancyLossTrace(BenchmarkState& state)
+{
+    static constexpr const size_t REDUNDANCY = 2;
+    static constexpr const int64_t FRAMES = 3000;
+    static constexpr const amf_pts FRAME_DURATION = 20 * AMF_MILLISECOND;
+    static constexpr const size_t FRAME_SIZE = 160;     //  64 kbps at 20 ms frames
+
+    while (state.KeepRunning() == true)
+    {
+        //  Good to bad with 5%, bad to good with 50%: about 9% loss in bursts of 2 frames on average
+        std::mt19937 generator(2198);
+        std::bernoulli_distribution enterBurst(0.05);
+        std::bernoulli_distribution leaveBurst(0.5);
+        std::vector<bool> lost(FRAMES, false);
+        bool burst = false;
+        for (int64_t i = 1; i < FRAMES; ++i)    //  The first frame always arrives, the receiver starts counting from it
+        {
+            burst = burst == true ? leaveBurst(generator) == false : enterBurst(generator) == true;
+            lost[i] = burst;
+        }
+
+        AudioRedundancyHistory history;
+        history.SetDepth(REDUNDANCY);
+        FlowCtrlProtocol sender(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+        FlowCtrlProtocol receiver(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+        receiver.SetReorderableOpCode(AUDIO_CHANNEL_ID, static_cast<int16_t>(AUDIO_OP_CODE::DATA));     //  As the client does when the server advertises redundancy
+        FragmentCollector collector;
+        AudioFramePlayer player;
+        net::Socket::IPv4Address from("127.0.0.1", 1235);
+        std::vector<uint8_t> frame(FRAME_SIZE);
+        int64_t lostFrames = 0;
+        int64_t recoverable = 0;
+        int64_t run = 0;
+        bool failed = false;
+        for (int64_t i = 0; i < FRAMES && failed == false; ++i)
+        {
+            std::fill(frame.begin(), frame.end(), uint8_t(i));
+            amf_pts pts = i * FRAME_DURATION;
+            history.Push(i, pts, FRAME_DURATION, frame.data(), frame.size());
+            AudioRedundancyHistory::Frames frames;
+            history.Collect(i, frames);
+            AudioData::RedundantBlocks redundantBlocks;
+            std::vector<uint8_t> message;
+            for (const AudioRedundancyHistory::Frame* redundant : frames)
+            {
+                redundantBlocks.push_back({ redundant->sequenceNumber, redundant->pts, redundant->duration, uint32_t(redundant->payload.size()) });
+            }
+            AudioData audioData(pts, FRAME_DURATION, uint32_t(frame.size()), i, false, transport_common::DEFAULT_STREAM, redundantBlocks);
+            const uint8_t* header = static_cast<const uint8_t*>(audioData.GetSendData());
+            message.insert(message.end(), header, header + audioData.GetSendSize());
+            message.push_back(0);
+            message.insert(message.end(), frame.begin(), frame.end());
+            for (const AudioRedundancyHistory::Frame* redundant : frames)
+            {
+                message.insert(message.end(), redundant->payload.begin(), redundant->payload.end());
+            }
+
+            collector.m_Datagrams.clear();
+            uint32_t bytesSent = 0;
+            sender.FragmentMessage(message.data(), uint32_t(message.size()), DATAGRAM_SIZE, AUDIO_CHANNEL_ID, collector, bytesSent);
+            if (lost[i] == true)
+            {
+                ++lostFrames;
+                ++run;
+                continue;
+            }
+            recoverable += int64_t(std::min(size_t(run), REDUNDANCY));
+            run = 0;
+            for (const std::vector<uint8_t>& datagram : collector.m_Datagrams)
+            {
+                receiver.ProcessFragment(datagram.data(), uint32_t(datagram.size()), from, player);
+            }
+            if (player.m_Played.empty() == true || player.m_Played.back() != i)
+            {
+                state.SkipWithError("frame " + std::to_string(i) + " was not played when it arrived");
+                failed = true;
+            }
+        }
+        if (failed == true)
+        {
+            break;
+        }
+        if (player.m_Invalid != 0)
+        {
+            state.SkipWithError("audio messages did not parse");
+            break;
+        }
+        for (size_t i = 1; i < player.m_Played.size(); ++i)
+        {
+            if (player.m_Played[i] <= player.m_Played[i - 1])
+            {
+                state.SkipWithError("frames were played out of order or twice");
+                failed = true;
+                break;
+            }
+        }
+        if (failed == true)
+        {
+            break;
+        }
+        const AudioLossRecovery::Stats& stats = player.m_Recovery.GetStats();
+        if (stats.recovered != recoverable || int64_t(player.m_Played.size()) != FRAMES - lostFrames + recoverable)
+        {
+            state.SkipWithError("recovered " + std::to_string(stats.recovered) + " lost frames, expected " + std::to_string(recoverable));
+            break;
+        }
+        char label[128] = {};
+        snprintf(label, sizeof(label), "%lld of %lld lost frames recovered (%.1f%%), %.1f%% loss",
+                 (long long)stats.recovered, (long long)lostFrames, lostFrames > 0 ? 100.0 * stats.recovered / lostFrames : 100.0, 100.0 * lostFrames / FRAMES);
+        state.SetLabel(label);
+    }
+}
+
+//  Audio data may skip a gap only on a receiver that enabled it: AudioInit and the messages behind it stay in order,
+//  data delivered ahead is not delivered again, and a frame arriving after a later one is dropped by AudioLossRecovery
+static void CheckAudioRedundancyInitOrder(BenchmarkState& state)
+{
+    class Scenario
+    {
+    public:
+        const char*             m_Name;
+        bool                    m_Reorderable;
+        std::vector<uint8_t>    m_Expected;
+    };
+    //  Messages 0..5: data, init (lost, retransmitted after message 4), data, init, data, data. Message 2 is received twice
+    static const AUDIO_OP_CODE opCodes[] = { AUDIO_OP_CODE::DATA, AUDIO_OP_CODE::INIT, AUDIO_OP_CODE::DATA, AUDIO_OP_CODE::INIT, AUDIO_OP_CODE::DATA, AUDIO_OP_CODE::DATA };
+    static const size_t arrivals[] = { 0, 2, 3, 4, 1, 2, 5 };
+    static const Scenario scenarios[] =
+    {
+        { "in order",       false,  { 0, 1, 2, 3, 4, 5 } },
+        { "reorderable",    true,   { 0, 2, 1, 3, 4, 5 } },
+    };
+
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        for (const Scenario& scenario : scenarios)
+        {
+            FlowCtrlProtocol sender(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+            FlowCtrlProtocol receiver(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+            if (scenario.m_Reorderable == true)
+            {
+                receiver.SetReorderableOpCode(AUDIO_CHANNEL_ID, static_cast<int16_t>(AUDIO_OP_CODE::DATA));
+            }
+            std::vector<std::vector<uint8_t>> datagrams;
+            for (size_t i = 0; i < amf_countof(opCodes); ++i)
+            {
+                uint8_t message[] = { static_cast<uint8_t>(opCodes[i]), uint8_t(i) };
+                FragmentCollector collector;
+                uint32_t bytesSent = 0;
+                sender.FragmentMessage(message, uint32_t(sizeof(message)), DATAGRAM_SIZE, AUDIO_CHANNEL_ID, collector, bytesSent);
+                datagrams.push_back(collector.m_Datagrams.front());
+            }
+            MessageOrderRecorder recorder;
+            net::Socket::IPv4Address from("127.0.0.1", 1235);
+            for (size_t idx : arrivals)
+            {
+                receiver.ProcessFragment(datagrams[idx].data(), uint32_t(datagrams[idx].size()), from, recorder);
+                if (idx == 4 && std::find(recorder.m_Delivered.begin(), recorder.m_Delivered.end(), 4) != recorder.m_Delivered.end())
+                {
+                    state.SkipWithError(std::string(scenario.m_Name) + ": data overtook the init waiting for the lost one");
+                    failed = true;
+                    break;
+                }
+            }
+            if (failed == false && recorder.m_Delivered != scenario.m_Expected)
+            {
+                std::string delivered;
+                for (uint8_t idx : recorder.m_Delivered)
+                {
+                    delivered += std::to_string(idx) + " ";
+                }
+                state.SkipWithError(std::string(scenario.m_Name) + ": messages delivered as " + delivered);
+                failed = true;
+            }
+            if (failed == true)
+            {
+                break;
+            }
+        }
+        if (failed == true)
+        {
+            break;
+        }
+
+        //  Frame 1 is lost without a redundant copy and comes after frame 2: it was concealed by then
+        AudioLossRecovery recovery;
+        std::vector<size_t> recover;
+        if (recovery.OnFrame(0, false, {}, recover) == false || recovery.OnFrame(2, false, {}, recover) == false ||
+            recovery.OnFrame(1, false, {}, recover) == true || recovery.OnFrame(3, false, {}, recover) == false)
+        {
+            state.SkipWithError("a frame arriving after a later one was played");
+            failed = true;
+        }
+    }
+    state.SetLabel("audio data past gaps, init in order");
+}
+
+void RegisterAudioChecks(BenchmarkRunner& runner)
+{
+    runner.RegisterCheck("Check/AudioRedundancy/LossTrace", CheckAudioRedundancyLossTrace);
+    runner.RegisterCheck("Check/AudioRedundancy/InitOrder", CheckAudioRedundancyInitOrder);
+}
@@ -0,0 +1,189 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "Benchmark.h"
+
+#include "amf/public/common/AMFFactory.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#include <iostream>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"Benchmark";
+
+//  Command line parameters
+static constexpr const wchar_t* PARAM_NAME_LOGFILE = L"LOGFILE";
+static constexpr const wchar_t* PARAM_NAME_FILTER = L"Filter";
+static constexpr const wchar_t* PARAM_NAME_MIN_TIME = L"MinTime";
+static constexpr const wchar_t* PARAM_NAME_JSON = L"Json";
+static constexpr const wchar_t* PARAM_NAME_LIST = L"List";
+
+// Default parameter values
+static constexpr const wchar_t* DEFAULT_LOG_FILENAME = L"./ssdk_bench.log";
+static constexpr const int64_t  DEFAULT_MIN_TIME = 500;     //  ms
+
+Benchmark::Benchmark()
+{
+    SetParamDescription(PARAM_NAME_LOGFILE, ParamCommon, L"Specify log file path, null - no log, default = ./ssdk_bench.log", nullptr);
+    SetParamDescription(PARAM_NAME_FILTER, ParamCommon, L"Run only the benchmarks whose name contains the string, e.g. FlowCtrl/ or Check/ for the functional checks, default = all", nullptr);
+    SetParamDescription(PARAM_NAME_MIN_TIME, ParamCommon, L"Minimum time to run each benchmark for in ms, default = 500", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_JSON, ParamCommon, L"Save the results to a JSON file in the google-benchmark format, default = none", nullptr);
+    SetParamDescription(PARAM_NAME_LIST, ParamCommon, L"List the benchmarks without running them (true, false), default = false", ParamConverterBoolean);
+}
+
+Benchmark::~Benchmark()
+{
+    Terminate();
+}
+
+bool Benchmark::Init(int argc, const char** argv)
+{
+    bool result = false;
+    m_Executable = argc > 0 ? argv[0] : "ssdk_bench";
+    if (InitAMF() != true)
+    {
+        std::cerr << "Failed to initialize AMF runtime\n";
+    }
+    else if (parseCmdLineParameters(this, argc, const_cast<char**>(argv)) != true)
+    {
+        AMFTraceError(AMF_FACILITY, L"Failed to parse command line parameters");
+    }
+    else
+    {
+        std::wstring logFilePath = DEFAULT_LOG_FILENAME;
+        GetParamWString(PARAM_NAME_LOGFILE, logFilePath);
+        if (logFilePath != L"null")
+        {
+            if (logFilePath.length() != 0)
+            {
+                g_AMFFactory.GetTrace()->SetPath(logFilePath.c_str());
+            }
+            g_AMFFactory.GetTrace()->EnableWriter(AMF_TRACE_WRITER_FILE, true);
+        }
+        else
+        {
+            g_AMFFactory.GetTrace()->EnableWriter(AMF_TRACE_WRITER_FILE, false);
+        }
+
+        std::string filter;
+        GetParamString(PARAM_NAME_FILTER, filter);
+        m_Runner.SetFilter(filter);
+        int64_t minTime = DEFAULT_MIN_TIME;
+        GetParam(PARAM_NAME_MIN_TIME, minTime);
+        m_Runner.SetMinTime(double(minTime > 0 ? minTime : DEFAULT_MIN_TIME) / 1000.0);
+        GetParamString(PARAM_NAME_JSON, m_JSONFileName);
+        GetParam(PARAM_NAME_LIST, m_ListOnly);
+
+        RegisterProtocolBenchmarks(m_Runner);
+        RegisterMessageBenchmarks(m_Runner);
+        RegisterAudioChecks(m_Runner);
+        RegisterSendQueueChecks(m_Runner);
+        RegisterStreamCaptureChecks(m_Runner);
+        RegisterDatagramChecks(m_Runner);
+        RegisterSharedMemoryChecks(m_Runner);
+        RegisterUtilBenchmarks(m_Runner, m_Context);
+        RegisterServerBenchmarks(m_Runner);
+        RegisterTransportChecks(m_Runner, m_Context);
+        result = true;
+    }
+    return result;
+}
+
+void Benchmark::Terminate()
+{
+    TerminateAMF();
+}
+
+bool Benchmark::Run()
+{
+    if (m_ListOnly == true)
+    {
+        m_Runner.List();
+        return true;
+    }
+    m_Runner.Run();
+    if (m_JSONFileName.empty() == false && m_Runner.SaveJSON(m_JSONFileName, m_Executable) == false)
+    {
+        std::cerr << "Failed to save results to " << m_JSONFileName << "\n";
+        return false;
+    }
+    size_t failures = m_Runner.GetFailureCount();
+    if (failures > 0)
+    {
+        std::cerr << failures << " benchmark(s) or check(s) failed\n";
+        return false;
+    }
+    return true;
+}
+
+bool Benchmark::InitAMF()
+{
+    bool result = false;
+    AMF_RESULT amfResult = g_AMFFactory.Init();
+    if (amfResult == AMF_OK)
+    {
+        //  Traces on the measured paths would be measured too, only warnings and errors are let through
+        g_AMFFactory.GetDebug()->AssertsEnable(false);
+        g_AMFFactory.GetTrace()->TraceEnableAsync(true);
+        g_AMFFactory.GetTrace()->SetGlobalLevel(AMF_TRACE_WARNING);
+        g_AMFFactory.GetTrace()->SetWriterLevel(AMF_TRACE_WRITER_FILE, AMF_TRACE_WARNING);
+        g_AMFFactory.GetTrace()->EnableWriter(AMF_TRACE_WRITER_CONSOLE, false);     //  Console is used for results
+        g_AMFFactory.GetTrace()->SetWriterLevel(AMF_TRACE_WRITER_DEBUG_OUTPUT, AMF_TRACE_WARNING);
+
+        amfResult = g_AMFFactory.GetFactory()->CreateContext(&m_Context);
+        if (m_Context == nullptr)
+        {
+            AMFTraceError(AMF_FACILITY, L"Failed to create AMFContext, result=%s", amf::AMFGetResultText(amfResult));
+        }
+        else
+        {
+            amf_increase_timer_precision();
+            m_AMFInitalized = true;
+            result = true;
+        }
+    }
+    return result;
+}
+
+void Benchmark::TerminateAMF()
+{
+    if (m_AMFInitalized == true)
+    {
+        amf_restore_timer_precision();
+        m_Context = nullptr;
+        g_AMFFactory.Terminate();
+        m_AMFInitalized = false;
+    }
+}
@@ -0,0 +1,88 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include "BenchmarkRunner.h"
+
+#include "amf/public/include/core/Context.h"
+#include "amf/public/samples/CPPSamples/common/CmdLineParser.h"
+
+#include <memory>
+#include <string>
+
+//  ssdk_bench: microbenchmarks of the transport, crypto and pipeline hot paths. Runs on the CPU only,
+//  a GPU is not required, and saves the results as JSON for regression tracking. Also runs the functional
+//  checks named Check/..., exits with an error when any of them fails
+class Benchmark :
+    public ParametersStorage
+{
+public:
+    typedef std::unique_ptr<Benchmark>  Ptr;
+
+public:
+    Benchmark();
+    virtual ~Benchmark();
+
+    bool Init(int argc, const char** argv);
+    void Terminate();
+
+    bool Run();
+
+protected:
+    bool InitAMF();
+    void TerminateAMF();
+
+private:
+    amf::AMFContextPtr  m_Context;
+    bool                m_AMFInitalized = false;
+    BenchmarkRunner     m_Runner;
+    std::string         m_Executable;
+    std::string         m_JSONFileName;
+    bool                m_ListOnly = false;
+};
+
+//  Benchmark groups, each one registers its benchmarks with the runner
+void RegisterProtocolBenchmarks(BenchmarkRunner& runner);
+void RegisterMessageBenchmarks(BenchmarkRunner& runner);
+void RegisterAudioChecks(BenchmarkRunner& runner);
+void RegisterSendQueueChecks(BenchmarkRunner& runner);
+void RegisterStreamCaptureChecks(BenchmarkRunner& runner);
+void RegisterDatagramChecks(BenchmarkRunner& runner);
+void RegisterSharedMemoryChecks(BenchmarkRunner& runner);
+void RegisterUtilBenchmarks(BenchmarkRunner& runner, amf::AMFContext* context);
+void RegisterServerBenchmarks(BenchmarkRunner& runner);
+void RegisterTransportChecks(BenchmarkRunner& runner, amf::AMFContext* context);
@@ -0,0 +1,395 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "BenchmarkRunner.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+static constexpr const int64_t MAX_ITERATIONS = 1000000000;
+
+//-------------------------------------------------------------------------------------------------
+// AllocationCounter - the global operator new of ssdk_bench counts the allocations of every thread
+//-------------------------------------------------------------------------------------------------
+static thread_local int64_t t_AllocationCount = 0;
+static thread_local int64_t t_AllocatedBytes = 0;
+
+static void* CountedAllocate(size_t size) noexcept
+{
+    ++t_AllocationCount;
+    t_AllocatedBytes += int64_t(size);
+    return malloc(size != 0 ? size : 1);
+}
+
+static void* CountedAllocateOrThrow(size_t size)
+{
+    void* memory = CountedAllocate(size);
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new(size_t size) { return CountedAllocateOrThrow(size); }
+void* operator new[](size_t size) { return CountedAllocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t) noexcept { free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { free(memory); }
+
+AllocationCounter::AllocationCounter() noexcept
+{
+    Reset();
+}
+
+void AllocationCounter::Reset() noexcept
+{
+    m_Count = t_AllocationCount;
+    m_Bytes = t_AllocatedBytes;
+}
+
+int64_t AllocationCounter::GetCount() const noexcept
+{
+    return t_AllocationCount - m_Count;
+}
+
+int64_t AllocationCounter::GetBytes() const noexcept
+{
+    return t_AllocatedBytes - m_Bytes;
+}
+
+//-------------------------------------------------------------------------------------------------
+// BenchmarkState
+//-------------------------------------------------------------------------------------------------
+BenchmarkState::BenchmarkState(int64_t arg, int64_t iterations) :
+    m_Arg(arg),
+    m_MaxIterations(iterations)
+{
+}
+
+bool BenchmarkState::KeepRunning()
+{
+    if (m_Started == false)
+    {
+        m_Started = true;
+        ResumeTiming();
+    }
+    if (m_Iterations < m_MaxIterations)
+    {
+        ++m_Iterations;
+        return true;
+    }
+    PauseTiming();
+    return false;
+}
+
+void BenchmarkState::PauseTiming()
+{
+    if (m_Running == true)
+    {
+        m_RealTime += GetRealClock() - m_RealStart;
+        m_CpuTime += GetCpuClock() - m_CpuStart;
+        m_Running = false;
+    }
+}
+
+void BenchmarkState::ResumeTiming()
+{
+    if (m_Running == false)
+    {
+        m_Running = true;
+        m_CpuStart = GetCpuClock();
+        m_RealStart = GetRealClock();
+    }
+}
+
+int64_t BenchmarkState::GetRealClock()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t BenchmarkState::GetCpuClock()
+{
+#ifdef _WIN32
+    return static_cast<int64_t>(std::clock()) * (1000000000 / CLOCKS_PER_SEC);
+#else
+    struct timespec ts = {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+//-------------------------------------------------------------------------------------------------
+// BenchmarkRunner
+//-------------------------------------------------------------------------------------------------
+void BenchmarkRunner::Register(const std::string& name, Function function, const std::vector<int64_t>& args)
+{
+    m_Benchmarks.push_back({ name, function, args });
+}
+
+void BenchmarkRunner::RegisterCheck(const std::string& name, Function function, const std::vector<int64_t>& args)
+{
+    m_Benchmarks.push_back({ name, function, args, true });
+}
+
+void BenchmarkRunner::List() const
+{
+    for (const Benchmark& benchmark : m_Benchmarks)
+    {
+        if (benchmark.m_Args.empty() == true)
+        {
+            printf("%s\n", benchmark.m_Name.c_str());
+        }
+        for (int64_t arg : benchmark.m_Args)
+        {
+            printf("%s/%lld\n", benchmark.m_Name.c_str(), static_cast<long long>(arg));
+        }
+    }
+}
+
+const BenchmarkRunner::Results& BenchmarkRunner::Run()
+{
+    m_Results.clear();
+    PrintHeader();
+    for (const Benchmark& benchmark : m_Benchmarks)
+    {
+        std::vector<int64_t> args = benchmark.m_Args;
+        if (args.empty() == true)
+        {
+            args.push_back(0);
+        }
+        for (int64_t arg : args)
+        {
+            std::string name = benchmark.m_Name;
+            if (benchmark.m_Args.empty() == false)
+            {
+                name += "/" + std::to_string(arg);
+            }
+            if (m_Filter.empty() == false && name.find(m_Filter) == std::string::npos)
+            {
+                continue;
+            }
+            m_Results.push_back(benchmark.m_Check == true ? RunCheck(name, benchmark.m_Function, arg) : RunBenchmark(name, benchmark.m_Function, arg));
+            PrintResult(m_Results.back());
+        }
+    }
+    return m_Results;
+}
+
+size_t BenchmarkRunner::GetFailureCount() const
+{
+    size_t failures = 0;
+    for (const Result& result : m_Results)
+    {
+        failures += result.m_Error.empty() == false ? 1 : 0;
+    }
+    return failures;
+}
+
+BenchmarkRunner::Result BenchmarkRunner::RunCheck(const std::string& name, const Function& function, int64_t arg)
+{
+    Result result;
+    result.m_Name = name;
+    result.m_Check = true;
+    BenchmarkState state(arg, 1);
+    function(state);
+    result.m_Iterations = 1;
+    result.m_RealTime = double(state.GetRealTime());
+    result.m_CpuTime = double(state.GetCpuTime());
+    result.m_Label = state.GetLabel();
+    result.m_Error = state.GetError();
+    result.m_Skipped = state.GetSkipped();
+    return result;
+}
+
+BenchmarkRunner::Result BenchmarkRunner::RunBenchmark(const std::string& name, const Function& function, int64_t arg) const
+{
+    Result result;
+    result.m_Name = name;
+    const int64_t minTime = static_cast<int64_t>(m_MinTime * 1e9);
+    for (int64_t iterations = 1; ; )
+    {
+        BenchmarkState state(arg, iterations);
+        function(state);
+        if (state.GetError().empty() == false || state.GetSkipped().empty() == false)
+        {
+            result.m_Error = state.GetError();
+            result.m_Skipped = state.GetSkipped();
+            break;
+        }
+        int64_t realTime = state.GetRealTime();
+        if (realTime >= minTime || iterations >= MAX_ITERATIONS)
+        {
+            result.m_Iterations = iterations;
+            result.m_RealTime = double(realTime) / iterations;
+            result.m_CpuTime = double(state.GetCpuTime()) / iterations;
+            double seconds = double(realTime) / 1e9;
+            result.m_BytesPerSecond = seconds > 0 ? state.GetBytesProcessed() / seconds : 0;
+            result.m_ItemsPerSecond = seconds > 0 ? state.GetItemsProcessed() / seconds : 0;
+            result.m_Label = state.GetLabel();
+            break;
+        }
+        //  Aim 40% past the minimum time, growing at most 10x per attempt as google-benchmark does
+        double multiplier = realTime > 0 ? double(minTime) * 1.4 / double(realTime) : 10.0;
+        multiplier = multiplier > 10.0 ? 10.0 : (multiplier < 1.1 ? 2.0 : multiplier);
+        int64_t next = static_cast<int64_t>(double(iterations) * multiplier);
+        iterations = next > iterations ? (next < MAX_ITERATIONS ? next : MAX_ITERATIONS) : iterations + 1;
+    }
+    return result;
+}
+
+void BenchmarkRunner::PrintHeader()
+{
+    printf("%-48s %14s %14s %12s %16s %16s\n", "Benchmark", "Time, ns", "CPU, ns", "Iterations", "Bytes/s", "Items/s");
+    printf("%s\n", std::string(125, '-').c_str());
+}
+
+void BenchmarkRunner::PrintResult(const Result& result)
+{
+    if (result.m_Error.empty() == false)
+    {
+        printf("%-48s ERROR: %s\n", result.m_Name.c_str(), result.m_Error.c_str());
+        return;
+    }
+    if (result.m_Skipped.empty() == false)
+    {
+        printf("%-48s SKIPPED: %s\n", result.m_Name.c_str(), result.m_Skipped.c_str());
+        return;
+    }
+    if (result.m_Check == true)
+    {
+        printf("%-48s PASSED %s\n", result.m_Name.c_str(), result.m_Label.c_str());
+        fflush(stdout);
+        return;
+    }
+    printf("%-48s %14.1f %14.1f %12lld %15.3fM %15.3fM %s\n", result.m_Name.c_str(), result.m_RealTime, result.m_CpuTime,
+        static_cast<long long>(result.m_Iterations), result.m_BytesPerSecond / 1e6, result.m_ItemsPerSecond / 1e6, result.m_Label.c_str());
+    fflush(stdout);
+}
+
+std::string BenchmarkRunner::Escape(const std::string& text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+bool BenchmarkRunner::SaveJSON(const std::string& fileName, const std::string& executable) const
+{
+    std::ofstream file(fileName, std::ios::trunc);
+    if (file.is_open() == false)
+    {
+        return false;
+    }
+
+    char date[64] = {};
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    std::ostringstream json;
+    json.precision(17);
+    json << "{\n  \"context\": {\n";
+    json << "    \"date\": \"" << date << "\",\n";
+    json << "    \"executable\": \"" << Escape(executable) << "\",\n";
+    json << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    json << "    \"library_build_type\": \"release\"\n";
+#else
+    json << "    \"library_build_type\": \"debug\"\n";
+#endif
+    json << "  },\n  \"benchmarks\": [";
+    bool first = true;
+    for (const Result& result : m_Results)
+    {
+        if (result.m_Check == true || result.m_Skipped.empty() == false)
+        {   //  Only measurements are tracked for regressions
+            continue;
+        }
+        json << (first == true ? "\n" : ",\n") << "    {\n";
+        first = false;
+        json << "      \"name\": \"" << Escape(result.m_Name) << "\",\n";
+        json << "      \"run_name\": \"" << Escape(result.m_Name) << "\",\n";
+        json << "      \"run_type\": \"iteration\",\n";
+        if (result.m_Error.empty() == false)
+        {
+            json << "      \"error_occurred\": true,\n";
+            json << "      \"error_message\": \"" << Escape(result.m_Error) << "\"\n    }";
+            continue;
+        }
+        json << "      \"iterations\": " << result.m_Iterations << ",\n";
+        json << "      \"real_time\": " << result.m_RealTime << ",\n";
+        json << "      \"cpu_time\": " << result.m_CpuTime << ",\n";
+        json << "      \"time_unit\": \"ns\"";
+        if (result.m_BytesPerSecond > 0)
+        {
+            json << ",\n      \"bytes_per_second\": " << result.m_BytesPerSecond;
+        }
+        if (result.m_ItemsPerSecond > 0)
+        {
+            json << ",\n      \"items_per_second\": " << result.m_ItemsPerSecond;
+        }
+        if (result.m_Label.empty() == false)
+        {
+            json << ",\n      \"label\": \"" << Escape(result.m_Label) << "\"";
+        }
+        json << "\n    }";
+    }
+    json << "\n  ]\n}\n";
+    file << json.str();
+    return file.good();
+}
@@ -0,0 +1,184 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+//  BenchmarkState - passed to the body of a benchmark, which runs the measured code while KeepRunning() returns true:
+//
+//      void FragmentMessage(BenchmarkState& state)
+//      {
+//          <setup, not measured>
+//          while (state.KeepRunning() == true)
+//          {
+//              <measured code>
+//          }
+//          state.SetBytesProcessed(state.GetIterations() * state.GetArg());
+//      }
+//
+//  A check registered with BenchmarkRunner::RegisterCheck() has the same signature and runs exactly one iteration.
+//  It reports a failure with SkipWithError(), which makes ssdk_bench exit with an error, so checks can run under ctest
+class BenchmarkState
+{
+public:
+    BenchmarkState(int64_t arg, int64_t iterations);
+
+    bool KeepRunning();
+
+    //  Exclude per-iteration setup from the measurement
+    void PauseTiming();
+    void ResumeTiming();
+
+    inline int64_t GetArg() const noexcept { return m_Arg; }
+    inline int64_t GetIterations() const noexcept { return m_MaxIterations; }
+
+    inline void SetBytesProcessed(int64_t bytes) noexcept { m_BytesProcessed = bytes; }
+    inline void SetItemsProcessed(int64_t items) noexcept { m_ItemsProcessed = items; }
+    inline void SetLabel(const std::string& label) { m_Label = label; }
+    inline void SkipWithError(const std::string& error) { m_Error = error; m_Iterations = m_MaxIterations; }
+    inline void SkipWithMessage(const std::string& message) { m_Skipped = message; m_Iterations = m_MaxIterations; }  //  Not a failure, e.g. a feature the OS lacks
+
+    //  Keeps the compiler from optimizing away a result which is not used otherwise
+    template<typename T>
+    static inline void DoNotOptimize(const T& value) { static_cast<void>(*reinterpret_cast<const volatile char*>(&value)); }
+
+    inline int64_t GetRealTime() const noexcept { return m_RealTime; }     //  ns
+    inline int64_t GetCpuTime() const noexcept { return m_CpuTime; }       //  ns
+    inline int64_t GetBytesProcessed() const noexcept { return m_BytesProcessed; }
+    inline int64_t GetItemsProcessed() const noexcept { return m_ItemsProcessed; }
+    inline const std::string& GetLabel() const noexcept { return m_Label; }
+    inline const std::string& GetError() const noexcept { return m_Error; }
+    inline const std::string& GetSkipped() const noexcept { return m_Skipped; }
+
+private:
+    static int64_t GetRealClock();
+    static int64_t GetCpuClock();
+
+private:
+    int64_t     m_Arg = 0;
+    int64_t     m_MaxIterations = 0;
+    int64_t     m_Iterations = 0;
+    bool        m_Started = false;
+    bool        m_Running = false;
+    int64_t     m_RealStart = 0;
+    int64_t     m_CpuStart = 0;
+    int64_t     m_RealTime = 0;
+    int64_t     m_CpuTime = 0;
+    int64_t     m_BytesProcessed = 0;
+    int64_t     m_ItemsProcessed = 0;
+    std::string m_Label;
+    std::string m_Error;
+    std::string m_Skipped;
+};
+
+//  AllocationCounter - counts the heap allocations the calling thread makes through operator new from its construction or
+//  the last Reset() on. ssdk_bench replaces the global operator new to count them, so the standard library, the SDK and the
+//  AMF helper code linked into ssdk_bench are counted, allocations made inside the AMF runtime are not
+class AllocationCounter
+{
+public:
+    AllocationCounter() noexcept;
+
+    void Reset() noexcept;
+    int64_t GetCount() const noexcept;
+    int64_t GetBytes() const noexcept;
+
+private:
+    int64_t     m_Count = 0;
+    int64_t     m_Bytes = 0;
+};
+
+//  BenchmarkRunner - a minimal in-tree replacement for google-benchmark. Every registered benchmark is run once per argument,
+//  the number of iterations grows until a run takes at least the minimum time. Results are printed to the console and
+//  optionally saved as JSON in the google-benchmark format, so that the existing tools can compare runs.
+class BenchmarkRunner
+{
+public:
+    typedef std::function<void(BenchmarkState&)> Function;
+
+    struct Result
+    {
+        std::string m_Name;
+        int64_t     m_Iterations = 0;
+        double      m_RealTime = 0;         //  ns per iteration
+        double      m_CpuTime = 0;          //  ns per iteration
+        double      m_BytesPerSecond = 0;
+        double      m_ItemsPerSecond = 0;
+        std::string m_Label;
+        std::string m_Error;
+        std::string m_Skipped;
+        bool        m_Check = false;
+    };
+    typedef std::vector<Result> Results;
+
+public:
+    BenchmarkRunner() = default;
+
+    void Register(const std::string& name, Function function, const std::vector<int64_t>& args = {});
+    void RegisterCheck(const std::string& name, Function function, const std::vector<int64_t>& args = {});    //  Runs once, see BenchmarkState
+
+    void SetFilter(const std::string& filter) { m_Filter = filter; }   //  Run only the benchmarks whose name contains the string
+    void SetMinTime(double seconds) { m_MinTime = seconds; }
+
+    void List() const;
+    const Results& Run();
+    size_t GetFailureCount() const;     //  Benchmarks and checks of the last Run() which reported an error
+    bool SaveJSON(const std::string& fileName, const std::string& executable) const;
+
+private:
+    Result RunBenchmark(const std::string& name, const Function& function, int64_t arg) const;
+    static Result RunCheck(const std::string& name, const Function& function, int64_t arg);
+    static void PrintHeader();
+    static void PrintResult(const Result& result);
+    static std::string Escape(const std::string& text);
+
+private:
+    struct Benchmark
+    {
+        std::string             m_Name;
+        Function                m_Function;
+        std::vector<int64_t>    m_Args;
+        bool                    m_Check = false;
+    };
+    std::vector<Benchmark>  m_Benchmarks;
+    std::string             m_Filter;
+    double                  m_MinTime = 0.5;
+    Results                 m_Results;
+};
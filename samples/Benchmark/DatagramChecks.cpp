@@ -0,0 +1,536 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "Benchmark.h"
+
+#include "sdk/transports/transport-amd/FlowCtrlProtocol.h"
+#include "sdk/transports/transport-amd/PathMtuDiscovery.h"
+#include "sdk/net/DatagramSocket.h"
+#include "sdk/net/ImpairedDatagramSocket.h"
+#include "sdk/net/NetworkImpairment.h"
+#include "sdk/net/Selector.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux)
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+using namespace ssdk;
+using namespace ssdk::transport_amd;
+
+//-------------------------------------------------------------------------------------------------
+// PathMtuDiscovery - the probe search through a relay which drops what does not fit the path
+//-------------------------------------------------------------------------------------------------
+//  The server sends its probes over UDP loopback to a relay, which forwards the datagrams that fit the path MTU and drops
+//  the rest along with a share of all datagrams in both directions. The client acknowledges every probe it receives as
+//  the flow control protocol does. The state machine runs on a simulated clock which jumps to the probe deadline when
+//  nothing comes back, so timeouts cost no real time. The search has to settle within SEARCH_GRANULARITY below the path
+//  MTU, on a new path MTU after a black hole, and on MIN_PLPMTU when even the base does not get through.
+class RelayPath
+{
+public:
+    const char* m_Name = "";
+    size_t      m_PathMtu = 0;
+    double      m_Loss = 0;
+    size_t      m_NewPathMtu = 0;       //  The route changes to this path MTU once the search is complete, 0 - never
+};
+
+//  Receives one datagram within the timeout, returns its size or 0
+static size_t ReceiveRelayed(net::DatagramSocket* socket, std::vector<uint8_t>& buffer)
+{
+    static constexpr const int RELAY_TIMEOUT_MS = 10;      //  Loopback delivers at once, anything later is lost
+
+    struct timeval timeout = { 0, RELAY_TIMEOUT_MS * 1000 };
+    net::Selector selector;
+    net::Socket::Set readable;
+    selector.AddReadableSocket(socket);
+    size_t bytes = 0;
+    net::Socket::IPv4Address from;
+    if (selector.WaitToRead(timeout, readable) != net::Selector::Result::OK ||
+        socket->ReceiveFrom(buffer.data(), buffer.size(), &from, &bytes) != net::Socket::Result::OK)
+    {
+        bytes = 0;
+    }
+    return bytes;
+}
+
+static net::Socket::IPv4Address GetBoundAddress(net::DatagramSocket* socket)
+{
+    sockaddr_in local = {};
+    socklen_t localSize = sizeof(local);
+    getsockname(socket->GetNativeHandle(), reinterpret_cast<sockaddr*>(&local), &localSize);
+    return net::Socket::IPv4Address(local);
+}
+
+static void CheckPathMtuDiscoveryRelay(BenchmarkState& state)
+{
+    static constexpr const amf_pts MAX_SEARCH_TIME = 60 * AMF_SECOND;
+    static constexpr const amf_pts ROUND_TRIP = AMF_MILLISECOND;
+    static const RelayPath PATHS[] = {
+        { "Ethernet", 1472, 0, 0 },
+        { "PPPoE, 5% loss", 1464, 0.05, 0 },
+        { "jumbo frames, 2% loss", PathMtuDiscovery::MAX_PLPMTU, 0.02, 0 },
+        { "route change to a VPN", 1472, 0, 1372 },
+        { "tunnel below the base", 1100, 0, 0 },
+    };
+
+    net::DatagramSocket::Ptr server(new net::DatagramSocket());
+    net::DatagramSocket::Ptr relay(new net::DatagramSocket());
+    net::DatagramSocket::Ptr client(new net::DatagramSocket());
+    if (server->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK ||
+        relay->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK ||
+        client->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK)
+    {
+        state.SkipWithError("Bind() failed");
+        return;
+    }
+    const net::Socket::IPv4Address serverAddress = GetBoundAddress(server);
+    const net::Socket::IPv4Address relayAddress = GetBoundAddress(relay);
+    const net::Socket::IPv4Address clientAddress = GetBoundAddress(client);
+    std::vector<uint8_t> buffer(PathMtuDiscovery::MAX_PLPMTU + 1024);
+
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        std::string report;
+        for (size_t i = 0; i < amf_countof(PATHS) && failed == false; ++i)
+        {
+            const RelayPath& path = PATHS[i];
+            std::mt19937 generator(8899);
+            std::uniform_real_distribution<double> chance(0, 1);
+            size_t pathMtu = path.m_PathMtu;
+            //  Forwards the datagram waiting at the relay unless it is dropped, returns false when nothing was forwarded
+            auto forward = [&](const net::Socket::Address& to)
+            {
+                size_t bytes = ReceiveRelayed(relay, buffer);
+                size_t sent = 0;
+                return bytes > 0 && bytes <= pathMtu && chance(generator) >= path.m_Loss &&
+                       relay->SendTo(buffer.data(), bytes, to, &sent) == net::Socket::Result::OK;
+            };
+
+            PathMtuDiscovery discovery;
+            amf_pts now = 0;
+            discovery.Start(PathMtuDiscovery::MAX_PLPMTU, now);
+            int64_t probes = 0;
+            std::string error;
+            for (bool routeChanged = false; error.empty() == true; )
+            {
+                const amf_pts searchStart = now;
+                while (discovery.GetState() != PathMtuDiscovery::State::SEARCH_COMPLETE && discovery.GetState() != PathMtuDiscovery::State::BASE_ERROR &&
+                       now - searchStart < MAX_SEARCH_TIME && error.empty() == true)
+                {
+                    size_t probeSize = 0;
+                    FlowCtrlProtocol::MessageID probeID = 0;
+                    //  Sessions skip GetNextProbe() without taking their lock until this time
+                    const bool due = now >= discovery.GetNextProbeTime();
+                    if (discovery.GetNextProbe(now, probeSize, probeID) == false)
+                    {
+                        now += PathMtuDiscovery::PROBE_TIMEOUT / 5;
+                        continue;
+                    }
+                    if (due == false)
+                    {
+                        error = "a probe was due before GetNextProbeTime()";
+                        break;
+                    }
+                    ++probes;
+                    FlowCtrlProtocol::Fragment probe = FlowCtrlProtocol::CreatePathMtuProbe(probeID, FlowCtrlProtocol::PathMtuProbeType::PROBE, uint32_t(probeSize), probeSize);
+                    size_t sent = 0;
+                    if (probe.GetSizeToSend() != probeSize ||
+                        server->SendTo(probe.GetDataToSend(), probe.GetSizeToSend(), relayAddress, &sent) != net::Socket::Result::OK)
+                    {
+                        error = "a probe of " + std::to_string(probeSize) + " bytes could not be sent";
+                        break;
+                    }
+                    if (forward(clientAddress) == false)
+                    {
+                        continue;
+                    }
+
+                    //  The client acknowledges the probe with the size it was sent with
+                    size_t bytes = ReceiveRelayed(client, buffer);
+                    FlowCtrlProtocol::Fragment received;
+                    FlowCtrlProtocol::PathMtuProbeType type = FlowCtrlProtocol::PathMtuProbeType::ACK;
+                    uint32_t receivedSize = 0;
+                    if (bytes == 0 || received.ParseFromBuffer(buffer.data(), bytes) != FlowCtrlProtocol::Result::OK ||
+                        FlowCtrlProtocol::ParsePathMtuProbe(received, type, receivedSize) == false ||
+                        type != FlowCtrlProtocol::PathMtuProbeType::PROBE || receivedSize != bytes)
+                    {
+                        error = "the client received a malformed probe";
+                        break;
+                    }
+                    FlowCtrlProtocol::Fragment ack = FlowCtrlProtocol::CreatePathMtuProbe(received.GetMessageID(), FlowCtrlProtocol::PathMtuProbeType::ACK, receivedSize);
+                    client->SendTo(ack.GetDataToSend(), ack.GetSizeToSend(), relayAddress, &sent);
+                    if (forward(serverAddress) == false)
+                    {
+                        continue;
+                    }
+
+                    bytes = ReceiveRelayed(server, buffer);
+                    FlowCtrlProtocol::Fragment acknowledged;
+                    if (bytes == 0 || acknowledged.ParseFromBuffer(buffer.data(), bytes) != FlowCtrlProtocol::Result::OK ||
+                        FlowCtrlProtocol::ParsePathMtuProbe(acknowledged, type, receivedSize) == false || type != FlowCtrlProtocol::PathMtuProbeType::ACK)
+                    {
+                        error = "the server received a malformed acknowledgement";
+                        break;
+                    }
+                    now += ROUND_TRIP;
+                    discovery.OnProbeAcknowledged(acknowledged.GetMessageID(), receivedSize, now);
+                }
+                if (error.empty() == false)
+                {
+                    break;
+                }
+
+                const size_t plpmtu = discovery.GetPlpmtu();
+                if (pathMtu < PathMtuDiscovery::BASE_PLPMTU)
+                {
+                    if (discovery.GetState() != PathMtuDiscovery::State::BASE_ERROR || plpmtu != PathMtuDiscovery::MIN_PLPMTU)
+                    {
+                        error = "the PLPMTU is " + std::to_string(plpmtu) + " although the base does not get through";
+                    }
+                }
+                else if (discovery.GetState() != PathMtuDiscovery::State::SEARCH_COMPLETE)
+                {
+                    error = "the search did not complete within a minute";
+                }
+                else if (plpmtu > pathMtu || plpmtu + PathMtuDiscovery::SEARCH_GRANULARITY <= pathMtu)
+                {
+                    error = "the search settled on " + std::to_string(plpmtu) + " bytes for a path MTU of " + std::to_string(pathMtu);
+                }
+                if (error.empty() == false || path.m_NewPathMtu == 0 || routeChanged == true)
+                {
+                    break;
+                }
+                //  Datagrams of the PLPMTU stop getting through, the owner notices the losses and restarts the search
+                routeChanged = true;
+                pathMtu = path.m_NewPathMtu;
+                if (discovery.OnBlackHoleSuspected(now) == false)
+                {
+                    error = "a suspected black hole did not restart the search";
+                }
+            }
+
+            char line[160];
+            snprintf(line, sizeof(line), "%s: %zu bytes after %lld probes, %.2f s; ", path.m_Name, discovery.GetPlpmtu(),
+                     static_cast<long long>(probes), double(now) / AMF_SECOND);
+            report += line;
+            if (error.empty() == false)
+            {
+                state.SkipWithError(std::string(path.m_Name) + ": " + error);
+                failed = true;
+                break;
+            }
+        }
+        state.SetLabel(report);
+    }
+}
+
+//  The server sends through an impaired socket with a local MTU: probes above it have to fail with MESSAGE_TOO_BIG
+//  rather than vanish, so that the search settles without waiting for probe timeouts
+static void CheckPathMtuDiscoveryImpairedMtu(BenchmarkState& state)
+{
+    static constexpr const size_t LOCAL_MTU = 1400;
+
+    net::NetworkImpairment::Params params;
+    if (params.Parse("mtu=" + std::to_string(LOCAL_MTU)) == false || params.m_Mtu != LOCAL_MTU ||
+        net::NetworkImpairment::Params().Parse("mtu=1400,delay=ten") == true)
+    {
+        state.SkipWithError("impairment specs are not parsed correctly");
+        return;
+    }
+    net::ImpairedDatagramSocket::Ptr server(new net::ImpairedDatagramSocket(params));
+    net::DatagramSocket::Ptr client(new net::DatagramSocket());
+    if (server->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK ||
+        client->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK)
+    {
+        state.SkipWithError("Bind() failed");
+        return;
+    }
+    const net::Socket::IPv4Address clientAddress = GetBoundAddress(client);
+    std::vector<uint8_t> buffer(PathMtuDiscovery::MAX_PLPMTU + 1024);
+
+    while (state.KeepRunning() == true)
+    {
+        PathMtuDiscovery discovery;
+        amf_pts now = 0;
+        discovery.Start(PathMtuDiscovery::MAX_PLPMTU, now);
+        int64_t tooBig = 0;
+        std::string error;
+        while (discovery.GetState() != PathMtuDiscovery::State::SEARCH_COMPLETE && discovery.GetState() != PathMtuDiscovery::State::BASE_ERROR &&
+               error.empty() == true)
+        {
+            size_t probeSize = 0;
+            FlowCtrlProtocol::MessageID probeID = 0;
+            if (discovery.GetNextProbe(now, probeSize, probeID) == false)
+            {
+                error = "the search waited for a probe timeout";
+                break;
+            }
+            FlowCtrlProtocol::Fragment probe = FlowCtrlProtocol::CreatePathMtuProbe(probeID, FlowCtrlProtocol::PathMtuProbeType::PROBE, uint32_t(probeSize), probeSize);
+            size_t sent = 0;
+            net::Socket::Result result = server->SendTo(probe.GetDataToSend(), probe.GetSizeToSend(), clientAddress, &sent);
+            if (result == net::Socket::Result::MESSAGE_TOO_BIG)
+            {
+                if (probeSize <= LOCAL_MTU)
+                {
+                    error = "a probe of " + std::to_string(probeSize) + " bytes was rejected";
+                }
+                ++tooBig;
+                discovery.OnPacketTooBig(probeSize, now);
+                continue;
+            }
+            if (result != net::Socket::Result::OK || probeSize > LOCAL_MTU || ReceiveRelayed(client, buffer) != probeSize)
+            {
+                error = "a probe of " + std::to_string(probeSize) + " bytes was sent, the local MTU is " + std::to_string(LOCAL_MTU);
+                break;
+            }
+            now += AMF_MILLISECOND;
+            discovery.OnProbeAcknowledged(probeID, probeSize, now);
+        }
+
+        const size_t plpmtu = discovery.GetPlpmtu();
+        if (error.empty() == true && (discovery.GetState() != PathMtuDiscovery::State::SEARCH_COMPLETE ||
+                                      plpmtu > LOCAL_MTU || plpmtu + PathMtuDiscovery::SEARCH_GRANULARITY <= LOCAL_MTU || tooBig == 0))
+        {
+            error = "the search settled on " + std::to_string(plpmtu) + " bytes for a local MTU of " + std::to_string(LOCAL_MTU);
+        }
+        if (error.empty() == false)
+        {
+            state.SkipWithError(error);
+            break;
+        }
+        state.SetLabel(std::to_string(plpmtu) + " bytes, " + std::to_string(tooBig) + " probes rejected locally");
+    }
+}
+
+#if defined(__linux)
+//-------------------------------------------------------------------------------------------------
+// DatagramSocket - per-datagram DiffServ marking, receive drop counting and the sender address
+//-------------------------------------------------------------------------------------------------
+class TrafficClassScenario
+{
+public:
+    const char*                 m_Name = "";
+    net::Socket::TrafficClass   m_SocketClass = net::Socket::TrafficClass::BEST_EFFORT;
+    net::Socket::TrafficClass   m_DatagramClass = net::Socket::TrafficClass::BEST_EFFORT;
+};
+
+//  Receives one datagram within the timeout through recvmsg() with IP_RECVTOS set, returns the TOS byte it arrived with or -1
+static int ReceiveTypeOfService(net::DatagramSocket* socket, std::vector<uint8_t>& buffer)
+{
+    net::Selector selector;
+    net::Socket::Set readable;
+    selector.AddReadableSocket(socket);
+    struct timeval timeout = { 0, 100 * 1000 };
+    if (selector.WaitToRead(timeout, readable) != net::Selector::Result::OK)
+    {
+        return -1;
+    }
+    iovec iov = { buffer.data(), buffer.size() };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+    msghdr msg = {};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    int tos = -1;
+    if (::recvmsg(socket->GetNativeHandle(), &msg, 0) > 0)
+    {
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+            if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_TOS)
+            {
+                tos = *reinterpret_cast<const uint8_t*>(CMSG_DATA(cmsg));
+            }
+        }
+    }
+    return tos;
+}
+
+//  Sends datagrams marked per socket and per datagram over loopback and reads the TOS byte back, then floods a receiver
+//  with a small receive buffer: the drop counter reported with the next datagram has to account for every datagram which
+//  was not received. The sender address has to come back whole into an address which held garbage, both through the
+//  recvfrom() and the recvmsg() path of ReceiveFrom()
+static void CheckDatagramSocketTrafficClassAndDrops(BenchmarkState& state)
+{
+    static const TrafficClassScenario SCENARIOS[] = {
+        { "default", net::Socket::TrafficClass::BEST_EFFORT, net::Socket::TrafficClass::BEST_EFFORT },
+        { "video socket", net::Socket::TrafficClass::VIDEO, net::Socket::TrafficClass::VIDEO },
+        { "video datagram", net::Socket::TrafficClass::BEST_EFFORT, net::Socket::TrafficClass::VIDEO },
+        { "interactive datagram", net::Socket::TrafficClass::VIDEO, net::Socket::TrafficClass::INTERACTIVE },
+        { "best effort datagram", net::Socket::TrafficClass::INTERACTIVE, net::Socket::TrafficClass::BEST_EFFORT },
+    };
+    static constexpr const size_t FLOOD_COUNT = 256;
+    static constexpr const size_t FLOOD_SIZE = 1200;
+
+    std::vector<uint8_t> buffer(FLOOD_SIZE);
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        net::DatagramSocket::Ptr sender(new net::DatagramSocket());
+        net::DatagramSocket::Ptr receiver(new net::DatagramSocket());
+        net::DatagramSocket::Ptr flooded(new net::DatagramSocket());
+        if (sender->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK ||
+            receiver->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK ||
+            flooded->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK)
+        {
+            state.SkipWithError("Bind() failed");
+            break;
+        }
+        net::Socket::IPv4Address senderAddress = GetBoundAddress(sender);
+        senderAddress.SetAddress("127.0.0.1");     //  Bound by interface, the socket name holds INADDR_ANY
+        const net::Socket::IPv4Address receiverAddress = GetBoundAddress(receiver);
+        const net::Socket::IPv4Address floodedAddress = GetBoundAddress(flooded);
+        int receiveTos = 1;
+        if (receiver->SetSocketOpt(IPPROTO_IP, IP_RECVTOS, &receiveTos, sizeof(receiveTos)) != net::Socket::Result::OK)
+        {
+            state.SkipWithError("IP_RECVTOS could not be set");
+            break;
+        }
+
+        std::string report;
+        for (size_t i = 0; i < amf_countof(SCENARIOS) && failed == false; ++i)
+        {
+            const TrafficClassScenario& scenario = SCENARIOS[i];
+            size_t sent = 0;
+            if (sender->SetTrafficClass(scenario.m_SocketClass) != net::Socket::Result::OK ||
+                sender->SendTo(buffer.data(), FLOOD_SIZE, receiverAddress, &sent, 0, scenario.m_DatagramClass) != net::Socket::Result::OK)
+            {
+                state.SkipWithError(std::string(scenario.m_Name) + ": the datagram could not be sent");
+                failed = true;
+                break;
+            }
+            const int expected = net::Socket::GetTypeOfService(scenario.m_DatagramClass);
+            const int received = ReceiveTypeOfService(receiver, buffer);
+            if (received != expected)
+            {
+                char message[256];
+                snprintf(message, sizeof(message), "%s: the datagram arrived with TOS 0x%02x, expected 0x%02x", scenario.m_Name, received, expected);
+                state.SkipWithError(message);
+                failed = true;
+                break;
+            }
+            char line[64];
+            snprintf(line, sizeof(line), "%s0x%02x", report.empty() == true ? "TOS " : ", ", received);
+            report += line;
+        }
+        if (failed == true)
+        {
+            break;
+        }
+
+        //  recvfrom() path, the address held garbage before
+        net::Socket::IPv4Address from;
+        memset(&from.ToSockAddr(), 0xA5, sizeof(sockaddr_storage));
+        size_t sent = 0;
+        size_t bytes = 0;
+        if (sender->SendTo(buffer.data(), FLOOD_SIZE, floodedAddress, &sent) != net::Socket::Result::OK ||
+            ReceiveRelayed(flooded, buffer) == 0)
+        {
+            state.SkipWithError("the datagram before the flood was not received");
+            break;
+        }
+        if (sender->SendTo(buffer.data(), FLOOD_SIZE, floodedAddress, &sent) != net::Socket::Result::OK ||
+            flooded->ReceiveFrom(buffer.data(), buffer.size(), &from, &bytes) != net::Socket::Result::OK ||
+            from != senderAddress || from < senderAddress || senderAddress < from)
+        {
+            state.SkipWithError("recvfrom() did not return the sender address whole");
+            break;
+        }
+
+        int bufferSize = 4096;     //  The kernel doubles it and keeps the minimum, still only a few datagrams of FLOOD_SIZE
+        if (flooded->SetCountReceiveDrops(true) != net::Socket::Result::OK ||
+            flooded->SetSocketOpt(SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize)) != net::Socket::Result::OK)
+        {
+            state.SkipWithError("the receive buffer could not be set up");
+            break;
+        }
+        size_t flooding = 0;
+        for (size_t i = 0; i < FLOOD_COUNT; ++i)
+        {
+            if (sender->SendTo(buffer.data(), FLOOD_SIZE, floodedAddress, &sent) == net::Socket::Result::OK)
+            {
+                ++flooding;
+            }
+        }
+        size_t drained = 0;
+        while (ReceiveRelayed(flooded, buffer) > 0)
+        {
+            ++drained;
+        }
+        //  Datagrams queued before the first drop carry no counter, the one sent after the flood does
+        memset(&from.ToSockAddr(), 0xA5, sizeof(sockaddr_storage));
+        if (sender->SendTo(buffer.data(), FLOOD_SIZE, floodedAddress, &sent) != net::Socket::Result::OK ||
+            flooded->ReceiveFrom(buffer.data(), buffer.size(), &from, &bytes) != net::Socket::Result::OK)
+        {
+            state.SkipWithError("the datagram after the flood was not received");
+            break;
+        }
+        if (from != senderAddress || from < senderAddress || senderAddress < from)
+        {
+            state.SkipWithError("recvmsg() did not return the sender address whole");
+            break;
+        }
+        const size_t drops = flooded->GetReceiveDrops();
+        if (drops == 0 || drained + drops != flooding)
+        {
+            char message[256];
+            snprintf(message, sizeof(message), "%zu datagrams were sent, %zu received and %zu counted as dropped", flooding, drained, drops);
+            state.SkipWithError(message);
+            break;
+        }
+        char line[128];
+        snprintf(line, sizeof(line), ", %zu of %zu datagrams dropped", drops, flooding);
+        state.SetLabel(report + line);
+    }
+}
+#endif
+
+void RegisterDatagramChecks(BenchmarkRunner& runner)
+{
+    runner.RegisterCheck("Check/PathMtuDiscovery/Relay", CheckPathMtuDiscoveryRelay);
+    runner.RegisterCheck("Check/PathMtuDiscovery/ImpairedMtu", CheckPathMtuDiscoveryImpairedMtu);
+#if defined(__linux)
+    runner.RegisterCheck("Check/DatagramSocket/TrafficClassAndDrops", CheckDatagramSocketTrafficClassAndDrops);
+#endif
+}
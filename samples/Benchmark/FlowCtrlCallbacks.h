@@ -0,0 +1,78 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#include "sdk/transports/transport-amd/FlowCtrlProtocol.h"
+
+#include <cstdint>
+#include <vector>
+
+//  Flow control constants and callbacks shared by the benchmarks and checks which fragment and reassemble messages
+static constexpr const uint32_t DATAGRAM_SIZE = uint32_t(ssdk::transport_amd::FlowCtrlProtocol::UDP_MAX_MSS_SIZE_WITH_NO_FRAGMENTATION);
+static constexpr const uint8_t VIDEO_CHANNEL_ID = static_cast<uint8_t>(ssdk::transport_amd::Channel::VIDEO_OUT);
+static constexpr const uint8_t AUDIO_CHANNEL_ID = static_cast<uint8_t>(ssdk::transport_amd::Channel::AUDIO_OUT);
+
+class FragmentCollector :
+    public ssdk::transport_amd::FlowCtrlProtocol::ProcessOutgoingCallback
+{
+public:
+    virtual ssdk::net::Socket::Result OnFragmentReady(const ssdk::transport_amd::FlowCtrlProtocol::Fragment& fragment, bool /*last*/) override
+    {
+        const uint8_t* data = static_cast<const uint8_t*>(fragment.GetDataToSend());
+        m_Datagrams.push_back(std::vector<uint8_t>(data, data + fragment.GetSizeToSend()));
+        return ssdk::net::Socket::Result::OK;
+    }
+    virtual void OnSetMaxFragmentSize(size_t /*fragmentSize*/) override {}
+
+    std::vector<std::vector<uint8_t>> m_Datagrams;
+};
+
+class MessageCounter :
+    public ssdk::transport_amd::FlowCtrlProtocol::ProcessIncomingCallback
+{
+public:
+    virtual void OnCompleteMessage(ssdk::transport_amd::FlowCtrlProtocol::MessageID /*msgID*/, const void* /*buf*/, size_t size, const ssdk::net::Socket::Address& /*receivedFrom*/, uint8_t /*optional*/) override
+    {
+        ++m_Messages;
+        m_Bytes += size;
+    }
+    virtual ssdk::net::Socket::Result OnRequestFragment(const ssdk::transport_amd::FlowCtrlProtocol::Fragment& /*fragment*/) override { ++m_Requests; return ssdk::net::Socket::Result::OK; }
+
+    int64_t m_Messages = 0;
+    int64_t m_Bytes = 0;
+    int64_t m_Requests = 0;
+};
@@ -0,0 +1,397 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "Benchmark.h"
+
+#include "sdk/transports/transport-amd/messages/audio/AudioData.h"
+#include "sdk/transports/transport-amd/messages/audio/AudioInit.h"
+#include "sdk/transports/transport-amd/messages/sensors/DeviceEvent.h"
+#include "sdk/transports/transport-amd/messages/sensors/TrackableDeviceCaps.h"
+#include "sdk/transports/transport-amd/messages/service/ClockSync.h"
+#include "sdk/transports/transport-amd/messages/service/Connect.h"
+#include "sdk/transports/transport-amd/messages/service/GenericMessage.h"
+#include "sdk/transports/transport-amd/messages/service/Resume.h"
+#include "sdk/transports/transport-amd/messages/service/StartStop.h"
+#include "sdk/transports/transport-amd/messages/service/Stats.h"
+#include "sdk/transports/transport-amd/messages/service/Update.h"
+#include "sdk/transports/transport-amd/messages/video/Cursor.h"
+#include "sdk/transports/transport-amd/messages/video/QoS.h"
+#include "sdk/transports/transport-amd/messages/video/VideoData.h"
+#include "sdk/transports/transport-amd/messages/video/VideoInit.h"
+#include "sdk/controllers/UserInput.h"
+#include "sdk/util/clock/ClockSync.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace ssdk;
+using namespace ssdk::transport_amd;
+
+//-------------------------------------------------------------------------------------------------
+// Message JSON
+//-------------------------------------------------------------------------------------------------
+static VideoData MakeVideoData(int64_t frameNum)
+{
+    return VideoData(frameNum * 166667, frameNum * 166667 - 50000, 30000, 40000, 42000, transport_common::VideoFrame::ViewType::MONOSCOPIC,
+        transport_common::VideoFrame::SubframeType::P, 20000, amf_uint64(frameNum), false, transport_common::DEFAULT_STREAM);
+}
+
+static constexpr const size_t MEDIA_PAYLOAD_SIZE = 42000;      //  A P-frame at 20 Mbps, the binary payload after the JSON of media messages
+
+//  Every message type in messages/ as its sender builds it. Build() stores what is sent, without the payload of media messages,
+//  which follows the terminating 0 of the JSON on the wire
+class MessageType
+{
+public:
+    const char* m_Name;
+    void        (*m_Build)(std::string& datagram);
+    bool        (*m_Parse)(const void* datagram, size_t size);
+    bool        m_Payload;
+};
+
+static void StoreMessage(const Message& message, std::string& datagram)
+{
+    datagram.assign(static_cast<const char*>(message.GetSendData()), message.GetSendSize());
+}
+
+template<class T>
+static bool ParseMessage(const void* datagram, size_t size)
+{
+    T message;
+    return message.ParseBuffer(datagram, size);
+}
+
+static const MessageType MESSAGE_TYPES[] =
+{
+    { "AudioData", [](std::string& datagram) { StoreMessage(AudioData(AMF_SECOND, AMF_SECOND / 100, uint32_t(MEDIA_PAYLOAD_SIZE), 100, false, transport_common::DEFAULT_STREAM), datagram); },
+        ParseMessage<AudioData>, true },
+    { "AudioInit", [](std::string& datagram) { StoreMessage(AudioInit(1, "aac", amf::AMFAF_FLTP, 48000, 2, 3, transport_common::DEFAULT_STREAM), datagram); },
+        ParseMessage<AudioInit>, true },
+    { "AudioInitAck", [](std::string& datagram) { StoreMessage(AudioInitAck(1, true, transport_common::DEFAULT_STREAM), datagram); }, ParseMessage<AudioInitAck>, false },
+    { "AudioInitRequest", [](std::string& datagram) { StoreMessage(AudioInitRequest(transport_common::DEFAULT_STREAM), datagram); }, ParseMessage<AudioInitRequest>, false },
+    { "DeviceEvent", [](std::string& datagram)
+        {
+            DeviceEvent event(transport_common::DEFAULT_STREAM);
+            event.AddValue(std::string(ctls::DEVICE_HMD) + ctls::DEVICE_POSE, DeviceEvent::Pose(amf::Pose(), 0, 0), 0, AMF_SECOND);
+            event.Prepare();
+            StoreMessage(event, datagram);
+        }, ParseMessage<DeviceEvent>, false },
+    { "TrackableDeviceCaps", [](std::string& datagram) { StoreMessage(TrackableDeviceCaps(ctls::DEVICE_HMD, TrackableDeviceCaps::DeviceClass::HMD, "ssdk_bench"), datagram); },
+        ParseMessage<TrackableDeviceCaps>, false },
+    { "TrackableDeviceDisconnected", [](std::string& datagram) { StoreMessage(TrackableDeviceDisconnected(ctls::DEVICE_HMD), datagram); },
+        ParseMessage<TrackableDeviceDisconnected>, false },
+    { "ClockSync", [](std::string& datagram) { StoreMessage(ClockSyncMessage(AMF_SECOND, AMF_SECOND + 1000, AMF_SECOND + 2000), datagram); }, ParseMessage<ClockSyncMessage>, false },
+    { "ConnectRequest", [](std::string& datagram)
+        {
+            std::vector<VideoCodec> videoCodecs = { VideoCodec("H264", AMFConstructSize(1920, 1080), AMFConstructRate(60, 1)), VideoCodec("HEVC", AMFConstructSize(3840, 2160), AMFConstructRate(60, 1)) };
+            std::vector<AudioCodec> audioCodecs = { AudioCodec("AAC", 48000, 2, 3) };
+            StoreMessage(ConnectRequest(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT, FlowCtrlProtocol::PROTOCOL_VERSION_MIN, "ssdk_bench", FlowCtrlProtocol::MAX_DATAGRAM_SIZE,
+                                        videoCodecs, audioCodecs), datagram);
+        }, ParseMessage<ConnectRequest>, false },
+    { "DiscoveryRequest", [](std::string& datagram)
+        {
+            StoreMessage(DiscoveryRequest(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT, FlowCtrlProtocol::PROTOCOL_VERSION_MIN, "ssdk_bench", FlowCtrlProtocol::MAX_DATAGRAM_SIZE), datagram);
+        }, ParseMessage<DiscoveryRequest>, false },
+    { "HelloResponse", [](std::string& datagram)
+        {
+            StoreMessage(HelloResponse("ssdk_bench", FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT, FlowCtrlProtocol::PROTOCOL_VERSION_MIN, 1235, uint32_t(FlowCtrlProtocol::MAX_DATAGRAM_SIZE)), datagram);
+        }, ParseMessage<HelloResponse>, false },
+    { "HelloRefused", [](std::string& datagram) { StoreMessage(HelloRefused(), datagram); }, ParseMessage<HelloRefused>, false },
+    { "GenericMessage", [](std::string& datagram) { StoreMessage(GenericMessage("ssdk_bench"), datagram); }, ParseMessage<GenericMessage>, false },
+    { "Resume", [](std::string& datagram) { StoreMessage(ResumeMessage(std::string(64, 't'), std::string(64, 'p')), datagram); }, ParseMessage<ResumeMessage>, false },
+    { "StartRequest", [](std::string& datagram)
+        {
+            StoreMessage(StartRequest("ssdk_bench", 1920, 1080, 60.0f, 20000000, 0.0f, 16.0f / 9.0f, false, "H264", false, "AAC", 2, 3, 1920, 1080,
+                                      transport_common::DEFAULT_STREAM, transport_common::DEFAULT_STREAM), datagram);
+        }, ParseMessage<StartRequest>, false },
+    { "StopRequest", [](std::string& datagram) { StoreMessage(StopRequest(transport_common::DEFAULT_STREAM, transport_common::DEFAULT_STREAM), datagram); }, ParseMessage<StopRequest>, false },
+    { "Statistics", [](std::string& datagram)
+        {
+            StoreMessage(Statistics(transport_common::DEFAULT_STREAM, 40.0f, 10.0f, 12.0f, 6.0f, 8.0f, 4.0f, 0.5f, 0.5f, 1, 2.0f, 60.0f), datagram);
+        }, ParseMessage<Statistics>, false },
+    { "ServerStat", [](std::string& datagram) { StoreMessage(ServerStat(transport_common::DEFAULT_STREAM, 2400, 60, 65, 4200, 55), datagram); }, ParseMessage<ServerStat>, false },
+    { "UpdateRequest", [](std::string& datagram)
+        {
+            StoreMessage(UpdateRequest(transport_common::DEFAULT_STREAM, 60.0f, AMFConstructSize(1920, 1080), 20000000), datagram);
+        }, ParseMessage<UpdateRequest>, false },
+    { "CursorData", [](std::string& datagram) { StoreMessage(CursorData(64, 64, 256, 0, 0, 1920, 1080, true, false, 0x5a5a5a5a5a5a5a5aULL, false), datagram); },
+        ParseMessage<CursorData>, true },
+    { "CursorCacheMiss", [](std::string& datagram) { StoreMessage(CursorCacheMiss(0x5a5a5a5a5a5a5a5aULL), datagram); }, ParseMessage<CursorCacheMiss>, false },
+    { "QoSData", [](std::string& datagram)
+        {
+            StoreMessage(QoSData(AMF_SECOND, 60, 20 * AMF_MILLISECOND, 35 * AMF_MILLISECOND, 25 * AMF_MILLISECOND, 1, 5 * AMF_MILLISECOND, 5 * AMF_MILLISECOND), datagram);
+        }, ParseMessage<QoSData>, false },
+    { "VideoData", [](std::string& datagram) { StoreMessage(MakeVideoData(1000), datagram); }, ParseMessage<VideoData>, true },
+    { "VideoForceUpdate", [](std::string& datagram) { StoreMessage(VideoForceUpdate(transport_common::DEFAULT_STREAM), datagram); }, ParseMessage<VideoForceUpdate>, false },
+    { "VideoInit", [](std::string& datagram)
+        {
+            StoreMessage(VideoInit(1, "H264", 1920, 1080, AMFConstructRect(0, 0, 1920, 1080), false, 8, transport_common::DEFAULT_STREAM), datagram);
+        }, ParseMessage<VideoInit>, true },
+    { "VideoInitAck", [](std::string& datagram) { StoreMessage(VideoInitAck(1, true, transport_common::DEFAULT_STREAM), datagram); }, ParseMessage<VideoInitAck>, false },
+    { "VideoInitRequest", [](std::string& datagram) { StoreMessage(VideoInitRequest(transport_common::DEFAULT_STREAM), datagram); }, ParseMessage<VideoInitRequest>, false },
+};
+
+static void MessageSerialize(BenchmarkState& state, const MessageType& type)
+{
+    std::string datagram;
+    AllocationCounter allocations;
+    while (state.KeepRunning() == true)
+    {
+        type.m_Build(datagram);
+    }
+    char label[128];
+    snprintf(label, sizeof(label), "%s, %.1f allocations", type.m_Name, double(allocations.GetCount()) / double(std::max(state.GetIterations(), int64_t(1))));
+    state.SetBytesProcessed(state.GetIterations() * int64_t(datagram.size()));
+    state.SetItemsProcessed(state.GetIterations());
+    state.SetLabel(label);
+}
+
+static void MessageParse(BenchmarkState& state, const MessageType& type)
+{
+    std::string datagram;
+    type.m_Build(datagram);
+    if (type.m_Payload == true)
+    {
+        datagram.push_back('\0');
+        datagram.append(MEDIA_PAYLOAD_SIZE, '\x5a');
+    }
+    AllocationCounter allocations;
+    while (state.KeepRunning() == true)
+    {
+        if (type.m_Parse(datagram.data(), datagram.size()) == false)
+        {
+            state.SkipWithError("ParseBuffer() failed");
+        }
+    }
+    char label[128];
+    snprintf(label, sizeof(label), "%s, %.1f allocations", type.m_Name, double(allocations.GetCount()) / double(std::max(state.GetIterations(), int64_t(1))));
+    state.SetBytesProcessed(state.GetIterations() * int64_t(datagram.size()));
+    state.SetItemsProcessed(state.GetIterations());
+    state.SetLabel(label);
+}
+
+//  Received messages are parsed with the thread's parser from its text buffer. For every type, once the buffer has grown,
+//  parsing must allocate less than a fresh parser over a copy of the datagram, which is what ParseBuffer() used to do,
+//  and the payload after the JSON of a media message must not change what is allocated: it is neither copied nor parsed
+static void CheckMessageParseAllocations(BenchmarkState& state)
+{
+    static constexpr const size_t LARGE_PAYLOAD_SIZE = 262144;
+
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        int64_t minSaved = std::numeric_limits<int64_t>::max();
+        int64_t maxAllocations = 0;
+        for (const MessageType& type : MESSAGE_TYPES)
+        {
+            std::string datagram;
+            type.m_Build(datagram);
+            if (type.m_Parse(datagram.data(), datagram.size()) == false)
+            {
+                state.SkipWithError(std::string(type.m_Name) + " does not parse");
+                failed = true;
+                break;
+            }
+            AllocationCounter allocations;
+            type.m_Parse(datagram.data(), datagram.size());
+            const int64_t count = allocations.GetCount();
+            const int64_t bytes = allocations.GetBytes();
+
+            amf::JSONParser::Node::Ptr root;
+            allocations.Reset();
+            MessageParser::GetThreadInstance().Parse(datagram.data() + 1, datagram.size() - 1, &root);
+            const int64_t reused = allocations.GetCount();
+            root.Release();
+            allocations.Reset();
+            {
+                std::string copy(datagram.data() + 1, datagram.size() - 1);
+                amf::JSONParser::Ptr parser;
+                CreateJSONParser(&parser);
+                parser->Parse(copy, &root);
+                root.Release();
+            }
+            const int64_t fresh = allocations.GetCount();
+            if (reused >= fresh)
+            {
+                state.SkipWithError(std::string(type.m_Name) + ": the thread's parser made " + std::to_string(reused) + " allocations, a fresh one " + std::to_string(fresh));
+                failed = true;
+                break;
+            }
+
+            if (type.m_Payload == true)
+            {
+                datagram.push_back('\0');
+                datagram.append(LARGE_PAYLOAD_SIZE, '\x5a');
+                allocations.Reset();
+                type.m_Parse(datagram.data(), datagram.size());
+                if (allocations.GetCount() != count || allocations.GetBytes() != bytes)
+                {
+                    state.SkipWithError(std::string(type.m_Name) + ": a " + std::to_string(LARGE_PAYLOAD_SIZE) + " byte payload changed the allocations from " +
+                                        std::to_string(count) + " (" + std::to_string(bytes) + " bytes) to " +
+                                        std::to_string(allocations.GetCount()) + " (" + std::to_string(allocations.GetBytes()) + " bytes)");
+                    failed = true;
+                    break;
+                }
+            }
+            minSaved = std::min(minSaved, fresh - reused);
+            maxAllocations = std::max(maxAllocations, count);
+        }
+        if (failed == false)
+        {
+            state.SetLabel(std::to_string(amf_countof(MESSAGE_TYPES)) + " types, up to " + std::to_string(maxAllocations) + " allocations per message, " +
+                           std::to_string(minSaved) + " or more saved by the thread's parser");
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// ClockSync - network latency of video frames over a skewed server clock and an asymmetric path
+//-------------------------------------------------------------------------------------------------
+//  The server clock runs at an offset and a skew from the client's, and frames wait in the send queue for up to
+//  a frame interval before they go out. The latency the client derives from the send time stamped at dequeue must
+//  follow the downlink delay, off only by half the path asymmetry, which a clock exchange cannot observe
+class SimulatedPath
+{
+public:
+    const char*     m_Name = "";
+    amf_pts         m_Uplink = 0;
+    amf_pts         m_Downlink = 0;
+    double          m_Skew = 0;
+    amf_pts         m_Offset = 0;
+
+    inline amf_pts ToServer(amf_pts client) const noexcept { return m_Offset + client + amf_pts(double(client) * m_Skew); }
+};
+
+static void CheckClockSyncSkewAndAsymmetry(BenchmarkState& state)
+{
+    static constexpr const amf_pts DURATION = 60 * AMF_SECOND;
+    static constexpr const amf_pts SETTLE_TIME = 20 * AMF_SECOND;
+    static constexpr const amf_pts MAX_QUEUE_WAIT = AMF_SECOND / 60;
+    static constexpr const amf_pts TURNAROUND = AMF_MILLISECOND / 20;
+    static constexpr const double MAX_SKEW_ERROR_PPM = 5.0;
+    static constexpr const amf_pts MAX_MEAN_ERROR = AMF_MILLISECOND / 2;
+    static const SimulatedPath PATHS[] = {
+        { "symmetric 5/5 ms, +50 ppm", 5 * AMF_MILLISECOND, 5 * AMF_MILLISECOND, 50e-6, 3600 * AMF_SECOND },
+        { "asymmetric 2/8 ms, -200 ppm", 2 * AMF_MILLISECOND, 8 * AMF_MILLISECOND, -200e-6, -42 * AMF_SECOND },
+    };
+
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        std::string report;
+        for (size_t i = 0; i < amf_countof(PATHS) && failed == false; ++i)
+        {
+            const SimulatedPath& path = PATHS[i];
+            std::mt19937 generator(37);
+            std::exponential_distribution<double> jitter(1.0 / double(AMF_MILLISECOND * 3 / 10));
+            std::uniform_real_distribution<double> chance(0, 1);
+            std::uniform_int_distribution<amf_pts> queueWait(0, MAX_QUEUE_WAIT);
+            auto delay = [&](amf_pts base) { return base + amf_pts(jitter(generator)) + (chance(generator) < 0.05 ? 20 * AMF_MILLISECOND : 0); };
+
+            util::ClockSync clockSync;
+            amf_pts requestTime = 0;
+            amf_pts errorSum = 0;
+            int64_t frameNum = 0;
+            int64_t frames = 0;
+            bool stamped = true;
+            for (amf_pts created = 0; created < DURATION && stamped == true; created += AMF_SECOND / 60, ++frameNum)
+            {
+                amf_pts sendTime = created + queueWait(generator);
+                amf_pts downlink = delay(path.m_Downlink);
+                amf_pts arrival = sendTime + downlink;
+                while (requestTime < arrival)
+                {   //  Exchanges are completed in the order they would be with the frames
+                    amf_pts receive = path.ToServer(requestTime + delay(path.m_Uplink));
+                    amf_pts transmit = receive + TURNAROUND;
+                    amf_pts destination = requestTime + (transmit - path.ToServer(requestTime)) + delay(path.m_Downlink);
+                    clockSync.AddSample(requestTime, receive, transmit, destination);
+                    requestTime += clockSync.GetRequestInterval();
+                }
+
+                VideoData sent = MakeVideoData(frameNum);
+                std::vector<uint8_t> message(sent.GetSendSize() + 1 + 1200, 0x5a);
+                memcpy(message.data(), sent.GetSendData(), sent.GetSendSize());
+                message[sent.GetSendSize()] = 0;
+                stamped = VideoData::StampSendTime(message.data(), message.size(), path.ToServer(sendTime));
+                VideoData received;
+                stamped = stamped == true && received.ParseBuffer(message.data(), message.size()) == true &&
+                          received.GetSendTime() == path.ToServer(sendTime);
+                if (created >= SETTLE_TIME && clockSync.IsSynchronized() == true)
+                {
+                    errorSum += (arrival - clockSync.RemoteToLocal(received.GetSendTime())) - downlink;
+                    ++frames;
+                }
+            }
+            if (stamped == false)
+            {
+                state.SkipWithError("the send time did not survive stamping and parsing a VideoData message");
+                failed = true;
+                break;
+            }
+
+            amf_pts bias = (path.m_Uplink - path.m_Downlink) / 2;
+            amf_pts meanError = frames > 0 ? errorSum / frames : MAX_QUEUE_WAIT;
+            double skewError = clockSync.GetSkewPpm() - path.m_Skew * 1e6;
+            char line[256];
+            snprintf(line, sizeof(line), "%s: skew error %.2f ppm, latency error %.3f ms (bias %.3f ms); ", path.m_Name,
+                     skewError, double(meanError) / AMF_MILLISECOND, double(bias) / AMF_MILLISECOND);
+            report += line;
+            if (std::abs(skewError) > MAX_SKEW_ERROR_PPM || std::abs(meanError - bias) > MAX_MEAN_ERROR)
+            {
+                state.SkipWithError(report);
+                failed = true;
+            }
+        }
+        state.SetLabel(report);
+    }
+}
+
+void RegisterMessageBenchmarks(BenchmarkRunner& runner)
+{
+    for (const MessageType& type : MESSAGE_TYPES)
+    {
+        runner.Register(std::string("Message/Serialize/") + type.m_Name, [&type](BenchmarkState& state) { MessageSerialize(state, type); });
+        runner.Register(std::string("Message/Parse/") + type.m_Name, [&type](BenchmarkState& state) { MessageParse(state, type); });
+    }
+    runner.RegisterCheck("Check/Message/ParseAllocations", CheckMessageParseAllocations);
+    runner.RegisterCheck("Check/ClockSync/SkewAndAsymmetry", CheckClockSyncSkewAndAsymmetry);
+}
@@ -0,0 +1,772 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "Benchmark.h"
+#include "FlowCtrlCallbacks.h"
+
+#include "sdk/transports/transport-amd/FlowCtrlProtocol.h"
+#include "sdk/transports/transport-amd/LocalTransport.h"
+#include "sdk/net/DatagramSocket.h"
+#include "sdk/net/DatagramRing.h"
+#include "sdk/net/NetworkImpairment.h"
+#include "sdk/net/Selector.h"
+#include "sdk/net/SharedMemoryRing.h"
+#include "sdk/util/encryption/AESPSKCipher.h"
+#include "sdk/util/trace/PipelineTrace.h"
+#include "amf/public/common/Thread.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__linux)
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace ssdk;
+using namespace ssdk::transport_amd;
+
+//  Message sizes seen on the wire: an input event, an audio frame, P-frames at 5, 20 and 50 Mbps at 60 fps and an IDR frame
+static const std::vector<int64_t> MESSAGE_SIZES = { 64, 480, 10000, 42000, 105000, 262144 };
+
+//  One second of a 60 fps, 20 Mbps stream: an IDR frame every 60 frames, P-frames of varying size, two audio frames
+//  and a few input events per video frame. Generated from a fixed seed, so every run sees the same sequence
+static const std::vector<uint32_t>& GetStreamMix()
+{
+    static std::vector<uint32_t> mix;
+    if (mix.empty() == true)
+    {
+        std::mt19937 generator(1234);
+        std::uniform_int_distribution<uint32_t> pFrameSize(25000, 55000);
+        for (int frame = 0; frame < 60; ++frame)
+        {
+            mix.push_back(frame == 0 ? 250000 : pFrameSize(generator));
+            mix.push_back(480);
+            mix.push_back(480);
+            mix.push_back(64);
+            mix.push_back(64);
+        }
+    }
+    return mix;
+}
+
+namespace
+{
+    class FragmentCounter :
+        public FlowCtrlProtocol::ProcessOutgoingCallback
+    {
+    public:
+        virtual net::Socket::Result OnFragmentReady(const FlowCtrlProtocol::Fragment& /*fragment*/, bool /*last*/) override { ++m_Fragments; return net::Socket::Result::OK; }
+        virtual void OnSetMaxFragmentSize(size_t /*fragmentSize*/) override {}
+
+        int64_t m_Fragments = 0;
+    };
+
+    //  Datagrams of a message, renumbered before every replay, as the receiver drops messages it has already seen
+    class FragmentedMessage
+    {
+    public:
+        FragmentedMessage(uint32_t size)
+        {
+            FlowCtrlProtocol sender(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+            std::vector<uint8_t> message(size, 0x5a);
+            FragmentCollector collector;
+            uint32_t bytesSent = 0;
+            sender.FragmentMessage(message.data(), size, DATAGRAM_SIZE, VIDEO_CHANNEL_ID, collector, bytesSent);
+            m_Datagrams = std::move(collector.m_Datagrams);
+        }
+
+        void Feed(FlowCtrlProtocol& receiver, FlowCtrlProtocol::MessageID messageID, FlowCtrlProtocol::ProcessIncomingCallback& callback, const net::Socket::Address& from)
+        {
+            for (std::vector<uint8_t>& datagram : m_Datagrams)
+            {
+                reinterpret_cast<FlowCtrlProtocol::FragmentHeader*>(datagram.data())->m_MessageID = htons(messageID);
+                receiver.ProcessFragment(datagram.data(), uint32_t(datagram.size()), from, callback);
+            }
+        }
+
+        inline size_t GetFragmentCount() const noexcept { return m_Datagrams.size(); }
+
+    private:
+        std::vector<std::vector<uint8_t>> m_Datagrams;
+    };
+}
+
+//-------------------------------------------------------------------------------------------------
+// FlowCtrlProtocol
+//-------------------------------------------------------------------------------------------------
+static void FlowCtrlFragment(BenchmarkState& state)
+{
+    FlowCtrlProtocol sender(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+    std::vector<uint8_t> message(size_t(state.GetArg()), 0x5a);
+    FragmentCounter counter;
+    uint32_t bytesSent = 0;
+    while (state.KeepRunning() == true)
+    {
+        sender.FragmentMessage(message.data(), uint32_t(message.size()), DATAGRAM_SIZE, VIDEO_CHANNEL_ID, counter, bytesSent);
+    }
+    state.SetBytesProcessed(state.GetIterations() * state.GetArg());
+    state.SetItemsProcessed(counter.m_Fragments);
+}
+
+static void FlowCtrlReassemble(BenchmarkState& state)
+{
+    FragmentedMessage message(uint32_t(state.GetArg()));
+    FlowCtrlProtocol receiver(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+    MessageCounter counter;
+    net::Socket::IPv4Address from("127.0.0.1", 1235);
+    FlowCtrlProtocol::MessageID messageID = 0;
+    while (state.KeepRunning() == true)
+    {
+        message.Feed(receiver, ++messageID, counter, from);
+    }
+    if (counter.m_Messages != state.GetIterations())
+    {
+        state.SkipWithError("messages were not reassembled");
+    }
+    state.SetBytesProcessed(counter.m_Bytes);
+    state.SetItemsProcessed(state.GetIterations() * int64_t(message.GetFragmentCount()));
+}
+
+//  With tracing on every message is sent under its own key, as SendVideoFrame() does, and every fragment gets a span
+static void FlowCtrlStreamMix(BenchmarkState& state, bool traced)
+{
+    const std::vector<uint32_t>& mix = GetStreamMix();
+    FlowCtrlProtocol sender(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+    FlowCtrlProtocol receiver(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+    std::vector<uint8_t> payload(*std::max_element(mix.begin(), mix.end()), 0x5a);
+    FragmentCollector collector;
+    MessageCounter counter;
+    net::Socket::IPv4Address from("127.0.0.1", 1235);
+    uint32_t bytesSent = 0;
+    size_t next = 0;
+    amf_pts key = 0;
+    util::PipelineTrace::Enable(traced);
+    while (state.KeepRunning() == true)
+    {
+        util::PipelineTrace::KeyScope scope(++key);
+        collector.m_Datagrams.clear();
+        sender.FragmentMessage(payload.data(), mix[next], DATAGRAM_SIZE, VIDEO_CHANNEL_ID, collector, bytesSent);
+        for (const std::vector<uint8_t>& datagram : collector.m_Datagrams)
+        {
+            receiver.ProcessFragment(datagram.data(), uint32_t(datagram.size()), from, counter);
+        }
+        next = (next + 1) % mix.size();
+    }
+    util::PipelineTrace::Enable(false);
+    util::PipelineTrace::Clear();
+    state.SetBytesProcessed(counter.m_Bytes);
+    state.SetItemsProcessed(counter.m_Messages);
+    state.SetLabel("fragment + reassemble");
+}
+
+//-------------------------------------------------------------------------------------------------
+// FlowCtrlProtocol over an impaired path - goodput, frame completion latency and NACK overhead
+//-------------------------------------------------------------------------------------------------
+namespace
+{
+    //  A scripted network profile: the impairment of the video path and of the path requests for missing fragments take back
+    struct ImpairmentProfile
+    {
+        const char* m_Name;
+        const char* m_Forward;
+        const char* m_Return;
+    };
+
+    //  One direction of an emulated path, datagrams are held until the departure time NetworkImpairment gave them
+    class ImpairedLink
+    {
+    public:
+        ImpairedLink(const char* spec) : m_Model(ParseSpec(spec, m_Valid)) {}
+
+        //  A malformed spec leaves the link unimpaired, the check has to fail rather than measure a clean path
+        inline bool IsValid() const noexcept { return m_Valid; }
+
+        net::Socket::Result Send(const void* data, size_t size, amf_pts now)
+        {
+            size_t mtu = m_Model.GetParams().m_Mtu;
+            if (mtu != 0 && size > mtu)
+            {
+                return net::Socket::Result::MESSAGE_TOO_BIG;
+            }
+            amf_pts departures[net::NetworkImpairment::MAX_COPIES] = {};
+            size_t copies = m_Model.Schedule(size, now, departures);
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < copies; ++i)
+            {
+                m_InFlight.insert({ departures[i], std::vector<uint8_t>(bytes, bytes + size) });
+            }
+            return net::Socket::Result::OK;
+        }
+
+        //  Taken off the link before they are handed over, as delivering one may send on the link again
+        template<typename Deliver>
+        void DeliverDue(amf_pts now, Deliver deliver)
+        {
+            std::vector<std::vector<uint8_t>> due;
+            while (m_InFlight.empty() == false && m_InFlight.begin()->first <= now)
+            {
+                due.push_back(std::move(m_InFlight.begin()->second));
+                m_InFlight.erase(m_InFlight.begin());
+            }
+            for (std::vector<uint8_t>& datagram : due)
+            {
+                deliver(datagram);
+            }
+        }
+
+        inline bool IsEmpty() const noexcept { return m_InFlight.empty(); }
+
+    private:
+        static net::NetworkImpairment::Params ParseSpec(const char* spec, bool& valid)
+        {
+            net::NetworkImpairment::Params params;
+            valid = params.Parse(spec);
+            return params;
+        }
+
+        bool                                                m_Valid = false;    //  Declared before m_Model, which sets it
+        net::NetworkImpairment                              m_Model;
+        std::multimap<amf_pts, std::vector<uint8_t>>        m_InFlight;
+    };
+
+    class LinkWriter :
+        public FlowCtrlProtocol::ProcessOutgoingCallback
+    {
+    public:
+        LinkWriter(ImpairedLink& link) : m_Link(link) {}
+
+        virtual net::Socket::Result OnFragmentReady(const FlowCtrlProtocol::Fragment& fragment, bool /*last*/) override
+        {
+            net::Socket::Result result = m_Link.Send(fragment.GetDataToSend(), fragment.GetSizeToSend(), m_Now);
+            m_Bytes += int64_t(fragment.GetSizeToSend());
+            return result;
+        }
+        virtual void OnSetMaxFragmentSize(size_t /*fragmentSize*/) override {}
+
+        ImpairedLink&   m_Link;
+        amf_pts         m_Now = 0;
+        int64_t         m_Bytes = 0;
+    };
+
+    //  Receiving end: frames carry their index in the first bytes, requests for missing fragments go back over the return link
+    class FrameReceiver :
+        public FlowCtrlProtocol::ProcessIncomingCallback
+    {
+    public:
+        FrameReceiver(ImpairedLink& returnLink, const std::vector<amf_pts>& sendTimes) : m_ReturnLink(returnLink), m_SendTimes(sendTimes) {}
+
+        virtual void OnCompleteMessage(FlowCtrlProtocol::MessageID /*msgID*/, const void* buf, size_t size, const net::Socket::Address& /*receivedFrom*/, uint8_t /*optional*/) override
+        {
+            uint32_t frame = 0;
+            memcpy(&frame, buf, sizeof(frame));
+            if (frame < m_SendTimes.size())
+            {
+                m_Latencies.push_back(m_Now - m_SendTimes[frame]);
+                m_Bytes += int64_t(size);
+            }
+        }
+        virtual net::Socket::Result OnRequestFragment(const FlowCtrlProtocol::Fragment& fragment) override
+        {
+            net::Socket::Result result = m_ReturnLink.Send(fragment.GetDataToSend(), fragment.GetSizeToSend(), m_Now);
+            m_RequestBytes += int64_t(fragment.GetSizeToSend());
+            return result;
+        }
+
+        ImpairedLink&                   m_ReturnLink;
+        const std::vector<amf_pts>&     m_SendTimes;
+        amf_pts                         m_Now = 0;
+        std::vector<amf_pts>            m_Latencies;
+        int64_t                         m_Bytes = 0;
+        int64_t                         m_RequestBytes = 0;
+    };
+}
+
+static const ImpairmentProfile IMPAIRMENT_PROFILES[] = {
+    { "Clean", "delay=10", "delay=10" },
+    { "Loss1", "loss=1,delay=10,jitter=2,seed=28", "delay=10,jitter=2,seed=29" },
+    { "Bursty", "ge=1:30:0:50,delay=20,jitter=5,dist=normal,rate=40000,reorder=0.5,seed=42", "ge=1:30:0:50,delay=20,jitter=5,dist=normal,seed=43" },
+};
+
+//  Two seconds of the video in the stream mix sent in real time, as the gap timeouts of the receiver run on the real clock.
+//  Goodput is the rate of video completely received over the stream, latency is from handing a frame to the flow control
+//  to its delivery, the overhead is the requests for missing fragments and the retransmissions relative to the original fragments
+static void FlowCtrlImpaired(BenchmarkState& state, const ImpairmentProfile& profile)
+{
+    static constexpr const amf_pts FRAME_INTERVAL = AMF_SECOND / 60;
+    static constexpr const size_t FRAMES = 120;
+    static constexpr const amf_pts DRAIN_TIME = 500 * AMF_MILLISECOND;
+
+    const std::vector<uint32_t>& mix = GetStreamMix();
+    std::vector<uint32_t> frameSizes;
+    for (size_t i = 0; frameSizes.size() < FRAMES; i = (i + 5) % mix.size())   //  Video frames are every fifth message of the mix
+    {
+        frameSizes.push_back(mix[i]);
+    }
+    std::vector<uint8_t> payload(*std::max_element(frameSizes.begin(), frameSizes.end()), 0x5a);
+    net::Socket::IPv4Address from("127.0.0.1", 1235);
+
+    int64_t deliveredBytes = 0;
+    int64_t originalBytes = 0;
+    int64_t overheadBytes = 0;
+    int64_t lostFrames = 0;
+    std::vector<amf_pts> latencies;
+    while (state.KeepRunning() == true)
+    {
+        ImpairedLink forward(profile.m_Forward);
+        ImpairedLink backward(profile.m_Return);
+        if (forward.IsValid() == false || backward.IsValid() == false)
+        {
+            state.SkipWithError(std::string("malformed impairment profile ") + profile.m_Name);
+            break;
+        }
+        FlowCtrlProtocol sender(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+        FlowCtrlProtocol receiver(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+        LinkWriter writer(forward);
+        LinkWriter retransmitter(forward);
+        MessageCounter senderRequests;
+        std::vector<amf_pts> sendTimes(FRAMES, 0);
+        FrameReceiver frameReceiver(backward, sendTimes);
+
+        const amf_pts start = amf_high_precision_clock();
+        amf_pts now = 0;
+        size_t sent = 0;
+        while (sent < FRAMES || now < sendTimes.back() + DRAIN_TIME || forward.IsEmpty() == false || backward.IsEmpty() == false)
+        {
+            now = amf_high_precision_clock() - start;
+            writer.m_Now = now;
+            retransmitter.m_Now = now;
+            frameReceiver.m_Now = now;
+            for (; sent < FRAMES && now >= amf_pts(sent) * FRAME_INTERVAL; ++sent)
+            {
+                uint32_t frame = uint32_t(sent);
+                memcpy(payload.data(), &frame, sizeof(frame));
+                sendTimes[sent] = now;
+                uint32_t bytesSent = 0;
+                sender.FragmentMessage(payload.data(), frameSizes[sent], DATAGRAM_SIZE, VIDEO_CHANNEL_ID, writer, bytesSent);
+            }
+            forward.DeliverDue(now, [&](const std::vector<uint8_t>& datagram)
+                {
+                    receiver.ProcessFragment(datagram.data(), uint32_t(datagram.size()), from, frameReceiver);
+                });
+            backward.DeliverDue(now, [&](const std::vector<uint8_t>& datagram)
+                {
+                    sender.ProcessFragment(datagram.data(), uint32_t(datagram.size()), from, senderRequests, &retransmitter);
+                });
+            receiver.TickNotify(frameReceiver, VIDEO_CHANNEL_ID);
+            amf_sleep(1);
+        }
+
+        deliveredBytes += frameReceiver.m_Bytes;
+        originalBytes += writer.m_Bytes;
+        overheadBytes += frameReceiver.m_RequestBytes + retransmitter.m_Bytes;
+        lostFrames += int64_t(FRAMES) - int64_t(frameReceiver.m_Latencies.size());
+        latencies.insert(latencies.end(), frameReceiver.m_Latencies.begin(), frameReceiver.m_Latencies.end());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) { return latencies.empty() == true ? 0.0 : double(latencies[size_t(p * double(latencies.size() - 1))]) / AMF_MILLISECOND; };
+    const double streamSeconds = double(state.GetIterations() * int64_t(FRAMES) * FRAME_INTERVAL) / AMF_SECOND;
+    char label[256] = {};
+    snprintf(label, sizeof(label), "goodput %.1f Mbps, latency p50 %.1f p99 %.1f max %.1f ms, NACK overhead %.2f%%, %lld frames lost",
+             double(deliveredBytes) * 8 / streamSeconds / 1e6, percentile(0.5), percentile(0.99), percentile(1.0),
+             originalBytes > 0 ? 100.0 * double(overheadBytes) / double(originalBytes) : 0.0, (long long)lostFrames);
+    state.SetBytesProcessed(deliveredBytes);
+    state.SetItemsProcessed(state.GetIterations() * int64_t(FRAMES) - lostFrames);
+    state.SetLabel(label);
+}
+
+//-------------------------------------------------------------------------------------------------
+// MessageChunks - missing fragment requests
+//-------------------------------------------------------------------------------------------------
+static void FillMessageChunks(FlowCtrlProtocol::MessageChunks& chunks, int64_t count)
+{
+    const size_t fragmentSize = DATAGRAM_SIZE - sizeof(FlowCtrlProtocol::FragmentHeader);
+    for (int64_t i = 0; i < count; ++i)
+    {   //  Every other fragment of consecutive messages is missing
+        chunks.AddChunk(VIDEO_CHANNEL_ID, FlowCtrlProtocol::MessageID(i / 16), size_t(i % 16) * 2 * fragmentSize, fragmentSize);
+    }
+}
+
+static void MessageChunksPack(BenchmarkState& state)
+{
+    FlowCtrlProtocol::MessageChunks chunks;
+    FillMessageChunks(chunks, state.GetArg());
+    int64_t bytes = 0;
+    while (state.KeepRunning() == true)
+    {
+        FlowCtrlProtocol::MessageChunks::Buf packed = chunks.Pack();
+        bytes += int64_t(packed.second);
+    }
+    state.SetBytesProcessed(bytes);
+    state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+}
+
+static void MessageChunksUnpack(BenchmarkState& state)
+{
+    FlowCtrlProtocol::MessageChunks chunks;
+    FillMessageChunks(chunks, state.GetArg());
+    FlowCtrlProtocol::MessageChunks::Buf packed = chunks.Pack();
+    while (state.KeepRunning() == true)
+    {
+        FlowCtrlProtocol::MessageChunks unpacked;
+        if (unpacked.Unpack(packed.first.get()) == false)
+        {
+            state.SkipWithError("Unpack() failed");
+        }
+    }
+    state.SetBytesProcessed(state.GetIterations() * int64_t(packed.second));
+    state.SetItemsProcessed(state.GetIterations() * state.GetArg());
+}
+
+//-------------------------------------------------------------------------------------------------
+// Selector - one readable socket among many
+//-------------------------------------------------------------------------------------------------
+static void SelectorWaitToRead(BenchmarkState& state)
+{
+    std::vector<net::DatagramSocket::Ptr> sockets;
+    net::Selector selector;
+    for (int64_t i = 0; i < state.GetArg(); ++i)
+    {
+        net::DatagramSocket::Ptr socket(new net::DatagramSocket());
+        if (socket->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK)
+        {
+            state.SkipWithError("Bind() failed");
+            return;
+        }
+        selector.AddReadableSocket(socket);
+        sockets.push_back(socket);
+    }
+    sockaddr_in local = {};
+    socklen_t localSize = sizeof(local);
+    getsockname(sockets.back()->GetNativeHandle(), reinterpret_cast<sockaddr*>(&local), &localSize);
+    net::Socket::IPv4Address target(local);
+
+    net::DatagramSocket::Ptr sender(new net::DatagramSocket());
+    uint8_t datagram[64] = {};
+    while (state.KeepRunning() == true)
+    {
+        size_t bytes = 0;
+        sender->SendTo(datagram, sizeof(datagram), target, &bytes);
+        struct timeval timeout = { 1, 0 };
+        net::Socket::Set readable;
+        if (selector.WaitToRead(timeout, readable) != net::Selector::Result::OK || readable.size() != 1)
+        {
+            state.SkipWithError("WaitToRead() failed");
+            return;
+        }
+        net::Socket::Address from;
+        sockets.back()->ReceiveFrom(datagram, sizeof(datagram), &from, &bytes);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+    state.SetLabel("send + select + receive");
+}
+
+//-------------------------------------------------------------------------------------------------
+// Loopback - a frame sent as fragments and received, through select() or io_uring
+//-------------------------------------------------------------------------------------------------
+//  Frames whose fragments fit in the default receive buffer, so that nothing is dropped on loopback
+static const std::vector<int64_t> LOOPBACK_FRAME_SIZES = { 1200, 10000, 42000, 105000 };
+static constexpr const int LOOPBACK_RECEIVE_TIMEOUT_MS = 100;
+
+static void LoopbackFrame(BenchmarkState& state, bool ioUring)
+{
+    net::DatagramSocket::Ptr receiver(new net::DatagramSocket());
+    net::DatagramSocket::Ptr sender(new net::DatagramSocket());
+    if (receiver->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK ||
+        sender->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK)
+    {
+        state.SkipWithError("Bind() failed");
+        return;
+    }
+    sockaddr_in local = {};
+    socklen_t localSize = sizeof(local);
+    getsockname(receiver->GetNativeHandle(), reinterpret_cast<sockaddr*>(&local), &localSize);
+    net::Socket::IPv4Address target(local);
+
+    net::DatagramSendRing* sendRing = nullptr;
+    net::DatagramReceiveRing receiveRing;
+    if (ioUring == true)
+    {
+        if ((sendRing = net::DatagramSendRing::GetThreadInstance()) == nullptr ||
+            receiveRing.Init(receiver, DATAGRAM_SIZE) != net::Socket::Result::OK)
+        {
+            state.SkipWithMessage("io_uring is not available");
+            return;
+        }
+    }
+    const uint64_t ringSyscallsStart = ioUring == true ? sendRing->GetSyscallCount() : 0;
+
+    const size_t fragments = (size_t(state.GetArg()) + DATAGRAM_SIZE - 1) / DATAGRAM_SIZE;
+    std::vector<uint8_t> frame(size_t(state.GetArg()), 0x5a);
+    std::vector<uint8_t> datagram(DATAGRAM_SIZE);
+    int64_t packets = 0;
+    int64_t selectSyscalls = 0;     //  The select path makes one select() before each sendto() and recvfrom()
+    while (state.KeepRunning() == true)
+    {
+        for (size_t offset = 0; offset < frame.size(); offset += DATAGRAM_SIZE)
+        {
+            size_t size = std::min(frame.size() - offset, size_t(DATAGRAM_SIZE));
+            if (ioUring == true)
+            {
+                sendRing->Add(sender, frame.data() + offset, size, target);
+            }
+            else
+            {
+                struct timeval timeout = { 1, 0 };
+                net::Selector selector;
+                net::Socket::Set writable;
+                selector.AddWritableSocket(sender);
+                selector.WaitToWrite(timeout, writable);
+                size_t bytes = 0;
+                sender->SendTo(frame.data() + offset, size, target, &bytes);
+                selectSyscalls += 2;
+            }
+        }
+        if (ioUring == true && sendRing->Flush() != net::Socket::Result::OK)
+        {
+            state.SkipWithError("DatagramSendRing::Flush() failed");
+            return;
+        }
+
+        size_t received = 0;
+        if (ioUring == true)
+        {
+            while (received < fragments)
+            {
+                size_t count = 0;
+                if (receiveRing.Receive(LOOPBACK_RECEIVE_TIMEOUT_MS, [](uint8_t* buf, size_t, const net::Socket::Address&) { BenchmarkState::DoNotOptimize(*buf); }, &count) != net::Socket::Result::OK ||
+                    count == 0)
+                {
+                    break;
+                }
+                received += count;
+            }
+        }
+        else
+        {
+            net::Selector selector;
+            selector.AddReadableSocket(receiver);
+            for (; received < fragments; ++received)
+            {
+                struct timeval timeout = { 0, LOOPBACK_RECEIVE_TIMEOUT_MS * 1000 };
+                net::Socket::Set readable;
+                selectSyscalls += 2;
+                if (selector.WaitToRead(timeout, readable) != net::Selector::Result::OK)
+                {
+                    break;
+                }
+                net::Socket::Address from;
+                size_t bytes = 0;
+                receiver->ReceiveFrom(datagram.data(), datagram.size(), &from, &bytes);
+            }
+        }
+        packets += int64_t(received);
+    }
+
+    const uint64_t syscalls = ioUring == true ? sendRing->GetSyscallCount() - ringSyscallsStart + receiveRing.GetSyscallCount() : uint64_t(selectSyscalls);
+    char label[128];
+    snprintf(label, sizeof(label), "%s: %.1f syscalls/frame, %.0f ns CPU/packet, %lld%% received", ioUring == true ? "io_uring" : "select",
+        double(syscalls) / double(state.GetIterations()), double(state.GetCpuTime()) / double(std::max<int64_t>(packets, 1)),
+        static_cast<long long>(packets * 100 / std::max<int64_t>(state.GetIterations() * int64_t(fragments), 1)));
+    state.SetBytesProcessed(state.GetIterations() * state.GetArg());
+    state.SetItemsProcessed(packets);
+    state.SetLabel(label);
+}
+
+#if defined(__linux)
+//-------------------------------------------------------------------------------------------------
+// Local transport - a frame through the shared memory ring vs. the UDP path on loopback
+//-------------------------------------------------------------------------------------------------
+//  Both sides run on one thread, so the time per iteration is the CPU latency of a frame from send to delivery
+static void LocalFrameSharedMemory(BenchmarkState& state)
+{
+    net::SharedMemoryRing producer;
+    net::SharedMemoryRing consumer;
+    int sockets[2] = { -1, -1 };
+    if (producer.Create(transport_amd::LOCAL_RING_SIZE) != net::SharedMemoryRing::Result::OK ||
+        consumer.Attach(dup(producer.GetHandle())) != net::SharedMemoryRing::Result::OK ||
+        socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0)
+    {
+        state.SkipWithError("failed to set up the shared memory ring");
+        return;
+    }
+
+    std::vector<uint8_t> frame(size_t(state.GetArg()), 0x5a);
+    while (state.KeepRunning() == true)
+    {
+        uint64_t position = 0;
+        if (producer.Write(frame.data(), frame.size(), &position) != net::SharedMemoryRing::Result::OK)
+        {
+            state.SkipWithError("Write() failed");
+            break;
+        }
+        transport_amd::LocalRingMessage ringMsg = { VIDEO_CHANNEL_ID, position, uint32_t(frame.size()) };
+        if (send(sockets[0], &ringMsg, sizeof(ringMsg), 0) != ssize_t(sizeof(ringMsg)) ||
+            recv(sockets[1], &ringMsg, sizeof(ringMsg), MSG_WAITALL) != ssize_t(sizeof(ringMsg)))
+        {
+            state.SkipWithError("failed to pass the frame");
+            break;
+        }
+        const uint8_t* payload = consumer.Read(ringMsg.m_Position, ringMsg.m_Size);
+        if (payload == nullptr)
+        {
+            state.SkipWithError("Read() failed");
+            break;
+        }
+        BenchmarkState::DoNotOptimize(payload[ringMsg.m_Size - 1]);
+        consumer.Release(ringMsg.m_Position, ringMsg.m_Size);
+    }
+    close(sockets[0]);
+    close(sockets[1]);
+    state.SetBytesProcessed(state.GetIterations() * state.GetArg());
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+namespace
+{
+    class DecryptingReceiver :
+        public FlowCtrlProtocol::ProcessIncomingCallback
+    {
+    public:
+        DecryptingReceiver(util::AESPSKCipher& cipher) : m_Cipher(cipher) {}
+
+        virtual void OnCompleteMessage(FlowCtrlProtocol::MessageID /*msgID*/, const void* buf, size_t size, const net::Socket::Address& /*receivedFrom*/, uint8_t /*optional*/) override
+        {
+            m_ClearText.resize(m_Cipher.GetClearTextBufferSize(size));
+            size_t clearTextOfs = 0;
+            size_t clearTextSize = 0;
+            if (m_Cipher.Decrypt(buf, size, m_ClearText.data(), &clearTextOfs, &clearTextSize) == true)
+            {
+                ++m_Messages;
+            }
+        }
+        virtual net::Socket::Result OnRequestFragment(const FlowCtrlProtocol::Fragment& /*fragment*/) override { return net::Socket::Result::OK; }
+
+        int64_t m_Messages = 0;
+
+    private:
+        util::AESPSKCipher&     m_Cipher;
+        std::vector<uint8_t>    m_ClearText;
+    };
+}
+
+//  What a same-host client pays without the local transport: encryption, fragmentation, a sendto() and a recvfrom()
+//  per fragment, reassembly and decryption
+static void LocalFrameUdpLoopback(BenchmarkState& state)
+{
+    net::DatagramSocket::Ptr receiverSocket(new net::DatagramSocket());
+    net::DatagramSocket::Ptr senderSocket(new net::DatagramSocket());
+    if (receiverSocket->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK ||
+        senderSocket->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK)
+    {
+        state.SkipWithError("Bind() failed");
+        return;
+    }
+    sockaddr_in local = {};
+    socklen_t localSize = sizeof(local);
+    getsockname(receiverSocket->GetNativeHandle(), reinterpret_cast<sockaddr*>(&local), &localSize);
+    net::Socket::IPv4Address target(local);
+
+    util::AESPSKCipher cipher("ssdk_bench");
+    FlowCtrlProtocol sender(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+    FlowCtrlProtocol receiver(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+    DecryptingReceiver delivered(cipher);
+    std::vector<uint8_t> frame(size_t(state.GetArg()), 0x5a);
+    std::vector<uint8_t> cipherText(cipher.GetCipherTextBufferSize(frame.size()));
+    std::vector<uint8_t> datagram(DATAGRAM_SIZE + sizeof(FlowCtrlProtocol::FragmentHeader));
+    net::Selector selector;
+    selector.AddReadableSocket(receiverSocket);
+    while (state.KeepRunning() == true)
+    {
+        size_t cipherTextSize = 0;
+        cipher.Encrypt(frame.data(), frame.size(), cipherText.data(), &cipherTextSize);
+        FragmentCollector fragments;
+        uint32_t bytesSent = 0;
+        sender.FragmentMessage(cipherText.data(), uint32_t(cipherTextSize), DATAGRAM_SIZE, VIDEO_CHANNEL_ID, fragments, bytesSent);
+        for (const std::vector<uint8_t>& fragment : fragments.m_Datagrams)
+        {
+            size_t bytes = 0;
+            senderSocket->SendTo(fragment.data(), fragment.size(), target, &bytes);
+        }
+        for (size_t received = 0; received < fragments.m_Datagrams.size(); ++received)
+        {
+            struct timeval timeout = { 0, LOOPBACK_RECEIVE_TIMEOUT_MS * 1000 };
+            net::Socket::Set readable;
+            if (selector.WaitToRead(timeout, readable) != net::Selector::Result::OK)
+            {
+                break;
+            }
+            net::Socket::Address from;
+            size_t bytes = 0;
+            if (receiverSocket->ReceiveFrom(datagram.data(), datagram.size(), &from, &bytes) == net::Socket::Result::OK)
+            {
+                receiver.ProcessFragment(datagram.data(), uint32_t(bytes), from, delivered);
+            }
+        }
+    }
+    char label[64];
+    snprintf(label, sizeof(label), "%lld%% delivered", static_cast<long long>(delivered.m_Messages * 100 / std::max<int64_t>(state.GetIterations(), 1)));
+    state.SetBytesProcessed(state.GetIterations() * state.GetArg());
+    state.SetItemsProcessed(delivered.m_Messages);
+    state.SetLabel(label);
+}
+#endif
+
+void RegisterProtocolBenchmarks(BenchmarkRunner& runner)
+{
+    runner.Register("FlowCtrl/Fragment", FlowCtrlFragment, MESSAGE_SIZES);
+    runner.Register("FlowCtrl/Reassemble", FlowCtrlReassemble, MESSAGE_SIZES);
+    runner.Register("FlowCtrl/StreamMix", [](BenchmarkState& state) { FlowCtrlStreamMix(state, false); });
+    runner.Register("FlowCtrl/StreamMix/Traced", [](BenchmarkState& state) { FlowCtrlStreamMix(state, true); });
+    for (const ImpairmentProfile& profile : IMPAIRMENT_PROFILES)
+    {
+        runner.Register(std::string("FlowCtrl/Impaired/") + profile.m_Name, [&profile](BenchmarkState& state) { FlowCtrlImpaired(state, profile); });
+    }
+    runner.Register("MessageChunks/Pack", MessageChunksPack, { 1, 16, 256 });
+    runner.Register("MessageChunks/Unpack", MessageChunksUnpack, { 1, 16, 256 });
+    runner.Register("Selector/WaitToRead", SelectorWaitToRead, { 1, 16, 64, 256 });
+    runner.Register("Loopback/Frame/Select", [](BenchmarkState& state) { LoopbackFrame(state, false); }, LOOPBACK_FRAME_SIZES);
+    runner.Register("Loopback/Frame/IoUring", [](BenchmarkState& state) { LoopbackFrame(state, true); }, LOOPBACK_FRAME_SIZES);
+#if defined(__linux)
+    runner.Register("Local/Frame/SharedMemory", LocalFrameSharedMemory, LOOPBACK_FRAME_SIZES);
+    runner.Register("Local/Frame/UdpLoopback", LocalFrameUdpLoopback, LOOPBACK_FRAME_SIZES);
+#endif
+}
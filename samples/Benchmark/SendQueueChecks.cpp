@@ -0,0 +1,431 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "Benchmark.h"
+
+#include "sdk/transports/transport-amd/SendQueue.h"
+#include "amf/public/common/Thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace ssdk;
+using namespace ssdk::transport_amd;
+
+//-------------------------------------------------------------------------------------------------
+// SendQueue - sliced frames are dropped whole
+//-------------------------------------------------------------------------------------------------
+namespace
+{
+    struct SliceHeader
+    {
+        amf_pts     frameID;
+        int32_t     slice;
+    };
+
+    //  Counts the slices of every frame sent. Holds the first message until released when asked to,
+    //  so that a frame can be caught half sent
+    class SliceRecorder :
+        public SendQueue::Sender
+    {
+    public:
+        SliceRecorder(bool holdFirst) : m_Hold(holdFirst) {}
+
+        virtual transport_common::Result SendQueuedMessage(Channel /*channel*/, const void* msg, size_t msgLen) override
+        {
+            m_Holding = m_Hold.exchange(false);
+            while (m_Holding == true && m_Release == false)
+            {
+                amf_sleep(1);
+            }
+            m_Holding = false;
+            if (msgLen == sizeof(SliceHeader))
+            {
+                amf::AMFLock lock(&m_Guard);
+                ++m_Slices[static_cast<const SliceHeader*>(msg)->frameID];
+                ++m_Sent;
+            }
+            return transport_common::Result::OK;
+        }
+
+        inline int GetSlices(amf_pts frameID) { amf::AMFLock lock(&m_Guard); return m_Slices[frameID]; }
+
+        amf::AMFCriticalSection     m_Guard;
+        std::map<amf_pts, int>      m_Slices;
+        std::atomic<int>            m_Sent = 0;
+        std::atomic<bool>           m_Hold;
+        std::atomic<bool>           m_Holding = false;
+        std::atomic<bool>           m_Release = false;
+    };
+
+    //  Pushes a frame in slices, the class of a sliced frame that is not a key frame is only known from its last slice
+    void PushSlices(SendQueue& queue, amf_pts frameID, int slices, SendQueue::MessageClass messageClass)
+    {
+        for (int slice = 0; slice < slices; ++slice)
+        {
+            SliceHeader header = { frameID, slice };
+            SendQueue::MessageClass sliceClass = messageClass;
+            if (messageClass == SendQueue::MessageClass::VIDEO_NON_REFERENCE && slice < slices - 1)
+            {
+                sliceClass = SendQueue::MessageClass::VIDEO_REFERENCE;
+            }
+            queue.Push(Channel::VIDEO_OUT, &header, sizeof(header), sliceClass, frameID);
+        }
+    }
+
+    //  Waits up to a second for the sender thread
+    template<typename Condition>
+    bool WaitFor(Condition condition)
+    {
+        for (int i = 0; i < 1000 && condition() == false; ++i)
+        {
+            amf_sleep(1);
+        }
+        return condition();
+    }
+}
+
+static void CheckSendQueueSlicedFrames(BenchmarkState& state)
+{
+    static constexpr const int SLICES = 3;
+    static constexpr const amf_pts MAX_AGE = 10 * AMF_MILLISECOND;
+
+    while (state.KeepRunning() == true)
+    {
+        //  Overflow with nothing sent and no key frame queued: a sliced B-frame goes first, then the P-frames,
+        //  including the one whose slices are being pushed, with the slices still to come. A sliced key frame ends the wait in full
+        {
+            SliceRecorder recorder(false);
+            SendQueue queue(recorder, 8, AMF_SECOND);
+            PushSlices(queue, 0, 2, SendQueue::MessageClass::VIDEO_REFERENCE);
+            PushSlices(queue, 1, SLICES, SendQueue::MessageClass::VIDEO_NON_REFERENCE);
+            PushSlices(queue, 2, 2, SendQueue::MessageClass::VIDEO_REFERENCE);
+            PushSlices(queue, 3, SLICES, SendQueue::MessageClass::VIDEO_REFERENCE);
+            PushSlices(queue, 4, SLICES, SendQueue::MessageClass::VIDEO_REFERENCE);
+            PushSlices(queue, 5, SLICES, SendQueue::MessageClass::VIDEO_KEY);
+            PushSlices(queue, 6, SLICES, SendQueue::MessageClass::VIDEO_REFERENCE);
+            queue.Start();
+            WaitFor([&queue]() { return queue.GetStats(false).depth == 0; });
+            queue.Stop();
+
+            const int expected[] = { 0, 0, 0, 0, 0, SLICES, SLICES };
+            std::string error;
+            for (amf_pts frameID = 0; frameID < amf_pts(sizeof(expected) / sizeof(expected[0])) && error.empty() == true; ++frameID)
+            {
+                int slices = recorder.GetSlices(frameID);
+                if (slices != expected[frameID])
+                {
+                    error = "frame " + std::to_string(frameID) + ": " + std::to_string(slices) + " slices sent, expected " + std::to_string(expected[frameID]);
+                }
+            }
+            if (error.empty() == false)
+            {
+                state.SkipWithError(error);
+                break;
+            }
+            if (queue.TakeKeyFrameRequest() == false || queue.GetStats(false).droppedVideo != 5)
+            {
+                state.SkipWithError("the dropped P-frames did not request a key frame or were not counted once each");
+                break;
+            }
+        }
+
+        //  A stale queue is flushed by a new key frame, but not the rest of the frame the sender has started on,
+        //  and the first slice of the new key frame is not flushed by its own later slices
+        {
+            SliceRecorder recorder(true);
+            SendQueue queue(recorder, 64, MAX_AGE);
+            queue.Start();
+            PushSlices(queue, 0, SLICES, SendQueue::MessageClass::VIDEO_KEY);
+            if (WaitFor([&recorder]() { return recorder.m_Holding == true; }) == false)
+            {
+                state.SkipWithError("the sender thread did not pick up the first slice");
+                break;
+            }
+            amf_sleep(int(2 * MAX_AGE / AMF_MILLISECOND));
+            PushSlices(queue, 1, 1, SendQueue::MessageClass::VIDEO_REFERENCE);
+            amf_sleep(int(2 * MAX_AGE / AMF_MILLISECOND));
+            SliceHeader header = { 2, 0 };
+            queue.Push(Channel::VIDEO_OUT, &header, sizeof(header), SendQueue::MessageClass::VIDEO_KEY, 2);
+            amf_sleep(int(2 * MAX_AGE / AMF_MILLISECOND));
+            header.slice = 1;
+            queue.Push(Channel::VIDEO_OUT, &header, sizeof(header), SendQueue::MessageClass::VIDEO_KEY, 2);
+            recorder.m_Release = true;
+            WaitFor([&queue]() { return queue.GetStats(false).depth == 0; });
+            queue.Stop();
+
+            if (recorder.GetSlices(0) != SLICES)
+            {
+                state.SkipWithError("the rest of a frame the sender had started on was dropped");
+                break;
+            }
+            if (recorder.GetSlices(1) != 0 || recorder.GetSlices(2) != 2)
+            {
+                state.SkipWithError("a new key frame did not supersede the stale frame, or was not sent in full");
+                break;
+            }
+        }
+    }
+}
+
+//  One producer feeding the queues of a fast and a deliberately slow consumer, as the server does for two subscribers:
+//  the fast one gets every frame while the slow one falls behind, and every frame the slow one gets is decodable
+namespace
+{
+    //  GOP of 30 with every third frame non-referenced
+    SendQueue::MessageClass GetFrameClass(amf_pts frameID)
+    {
+        return frameID % 30 == 0 ? SendQueue::MessageClass::VIDEO_KEY :
+            (frameID % 3 == 2 ? SendQueue::MessageClass::VIDEO_NON_REFERENCE : SendQueue::MessageClass::VIDEO_REFERENCE);
+    }
+
+    //  The reference frame a frame depends on
+    amf_pts GetReferenceFrame(amf_pts frameID)
+    {
+        amf_pts reference = frameID - 1;
+        while (GetFrameClass(reference) == SendQueue::MessageClass::VIDEO_NON_REFERENCE)
+        {
+            --reference;
+        }
+        return reference;
+    }
+
+    class FrameRecorder :
+        public SendQueue::Sender
+    {
+    public:
+        FrameRecorder(amf_pts delay) : m_Delay(delay) {}
+
+        virtual transport_common::Result SendQueuedMessage(Channel /*channel*/, const void* msg, size_t msgLen) override
+        {
+            if (m_Delay > 0)
+            {
+                amf_sleep(amf_ulong(m_Delay / AMF_MILLISECOND));
+            }
+            if (msgLen == sizeof(amf_pts))
+            {
+                amf::AMFLock lock(&m_Guard);
+                m_Frames.push_back(*static_cast<const amf_pts*>(msg));
+            }
+            return transport_common::Result::OK;
+        }
+
+        inline std::vector<amf_pts> GetFrames() { amf::AMFLock lock(&m_Guard); return m_Frames; }
+
+        //  Empty when every frame received can be decoded
+        std::string FindUndecodable()
+        {
+            std::vector<amf_pts> frames = GetFrames();
+            std::set<amf_pts> received;
+            std::string error;
+            for (size_t i = 0; i < frames.size() && error.empty() == true; ++i)
+            {
+                if (i > 0 && frames[i] <= frames[i - 1])
+                {
+                    error = "frame " + std::to_string(frames[i]) + " was sent out of order";
+                }
+                else if (GetFrameClass(frames[i]) != SendQueue::MessageClass::VIDEO_KEY && received.count(GetReferenceFrame(frames[i])) == 0)
+                {
+                    error = "frame " + std::to_string(frames[i]) + " was sent without the frame it references";
+                }
+                if (GetFrameClass(frames[i]) != SendQueue::MessageClass::VIDEO_NON_REFERENCE)
+                {
+                    received.insert(frames[i]);
+                }
+            }
+            return error;
+        }
+
+    private:
+        const amf_pts               m_Delay;
+        amf::AMFCriticalSection     m_Guard;
+        std::vector<amf_pts>        m_Frames;
+    };
+}
+
+static void CheckSendQueueFastAndSlowConsumers(BenchmarkState& state)
+{
+    static constexpr const amf_pts FRAMES = 100;
+    static constexpr const amf_pts FRAME_INTERVAL = 5 * AMF_MILLISECOND;
+
+    while (state.KeepRunning() == true)
+    {
+        //  A full queue holding a key frame and the frames depending on it: they stay decodable, nothing is dropped
+        //  and no other key frame is asked for
+        {
+            FrameRecorder recorder(0);
+            SendQueue queue(recorder, 8, AMF_SECOND);
+            for (amf_pts frameID = 0; frameID < 10; ++frameID)
+            {
+                queue.Push(Channel::VIDEO_OUT, &frameID, sizeof(frameID), frameID == 0 ? SendQueue::MessageClass::VIDEO_KEY : SendQueue::MessageClass::VIDEO_REFERENCE, frameID);
+            }
+            queue.Start();
+            WaitFor([&queue]() { return queue.GetStats(false).depth == 0; });
+            queue.Stop();
+            if (recorder.GetFrames().size() != 10 || queue.TakeKeyFrameRequest() == true)
+            {
+                state.SkipWithError("frames after a queued key frame were dropped or another key frame was requested");
+                break;
+            }
+        }
+
+        FrameRecorder fast(0);
+        FrameRecorder slow(3 * FRAME_INTERVAL);
+        SendQueue fastQueue(fast, 64, AMF_SECOND);
+        SendQueue slowQueue(slow, 8, 200 * AMF_MILLISECOND);
+        fastQueue.Start();
+        slowQueue.Start();
+        amf_pts maxPush = 0;
+        for (amf_pts frameID = 0; frameID < FRAMES; ++frameID)
+        {
+            //  Both queues keep a reference to the same buffer
+            util::BufferPool::Lease frame = util::BufferPool::GetInstance().Acquire(&frameID, sizeof(frameID));
+            amf_pts start = amf_high_precision_clock();
+            fastQueue.Push(Channel::VIDEO_OUT, frame, GetFrameClass(frameID), frameID);
+            slowQueue.Push(Channel::VIDEO_OUT, frame, GetFrameClass(frameID), frameID);
+            maxPush = std::max(maxPush, amf_high_precision_clock() - start);
+            amf_sleep(amf_ulong(FRAME_INTERVAL / AMF_MILLISECOND));
+        }
+        bool fastDone = WaitFor([&fast]() { return fast.GetFrames().size() == size_t(FRAMES); });
+        fastQueue.Stop();
+        slowQueue.Stop();
+
+        SendQueue::Stats slowStats = slowQueue.GetStats(false);
+        std::string error = slow.FindUndecodable();
+        if (fastDone == false || fastQueue.GetStats(false).droppedVideo != 0)
+        {
+            state.SkipWithError("the fast consumer got " + std::to_string(fast.GetFrames().size()) + " of " + std::to_string(FRAMES) + " frames");
+            break;
+        }
+        if (maxPush > 20 * AMF_MILLISECOND)
+        {
+            state.SkipWithError("pushing a frame took " + std::to_string(maxPush / AMF_MILLISECOND) + " ms, the producer was held up by the slow consumer");
+            break;
+        }
+        if (slowStats.droppedVideo == 0)
+        {
+            state.SkipWithError("the slow consumer had no frames dropped");
+            break;
+        }
+        if (error.empty() == false)
+        {
+            state.SkipWithError("slow consumer: " + error);
+            break;
+        }
+    }
+}
+
+//  A P-only stream paced to half its bitrate: every frame goes out, none before the bucket allows it,
+//  and control messages overtake the video held back
+namespace
+{
+    class PacedRecorder :
+        public SendQueue::Sender
+    {
+    public:
+        virtual transport_common::Result SendQueuedMessage(Channel channel, const void* /*msg*/, size_t /*msgLen*/) override
+        {
+            if (channel == Channel::VIDEO_OUT)
+            {
+                ++m_Video;
+            }
+            else if (m_VideoBeforeControl < 0)
+            {
+                m_VideoBeforeControl = m_Video.load();
+            }
+            return transport_common::Result::OK;
+        }
+
+        std::atomic<int>            m_Video = 0;
+        std::atomic<int>            m_VideoBeforeControl = -1;
+    };
+}
+
+static void CheckSendQueuePacing(BenchmarkState& state)
+{
+    static constexpr const int64_t BITRATE = 1000000;
+    static constexpr const int FRAMES = 20;
+    static constexpr const size_t FRAME_SIZE = BITRATE / 100 / 8;      //  10 ms worth each
+
+    std::vector<uint8_t> frame(FRAME_SIZE, 0);
+    while (state.KeepRunning() == true)
+    {
+        PacedRecorder recorder;
+        SendQueue queue(recorder, 64, AMF_SECOND);
+        queue.SetPacingBitrate(BITRATE);
+        for (int i = 0; i < FRAMES; ++i)
+        {
+            queue.Push(Channel::VIDEO_OUT, frame.data(), frame.size(), i == 0 ? SendQueue::MessageClass::VIDEO_KEY : SendQueue::MessageClass::VIDEO_REFERENCE, amf_pts(i));
+        }
+        uint8_t control = 0;
+        queue.Push(Channel::SERVICE, &control, sizeof(control), SendQueue::MessageClass::CONTROL);
+
+        amf_pts start = amf_high_precision_clock();
+        queue.Start();
+        WaitFor([&recorder]() { return recorder.m_Video == FRAMES; });
+        amf_pts elapsed = amf_high_precision_clock() - start;
+        queue.Stop();
+
+        SendQueue::Stats stats = queue.GetStats(false);
+        if (recorder.m_Video != FRAMES || stats.droppedVideo != 0 || queue.TakeKeyFrameRequest() == true)
+        {
+            state.SkipWithError("paced P-frames were dropped instead of delayed: " + std::to_string(recorder.m_Video) + " of " + std::to_string(FRAMES) + " sent");
+            break;
+        }
+        //  The first frame goes out at once, the rest at 10 ms intervals
+        if (elapsed < (FRAMES - 1) * 10 * AMF_MILLISECOND * 3 / 4)
+        {
+            state.SkipWithError("video went out faster than the pacing bitrate: " + std::to_string(elapsed / AMF_MILLISECOND) + " ms");
+            break;
+        }
+        if (recorder.m_VideoBeforeControl < 0 || recorder.m_VideoBeforeControl >= FRAMES / 2)
+        {
+            state.SkipWithError("a control message waited behind paced video");
+            break;
+        }
+    }
+}
+
+void RegisterSendQueueChecks(BenchmarkRunner& runner)
+{
+    runner.RegisterCheck("Check/SendQueue/SlicedFrames", CheckSendQueueSlicedFrames);
+    runner.RegisterCheck("Check/SendQueue/Pacing", CheckSendQueuePacing);
+    runner.RegisterCheck("Check/SendQueue/FastAndSlowConsumers", CheckSendQueueFastAndSlowConsumers);
+}
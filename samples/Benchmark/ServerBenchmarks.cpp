@@ -0,0 +1,668 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+#include "Benchmark.h"
+
+#include "sdk/net/DatagramServer.h"
+#include "sdk/net/Selector.h"
+#include "sdk/net/TimerWheel.h"
+
+#include "amf/public/common/Thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#if defined(__linux)
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#endif
+
+using namespace ssdk;
+
+//-------------------------------------------------------------------------------------------------
+// Timer wheel accuracy: random schedules, cancellations and advances against a model of when every timer is due. A
+// timer must not fire before its delay has passed from the last Advance(), nor later than two ticks of rounding plus
+// the step of the Advance() that fires it, and a cancelled timer must not fire at all
+//-------------------------------------------------------------------------------------------------
+static void CheckTimerWheelAccuracy(BenchmarkState& state)
+{
+    static constexpr const int OPERATIONS = 200000;
+    static constexpr const amf_pts RESOLUTION = net::TimerWheel::DEFAULT_RESOLUTION;
+
+    class ModelTimer
+    {
+    public:
+        amf_pts m_Due = 0;
+        bool    m_Cancelled = false;
+        amf_pts m_Fired = -1;
+    };
+
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        std::mt19937 generator(2211);
+        std::uniform_int_distribution<int> operation(0, 9);
+        std::uniform_int_distribution<amf_pts> shortDelay(0, 100 * RESOLUTION);
+        std::uniform_int_distribution<amf_pts> longDelay(0, 10000 * RESOLUTION);   //  Spans the first two levels, exercises cascading
+        std::uniform_int_distribution<amf_pts> step(0, 3 * RESOLUTION);
+
+        net::TimerWheel wheel(RESOLUTION);
+        std::vector<ModelTimer> model(1);       //  Indexed by TimerID, which the wheel hands out in sequence
+        std::vector<net::TimerWheel::TimerID> pending;
+        amf_pts now = 0;
+        amf_pts lastStep = 0;
+        int64_t fired = 0;
+        std::string error;
+        wheel.Advance(now);
+        for (int i = 0; i < OPERATIONS && error.empty() == true; ++i)
+        {
+            const int kind = operation(generator);
+            if (kind < 5)
+            {
+                const amf_pts delay = kind == 0 ? longDelay(generator) : shortDelay(generator);
+                const net::TimerWheel::TimerID id = net::TimerWheel::TimerID(model.size());
+                model.push_back({ now + delay });
+                if (wheel.Schedule(delay, [&, id]() { model[id].m_Fired = now; }) != id)
+                {
+                    error = "Schedule() returned an unexpected timer ID";
+                }
+                pending.push_back(id);
+            }
+            else if (kind < 7 && pending.empty() == false)
+            {
+                std::uniform_int_distribution<size_t> pick(0, pending.size() - 1);
+                const size_t index = pick(generator);
+                ModelTimer& timer = model[pending[index]];
+                if (wheel.Cancel(pending[index]) != (timer.m_Fired < 0))
+                {
+                    error = "Cancel() did not match whether the timer has fired";
+                }
+                timer.m_Cancelled = timer.m_Fired < 0;
+                pending[index] = pending.back();
+                pending.pop_back();
+            }
+            else
+            {
+                lastStep = step(generator);
+                now += lastStep;
+                fired += int64_t(wheel.Advance(now));
+                for (size_t j = 0; j < pending.size(); )
+                {
+                    const ModelTimer& timer = model[pending[j]];
+                    if (timer.m_Fired >= 0 && timer.m_Fired < timer.m_Due)
+                    {
+                        error = "a timer fired " + std::to_string((timer.m_Due - timer.m_Fired) / 10) + " us early";
+                    }
+                    else if (timer.m_Fired >= 0 && timer.m_Fired - timer.m_Due >= 2 * RESOLUTION + lastStep)
+                    {
+                        error = "a timer fired " + std::to_string((timer.m_Fired - timer.m_Due) / 10) + " us late";
+                    }
+                    else if (timer.m_Fired < 0 && now - timer.m_Due >= 2 * RESOLUTION + lastStep)
+                    {
+                        error = "a timer did not fire " + std::to_string((now - timer.m_Due) / 10) + " us after it was due";
+                    }
+                    if (timer.m_Fired >= 0)
+                    {
+                        pending[j] = pending.back();
+                        pending.pop_back();
+                    }
+                    else
+                    {
+                        ++j;
+                    }
+                }
+            }
+        }
+        for (size_t id = 1; id < model.size() && error.empty() == true; ++id)
+        {
+            if (model[id].m_Cancelled == true && model[id].m_Fired >= 0)
+            {
+                error = "a cancelled timer has fired";
+            }
+        }
+
+        if (error.empty() == false)
+        {
+            state.SkipWithError(error);
+            failed = true;
+            break;
+        }
+        state.SetLabel(std::to_string(model.size() - 1) + " timers, " + std::to_string(fired) + " fired");
+    }
+}
+
+#if defined(__linux)
+//-------------------------------------------------------------------------------------------------
+// A bare DatagramServer with receive shards sharing a port through SO_REUSEPORT. Every datagram starts with the
+// connection ID of its session, 0 for the first one. Sessions count what they receive and on which thread, and can
+// spend some time on every datagram in place of the decryption and reassembly of a real session.
+//-------------------------------------------------------------------------------------------------
+static constexpr const size_t SHARD_DATAGRAM_SIZE = 1500;
+static constexpr const size_t SHARD_MAX_CONNECTIONS = 4096;
+
+class ShardSession :
+    public amf::AMFInterfaceBase,
+    public net::DatagramServerSession
+{
+public:
+    AMF_BEGIN_INTERFACE_MAP
+        AMF_INTERFACE_MULTI_ENTRY(net::DatagramServerSession)
+        AMF_INTERFACE_MULTI_ENTRY(net::Session)
+    AMF_END_INTERFACE_MAP
+
+    ShardSession(const net::Socket::Address& peer, amf_pts workPerDatagram) : net::DatagramServerSession(peer), m_WorkPerDatagram(workPerDatagram) {}
+
+    inline int64_t GetReceived() const noexcept { return m_Received; }
+    inline int64_t GetWrongThreadCalls() const noexcept { return m_WrongThreadCalls; }
+
+protected:
+    virtual net::Session::Result AMF_STD_CALL OnInit() override { return net::Session::Result::OK; }
+    virtual net::Session::Result AMF_STD_CALL OnSessionTimeout() override { return net::Session::Result::OK; }
+    virtual net::Session::Result AMF_STD_CALL OnSessionClose() override { return net::Session::Result::OK; }
+    virtual net::Socket::Result AMF_STD_CALL Send(const void*, size_t, size_t* const, int) override { return net::Socket::Result::OK; }
+
+    virtual bool AMF_STD_CALL OnTickNotify() override
+    {
+        CheckThread();
+        return true;
+    }
+
+    virtual net::Session::Result AMF_STD_CALL OnDataReceived(const void*, size_t, const net::Socket::Address&) override
+    {
+        CheckThread();
+        for (amf_pts end = amf_high_precision_clock() + m_WorkPerDatagram; m_WorkPerDatagram > 0 && amf_high_precision_clock() < end; )
+        {
+        }
+        ++m_Received;
+        return net::Session::Result::OK;
+    }
+
+    //  Any new address is accepted at once, the path validation itself is the transport's business
+    virtual bool AMF_STD_CALL ValidatePeerAddress(const void*, size_t, const net::Socket::Address& receivedFrom) override
+    {
+        CheckThread();
+        amf::AMFLock lock(&m_PeerGuard);
+        m_Peer = receivedFrom;
+        return true;
+    }
+
+private:
+    void CheckThread();
+
+private:
+    const amf_pts           m_WorkPerDatagram;
+    std::atomic<int64_t>    m_Received{ 0 };
+    std::atomic<int64_t>    m_WrongThreadCalls{ 0 };
+};
+
+//  Connection IDs are shared by the shards, like the connection table of transport_amd::ServerImpl
+class ShardConnections
+{
+public:
+    net::DatagramServerSession::ConnectionID Register(net::DatagramServerSession* session)
+    {
+        amf::AMFLock lock(&m_Guard);
+        net::DatagramServerSession::ConnectionID connectionID = net::DatagramServerSession::ConnectionID(m_Connections.size() + 1);
+        m_Connections[connectionID] = net::DatagramServerSession::Ptr(session);
+        return connectionID;
+    }
+
+    size_t GetCount() const
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_Connections.size();
+    }
+
+    net::DatagramServerSession::Ptr Find(net::DatagramServerSession::ConnectionID connectionID) const
+    {
+        amf::AMFLock lock(&m_Guard);
+        std::map<net::DatagramServerSession::ConnectionID, net::DatagramServerSession::Ptr>::const_iterator it = m_Connections.find(connectionID);
+        return it != m_Connections.end() ? it->second : nullptr;
+    }
+
+private:
+    mutable amf::AMFCriticalSection m_Guard;
+    std::map<net::DatagramServerSession::ConnectionID, net::DatagramServerSession::Ptr> m_Connections;
+};
+
+class ShardServer :
+    public net::DatagramServer,
+    protected amf::AMFThread
+{
+public:
+    ShardServer(net::DatagramSocket* socket, ShardConnections& connections, size_t maxConnections = SHARD_MAX_CONNECTIONS, amf_pts workPerDatagram = 0) :
+        net::DatagramServer(socket, SHARD_DATAGRAM_SIZE, maxConnections, 10),
+        m_Connections(connections),
+        m_WorkPerDatagram(workPerDatagram)
+    {
+    }
+
+    //  Binds to the port of the first shard, 0 picks a free one
+    bool Bind(uint16_t port)
+    {
+        int yes = 1;
+        return m_Socket->SetSocketOpt(SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) == net::Socket::Result::OK &&
+               m_Socket->Bind(net::Socket::IPv4Address("127.0.0.1", port)) == net::Socket::Result::OK;
+    }
+
+    uint16_t GetPort() const
+    {
+        sockaddr_in local = {};
+        socklen_t localSize = sizeof(local);
+        getsockname(m_Socket->GetNativeHandle(), reinterpret_cast<sockaddr*>(&local), &localSize);
+        return ntohs(local.sin_port);
+    }
+
+    void StartShard()
+    {
+        Start();
+        while (IsServerRunning() == false)
+        {
+            amf_sleep(1);
+        }
+    }
+
+    void StopShard()
+    {
+        ShutdownServer();
+        RequestStop();
+        WaitForStop();
+        TerminateSessions();
+    }
+
+    inline bool IsShardThread() const { return m_ThreadID == std::this_thread::get_id(); }
+
+    //  CPU time of the shard's thread in ns, valid once StartShard() has returned
+    int64_t GetThreadCpuTime() const
+    {
+        struct timespec ts = {};
+        clock_gettime(m_CpuClock, &ts);
+        return int64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+protected:
+    virtual void Run() override
+    {
+        m_ThreadID = std::this_thread::get_id();
+        pthread_getcpuclockid(pthread_self(), &m_CpuClock);
+        RunServer();
+    }
+
+    virtual net::Session::Ptr AMF_STD_CALL OnCreateSession(const net::Socket::Address& peer, net::Socket*, uint8_t*, size_t) override
+    {
+        ShardSession* session = new amf::AMFInterfaceMultiImpl<ShardSession, net::Session, const net::Socket::Address&, amf_pts>(peer, m_WorkPerDatagram);
+        session->SetConnectionID(m_Connections.Register(session));
+        return net::Session::Ptr(session);
+    }
+
+    virtual bool AMF_STD_CALL ExtractConnectionID(uint8_t* buf, size_t& bufSize, net::DatagramServerSession::ConnectionID& connectionID) override
+    {
+        bool result = false;
+        if (bufSize > sizeof(connectionID))
+        {
+            memcpy(&connectionID, buf, sizeof(connectionID));
+            bufSize -= sizeof(connectionID);
+            memmove(buf, buf + sizeof(connectionID), bufSize);
+            result = connectionID != net::DatagramServerSession::INVALID_CONNECTION_ID;
+        }
+        return result;
+    }
+
+    virtual net::DatagramServerSession::Ptr AMF_STD_CALL FindSession(net::DatagramServerSession::ConnectionID connectionID) override
+    {
+        return m_Connections.Find(connectionID);
+    }
+
+private:
+    ShardConnections&   m_Connections;
+    const amf_pts       m_WorkPerDatagram;
+    std::thread::id     m_ThreadID;
+    clockid_t           m_CpuClock = CLOCK_THREAD_CPUTIME_ID;
+};
+
+void ShardSession::CheckThread()
+{
+    const ShardServer* owner = static_cast<const ShardServer*>(GetOwner());
+    if (owner == nullptr || owner->IsShardThread() == false)
+    {
+        ++m_WrongThreadCalls;
+    }
+}
+
+//  A client socket on a port of its own, which the kernel hashes to one of the shards
+static net::DatagramSocket::Ptr OpenShardClient()
+{
+    net::DatagramSocket::Ptr socket(new net::DatagramSocket());
+    return socket->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) == net::Socket::Result::OK ? socket : nullptr;
+}
+
+static bool SendToShards(net::DatagramSocket* socket, uint16_t port, net::DatagramServerSession::ConnectionID connectionID)
+{
+    uint8_t datagram[64] = {};
+    memcpy(datagram, &connectionID, sizeof(connectionID));
+    size_t bytesSent = 0;
+    return socket->SendTo(datagram, sizeof(datagram), net::Socket::IPv4Address("127.0.0.1", port), &bytesSent) == net::Socket::Result::OK;
+}
+
+//  The address the shards see the client's datagrams come from
+static net::Socket::Address GetLoopbackAddress(net::DatagramSocket* socket)
+{
+    sockaddr_in local = {};
+    socklen_t localSize = sizeof(local);
+    getsockname(socket->GetNativeHandle(), reinterpret_cast<sockaddr*>(&local), &localSize);
+    local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return net::Socket::IPv4Address(local);
+}
+
+//  Waits up to a second, long enough for a shard to pick up a posted datagram at its next select() timeout
+template<typename Condition>
+static bool WaitFor(Condition condition)
+{
+    for (int i = 0; i < 1000 && condition() == false; ++i)
+    {
+        amf_sleep(1);
+    }
+    return condition();
+}
+
+//  One session for each of count loopback addresses from 127.0.0.2 up, so that any number of sessions takes one client
+//  socket at a time. Socket::Bind() binds to the interface rather than the address on Linux, hence the plain bind()
+static bool CreateShardSessions(ShardConnections& connections, uint16_t port, size_t count)
+{
+    static constexpr const size_t BATCH = 256;     //  Well within the receive buffer of the server socket
+    for (size_t i = 0; i < count; ++i)
+    {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK + 1 + uint32_t(i));
+        net::DatagramSocket::Ptr client(new net::DatagramSocket());
+        if (bind(client->GetNativeHandle(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            SendToShards(client, port, net::DatagramServerSession::INVALID_CONNECTION_ID) == false)
+        {
+            return false;
+        }
+        if (((i + 1) % BATCH == 0 || i + 1 == count) && WaitFor([&]() { return connections.GetCount() >= i + 1; }) == false)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Connection migration across receive shards: after the client moves to an address which is hashed to another shard,
+// its session has to be handed over to that shard rather than run by two threads
+//-------------------------------------------------------------------------------------------------
+static void CheckDatagramServerShardMigration(BenchmarkState& state)
+{
+    static constexpr const int MAX_REBINDS = 64;
+    static constexpr const int DATAGRAMS = 100;
+
+    while (state.KeepRunning() == true)
+    {
+        ShardConnections connections;
+        ShardServer first(new net::DatagramSocket(), connections);
+        ShardServer second(new net::DatagramSocket(), connections);
+        if (first.Bind(0) == false || second.Bind(first.GetPort()) == false)
+        {
+            state.SkipWithMessage("SO_REUSEPORT is not available");
+            break;
+        }
+        const uint16_t port = first.GetPort();
+        first.StartShard();
+        second.StartShard();
+
+        net::DatagramSocket::Ptr client = OpenShardClient();
+        net::DatagramServerSession::Ptr session;
+        if (client == nullptr || SendToShards(client, port, net::DatagramServerSession::INVALID_CONNECTION_ID) == false ||
+            WaitFor([&]() { return (session = connections.Find(1)) != nullptr && session->GetOwner() != nullptr; }) == false)
+        {
+            state.SkipWithError("the session was not created");
+        }
+        else
+        {
+            //  Rebind until the client lands on the other shard
+            net::DatagramServer* createdBy = session->GetOwner();
+            for (int i = 0; i < MAX_REBINDS && session->GetOwner() == createdBy; ++i)
+            {
+                net::DatagramSocket::Ptr rebound = OpenShardClient();
+                if (rebound == nullptr || SendToShards(rebound, port, session->GetConnectionID()) == false)
+                {
+                    break;
+                }
+                const net::Socket::Address reboundAddress = GetLoopbackAddress(rebound);
+                if (WaitFor([&]() { return session->GetPeerAddress() == reboundAddress; }) == true)
+                {
+                    client = rebound;
+                    amf_sleep(10);      //  The handover follows right after the new address is validated
+                }
+            }
+            ShardSession* shardSession = static_cast<ShardSession*>(session.GetPtr());
+            const int64_t receivedBefore = shardSession->GetReceived();
+            for (int i = 0; i < DATAGRAMS; ++i)
+            {
+                SendToShards(client, port, session->GetConnectionID());
+            }
+            WaitFor([&]() { return shardSession->GetReceived() >= receivedBefore + DATAGRAMS; });
+            amf_sleep(3 * COMM_SELECTOR_FLUSH_INTERVAL_IN_MS);     //  Let the ticks of the new owner run
+
+            if (session->GetOwner() == createdBy)
+            {
+                state.SkipWithError("the session was not handed over to the shard its new address is hashed to");
+            }
+            else if (shardSession->GetReceived() < receivedBefore + DATAGRAMS)
+            {
+                state.SkipWithError("datagrams were lost after the handover");
+            }
+            else if (shardSession->GetWrongThreadCalls() != 0)
+            {
+                state.SkipWithError("the session was run by a thread other than its owner's");
+            }
+        }
+        second.StopShard();
+        first.StopShard();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Session housekeeping: CPU time the server thread spends per second on the ticks and timers of idle sessions, each
+// of which ticks once per flush interval
+//-------------------------------------------------------------------------------------------------
+static const std::vector<int64_t> HOUSEKEEPING_SESSIONS = { 10, 100, 1000, 10000 };
+
+static void DatagramServerHousekeeping(BenchmarkState& state)
+{
+    const size_t sessions = size_t(state.GetArg());
+    ShardConnections connections;
+    ShardServer server(new net::DatagramSocket(), connections, sessions);
+    if (server.Bind(0) == false)
+    {
+        state.SkipWithError("the server could not bind to a port");
+        return;
+    }
+    server.StartShard();
+    if (CreateShardSessions(connections, server.GetPort(), sessions) == false)
+    {
+        state.SkipWithError("only " + std::to_string(connections.GetCount()) + " of " + std::to_string(sessions) + " sessions were created");
+    }
+    else
+    {
+        const int64_t cpuStart = server.GetThreadCpuTime();
+        while (state.KeepRunning() == true)
+        {
+            amf_sleep(COMM_SELECTOR_FLUSH_INTERVAL_IN_MS);     //  Every session ticks once per flush interval
+        }
+        const double cpuTime = double(server.GetThreadCpuTime() - cpuStart);
+        char label[64];
+        snprintf(label, sizeof(label), "%.3f ms of server CPU per second", state.GetRealTime() > 0 ? cpuTime * 1000.0 / double(state.GetRealTime()) : 0.0);
+        state.SetLabel(label);
+        state.SetItemsProcessed(state.GetIterations() * int64_t(sessions));     //  Session ticks
+    }
+    server.StopShard();
+}
+
+//-------------------------------------------------------------------------------------------------
+// Receive shards: datagrams per second received from many clients by 1, 2 and 4 shards on one port. Every datagram
+// costs its session about a microsecond, so the shards have work to spread over the cores. The label gives the number
+// of cores, as the shards can't receive more than a single one does on one core.
+//-------------------------------------------------------------------------------------------------
+static const std::vector<int64_t> SHARD_COUNTS = { 1, 2, 4 };
+static constexpr const size_t SHARD_CLIENTS = 32;
+static constexpr const size_t SHARD_SENDERS = 4;
+static constexpr const size_t SHARD_PAYLOAD_SIZE = 1200;
+static constexpr const amf_pts SHARD_WORK_PER_DATAGRAM = AMF_MILLISECOND / 1000;
+
+static void DatagramServerShards(BenchmarkState& state)
+{
+    const size_t shardCount = size_t(state.GetArg());
+    ShardConnections connections;
+    std::vector<std::unique_ptr<ShardServer>> shards;
+    bool bound = true;
+    for (size_t i = 0; i < shardCount && bound == true; ++i)
+    {
+        shards.emplace_back(new ShardServer(new net::DatagramSocket(), connections, SHARD_MAX_CONNECTIONS, SHARD_WORK_PER_DATAGRAM));
+        bound = shards.back()->Bind(i == 0 ? 0 : shards.front()->GetPort());
+    }
+    if (bound == false)
+    {
+        state.SkipWithMessage("SO_REUSEPORT is not available");
+        return;
+    }
+    const uint16_t port = shards.front()->GetPort();
+    for (std::unique_ptr<ShardServer>& shard : shards)
+    {
+        shard->StartShard();
+    }
+
+    std::vector<net::DatagramSocket::Ptr> clients;
+    for (size_t i = 0; i < SHARD_CLIENTS; ++i)
+    {
+        net::DatagramSocket::Ptr client = OpenShardClient();
+        if (client != nullptr && SendToShards(client, port, net::DatagramServerSession::INVALID_CONNECTION_ID) == true)
+        {
+            clients.push_back(client);
+        }
+    }
+    if (clients.size() < SHARD_CLIENTS || WaitFor([&]() { return connections.GetCount() >= SHARD_CLIENTS; }) == false)
+    {
+        state.SkipWithError("only " + std::to_string(connections.GetCount()) + " of " + std::to_string(SHARD_CLIENTS) + " sessions were created");
+    }
+    else
+    {
+        std::vector<net::DatagramServerSession::Ptr> owned;
+        std::vector<ShardSession*> sessions;
+        std::vector<net::DatagramServer*> busyShards;
+        for (net::DatagramServerSession::ConnectionID connectionID = 1; connectionID <= SHARD_CLIENTS; ++connectionID)
+        {
+            owned.push_back(connections.Find(connectionID));
+            sessions.push_back(static_cast<ShardSession*>(owned.back().GetPtr()));
+            if (std::find(busyShards.begin(), busyShards.end(), owned.back()->GetOwner()) == busyShards.end())
+            {
+                busyShards.push_back(owned.back()->GetOwner());
+            }
+        }
+        auto received = [&]()
+        {
+            int64_t total = 0;
+            for (ShardSession* session : sessions)
+            {
+                total += session->GetReceived();
+            }
+            return total;
+        };
+
+        //  Senders flood the port from every client, what the shards can't keep up with is dropped by the kernel
+        std::atomic<bool> sending{ true };
+        std::atomic<int64_t> sent{ 0 };
+        std::vector<std::thread> senders;
+        for (size_t i = 0; i < SHARD_SENDERS; ++i)
+        {
+            senders.emplace_back([&, i]()
+            {
+                uint8_t payload[SHARD_PAYLOAD_SIZE] = {};
+                net::Socket::IPv4Address to("127.0.0.1", port);
+                for (size_t client = i; sending == true; client = client + SHARD_SENDERS < clients.size() ? client + SHARD_SENDERS : i)
+                {
+                    size_t bytesSent = 0;
+                    if (clients[client]->SendTo(payload, sizeof(payload), to, &bytesSent) == net::Socket::Result::OK)
+                    {
+                        ++sent;
+                    }
+                }
+            });
+        }
+        amf_sleep(10);      //  Let the receive queues fill up
+        const int64_t receivedStart = received();
+        const int64_t sentStart = sent;
+        while (state.KeepRunning() == true)
+        {
+            amf_sleep(10);
+        }
+        const int64_t receivedCount = received() - receivedStart;
+        const int64_t sentCount = sent - sentStart;
+        sending = false;
+        for (std::thread& sender : senders)
+        {
+            sender.join();
+        }
+
+        char label[96];
+        snprintf(label, sizeof(label), "%zu of %zu shards busy, %.1f%% dropped, %u cores", busyShards.size(), shardCount,
+                 sentCount > 0 ? 100.0 * double(sentCount - receivedCount) / double(sentCount) : 0.0, std::thread::hardware_concurrency());
+        state.SetLabel(label);
+        state.SetItemsProcessed(receivedCount);
+        state.SetBytesProcessed(receivedCount * int64_t(SHARD_PAYLOAD_SIZE));
+    }
+    for (std::unique_ptr<ShardServer>& shard : shards)
+    {
+        shard->StopShard();
+    }
+}
+#endif
+
+void RegisterServerBenchmarks(BenchmarkRunner& runner)
+{
+    runner.RegisterCheck("Check/TimerWheel/Accuracy", CheckTimerWheelAccuracy);
+#if defined(__linux)
+    runner.Register("DatagramServer/Housekeeping", DatagramServerHousekeeping, HOUSEKEEPING_SESSIONS);
+    runner.Register("DatagramServer/Shards", DatagramServerShards, SHARD_COUNTS);
+    runner.RegisterCheck("Check/DatagramServer/ShardMigration", CheckDatagramServerShardMigration);
+#endif
+}
@@ -0,0 +1,174 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "Benchmark.h"
+
+#if defined(__linux)
+#include "sdk/net/SharedMemoryRing.h"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace ssdk;
+
+//-------------------------------------------------------------------------------------------------
+// SharedMemoryRing - a ring whose header the client can write to
+//-------------------------------------------------------------------------------------------------
+//  The client maps the ring header read/write: a bogus read position or capacity stored there must not make
+//  the producer write outside the ring, and the seals must keep the client from resizing the mapping
+static void CheckSharedMemoryRingUntrustedHeader(BenchmarkState& state)
+{
+    static constexpr const size_t CAPACITY = 64 * 1024;
+    static constexpr const size_t HEADER_SIZE = 4096;
+    net::SharedMemoryRing producer;
+    if (producer.Create(CAPACITY) != net::SharedMemoryRing::Result::OK)
+    {
+        state.SkipWithError("Create() failed");
+        return;
+    }
+    void* mapping = mmap(nullptr, HEADER_SIZE + CAPACITY, PROT_READ | PROT_WRITE, MAP_SHARED, producer.GetHandle(), 0);
+    if (mapping == MAP_FAILED)
+    {
+        state.SkipWithError("mmap() failed");
+        return;
+    }
+    uint64_t* capacity = reinterpret_cast<uint64_t*>(static_cast<uint8_t*>(mapping) + 8);
+    std::atomic<uint64_t>* readPosition = reinterpret_cast<std::atomic<uint64_t>*>(static_cast<uint8_t*>(mapping) + 24);
+
+    std::vector<uint8_t> message(CAPACITY / 4, 0x5a);
+    uint64_t position = 0;
+    while (state.KeepRunning() == true)
+    {
+        if (producer.Write(message.data(), message.size(), &position) != net::SharedMemoryRing::Result::OK)
+        {
+            state.SkipWithError("Write() to an empty ring failed");
+            break;
+        }
+
+        //  A read position past everything written would leave room for more than the capacity
+        *capacity = uint64_t(1) << 40;
+        readPosition->store(uint64_t(1) << 40);
+        if (producer.Write(message.data(), message.size(), &position) != net::SharedMemoryRing::Result::CORRUPT)
+        {
+            state.SkipWithError("Write() accepted a read position ahead of the write position");
+            break;
+        }
+        //  A read position far behind the write position would claim more than the capacity is in use
+        readPosition->store(0);
+        for (int i = 0; i < 3; ++i)
+        {
+            producer.Write(message.data(), message.size(), &position);
+        }
+        if (producer.Write(message.data(), message.size(), &position) != net::SharedMemoryRing::Result::NO_SPACE)
+        {
+            state.SkipWithError("Write() did not stop at the capacity it was created with");
+            break;
+        }
+        if (producer.GetCapacity() != CAPACITY)
+        {
+            state.SkipWithError("the capacity was read back from the shared header");
+            break;
+        }
+        if (ftruncate(producer.GetHandle(), HEADER_SIZE) == 0)
+        {
+            state.SkipWithError("the mapping could be shrunk");
+            break;
+        }
+    }
+    munmap(mapping, HEADER_SIZE + CAPACITY);
+}
+
+//  A message which does not fit before the end of an empty ring: skipping the tail must not leave the write
+//  position more than the capacity ahead of the read position, or the next write fails as CORRUPT
+static void CheckSharedMemoryRingEmptyRing(BenchmarkState& state)
+{
+    static constexpr const size_t CAPACITY = 64 * 1024;
+    net::SharedMemoryRing ring;
+    if (ring.Create(CAPACITY) != net::SharedMemoryRing::Result::OK)
+    {
+        state.SkipWithError("Create() failed");
+        return;
+    }
+
+    std::vector<uint8_t> small(CAPACITY * 3 / 10, 0x11);
+    std::vector<uint8_t> large(CAPACITY * 8 / 10, 0x22);
+    while (state.KeepRunning() == true)
+    {
+        uint64_t position = 0;
+        if (ring.Write(small.data(), small.size(), &position) != net::SharedMemoryRing::Result::OK || ring.Read(position, small.size()) == nullptr)
+        {
+            state.SkipWithError("Write() to an empty ring failed");
+            break;
+        }
+        ring.Release(position, small.size());
+
+        uint64_t largePosition = 0;
+        if (ring.Write(large.data(), large.size(), &largePosition) != net::SharedMemoryRing::Result::OK)
+        {
+            state.SkipWithError("a message past the end of an empty ring was not written");
+            break;
+        }
+        net::SharedMemoryRing::Result result = ring.Write(small.data(), CAPACITY / 10, &position);
+        if (result != net::SharedMemoryRing::Result::OK)
+        {
+            state.SkipWithError(std::string("Write() after a message past the end of an empty ring failed") + (result == net::SharedMemoryRing::Result::CORRUPT ? " as CORRUPT" : ""));
+            break;
+        }
+        const uint8_t* data = ring.Read(largePosition, large.size());
+        if (data == nullptr || memcmp(data, large.data(), large.size()) != 0)
+        {
+            state.SkipWithError("the message past the end of an empty ring could not be read back");
+            break;
+        }
+        ring.Release(position, CAPACITY / 10);
+    }
+}
+#endif
+
+void RegisterSharedMemoryChecks(BenchmarkRunner& runner)
+{
+#if defined(__linux)
+    runner.RegisterCheck("Check/SharedMemoryRing/UntrustedHeader", CheckSharedMemoryRingUntrustedHeader);
+    runner.RegisterCheck("Check/SharedMemoryRing/EmptyRing", CheckSharedMemoryRingEmptyRing);
+#else
+    (void)runner;
+#endif
+}
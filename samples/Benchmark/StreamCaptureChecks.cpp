@@ -0,0 +1,212 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "Benchmark.h"
+#include "FlowCtrlCallbacks.h"
+
+#include "sdk/transports/transport-amd/StreamCapture.h"
+#include "sdk/transports/transport-amd/StreamReplay.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ssdk;
+using namespace ssdk::transport_amd;
+
+//-------------------------------------------------------------------------------------------------
+// StreamCapture - capture files read back and replay as recorded
+//-------------------------------------------------------------------------------------------------
+namespace
+{
+    class ReplayedMessages :
+        public ReceiverCallback
+    {
+    public:
+        virtual void AMF_STD_CALL OnMessageReceived(Session* /*session*/, Channel /*channel*/, int /*msgID*/, const void* message, size_t messageSize) override
+        {
+            const uint8_t* data = static_cast<const uint8_t*>(message);
+            m_Messages.push_back(std::vector<uint8_t>(data, data + messageSize));
+        }
+        virtual void AMF_STD_CALL OnTerminate(Session* /*session*/, TerminationReason /*reason*/) override {}
+
+        std::vector<std::vector<uint8_t>> m_Messages;
+    };
+}
+
+//  Video messages go out through one flow control and come in through another, both recording to the same capture along with
+//  the reassembled messages, enough records to get an index. A plain capture must read back record for record, seek by timestamp
+//  and replay the messages, a redacted one must keep the fragment headers and nothing of the payloads
+static void CheckStreamCaptureRoundTrip(BenchmarkState& state)
+{
+    static const std::string SECRET = "ssdk-bench-capture-payload";
+    static const uint32_t MESSAGE_SIZES_CYCLE[] = { 64, 480, 4000, 42000 };
+    static constexpr const int MESSAGES = 40;
+
+    struct ExpectedRecord
+    {
+        StreamCapture::RecordType   m_Type;
+        StreamCapture::Direction    m_Direction;
+        std::vector<uint8_t>        m_Payload;
+    };
+
+    const std::string fileName = (std::filesystem::temp_directory_path() / "ssdk_bench_capture.sscap").string();
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        for (int redact = 0; redact < 2 && failed == false; ++redact)
+        {
+            StreamRecorder::Ptr recorder = std::make_shared<StreamRecorder>();
+            if (recorder->Open(fileName, redact == 1) == false)
+            {
+                state.SkipWithError("StreamRecorder::Open() failed");
+                failed = true;
+                break;
+            }
+            FlowCtrlProtocol sender(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+            FlowCtrlProtocol receiver(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT);
+            sender.SetRecorder(recorder);
+            receiver.SetRecorder(recorder);
+            MessageCounter counter;
+            net::Socket::IPv4Address from("127.0.0.1", 1235);
+            std::vector<ExpectedRecord> expected;
+            std::vector<std::vector<uint8_t>> messages;
+            for (int i = 0; i < MESSAGES; ++i)
+            {
+                std::vector<uint8_t> message(MESSAGE_SIZES_CYCLE[i % amf_countof(MESSAGE_SIZES_CYCLE)]);
+                for (size_t ofs = 0; ofs < message.size(); ++ofs)
+                {
+                    message[ofs] = uint8_t(SECRET[ofs % SECRET.length()]);
+                }
+                FragmentCollector collector;
+                uint32_t bytesSent = 0;
+                sender.FragmentMessage(message.data(), uint32_t(message.size()), DATAGRAM_SIZE, VIDEO_CHANNEL_ID, collector, bytesSent);
+                for (const std::vector<uint8_t>& datagram : collector.m_Datagrams)
+                {
+                    expected.push_back({ StreamCapture::RecordType::FRAGMENT, StreamCapture::Direction::OUTGOING, datagram });
+                }
+                for (const std::vector<uint8_t>& datagram : collector.m_Datagrams)
+                {
+                    expected.push_back({ StreamCapture::RecordType::FRAGMENT, StreamCapture::Direction::INCOMING, datagram });
+                    receiver.ProcessFragment(datagram.data(), uint32_t(datagram.size()), from, counter);
+                }
+                recorder->RecordMessage(StreamCapture::Direction::INCOMING, Channel::VIDEO_OUT, i, message.data(), message.size());
+                expected.push_back({ StreamCapture::RecordType::MESSAGE, StreamCapture::Direction::INCOMING, message });
+                messages.push_back(std::move(message));
+            }
+            recorder->Close();
+
+            CaptureReader reader;
+            if (reader.Open(fileName) == false || (reader.GetFlags() & StreamCapture::FLAG_REDACTED) != (redact == 1 ? StreamCapture::FLAG_REDACTED : 0))
+            {
+                state.SkipWithError("CaptureReader::Open() failed or the redaction flag was lost");
+                failed = true;
+                break;
+            }
+            CaptureReader::Record record;
+            std::vector<amf_pts> timestamps;
+            for (const ExpectedRecord& want : expected)
+            {
+                std::vector<uint8_t> payload = want.m_Payload;
+                if (redact == 1)
+                {   //  Only a fragment header survives
+                    size_t kept = want.m_Type == StreamCapture::RecordType::FRAGMENT ? FlowCtrlProtocol::Fragment::GetSizeOfFragmentHeader() : 0;
+                    std::fill(payload.begin() + std::min(kept, payload.size()), payload.end(), uint8_t(0));
+                }
+                if (reader.ReadNext(record) == false || record.m_Type != want.m_Type || record.m_Direction != want.m_Direction ||
+                    record.m_Payload != payload || record.m_Redacted != (redact == 1) ||
+                    (timestamps.empty() == false && record.m_Timestamp < timestamps.back()))
+                {
+                    state.SkipWithError("record " + std::to_string(timestamps.size()) + (redact == 1 ? " of the redacted capture" : "") + " did not read back as recorded");
+                    failed = true;
+                    break;
+                }
+                timestamps.push_back(record.m_Timestamp);
+            }
+            if (failed == true)
+            {
+                break;
+            }
+            if (reader.ReadNext(record) == true)
+            {
+                state.SkipWithError("the capture has more records than were recorded");
+                failed = true;
+                break;
+            }
+            const size_t middle = expected.size() * 2 / 3;
+            const size_t first = size_t(std::lower_bound(timestamps.begin(), timestamps.end(), timestamps[middle]) - timestamps.begin());
+            if (expected.size() <= StreamCapture::INDEX_INTERVAL || reader.Seek(timestamps[middle]) == false ||
+                reader.ReadNext(record) == false || record.m_Timestamp != timestamps[first] || record.m_Direction != expected[first].m_Direction)
+            {
+                state.SkipWithError("Seek() did not position at the first record of a timestamp past the index");
+                failed = true;
+                break;
+            }
+            reader.Close();
+
+            if (redact == 1)
+            {
+                std::ifstream file(fileName, std::ios::binary);
+                std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+                if (contents.find(SECRET.substr(0, 8)) != std::string::npos)
+                {
+                    state.SkipWithError("payload bytes were written to a redacted capture");
+                    failed = true;
+                }
+            }
+            else
+            {
+                ReplayedMessages replayed;
+                StreamReplay replay(&replayed);
+                if (replay.Open(fileName) == false || replay.Run(StreamReplay::Layer::FRAGMENT, 0) == false || replayed.m_Messages != messages)
+                {
+                    state.SkipWithError("the fragments did not replay into the messages recorded");
+                    failed = true;
+                }
+            }
+        }
+    }
+    std::remove(fileName.c_str());
+}
+
+void RegisterStreamCaptureChecks(BenchmarkRunner& runner)
+{
+    runner.RegisterCheck("Check/StreamCapture/RoundTrip", CheckStreamCaptureRoundTrip);
+}
@@ -0,0 +1,829 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "Benchmark.h"
+
+#include "samples/LoadGenerator/SyntheticServer.h"
+#include "samples/LoadGenerator/SimulatedClient.h"
+#include "sdk/transports/transport-amd/CursorCache.h"
+#include "sdk/transports/transport-amd/ServerDiscovery.h"
+#include "sdk/transports/transport-amd/SessionResumption.h"
+#include "sdk/net/Selector.h"
+
+#include "amf/public/common/Thread.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace ssdk;
+using namespace ssdk::transport_amd;
+
+//  Functional checks which need a server and a client talking to each other. Both run in this process on loopback,
+//  on a fixed port of their own
+static constexpr const unsigned short LOOPBACK_SERVER_PORT = 19470;
+static constexpr const char* LOOPBACK_PASSPHRASE = "ssdk_bench";
+static constexpr const char* LOOPBACK_CLIENT_ID = "ssdk_bench";
+
+static SyntheticServer::Config GetLoopbackServerConfig()
+{
+    SyntheticServer::Config config;
+    config.m_Port = LOOPBACK_SERVER_PORT;
+    config.m_DatagramSize = 65507;
+    config.m_BindInterface = "127.0.0.1";
+    config.m_HostName = "ssdk_bench";
+    config.m_Passphrase = LOOPBACK_PASSPHRASE;
+    config.m_MaxConnections = 4;
+    config.m_Resolution = { 640, 360 };
+    config.m_Framerate = 60;
+    config.m_VideoBitrate = 2000000;
+    config.m_AudioSamplingRate = 48000;
+    config.m_AudioChannels = 2;
+    config.m_AudioBitrate = 64000;
+    return config;
+}
+
+static SimulatedClient::Config GetLoopbackClientConfig()
+{
+    SimulatedClient::Config config;
+    config.m_ID = LOOPBACK_CLIENT_ID;
+    config.m_ServerUrl = "udp://127.0.0.1:" + std::to_string(LOOPBACK_SERVER_PORT);
+    config.m_DatagramSize = 65507;
+    config.m_Passphrase = LOOPBACK_PASSPHRASE;
+    return config;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Session resumption
+//-------------------------------------------------------------------------------------------------
+//  The ticket ID and the challenge go out in the clear, anyone who saw them must not be able to redeem the ticket
+static void CheckSessionResumptionProof(BenchmarkState& state)
+{
+    static constexpr const transport_common::SessionHandle SESSION = 1;
+
+    while (state.KeepRunning() == true)
+    {
+        ResumptionCache cache;
+        ResumptionState::Ptr pState(new ResumptionState(LOOPBACK_CLIENT_ID, nullptr));
+        transport_common::SessionHandle previousSession = transport_common::INVALID_SESSION_HANDLE;
+        std::string challenge = MakeResumeChallenge();
+        std::string secret;
+        std::string ticket = cache.Issue(SESSION, pState, &secret);
+
+        if (cache.IsRedeemable(ticket, LOOPBACK_CLIENT_ID) == false || cache.IsRedeemable(ticket, "another device") == true)
+        {
+            state.SkipWithError("a ticket was not bound to the device it was issued to");
+            break;
+        }
+        if (cache.Redeem(ticket, LOOPBACK_CLIENT_ID, challenge, ComputeResumeProof(ticket, challenge, LOOPBACK_CLIENT_ID), &previousSession) != nullptr ||
+            previousSession != transport_common::INVALID_SESSION_HANDLE)
+        {
+            state.SkipWithError("a proof computed without the secret was accepted");
+            break;
+        }
+        if (cache.IsRedeemable(ticket, LOOPBACK_CLIENT_ID) == true)
+        {
+            state.SkipWithError("a failed attempt did not burn the ticket");
+            break;
+        }
+
+        ticket = cache.Issue(SESSION, pState, &secret);
+        if (cache.Redeem(ticket, LOOPBACK_CLIENT_ID, MakeResumeChallenge(), ComputeResumeProof(secret, challenge, LOOPBACK_CLIENT_ID), &previousSession) != nullptr)
+        {
+            state.SkipWithError("a proof for another challenge was accepted");
+            break;
+        }
+
+        ticket = cache.Issue(SESSION, pState, &secret);
+        std::string proof = ComputeResumeProof(secret, challenge, LOOPBACK_CLIENT_ID);
+        if (cache.Redeem(ticket, LOOPBACK_CLIENT_ID, challenge, proof, &previousSession) != pState || previousSession != SESSION)
+        {
+            state.SkipWithError("the proof of the ticket's holder was rejected");
+            break;
+        }
+        if (cache.Redeem(ticket, LOOPBACK_CLIENT_ID, challenge, proof, &previousSession) != nullptr)
+        {
+            state.SkipWithError("a ticket was redeemed twice");
+            break;
+        }
+    }
+}
+
+//  A client which reconnects every CHURN_PERIOD: the first connect is cold, the following ones present the ticket from the previous one
+static void CheckSessionResumptionLoopback(BenchmarkState& state, amf::AMFContext* context)
+{
+    static constexpr const amf_pts CHURN_PERIOD = AMF_SECOND;
+    static constexpr const amf_uint32 RUN_TIME_MS = 4500;
+
+    if (context == nullptr)
+    {
+        state.SkipWithError("AMF is not available");
+        return;
+    }
+    SyntheticServer server(context);
+    if (server.Start(GetLoopbackServerConfig()) == false)
+    {
+        state.SkipWithError("failed to start the server");
+        return;
+    }
+    SimulatedClient::Config clientConfig = GetLoopbackClientConfig();
+    clientConfig.m_SubscribeAudio = false;
+    clientConfig.m_ChurnPeriod = CHURN_PERIOD;
+    SimulatedClient client(context, clientConfig);
+    if (client.Start() == false)
+    {
+        state.SkipWithError("failed to start the client");
+        server.Stop();
+        return;
+    }
+    while (state.KeepRunning() == true)
+    {
+        amf_sleep(RUN_TIME_MS);
+    }
+    client.Stop();
+    server.Stop();
+
+    SimulatedClient::Stats stats;
+    client.GetStats(stats);
+    if (stats.m_ColdFirstFrameSamples == 0)
+    {
+        state.SkipWithError("no video after a cold connect");
+    }
+    else if (stats.m_ResumedConnections == 0)
+    {
+        state.SkipWithError("the server did not resume any session");
+    }
+    else if (stats.m_ResumedFirstFrameSamples == 0)
+    {
+        state.SkipWithError("no video after a resumed connect");
+    }
+    else
+    {
+        char label[128];
+        snprintf(label, sizeof(label), "first frame: cold %.1f ms, resumed %.1f ms avg, %lld of %lld connects resumed",
+            double(stats.m_ColdFirstFrameSum) / double(stats.m_ColdFirstFrameSamples) / AMF_MILLISECOND,
+            double(stats.m_ResumedFirstFrameSum) / double(stats.m_ResumedFirstFrameSamples) / AMF_MILLISECOND,
+            static_cast<long long>(stats.m_ResumedConnections), static_cast<long long>(stats.m_Connections));
+        state.SetLabel(label);
+    }
+}
+
+#if defined(__linux)
+//-------------------------------------------------------------------------------------------------
+// Connection migration
+//-------------------------------------------------------------------------------------------------
+//  The client moves its socket to a new local port every REBIND_PERIOD while video is streaming. The server has to recognize
+//  the connection ID, validate the new path and carry on with the same flow control and cipher, so the client never
+//  reconnects and video keeps arriving between rebinds.
+static void CheckConnectionMigrationLoopback(BenchmarkState& state, amf::AMFContext* context)
+{
+    static constexpr const amf_pts REBIND_PERIOD = AMF_SECOND;
+    static constexpr const amf_pts RUN_TIME = 4 * AMF_SECOND + AMF_SECOND / 2;
+    static constexpr const amf_uint32 SAMPLE_INTERVAL_MS = 20;
+    static constexpr const int64_t MIN_FRAMES_PER_PERIOD = 20;      //  Out of 60 sent per second
+
+    if (context == nullptr)
+    {
+        state.SkipWithError("AMF is not available");
+        return;
+    }
+    SyntheticServer server(context);
+    if (server.Start(GetLoopbackServerConfig()) == false)
+    {
+        state.SkipWithError("failed to start the server");
+        return;
+    }
+    SimulatedClient::Config clientConfig = GetLoopbackClientConfig();
+    clientConfig.m_SubscribeAudio = false;
+    clientConfig.m_RebindPeriod = REBIND_PERIOD;
+    SimulatedClient client(context, clientConfig);
+    if (client.Start() == false)
+    {
+        state.SkipWithError("failed to start the client");
+        server.Stop();
+        return;
+    }
+
+    SimulatedClient::Stats stats;
+    std::vector<int64_t> framesAtRebind;    //  Video frames received by the time of each rebind and at the end
+    while (state.KeepRunning() == true)
+    {
+        const amf_pts start = amf_high_precision_clock();
+        while (amf_high_precision_clock() - start < RUN_TIME)
+        {
+            amf_sleep(SAMPLE_INTERVAL_MS);
+            client.GetStats(stats);
+            while (int64_t(framesAtRebind.size()) < stats.m_Rebinds)
+            {
+                framesAtRebind.push_back(stats.m_VideoFrames);
+            }
+        }
+    }
+    client.GetStats(stats);
+    framesAtRebind.push_back(stats.m_VideoFrames);
+    client.Stop();
+    server.Stop();
+
+    std::string error;
+    if (stats.m_Rebinds < 2)
+    {
+        error = "the client rebound its socket " + std::to_string(stats.m_Rebinds) + " times";
+    }
+    else if (stats.m_Connections != 1 || stats.m_Connected == false)
+    {
+        error = "the connection did not survive the rebinds, " + std::to_string(stats.m_Connections) + " connections were made";
+    }
+    for (size_t i = 1; i < framesAtRebind.size() && error.empty() == true; ++i)
+    {
+        const int64_t frames = framesAtRebind[i] - framesAtRebind[i - 1];
+        if (frames < MIN_FRAMES_PER_PERIOD)
+        {
+            error = "only " + std::to_string(frames) + " video frames arrived after rebind " + std::to_string(i);
+        }
+    }
+    if (error.empty() == false)
+    {
+        state.SkipWithError(error);
+        return;
+    }
+    char label[128];
+    snprintf(label, sizeof(label), "%lld rebinds, %lld video frames received, %lld lost", static_cast<long long>(stats.m_Rebinds),
+        static_cast<long long>(stats.m_VideoFrames), static_cast<long long>(stats.m_VideoFramesLost));
+    state.SetLabel(label);
+}
+#endif
+
+//-------------------------------------------------------------------------------------------------
+// Cursor cache
+//-------------------------------------------------------------------------------------------------
+//  A desktop session switches among a few pointer shapes over and over and plays the frames of the busy cursor in a loop.
+//  ServerTransportImpl::SetCursor() sends every change to a client on loopback, which has to display the right bitmap after
+//  each of them. A bitmap the client receives is put into a new surface, a cached one comes back as the same surface, so
+//  the number of distinct surfaces displayed is the number of bitmaps the server sent.
+class CursorShape
+{
+public:
+    int32_t                 m_Width = 0;
+    int32_t                 m_Height = 0;
+    std::vector<uint8_t>    m_Bitmap;
+};
+
+class CursorScenario
+{
+public:
+    const char* m_Name = "";
+    size_t      m_BusyFrames = 0;       //  Frames of the busy animation on top of the nine static shapes
+    bool        m_Cycle = false;        //  Cycle through all shapes in order rather than switch at random
+    size_t      m_Changes = 0;
+};
+
+static std::vector<CursorShape> MakeCursorShapes(size_t busyFrames)
+{
+    static const int32_t SIZES[] = { 32, 32, 32, 32, 32, 32, 32, 32, 64 };    //  Arrow, I-beam, hand, 4 resize, move, drag and drop
+    std::mt19937 generator(1968);
+    std::vector<CursorShape> shapes;
+    for (size_t i = 0; i < amf_countof(SIZES) + busyFrames; ++i)
+    {
+        CursorShape shape;
+        shape.m_Width = shape.m_Height = i < amf_countof(SIZES) ? SIZES[i] : 48;
+        shape.m_Bitmap.resize(size_t(shape.m_Width) * shape.m_Height * 4);
+        for (uint8_t& byte : shape.m_Bitmap)
+        {
+            byte = uint8_t(generator());
+        }
+        shapes.push_back(std::move(shape));
+    }
+    return shapes;
+}
+
+//  Indices into the shapes: mostly arrow, I-beam and hand, now and then a resize or drag, and runs of the busy animation
+static std::vector<size_t> MakeCursorSequence(const CursorScenario& scenario, size_t shapes)
+{
+    std::mt19937 generator(2026);
+    std::uniform_real_distribution<double> chance(0, 1);
+    std::vector<size_t> sequence;
+    while (sequence.size() < scenario.m_Changes)
+    {
+        if (scenario.m_Cycle == true)
+        {
+            sequence.push_back(sequence.size() % shapes);
+            continue;
+        }
+        const double kind = chance(generator);
+        if (kind < 0.6)
+        {
+            sequence.push_back(generator() % 3);
+        }
+        else if (kind < 0.8)
+        {
+            sequence.push_back(3 + generator() % 5);
+        }
+        else if (kind < 0.95)
+        {
+            for (size_t frame = 0; frame < 3 * scenario.m_BusyFrames; ++frame)
+            {
+                sequence.push_back(9 + frame % scenario.m_BusyFrames);
+            }
+        }
+        else
+        {
+            sequence.push_back(8);
+        }
+    }
+    sequence.resize(scenario.m_Changes);
+    return sequence;
+}
+
+class CursorRecorder : public transport_common::ClientTransport::CursorCallback
+{
+public:
+    virtual void OnCursorChanged(const transport_common::Cursor& cursor) override
+    {
+        amf::AMFSurfacePtr surface;
+        std::vector<uint8_t> bitmap;
+        if (const_cast<transport_common::Cursor&>(cursor).GetBitmap(&surface) == AMF_OK && surface != nullptr)
+        {
+            amf::AMFPlane* plane = surface->GetPlaneAt(0);
+            const size_t rowSize = size_t(plane->GetWidth()) * plane->GetPixelSizeInBytes();
+            bitmap.resize(rowSize * plane->GetHeight());
+            for (int32_t row = 0; row < plane->GetHeight(); ++row)
+            {
+                memcpy(bitmap.data() + row * rowSize, static_cast<const uint8_t*>(plane->GetNative()) + size_t(row) * plane->GetHPitch(), rowSize);
+            }
+        }
+        amf::AMFLock lock(&m_Guard);
+        if (surface != nullptr && m_Surfaces.insert(surface.GetPtr()).second == true)
+        {
+            m_Held.push_back(surface);      //  Keeps the surface alive, so that its address is not reused by another bitmap
+        }
+        m_Displayed = std::move(bitmap);
+        ++m_Changes;
+    }
+    virtual void OnCursorHidden() override {}
+
+    int64_t GetChanges() const
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_Changes;
+    }
+    std::vector<uint8_t> GetDisplayed() const
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_Displayed;
+    }
+    size_t GetBitmapsReceived() const
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_Surfaces.size();
+    }
+
+private:
+    mutable amf::AMFCriticalSection     m_Guard;
+    int64_t                             m_Changes = 0;
+    std::vector<uint8_t>                m_Displayed;
+    std::set<amf::AMFSurface*>          m_Surfaces;
+    std::vector<amf::AMFSurfacePtr>     m_Held;
+};
+
+//  Waits until the client has displayed more than changes cursors, returns false on timeout
+static bool WaitForCursor(const CursorRecorder& recorder, int64_t changes)
+{
+    static constexpr const amf_pts CURSOR_TIMEOUT = AMF_SECOND;
+
+    const amf_pts start = amf_high_precision_clock();
+    while (recorder.GetChanges() <= changes)
+    {
+        if (amf_high_precision_clock() - start > CURSOR_TIMEOUT)
+        {
+            return false;
+        }
+        amf_sleep(1);
+    }
+    return true;
+}
+
+static void CheckCursorCacheLoopback(BenchmarkState& state, amf::AMFContext* context)
+{
+    static const CursorScenario SCENARIOS[] = {
+        { "all shapes cached", 8, false, 400 },
+        { "more shapes than the cache holds", size_t(DEFAULT_CURSOR_CACHE_SIZE), true, 2 * (9 + size_t(DEFAULT_CURSOR_CACHE_SIZE)) },
+    };
+    static constexpr const amf_uint32 CONNECT_TIMEOUT_MS = 5000;
+
+    if (context == nullptr)
+    {
+        state.SkipWithError("AMF is not available");
+        return;
+    }
+
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        std::string report;
+        for (size_t s = 0; s < amf_countof(SCENARIOS) && failed == false; ++s)
+        {
+            const CursorScenario& scenario = SCENARIOS[s];
+            const std::vector<CursorShape> shapes = MakeCursorShapes(scenario.m_BusyFrames);
+            const std::vector<size_t> sequence = MakeCursorSequence(scenario, shapes.size());
+            std::vector<amf::AMFSurfacePtr> surfaces;
+            for (const CursorShape& shape : shapes)
+            {
+                amf::AMFSurfacePtr surface;
+                if (context->AllocSurface(amf::AMF_MEMORY_HOST, amf::AMF_SURFACE_BGRA, shape.m_Width, shape.m_Height, &surface) != AMF_OK)
+                {
+                    break;
+                }
+                amf::AMFPlane* plane = surface->GetPlaneAt(0);
+                const size_t rowSize = size_t(shape.m_Width) * 4;
+                for (int32_t row = 0; row < shape.m_Height; ++row)
+                {
+                    memcpy(static_cast<uint8_t*>(plane->GetNative()) + size_t(row) * plane->GetHPitch(), shape.m_Bitmap.data() + row * rowSize, rowSize);
+                }
+                surfaces.push_back(surface);
+            }
+            if (surfaces.size() != shapes.size())
+            {
+                state.SkipWithError("AllocSurface() failed");
+                failed = true;
+                break;
+            }
+
+            //  A new server and client for every scenario, so that both caches start empty
+            SyntheticServer server(context);
+            if (server.Start(GetLoopbackServerConfig()) == false)
+            {
+                state.SkipWithError("failed to start the server");
+                failed = true;
+                break;
+            }
+            CursorRecorder recorder;
+            SimulatedClient::Config clientConfig = GetLoopbackClientConfig();
+            clientConfig.m_SubscribeAudio = false;
+            clientConfig.m_CursorCallback = &recorder;
+            SimulatedClient client(context, clientConfig);
+            SyntheticServer::Stats serverStats;
+            SimulatedClient::Stats clientStats;
+            bool connected = client.Start();
+            for (amf_uint32 waited = 0; connected == true && (serverStats.m_Connections == 0 || clientStats.m_Connected == false); waited += 10)
+            {
+                if (waited >= CONNECT_TIMEOUT_MS)
+                {
+                    connected = false;
+                    break;
+                }
+                amf_sleep(10);
+                server.GetStats(serverStats);
+                client.GetStats(clientStats);
+            }
+
+            std::string error;
+            const AMFSize resolution = { 1920, 1080 };
+            if (connected == false)
+            {
+                error = "the client did not connect";
+            }
+            for (size_t i = 0; i < sequence.size() && error.empty() == true; ++i)
+            {
+                static constexpr const int FIRST_CURSOR_ATTEMPTS = 5;   //  The server may not have added the subscriber yet
+
+                const size_t index = sequence[i];
+                const int64_t changes = recorder.GetChanges();
+                transport_common::Cursor cursor(surfaces[index], AMFPoint{ 0, 0 }, resolution, transport_common::Cursor::Type::COLOR);
+                bool displayed = false;
+                for (int attempt = 0; attempt < (i == 0 ? FIRST_CURSOR_ATTEMPTS : 1) && displayed == false; ++attempt)
+                {
+                    displayed = server.GetTransport()->SetCursor(cursor) == transport_common::Result::OK && WaitForCursor(recorder, changes) == true;
+                }
+                if (displayed == false)
+                {
+                    error = "change " + std::to_string(i) + " was not displayed";
+                }
+                else if (recorder.GetDisplayed() != shapes[index].m_Bitmap)
+                {
+                    error = "the client displayed the wrong cursor after change " + std::to_string(i);
+                }
+            }
+            const size_t received = recorder.GetBitmapsReceived();
+            client.Stop();
+            server.Stop();
+
+            if (error.empty() == true)
+            {
+                const size_t distinct = std::set<size_t>(sequence.begin(), sequence.end()).size();
+                //  The client holds every shape of the first scenario, each bitmap has to be sent once. In the second one
+                //  every shape has been evicted by the time it comes round again
+                const size_t expected = scenario.m_Cycle == true ? sequence.size() : distinct;
+                if (received != expected)
+                {
+                    error = std::to_string(received) + " bitmaps were sent for " + std::to_string(sequence.size()) + " changes among " +
+                            std::to_string(distinct) + " shapes, expected " + std::to_string(expected);
+                }
+            }
+            if (error.empty() == false)
+            {
+                state.SkipWithError(std::string(scenario.m_Name) + ": " + error);
+                failed = true;
+                break;
+            }
+            char line[160];
+            snprintf(line, sizeof(line), "%s%s: %zu bitmaps sent for %zu changes", report.empty() == true ? "" : "; ", scenario.m_Name, received, sequence.size());
+            report += line;
+        }
+        if (failed == false)
+        {
+            state.SetLabel(report);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// Server discovery
+//-------------------------------------------------------------------------------------------------
+//  Stands between the discovery client and the server on loopback and drops the first requests it receives, the way a lossy
+//  Wi-Fi link drops broadcasts. The requests which follow and everything the server sends back are passed through.
+class DroppingDiscoveryRelay : public amf::AMFThread
+{
+public:
+    DroppingDiscoveryRelay(const net::Socket::IPv4Address& server, int64_t requestsToDrop) :
+        m_Socket(new net::DatagramSocket()),
+        m_Server(server),
+        m_RequestsToDrop(requestsToDrop)
+    {
+    }
+
+    bool Bind()
+    {
+        if (m_Socket->Bind(net::Socket::IPv4Address("127.0.0.1", 0)) != net::Socket::Result::OK)
+        {
+            return false;
+        }
+        sockaddr_in local = {};
+        socklen_t localSize = sizeof(local);
+        getsockname(m_Socket->GetNativeHandle(), reinterpret_cast<sockaddr*>(&local), &localSize);
+        m_Address = net::Socket::IPv4Address("127.0.0.1", net::Socket::IPv4Address(local).GetPort());
+        return true;
+    }
+
+    inline const net::Socket::IPv4Address& GetAddress() const { return m_Address; }
+    inline int64_t GetRequestCount() const { return m_Requests; }
+    inline int64_t GetForwardedCount() const { return m_Forwarded; }
+
+    virtual void Run() override
+    {
+        static constexpr const int POLL_INTERVAL_MS = 10;
+
+        std::vector<uint8_t> buffer(65536);
+        net::Selector selector;
+        selector.AddReadableSocket(m_Socket);
+        net::Socket::IPv4Address client;
+        while (StopRequested() == false)
+        {
+            struct timeval timeout = { 0, POLL_INTERVAL_MS * 1000 };
+            net::Socket::Set readable;
+            net::Socket::IPv4Address from;
+            size_t bytes = 0;
+            size_t sent = 0;
+            if (selector.WaitToRead(timeout, readable) != net::Selector::Result::OK || readable.size() == 0 ||
+                m_Socket->ReceiveFrom(buffer.data(), buffer.size(), &from, &bytes) != net::Socket::Result::OK)
+            {
+                continue;
+            }
+            if (from == m_Server)
+            {
+                m_Socket->SendTo(buffer.data(), bytes, client, &sent);
+            }
+            else
+            {
+                client = from;
+                if (++m_Requests > m_RequestsToDrop)
+                {
+                    ++m_Forwarded;
+                    m_Socket->SendTo(buffer.data(), bytes, m_Server, &sent);
+                }
+            }
+        }
+    }
+
+private:
+    net::DatagramSocket::Ptr    m_Socket;
+    net::Socket::IPv4Address    m_Address;
+    net::Socket::IPv4Address    m_Server;
+    int64_t                     m_RequestsToDrop = 0;
+    std::atomic<int64_t>        m_Requests{ 0 };
+    std::atomic<int64_t>        m_Forwarded{ 0 };
+};
+
+class DiscoveryCounter : public ServerEnumCallback
+{
+public:
+    DiscoveryCounter(amf_pts startTime) : m_StartTime(startTime) {}
+
+    virtual DiscoveryCtrl AMF_STD_CALL OnServerDiscovered(ServerParameters* /*server*/) override
+    {
+        if (m_Discovered++ == 0)
+        {
+            m_FirstAnswerTime = amf_high_precision_clock() - m_StartTime;
+        }
+        return DiscoveryCtrl::CONTINUE;
+    }
+
+    virtual DiscoveryCtrl AMF_STD_CALL OnConnectionRefused() override
+    {
+        ++m_Refused;
+        return DiscoveryCtrl::ABORT;
+    }
+
+    amf_pts     m_StartTime = 0;
+    amf_pts     m_FirstAnswerTime = 0;
+    int64_t     m_Discovered = 0;
+    int64_t     m_Refused = 0;
+};
+
+class DiscoveryScenario
+{
+public:
+    const char* m_Name = "";
+    bool        m_Enumerate = false;        //  EnumerateServers() with the relay in the cache, otherwise QueryServerInfo() of the relay
+    int64_t     m_RequestsToDrop = 0;
+    time_t      m_Timeout = 0;              //  In seconds
+    amf_pts     m_EarliestAnswer = 0;       //  The first request that gets through is sent within this window, 0 - none does
+    amf_pts     m_LatestAnswer = 0;
+};
+
+//  Requests are repeated at 0, 50, 250, 1050, 4250 ms, the server has to be found by the first one the relay lets through and
+//  reported once, although it answers all the requests which follow. Enumeration ends a quiet period after the last answer
+//  rather than at the timeout.
+static void CheckServerDiscoveryDroppedRequests(BenchmarkState& state, amf::AMFContext* context)
+{
+    static const DiscoveryScenario SCENARIOS[] = {
+        { "query, 1 dropped", false, 1, 10, 50 * AMF_MILLISECOND, 250 * AMF_MILLISECOND },
+        { "query, 3 dropped", false, 3, 10, 1050 * AMF_MILLISECOND, 4250 * AMF_MILLISECOND },
+        { "enumeration of a cached server, 2 dropped", true, 2, 10, 250 * AMF_MILLISECOND, 1050 * AMF_MILLISECOND },
+        { "enumeration, all dropped", true, std::numeric_limits<int64_t>::max(), 1, 0, 0 },
+    };
+
+    if (context == nullptr)
+    {
+        state.SkipWithError("AMF is not available");
+        return;
+    }
+    SyntheticServer server(context);
+    if (server.Start(GetLoopbackServerConfig()) == false)
+    {
+        state.SkipWithError("failed to start the server");
+        return;
+    }
+    const net::Socket::IPv4Address serverAddress("127.0.0.1", LOOPBACK_SERVER_PORT);
+
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        std::string report;
+        for (size_t i = 0; i < amf_countof(SCENARIOS) && failed == false; ++i)
+        {
+            const DiscoveryScenario& scenario = SCENARIOS[i];
+            DroppingDiscoveryRelay relay(serverAddress, scenario.m_RequestsToDrop);
+            if (relay.Bind() == false)
+            {
+                state.SkipWithError("Bind() failed");
+                failed = true;
+                break;
+            }
+            relay.Start();
+
+            DiscoveryCache cache;
+            if (scenario.m_Enumerate == true)
+            {
+                cache.Update(relay.GetAddress());
+            }
+            ServerParametersImpl::Collection servers;
+            DiscoveryClient discoveryClient(LOOPBACK_CLIENT_ID, servers, relay.GetAddress().GetPort());
+            ServerDiscoverySession::Ptr session(discoveryClient.Connect(net::Url(scenario.m_Enumerate == true ? "*" : "127.0.0.1", "udp", relay.GetAddress().GetPort())));
+            DatagramClientSessionFlowCtrl::Result result = DatagramClientSessionFlowCtrl::Result::RECEIVE_FAILED;
+            const amf_pts startTime = amf_high_precision_clock();
+            DiscoveryCounter counter(startTime);
+            if (session != nullptr)
+            {
+                session->SetTimeout(scenario.m_Timeout);
+                size_t count = 0;
+                result = scenario.m_Enumerate == true ? session->EnumerateServers(&counter, &count, nullptr, &cache) : session->QueryServerInfo(&counter, nullptr, &cache);
+            }
+            const amf_pts elapsed = amf_high_precision_clock() - startTime;
+            relay.RequestStop();
+            relay.WaitForStop();
+
+            std::set<std::string> urls;
+            for (const ServerParameters::Ptr& found : servers)
+            {
+                urls.insert(found->GetUrl());
+            }
+            DiscoveryCache::Entries cached = cache.GetRecent();
+            std::string error;
+            if (session == nullptr)
+            {
+                error = "the discovery session could not be created";
+            }
+            else if (scenario.m_LatestAnswer == 0)
+            {
+                if (result != DatagramClientSessionFlowCtrl::Result::TIMEOUT || counter.m_Discovered != 0 || servers.empty() == false)
+                {
+                    error = "a server was reported although all requests were dropped";
+                }
+                else if (elapsed < scenario.m_Timeout * AMF_SECOND)
+                {
+                    error = "gave up before the timeout";
+                }
+            }
+            else if (result != DatagramClientSessionFlowCtrl::Result::OK || counter.m_Discovered == 0)
+            {
+                error = "the server was not found";
+            }
+            else if (counter.m_FirstAnswerTime < scenario.m_EarliestAnswer || counter.m_FirstAnswerTime >= scenario.m_LatestAnswer)
+            {
+                error = "the server was found at " + std::to_string(counter.m_FirstAnswerTime / AMF_MILLISECOND) + " ms, not by the first request which got through";
+            }
+            else if (counter.m_Discovered != int64_t(servers.size()) || urls.size() != servers.size())
+            {
+                error = "the server was reported " + std::to_string(counter.m_Discovered) + " times";
+            }
+            else if (scenario.m_Enumerate == true && relay.GetForwardedCount() < 2)
+            {
+                error = "the server did not answer a repeated request";
+            }
+            else if (elapsed >= scenario.m_Timeout * AMF_SECOND)
+            {
+                error = "did not return before the timeout";
+            }
+            else if (cached.empty() == true || cached.front().m_Port != relay.GetAddress().GetPort())
+            {
+                error = "the server which answered was not cached";
+            }
+            if (error.empty() == false)
+            {
+                state.SkipWithError(std::string(scenario.m_Name) + ": " + error);
+                failed = true;
+                break;
+            }
+            char line[160];
+            snprintf(line, sizeof(line), "%s%s: %lld of %lld requests dropped, returned after %lld ms", report.empty() == true ? "" : "; ", scenario.m_Name,
+                static_cast<long long>(std::min(relay.GetRequestCount(), scenario.m_RequestsToDrop)), static_cast<long long>(relay.GetRequestCount()),
+                static_cast<long long>(elapsed / AMF_MILLISECOND));
+            report += line;
+        }
+        if (failed == false)
+        {
+            state.SetLabel(report);
+        }
+    }
+    server.Stop();
+}
+
+void RegisterTransportChecks(BenchmarkRunner& runner, amf::AMFContext* context)
+{
+    runner.RegisterCheck("Check/SessionResumption/Proof", CheckSessionResumptionProof);
+    runner.RegisterCheck("Check/SessionResumption/Loopback", [context](BenchmarkState& state) { CheckSessionResumptionLoopback(state, context); });
+    runner.RegisterCheck("Check/ServerDiscovery/DroppedRequests", [context](BenchmarkState& state) { CheckServerDiscoveryDroppedRequests(state, context); });
+    runner.RegisterCheck("Check/CursorCache/Loopback", [context](BenchmarkState& state) { CheckCursorCacheLoopback(state, context); });
+#if defined(__linux)
+    runner.RegisterCheck("Check/ConnectionMigration/Loopback", [context](BenchmarkState& state) { CheckConnectionMigrationLoopback(state, context); });
+#endif
+}
@@ -0,0 +1,1260 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "Benchmark.h"
+
+#include "sdk/util/encryption/AESPSKCipher.h"
+#include "sdk/util/pipeline/AVSynchronizer.h"
+#include "sdk/util/QoS/ValueHistory.h"
+#include "sdk/util/QoS/SessionRatePolicy.h"
+#include "sdk/util/trace/PipelineTrace.h"
+#include "sdk/util/metrics/MetricsExporter.h"
+#include "sdk/util/memory/BufferPool.h"
+#include "sdk/util/audio/PCMConverter.h"
+#include "sdk/video/Defines.h"
+#include "sdk/video/FrameChangeDetector.h"
+#include "amf/public/common/AMFFactory.h"
+#include "amf/public/include/components/FFMPEGComponents.h"
+#include "amf/public/include/components/FFMPEGAudioConverter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+    #define FFMPEG_HELPER_DLL_NAME    FFMPEG_DLL_NAME
+#elif defined(__linux)
+    #define FFMPEG_HELPER_DLL_NAME    L"libamf-component-ffmpeg64.so"
+#endif
+
+using namespace ssdk;
+
+//  Sizes of an input event, an audio frame, a datagram, a P-frame and an IDR frame
+static const std::vector<int64_t> CIPHER_SIZES = { 64, 480, 1472, 42000, 262144 };
+
+//-------------------------------------------------------------------------------------------------
+// AESPSKCipher
+//-------------------------------------------------------------------------------------------------
+static void CipherEncrypt(BenchmarkState& state)
+{
+    util::AESPSKCipher cipher("ssdk_bench");
+    std::vector<uint8_t> clearText(size_t(state.GetArg()), 0x5a);
+    std::vector<uint8_t> cipherText(cipher.GetCipherTextBufferSize(clearText.size()));
+    while (state.KeepRunning() == true)
+    {
+        size_t cipherTextSize = 0;
+        if (cipher.Encrypt(clearText.data(), clearText.size(), cipherText.data(), &cipherTextSize) == false)
+        {
+            state.SkipWithError("Encrypt() failed");
+        }
+    }
+    state.SetBytesProcessed(state.GetIterations() * state.GetArg());
+}
+
+static void CipherDecrypt(BenchmarkState& state)
+{
+    util::AESPSKCipher cipher("ssdk_bench");
+    std::vector<uint8_t> clearText(size_t(state.GetArg()), 0x5a);
+    std::vector<uint8_t> cipherText(cipher.GetCipherTextBufferSize(clearText.size()));
+    size_t cipherTextSize = 0;
+    cipher.Encrypt(clearText.data(), clearText.size(), cipherText.data(), &cipherTextSize);
+    std::vector<uint8_t> decrypted(cipher.GetClearTextBufferSize(cipherTextSize));
+    while (state.KeepRunning() == true)
+    {
+        size_t clearTextOfs = 0;
+        size_t clearTextSize = 0;
+        if (cipher.Decrypt(cipherText.data(), cipherTextSize, decrypted.data(), &clearTextOfs, &clearTextSize) == false)
+        {
+            state.SkipWithError("Decrypt() failed");
+        }
+    }
+    state.SetBytesProcessed(state.GetIterations() * state.GetArg());
+}
+
+//-------------------------------------------------------------------------------------------------
+// ValueHistory, ValueAverage - QoS statistics, updated for every frame
+//-------------------------------------------------------------------------------------------------
+template<size_t Size>
+static void ValueHistoryAddValue(BenchmarkState& state)
+{
+    util::ValueHistory<float, Size> history;
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<float> bitrate(15.0f, 25.0f);
+    amf_pts time = 0;
+    while (state.KeepRunning() == true)
+    {
+        history.AddValue(bitrate(generator), ++time);
+        float average = history.GetAverage();
+        BenchmarkState::DoNotOptimize(average);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+static void ValueAverageAdd(BenchmarkState& state)
+{
+    util::ValueAverage<int64_t> average;
+    int64_t value = 0;
+    while (state.KeepRunning() == true)
+    {
+        average.Add(++value);
+        if (average.GetCount() == 60)
+        {   //  Read once per second at 60 fps
+            float result = average.GetAverageAndClear();
+            BenchmarkState::DoNotOptimize(result);
+        }
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+//-------------------------------------------------------------------------------------------------
+// AVSynchronizer - submission of decoded frames without presenters, measures the synchronizer itself
+//-------------------------------------------------------------------------------------------------
+static void AVSynchronizerSubmitVideo(BenchmarkState& state, amf::AMFContext* context, bool traced)
+{
+    amf::AMFSurfacePtr surface;
+    if (context == nullptr || context->AllocSurface(amf::AMF_MEMORY_HOST, amf::AMF_SURFACE_NV12, 1920, 1080, &surface) != AMF_OK)
+    {
+        state.SkipWithError("AllocSurface() failed");
+        return;
+    }
+    surface->SetProperty(video::STREAM_ID_PROPERTY, int64_t(0));
+    util::AVSynchronizer synchronizer(nullptr, nullptr);
+    util::AVSynchronizer::VideoInput::Ptr input;
+    synchronizer.GetVideoInput(input);
+    input->Start();
+    util::PipelineTrace::Enable(traced);
+    amf_pts pts = 0;
+    while (state.KeepRunning() == true)
+    {
+        pts += AMF_SECOND / 60;
+        surface->SetPts(pts);
+        surface->SetProperty(video::ORIGIN_PTS_PROPERTY, pts);
+        surface->SetProperty(video::VIDEO_CLIENT_LATENCY_PTS, pts);
+        util::PipelineTrace::SetDataKey(surface, pts);
+        if (input->SubmitInput(surface) != AMF_OK)
+        {
+            state.SkipWithError("SubmitInput() failed");
+        }
+    }
+    util::PipelineTrace::Enable(false);
+    util::PipelineTrace::Clear();
+    input->Stop();
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+static void AVSynchronizerSubmitAudio(BenchmarkState& state, amf::AMFContext* context)
+{
+    amf::AMFAudioBufferPtr buffer;
+    if (context == nullptr || context->AllocAudioBuffer(amf::AMF_MEMORY_HOST, amf::AMFAF_S16, 480, 48000, 2, &buffer) != AMF_OK)
+    {
+        state.SkipWithError("AllocAudioBuffer() failed");
+        return;
+    }
+    util::AVSynchronizer synchronizer(nullptr, nullptr);
+    util::AVSynchronizer::AudioInput::Ptr input;
+    synchronizer.GetAudioInput(input);
+    input->Start();
+    amf_pts pts = 0;
+    while (state.KeepRunning() == true)
+    {
+        pts += AMF_SECOND / 100;
+        buffer->SetPts(pts);
+        if (input->SubmitInput(buffer) != AMF_OK)
+        {
+            state.SkipWithError("SubmitInput() failed");
+        }
+    }
+    input->Stop();
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+//-------------------------------------------------------------------------------------------------
+// PipelineTrace - cost of the instrumentation with tracing switched off and on at run time. The classes are used directly,
+// so these run even when the SSDK_TRACE_* macros are compiled out and cost nothing
+//-------------------------------------------------------------------------------------------------
+static void PipelineTraceSpan(BenchmarkState& state, bool enabled)
+{
+    util::PipelineTrace::Enable(enabled);
+    amf_pts pts = 0;
+    while (state.KeepRunning() == true)
+    {
+        util::PipelineTrace::Span span(util::PipelineTrace::Event::PRESENT, ++pts);
+    }
+    util::PipelineTrace::Enable(false);
+    util::PipelineTrace::Clear();
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+//  The client receive path: reassembly and decryption spans recorded before the message is parsed and claimed by its frame
+static void PipelineTraceDeferred(BenchmarkState& state, bool enabled)
+{
+    util::PipelineTrace::Enable(enabled);
+    amf_pts pts = 0;
+    while (state.KeepRunning() == true)
+    {
+        amf_pts start = amf_high_precision_clock();
+        util::PipelineTrace::Defer(util::PipelineTrace::Event::REASSEMBLE, start);
+        util::PipelineTrace::Defer(util::PipelineTrace::Event::DECRYPT, start);
+        util::PipelineTrace::KeyScope scope(++pts);
+    }
+    util::PipelineTrace::Enable(false);
+    util::PipelineTrace::Clear();
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+//-------------------------------------------------------------------------------------------------
+// MetricsRegistry - cost of an update on the instrumented paths and of a scrape
+//-------------------------------------------------------------------------------------------------
+static constexpr const unsigned short SCRAPE_PORT = 19464;
+
+static void MetricsCounterAdd(BenchmarkState& state)
+{
+    util::MetricsRegistry::Counter::Ptr counter = util::MetricsRegistry::GetInstance().GetCounter("ssdk_bench_counter", "ssdk_bench");
+    while (state.KeepRunning() == true)
+    {
+        counter->Add(1472);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+static void MetricsHistogramObserve(BenchmarkState& state)
+{
+    util::MetricsRegistry::Histogram::Ptr histogram = util::MetricsRegistry::GetInstance().GetHistogram("ssdk_bench_histogram", "ssdk_bench", util::MetricsRegistry::LATENCY_BUCKETS);
+    double value = 0;
+    while (state.KeepRunning() == true)
+    {
+        value = value < 0.05 ? value + 0.0001 : 0;
+        histogram->Observe(value);
+    }
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+//  Registers arg metrics on top of the ones already alive, each with its own labels like the per-subscriber metrics
+static std::vector<util::MetricsRegistry::Counter::Ptr> RegisterScrapeCounters(int64_t count)
+{
+    std::vector<util::MetricsRegistry::Counter::Ptr> counters;
+    for (int64_t i = 0; i < count; ++i)
+    {
+        counters.push_back(util::MetricsRegistry::GetInstance().GetCounter("ssdk_bench_scrape", "ssdk_bench", { { "index", std::to_string(i) } }));
+        counters.back()->Add(uint64_t(i));
+    }
+    return counters;
+}
+
+static void MetricsExport(BenchmarkState& state)
+{
+    std::vector<util::MetricsRegistry::Counter::Ptr> counters = RegisterScrapeCounters(state.GetArg());
+    size_t bytes = 0;
+    while (state.KeepRunning() == true)
+    {
+        bytes += util::MetricsRegistry::GetInstance().Export().size();
+    }
+    state.SetBytesProcessed(int64_t(bytes));
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+static constexpr const char SCRAPE_REQUEST[] = "GET /metrics HTTP/1.1\r\nHost: 127.0.0.1\r\nAccept: application/openmetrics-text\r\n\r\n";
+
+//  Connects to the exporter on SCRAPE_PORT, sends the request and reads the response to the end
+static bool SendScrapeRequest(const char* request, std::vector<char>& buffer, std::string& response)
+{
+    net::StreamSocket::Ptr socket(new net::StreamSocket);
+    socket->SetTimeout(2);
+    if (socket->Connect(net::Socket::IPv4Address("127.0.0.1", SCRAPE_PORT)) != net::Socket::Result::OK ||
+        socket->SendAll(request, strlen(request)) != net::Socket::Result::OK)
+    {
+        return false;
+    }
+    response.clear();
+    size_t received = 0;
+    while (socket->Receive(buffer.data(), buffer.size(), &received) == net::Socket::Result::OK && received > 0)
+    {
+        response.append(buffer.data(), received);
+    }
+    return true;
+}
+
+//  A full scrape over loopback: connect, GET /metrics, read to the end. Fails unless the response is a complete exposition
+static void MetricsScrape(BenchmarkState& state)
+{
+    std::vector<util::MetricsRegistry::Counter::Ptr> counters = RegisterScrapeCounters(state.GetArg());
+    util::MetricsExporter exporter;
+    if (exporter.Init("tcp://127.0.0.1:" + std::to_string(SCRAPE_PORT)) == false)
+    {
+        state.SkipWithError("Cannot listen on port " + std::to_string(SCRAPE_PORT));
+        return;
+    }
+    const std::string expectedSample = "ssdk_bench_scrape_total{index=\"" + std::to_string(state.GetArg() - 1) + "\"} " + std::to_string(state.GetArg() - 1) + "\n";
+    std::vector<char> buffer(65536);
+    std::string response;
+    size_t bytes = 0;
+    while (state.KeepRunning() == true)
+    {
+        if (SendScrapeRequest(SCRAPE_REQUEST, buffer, response) == false)
+        {
+            state.SkipWithError("Cannot connect to the metrics endpoint");
+            break;
+        }
+        bytes += response.size();
+        if (response.compare(0, 15, "HTTP/1.0 200 OK") != 0 || response.find(util::MetricsExporter::CONTENT_TYPE) == std::string::npos ||
+            response.find(expectedSample) == std::string::npos || response.size() < 6 || response.compare(response.size() - 6, 6, "# EOF\n") != 0)
+        {
+            state.SkipWithError("Malformed response from the metrics endpoint");
+            break;
+        }
+    }
+    exporter.Terminate();
+    state.SetBytesProcessed(int64_t(bytes));
+    state.SetItemsProcessed(state.GetIterations());
+    state.SetLabel("connect + GET /metrics over loopback");
+}
+
+//  Scrapes metrics of every type over loopback and compares the exposition with the values set, then scrapes again after
+//  some of the metrics have been released, the way a subscriber's metrics are when its session ends
+//  Per-session series registered and released over and over without a scrape in between must not accumulate in the registry
+static void CheckMetricsRegistryChurn(BenchmarkState& state)
+{
+    static constexpr const int SESSIONS = 1000;
+
+    util::MetricsRegistry& registry = util::MetricsRegistry::GetInstance();
+    while (state.KeepRunning() == true)
+    {
+        const size_t before = registry.GetSeriesCount();
+        for (int i = 0; i < SESSIONS; ++i)
+        {
+            const util::MetricsRegistry::Labels labels = { { "session", std::to_string(i) } };
+            util::MetricsRegistry::Counter::Ptr counter = registry.GetCounter("ssdk_bench_check_churn_bytes", "Bytes sent", labels);
+            util::MetricsRegistry::Gauge::Ptr gauge = registry.GetGauge("ssdk_bench_check_churn_depth", "Queue depth", labels);
+            counter->Increment();
+            gauge->Set(double(i));
+        }
+        const size_t after = registry.GetSeriesCount();
+        if (after > before + 2)
+        {
+            state.SkipWithError(std::to_string(after - before) + " series of released sessions are still registered");
+            break;
+        }
+    }
+}
+
+static void CheckMetricsExporterScrape(BenchmarkState& state)
+{
+    util::MetricsRegistry& registry = util::MetricsRegistry::GetInstance();
+    util::MetricsRegistry::Counter::Ptr counter = registry.GetCounter("ssdk_bench_check_requests", "Requests \\ served", { { "path", "/a\"b" } });
+    util::MetricsRegistry::Gauge::Ptr gauge = registry.GetGauge("ssdk_bench_check_queue_depth", "Queue depth", { { "session", "1" } });
+    util::MetricsRegistry::Histogram::Ptr histogram = registry.GetHistogram("ssdk_bench_check_latency_seconds", "Latency", { 0.2, 0.3, 1 });
+    counter->Add(40);
+    counter->Increment();
+    counter->Increment();
+    gauge->Set(0.25);
+    for (double value : { 0.125, 0.25, 0.5, 2.0 })
+    {
+        histogram->Observe(value);
+    }
+    static const char* const EXPECTED_LINES[] = {
+        "# TYPE ssdk_bench_check_requests counter\n",
+        "# HELP ssdk_bench_check_requests Requests \\\\ served\n",
+        "ssdk_bench_check_requests_total{path=\"/a\\\"b\"} 42\n",
+        "# TYPE ssdk_bench_check_queue_depth gauge\n",
+        "ssdk_bench_check_queue_depth{session=\"1\"} 0.25\n",
+        "# TYPE ssdk_bench_check_latency_seconds histogram\n",
+        "ssdk_bench_check_latency_seconds_bucket{le=\"0.2\"} 1\n",
+        "ssdk_bench_check_latency_seconds_bucket{le=\"0.3\"} 2\n",
+        "ssdk_bench_check_latency_seconds_bucket{le=\"1\"} 3\n",
+        "ssdk_bench_check_latency_seconds_bucket{le=\"+Inf\"} 4\n",
+        "ssdk_bench_check_latency_seconds_count 4\n",
+        "ssdk_bench_check_latency_seconds_sum 2.875\n",
+    };
+
+    util::MetricsExporter exporter;
+    if (exporter.Init("tcp://127.0.0.1:" + std::to_string(SCRAPE_PORT)) == false)
+    {
+        state.SkipWithError("Cannot listen on port " + std::to_string(SCRAPE_PORT));
+        return;
+    }
+    std::vector<char> buffer(65536);
+    std::string response;
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        if (SendScrapeRequest(SCRAPE_REQUEST, buffer, response) == false)
+        {
+            state.SkipWithError("Cannot connect to the metrics endpoint");
+            failed = true;
+            break;
+        }
+        const size_t headerEnd = response.find("\r\n\r\n");
+        const std::string body = headerEnd != std::string::npos ? response.substr(headerEnd + 4) : std::string();
+        if (response.compare(0, 17, "HTTP/1.0 200 OK\r\n") != 0 || response.find(std::string("Content-Type: ") + util::MetricsExporter::CONTENT_TYPE + "\r\n") == std::string::npos ||
+            response.find("Content-Length: " + std::to_string(body.size()) + "\r\n") == std::string::npos)
+        {
+            state.SkipWithError("Malformed headers from the metrics endpoint");
+            failed = true;
+            break;
+        }
+        if (body.size() < 6 || body.compare(body.size() - 6, 6, "# EOF\n") != 0 || body.find("# EOF\n") != body.size() - 6)
+        {
+            state.SkipWithError("The exposition does not end with a single # EOF");
+            failed = true;
+            break;
+        }
+        for (const char* line : EXPECTED_LINES)
+        {
+            if (body.find(line) == std::string::npos)
+            {
+                state.SkipWithError(std::string("Missing from the exposition: ") + line);
+                failed = true;
+                break;
+            }
+        }
+        if (failed == true)
+        {
+            break;
+        }
+
+        gauge.reset();
+        if (SendScrapeRequest(SCRAPE_REQUEST, buffer, response) == false || response.find("ssdk_bench_check_queue_depth") != std::string::npos ||
+            response.find(EXPECTED_LINES[2]) == std::string::npos)
+        {
+            state.SkipWithError("A released gauge was still exported, or the metrics which are alive were not");
+            failed = true;
+            break;
+        }
+        if (SendScrapeRequest("GET /other HTTP/1.1\r\n\r\n", buffer, response) == false || response.compare(0, 22, "HTTP/1.0 404 Not Found") != 0 ||
+            SendScrapeRequest("POST /metrics HTTP/1.1\r\n\r\n", buffer, response) == false || response.compare(0, 31, "HTTP/1.0 405 Method Not Allowed") != 0)
+        {
+            state.SkipWithError("Requests other than GET /metrics were not refused");
+            failed = true;
+            break;
+        }
+    }
+    exporter.Terminate();
+}
+
+//-------------------------------------------------------------------------------------------------
+// BufferPool - one lease per outbound message, compared with the allocations it replaces
+//-------------------------------------------------------------------------------------------------
+//  Sizes of an audio frame, a P-frame, an IDR frame and a 4K IDR frame
+static const std::vector<int64_t> SEND_BUFFER_SIZES = { 480, 42000, 262144, 1048576 };
+
+static std::string FormatHitRate(const util::BufferPool::Stats& before, const util::BufferPool::Stats& after)
+{
+    uint64_t acquired = after.acquired - before.acquired;
+    uint64_t hits = (after.threadCacheHits + after.sharedHits) - (before.threadCacheHits + before.sharedHits);
+    char label[64];
+    snprintf(label, sizeof(label), "hit rate %.2f%%", acquired > 0 ? 100.0 * double(hits) / double(acquired) : 0.0);
+    return label;
+}
+
+//  Every buffer is written to, an untouched allocation would not show the page faults a fresh multi-hundred-KB block costs
+static void BufferPoolAcquire(BenchmarkState& state)
+{
+    util::BufferPool& pool = util::BufferPool::GetInstance();
+    util::BufferPool::Stats before = pool.GetStats();
+    while (state.KeepRunning() == true)
+    {
+        util::BufferPool::Lease lease = pool.Acquire(size_t(state.GetArg()));
+        memset(lease.GetData(), 0, lease.GetSize());
+        BenchmarkState::DoNotOptimize(lease.GetData()[0]);
+    }
+    state.SetBytesProcessed(state.GetIterations() * state.GetArg());
+    state.SetLabel(FormatHitRate(before, pool.GetStats()));
+}
+
+//  The way SetCursor and the send queues use a lease: one buffer, a reference per session, released by the last one
+static void BufferPoolShare(BenchmarkState& state)
+{
+    util::BufferPool& pool = util::BufferPool::GetInstance();
+    std::vector<util::BufferPool::Lease> sessions(size_t(state.GetArg()));
+    util::BufferPool::Stats before = pool.GetStats();
+    while (state.KeepRunning() == true)
+    {
+        util::BufferPool::Lease lease = pool.Acquire(42000);
+        for (util::BufferPool::Lease& session : sessions)
+        {
+            session = lease;
+        }
+        lease.Reset();
+        for (util::BufferPool::Lease& session : sessions)
+        {
+            session.Reset();
+        }
+    }
+    state.SetItemsProcessed(state.GetIterations());
+    state.SetLabel(FormatHitRate(before, pool.GetStats()));
+}
+
+static void HeapAllocate(BenchmarkState& state)
+{
+    while (state.KeepRunning() == true)
+    {
+        std::unique_ptr<uint8_t[]> buffer(new uint8_t[size_t(state.GetArg())]);
+        memset(buffer.get(), 0, size_t(state.GetArg()));
+        BenchmarkState::DoNotOptimize(buffer[0]);
+    }
+    state.SetBytesProcessed(state.GetIterations() * state.GetArg());
+}
+
+static void AMFBufferAllocate(BenchmarkState& state, amf::AMFContext* context)
+{
+    while (state.KeepRunning() == true)
+    {
+        amf::AMFBufferPtr pBuffer;
+        if (context == nullptr || context->AllocBuffer(amf::AMF_MEMORY_HOST, size_t(state.GetArg()), &pBuffer) != AMF_OK)
+        {
+            state.SkipWithError("AllocBuffer() failed");
+            break;
+        }
+        memset(pBuffer->GetNative(), 0, size_t(state.GetArg()));
+        BenchmarkState::DoNotOptimize(static_cast<uint8_t*>(pBuffer->GetNative())[0]);
+    }
+    state.SetBytesProcessed(state.GetIterations() * state.GetArg());
+}
+
+//-------------------------------------------------------------------------------------------------
+// SessionRatePolicy and FrameDropFilter - decisions over synthetic per-session stats, no clock or transport involved
+//-------------------------------------------------------------------------------------------------
+typedef transport_common::VideoFrame::SubframeType SubframeType;
+
+static constexpr const amf_pts FRAME_INTERVAL = AMF_SECOND / 60;
+
+static void CheckSessionRatePolicyModes(BenchmarkState& state)
+{
+    std::vector<util::SessionRateState> sessions(3);
+    sessions[0].session = 1;
+    sessions[0].targetBitrate = 2000000;
+    sessions[1].session = 2;
+    sessions[1].targetBitrate = 5000000;
+    sessions[2].session = 3;
+    sessions[2].targetBitrate = 10000000;
+
+    while (state.KeepRunning() == true)
+    {
+        util::SessionRatePolicy policy;
+        util::SessionRatePolicy::Params params;
+        util::SessionRatePolicy::Decision decision = policy.Evaluate(sessions);
+        if (decision.encoderBitrate != 2000000 || decision.deliveryBitrates.empty() == false)
+        {
+            state.SkipWithError("WORST_SESSION: the encoder does not run at the worst session's bitrate");
+            break;
+        }
+
+        params.mode = util::SessionRatePolicy::Mode::PERCENTILE;
+        params.percentile = 0.5f;
+        policy.SetParams(params);
+        decision = policy.Evaluate(sessions);
+        if (decision.encoderBitrate != 5000000 || decision.deliveryBitrates.size() != 1 || decision.deliveryBitrates[1] != 2000000)
+        {
+            state.SkipWithError("PERCENTILE: wrong encoder bitrate or paced sessions");
+            break;
+        }
+
+        params.mode = util::SessionRatePolicy::Mode::SELECTIVE_DROP;
+        policy.SetParams(params);
+        decision = policy.Evaluate(sessions);
+        if (decision.encoderBitrate != 10000000 || decision.deliveryBitrates.size() != 2 || decision.deliveryBitrates[2] != 5000000)
+        {
+            state.SkipWithError("SELECTIVE_DROP: wrong encoder bitrate or paced sessions");
+            break;
+        }
+
+        params.mode = util::SessionRatePolicy::Mode::ENCODER_PER_TIER;
+        params.tierBitrates = { 8000000, 3000000 };
+        policy.SetParams(params);
+        decision = policy.Evaluate(sessions);
+        if (decision.encoderBitrate != 8000000 || decision.tiers.size() != 2 || decision.tiers[3000000].size() != 2 || decision.tiers[8000000].count(3) != 1)
+        {
+            state.SkipWithError("ENCODER_PER_TIER: sessions were not grouped into the tiers they can sustain");
+            break;
+        }
+        if (decision.deliveryBitrates.size() != 2 || decision.deliveryBitrates[1] != 3000000 || decision.deliveryBitrates[2] != 3000000)
+        {
+            state.SkipWithError("ENCODER_PER_TIER: sessions below the top tier are not paced to their tier");
+            break;
+        }
+    }
+}
+
+//  QoS re-applies the policy on every evaluation, the session's debt must survive a bitrate that keeps changing
+static void CheckFrameDropFilterReevaluation(BenchmarkState& state)
+{
+    static constexpr const int64_t BITRATE = 1000000;
+
+    while (state.KeepRunning() == true)
+    {
+        util::FrameDropFilter filter;
+        amf_pts now = AMF_SECOND;
+        size_t frameSize = size_t(BITRATE * 2 / 60 / 8);    //  Twice what the session can take
+        for (int i = 0; i < 120; ++i, now += FRAME_INTERVAL)
+        {
+            if (i % 6 == 0)
+            {
+                filter.SetBitrate(BITRATE + (i / 6 % 2) * 10000);
+            }
+            filter.Filter(now, now, frameSize, SubframeType::P, false);
+        }
+        if (filter.GetDroppedFrames() == 0)
+        {
+            state.SkipWithError("a session sent twice its bitrate for 2 s without a frame dropped");
+            break;
+        }
+
+        util::FrameDropFilter idle;
+        idle.SetBitrate(4 * BITRATE);
+        idle.Filter(AMF_SECOND, AMF_SECOND, 1, SubframeType::P, false);
+        idle.Filter(2 * AMF_SECOND, 2 * AMF_SECOND, 1, SubframeType::P, false);
+        idle.SetBitrate(BITRATE);
+        if (idle.GetBudget() > BITRATE / 2 || idle.GetBudget() < BITRATE / 2 - 16)
+        {
+            state.SkipWithError("the burst budget was not clamped to the new bitrate");
+            break;
+        }
+    }
+}
+
+//  Sliced frames: only the last slice carries the frame type, the key flag and the PTS identify the rest
+static void CheckFrameDropFilterSlices(BenchmarkState& state)
+{
+    static constexpr const int64_t BITRATE = 1000000;
+    static constexpr const int SLICES = 4;
+
+    while (state.KeepRunning() == true)
+    {
+        util::FrameDropFilter filter;
+        filter.SetBitrate(BITRATE);
+        amf_pts now = AMF_SECOND;
+        bool waitingForKeyFrame = false;
+        for (int i = 0; i < 120 && waitingForKeyFrame == false; ++i, now += FRAME_INTERVAL)
+        {
+            waitingForKeyFrame = filter.Filter(now, now, size_t(BITRATE / 8), SubframeType::P, false) == util::FrameDropFilter::Verdict::DROP_UNTIL_KEY_FRAME;
+        }
+        if (waitingForKeyFrame == false)
+        {
+            state.SkipWithError("the session never fell behind far enough to wait for a key frame");
+            break;
+        }
+
+        //  A sliced P-frame while waiting: none of it goes out
+        int sent = 0;
+        for (int slice = 0; slice < SLICES; ++slice)
+        {
+            sent += filter.Filter(now, now, 1000, slice < SLICES - 1 ? SubframeType::SLICE : SubframeType::P, false) == util::FrameDropFilter::Verdict::SEND ? 1 : 0;
+        }
+        now += FRAME_INTERVAL;
+        if (sent != 0)
+        {
+            state.SkipWithError("part of a sliced P-frame was sent while waiting for a key frame");
+            break;
+        }
+
+        //  A sliced IDR: all of it goes out and ends the wait
+        for (int slice = 0; slice < SLICES; ++slice)
+        {
+            sent += filter.Filter(now, now, 1000, slice < SLICES - 1 ? SubframeType::SLICE : SubframeType::IDR, true) == util::FrameDropFilter::Verdict::SEND ? 1 : 0;
+        }
+        now += AMF_SECOND;
+        if (sent != SLICES)
+        {
+            state.SkipWithError("a sliced IDR was not sent in full");
+            break;
+        }
+        if (filter.Filter(now, now, 1000, SubframeType::P, false) != util::FrameDropFilter::Verdict::SEND)
+        {
+            state.SkipWithError("the sliced IDR did not end the wait for a key frame");
+            break;
+        }
+        now += FRAME_INTERVAL;
+
+        //  A sliced P-frame which starts within the budget is sent in full even when it overdraws it
+        sent = 0;
+        for (int slice = 0; slice < SLICES; ++slice)
+        {
+            sent += filter.Filter(now, now, size_t(BITRATE / 4), slice < SLICES - 1 ? SubframeType::SLICE : SubframeType::P, false) == util::FrameDropFilter::Verdict::SEND ? 1 : 0;
+        }
+        if (sent != SLICES)
+        {
+            state.SkipWithError("a sliced P-frame was cut off midway");
+            break;
+        }
+    }
+}
+
+//  A P-only stream, as the low latency encoders produce, at twice the session's bitrate: without pacing in the
+//  transport the filter has nothing but reference frames to drop, with it every frame is passed on to be delayed
+static void CheckFrameDropFilterPOnly(BenchmarkState& state)
+{
+    static constexpr const int64_t BITRATE = 1000000;
+
+    while (state.KeepRunning() == true)
+    {
+        bool failed = false;
+        for (int paced = 0; paced < 2 && failed == false; ++paced)
+        {
+            util::FrameDropFilter filter;
+            filter.SetBitrate(BITRATE);
+            filter.SetPaced(paced == 1);
+            amf_pts now = AMF_SECOND;
+            int waits = 0;
+            for (int i = 0; i < 240; ++i, now += FRAME_INTERVAL)
+            {
+                bool keyFrame = i % 120 == 0;
+                util::FrameDropFilter::Verdict verdict = filter.Filter(now, now, size_t(BITRATE * 2 / 60 / 8), keyFrame == true ? SubframeType::IDR : SubframeType::P, keyFrame);
+                waits += verdict == util::FrameDropFilter::Verdict::DROP_UNTIL_KEY_FRAME ? 1 : 0;
+            }
+            if (paced == 0 && waits == 0)
+            {
+                state.SkipWithError("an unpaced session twice over its bitrate never waited for a key frame");
+                failed = true;
+            }
+            else if (paced == 1 && (filter.GetDroppedFrames() != 0 || filter.GetBudget() < -BITRATE / 2))
+            {
+                state.SkipWithError("a paced session had " + std::to_string(filter.GetDroppedFrames()) + " P-frames dropped");
+                failed = true;
+            }
+            else if (paced == 1)
+            {   //  The deficit is capped, a session back under its bitrate catches up within a second
+                for (int i = 0; i < 60; ++i, now += FRAME_INTERVAL)
+                {
+                    filter.Filter(now, now, size_t(BITRATE / 4 / 60 / 8), SubframeType::P, false);
+                }
+                if (filter.GetBudget() < 0)
+                {
+                    state.SkipWithError("a paced session had not caught up a second after its stream slowed down");
+                    failed = true;
+                }
+            }
+        }
+        if (failed == true)
+        {
+            break;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// FrameChangeDetector - static content detection on BGRA desktop frames in host memory
+//-------------------------------------------------------------------------------------------------
+static const std::vector<int64_t> FRAME_HEIGHTS = { 720, 1080, 2160 };     //  16:9
+
+static void FillDesktop(uint8_t* data, size_t width, size_t height, size_t pitch)
+{
+    std::mt19937 generator(34);
+    for (size_t y = 0; y < height; ++y)
+    {
+        uint32_t* row = reinterpret_cast<uint32_t*>(data + y * pitch);
+        for (size_t x = 0; x < width; ++x)
+        {
+            row[x] = generator();
+        }
+    }
+}
+
+static void FrameChangeDetectorHashTiles(BenchmarkState& state)
+{
+    const size_t height = size_t(state.GetArg());
+    const size_t width = height * 16 / 9;
+    const size_t pitch = width * 4;
+    std::vector<uint8_t> frame(pitch * height);
+    FillDesktop(frame.data(), width, height, pitch);
+    std::vector<uint64_t> hashes;
+    while (state.KeepRunning() == true)
+    {
+        hashes.clear();
+        video::FrameChangeDetector::HashTiles(frame.data(), pitch, height, pitch, 64 * 4, 64, hashes);
+        BenchmarkState::DoNotOptimize(hashes[0]);
+    }
+    state.SetBytesProcessed(state.GetIterations() * int64_t(frame.size()));
+    state.SetItemsProcessed(state.GetIterations());
+    state.SetLabel(std::to_string(hashes.size()) + " tiles");
+}
+
+//  A host memory frame goes out while it changes and for the refinement frames after, then it is skipped
+//  until a single pixel changes, which must be caught in its tile
+static void CheckFrameChangeDetectorHostSurface(BenchmarkState& state, amf::AMFContext* context)
+{
+    static constexpr const int32_t WIDTH = 640;
+    static constexpr const int32_t HEIGHT = 360;
+    static constexpr const uint32_t REFINEMENT_FRAMES = 2;
+
+    while (state.KeepRunning() == true)
+    {
+        amf::AMFSurfacePtr surface;
+        if (context == nullptr || context->AllocSurface(amf::AMF_MEMORY_HOST, amf::AMF_SURFACE_BGRA, WIDTH, HEIGHT, &surface) != AMF_OK)
+        {
+            state.SkipWithError("AllocSurface() failed");
+            break;
+        }
+        amf::AMFPlane* plane = surface->GetPlaneAt(0);
+        uint8_t* data = static_cast<uint8_t*>(plane->GetNative());
+        FillDesktop(data, size_t(WIDTH), size_t(HEIGHT), size_t(plane->GetHPitch()));
+
+        video::FrameChangeDetector detector;
+        video::FrameChangeDetector::Params params;
+        params.enabled = true;
+        params.idleFramerate = 0;
+        params.refinementFrames = REFINEMENT_FRAMES;
+        detector.SetParams(params);
+
+        amf_pts now = AMF_SECOND;
+        int submitted = 0;
+        for (int i = 0; i < 10; ++i, now += FRAME_INTERVAL)
+        {
+            submitted += detector.Evaluate(surface, now) == video::FrameChangeDetector::Decision::SUBMIT ? 1 : 0;
+        }
+        if (submitted != 1 + int(REFINEMENT_FRAMES) || detector.IsInspecting() == false)
+        {
+            state.SkipWithError(std::to_string(submitted) + " frames of static content were submitted, expected " + std::to_string(1 + REFINEMENT_FRAMES));
+            break;
+        }
+
+        data[(HEIGHT / 2) * plane->GetHPitch() + (WIDTH / 2) * 4] ^= 1;
+        if (detector.Evaluate(surface, now) != video::FrameChangeDetector::Decision::SUBMIT || detector.GetChangedTileCount() != 1)
+        {
+            state.SkipWithError("a changed pixel was not detected in exactly one tile");
+            break;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+// PCMConverter - inline PCM conversion, compared with the FFmpeg audio converter component it replaces
+//-------------------------------------------------------------------------------------------------
+class PCMConversion
+{
+public:
+    const char*                 m_Name;
+    util::PCMConverter::Format  m_Input;
+    util::PCMConverter::Format  m_Output;
+};
+
+static const PCMConversion PCM_CONVERSIONS[] =
+{
+    { "S16-FLT",        { amf::AMFAF_S16, 48000, 2, 0 },    { amf::AMFAF_FLT, 48000, 2, 0 } },
+    { "FLTP-S16",       { amf::AMFAF_FLTP, 48000, 2, 0 },   { amf::AMFAF_S16, 48000, 2, 0 } },
+    { "5.1-Stereo",     { amf::AMFAF_FLT, 48000, 6, 0 },    { amf::AMFAF_S16, 48000, 2, 0 } },
+    { "44.1k-48k",      { amf::AMFAF_S16, 44100, 2, 0 },    { amf::AMFAF_S16, 48000, 2, 0 } },
+    { "48k-44.1k",      { amf::AMFAF_FLTP, 48000, 2, 0 },   { amf::AMFAF_S16, 44100, 2, 0 } },
+};
+static const std::vector<int64_t> PCM_CONVERSION_CASES = { 0, 1, 2, 3, 4 };    //  Indices into PCM_CONVERSIONS
+static constexpr const size_t PCM_FRAME_SAMPLES = 480;                         //  10 ms at 48 kHz, the audio frame of the stream
+
+static size_t PCMSampleSize(amf::AMF_AUDIO_FORMAT format)
+{
+    return format == amf::AMFAF_S16 || format == amf::AMFAF_S16P ? sizeof(int16_t) : sizeof(float);
+}
+
+static void FillTone(void* data, const util::PCMConverter::Format& format, size_t sampleCount, size_t firstSample, double frequency, double amplitude)
+{
+    static constexpr double PI = 3.14159265358979323846;
+    const bool planar = format.format == amf::AMFAF_S16P || format.format == amf::AMFAF_FLTP;
+    const size_t channels = size_t(format.channels);
+    for (size_t i = 0; i < sampleCount; ++i)
+    {
+        double value = amplitude * std::sin(2.0 * PI * frequency * double(firstSample + i) / double(format.samplingRate));
+        for (size_t channel = 0; channel < channels; ++channel)
+        {
+            size_t index = planar == true ? channel * sampleCount + i : i * channels + channel;
+            if (PCMSampleSize(format.format) == sizeof(int16_t))
+            {
+                static_cast<int16_t*>(data)[index] = int16_t(std::lrint(value * 32767.0));
+            }
+            else
+            {
+                static_cast<float*>(data)[index] = float(value);
+            }
+        }
+    }
+}
+
+//  The same component AudioOutput falls back to, NULL when the FFmpeg helper library is not installed
+static amf::AMFComponentPtr CreateFFmpegConverter(amf::AMFContext* context, const util::PCMConverter::Format& input, const util::PCMConverter::Format& output)
+{
+    amf::AMFComponentPtr converter;
+    if (context == nullptr ||
+        g_AMFFactory.LoadExternalComponent(context, FFMPEG_HELPER_DLL_NAME, "AMFCreateComponentInt", (void*)FFMPEG_AUDIO_CONVERTER, &converter) != AMF_OK || converter == nullptr)
+    {
+        return nullptr;
+    }
+    converter->SetProperty(AUDIO_CONVERTER_IN_AUDIO_SAMPLE_RATE, input.samplingRate);
+    converter->SetProperty(AUDIO_CONVERTER_IN_AUDIO_SAMPLE_FORMAT, input.format);
+    converter->SetProperty(AUDIO_CONVERTER_IN_AUDIO_CHANNELS, input.channels);
+    converter->SetProperty(AUDIO_CONVERTER_IN_AUDIO_CHANNEL_LAYOUT, input.layout);
+    converter->SetProperty(AUDIO_CONVERTER_OUT_AUDIO_SAMPLE_RATE, output.samplingRate);
+    converter->SetProperty(AUDIO_CONVERTER_OUT_AUDIO_SAMPLE_FORMAT, output.format);
+    converter->SetProperty(AUDIO_CONVERTER_OUT_AUDIO_CHANNELS, output.channels);
+    converter->SetProperty(AUDIO_CONVERTER_OUT_AUDIO_CHANNEL_LAYOUT, output.layout);
+    return converter->Init(amf::AMF_SURFACE_UNKNOWN, 0, 0) == AMF_OK ? converter : nullptr;
+}
+
+//  Runs the whole input through the component and drains it, the output bytes are appended
+static bool FFmpegConvert(amf::AMFContext* context, amf::AMFComponent* converter, const util::PCMConverter::Format& format,
+                          const void* input, size_t sampleCount, std::vector<uint8_t>& output)
+{
+    amf::AMFAudioBufferPtr buffer;
+    if (context->AllocAudioBuffer(amf::AMF_MEMORY_HOST, format.format, amf_int32(sampleCount), format.samplingRate, format.channels, &buffer) != AMF_OK)
+    {
+        return false;
+    }
+    memcpy(buffer->GetNative(), input, sampleCount * size_t(format.channels) * PCMSampleSize(format.format));
+    buffer->SetPts(0);
+    buffer->SetDuration(amf_pts(sampleCount) * AMF_SECOND / format.samplingRate);
+    if (converter->SubmitInput(buffer) != AMF_OK || converter->Drain() != AMF_OK)
+    {
+        return false;
+    }
+    for (int attempt = 0; attempt < 1000; )
+    {
+        amf::AMFDataPtr data;
+        AMF_RESULT result = converter->QueryOutput(&data);
+        if (result == AMF_EOF)
+        {
+            return true;
+        }
+        amf::AMFAudioBufferPtr converted(data);
+        if (converted != nullptr)
+        {
+            const uint8_t* native = static_cast<const uint8_t*>(converted->GetNative());
+            output.insert(output.end(), native, native + converted->GetSize());
+        }
+        else if (result == AMF_OK || result == AMF_REPEAT)
+        {
+            amf_sleep(1);
+            ++attempt;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return false;
+}
+
+//  Every 16-bit value survives a round trip through float, and float to 16-bit conversion rounds half to even and clips
+//  exactly like FFmpeg's av_clip_int16(lrintf(x * 32768)). When the FFmpeg component loads, its output must match bit for bit
+static void CheckPCMConverterBitExact(BenchmarkState& state, amf::AMFContext* context)
+{
+    static constexpr const size_t S16_VALUES = 65536;
+    static constexpr const size_t FLOAT_VALUES = 5 * 65536 + 4;      //  [-1.25, 1.25] in half LSB steps, whole stereo samples in 3 sample chunks, not whole vectors
+    const util::PCMConverter::Format s16 = { amf::AMFAF_S16, 48000, 2, 0 };
+    const util::PCMConverter::Format flt = { amf::AMFAF_FLT, 48000, 2, 0 };
+
+    std::vector<int16_t> pcm(S16_VALUES);
+    for (size_t i = 0; i < S16_VALUES; ++i)
+    {
+        pcm[i] = int16_t(int32_t(i) - 32768);
+    }
+    std::vector<float> edges(FLOAT_VALUES);
+    for (size_t i = 0; i < FLOAT_VALUES; ++i)
+    {
+        edges[i] = float(int64_t(i) - int64_t(FLOAT_VALUES / 2)) / 65536.0f;
+    }
+
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        util::PCMConverter toFloat;
+        util::PCMConverter toS16;
+        if (toFloat.Init(s16, flt) == false || toS16.Init(flt, s16) == false)
+        {
+            state.SkipWithError("PCMConverter::Init() failed");
+            failed = true;
+            break;
+        }
+        std::vector<float> floats(S16_VALUES);
+        std::vector<int16_t> roundTrip(S16_VALUES);
+        toFloat.Convert(pcm.data(), S16_VALUES / 2, floats.data(), S16_VALUES / 2);
+        toS16.Convert(floats.data(), S16_VALUES / 2, roundTrip.data(), S16_VALUES / 2);
+        for (size_t i = 0; i < S16_VALUES && failed == false; ++i)
+        {
+            if (floats[i] != float(pcm[i]) / 32768.0f || roundTrip[i] != pcm[i])
+            {
+                state.SkipWithError("16-bit sample " + std::to_string(pcm[i]) + " did not survive the round trip through float");
+                failed = true;
+            }
+        }
+
+        std::vector<int16_t> clipped(FLOAT_VALUES);
+        std::vector<int16_t> clippedScalar(FLOAT_VALUES);
+        toS16.Convert(edges.data(), FLOAT_VALUES / 2, clipped.data(), FLOAT_VALUES / 2);
+        for (size_t i = 0; i < FLOAT_VALUES; i += 6)
+        {   //  Shorter than a vector, the scalar path converts all of it
+            toS16.Convert(&edges[i], 3, &clippedScalar[i], 3);
+        }
+        for (size_t i = 0; i < FLOAT_VALUES && failed == false; ++i)
+        {
+            int16_t expected = int16_t(std::min(std::max(std::nearbyint(edges[i] * 32768.0f), -32768.0f), 32767.0f));
+            if (clipped[i] != expected || clippedScalar[i] != expected)
+            {
+                state.SkipWithError("float sample " + std::to_string(edges[i]) + " converted to " + std::to_string(clipped[i]) + " and " + std::to_string(clippedScalar[i]) + ", expected " + std::to_string(expected));
+                failed = true;
+            }
+        }
+        if (failed == true)
+        {
+            break;
+        }
+
+        amf::AMFComponentPtr ffmpegToFloat = CreateFFmpegConverter(context, s16, flt);
+        amf::AMFComponentPtr ffmpegToS16 = CreateFFmpegConverter(context, flt, s16);
+        if (ffmpegToFloat == nullptr || ffmpegToS16 == nullptr)
+        {
+            state.SetLabel("FFmpeg converter not available, compared with its conversion formulas only");
+            break;
+        }
+        std::vector<uint8_t> ffmpegFloats;
+        std::vector<uint8_t> ffmpegClipped;
+        if (FFmpegConvert(context, ffmpegToFloat, s16, pcm.data(), S16_VALUES / 2, ffmpegFloats) == false ||
+            FFmpegConvert(context, ffmpegToS16, flt, edges.data(), FLOAT_VALUES / 2, ffmpegClipped) == false)
+        {
+            state.SkipWithError("the FFmpeg audio converter failed");
+            failed = true;
+        }
+        else if (ffmpegFloats.size() != floats.size() * sizeof(float) || memcmp(ffmpegFloats.data(), floats.data(), ffmpegFloats.size()) != 0 ||
+                 ffmpegClipped.size() != clipped.size() * sizeof(int16_t) || memcmp(ffmpegClipped.data(), clipped.data(), ffmpegClipped.size()) != 0)
+        {
+            state.SkipWithError("PCMConverter output differs from the FFmpeg audio converter");
+            failed = true;
+        }
+    }
+}
+
+//  A tone resampled in uneven chunks is fitted with a sine at the times given by the output pts, which PCMAudioConverter computes
+//  as the input pts plus GetOutputPtsOffset(). The phase of the fit is the pts error, which must be within one AMF time unit
+//  (without the offset it is half the filter, about 0.5 ms), and the residual of the fit is the noise and distortion of the filter
+static void CheckPCMConverterResamplerSNR(BenchmarkState& state)
+{
+    static constexpr const double TONE = 997.0;                 //  Hz, does not divide any of the rates
+    static constexpr const double AMPLITUDE = 0.5;
+    static constexpr const double MIN_SNR = 90.0;               //  dB
+    static constexpr const double MAX_PTS_ERROR = 1.0;          //  In AMF time units, the pts resolution
+    static constexpr const amf_pts SETTLE_TIME = AMF_SECOND / 100;
+    static const std::pair<int32_t, int32_t> RATES[] = { { 44100, 48000 }, { 48000, 44100 }, { 16000, 48000 }, { 48000, 16000 } };
+    static const size_t CHUNKS[] = { 480, 17, 1024, 333 };
+    static constexpr double PI = 3.14159265358979323846;
+
+    bool failed = false;
+    while (failed == false && state.KeepRunning() == true)
+    {
+        std::string label;
+        for (const std::pair<int32_t, int32_t>& rates : RATES)
+        {
+            const util::PCMConverter::Format input = { amf::AMFAF_FLTP, rates.first, 1, 0 };
+            const util::PCMConverter::Format output = { amf::AMFAF_FLTP, rates.second, 1, 0 };
+            util::PCMConverter converter;
+            if (converter.Init(input, output) == false)
+            {
+                state.SkipWithError("PCMConverter::Init() failed");
+                failed = true;
+                break;
+            }
+            const std::string name = std::to_string(rates.first) + "->" + std::to_string(rates.second);
+            const amf_pts firstPts = converter.GetOutputPtsOffset();
+            size_t consumed = 0;
+            size_t produced = 0;
+            std::vector<float> in;
+            std::vector<float> out;
+            std::vector<double> times;
+            std::vector<double> samples;
+            for (size_t chunk = 0; consumed < size_t(rates.first); ++chunk)
+            {
+                const size_t count = CHUNKS[chunk % amf_countof(CHUNKS)];
+                const amf_pts pts = amf_pts(consumed) * AMF_SECOND / rates.first + converter.GetOutputPtsOffset();
+                const double expectedPts = double(firstPts) + double(produced) * double(AMF_SECOND) / double(rates.second);
+                if (std::abs(double(pts) - expectedPts) > 2.0)
+                {
+                    state.SkipWithError(name + ": chunk " + std::to_string(chunk) + " pts " + std::to_string(pts) + " is not contiguous with the previous output");
+                    failed = true;
+                    break;
+                }
+                in.resize(count);
+                FillTone(in.data(), input, count, consumed, TONE, AMPLITUDE);
+                out.resize(converter.GetOutputSampleCount(count));
+                const size_t converted = converter.Convert(in.data(), count, out.data(), out.size());
+                for (size_t i = 0; i < converted; ++i)
+                {   //  Timed from the first pts, the pts of the later chunks were checked to be contiguous with it
+                    const double t = double(firstPts) / double(AMF_SECOND) + double(produced + i) / double(rates.second);
+                    if (t * double(AMF_SECOND) >= double(SETTLE_TIME))
+                    {
+                        times.push_back(t);
+                        samples.push_back(double(out[i]));
+                    }
+                }
+                consumed += count;
+                produced += converted;
+            }
+            if (failed == true)
+            {
+                break;
+            }
+            //  Least squares fit of a * sin(wt) + b * cos(wt) = A * sin(w(t + error))
+            const double w = 2.0 * PI * TONE;
+            double ss = 0.0, sc = 0.0, cc = 0.0, ys = 0.0, yc = 0.0;
+            for (size_t i = 0; i < samples.size(); ++i)
+            {
+                const double s = std::sin(w * times[i]);
+                const double c = std::cos(w * times[i]);
+                ss += s * s;
+                sc += s * c;
+                cc += c * c;
+                ys += samples[i] * s;
+                yc += samples[i] * c;
+            }
+            const double determinant = ss * cc - sc * sc;
+            const double a = (ys * cc - yc * sc) / determinant;
+            const double b = (yc * ss - ys * sc) / determinant;
+            double signal = 0.0;
+            double noise = 0.0;
+            for (size_t i = 0; i < samples.size(); ++i)
+            {
+                const double fit = a * std::sin(w * times[i]) + b * std::cos(w * times[i]);
+                signal += fit * fit;
+                noise += (samples[i] - fit) * (samples[i] - fit);
+            }
+            const double ptsError = std::atan2(b, a) / w * double(AMF_SECOND);
+            const double snr = 10.0 * std::log10(signal / std::max(noise, 1e-30));
+            if (std::abs(ptsError) > MAX_PTS_ERROR)
+            {
+                state.SkipWithError(name + ": output pts is off by " + std::to_string(ptsError / 10.0) + " us");
+                failed = true;
+                break;
+            }
+            if (snr < MIN_SNR)
+            {
+                state.SkipWithError(name + ": SNR " + std::to_string(snr) + " dB is below " + std::to_string(MIN_SNR) + " dB");
+                failed = true;
+                break;
+            }
+            char snrText[32];
+            snprintf(snrText, sizeof(snrText), "%.1f dB", snr);
+            label += (label.empty() == true ? "" : ", ") + name + " " + snrText;
+        }
+        state.SetLabel(label);
+    }
+}
+
+static void PCMConverterConvert(BenchmarkState& state)
+{
+    const PCMConversion& conversion = PCM_CONVERSIONS[size_t(state.GetArg())];
+    util::PCMConverter converter;
+    converter.Init(conversion.m_Input, conversion.m_Output);
+    std::vector<uint8_t> input(PCM_FRAME_SAMPLES * size_t(conversion.m_Input.channels) * PCMSampleSize(conversion.m_Input.format));
+    FillTone(input.data(), conversion.m_Input, PCM_FRAME_SAMPLES, 0, 997.0, 0.5);
+    const size_t maxOutputSampleCount = PCM_FRAME_SAMPLES * size_t(conversion.m_Output.samplingRate) / size_t(conversion.m_Input.samplingRate) + 1;
+    std::vector<uint8_t> output(maxOutputSampleCount * size_t(conversion.m_Output.channels) * PCMSampleSize(conversion.m_Output.format));
+    while (state.KeepRunning() == true)
+    {
+        size_t converted = converter.Convert(input.data(), PCM_FRAME_SAMPLES, output.data(), maxOutputSampleCount);
+        BenchmarkState::DoNotOptimize(converted);
+    }
+    state.SetBytesProcessed(state.GetIterations() * int64_t(input.size()));
+    state.SetItemsProcessed(state.GetIterations() * int64_t(PCM_FRAME_SAMPLES));
+    state.SetLabel(conversion.m_Name);
+}
+
+//  Baseline: the FFmpeg audio converter component PCMConverter replaces, on the same frames
+static void FFmpegAudioConvert(BenchmarkState& state, amf::AMFContext* context)
+{
+    const PCMConversion& conversion = PCM_CONVERSIONS[size_t(state.GetArg())];
+    amf::AMFComponentPtr converter = CreateFFmpegConverter(context, conversion.m_Input, conversion.m_Output);
+    amf::AMFAudioBufferPtr input;
+    if (converter == nullptr ||
+        context->AllocAudioBuffer(amf::AMF_MEMORY_HOST, conversion.m_Input.format, amf_int32(PCM_FRAME_SAMPLES), conversion.m_Input.samplingRate, conversion.m_Input.channels, &input) != AMF_OK)
+    {
+        state.SkipWithMessage("FFmpeg audio converter not available");
+        return;
+    }
+    FillTone(input->GetNative(), conversion.m_Input, PCM_FRAME_SAMPLES, 0, 997.0, 0.5);
+    const amf_pts duration = amf_pts(PCM_FRAME_SAMPLES) * AMF_SECOND / conversion.m_Input.samplingRate;
+    input->SetDuration(duration);
+    amf_pts pts = 0;
+    while (state.KeepRunning() == true)
+    {
+        input->SetPts(pts);
+        pts += duration;
+        if (converter->SubmitInput(input) != AMF_OK)
+        {
+            state.SkipWithError("SubmitInput() failed");
+            break;
+        }
+        amf::AMFDataPtr converted;
+        converter->QueryOutput(&converted);
+        BenchmarkState::DoNotOptimize(converted);
+    }
+    state.SetBytesProcessed(state.GetIterations() * int64_t(input->GetSize()));
+    state.SetItemsProcessed(state.GetIterations() * int64_t(PCM_FRAME_SAMPLES));
+    state.SetLabel(conversion.m_Name);
+}
+
+void RegisterUtilBenchmarks(BenchmarkRunner& runner, amf::AMFContext* context)
+{
+    runner.Register("AESPSKCipher/Encrypt", CipherEncrypt, CIPHER_SIZES);
+    runner.Register("AESPSKCipher/Decrypt", CipherDecrypt, CIPHER_SIZES);
+    runner.Register("ValueHistory/AddValue/10", ValueHistoryAddValue<10>);
+    runner.Register("ValueHistory/AddValue/100", ValueHistoryAddValue<100>);
+    runner.Register("ValueAverage/Add", ValueAverageAdd);
+    runner.Register("AVSynchronizer/SubmitVideo", [context](BenchmarkState& state) { AVSynchronizerSubmitVideo(state, context, false); });
+    runner.Register("AVSynchronizer/SubmitVideo/Traced", [context](BenchmarkState& state) { AVSynchronizerSubmitVideo(state, context, true); });
+    runner.Register("AVSynchronizer/SubmitAudio", [context](BenchmarkState& state) { AVSynchronizerSubmitAudio(state, context); });
+    runner.Register("PipelineTrace/Span/Off", [](BenchmarkState& state) { PipelineTraceSpan(state, false); });
+    runner.Register("PipelineTrace/Span/On", [](BenchmarkState& state) { PipelineTraceSpan(state, true); });
+    runner.Register("PipelineTrace/Deferred/Off", [](BenchmarkState& state) { PipelineTraceDeferred(state, false); });
+    runner.Register("PipelineTrace/Deferred/On", [](BenchmarkState& state) { PipelineTraceDeferred(state, true); });
+    runner.Register("MetricsRegistry/Counter/Add", MetricsCounterAdd);
+    runner.Register("MetricsRegistry/Histogram/Observe", MetricsHistogramObserve);
+    runner.Register("MetricsRegistry/Export", MetricsExport, { 16, 256 });
+    runner.Register("MetricsExporter/Scrape", MetricsScrape, { 16, 256 });
+    runner.RegisterCheck("Check/MetricsRegistry/Churn", CheckMetricsRegistryChurn);
+    runner.RegisterCheck("Check/MetricsExporter/Scrape", CheckMetricsExporterScrape);
+    runner.Register("BufferPool/Acquire", BufferPoolAcquire, SEND_BUFFER_SIZES);
+    runner.Register("BufferPool/Share", BufferPoolShare, { 1, 4, 16 });
+    runner.Register("BufferPool/Baseline/Heap", HeapAllocate, SEND_BUFFER_SIZES);
+    runner.Register("BufferPool/Baseline/AMFBuffer", [context](BenchmarkState& state) { AMFBufferAllocate(state, context); }, SEND_BUFFER_SIZES);
+    runner.RegisterCheck("Check/SessionRatePolicy/Modes", CheckSessionRatePolicyModes);
+    runner.RegisterCheck("Check/FrameDropFilter/Reevaluation", CheckFrameDropFilterReevaluation);
+    runner.RegisterCheck("Check/FrameDropFilter/Slices", CheckFrameDropFilterSlices);
+    runner.RegisterCheck("Check/FrameDropFilter/POnly", CheckFrameDropFilterPOnly);
+    runner.Register("FrameChangeDetector/HashTiles", FrameChangeDetectorHashTiles, FRAME_HEIGHTS);
+    runner.RegisterCheck("Check/FrameChangeDetector/HostSurface", [context](BenchmarkState& state) { CheckFrameChangeDetectorHostSurface(state, context); });
+    runner.Register("PCMConverter/Convert", PCMConverterConvert, PCM_CONVERSION_CASES);
+    runner.Register("PCMConverter/Baseline/FFmpeg", [context](BenchmarkState& state) { FFmpegAudioConvert(state, context); }, PCM_CONVERSION_CASES);
+    runner.RegisterCheck("Check/PCMConverter/BitExact", [context](BenchmarkState& state) { CheckPCMConverterBitExact(state, context); });
+    runner.RegisterCheck("Check/PCMConverter/ResamplerSNR", CheckPCMConverterResamplerSNR);
+}
@@ -0,0 +1,557 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "LoadGenerator.h"
+
+#include "amf/public/common/AMFFactory.h"
+#include "amf/public/common/TraceAdapter.h"
+#include "amf/public/common/AMFSTL.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"LoadGenerator";
+
+//  Command line parameters
+static constexpr const wchar_t* PARAM_NAME_MODE = L"mode";
+static constexpr const wchar_t* PARAM_NAME_LOGFILE = L"LOGFILE";
+static constexpr const wchar_t* PARAM_NAME_PORT = L"port";
+static constexpr const wchar_t* PARAM_NAME_DATAGRAM_SIZE = L"datagramSize";
+static constexpr const wchar_t* PARAM_NAME_ENCRYPTION = L"encrypted";
+static constexpr const wchar_t* PARAM_NAME_PASSPHRASE = L"pass";
+static constexpr const wchar_t* PARAM_NAME_DURATION = L"Duration";
+static constexpr const wchar_t* PARAM_NAME_STATS_INTERVAL = L"StatsInterval";
+
+//  Client mode parameters
+static constexpr const wchar_t* PARAM_NAME_URL = L"server";
+static constexpr const wchar_t* PARAM_NAME_CLIENTS = L"Clients";
+static constexpr const wchar_t* PARAM_NAME_VIDEO = L"Video";
+static constexpr const wchar_t* PARAM_NAME_AUDIO = L"Audio";
+static constexpr const wchar_t* PARAM_NAME_INPUT_RATE = L"InputRate";
+static constexpr const wchar_t* PARAM_NAME_CHURN = L"Churn";
+static constexpr const wchar_t* PARAM_NAME_RESUME = L"Resume";
+static constexpr const wchar_t* PARAM_NAME_REBIND = L"Rebind";
+static constexpr const wchar_t* PARAM_NAME_RAMP_UP = L"RampUp";
+static constexpr const wchar_t* PARAM_NAME_PER_CLIENT_STATS = L"PerClientStats";
+
+//  Server mode parameters
+static constexpr const wchar_t* PARAM_NAME_PROTOCOL = L"protocol";
+static constexpr const wchar_t* PARAM_NAME_NETWORK_IMPAIRMENT = L"NetImpairment";
+static constexpr const wchar_t* PARAM_NAME_BIND_INTERFACE = L"BindInterface";
+static constexpr const wchar_t* PARAM_NAME_LOCAL_SOCKET = L"LocalSocket";
+static constexpr const wchar_t* PARAM_NAME_SERVER_HOSTNAME = L"Hostname";
+static constexpr const wchar_t* PARAM_NAME_MAX_CONNECTIONS = L"Connections";
+static constexpr const wchar_t* PARAM_NAME_RESOLUTION = L"Resolution";
+static constexpr const wchar_t* PARAM_NAME_FRAMERATE = L"FrameRate";
+static constexpr const wchar_t* PARAM_NAME_VIDEO_BITRATE = L"VideoBitrate";
+static constexpr const wchar_t* PARAM_NAME_AUDIO_BITRATE = L"AudioBitrate";
+static constexpr const wchar_t* PARAM_NAME_AUDIO_SAMPLING_RATE = L"AudioSamplingRate";
+static constexpr const wchar_t* PARAM_NAME_AUDIO_CHANNELS = L"AudioChannels";
+
+//  Values for PARAM_NAME_MODE
+static constexpr const wchar_t* MODE_CLIENT = L"CLIENT";
+static constexpr const wchar_t* MODE_SERVER = L"SERVER";
+
+//  Values for PARAM_NAME_PROTOCOL
+static constexpr const wchar_t* PROTOCOL_TCP = L"TCP";
+
+// Default parameter values
+static constexpr const unsigned short DEFAULT_PORT = 1235;
+static constexpr const int64_t  DEFAULT_DATAGRAM_SIZE = 65507;
+static constexpr const wchar_t* DEFAULT_LOG_FILENAME = L"./ssdk-loadgen.log";
+static constexpr const int64_t  DEFAULT_CLIENTS = 1;
+static constexpr const int64_t  DEFAULT_RAMP_UP = 100;              //  ms
+static constexpr const int64_t  DEFAULT_STATS_INTERVAL = 1;         //  seconds
+static constexpr const char*    DEFAULT_BIND_INTERFACE = "*";
+static constexpr const char*    DEFAULT_SERVER_HOSTNAME = "ssdk-loadgen";
+static constexpr const int64_t  DEFAULT_MAX_CONNECTIONS = 1000;
+static constexpr const int64_t  DEFAULT_FRAMERATE = 60;
+static constexpr const int64_t  DEFAULT_VIDEO_BITRATE = 20000000;
+static constexpr const int64_t  DEFAULT_AUDIO_BITRATE = 256000;
+static constexpr const int64_t  DEFAULT_AUDIO_SAMPLING_RATE = 48000;
+static constexpr const int64_t  DEFAULT_AUDIO_CHANNELS = 2;
+
+static std::atomic<bool> s_StopRequested = false;
+
+LoadGenerator::LoadGenerator()
+{
+    SetParamDescription(PARAM_NAME_MODE, ParamCommon, L"Specify what to run: [client, server], default = client", nullptr);
+    SetParamDescription(PARAM_NAME_LOGFILE, ParamCommon, L"Specify log file path, default = ./ssdk-loadgen.log", nullptr);
+    SetParamDescription(PARAM_NAME_PORT, ParamCommon, L"Specify a UDP/TCP port the server is listening on, default = 1235", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_DATAGRAM_SIZE, ParamCommon, L"Specify UDP datagram size, default = 65507", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_ENCRYPTION, ParamCommon, L"Enable AES encryption of traffic between client and server (true, false), default = false", ParamConverterBoolean);
+    SetParamDescription(PARAM_NAME_PASSPHRASE, ParamCommon, L"Specify a passphrase for AES encryption", nullptr);
+    SetParamDescription(PARAM_NAME_DURATION, ParamCommon, L"Run for the specified number of seconds, 0 - until interrupted, default = 0", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_STATS_INTERVAL, ParamCommon, L"Statistics reporting interval in seconds, default = 1", ParamConverterInt64);
+
+    SetParamDescription(PARAM_NAME_URL, ParamCommon, L"Client mode: server url, server auto discovered when not specified", nullptr);
+    SetParamDescription(PARAM_NAME_CLIENTS, ParamCommon, L"Client mode: number of simulated clients, default = 1", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_VIDEO, ParamCommon, L"Client mode: subscribe to the video stream (true, false), default = true", ParamConverterBoolean);
+    SetParamDescription(PARAM_NAME_AUDIO, ParamCommon, L"Client mode: subscribe to the audio stream (true, false), default = true", ParamConverterBoolean);
+    SetParamDescription(PARAM_NAME_INPUT_RATE, ParamCommon, L"Client mode: mouse events sent by each client per second, default = 0 (no input)", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_CHURN, ParamCommon, L"Client mode: disconnect and reconnect each client every N seconds, default = 0 (stay connected)", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_RESUME, ParamCommon, L"Client mode: resume the previous session when reconnecting (true, false), default = true", ParamConverterBoolean);
+    SetParamDescription(PARAM_NAME_REBIND, ParamCommon, L"Client mode, Linux only: move each client to a new local UDP port every N seconds to exercise connection migration, default = 0 (never)", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_RAMP_UP, ParamCommon, L"Client mode: delay between starting consecutive clients in ms, default = 100", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_PER_CLIENT_STATS, ParamCommon, L"Client mode: report statistics for every client in addition to the totals (true, false), default = true", ParamConverterBoolean);
+
+    SetParamDescription(PARAM_NAME_PROTOCOL, ParamCommon, L"Server mode: specify a transport protocol [UDP, TCP], default = UDP", nullptr);
+    SetParamDescription(PARAM_NAME_NETWORK_IMPAIRMENT, ParamCommon, L"Server mode: emulate a lossy network on outgoing UDP traffic, e.g. \"loss=1,delay=20,jitter=5\", default = none", nullptr);
+    SetParamDescription(PARAM_NAME_BIND_INTERFACE, ParamCommon, L"Server mode: IP address or interface name the server is accepting connections from, * for any", nullptr);
+    SetParamDescription(PARAM_NAME_LOCAL_SOCKET, ParamCommon, L"Server mode, Linux only: also accept same-host clients over shared memory, point clients at -server local://<name>, default = none", nullptr);
+    SetParamDescription(PARAM_NAME_SERVER_HOSTNAME, ParamCommon, L"Server mode: display name of server, default = ssdk-loadgen", nullptr);
+    SetParamDescription(PARAM_NAME_MAX_CONNECTIONS, ParamCommon, L"Server mode: maximum number of concurrent connections, default = 1000", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_RESOLUTION, ParamCommon, L"Server mode: video stream resolution, (w,h) default = 1920,1080", ParamConverterSize);
+    SetParamDescription(PARAM_NAME_FRAMERATE, ParamCommon, L"Server mode: video frame rate, default = 60", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_VIDEO_BITRATE, ParamCommon, L"Server mode: video bitrate in bits per second, default = 20000000", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_AUDIO_BITRATE, ParamCommon, L"Server mode: audio bitrate in bits per second, default = 256000", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_AUDIO_SAMPLING_RATE, ParamCommon, L"Server mode: audio sampling rate in Hz, default = 48000", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_AUDIO_CHANNELS, ParamCommon, L"Server mode: number of audio channels [1, 2], default = 2", ParamConverterInt64);
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    Terminate();
+}
+
+bool LoadGenerator::Init(int argc, const char** argv)
+{
+    bool result = false;
+    if (InitAMF() != true)
+    {
+        std::cerr << "Failed to initialize AMF runtime\n";
+    }
+    else if (parseCmdLineParameters(this, argc, const_cast<char**>(argv)) != true)
+    {
+        AMFTraceError(AMF_FACILITY, L"Failed to parse command line parameters");
+    }
+    else
+    {
+        std::wstring logFilePath = DEFAULT_LOG_FILENAME;
+        GetParamWString(PARAM_NAME_LOGFILE, logFilePath);
+        if (logFilePath != L"null")
+        {
+            if (logFilePath.length() != 0)
+            {
+                g_AMFFactory.GetTrace()->SetPath(logFilePath.c_str());
+            }
+            g_AMFFactory.GetTrace()->EnableWriter(AMF_TRACE_WRITER_FILE, true);
+        }
+        else
+        {
+            g_AMFFactory.GetTrace()->EnableWriter(AMF_TRACE_WRITER_FILE, false);
+        }
+
+        std::wstring mode = MODE_CLIENT;
+        if (GetParamWString(PARAM_NAME_MODE, mode) == AMF_OK)
+        {
+            mode = ::toUpper(mode);
+        }
+        if (mode == MODE_CLIENT)
+        {
+            m_Mode = Mode::CLIENT;
+            result = InitClients();
+        }
+        else if (mode == MODE_SERVER)
+        {
+            m_Mode = Mode::SERVER;
+            result = InitServer();
+        }
+        else
+        {
+            std::cerr << "Invalid mode, expected client or server\n";
+        }
+    }
+    return result;
+}
+
+void LoadGenerator::Terminate()
+{
+    TerminateClients();
+    TerminateServer();
+    TerminateAMF();
+}
+
+void LoadGenerator::RequestStop()
+{
+    s_StopRequested = true;
+}
+
+void LoadGenerator::Run()
+{
+    int64_t duration = 0;
+    GetParam(PARAM_NAME_DURATION, duration);
+    int64_t statsInterval = DEFAULT_STATS_INTERVAL;
+    GetParam(PARAM_NAME_STATS_INTERVAL, statsInterval);
+    amf_pts interval = std::max<int64_t>(statsInterval, 1) * AMF_SECOND;
+
+    m_StartTime = amf_high_precision_clock();
+    amf_pts lastReportTime = m_StartTime;
+    while (s_StopRequested == false && (duration == 0 || amf_high_precision_clock() - m_StartTime < duration * AMF_SECOND))
+    {
+        amf_sleep(50);
+        amf_pts now = amf_high_precision_clock();
+        if (now - lastReportTime >= interval)
+        {
+            if (m_Mode == Mode::CLIENT)
+            {
+                ReportClientStats(now - lastReportTime, false);
+            }
+            else
+            {
+                ReportServerStats(now - lastReportTime);
+            }
+            lastReportTime = now;
+        }
+    }
+    if (m_Mode == Mode::CLIENT)
+    {
+        ReportClientStats(amf_high_precision_clock() - lastReportTime, true);
+    }
+}
+
+bool LoadGenerator::InitAMF()
+{
+    bool result = false;
+    AMF_RESULT amfResult = g_AMFFactory.Init();
+    if (amfResult == AMF_OK)
+    {
+        g_AMFFactory.GetDebug()->AssertsEnable(false);
+        g_AMFFactory.GetTrace()->TraceEnableAsync(true);
+        g_AMFFactory.GetTrace()->SetGlobalLevel(AMF_TRACE_INFO);
+        g_AMFFactory.GetTrace()->SetWriterLevel(AMF_TRACE_WRITER_FILE, AMF_TRACE_INFO);
+        g_AMFFactory.GetTrace()->EnableWriter(AMF_TRACE_WRITER_CONSOLE, false);     //  Console is used for statistics
+        g_AMFFactory.GetTrace()->SetWriterLevel(AMF_TRACE_WRITER_DEBUG_OUTPUT, AMF_TRACE_WARNING);
+
+        amfResult = g_AMFFactory.GetFactory()->CreateContext(&m_Context);
+        if (m_Context == nullptr)
+        {
+            AMFTraceError(AMF_FACILITY, L"Failed to create AMFContext, result=%s", amf::AMFGetResultText(amfResult));
+        }
+        else
+        {
+            amf_increase_timer_precision();
+            m_AMFInitalized = true;
+            result = true;
+        }
+    }
+    return result;
+}
+
+void LoadGenerator::TerminateAMF()
+{
+    if (m_AMFInitalized == true)
+    {
+        amf_restore_timer_precision();
+        m_Context = nullptr;
+        g_AMFFactory.Terminate();
+        m_AMFInitalized = false;
+    }
+}
+
+bool LoadGenerator::InitClients()
+{
+    SimulatedClient::Config config;
+    GetParamString(PARAM_NAME_URL, config.m_ServerUrl);
+
+    int64_t port = DEFAULT_PORT;
+    GetParam(PARAM_NAME_PORT, port);
+    config.m_DiscoveryPort = uint16_t(port);
+
+    config.m_DatagramSize = DEFAULT_DATAGRAM_SIZE;
+    GetParam(PARAM_NAME_DATAGRAM_SIZE, config.m_DatagramSize);
+
+    bool encryption = false;
+    GetParam(PARAM_NAME_ENCRYPTION, encryption);
+    if (encryption == true && GetParamString(PARAM_NAME_PASSPHRASE, config.m_Passphrase) != AMF_OK)
+    {
+        std::cerr << "Encryption requested, but the passphrase was not provided\n";
+        return false;
+    }
+
+    GetParam(PARAM_NAME_VIDEO, config.m_SubscribeVideo);
+    GetParam(PARAM_NAME_AUDIO, config.m_SubscribeAudio);
+
+    int64_t inputRate = 0;
+    GetParam(PARAM_NAME_INPUT_RATE, inputRate);
+    config.m_InputRate = float(inputRate);
+
+    int64_t churn = 0;
+    GetParam(PARAM_NAME_CHURN, churn);
+    config.m_ChurnPeriod = churn * AMF_SECOND;
+    GetParam(PARAM_NAME_RESUME, config.m_Resume);
+    int64_t rebind = 0;
+    GetParam(PARAM_NAME_REBIND, rebind);
+    config.m_RebindPeriod = rebind * AMF_SECOND;
+
+    int64_t rampUp = DEFAULT_RAMP_UP;
+    GetParam(PARAM_NAME_RAMP_UP, rampUp);
+
+    int64_t clients = DEFAULT_CLIENTS;
+    GetParam(PARAM_NAME_CLIENTS, clients);
+    if (clients < 1)
+    {
+        std::cerr << "Number of clients must be positive\n";
+        return false;
+    }
+
+    //  Client IDs must be unique across all load generator instances connected to the same server
+    std::random_device rd;
+    char prefix[32];
+    snprintf(prefix, sizeof(prefix), "loadgen-%08x-", unsigned(rd()));
+
+    for (int64_t i = 0; i < clients; ++i)
+    {
+        char id[64];
+        snprintf(id, sizeof(id), "%s%04lld", prefix, static_cast<long long>(i));
+        config.m_ID = id;
+        config.m_StartDelay = i * rampUp * AMF_MILLISECOND;
+
+        SimulatedClient::Ptr client(new SimulatedClient(m_Context, config));
+        if (client->Start() != true)
+        {
+            AMFTraceError(AMF_FACILITY, L"Failed to start simulated client %S", id);
+            return false;
+        }
+        m_Clients.push_back(std::move(client));
+    }
+    m_LastClientStats.resize(m_Clients.size());
+    std::cout << "Started " << clients << " simulated client(s)" << std::endl;
+    return true;
+}
+
+void LoadGenerator::TerminateClients()
+{
+    for (auto& client : m_Clients)
+    {
+        client->Stop();
+    }
+    m_Clients.clear();
+    m_LastClientStats.clear();
+}
+
+bool LoadGenerator::InitServer()
+{
+    SyntheticServer::Config config;
+
+    int64_t port = DEFAULT_PORT;
+    GetParam(PARAM_NAME_PORT, port);
+    config.m_Port = uint16_t(port);
+
+    std::wstring protocol;
+    GetParamWString(PARAM_NAME_PROTOCOL, protocol);
+    if (::toUpper(protocol) == PROTOCOL_TCP)
+    {
+        config.m_NetworkType = ssdk::transport_common::ServerTransport::NETWORK_TYPE::NETWORK_TCP;
+    }
+
+    config.m_DatagramSize = DEFAULT_DATAGRAM_SIZE;
+    GetParam(PARAM_NAME_DATAGRAM_SIZE, config.m_DatagramSize);
+    GetParamString(PARAM_NAME_NETWORK_IMPAIRMENT, config.m_NetworkImpairment);
+
+    config.m_BindInterface = DEFAULT_BIND_INTERFACE;
+    GetParamString(PARAM_NAME_BIND_INTERFACE, config.m_BindInterface);
+    GetParamString(PARAM_NAME_LOCAL_SOCKET, config.m_LocalSocket);
+    config.m_HostName = DEFAULT_SERVER_HOSTNAME;
+    GetParamString(PARAM_NAME_SERVER_HOSTNAME, config.m_HostName);
+
+    bool encryption = false;
+    GetParam(PARAM_NAME_ENCRYPTION, encryption);
+    if (encryption == true && GetParamString(PARAM_NAME_PASSPHRASE, config.m_Passphrase) != AMF_OK)
+    {
+        std::cerr << "Encryption requested, but the passphrase was not provided\n";
+        return false;
+    }
+
+    config.m_MaxConnections = DEFAULT_MAX_CONNECTIONS;
+    GetParam(PARAM_NAME_MAX_CONNECTIONS, config.m_MaxConnections);
+
+    config.m_Resolution = { 1920, 1080 };
+    GetParam(PARAM_NAME_RESOLUTION, config.m_Resolution);
+
+    int64_t framerate = DEFAULT_FRAMERATE;
+    GetParam(PARAM_NAME_FRAMERATE, framerate);
+    config.m_Framerate = float(std::max<int64_t>(framerate, 1));
+
+    config.m_VideoBitrate = DEFAULT_VIDEO_BITRATE;
+    GetParam(PARAM_NAME_VIDEO_BITRATE, config.m_VideoBitrate);
+
+    int64_t audioBitrate = DEFAULT_AUDIO_BITRATE;
+    GetParam(PARAM_NAME_AUDIO_BITRATE, audioBitrate);
+    config.m_AudioBitrate = int32_t(audioBitrate);
+
+    int64_t audioSamplingRate = DEFAULT_AUDIO_SAMPLING_RATE;
+    GetParam(PARAM_NAME_AUDIO_SAMPLING_RATE, audioSamplingRate);
+    config.m_AudioSamplingRate = int32_t(audioSamplingRate);
+
+    int64_t audioChannels = DEFAULT_AUDIO_CHANNELS;
+    GetParam(PARAM_NAME_AUDIO_CHANNELS, audioChannels);
+    config.m_AudioChannels = audioChannels == 1 ? 1 : 2;
+
+    m_Server = SyntheticServer::Ptr(new SyntheticServer(m_Context));
+    if (m_Server->Start(config) != true)
+    {
+        std::cerr << "Failed to start the synthetic server\n";
+        return false;
+    }
+    std::cout << "Synthetic server listening on port " << config.m_Port << std::endl;
+    return true;
+}
+
+void LoadGenerator::TerminateServer()
+{
+    if (m_Server != nullptr)
+    {
+        m_Server->Stop();
+        m_Server = nullptr;
+    }
+}
+
+void LoadGenerator::ReportClientStats(amf_pts interval, bool final)
+{
+    bool perClient = true;
+    GetParam(PARAM_NAME_PER_CLIENT_STATS, perClient);
+
+    double seconds = double(std::max<amf_pts>(interval, 1)) / AMF_SECOND;
+    SimulatedClient::Stats total;   //  Cumulative since start
+    SimulatedClient::Stats delta;   //  Accumulated over the last reporting interval
+    int64_t connected = 0;
+    for (size_t i = 0; i < m_Clients.size(); ++i)
+    {
+        SimulatedClient::Stats stats;
+        m_Clients[i]->GetStats(stats);
+        const SimulatedClient::Stats& last = m_LastClientStats[i];
+
+        int64_t videoFrames = stats.m_VideoFrames - last.m_VideoFrames;
+        int64_t videoBytes = stats.m_VideoBytes - last.m_VideoBytes;
+        int64_t videoFramesLost = stats.m_VideoFramesLost - last.m_VideoFramesLost;
+        int64_t audioBuffers = stats.m_AudioBuffers - last.m_AudioBuffers;
+        int64_t audioBuffersLost = stats.m_AudioBuffersLost - last.m_AudioBuffersLost;
+        int64_t inputEvents = stats.m_InputEventsSent - last.m_InputEventsSent;
+        amf_pts latencySum = stats.m_LatencySum - last.m_LatencySum;
+        int64_t latencySamples = stats.m_LatencySamples - last.m_LatencySamples;
+
+        connected += stats.m_Connected == true ? 1 : 0;
+        total.m_Connections += stats.m_Connections;
+        total.m_VideoFrames += stats.m_VideoFrames;
+        total.m_VideoBytes += stats.m_VideoBytes;
+        total.m_VideoFramesLost += stats.m_VideoFramesLost;
+        total.m_AudioBuffers += stats.m_AudioBuffers;
+        total.m_AudioBuffersLost += stats.m_AudioBuffersLost;
+        total.m_InputEventsSent += stats.m_InputEventsSent;
+        total.m_LatencySum += stats.m_LatencySum;
+        total.m_LatencySamples += stats.m_LatencySamples;
+        total.m_LatencyMax = std::max(total.m_LatencyMax, stats.m_LatencyMax);
+        total.m_ResumedConnections += stats.m_ResumedConnections;
+        total.m_ColdFirstFrameSum += stats.m_ColdFirstFrameSum;
+        total.m_ColdFirstFrameSamples += stats.m_ColdFirstFrameSamples;
+        total.m_ResumedFirstFrameSum += stats.m_ResumedFirstFrameSum;
+        total.m_ResumedFirstFrameSamples += stats.m_ResumedFirstFrameSamples;
+        total.m_Rebinds += stats.m_Rebinds;
+
+        delta.m_VideoFrames += videoFrames;
+        delta.m_VideoBytes += videoBytes;
+        delta.m_VideoFramesLost += videoFramesLost;
+        delta.m_AudioBuffers += audioBuffers;
+        delta.m_AudioBuffersLost += audioBuffersLost;
+        delta.m_InputEventsSent += inputEvents;
+        delta.m_LatencySum += latencySum;
+        delta.m_LatencySamples += latencySamples;
+
+        if (perClient == true && final == false)
+        {
+            printf("  %s %-4s | video %6.1f fps %8.2f Mbps lost %lld | audio %6.1f buf/s lost %lld | input %6.1f ev/s | latency %6.2f ms\n",
+                   m_Clients[i]->GetID().c_str(), stats.m_Connected == true ? "up" : "down",
+                   double(videoFrames) / seconds, double(videoBytes) * 8 / seconds / 1000000, static_cast<long long>(videoFramesLost),
+                   double(audioBuffers) / seconds, static_cast<long long>(audioBuffersLost),
+                   double(inputEvents) / seconds,
+                   latencySamples > 0 ? double(latencySum) / latencySamples / AMF_MILLISECOND : 0.0);
+        }
+        m_LastClientStats[i] = stats;
+    }
+
+    double elapsed = double(amf_high_precision_clock() - m_StartTime) / AMF_SECOND;
+    if (final == false)
+    {
+        printf("[%8.1fs] clients %lld/%zu | video %6.1f fps %8.2f Mbps lost %lld | audio %6.1f buf/s lost %lld | input %6.1f ev/s | latency %6.2f ms, max %6.2f ms\n",
+               elapsed, static_cast<long long>(connected), m_Clients.size(),
+               double(delta.m_VideoFrames) / seconds, double(delta.m_VideoBytes) * 8 / seconds / 1000000, static_cast<long long>(delta.m_VideoFramesLost),
+               double(delta.m_AudioBuffers) / seconds, static_cast<long long>(delta.m_AudioBuffersLost),
+               double(delta.m_InputEventsSent) / seconds,
+               delta.m_LatencySamples > 0 ? double(delta.m_LatencySum) / delta.m_LatencySamples / AMF_MILLISECOND : 0.0,
+               double(total.m_LatencyMax) / AMF_MILLISECOND);
+    }
+    else
+    {
+        //  The summary covers the whole run rather than the last interval
+        elapsed = std::max(elapsed, 0.001);
+        printf("Summary after %.1fs: %lld connection(s) | video %lld frames %.2f Mbps avg lost %lld | audio %lld buffers lost %lld | input %lld events | latency avg %.2f ms, max %.2f ms\n",
+               elapsed, static_cast<long long>(total.m_Connections),
+               static_cast<long long>(total.m_VideoFrames), double(total.m_VideoBytes) * 8 / elapsed / 1000000, static_cast<long long>(total.m_VideoFramesLost),
+               static_cast<long long>(total.m_AudioBuffers), static_cast<long long>(total.m_AudioBuffersLost),
+               static_cast<long long>(total.m_InputEventsSent),
+               total.m_LatencySamples > 0 ? double(total.m_LatencySum) / total.m_LatencySamples / AMF_MILLISECOND : 0.0,
+               double(total.m_LatencyMax) / AMF_MILLISECOND);
+        printf("First video frame after connect: cold %.2f ms avg (%lld), resumed %.2f ms avg (%lld of %lld connection(s))\n",
+               total.m_ColdFirstFrameSamples > 0 ? double(total.m_ColdFirstFrameSum) / total.m_ColdFirstFrameSamples / AMF_MILLISECOND : 0.0,
+               static_cast<long long>(total.m_ColdFirstFrameSamples),
+               total.m_ResumedFirstFrameSamples > 0 ? double(total.m_ResumedFirstFrameSum) / total.m_ResumedFirstFrameSamples / AMF_MILLISECOND : 0.0,
+               static_cast<long long>(total.m_ResumedFirstFrameSamples), static_cast<long long>(total.m_ResumedConnections));
+        if (total.m_Rebinds > 0)
+        {   //  Every rebind a connection does not survive shows up as an extra connection
+            printf("Client address changes: %lld rebind(s) over %lld connection(s)\n",
+                   static_cast<long long>(total.m_Rebinds), static_cast<long long>(total.m_Connections));
+        }
+    }
+    fflush(stdout);
+}
+
+void LoadGenerator::ReportServerStats(amf_pts interval)
+{
+    double seconds = double(std::max<amf_pts>(interval, 1)) / AMF_SECOND;
+    SyntheticServer::Stats stats;
+    m_Server->GetStats(stats);
+    double elapsed = double(amf_high_precision_clock() - m_StartTime) / AMF_SECOND;
+    printf("[%8.1fs] clients %lld (video %lld, audio %lld) | generated video %6.1f fps, audio %6.1f buf/s | input %6.1f ev/s\n",
+           elapsed, static_cast<long long>(stats.m_Connections), static_cast<long long>(stats.m_VideoSubscribers), static_cast<long long>(stats.m_AudioSubscribers),
+           double(stats.m_VideoFrames - m_LastServerStats.m_VideoFrames) / seconds,
+           double(stats.m_AudioBuffers - m_LastServerStats.m_AudioBuffers) / seconds,
+           double(stats.m_InputEvents - m_LastServerStats.m_InputEvents) / seconds);
+    fflush(stdout);
+    m_LastServerStats = stats;
+}
@@ -0,0 +1,96 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "SimulatedClient.h"
+#include "SyntheticServer.h"
+
+#include "amf/public/include/core/Context.h"
+#include "amf/public/samples/CPPSamples/common/CmdLineParser.h"
+
+#include <memory>
+#include <vector>
+
+//  ssdk-loadgen: spawns a number of simulated clients in a single process to put a streaming server under load,
+//  or runs a synthetic server producing null-codec streams for the clients to connect to
+class LoadGenerator :
+    public ParametersStorage
+{
+public:
+    typedef std::unique_ptr<LoadGenerator>  Ptr;
+
+    enum class Mode
+    {
+        CLIENT,
+        SERVER
+    };
+
+public:
+    LoadGenerator();
+    virtual ~LoadGenerator();
+
+    bool Init(int argc, const char** argv);
+    void Terminate();
+
+    void Run();
+
+    static void RequestStop();
+
+protected:
+    bool InitAMF();
+    void TerminateAMF();
+
+    bool InitClients();
+    void TerminateClients();
+
+    bool InitServer();
+    void TerminateServer();
+
+    void ReportClientStats(amf_pts interval, bool final);
+    void ReportServerStats(amf_pts interval);
+
+protected:
+    bool                                    m_AMFInitalized = false;
+    amf::AMFContextPtr                      m_Context;
+    Mode                                    m_Mode = Mode::CLIENT;
+
+    std::vector<SimulatedClient::Ptr>       m_Clients;
+    std::vector<SimulatedClient::Stats>     m_LastClientStats;
+    amf_pts                                 m_StartTime = 0;
+
+    SyntheticServer::Ptr                    m_Server;
+    SyntheticServer::Stats                  m_LastServerStats;
+};
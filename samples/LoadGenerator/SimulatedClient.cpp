@@ -0,0 +1,423 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "SimulatedClient.h"
+
+#include "sdk/video/Defines.h"
+#include "sdk/video/NullVideoBitstream.h"
+#include "sdk/controllers/UserInput.h"
+
+#include "amf/public/common/TraceAdapter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"SimulatedClient";
+
+static constexpr const amf_pts RECONNECT_DELAY = AMF_SECOND;
+static constexpr const amf_uint DEFAULT_TURNAROUND_LATENCY_PERIOD = 16;
+static constexpr const char* DEFAULT_DISPLAY_MODEL = "Load Generator";
+
+SimulatedClient::SimulatedClient(amf::AMFContext* context, const Config& config) :
+    m_Context(context),
+    m_Config(config),
+    m_ServerUrl(config.m_ServerUrl),
+    m_WorkerThread(*this)
+{
+}
+
+SimulatedClient::~SimulatedClient()
+{
+    Stop();
+}
+
+bool SimulatedClient::Start()
+{
+    bool result = false;
+    m_Transport = ssdk::transport_common::ClientTransport::Ptr(new ssdk::transport_amd::ClientTransportImpl);
+
+    ssdk::transport_amd::ClientTransportImpl::ClientInitParametersAMD initParams;
+    initParams.SetContext(m_Context);
+    initParams.SetConnectionManagerCallback(this);
+    initParams.SetVideoReceiverCallback(this);
+    initParams.SetAudioReceiverCallback(this);
+    initParams.SetServerEnumCallback(this);
+    initParams.SetCursorCallback(m_Config.m_CursorCallback);
+    initParams.SetDiscoveryPort(m_Config.m_DiscoveryPort);
+    initParams.SetDatagramSize(m_Config.m_DatagramSize);
+    initParams.SetID(m_Config.m_ID);
+    if (m_Config.m_Passphrase.empty() == false)
+    {
+        initParams.SetPassphrase(m_Config.m_Passphrase);
+    }
+    initParams.SetDisplayModel(DEFAULT_DISPLAY_MODEL);
+    initParams.SetDisplayWidth(0);
+    initParams.SetDisplayHeight(0);
+    initParams.SetDisplayClientWidth(0);
+    initParams.SetDisplayClientHeight(0);
+    initParams.SetBitrate(0);
+    initParams.SetLatencyMessagePeriod(DEFAULT_TURNAROUND_LATENCY_PERIOD);
+    initParams.SetSessionResumption(m_Config.m_Resume);
+
+    if (m_Transport->Start(initParams) != ssdk::transport_common::Result::OK)
+    {
+        AMFTraceError(AMF_FACILITY, L"Client %S: failed to start the client transport", m_Config.m_ID.c_str());
+        m_Transport = nullptr;
+    }
+    else
+    {
+        result = m_WorkerThread.Start();
+    }
+    return result;
+}
+
+void SimulatedClient::Stop()
+{
+    m_WorkerThread.RequestStop();
+    m_WorkerThread.WaitForStop();
+    if (m_Transport != nullptr)
+    {
+        m_Transport->Shutdown();
+        m_Transport = nullptr;
+    }
+}
+
+void SimulatedClient::GetStats(Stats& stats) const
+{
+    amf::AMFLock lock(&m_Guard);
+    stats = m_Stats;
+}
+
+bool SimulatedClient::Connect()
+{
+    ssdk::transport_common::Result result = ssdk::transport_common::Result::OK;
+    if (m_ServerUrl.empty() == true)
+    {
+        result = m_Transport->FindServers();    //  m_ServerUrl is populated in OnServerDiscovered()
+        if (result != ssdk::transport_common::Result::OK || m_ServerUrl.empty() == true)
+        {
+            AMFTraceWarning(AMF_FACILITY, L"Client %S: server discovery did not succeed", m_Config.m_ID.c_str());
+            return false;
+        }
+    }
+
+    ResetStreamState();
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_ConnectStartTime = amf_high_precision_clock();
+    }
+    result = m_Transport->Connect(m_ServerUrl.c_str());
+    if (result != ssdk::transport_common::Result::OK)
+    {
+        AMFTraceWarning(AMF_FACILITY, L"Client %S: failed to connect to server %S, result = %d", m_Config.m_ID.c_str(), m_ServerUrl.c_str(), result);
+        amf::AMFLock lock(&m_Guard);
+        m_ConnectStartTime = -1;
+        return false;
+    }
+
+    const ssdk::transport_amd::ClientTransportImpl* transport = static_cast<const ssdk::transport_amd::ClientTransportImpl*>(m_Transport.get());
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_Stats.m_Connected = true;
+        ++m_Stats.m_Connections;
+        m_ConnectResumed = transport->IsResumed();
+        m_Stats.m_ResumedConnections += m_ConnectResumed == true ? 1 : 0;
+    }
+
+    if (m_Config.m_SubscribeAudio == true && (result = m_Transport->SubscribeToAudioStream()) != ssdk::transport_common::Result::OK)
+    {
+        AMFTraceError(AMF_FACILITY, L"Client %S: failed to subscribe to audio stream, result = %d", m_Config.m_ID.c_str(), result);
+    }
+    if (m_Config.m_SubscribeVideo == true && (result = m_Transport->SubscribeToVideoStream()) != ssdk::transport_common::Result::OK)
+    {
+        AMFTraceError(AMF_FACILITY, L"Client %S: failed to subscribe to video stream, result = %d", m_Config.m_ID.c_str(), result);
+    }
+    AMFTraceDebug(AMF_FACILITY, L"Client %S: connected to %S", m_Config.m_ID.c_str(), m_ServerUrl.c_str());
+    return true;
+}
+
+void SimulatedClient::Disconnect()
+{
+    m_Transport->Disconnect();
+    amf::AMFLock lock(&m_Guard);
+    m_Stats.m_Connected = false;
+}
+
+void SimulatedClient::Rebind()
+{
+    ssdk::transport_amd::ClientTransportImpl* transport = static_cast<ssdk::transport_amd::ClientTransportImpl*>(m_Transport.get());
+    ssdk::transport_common::Result result = transport->RebindSocket();
+    if (result != ssdk::transport_common::Result::OK)
+    {
+        AMFTraceWarning(AMF_FACILITY, L"Client %S: failed to rebind the socket, result = %d", m_Config.m_ID.c_str(), result);
+        return;
+    }
+    amf::AMFLock lock(&m_Guard);
+    ++m_Stats.m_Rebinds;
+}
+
+void SimulatedClient::ResetStreamState()
+{
+    //  Sequence numbers restart from scratch on every new connection and every codec reinitialization
+    amf::AMFLock lock(&m_Guard);
+    m_LastVideoSequenceNumber = -1;
+    m_LastAudioSequenceNumber = -1;
+}
+
+void SimulatedClient::SendInput()
+{
+    //  Move the mouse pointer in a small circle around the center of the screen, the same event a real client sends on every mouse move
+    static constexpr const int64_t EVENTS_PER_REVOLUTION = 120;
+    static constexpr const float RADIUS = 0.1f;
+    float angle = float(m_InputEventCnt++ % EVENTS_PER_REVOLUTION) * 2.0f * 3.14159265f / float(EVENTS_PER_REVOLUTION);
+    amf::AMFVariant event(AMFConstructFloatPoint2D(0.5f + RADIUS * std::cos(angle), 0.5f + RADIUS * std::sin(angle)));
+
+    std::string controlID = std::string(ssdk::ctls::DEVICE_MOUSE) + ssdk::ctls::DEVICE_MOUSE_POS;
+    if (m_Transport->SendControllerEvent(controlID.c_str(), event) == ssdk::transport_common::Result::OK)
+    {
+        amf::AMFLock lock(&m_Guard);
+        ++m_Stats.m_InputEventsSent;
+    }
+}
+
+//  VideoReceiverCallback methods
+bool SimulatedClient::OnVideoInit(const char* codec, ssdk::transport_common::StreamID streamID, int64_t initID,
+                                  const AMFSize& streamResolution, const AMFRect& /*viewport*/, uint32_t bitDepth,
+                                  bool /*stereoscopic*/, bool /*foveated*/, const void* /*initBlock*/, size_t /*initBlockSize*/)
+{
+    AMFTraceDebug(AMF_FACILITY, L"Client %S: video init for stream %lld, init ID %lld, codec %S, %dx%d, %u bit", m_Config.m_ID.c_str(), streamID, initID, codec, streamResolution.width, streamResolution.height, bitDepth);
+    amf::AMFLock lock(&m_Guard);
+    m_NullVideo = codec != nullptr && strcmp(codec, ssdk::video::CODEC_NULL) == 0;
+    m_LastVideoSequenceNumber = -1;
+    return true;    //  Nothing is decoded, so any codec is acceptable
+}
+
+void SimulatedClient::OnVideoFrame(ssdk::transport_common::StreamID /*streamID*/, const ssdk::transport_common::ReceivableVideoFrame& frame)
+{
+    amf_pts now = amf_high_precision_clock();
+    int64_t frameSize = 0;
+    amf_pts encodeTime = -1;
+    for (size_t i = 0; i < frame.GetSubframeCount(); ++i)
+    {
+        amf::AMFBufferPtr subframe;
+        if (frame.GetSubframeBuffer(i, &subframe) == AMF_OK && subframe != nullptr)
+        {
+            frameSize += subframe->GetSize();
+            if (i == 0 && subframe->GetSize() >= sizeof(ssdk::video::NullVideoSliceHeader))
+            {
+                const ssdk::video::NullVideoSliceHeader* header = static_cast<const ssdk::video::NullVideoSliceHeader*>(subframe->GetNative());
+                if (header->m_Magic == ssdk::video::NULL_VIDEO_SLICE_MAGIC)
+                {
+                    encodeTime = header->m_EncodeTime;
+                }
+            }
+        }
+    }
+
+    amf::AMFLock lock(&m_Guard);
+    ++m_Stats.m_VideoFrames;
+    m_Stats.m_VideoBytes += frameSize;
+    if (m_ConnectStartTime >= 0)
+    {   //  Resumed sessions skip the START round trip and the codec initialization, compare how soon the picture comes back
+        if (m_ConnectResumed == true)
+        {
+            m_Stats.m_ResumedFirstFrameSum += now - m_ConnectStartTime;
+            ++m_Stats.m_ResumedFirstFrameSamples;
+        }
+        else
+        {
+            m_Stats.m_ColdFirstFrameSum += now - m_ConnectStartTime;
+            ++m_Stats.m_ColdFirstFrameSamples;
+        }
+        m_ConnectStartTime = -1;
+    }
+    int64_t sequenceNumber = frame.GetSequenceNumber();
+    if (m_LastVideoSequenceNumber >= 0 && sequenceNumber > m_LastVideoSequenceNumber + 1)
+    {
+        m_Stats.m_VideoFramesLost += sequenceNumber - m_LastVideoSequenceNumber - 1;
+    }
+    m_LastVideoSequenceNumber = sequenceNumber;
+
+    //  The null encoder stamps every frame with the time it was produced. This is only meaningful when the server runs on the same host
+    if (m_NullVideo == true && encodeTime >= 0 && now >= encodeTime)
+    {
+        amf_pts latency = now - encodeTime;
+        m_Stats.m_LatencySum += latency;
+        m_Stats.m_LatencyMax = std::max(m_Stats.m_LatencyMax, latency);
+        ++m_Stats.m_LatencySamples;
+    }
+}
+
+void SimulatedClient::OnVideoServerStats(ssdk::transport_common::StreamID /*streamID*/, amf::AMFPropertyStorage* /*stats*/)
+{
+}
+
+//  AudioReceiverCallback methods
+bool SimulatedClient::OnAudioInit(const char* codec, ssdk::transport_common::StreamID streamID, int64_t initID,
+                                  uint32_t channels, uint32_t /*layout*/, uint32_t samplingRate, amf::AMF_AUDIO_FORMAT /*format*/,
+                                  const void* /*initBlock*/, size_t /*initBlockSize*/)
+{
+    AMFTraceDebug(AMF_FACILITY, L"Client %S: audio init for stream %lld, init ID %lld, codec %S, %u channels, %uHz", m_Config.m_ID.c_str(), streamID, initID, codec, channels, samplingRate);
+    amf::AMFLock lock(&m_Guard);
+    m_LastAudioSequenceNumber = -1;
+    return true;
+}
+
+void SimulatedClient::OnAudioBuffer(ssdk::transport_common::StreamID /*streamID*/, const ssdk::transport_common::ReceivableAudioBuffer& buffer)
+{
+    amf::AMFBufferPtr buf;
+    const_cast<ssdk::transport_common::ReceivableAudioBuffer&>(buffer).GetBuffer(&buf);
+
+    amf::AMFLock lock(&m_Guard);
+    ++m_Stats.m_AudioBuffers;
+    m_Stats.m_AudioBytes += buf != nullptr ? buf->GetSize() : 0;
+    int64_t sequenceNumber = buffer.GetSequenceNumber();
+    if (m_LastAudioSequenceNumber >= 0 && sequenceNumber > m_LastAudioSequenceNumber + 1)
+    {
+        m_Stats.m_AudioBuffersLost += sequenceNumber - m_LastAudioSequenceNumber - 1;
+    }
+    m_LastAudioSequenceNumber = sequenceNumber;
+}
+
+//  ConnectionManagerCallback methods
+ssdk::transport_common::ClientTransport::ConnectionManagerCallback::DiscoveryAction SimulatedClient::OnServerDiscovered(const ssdk::transport_common::ClientTransport::ServerDescriptor& /*server*/)
+{
+    return ssdk::transport_common::ClientTransport::ConnectionManagerCallback::DiscoveryAction::STOP;
+}
+
+void SimulatedClient::OnDiscoveryComplete()
+{
+}
+
+void SimulatedClient::OnConnectionEstablished(const ssdk::transport_common::ClientTransport::ServerDescriptor& /*server*/)
+{
+}
+
+void SimulatedClient::OnConnectionTerminated(TerminationReason reason)
+{
+    AMFTraceDebug(AMF_FACILITY, L"Client %S: connection terminated, reason %d", m_Config.m_ID.c_str(), static_cast<int>(reason));
+    amf::AMFLock lock(&m_Guard);
+    m_Stats.m_Connected = false;    //  The worker thread will reconnect
+}
+
+//  ServerEnumCallback methods
+ssdk::transport_amd::ServerEnumCallback::DiscoveryCtrl SimulatedClient::OnServerDiscovered(ssdk::transport_amd::ServerParameters* server)
+{
+    m_ServerUrl = server->GetUrl();
+    AMFTraceDebug(AMF_FACILITY, L"Client %S: server discovered: %S", m_Config.m_ID.c_str(), m_ServerUrl.c_str());
+    return ssdk::transport_amd::ServerEnumCallback::DiscoveryCtrl::ABORT;
+}
+
+ssdk::transport_amd::ServerEnumCallback::DiscoveryCtrl SimulatedClient::OnConnectionRefused()
+{
+    return ssdk::transport_amd::ServerEnumCallback::DiscoveryCtrl::CONTINUE;
+}
+
+SimulatedClient::WorkerThread::WorkerThread(SimulatedClient& client) :
+    m_Client(client)
+{
+}
+
+void SimulatedClient::WorkerThread::Run()
+{
+    const SimulatedClient::Config& config = m_Client.m_Config;
+    amf_pts startTime = amf_high_precision_clock();
+    while (StopRequested() == false && amf_high_precision_clock() - startTime < config.m_StartDelay)
+    {
+        amf_sleep(10);  //  Stagger connection attempts so that a large number of clients do not hit the server all at once
+    }
+
+    amf_pts inputPeriod = config.m_InputRate > 0 ? amf_pts(AMF_SECOND / config.m_InputRate) : 0;
+    amf_pts connectTime = 0;
+    amf_pts nextInputTime = 0;
+    amf_pts nextRebindTime = 0;
+    while (StopRequested() == false)
+    {
+        bool connected = false;
+        {
+            amf::AMFLock lock(&m_Client.m_Guard);
+            connected = m_Client.m_Stats.m_Connected;
+        }
+
+        amf_pts now = amf_high_precision_clock();
+        if (connected == false)
+        {
+            if (m_Client.Connect() == true)
+            {
+                connectTime = nextInputTime = amf_high_precision_clock();
+                nextRebindTime = connectTime + config.m_RebindPeriod;
+            }
+            else
+            {
+                amf_sleep(amf_uint32(RECONNECT_DELAY / AMF_MILLISECOND));
+            }
+        }
+        else if (config.m_ChurnPeriod > 0 && now - connectTime >= config.m_ChurnPeriod)
+        {
+            AMFTraceDebug(AMF_FACILITY, L"Client %S: disconnecting to simulate churn", config.m_ID.c_str());
+            m_Client.Disconnect();
+        }
+        else
+        {
+            if (config.m_RebindPeriod > 0 && now >= nextRebindTime)
+            {
+                AMFTraceDebug(AMF_FACILITY, L"Client %S: rebinding the socket to simulate a client address change", config.m_ID.c_str());
+                m_Client.Rebind();
+                nextRebindTime = now + config.m_RebindPeriod;
+            }
+            if (inputPeriod > 0 && now >= nextInputTime)
+            {
+                m_Client.SendInput();
+                nextInputTime += inputPeriod;
+                if (nextInputTime < now - AMF_SECOND)
+                {
+                    nextInputTime = now;    //  Do not try to catch up after a stall, that would produce an unrealistic burst of input
+                }
+            }
+            amf_sleep(1);
+        }
+    }
+
+    bool connected = false;
+    {
+        amf::AMFLock lock(&m_Client.m_Guard);
+        connected = m_Client.m_Stats.m_Connected;
+    }
+    if (connected == true)
+    {
+        m_Client.Disconnect();
+    }
+}
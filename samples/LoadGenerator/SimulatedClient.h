@@ -0,0 +1,165 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "sdk/transports/transport-amd/ClientTransportImpl.h"
+
+#include "amf/public/include/core/Context.h"
+#include "amf/public/common/Thread.h"
+
+#include <memory>
+#include <string>
+
+//  SimulatedClient emulates a single streaming client: it connects to a server, subscribes to its video and/or audio streams
+//  and accounts for everything it receives without decoding it. Optionally it sends synthetic input events at a fixed rate
+//  and periodically drops and re-establishes its connection to exercise the server's session setup and teardown paths.
+class SimulatedClient :
+    public ssdk::transport_common::ClientTransport::VideoReceiverCallback,
+    public ssdk::transport_common::ClientTransport::AudioReceiverCallback,
+    public ssdk::transport_common::ClientTransport::ConnectionManagerCallback,
+    public ssdk::transport_amd::ServerEnumCallback
+{
+public:
+    typedef std::unique_ptr<SimulatedClient>    Ptr;
+
+    struct Config
+    {
+        std::string     m_ID;
+        std::string     m_ServerUrl;                //  Server is discovered when empty
+        uint16_t        m_DiscoveryPort = 0;
+        int64_t         m_DatagramSize = 0;
+        std::string     m_Passphrase;               //  Encryption is disabled when empty
+        bool            m_SubscribeVideo = true;
+        bool            m_SubscribeAudio = true;
+        float           m_InputRate = 0;            //  Input events per second, 0 - no input
+        amf_pts         m_ChurnPeriod = 0;          //  Reconnect every m_ChurnPeriod (in 100ns units), 0 - stay connected
+        amf_pts         m_StartDelay = 0;           //  Delay before the first connection attempt (in 100ns units)
+        bool            m_Resume = true;            //  Present the resumption ticket from the previous connection when reconnecting
+        amf_pts         m_RebindPeriod = 0;         //  Move to a new local port every m_RebindPeriod (in 100ns units) to simulate NAT rebinding, 0 - never
+        ssdk::transport_common::ClientTransport::CursorCallback*   m_CursorCallback = nullptr;     //  Receives the server's cursor, cursors are not requested when nullptr
+    };
+
+    //  All counters are cumulative since the client was started
+    struct Stats
+    {
+        bool            m_Connected = false;
+        int64_t         m_Connections = 0;
+        int64_t         m_VideoFrames = 0;
+        int64_t         m_VideoBytes = 0;
+        int64_t         m_VideoFramesLost = 0;
+        int64_t         m_AudioBuffers = 0;
+        int64_t         m_AudioBytes = 0;
+        int64_t         m_AudioBuffersLost = 0;
+        int64_t         m_InputEventsSent = 0;
+        amf_pts         m_LatencySum = 0;           //  Encoder-to-receiver latency, only available for the null video codec
+        amf_pts         m_LatencyMax = 0;
+        int64_t         m_LatencySamples = 0;
+        int64_t         m_ResumedConnections = 0;
+        amf_pts         m_ColdFirstFrameSum = 0;    //  Time from the start of Connect() to the first video frame
+        int64_t         m_ColdFirstFrameSamples = 0;
+        amf_pts         m_ResumedFirstFrameSum = 0;
+        int64_t         m_ResumedFirstFrameSamples = 0;
+        int64_t         m_Rebinds = 0;              //  Local port changes the connection was expected to survive
+    };
+
+public:
+    SimulatedClient(amf::AMFContext* context, const Config& config);
+    virtual ~SimulatedClient();
+
+    bool Start();
+    void Stop();
+
+    inline const std::string& GetID() const noexcept { return m_Config.m_ID; }
+    void GetStats(Stats& stats) const;
+
+    //  ssdk::transport_common::ClientTransport::VideoReceiverCallback methods:
+    virtual bool OnVideoInit(const char* codec, ssdk::transport_common::StreamID streamID, int64_t initID,
+                             const AMFSize& streamResolution, const AMFRect& viewport, uint32_t bitDepth,
+                             bool stereoscopic, bool foveated, const void* initBlock, size_t initBlockSize) override;
+    virtual void OnVideoFrame(ssdk::transport_common::StreamID streamID, const ssdk::transport_common::ReceivableVideoFrame& frame) override;
+    virtual void OnVideoServerStats(ssdk::transport_common::StreamID streamID, amf::AMFPropertyStorage* stats) override;
+
+    //  ssdk::transport_common::ClientTransport::AudioReceiverCallback methods:
+    virtual bool OnAudioInit(const char* codec, ssdk::transport_common::StreamID streamID, int64_t initID,
+                             uint32_t channels, uint32_t layout, uint32_t samplingRate, amf::AMF_AUDIO_FORMAT format,
+                             const void* initBlock, size_t initBlockSize) override;
+    virtual void OnAudioBuffer(ssdk::transport_common::StreamID streamID, const ssdk::transport_common::ReceivableAudioBuffer& buffer) override;
+
+    //  ssdk::transport_common::ClientTransport::ConnectionManagerCallback methods:
+    virtual DiscoveryAction OnServerDiscovered(const ssdk::transport_common::ClientTransport::ServerDescriptor& server) override;
+    virtual void OnDiscoveryComplete() override;
+    virtual void OnConnectionEstablished(const ssdk::transport_common::ClientTransport::ServerDescriptor& server) override;
+    virtual void OnConnectionTerminated(TerminationReason reason) override;
+
+    //  ssdk::transport_amd::ServerEnumCallback methods:
+    virtual ssdk::transport_amd::ServerEnumCallback::DiscoveryCtrl AMF_STD_CALL OnServerDiscovered(ssdk::transport_amd::ServerParameters* server) override;
+    virtual ssdk::transport_amd::ServerEnumCallback::DiscoveryCtrl AMF_STD_CALL OnConnectionRefused() override;
+
+protected:
+    bool Connect();
+    void Disconnect();
+    void SendInput();
+    void Rebind();
+    void ResetStreamState();
+
+    class WorkerThread : public amf::AMFThread
+    {
+    public:
+        WorkerThread(SimulatedClient& client);
+
+        virtual void Run() override;
+
+    private:
+        SimulatedClient& m_Client;
+    };
+
+protected:
+    mutable amf::AMFCriticalSection                 m_Guard;
+    amf::AMFContextPtr                              m_Context;
+    Config                                          m_Config;
+    std::string                                     m_ServerUrl;
+
+    ssdk::transport_common::ClientTransport::Ptr    m_Transport;
+    WorkerThread                                    m_WorkerThread;
+
+    Stats                                           m_Stats;
+    bool                                            m_NullVideo = false;
+    int64_t                                         m_LastVideoSequenceNumber = -1;
+    int64_t                                         m_LastAudioSequenceNumber = -1;
+    int64_t                                         m_InputEventCnt = 0;
+    amf_pts                                         m_ConnectStartTime = -1;    //  -1 once the first frame of the connection was received
+    bool                                            m_ConnectResumed = false;
+};
@@ -0,0 +1,459 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "SyntheticServer.h"
+
+#include "sdk/video/encoders/NullVideoEncodeEngine.h"
+#include "sdk/audio/encoders/NullAudioEncodeEngine.h"
+#include "sdk/transports/transport-amd/ServerTransportImpl.h"
+
+#include "amf/public/common/TraceAdapter.h"
+
+#include <sstream>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"SyntheticServer";
+
+static constexpr const int32_t AUDIO_BUFFERS_PER_SECOND = 100;  //  10ms worth of samples per buffer, similar to what audio capture delivers
+
+SyntheticServer::SyntheticServer(amf::AMFContext* context) :
+    m_Context(context),
+    m_VideoSourceThread(*this),
+    m_AudioSourceThread(*this)
+{
+}
+
+SyntheticServer::~SyntheticServer()
+{
+    Stop();
+}
+
+bool SyntheticServer::Start(const Config& config)
+{
+    m_Config = config;
+
+    ssdk::transport_common::VideoStreamDescriptor videoStreamDescriptor;
+    ssdk::transport_common::AudioStreamDescriptor audioStreamDescriptor;
+
+    m_VideoEncoder = ssdk::video::VideoEncodeEngine::Ptr(new ssdk::video::NullVideoEncodeEngine(m_Context));
+    videoStreamDescriptor.SetCodec(m_VideoEncoder->GetCodecName());
+    videoStreamDescriptor.SetResolution(config.m_Resolution);
+    videoStreamDescriptor.SetFramerate(config.m_Framerate);
+    videoStreamDescriptor.SetBitrate(static_cast<int32_t>(config.m_VideoBitrate));
+    videoStreamDescriptor.SetColorDepth(ssdk::transport_common::VideoStreamDescriptor::ColorDepth::SDR_8);
+    std::stringstream videoDesc;
+    videoDesc << "Synthetic (" << config.m_Resolution.width << 'x' << config.m_Resolution.height << '@' << config.m_Framerate << "Hz, SDR)";
+    videoStreamDescriptor.SetDescription(videoDesc.str());
+
+    m_AudioEncoder = ssdk::audio::AudioEncodeEngine::Ptr(new ssdk::audio::NullAudioEncodeEngine(m_Context));
+    audioStreamDescriptor.SetCodec(m_AudioEncoder->GetCodecName());
+    audioStreamDescriptor.SetBitrate(config.m_AudioBitrate);
+    audioStreamDescriptor.SetSamplingRate(config.m_AudioSamplingRate);
+    audioStreamDescriptor.SetNumOfChannels(config.m_AudioChannels);
+    std::stringstream audioDesc;
+    audioDesc << "Synthetic, " << m_AudioEncoder->GetCodecName() << ", " << config.m_AudioBitrate << "bps";
+    audioStreamDescriptor.SetDescription(audioDesc.str());
+
+    m_Transport = ssdk::transport_common::ServerTransport::Ptr(new ssdk::transport_amd::ServerTransportImpl);
+    ssdk::transport_amd::ServerTransportImpl::ServerInitParametersAmd initParams;
+    initParams.SetContext(m_Context);
+    initParams.SetPort(config.m_Port);
+    initParams.SetNetworkType(config.m_NetworkType);
+    initParams.SetNetwork(true);
+    initParams.SetDatagramSize(config.m_DatagramSize);
+    initParams.SetNetworkImpairment(config.m_NetworkImpairment);
+    initParams.SetBindInterface(config.m_BindInterface);
+    initParams.SetLocalSocketPath(config.m_LocalSocket);
+    initParams.SetHostName(config.m_HostName);
+    if (config.m_Passphrase.empty() == false)
+    {
+        initParams.SetPassphrase(config.m_Passphrase);
+    }
+    initParams.AddVideoStream(videoStreamDescriptor);
+    initParams.AddAudioStream(audioStreamDescriptor);
+
+    initParams.SetCallback(static_cast<ssdk::transport_common::ServerTransport::ConnectionManagerCallback*>(this));
+    initParams.SetCallback(static_cast<ssdk::transport_common::ServerTransport::VideoSenderCallback*>(this));
+    initParams.SetCallback(static_cast<ssdk::transport_common::ServerTransport::AudioSenderCallback*>(this));
+    initParams.SetCallback(static_cast<ssdk::transport_common::ServerTransport::InputControllerCallback*>(this));
+
+    bool result = false;
+    if (InitPipelines(config) != true)
+    {
+        AMFTraceError(AMF_FACILITY, L"Failed to initialize video and audio pipelines");
+    }
+    else if (m_Transport->Start(initParams) != ssdk::transport_common::Result::OK)
+    {
+        AMFTraceError(AMF_FACILITY, L"Cannot initialize the network stack: failed to start server");
+    }
+    else
+    {
+        //  Frames are generated continuously regardless of the number of subscribers, so that the server-side encoding cost stays constant
+        //  and the measurements only reflect the cost of fanning the streams out to clients
+        m_VideoSourceThread.Start();
+        m_AudioSourceThread.Start();
+        AMFTraceInfo(AMF_FACILITY, L"Synthetic server started on port %d", int(config.m_Port));
+        result = true;
+    }
+    return result;
+}
+
+bool SyntheticServer::InitPipelines(const Config& config)
+{
+    m_VideoTransmitterAdapter = ssdk::video::TransmitterAdapter::Ptr(new ssdk::video::TransmitterAdapter(m_Transport, ssdk::transport_common::DEFAULT_STREAM, nullptr));
+    m_VideoOutput = ssdk::video::MonoscopicVideoOutput::Ptr(new ssdk::video::MonoscopicVideoOutput(*m_VideoTransmitterAdapter, m_VideoEncoder, m_Context, amf::AMF_MEMORY_HOST));
+
+    m_AudioTransmitterAdapter = ssdk::audio::TransmitterAdapter::Ptr(new ssdk::audio::TransmitterAdapter(m_Transport, ssdk::transport_common::DEFAULT_STREAM));
+    m_AudioOutput = ssdk::audio::AudioOutput::Ptr(new ssdk::audio::AudioOutput(*m_AudioTransmitterAdapter, m_AudioEncoder, m_Context));
+
+    //  Generated frames already match the encoded resolution and the encoder's preferred format, so no converter is inserted into either pipeline
+    AMF_RESULT amfResult = m_VideoOutput->Init(m_VideoEncoder->GetPreferredSDRFormat(), config.m_Resolution, config.m_Resolution, config.m_VideoBitrate, config.m_Framerate, false);
+    if (amfResult != AMF_OK)
+    {
+        AMFTraceError(AMF_FACILITY, L"Failed to initialize video output, result=%s", amf::AMFGetResultText(amfResult));
+        return false;
+    }
+
+    int32_t layout = config.m_AudioChannels == 1 ? int32_t(amf::AMFACL_SPEAKER_FRONT_CENTER) : int32_t(amf::AMFACL_SPEAKER_FRONT_LEFT | amf::AMFACL_SPEAKER_FRONT_RIGHT);
+    amfResult = m_AudioOutput->Init(amf::AMFAF_S16, config.m_AudioSamplingRate, config.m_AudioChannels, layout,
+                                    config.m_AudioSamplingRate, config.m_AudioChannels, layout, config.m_AudioBitrate);
+    if (amfResult != AMF_OK)
+    {
+        AMFTraceError(AMF_FACILITY, L"Failed to initialize audio output, result=%s", amf::AMFGetResultText(amfResult));
+        return false;
+    }
+    return true;
+}
+
+void SyntheticServer::Stop()
+{
+    m_VideoSourceThread.RequestStop();
+    m_VideoSourceThread.WaitForStop();
+    m_AudioSourceThread.RequestStop();
+    m_AudioSourceThread.WaitForStop();
+
+    if (m_Transport != nullptr)
+    {
+        m_Transport->Shutdown();
+    }
+    if (m_VideoOutput != nullptr)
+    {
+        m_VideoOutput->Terminate();
+        m_VideoOutput = nullptr;
+    }
+    m_VideoTransmitterAdapter = nullptr;
+    if (m_AudioOutput != nullptr)
+    {
+        m_AudioOutput->Terminate();
+        m_AudioOutput = nullptr;
+    }
+    m_AudioTransmitterAdapter = nullptr;
+    m_VideoEncoder = nullptr;
+    m_AudioEncoder = nullptr;
+    m_Transport = nullptr;
+}
+
+void SyntheticServer::GetStats(Stats& stats) const
+{
+    amf::AMFLock lock(&m_Guard);
+    stats = m_Stats;
+    stats.m_VideoSubscribers = static_cast<int64_t>(m_SessionsVideo.size());
+    stats.m_AudioSubscribers = static_cast<int64_t>(m_SessionsAudio.size());
+}
+
+void SyntheticServer::GenerateVideo()
+{
+    amf_pts frameDuration = amf_pts(AMF_SECOND / m_Config.m_Framerate);
+    amf_pts now = amf_high_precision_clock();
+
+    amf::AMFSurfacePtr frame;
+    AMF_RESULT result = m_Context->AllocSurface(amf::AMF_MEMORY_HOST, m_VideoEncoder->GetPreferredSDRFormat(), m_Config.m_Resolution.width, m_Config.m_Resolution.height, &frame);
+    if (result != AMF_OK)
+    {
+        AMFTraceError(AMF_FACILITY, L"Failed to allocate a video frame, result=%s", amf::AMFGetResultText(result));
+    }
+    else
+    {
+        frame->SetPts(now);
+        frame->SetDuration(frameDuration);
+        if (m_VideoOutput->SubmitInput(frame, 0, now) == AMF_OK)
+        {
+            amf::AMFLock lock(&m_Guard);
+            ++m_Stats.m_VideoFrames;
+        }
+    }
+
+    amf_pts elapsed = amf_high_precision_clock() - now;
+    if (elapsed < frameDuration)
+    {
+        amf_sleep(amf_uint32((frameDuration - elapsed) / AMF_MILLISECOND));
+    }
+}
+
+void SyntheticServer::GenerateAudio()
+{
+    amf_pts bufferDuration = AMF_SECOND / AUDIO_BUFFERS_PER_SECOND;
+    amf_pts now = amf_high_precision_clock();
+
+    amf::AMFAudioBufferPtr buffer;
+    AMF_RESULT result = m_Context->AllocAudioBuffer(amf::AMF_MEMORY_HOST, amf::AMFAF_S16, m_Config.m_AudioSamplingRate / AUDIO_BUFFERS_PER_SECOND, m_Config.m_AudioSamplingRate, m_Config.m_AudioChannels, &buffer);
+    if (result != AMF_OK)
+    {
+        AMFTraceError(AMF_FACILITY, L"Failed to allocate an audio buffer, result=%s", amf::AMFGetResultText(result));
+    }
+    else
+    {
+        memset(buffer->GetNative(), 0, buffer->GetSize());
+        buffer->SetPts(now);
+        buffer->SetDuration(bufferDuration);
+        if (m_AudioOutput->SubmitInput(buffer) == AMF_OK)
+        {
+            amf::AMFLock lock(&m_Guard);
+            ++m_Stats.m_AudioBuffers;
+        }
+    }
+
+    amf_pts elapsed = amf_high_precision_clock() - now;
+    if (elapsed < bufferDuration)
+    {
+        amf_sleep(amf_uint32((bufferDuration - elapsed) / AMF_MILLISECOND));
+    }
+}
+
+//  ConnectionManagerCallback methods
+ssdk::transport_common::ServerTransport::ConnectionManagerCallback::ClientAction SyntheticServer::OnDiscoveryRequest(const char* /*clientID*/)
+{
+    amf::AMFLock lock(&m_Guard);
+    return m_Stats.m_Connections < m_Config.m_MaxConnections ? ClientAction::ACCEPT : ClientAction::REFUSE;
+}
+
+ssdk::transport_common::ServerTransport::ConnectionManagerCallback::ClientAction SyntheticServer::OnConnectionRequest(ssdk::transport_common::SessionHandle session, const char* clientID, ClientRole /*role*/)
+{
+    ClientAction action = ClientAction::REFUSE;
+    amf::AMFLock lock(&m_Guard);
+    if (m_Stats.m_Connections < m_Config.m_MaxConnections)
+    {
+        ++m_Stats.m_Connections;
+        action = ClientAction::ACCEPT;
+        AMFTraceDebug(AMF_FACILITY, L"Accepted a connection request from client \"%S\", session ID: %lld", clientID, session);
+    }
+    else
+    {
+        AMFTraceWarning(AMF_FACILITY, L"Rejected a connection request from client \"%S\", session ID: %lld because the number of concurrent connections of %lld has been exceeded", clientID, session, m_Config.m_MaxConnections);
+    }
+    return action;
+}
+
+void SyntheticServer::OnClientSubscribed(ssdk::transport_common::SessionHandle /*session*/)
+{
+}
+
+void SyntheticServer::OnClientDisconnected(ssdk::transport_common::SessionHandle session, DisconnectReason reason)
+{
+    amf::AMFLock lock(&m_Guard);
+    if (m_Stats.m_Connections > 0)
+    {
+        --m_Stats.m_Connections;
+    }
+    m_SessionsVideo.erase(session);
+    m_SessionsAudio.erase(session);
+    if (m_VideoTransmitterAdapter != nullptr)
+    {
+        m_VideoTransmitterAdapter->UnregisterSession(session);
+    }
+    if (m_AudioTransmitterAdapter != nullptr)
+    {
+        m_AudioTransmitterAdapter->UnregisterSession(session);
+    }
+    AMFTraceDebug(AMF_FACILITY, L"Client with session ID: %lld %s, remaining clients: %lld", session, reason == DisconnectReason::CLIENT_DISCONNECTED ? L"disconnected" : L"timed out", m_Stats.m_Connections);
+}
+
+//  VideoSenderCallback methods
+void SyntheticServer::OnVideoStreamSubscribed(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID)
+{
+    amf::AMFLock lock(&m_Guard);
+    if (streamID != ssdk::transport_common::DEFAULT_STREAM || m_VideoTransmitterAdapter == nullptr)
+    {
+        AMFTraceWarning(AMF_FACILITY, L"Client session %lld is trying to subscribe to an invalid video stream %lld, request ignored", session, streamID);
+    }
+    else if (m_VideoTransmitterAdapter->RegisterSession(session) == true)
+    {
+        m_SessionsVideo.emplace(session);
+        m_VideoTransmitterAdapter->SendInitToSession(session);
+    }
+}
+
+void SyntheticServer::OnVideoStreamUnsubscribed(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID)
+{
+    amf::AMFLock lock(&m_Guard);
+    if (streamID == ssdk::transport_common::DEFAULT_STREAM && m_VideoTransmitterAdapter != nullptr)
+    {
+        m_VideoTransmitterAdapter->UnregisterSession(session);
+        m_SessionsVideo.erase(session);
+    }
+}
+
+void SyntheticServer::OnReadyToReceiveVideo(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID, ssdk::transport_common::InitID initID)
+{
+    amf::AMFLock lock(&m_Guard);
+    if (streamID == ssdk::transport_common::DEFAULT_STREAM && m_VideoTransmitterAdapter != nullptr)
+    {
+        m_VideoTransmitterAdapter->UpdateSession(session, initID);
+        m_VideoOutput->ForceKeyFrame();
+    }
+}
+
+void SyntheticServer::OnForceUpdateRequest(ssdk::transport_common::StreamID streamID)
+{
+    amf::AMFLock lock(&m_Guard);
+    if (streamID == ssdk::transport_common::DEFAULT_STREAM && m_VideoOutput != nullptr)
+    {
+        m_VideoOutput->ForceKeyFrame();
+    }
+}
+
+void SyntheticServer::OnVideoRequestInit(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID)
+{
+    amf::AMFLock lock(&m_Guard);
+    if (streamID == ssdk::transport_common::DEFAULT_STREAM && m_VideoTransmitterAdapter != nullptr)
+    {
+        m_VideoTransmitterAdapter->SendInitToSession(session);
+    }
+}
+
+//  The synthetic stream is kept at fixed parameters, so that the load remains the same regardless of what the clients request
+void SyntheticServer::OnBitrateChangeRecieverRequest(ssdk::transport_common::SessionHandle /*session*/, ssdk::transport_common::StreamID /*streamID*/, int64_t /*bitrate*/)
+{
+}
+
+void SyntheticServer::OnFramerateChangeRecieverRequest(ssdk::transport_common::SessionHandle /*session*/, ssdk::transport_common::StreamID /*streamID*/, float /*framerate*/)
+{
+}
+
+void SyntheticServer::OnResolutionChangeRecieverRequest(ssdk::transport_common::SessionHandle /*session*/, ssdk::transport_common::StreamID /*streamID*/, const AMFSize& /*resolution*/)
+{
+}
+
+//  AudioSenderCallback methods
+void SyntheticServer::OnAudioStreamSubscribed(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID)
+{
+    amf::AMFLock lock(&m_Guard);
+    if (streamID != ssdk::transport_common::DEFAULT_STREAM || m_AudioTransmitterAdapter == nullptr)
+    {
+        AMFTraceWarning(AMF_FACILITY, L"Client session %lld is trying to subscribe to an invalid audio stream %lld, request ignored", session, streamID);
+    }
+    else if (m_AudioTransmitterAdapter->RegisterSession(session) == true)
+    {
+        m_SessionsAudio.emplace(session);
+        m_AudioTransmitterAdapter->SendInitToSession(session);
+    }
+}
+
+void SyntheticServer::OnAudioStreamUnsubscribed(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID)
+{
+    amf::AMFLock lock(&m_Guard);
+    if (streamID == ssdk::transport_common::DEFAULT_STREAM && m_AudioTransmitterAdapter != nullptr)
+    {
+        m_AudioTransmitterAdapter->UnregisterSession(session);
+        m_SessionsAudio.erase(session);
+    }
+}
+
+void SyntheticServer::OnReadyToReceiveAudio(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID, ssdk::transport_common::InitID initID)
+{
+    amf::AMFLock lock(&m_Guard);
+    if (streamID == ssdk::transport_common::DEFAULT_STREAM && m_AudioTransmitterAdapter != nullptr)
+    {
+        m_AudioTransmitterAdapter->UpdateSession(session, initID);
+    }
+}
+
+void SyntheticServer::OnAudioRequestInit(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID)
+{
+    amf::AMFLock lock(&m_Guard);
+    if (streamID == ssdk::transport_common::DEFAULT_STREAM && m_AudioTransmitterAdapter != nullptr)
+    {
+        m_AudioTransmitterAdapter->SendInitToSession(session);
+    }
+}
+
+//  InputControllerCallback methods: input events are only counted, there is nothing to inject them into
+void SyntheticServer::OnControllerEnabled(ssdk::transport_common::SessionHandle /*session*/, const char* /*deviceID*/, ssdk::transport_common::ControllerType /*type*/)
+{
+}
+
+void SyntheticServer::OnControllerDisabled(ssdk::transport_common::SessionHandle /*session*/, const char* /*deviceID*/)
+{
+}
+
+void SyntheticServer::OnControllerInputEvent(ssdk::transport_common::SessionHandle /*session*/, const char* /*controlID*/, const ssdk::ctls::CtlEvent& /*event*/)
+{
+    amf::AMFLock lock(&m_Guard);
+    ++m_Stats.m_InputEvents;
+}
+
+amf::AMF_VARIANT_TYPE SyntheticServer::GetExpectedEventDataType(const char* /*controlID*/)
+{
+    return amf::AMF_VARIANT_FLOAT_POINT2D;  //  Simulated clients only send mouse position events
+}
+
+void SyntheticServer::OnTrackableDevicePoseChange(ssdk::transport_common::SessionHandle /*session*/, const char* /*deviceID*/, const ssdk::transport_common::Pose& /*pose*/)
+{
+}
+
+SyntheticServer::VideoSourceThread::VideoSourceThread(SyntheticServer& server) :
+    m_Server(server)
+{
+}
+
+void SyntheticServer::VideoSourceThread::Run()
+{
+    while (StopRequested() == false)
+    {
+        m_Server.GenerateVideo();
+    }
+}
+
+SyntheticServer::AudioSourceThread::AudioSourceThread(SyntheticServer& server) :
+    m_Server(server)
+{
+}
+
+void SyntheticServer::AudioSourceThread::Run()
+{
+    while (StopRequested() == false)
+    {
+        m_Server.GenerateAudio();
+    }
+}
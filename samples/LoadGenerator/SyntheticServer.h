@@ -0,0 +1,182 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "sdk/video/MonoscopicVideoOutput.h"
+#include "sdk/video/VideoTransmitterAdapter.h"
+#include "sdk/audio/AudioOutput.h"
+#include "sdk/audio/AudioTransmitterAdapter.h"
+#include "sdk/transports/transport-common/ServerTransport.h"
+
+#include "amf/public/include/core/Context.h"
+#include "amf/public/common/Thread.h"
+
+#include <memory>
+#include <set>
+#include <string>
+
+//  SyntheticServer is a GPU-less streaming server for load testing. Instead of capturing the display and audio output it
+//  generates blank frames and silence at a fixed rate and encodes them with the null video and audio codecs, so the entire
+//  server-side pipeline and the transport are exercised without any dependency on graphics or audio hardware.
+class SyntheticServer :
+    public ssdk::transport_common::ServerTransport::ConnectionManagerCallback,
+    public ssdk::transport_common::ServerTransport::VideoSenderCallback,
+    public ssdk::transport_common::ServerTransport::AudioSenderCallback,
+    public ssdk::transport_common::ServerTransport::InputControllerCallback
+{
+public:
+    typedef std::unique_ptr<SyntheticServer>    Ptr;
+
+    struct Config
+    {
+        ssdk::transport_common::ServerTransport::NETWORK_TYPE   m_NetworkType = ssdk::transport_common::ServerTransport::NETWORK_TYPE::NETWORK_UDP;
+        uint16_t        m_Port = 0;
+        int64_t         m_DatagramSize = 0;
+        std::string     m_BindInterface;
+        std::string     m_LocalSocket;          //  Shared memory transport for same-host clients is disabled when empty
+        std::string     m_HostName;
+        std::string     m_Passphrase;           //  Encryption is disabled when empty
+        std::string     m_NetworkImpairment;    //  See sdk/net/NetworkImpairment.h for the syntax, empty - no impairment
+        int64_t         m_MaxConnections = 0;
+        AMFSize         m_Resolution = {};
+        float           m_Framerate = 0;
+        int64_t         m_VideoBitrate = 0;
+        int32_t         m_AudioSamplingRate = 0;
+        int32_t         m_AudioChannels = 0;
+        int32_t         m_AudioBitrate = 0;
+    };
+
+    //  All counters are cumulative since the server was started
+    struct Stats
+    {
+        int64_t         m_Connections = 0;      //  Currently connected clients
+        int64_t         m_VideoSubscribers = 0;
+        int64_t         m_AudioSubscribers = 0;
+        int64_t         m_VideoFrames = 0;
+        int64_t         m_AudioBuffers = 0;
+        int64_t         m_InputEvents = 0;
+    };
+
+public:
+    SyntheticServer(amf::AMFContext* context);
+    virtual ~SyntheticServer();
+
+    bool Start(const Config& config);
+    void Stop();
+
+    void GetStats(Stats& stats) const;
+    inline ssdk::transport_common::ServerTransport* GetTransport() const noexcept { return m_Transport.get(); }     //  Valid between Start() and Stop()
+
+    //  ssdk::transport_common::ServerTransport::ConnectionManagerCallback methods
+    virtual ClientAction OnDiscoveryRequest(const char* clientID) override;
+    virtual ClientAction OnConnectionRequest(ssdk::transport_common::SessionHandle session, const char* clientID, ClientRole role) override;
+    virtual void OnClientSubscribed(ssdk::transport_common::SessionHandle session) override;
+    virtual void OnClientDisconnected(ssdk::transport_common::SessionHandle session, DisconnectReason reason) override;
+
+    //  ssdk::transport_common::ServerTransport::VideoSenderCallback methods:
+    virtual void OnVideoStreamSubscribed(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID) override;
+    virtual void OnVideoStreamUnsubscribed(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID) override;
+    virtual void OnReadyToReceiveVideo(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID, ssdk::transport_common::InitID initID) override;
+    virtual void OnForceUpdateRequest(ssdk::transport_common::StreamID streamID) override;
+    virtual void OnVideoRequestInit(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID) override;
+    virtual void OnBitrateChangeRecieverRequest(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID, int64_t bitrate) override;
+    virtual void OnFramerateChangeRecieverRequest(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID, float framerate) override;
+    virtual void OnResolutionChangeRecieverRequest(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID, const AMFSize& resolution) override;
+
+    //  ssdk::transport_common::ServerTransport::AudioSenderCallback methods:
+    virtual void OnAudioStreamSubscribed(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID) override;
+    virtual void OnAudioStreamUnsubscribed(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID) override;
+    virtual void OnReadyToReceiveAudio(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID, ssdk::transport_common::InitID initID) override;
+    virtual void OnAudioRequestInit(ssdk::transport_common::SessionHandle session, ssdk::transport_common::StreamID streamID) override;
+
+    //  ssdk::transport_common::ServerTransport::InputControllerCallback methods:
+    virtual void OnControllerEnabled(ssdk::transport_common::SessionHandle session, const char* deviceID, ssdk::transport_common::ControllerType type) override;
+    virtual void OnControllerDisabled(ssdk::transport_common::SessionHandle session, const char* deviceID) override;
+    virtual void OnControllerInputEvent(ssdk::transport_common::SessionHandle session, const char* controlID, const ssdk::ctls::CtlEvent& event) override;
+    virtual amf::AMF_VARIANT_TYPE GetExpectedEventDataType(const char* controlID) override;
+    virtual void OnTrackableDevicePoseChange(ssdk::transport_common::SessionHandle session, const char* deviceID, const ssdk::transport_common::Pose& pose) override;
+
+private:
+    bool InitPipelines(const Config& config);
+    void GenerateVideo();
+    void GenerateAudio();
+
+    class VideoSourceThread : public amf::AMFThread
+    {
+    public:
+        VideoSourceThread(SyntheticServer& server);
+
+        virtual void Run() override;
+
+    private:
+        SyntheticServer& m_Server;
+    };
+
+    class AudioSourceThread : public amf::AMFThread
+    {
+    public:
+        AudioSourceThread(SyntheticServer& server);
+
+        virtual void Run() override;
+
+    private:
+        SyntheticServer& m_Server;
+    };
+
+private:
+    mutable amf::AMFCriticalSection                     m_Guard;
+    amf::AMFContextPtr                                  m_Context;
+    Config                                              m_Config;
+
+    ssdk::transport_common::ServerTransport::Ptr        m_Transport;
+
+    ssdk::video::VideoEncodeEngine::Ptr                 m_VideoEncoder;
+    ssdk::video::TransmitterAdapter::Ptr                m_VideoTransmitterAdapter;
+    ssdk::video::MonoscopicVideoOutput::Ptr             m_VideoOutput;
+
+    ssdk::audio::AudioEncodeEngine::Ptr                 m_AudioEncoder;
+    ssdk::audio::TransmitterAdapter::Ptr                m_AudioTransmitterAdapter;
+    ssdk::audio::AudioOutput::Ptr                       m_AudioOutput;
+
+    typedef std::set<ssdk::transport_common::SessionHandle>  SessionCollection;
+    SessionCollection                                   m_SessionsVideo;
+    SessionCollection                                   m_SessionsAudio;
+
+    Stats                                               m_Stats;
+
+    VideoSourceThread                                   m_VideoSourceThread;
+    AudioSourceThread                                   m_AudioSourceThread;
+};
@@ -32,6 +32,7 @@
 //
 
 #include "AVStreamer.h"
+#include "sdk/util/trace/PipelineTrace.h"
 
 #include "amf/public/common/TraceAdapter.h"
 #include "amf/public/include/components/DisplayCapture.h"
@@ -393,6 +394,14 @@ void AVStreamer::OnQoSEvent(ssdk::transport_common::StreamID streamID, ssdk::uti
     case ssdk::util::QoS::QoSEvent::VIDEO_ENCODER_QUEUE_THRESHOLD_EXCEEDED:
         AMFTraceDebug(AMF_FACILITY, L"OnQoSEvent(VIDEO_ENCODER_QUEUE_THRESHOLD_EXCEEDED)(%lld)", value->int64Value);
         break;
+    case ssdk::util::QoS::QoSEvent::ENCODER_TIERS_CHANGED:
+        //  This server runs a single encoder at the highest tier, sessions in lower tiers are paced by the transport
+        AMFTraceDebug(AMF_FACILITY, L"OnQoSEvent(ENCODER_TIERS_CHANGED) (%lld)", value->int64Value);
+        break;
+    case ssdk::util::QoS::QoSEvent::KEY_FRAME_REQUESTED:
+        AMFTraceDebug(AMF_FACILITY, L"OnQoSEvent(KEY_FRAME_REQUESTED) session %lld", value->int64Value);
+        OnForceUpdateRequest(streamID);
+        break;
     default:
         AMFTraceDebug(AMF_FACILITY, L"OnQoSEvent(unknown!)");
         break;
@@ -639,6 +648,7 @@ void AVStreamer::CaptureVideo()
         {
             amf::AMFSurfacePtr frame(capturedData);
             m_TimestampCalibrator.SubmitVideo(frame);   //  This synchronizes low latency video timestamp to audio. See notes in sdk/util/pipeline/TimestampCalibrator.h for detailed explanations
+            SSDK_TRACE_INSTANT(CAPTURE, frame->GetPts());
             m_VideoOutput->SubmitInput(frame, lastOriginPts, timeOfLastOriginPts);
         }
     }
@@ -39,9 +39,13 @@ THE SOFTWARE.
 #include "sdk/video/encoders/GPUEncoderH264.h"
 #include "sdk/video/encoders/GPUEncoderHEVC.h"
 #include "sdk/video/encoders/GPUEncoderAV1.h"
+#include "sdk/video/encoders/NullVideoEncodeEngine.h"
 
 #include "sdk/audio/encoders/AudioEncoderAAC.h"
 #include "sdk/audio/encoders/AudioEncoderOPUS.h"
+#include "sdk/audio/encoders/NullAudioEncodeEngine.h"
+
+#include "sdk/util/trace/PipelineTrace.h"
 
 #include "amf/public/include/components/DisplayCapture.h"
 #include "amf/public/include/components/AudioCapture.h"
@@ -67,8 +71,15 @@ static constexpr const wchar_t* PARAM_NAME_SHUTDOWN = L"shutdown";
 static constexpr const wchar_t* PARAM_NAME_PROTOCOL = L"protocol";
 static constexpr const wchar_t* PARAM_NAME_PORT = L"port";
 static constexpr const wchar_t* PARAM_NAME_DATAGRAM_SIZE = L"datagramSize";
+static constexpr const wchar_t* PARAM_NAME_NETWORK_IMPAIRMENT = L"NetImpairment";
 static constexpr const wchar_t* PARAM_NAME_LOGFILE = L"LOGFILE";
+static constexpr const wchar_t* PARAM_NAME_TRACE_FILE = L"TraceFile";
+static constexpr const wchar_t* PARAM_NAME_METRICS = L"Metrics";
 static constexpr const wchar_t* PARAM_NAME_BIND_INTERFACE = L"BindInterface";
+static constexpr const wchar_t* PARAM_NAME_LOCAL_SOCKET = L"LocalSocket";
+static constexpr const wchar_t* PARAM_NAME_DSCP_MARKING = L"DscpMarking";
+static constexpr const wchar_t* PARAM_NAME_BUSY_POLL = L"BusyPoll";
+static constexpr const wchar_t* PARAM_NAME_IO_URING = L"IoUring";
 static constexpr const wchar_t* PARAM_NAME_SERVER_HOSTNAME = L"Hostname";
 static constexpr const wchar_t* PARAM_NAME_MAX_CONNECTIONS = L"Connections";
 
@@ -83,17 +94,24 @@ static constexpr const wchar_t* PARAM_NAME_RESOLUTION = L"Resolution";
 static constexpr const wchar_t* PARAM_NAME_VIDEO_BITRATE = L"VideoBitrate";
 static constexpr const wchar_t* PARAM_NAME_PRESERVE_ASPECT_RATIO = L"PreserveAspectRatio";
 static constexpr const wchar_t* PARAM_NAME_HDR = L"Hdr";
+static constexpr const wchar_t* PARAM_NAME_STATIC_CONTENT = L"StaticContent";
+static constexpr const wchar_t* PARAM_NAME_IDLE_FRAMERATE = L"IdleFramerate";
+static constexpr const wchar_t* PARAM_NAME_HASH_VIDEO_MEMORY = L"HashVideoMemory";
 
 static constexpr const wchar_t* PARAM_NAME_AUDIO_CODEC = L"AudioCodec";
 static constexpr const wchar_t* PARAM_NAME_AUDIO_BITRATE = L"AudioBitrate";
 static constexpr const wchar_t* PARAM_NAME_AUDIO_SAMPLING_RATE = L"AudioSamplingRate";
 static constexpr const wchar_t* PARAM_NAME_AUDIO_CHANNELS = L"AudioChannels";
+static constexpr const wchar_t* PARAM_NAME_AUDIO_REDUNDANCY = L"AudioRedundancy";
 
 static constexpr const wchar_t* PARAM_NAME_QOS_ADJUST_FRAMERATE = L"QOSFramerate";
 static constexpr const wchar_t* PARAM_NAME_QOS_ADJUST_BITRATE = L"QOSBitrate";
 
 static constexpr const wchar_t* PARAM_NAME_QOS_MIN_FRAMERATE = L"QOSMinFramerate";
 static constexpr const wchar_t* PARAM_NAME_QOS_MIN_BITRATE = L"QOSMinBitrate";
+static constexpr const wchar_t* PARAM_NAME_QOS_POLICY = L"QOSPolicy";
+static constexpr const wchar_t* PARAM_NAME_QOS_PERCENTILE = L"QOSPercentile";
+static constexpr const wchar_t* PARAM_NAME_QOS_TIERS = L"QOSTiers";
 
 //  Values for PARAM_NAME_CAPTURE_MODE
 static constexpr const wchar_t* CAPTURE_MODE_FRAMERATE = L"FRAMERATE";
@@ -101,6 +119,12 @@ static constexpr const wchar_t* CAPTURE_MODE_PRESENT = L"PRESENT";
 static constexpr const wchar_t* CAPTURE_MODE_ASAP = L"ASAP";
 static constexpr const wchar_t* CAPTURE_FORCE_COPY = L"CAPTURECOPY";
 
+//  Values for PARAM_NAME_QOS_POLICY
+static constexpr const wchar_t* QOS_POLICY_WORST = L"WORST";
+static constexpr const wchar_t* QOS_POLICY_PERCENTILE = L"PERCENTILE";
+static constexpr const wchar_t* QOS_POLICY_DROP = L"DROP";
+static constexpr const wchar_t* QOS_POLICY_TIERS = L"TIERS";
+
 //  Values for PARAM_NAME_PROTOCOL
 static constexpr const wchar_t* PROTOCOL_UDP = L"UDP";
 static constexpr const wchar_t* PROTOCOL_TCP = L"TCP";
@@ -111,11 +135,13 @@ static constexpr const wchar_t* VIDEO_CODEC_HEVC = L"HEVC";
 static constexpr const wchar_t* VIDEO_CODEC_AVC = L"AVC";
 static constexpr const wchar_t* VIDEO_CODEC_H265 = L"H265";
 static constexpr const wchar_t* VIDEO_CODEC_H264 = L"H264";
+static constexpr const wchar_t* VIDEO_CODEC_NULL = L"NULL";
 static constexpr const wchar_t* VIDEO_CODEC_EFC_OFF = L"EFCOFF";
 
 //  Values for PARAM_NAME_AUDIO_CODEC
 static constexpr const wchar_t* AUDIO_CODEC_AAC = L"AAC";
 static constexpr const wchar_t* AUDIO_CODEC_OPUS = L"OPUS";
+static constexpr const wchar_t* AUDIO_CODEC_NULL = L"NULL";
 
 //  Values for PARAM_NAME_AUDIO_CHANNELS
 static constexpr const wchar_t* AUDIO_CHANNELS_MONO = L"1";
@@ -157,8 +183,15 @@ RemoteDesktopServer::RemoteDesktopServer()
     SetParamDescription(PARAM_NAME_PROTOCOL, ParamCommon, L"Specify a transport protocol [UDP, TCP], default = UDP", nullptr);
     SetParamDescription(PARAM_NAME_PORT, ParamCommon, L"Specify a UDP/TCP port the server is listening on, default = 1235", ParamConverterInt64);
     SetParamDescription(PARAM_NAME_DATAGRAM_SIZE, ParamCommon, L"Specify UDP datagram size, default = 65507", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_NETWORK_IMPAIRMENT, ParamCommon, L"Emulate a lossy network on outgoing UDP traffic for testing, e.g. \"loss=1,delay=20,jitter=5,rate=20000,seed=1\", default = none", nullptr);
     SetParamDescription(PARAM_NAME_LOGFILE, ParamCommon, L"Specify log file path, default = ./RemoteDesktopServer.log", nullptr);
+    SetParamDescription(PARAM_NAME_TRACE_FILE, ParamCommon, L"Record a per-frame pipeline trace and save it to this file in the Chrome trace format on exit, default = none", nullptr);
+    SetParamDescription(PARAM_NAME_METRICS, ParamCommon, L"Serve OpenMetrics on http://<url>/metrics, e.g. tcp://127.0.0.1:9464 or local://name on Linux, default = none", nullptr);
     SetParamDescription(PARAM_NAME_BIND_INTERFACE, ParamCommon, L"IP address or interface name the server is accepting connections from, * for any", nullptr);
+    SetParamDescription(PARAM_NAME_LOCAL_SOCKET, ParamCommon, L"Linux only: also accept clients on the same host over shared memory, connect with local://<name>, a name starting with / is a filesystem path, default = none", nullptr);
+    SetParamDescription(PARAM_NAME_DSCP_MARKING, ParamCommon, L"Mark video packets with DSCP AF41 and audio and input with EF (true, false), default = true", ParamConverterBoolean);
+    SetParamDescription(PARAM_NAME_BUSY_POLL, ParamCommon, L"Linux only: busy poll the NIC for this many microseconds when receiving, 0 - off, default = 0", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_IO_URING, ParamCommon, L"Linux only: send and receive UDP through io_uring, falls back to select() when unavailable (true, false), default = false", ParamConverterBoolean);
     SetParamDescription(PARAM_NAME_SERVER_HOSTNAME, ParamCommon, L"Display name of server, \"RemoteDesktopServer\" will be used if empty", nullptr);
     SetParamDescription(PARAM_NAME_MAX_CONNECTIONS, ParamCommon, L"Specify the number of concurrent connections, default = 1", ParamConverterInt64);
 
@@ -172,22 +205,29 @@ RemoteDesktopServer::RemoteDesktopServer()
     SetParamDescription(CAPTURE_FORCE_COPY, ParamCommon, L"Force display capture to make a copy of the captured surface (true, false), default = false", ParamConverterBoolean);
 
     SetParamDescription(PARAM_NAME_RESOLUTION, ParamCommon, L"Encoded stream resolution, (w,h) default = 1920,1080", ParamConverterSize);
-    SetParamDescription(PARAM_NAME_VIDEO_CODEC, ParamCommon, L"Specify video codec: [av1, hevc, avc], default = hevc", nullptr);
+    SetParamDescription(PARAM_NAME_VIDEO_CODEC, ParamCommon, L"Specify video codec: [av1, hevc, avc, null], default = hevc", nullptr);
     SetParamDescription(PARAM_NAME_VIDEO_BITRATE, ParamCommon, L"Video bitrate in bits per second, default = 50000000", ParamConverterInt64);
     SetParamDescription(PARAM_NAME_HDR, ParamCommon, L"Enable HDR on video (true, false), default = false", ParamConverterBoolean);
     SetParamDescription(PARAM_NAME_PRESERVE_ASPECT_RATIO, ParamCommon, L"Preserve aspect ratio of the server display (true, false), default = true", ParamConverterBoolean);
     SetParamDescription(VIDEO_CODEC_EFC_OFF, ParamCommon, L"Force EFC (CSC in encoder) OFF (true, false), default = false", ParamConverterBoolean);
+    SetParamDescription(PARAM_NAME_STATIC_CONTENT, ParamCommon, L"Skip encoding of unchanged frames, detected by hashing captured frames in host memory or with dirty rectangles (true, false), default = false", ParamConverterBoolean);
+    SetParamDescription(PARAM_NAME_HASH_VIDEO_MEMORY, ParamCommon, L"Let StaticContent download captured frames in video memory to hash them, which costs a full copy per frame (true, false), default = false", ParamConverterBoolean);
+    SetParamDescription(PARAM_NAME_IDLE_FRAMERATE, ParamCommon, L"Minimum frame rate sent while the captured content is static, 0 - none, default = 1", ParamConverterInt64);
 
 
-    SetParamDescription(PARAM_NAME_AUDIO_CODEC, ParamCommon, L"Specify audio codec: [aac, opus], default = aac", nullptr);
+    SetParamDescription(PARAM_NAME_AUDIO_CODEC, ParamCommon, L"Specify audio codec: [aac, opus, null], default = aac", nullptr);
     SetParamDescription(PARAM_NAME_AUDIO_BITRATE, ParamCommon, L"Audio bitrate in bits per second, default = 256000", ParamConverterInt64);
     SetParamDescription(PARAM_NAME_AUDIO_SAMPLING_RATE, ParamCommon, L"Audio sampling rate in Hz, default = 44100", ParamConverterInt64);
     SetParamDescription(PARAM_NAME_AUDIO_CHANNELS, ParamCommon, L"Specify audio channel layout: [1 - mono, 2 - stereo, 2.1 - stereo+sub, 3 - stereo+center, 3.1 - stereo+center+sub, 5.1 - full surround], default = 2 (stereo)", nullptr);
+    SetParamDescription(PARAM_NAME_AUDIO_REDUNDANCY, ParamCommon, L"Number of previous audio frames repeated in every audio packet so that clients can replace lost packets without a retransmission, 0 - off, default = 0", ParamConverterInt64);
 
     SetParamDescription(PARAM_NAME_QOS_ADJUST_BITRATE, ParamCommon, L"Enables QoS bitrate adjustment (true, false), default = true", ParamConverterBoolean);
     SetParamDescription(PARAM_NAME_QOS_ADJUST_FRAMERATE, ParamCommon, L"Enables QoS framerate adjustment (true, false), default = true", ParamConverterBoolean);
     SetParamDescription(PARAM_NAME_QOS_MIN_FRAMERATE, ParamCommon, L"Minimum framerate set by QoS, default = 15", ParamConverterInt64);
     SetParamDescription(PARAM_NAME_QOS_MIN_BITRATE, ParamCommon, L"Minimum video bitrate set by QoS (in bits per second), default = 1000000", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_QOS_POLICY, ParamCommon, L"How QoS combines per-client bitrates [WORST - the slowest client sets the bitrate for everyone, PERCENTILE - bitrate at QOSPercentile of clients, slower clients have frames dropped, DROP - the fastest client sets the bitrate, slower clients have frames dropped, TIERS - group clients into QOSTiers], default = WORST", nullptr);
+    SetParamDescription(PARAM_NAME_QOS_PERCENTILE, ParamCommon, L"Percentile of client bitrates used by the PERCENTILE QoS policy (0-100), default = 50", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_QOS_TIERS, ParamCommon, L"Comma-separated bitrate tiers in bits per second used by the TIERS QoS policy, e.g. \"5000000,15000000,25000000\", default = none", nullptr);
 
 
 }
@@ -225,6 +265,17 @@ RemoteDesktopServer::EStatus RemoteDesktopServer::Init(int argc/* = 0*/, const c
                     g_AMFFactory.GetTrace()->EnableWriter(AMF_TRACE_WRITER_FILE, false);
                 }
 
+                if (GetParamString(PARAM_NAME_TRACE_FILE, m_TraceFile) == AMF_OK && m_TraceFile.empty() == false)
+                {
+                    ssdk::util::PipelineTrace::Enable(true);
+                }
+
+                std::string metricsUrl;
+                if (GetParamString(PARAM_NAME_METRICS, metricsUrl) == AMF_OK && metricsUrl.empty() == false)
+                {
+                    m_MetricsExporter.Init(metricsUrl);
+                }
+
                 int64_t port = m_Port = DEFAULT_PORT;
                 if (GetParam(PARAM_NAME_SHUTDOWN, port) == AMF_OK)
                 {
@@ -298,6 +349,12 @@ RemoteDesktopServer::EStatus RemoteDesktopServer::Init(int argc/* = 0*/, const c
 
 void RemoteDesktopServer::Terminate()
 {
+    m_MetricsExporter.Terminate();
+    if (m_TraceFile.empty() == false)
+    {
+        ssdk::util::PipelineTrace::Enable(false);
+        ssdk::util::PipelineTrace::SaveChromeTrace(m_TraceFile.c_str(), "RemoteDesktopServer", 1);
+    }
     TerminateStreamer();
     TerminateAudioCodec();
     TerminateAudioCapture();
@@ -724,6 +781,10 @@ bool RemoteDesktopServer::InitVideoCodec()
     {
         encoder = ssdk::video::VideoEncodeEngine::Ptr(new ssdk::video::GPUEncoderAV1(m_Context));
     }
+    else if (codec == VIDEO_CODEC_NULL)
+    {
+        encoder = ssdk::video::VideoEncodeEngine::Ptr(new ssdk::video::NullVideoEncodeEngine(m_Context));
+    }
     else
     {
         AMFTraceError(AMF_FACILITY, L"Invalid codec: %S", codec.c_str());
@@ -778,6 +839,10 @@ bool RemoteDesktopServer::InitAudioCodec()
     {
         encoder = ssdk::audio::AudioEncodeEngine::Ptr(new ssdk::audio::AudioEncoderOPUS(m_Context));
     }
+    else if (codec == AUDIO_CODEC_NULL)
+    {
+        encoder = ssdk::audio::AudioEncodeEngine::Ptr(new ssdk::audio::NullAudioEncodeEngine(m_Context));
+    }
     else
     {
         AMFTraceError(AMF_FACILITY, L"Invalid codec: %S", codec.c_str());
@@ -837,10 +902,42 @@ bool RemoteDesktopServer::InitNetwork()
     GetParam(PARAM_NAME_DATAGRAM_SIZE, datagramSize);
     initParams.SetDatagramSize(datagramSize);
 
+    std::string networkImpairment;
+    GetParamString(PARAM_NAME_NETWORK_IMPAIRMENT, networkImpairment);
+    initParams.SetNetworkImpairment(networkImpairment);
+
     std::string bindInterface = DEFAULT_BIND_INTERFACE;
     GetParamString(PARAM_NAME_BIND_INTERFACE, bindInterface);
     initParams.SetBindInterface(bindInterface);
 
+    std::string localSocket;
+    GetParamString(PARAM_NAME_LOCAL_SOCKET, localSocket);
+    initParams.SetLocalSocketPath(localSocket);
+
+    int64_t audioRedundancy = 0;
+    GetParam(PARAM_NAME_AUDIO_REDUNDANCY, audioRedundancy);
+    initParams.SetAudioRedundancy(audioRedundancy);
+
+    //  Size the socket buffers for a key frame at the configured video bitrate
+    int64_t videoBitrate = 50000000;
+    GetParam(PARAM_NAME_VIDEO_BITRATE, videoBitrate);
+    initParams.SetSocketMaxBitrate(videoBitrate);
+    int64_t frameRate = 60;
+    GetParam(PARAM_NAME_CAPTURE_RATE, frameRate);
+    initParams.SetSocketFrameRate(frameRate);
+
+    bool dscpMarking = true;
+    GetParam(PARAM_NAME_DSCP_MARKING, dscpMarking);
+    initParams.SetDscpMarking(dscpMarking);
+
+    int64_t busyPoll = 0;
+    GetParam(PARAM_NAME_BUSY_POLL, busyPoll);
+    initParams.SetSocketBusyPoll(busyPoll);
+
+    bool ioUring = false;
+    GetParam(PARAM_NAME_IO_URING, ioUring);
+    initParams.SetIoUring(ioUring);
+
     std::string hostName = DEFAULT_SERVER_HOSTNAME;
     GetParamString(PARAM_NAME_SERVER_HOSTNAME, hostName);
     initParams.SetHostName(hostName);
@@ -937,6 +1034,15 @@ bool RemoteDesktopServer::InitStreamer()
     bool forceEFCOff = false;
     GetParam(VIDEO_CODEC_EFC_OFF, forceEFCOff);
 
+    ssdk::video::FrameChangeDetector::Params staticContentParams;
+    GetParam(PARAM_NAME_STATIC_CONTENT, staticContentParams.enabled);
+    //  Display capture delivers frames in video memory without dirty rectangles, hashing them means downloading every frame
+    GetParam(PARAM_NAME_HASH_VIDEO_MEMORY, staticContentParams.hashVideoMemory);
+    int64_t idleFramerate = int64_t(staticContentParams.idleFramerate);
+    GetParam(PARAM_NAME_IDLE_FRAMERATE, idleFramerate);
+    staticContentParams.idleFramerate = float(idleFramerate);
+    m_VideoOutput->SetStaticContentDetection(staticContentParams);
+
     int64_t audioCaptureSamplingRate = 0;
     int64_t audioChannels = 0;
     int64_t audioChannelLayout = 0;
@@ -1023,6 +1129,44 @@ bool RemoteDesktopServer::InitStreamer()
             qosInitParams.bitrateStep = QOS_DEFAULT_BITRATE_STEP;
             qosInitParams.bitrateAdjustmentPeriod = QOS_DEFAULT_BITRATE_ADJUSTMENT_PERIOD_SECONDS * AMF_SECOND;
 
+            std::wstring qosPolicy = QOS_POLICY_WORST;
+            if (GetParamWString(PARAM_NAME_QOS_POLICY, qosPolicy) == AMF_OK)
+            {
+                qosPolicy = ::toUpper(qosPolicy);
+            }
+            if (qosPolicy == QOS_POLICY_PERCENTILE)
+            {
+                qosInitParams.ratePolicy.mode = ssdk::util::SessionRatePolicy::Mode::PERCENTILE;
+            }
+            else if (qosPolicy == QOS_POLICY_DROP)
+            {
+                qosInitParams.ratePolicy.mode = ssdk::util::SessionRatePolicy::Mode::SELECTIVE_DROP;
+            }
+            else if (qosPolicy == QOS_POLICY_TIERS)
+            {
+                qosInitParams.ratePolicy.mode = ssdk::util::SessionRatePolicy::Mode::ENCODER_PER_TIER;
+            }
+            else if (qosPolicy != QOS_POLICY_WORST)
+            {
+                AMFTraceWarning(AMF_FACILITY, L"Unknown QoS policy %s, using %s", qosPolicy.c_str(), QOS_POLICY_WORST);
+            }
+
+            int64_t percentile = 50;
+            GetParam(PARAM_NAME_QOS_PERCENTILE, percentile);
+            qosInitParams.ratePolicy.percentile = float(percentile) / 100;
+
+            std::string tiers;
+            GetParamString(PARAM_NAME_QOS_TIERS, tiers);
+            std::stringstream tierStream(tiers);
+            for (std::string tier; std::getline(tierStream, tier, ',');)
+            {
+                int64_t tierBitrate = strtoll(tier.c_str(), nullptr, 10);
+                if (tierBitrate > 0)
+                {
+                    qosInitParams.ratePolicy.tierBitrates.push_back(tierBitrate);
+                }
+            }
+
             result = m_QoS->Init(qosInitParams);
         }
 
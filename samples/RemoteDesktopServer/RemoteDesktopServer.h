@@ -52,6 +52,7 @@
 #include "amf/public/samples/CPPSamples/common/CmdLineParser.h"
 
 #include "sdk/controllers/server/ControllerManagerSvr.h"
+#include "sdk/util/metrics/MetricsExporter.h"
 
 #include <string>
 #include <memory>
@@ -165,4 +166,7 @@ protected:
     amf::AMFSurfacePtr                                  m_LastCursor;
 
     ssdk::ctls::svr::ControllerManager::Ptr             m_pControllerManager;
+
+    std::string                                         m_TraceFile;
+    ssdk::util::MetricsExporter                         m_MetricsExporter;
 };
\ No newline at end of file
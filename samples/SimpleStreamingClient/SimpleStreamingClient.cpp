@@ -35,6 +35,8 @@ THE SOFTWARE.
 
 #include "SimpleStreamingClient.h"
 
+#include "sdk/util/trace/PipelineTrace.h"
+
 #include "amf/public/common/AMFFactory.h"
 #include "amf/public/common/Thread.h"
 #include "amf/public/common/TraceAdapter.h"
@@ -59,8 +61,11 @@ const wchar_t* PARAM_NAME_VIDEO_DENOISER = L"VideoDenoiser";
 const wchar_t* PARAM_NAME_DEVICE_ID = L"DeviceID";
 const wchar_t* PARAM_NAME_RELATIVE_MOUSE_CAPTURE = L"RelativeMouse";
 const wchar_t* PARAM_NAME_DATAGRAM_SIZE = L"datagramSize";
+const wchar_t* PARAM_NAME_IO_URING = L"IoUring";
 const wchar_t* PARAM_NAME_SHOW_CURSOR = L"ShowCursor";
 const wchar_t* PARAM_NAME_LOGFILE = L"LOGFILE";
+const wchar_t* PARAM_NAME_TRACE_FILE = L"TraceFile";
+const wchar_t* PARAM_NAME_METRICS = L"Metrics";
 
 // Default parameter values
 static constexpr const unsigned short DEFAULT_PORT = 1235;
@@ -88,8 +93,11 @@ SimpleStreamingClient::SimpleStreamingClient()
     SetParamDescription(PARAM_NAME_DEVICE_ID, ParamCommon, L"Client device ID, GUID will be generated if empty", nullptr);
     SetParamDescription(PARAM_NAME_RELATIVE_MOUSE_CAPTURE, ParamCommon, L"Enable relative mouse movement capture (true, false) default = true", ParamConverterBoolean);
     SetParamDescription(PARAM_NAME_DATAGRAM_SIZE, ParamCommon, L"Specify UDP datagram size, default = 65507", ParamConverterInt64);
+    SetParamDescription(PARAM_NAME_IO_URING, ParamCommon, L"Linux only: send UDP through io_uring, falls back to select() when unavailable (true, false), default = false", ParamConverterBoolean);
     SetParamDescription(PARAM_NAME_SHOW_CURSOR, ParamCommon, L"Show cursor sent by server, (true, false), default = true", ParamConverterBoolean);
     SetParamDescription(PARAM_NAME_LOGFILE, ParamCommon, L"Specify log file path, default = ./SimpleStreamingClient.log", nullptr);
+    SetParamDescription(PARAM_NAME_TRACE_FILE, ParamCommon, L"Record a per-frame pipeline trace and save it to this file in the Chrome trace format on exit, timestamps are converted to the server clock, default = none", nullptr);
+    SetParamDescription(PARAM_NAME_METRICS, ParamCommon, L"Serve OpenMetrics on http://<url>/metrics, e.g. tcp://127.0.0.1:9465 or local://name on Linux, default = none", nullptr);
 }
 
 SimpleStreamingClient::~SimpleStreamingClient()
@@ -165,6 +173,8 @@ bool SimpleStreamingClient::Terminate()
         if (m_AMFInitalized == true)
         {
             //  Termination order is important, do not change!
+            SaveTrace();
+            m_MetricsExporter.Terminate();
             TerminateStatistics();
             TerminateNetwork();
             TerminateAudio();
@@ -209,9 +219,43 @@ bool SimpleStreamingClient::OnAppInit()
         g_AMFFactory.GetTrace()->EnableWriter(AMF_TRACE_WRITER_FILE, false);
     }
 
+    if (GetParamString(PARAM_NAME_TRACE_FILE, m_TraceFile) == AMF_OK && m_TraceFile.empty() == false)
+    {
+        ssdk::util::PipelineTrace::Enable(true);
+    }
+
+    std::string metricsUrl;
+    if (GetParamString(PARAM_NAME_METRICS, metricsUrl) == AMF_OK && metricsUrl.empty() == false)
+    {
+        m_MetricsExporter.Init(metricsUrl);
+    }
+
     return true;
 }
 
+void SimpleStreamingClient::SaveTrace()
+{
+    if (m_TraceFile.empty() == false)
+    {
+        ssdk::util::PipelineTrace::Enable(false);
+        //  Shift the client timeline onto the server clock so that both traces can be loaded together
+        amf_pts timeOffset = 0;
+        if (m_Transport != nullptr)
+        {
+            ssdk::util::ClockSync::Ptr clockSync = static_cast<ssdk::transport_amd::ClientTransportImpl*>(m_Transport.get())->GetClockSync();
+            if (clockSync != nullptr && clockSync->IsSynchronized() == true)
+            {
+                timeOffset = clockSync->GetOffset();
+            }
+            else
+            {
+                AMFTraceWarning(AMF_FACILITY, L"Clock is not synchronized with the server, the trace is saved on the local timeline");
+            }
+        }
+        ssdk::util::PipelineTrace::SaveChromeTrace(m_TraceFile.c_str(), "SimpleStreamingClient", 2, timeOffset);
+    }
+}
+
 void SimpleStreamingClient::OnAppTerminate()
 {
 }
@@ -326,6 +370,10 @@ bool SimpleStreamingClient::InitNetwork()
         GetParam(PARAM_NAME_DATAGRAM_SIZE, datagramSize);
         initParams.SetDatagramSize(datagramSize);
 
+        bool ioUring = false;
+        GetParam(PARAM_NAME_IO_URING, ioUring);
+        initParams.SetIoUring(ioUring);
+
         //  Unique device ID
         std::string deviceID;
         GetParamString(PARAM_NAME_DEVICE_ID, deviceID);
@@ -59,6 +59,7 @@ THE SOFTWARE.
 #include "sdk/audio/AudioReceiverPipeline.h"
 #include "sdk/util/pipeline/AVSynchronizer.h"
 #include "sdk/util/stats/ClientStatsManager.h"
+#include "sdk/util/metrics/MetricsExporter.h"
 
 #include "amf/public/include/core/Context.h"
 #include "amf/public/samples/CPPSamples/common/CmdLineParser.h"
@@ -82,6 +83,8 @@ extern const wchar_t* PARAM_NAME_DEVICE_ID;
 extern const wchar_t* PARAM_NAME_RELATIVE_MOUSE_CAPTURE;
 extern const wchar_t* PARAM_NAME_SHOW_CURSOR;
 extern const wchar_t* PARAM_NAME_LOGFILE;
+extern const wchar_t* PARAM_NAME_TRACE_FILE;
+extern const wchar_t* PARAM_NAME_METRICS;
 
 class SimpleStreamingClient :
     public ParametersStorage,
@@ -153,6 +156,8 @@ protected:
     virtual bool InitStatistics();
     virtual void TerminateStatistics();
 
+    void SaveTrace();
+
     virtual std::string GenerateGUID() const = 0;
 
     // Implementation of ConnectionManagerCallback interface
@@ -186,4 +191,7 @@ protected:
     ConnectThread::Ptr                      m_pConnectThread;
 
     ssdk::ctls::ControllerManager::Ptr      m_ControllerManager;
+
+    std::string                             m_TraceFile;
+    ssdk::util::MetricsExporter             m_MetricsExporter;
 };
@@ -40,9 +40,11 @@ namespace ssdk::audio
     const char* const CODEC_AAC = "AAC";
     const char* const CODEC_OPUS = "OPUS";
     const char* const CODEC_PCM = "PCM-S16";
+    const char* const CODEC_NULL = "NULL";
 
     extern const char* const CODEC_ID_AAC = "86018";
     extern const char* const CODEC_ID_OPUS = "86076";
     extern const char* const CODEC_ID_PCM = "3000";
+    extern const char* const CODEC_ID_NULL = "0";
 
 }
\ No newline at end of file
@@ -43,6 +43,8 @@ namespace ssdk::audio
     extern const char* const CODEC_ID_OPUS;
     extern const char* const CODEC_PCM;
     extern const char* const CODEC_ID_PCM;
+    extern const char* const CODEC_NULL;        //  Synthetic bitstream produced by NullAudioEncodeEngine, no FFmpeg required
+    extern const char* const CODEC_ID_NULL;
 
     constexpr const int CODEC_AAC_FFMPEG_ID = 86018;
     constexpr const int CODEC_OPUS_FFMPEG_ID = 86076;
@@ -35,6 +35,7 @@
 #include "AudioCodecs.h"
 #include "decoders/AudioDecoderAAC.h"
 #include "decoders/AudioDecoderOPUS.h"
+#include "decoders/NullAudioDecodeEngine.h"
 #include "amf/public/common/TraceAdapter.h"
 
 #include <sstream>
@@ -97,6 +98,10 @@ namespace ssdk::audio
         {
             decoder = AudioDecodeEngine::Ptr(new AudioDecoderOPUS(context));
         }
+        else if (codecNameStr == CODEC_NULL || codecNameStr == CODEC_ID_NULL)
+        {
+            decoder = AudioDecodeEngine::Ptr(new NullAudioDecodeEngine(context));
+        }
         else
         {
             result = AMF_NOT_SUPPORTED;
@@ -133,6 +133,18 @@ namespace ssdk::audio
 
     AMF_RESULT AudioOutput::InitializeConverter(amf::AMF_AUDIO_FORMAT inputFormat, int32_t inputSamplingRate, int32_t inputChannels, int32_t inputLayout, amf::AMF_AUDIO_FORMAT outputFormat, int32_t outputSamplingRate, int32_t outputChannels, int32_t outputLayout)
     {
+        PCMAudioConverter::Format pcmInput = { inputFormat, inputSamplingRate, inputChannels, inputLayout };
+        PCMAudioConverter::Format pcmOutput = { outputFormat, outputSamplingRate, outputChannels, outputLayout };
+        if (PCMAudioConverter::IsSupported(pcmInput, pcmOutput) == true)
+        {   //  Convert inline when possible, fall back to the FFmpeg converter component otherwise
+            PCMAudioConverter::Ptr pcmConverter = PCMAudioConverter::Ptr(new PCMAudioConverter(m_Context));
+            if (pcmConverter->Init(pcmInput, pcmOutput) == AMF_OK)
+            {
+                m_PCMConverter = pcmConverter;
+                return AMF_OK;
+            }
+        }
+
         amf::AMFComponentPtr converter;
         AMF_RESULT result = g_AMFFactory.LoadExternalComponent(m_Context, FFMPEG_HELPER_DLL_NAME, "AMFCreateComponentInt", (void*)FFMPEG_AUDIO_CONVERTER, &converter);
         AMF_RETURN_IF_FAILED(result, L"LoadExternalComponent(%s) failed", FFMPEG_AUDIO_CONVERTER);
@@ -198,6 +210,7 @@ namespace ssdk::audio
             m_Converter->Terminate();
             m_Converter = nullptr;
         }
+        m_PCMConverter = nullptr;
         if (m_Encoder != nullptr)
         {
             m_Encoder->Terminate(); //  Encoder is passed to a constructor, so do not NULL it here
@@ -233,6 +246,10 @@ namespace ssdk::audio
             {
                 m_Converter->Flush();
             }
+            if (m_PCMConverter != nullptr)
+            {
+                m_PCMConverter->Reset();
+            }
             if (m_Encoder != nullptr)
             {
                 m_Encoder->Flush();
@@ -254,7 +271,11 @@ namespace ssdk::audio
     {
         AMF_RESULT res = AMF_OK;
 
-        if (m_Converter != nullptr)
+        if (m_PCMConverter != nullptr)
+        {   //  AMF_NEED_MORE_INPUT when the buffer was too short to produce any output, nothing to encode then
+            res = m_PCMConverter->Convert(inBuffer, outBuffer);
+        }
+        else if (m_Converter != nullptr)
         {
             bool bSubmitRepeat = true;
             do
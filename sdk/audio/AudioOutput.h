@@ -43,6 +43,7 @@ THE SOFTWARE.
 
 #include "encoders/AudioEncodeEngine.h"
 #include "AudioTransmitterAdapter.h"
+#include "PCMAudioConverter.h"
 
 #include "amf/public/include/components/Component.h"
 #include "amf/public/common/Thread.h"
@@ -114,6 +115,7 @@ namespace ssdk::audio
 
         amf::AMFContextPtr          m_Context;
         amf::AMFComponentPtr        m_Converter;
+        PCMAudioConverter::Ptr      m_PCMConverter;     //  Used instead of m_Converter when it supports the conversion
         AudioEncodeEngine::Ptr      m_Encoder;
         Pump::Ptr                   m_Pump;
         InputQueue                  m_InputQueue;
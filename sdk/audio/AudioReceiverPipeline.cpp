@@ -76,12 +76,22 @@ namespace ssdk::audio
                 if (m_AudioConverter != nullptr)
                 {
                     m_AudioConverter->Terminate();
+                    m_AudioConverter = nullptr;
                 }
+                m_PCMConverter = nullptr;
                 if (InitConverter() == AMF_OK)
                 {
                     ssdk::util::AVSynchronizer::AudioInput::Ptr audioSink;
                     m_AVSynchronizer->GetAudioInput(audioSink); //  AV Syncronizer's video input terminates the pipeline and passes the frame to the presenter, for video it's just a passthrough
-                    ssdk::util::PipelineSlot::Ptr converterSlot = ssdk::util::PipelineSlot::Ptr(new ssdk::util::SynchronousSlot("AudioConverter", m_AudioConverter, audioSink));
+                    ssdk::util::PipelineSlot::Ptr converterSlot;
+                    if (m_PCMConverter != nullptr)
+                    {
+                        converterSlot = ssdk::util::PipelineSlot::Ptr(new PCMConverterSlot("AudioConverter", m_PCMConverter, audioSink));
+                    }
+                    else
+                    {
+                        converterSlot = ssdk::util::PipelineSlot::Ptr(new ssdk::util::SynchronousSlot("AudioConverter", m_AudioConverter, audioSink));
+                    }
                     m_PipelineHead = converterSlot; //  We always have at least a VideoConverter component, continue to
 
                     m_InitID = initID;
@@ -106,38 +116,53 @@ namespace ssdk::audio
 
     AMF_RESULT AudioReceiverPipeline::InitConverter()
     {
+        int64_t streamBitRate;
+        int64_t outputSamplingRate;
+        int64_t outputChannels;
+        int64_t outputFormat;
+        int64_t outputLayout;
+        int64_t outputBlockAlign;
+
+        AMF_RESULT result = m_Presenter->GetDescription(streamBitRate, outputSamplingRate, outputChannels, outputFormat, outputLayout, outputBlockAlign);
+        AMF_RETURN_IF_FAILED(result, L"Failed get parameters of the audio presenter, result = %s", amf::AMFGetResultText(result));
+
+        uint32_t inputSamplingRate = m_Input->GetSamplingRate();
+        amf::AMF_AUDIO_FORMAT inputFormat = m_Input->GetOutputFormat();
+        uint32_t inputChannels = m_Input->GetChannels();
+        uint32_t inputLayout = m_Input->GetLayout();
+
+        //  Convert inline when possible, fall back to the FFmpeg converter component otherwise
+        PCMAudioConverter::Format pcmInput = { inputFormat, static_cast<int32_t>(inputSamplingRate), static_cast<int32_t>(inputChannels), static_cast<int32_t>(inputLayout) };
+        PCMAudioConverter::Format pcmOutput = { static_cast<amf::AMF_AUDIO_FORMAT>(outputFormat), static_cast<int32_t>(outputSamplingRate), static_cast<int32_t>(outputChannels), static_cast<int32_t>(outputLayout) };
+        int64_t outputFrameSize = outputChannels * static_cast<int64_t>(pcmOutput.format == amf::AMFAF_S16 || pcmOutput.format == amf::AMFAF_S16P ? sizeof(int16_t) : sizeof(float));
+        if ((outputBlockAlign == 0 || outputBlockAlign == outputFrameSize) && PCMAudioConverter::IsSupported(pcmInput, pcmOutput) == true)
+        {
+            PCMAudioConverter::Ptr pcmConverter = PCMAudioConverter::Ptr(new PCMAudioConverter(m_Context));
+            if (pcmConverter->Init(pcmInput, pcmOutput) == AMF_OK)
+            {
+                m_PCMConverter = pcmConverter;
+                return AMF_OK;
+            }
+        }
+
         amf::AMFComponentPtr converter;
-        AMF_RESULT result = g_AMFFactory.LoadExternalComponent(m_Context, FFMPEG_HELPER_DLL_NAME, "AMFCreateComponentInt", (void*)FFMPEG_AUDIO_CONVERTER, &converter);
+        result = g_AMFFactory.LoadExternalComponent(m_Context, FFMPEG_HELPER_DLL_NAME, "AMFCreateComponentInt", (void*)FFMPEG_AUDIO_CONVERTER, &converter);
         AMF_RETURN_IF_FAILED(result, L"LoadExternalComponent(%s) failed", FFMPEG_AUDIO_CONVERTER);
 
         //  Configure converter input
-        uint32_t inputSamplingRate = m_Input->GetSamplingRate();
         result = converter->SetProperty(AUDIO_CONVERTER_IN_AUDIO_SAMPLE_RATE, inputSamplingRate);
         AMF_RETURN_IF_FAILED(result, L"Failed to set input sampling rate %d on audio converter, result = %s", inputSamplingRate, amf::AMFGetResultText(result));
 
-        amf::AMF_AUDIO_FORMAT inputFormat = m_Input->GetOutputFormat();
         result = converter->SetProperty(AUDIO_CONVERTER_IN_AUDIO_SAMPLE_FORMAT, inputFormat);
         AMF_RETURN_IF_FAILED(result, L"Failed to set input format %d on audio converter, result = %s", inputFormat, amf::AMFGetResultText(result));
 
-        uint32_t inputChannels = m_Input->GetChannels();
         result = converter->SetProperty(AUDIO_CONVERTER_IN_AUDIO_CHANNELS, inputChannels);
         AMF_RETURN_IF_FAILED(result, L"Failed to set input channels %d on audio converter, result = %s", inputChannels, amf::AMFGetResultText(result));
 
-        uint32_t inputLayout = m_Input->GetLayout();
         result = converter->SetProperty(AUDIO_CONVERTER_IN_AUDIO_CHANNEL_LAYOUT, inputLayout);
         AMF_RETURN_IF_FAILED(result, L"Failed to set input channel layout %d on audio converter, result = %s", inputLayout, amf::AMFGetResultText(result));
 
         //  Configure converter output
-        int64_t streamBitRate;
-        int64_t outputSamplingRate;
-        int64_t outputChannels;
-        int64_t outputFormat;
-        int64_t outputLayout;
-        int64_t outputBlockAlign;
-
-        result = m_Presenter->GetDescription(streamBitRate, outputSamplingRate, outputChannels, outputFormat, outputLayout, outputBlockAlign);
-        AMF_RETURN_IF_FAILED(result, L"Failed get parameters of the audio presenter, result = %s", amf::AMFGetResultText(result));
-
         result = converter->SetProperty(AUDIO_CONVERTER_OUT_AUDIO_SAMPLE_RATE, outputSamplingRate);
         AMF_RETURN_IF_FAILED(result, L"Failed to set output sampling rate %lld on audio converter, result = %s", outputSamplingRate, amf::AMFGetResultText(result));
 
@@ -172,6 +197,7 @@ namespace ssdk::audio
             m_Input = nullptr;
             audioConverter = m_AudioConverter;
             m_AudioConverter = nullptr;
+            m_PCMConverter = nullptr;
         }
         if (audioInput != nullptr)
         {
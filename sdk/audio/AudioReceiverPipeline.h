@@ -34,6 +34,7 @@
 #pragma once
 
 #include "audio/AudioInput.h"
+#include "audio/PCMAudioConverter.h"
 #include "util/pipeline/AVPipeline.h"
 #include "transports/transport-common/Transport.h"
 #include "util/pipeline/PipelineSlot.h"
@@ -72,6 +73,7 @@ namespace ssdk::audio
 
         ssdk::audio::AudioInput::Ptr            m_Input;
         amf::AMFComponentPtr                    m_AudioConverter;
+        PCMAudioConverter::Ptr                  m_PCMConverter;     //  Used instead of m_AudioConverter when it supports the conversion
 
         AudioPresenterPtr                       m_Presenter;
         ssdk::util::AVSynchronizer::Ptr         m_AVSynchronizer;
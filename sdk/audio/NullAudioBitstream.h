@@ -0,0 +1,70 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace ssdk::audio
+{
+    //  Bitstream produced by NullAudioEncodeEngine and consumed by NullAudioDecodeEngine.
+    //  Every packet starts with a NullAudioPacketHeader followed by filler bytes up to m_PacketSize. All fields are little-endian.
+    constexpr const uint32_t NULL_AUDIO_PACKET_MAGIC = 0x4455414E;      //  'NAUD'
+    constexpr const uint32_t NULL_AUDIO_EXTRADATA_MAGIC = 0x5844414E;   //  'NADX'
+    constexpr const uint32_t NULL_AUDIO_BITSTREAM_VERSION = 1;
+
+#pragma pack(push, 1)
+    struct NullAudioPacketHeader
+    {
+        uint32_t    m_Magic;
+        uint32_t    m_PacketSize;       //  Size of the packet in bytes, including the header
+        uint64_t    m_SequenceNumber;
+        int64_t     m_Pts;
+        int64_t     m_EncodeTime;       //  amf_high_precision_clock() when the packet was produced
+        uint32_t    m_SampleCount;      //  Number of samples per channel the packet decodes to
+    };
+
+    struct NullAudioExtraData
+    {
+        uint32_t    m_Magic;
+        uint32_t    m_Version;
+        int32_t     m_SamplingRate;
+        int32_t     m_Channels;
+    };
+#pragma pack(pop)
+
+    constexpr const wchar_t* const NULL_AUDIO_SEQUENCE_NUMBER = L"NullAudioSequenceNumber";    //  int64: packet number embedded in the bitstream, set on decoded buffers
+    constexpr const wchar_t* const NULL_AUDIO_ENCODE_TIME = L"NullAudioEncodeTime";            //  amf_pts: time the packet was produced by the encoder, set on decoded buffers
+}
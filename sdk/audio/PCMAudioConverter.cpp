@@ -0,0 +1,175 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "PCMAudioConverter.h"
+#include "amf/public/common/TraceAdapter.h"
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::audio::PCMAudioConverter";
+
+namespace ssdk::audio
+{
+    PCMAudioConverter::PCMAudioConverter(amf::AMFContext* context) :
+        m_Context(context)
+    {
+    }
+
+    PCMAudioConverter::~PCMAudioConverter()
+    {
+        m_Context = nullptr;
+    }
+
+    bool PCMAudioConverter::IsSupported(const Format& input, const Format& output)
+    {
+        return ssdk::util::PCMConverter::IsSupported(input, output);
+    }
+
+    AMF_RESULT PCMAudioConverter::Init(const Format& input, const Format& output)
+    {
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Context != nullptr, AMF_FAIL, L"AMFContext passed to PCMAudioConverter must not be NULL");
+        m_Initialized = m_Converter.Init(input, output);
+        AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_SUPPORTED, L"PCMAudioConverter::Init(): unsupported conversion from format %d, %d Hz, %d channels, layout 0x%x to format %d, %d Hz, %d channels, layout 0x%x",
+                            input.format, input.samplingRate, input.channels, input.layout, output.format, output.samplingRate, output.channels, output.layout);
+        AMFTraceInfo(AMF_FACILITY, L"Audio converter initialized: format %d, %d Hz, %d channels -> format %d, %d Hz, %d channels",
+                     input.format, input.samplingRate, input.channels, output.format, output.samplingRate, output.channels);
+        return AMF_OK;
+    }
+
+    void PCMAudioConverter::Reset()
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_Converter.Reset();
+    }
+
+    AMF_RESULT PCMAudioConverter::Convert(amf::AMFAudioBuffer* input, amf::AMFAudioBuffer** output)
+    {
+        AMF_RETURN_IF_INVALID_POINTER(input, L"PCMAudioConverter::Convert(): input must not be NULL");
+        AMF_RETURN_IF_INVALID_POINTER(output, L"PCMAudioConverter::Convert(): output must not be NULL");
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"PCMAudioConverter::Convert(): converter not initialized");
+
+        const Format& inputFormat = m_Converter.GetInputFormat();
+        const Format& outputFormat = m_Converter.GetOutputFormat();
+        AMF_RETURN_IF_FALSE(input->GetSampleFormat() == inputFormat.format && input->GetChannelCount() == inputFormat.channels, AMF_INVALID_FORMAT,
+                            L"PCMAudioConverter::Convert(): input format %d with %d channels does not match the converter's input", input->GetSampleFormat(), input->GetChannelCount());
+        AMF_RESULT result = input->Convert(amf::AMF_MEMORY_HOST);
+        AMF_RETURN_IF_FAILED(result, L"PCMAudioConverter::Convert(): failed to map the input to host memory, result=%s", amf::AMFGetResultText(result));
+
+        size_t inputSampleCount = static_cast<size_t>(input->GetSampleCount());
+        size_t outputSampleCount = m_Converter.GetOutputSampleCount(inputSampleCount);
+        if (outputSampleCount == 0)
+        {   //  Downsampling a very short buffer, keep it in the resampler history
+            m_Converter.Convert(input->GetNative(), inputSampleCount, nullptr, 0);
+            return AMF_NEED_MORE_INPUT;
+        }
+        const amf_pts ptsOffset = m_Converter.GetOutputPtsOffset();     //  Depends on the resampler state before this input
+        amf::AMFAudioBufferPtr converted;
+        result = m_Context->AllocAudioBuffer(amf::AMF_MEMORY_HOST, outputFormat.format, static_cast<amf_int32>(outputSampleCount), outputFormat.samplingRate, outputFormat.channels, &converted);
+        AMF_RETURN_IF_FAILED(result, L"PCMAudioConverter::Convert(): failed to allocate an audio buffer for %llu samples, result=%s", static_cast<unsigned long long>(outputSampleCount), amf::AMFGetResultText(result));
+        m_Converter.Convert(input->GetNative(), inputSampleCount, converted->GetNative(), outputSampleCount);
+        input->CopyTo(converted, false);
+        converted->SetPts(input->GetPts() + ptsOffset);
+        converted->SetDuration(static_cast<amf_pts>(outputSampleCount) * AMF_SECOND / outputFormat.samplingRate);
+        *output = converted.Detach();
+        return AMF_OK;
+    }
+
+    PCMConverterSlot::PCMConverterSlot(const char* slotName, PCMAudioConverter::Ptr converter, ssdk::util::PipelineSlot::Ptr nextSlot) :
+        ssdk::util::PipelineSlot(slotName),
+        m_Converter(converter),
+        m_NextSlot(nextSlot)
+    {
+    }
+
+    PCMConverterSlot::~PCMConverterSlot()
+    {
+        Stop();
+    }
+
+    void PCMConverterSlot::Start()
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_Terminated = false;
+    }
+
+    void PCMConverterSlot::Stop()
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_Terminated = true;
+    }
+
+    AMF_RESULT PCMConverterSlot::SubmitInput(amf::AMFData* input)
+    {
+        AMF_RETURN_IF_FALSE(input != nullptr, AMF_INVALID_ARG, L"Input to slot \"%S\" should not be NULL", m_Name.c_str());
+        PCMAudioConverter::Ptr converter;
+        ssdk::util::PipelineSlot::Ptr nextSlot;
+        {
+            amf::AMFLock lock(&m_Guard);
+            if (m_Terminated == true)
+            {
+                return AMF_ACCESS_DENIED;
+            }
+            converter = m_Converter;
+            nextSlot = m_NextSlot;
+        }
+        AMF_RETURN_IF_FALSE(converter != nullptr, AMF_NOT_INITIALIZED, L"Converter is NULL in slot \"%S\"", m_Name.c_str());
+        AMF_RETURN_IF_FALSE(nextSlot != nullptr, AMF_NOT_INITIALIZED, L"Slot's \"%S\" sink is NULL", m_Name.c_str());
+
+        amf::AMFAudioBufferPtr audioBuffer(input);
+        AMF_RETURN_IF_FALSE(audioBuffer != nullptr, AMF_INVALID_DATA_TYPE, L"Input to slot \"%S\" is not an audio buffer", m_Name.c_str());
+        amf::AMFAudioBufferPtr output;
+        AMF_RESULT result = converter->Convert(audioBuffer, &output);
+        if (result == AMF_NEED_MORE_INPUT)
+        {
+            return AMF_OK;
+        }
+        else if (result != AMF_OK)
+        {
+            AMFTraceError(AMF_FACILITY, L"Failed to convert audio in slot \"%S\", result=%s", m_Name.c_str(), amf::AMFGetResultText(result));
+            return result;
+        }
+        return nextSlot->SubmitInput(output);
+    }
+
+    AMF_RESULT PCMConverterSlot::Flush()
+    {
+        amf::AMFLock lock(&m_Guard);
+        if (m_Converter != nullptr)
+        {
+            m_Converter->Reset();
+        }
+        return m_NextSlot != nullptr ? m_NextSlot->Flush() : AMF_OK;
+    }
+}
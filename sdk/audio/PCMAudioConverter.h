@@ -0,0 +1,100 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include "util/audio/PCMConverter.h"
+#include "util/pipeline/PipelineSlot.h"
+
+#include "amf/public/include/core/Context.h"
+#include "amf/public/common/Thread.h"
+
+#include <memory>
+
+namespace ssdk::audio
+{
+    //  PCMAudioConverter: converts AMFAudioBuffers inline with ssdk::util::PCMConverter. Used in place of the FFmpeg audio
+    //  converter component whenever the conversion is supported, avoiding a component hop and its extra buffer copies.
+    class PCMAudioConverter
+    {
+    public:
+        typedef std::shared_ptr<PCMAudioConverter>  Ptr;
+        typedef ssdk::util::PCMConverter::Format    Format;
+
+    public:
+        PCMAudioConverter(amf::AMFContext* context);
+        ~PCMAudioConverter();
+
+        static bool IsSupported(const Format& input, const Format& output);
+
+        AMF_RESULT Init(const Format& input, const Format& output);
+        void Reset();
+
+        //  Input must be in host memory in the input format passed to Init(). The output carries the input's pts and properties
+        AMF_RESULT Convert(amf::AMFAudioBuffer* input, amf::AMFAudioBuffer** output);
+
+    private:
+        mutable amf::AMFCriticalSection m_Guard;
+        amf::AMFContextPtr              m_Context;
+        ssdk::util::PCMConverter        m_Converter;
+        bool                            m_Initialized = false;
+    };
+
+    //  Pipeline slot running a PCMAudioConverter synchronously on the caller's thread
+    class PCMConverterSlot : public ssdk::util::PipelineSlot
+    {
+    public:
+        PCMConverterSlot(const char* slotName, PCMAudioConverter::Ptr converter, ssdk::util::PipelineSlot::Ptr nextSlot);
+        virtual ~PCMConverterSlot();
+
+        virtual void Start() override;
+        virtual void Stop() override;
+
+        virtual AMF_RESULT SubmitInput(amf::AMFData* input) override;
+        virtual AMF_RESULT Flush() override;
+
+    private:
+        mutable amf::AMFCriticalSection     m_Guard;
+        PCMAudioConverter::Ptr              m_Converter;
+        ssdk::util::PipelineSlot::Ptr       m_NextSlot;
+        bool                                m_Terminated = false;
+    };
+}
@@ -0,0 +1,141 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "NullAudioDecodeEngine.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#include <cstring>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::audio::NullAudioDecodeEngine";
+
+static constexpr const size_t MAX_OUTPUT_QUEUE_DEPTH = 16;
+
+namespace ssdk::audio
+{
+    NullAudioDecodeEngine::NullAudioDecodeEngine(amf::AMFContext* context) :
+        m_Context(context)
+    {
+    }
+
+    NullAudioDecodeEngine::~NullAudioDecodeEngine()
+    {
+        Terminate();
+        m_Context = nullptr;
+    }
+
+    AMF_RESULT NullAudioDecodeEngine::Init(amf::AMF_AUDIO_FORMAT format, int32_t channels, int32_t layout, int32_t samplingRate, amf::AMFBuffer* initBlock)
+    {
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Context != nullptr, AMF_FAIL, L"AMFContext passed to NullAudioDecodeEngine must not be NULL");
+        if (initBlock != nullptr)
+        {
+            AMF_RETURN_IF_FALSE(initBlock->GetSize() >= sizeof(NullAudioExtraData), AMF_INVALID_ARG, L"NullAudioDecodeEngine::Init(): init block is too small (%llu bytes)", static_cast<unsigned long long>(initBlock->GetSize()));
+            const NullAudioExtraData* extraData = static_cast<const NullAudioExtraData*>(initBlock->GetNative());
+            AMF_RETURN_IF_FALSE(extraData->m_Magic == NULL_AUDIO_EXTRADATA_MAGIC, AMF_INVALID_ARG, L"NullAudioDecodeEngine::Init(): init block was not produced by the null audio encoder");
+            AMF_RETURN_IF_FALSE(extraData->m_Version == NULL_AUDIO_BITSTREAM_VERSION, AMF_NOT_SUPPORTED, L"NullAudioDecodeEngine::Init(): unsupported bitstream version %u", extraData->m_Version);
+        }
+        AMF_RESULT result = AudioDecodeEngine::Init(format, channels, layout, samplingRate, initBlock);
+        AMF_RETURN_IF_FAILED(result, L"NullAudioDecodeEngine::Init(): audio decoder failed to initialize, result=%s", amf::AMFGetResultText(result));
+        m_OutputQueue.clear();
+        m_Initialized = true;
+        AMFTraceInfo(AMF_FACILITY, L"Null audio decoder initialized, sampling rate: %d, channels: %d", samplingRate, channels);
+        return AMF_OK;
+    }
+
+    void NullAudioDecodeEngine::Terminate()
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_OutputQueue.clear();
+        m_Initialized = false;
+    }
+
+    AMF_RESULT NullAudioDecodeEngine::SubmitInput(amf::AMFBuffer* input)
+    {
+        AMF_RETURN_IF_INVALID_POINTER(input, L"NullAudioDecodeEngine::SubmitInput(): input must not be NULL");
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"SubmitInput() failed, decoder not initialized");
+        if (m_OutputQueue.size() >= MAX_OUTPUT_QUEUE_DEPTH)
+        {
+            return AMF_INPUT_FULL;
+        }
+
+        NullAudioPacketHeader header;
+        AMF_RETURN_IF_FALSE(input->GetSize() >= sizeof(header), AMF_INVALID_DATA_TYPE, L"NullAudioDecodeEngine::SubmitInput(): packet is too small (%llu bytes)", static_cast<unsigned long long>(input->GetSize()));
+        memcpy(&header, input->GetNative(), sizeof(header));
+        AMF_RETURN_IF_FALSE(header.m_Magic == NULL_AUDIO_PACKET_MAGIC && header.m_PacketSize == input->GetSize(), AMF_INVALID_DATA_TYPE, L"NullAudioDecodeEngine::SubmitInput(): packet %lld is corrupt", input->GetPts());
+
+        amf::AMFAudioBufferPtr output;
+        AMF_RESULT result = m_Context->AllocAudioBuffer(amf::AMF_MEMORY_HOST, m_Format, static_cast<amf_int32>(header.m_SampleCount), m_SamplingRate, m_Channels, &output);
+        AMF_RETURN_IF_FAILED(result, L"NullAudioDecodeEngine::SubmitInput(): failed to allocate an audio buffer for %u samples, result=%s", header.m_SampleCount, amf::AMFGetResultText(result));
+        memset(output->GetNative(), 0, output->GetSize());
+        input->CopyTo(output, false);
+        output->SetPts(input->GetPts());
+        output->SetDuration(input->GetDuration());
+        output->SetProperty(NULL_AUDIO_SEQUENCE_NUMBER, static_cast<int64_t>(header.m_SequenceNumber));
+        output->SetProperty(NULL_AUDIO_ENCODE_TIME, header.m_EncodeTime);
+        m_OutputQueue.push_back(output);
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullAudioDecodeEngine::QueryOutput(amf::AMFAudioBuffer** outputBuffer)
+    {
+        AMF_RETURN_IF_INVALID_POINTER(outputBuffer, L"NullAudioDecodeEngine::QueryOutput(): output must not be NULL");
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"QueryOutput() failed, decoder not initialized");
+        if (m_OutputQueue.empty() == true)
+        {
+            return AMF_REPEAT;
+        }
+        *outputBuffer = m_OutputQueue.front().Detach();
+        m_OutputQueue.pop_front();
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullAudioDecodeEngine::Flush()
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_OutputQueue.clear();
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullAudioDecodeEngine::Drain()
+    {
+        return AMF_OK;
+    }
+
+    const char* NullAudioDecodeEngine::GetCodecName() const noexcept
+    {
+        return CODEC_NULL;
+    }
+}
@@ -0,0 +1,182 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "NullAudioEncodeEngine.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#include <algorithm>
+#include <cstring>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::audio::NullAudioEncodeEngine";
+
+static constexpr const size_t MAX_QUEUED_PACKETS = 16;
+
+namespace ssdk::audio
+{
+    NullAudioEncodeEngine::NullAudioEncodeEngine(amf::AMFContext* context) :
+        m_Context(context)
+    {
+    }
+
+    NullAudioEncodeEngine::~NullAudioEncodeEngine()
+    {
+        Terminate();
+        m_Context = nullptr;
+    }
+
+    AMF_RESULT NullAudioEncodeEngine::Init(int32_t samplingRate, int32_t channels, int32_t layout, int32_t bitrate)
+    {
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Context != nullptr, AMF_FAIL, L"AMFContext passed to NullAudioEncodeEngine must not be NULL");
+        AMF_RETURN_IF_FALSE(samplingRate > 0 && channels > 0, AMF_INVALID_ARG, L"NullAudioEncodeEngine::Init(): invalid sampling rate %d or channel count %d", samplingRate, channels);
+        AMF_RESULT result = AudioEncodeEngine::Init(channels, layout, samplingRate, bitrate);
+        AMF_RETURN_IF_FAILED(result, L"NullAudioEncodeEngine::Init(): audio encoder failed to initialize, result=%s", amf::AMFGetResultText(result));
+        m_Format = amf::AMFAF_S16;
+        m_OutputQueue.clear();
+        m_SequenceNumber = 0;
+        m_Initialized = true;
+        AMFTraceInfo(AMF_FACILITY, L"Null audio encoder initialized, sampling rate: %d, channels: %d, bitrate: %d", samplingRate, channels, bitrate);
+        return AMF_OK;
+    }
+
+    void NullAudioEncodeEngine::Terminate()
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_OutputQueue.clear();
+        m_Initialized = false;
+    }
+
+    AMF_RESULT NullAudioEncodeEngine::SubmitInput(amf::AMFAudioBuffer* input)
+    {
+        AMF_RETURN_IF_INVALID_POINTER(input, L"NullAudioEncodeEngine::SubmitInput(): input must not be NULL");
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"SubmitInput() failed, encoder not initialized");
+        if (m_OutputQueue.size() >= MAX_QUEUED_PACKETS)
+        {
+            return AMF_INPUT_FULL;
+        }
+
+        uint32_t sampleCount = static_cast<uint32_t>(input->GetSampleCount());
+        size_t packetSize = std::max(static_cast<size_t>(int64_t(m_Bitrate) * sampleCount / m_SamplingRate / 8), sizeof(NullAudioPacketHeader));
+        amf::AMFBufferPtr packet;
+        AMF_RESULT result = m_Context->AllocBuffer(amf::AMF_MEMORY_HOST, packetSize, &packet);
+        AMF_RETURN_IF_FAILED(result, L"NullAudioEncodeEngine::SubmitInput(): failed to allocate a %llu byte buffer, result=%s", static_cast<unsigned long long>(packetSize), amf::AMFGetResultText(result));
+
+        NullAudioPacketHeader header = {};
+        header.m_Magic = NULL_AUDIO_PACKET_MAGIC;
+        header.m_PacketSize = static_cast<uint32_t>(packetSize);
+        header.m_SequenceNumber = m_SequenceNumber++;
+        header.m_Pts = input->GetPts();
+        header.m_EncodeTime = amf_high_precision_clock();
+        header.m_SampleCount = sampleCount;
+        uint8_t* data = static_cast<uint8_t*>(packet->GetNative());
+        memcpy(data, &header, sizeof(header));
+        memset(data + sizeof(header), 0, packetSize - sizeof(header));
+
+        input->CopyTo(packet, false);
+        packet->SetPts(input->GetPts());
+        packet->SetDuration(input->GetDuration());
+        m_OutputQueue.push_back(packet);
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullAudioEncodeEngine::QueryOutput(amf::AMFBuffer** outputBuffer)
+    {
+        AMF_RETURN_IF_INVALID_POINTER(outputBuffer, L"NullAudioEncodeEngine::QueryOutput(): output must not be NULL");
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"QueryOutput() failed, encoder not initialized");
+        if (m_OutputQueue.empty() == true)
+        {
+            return AMF_REPEAT;
+        }
+        *outputBuffer = m_OutputQueue.front().Detach();
+        m_OutputQueue.pop_front();
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullAudioEncodeEngine::Flush()
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_OutputQueue.clear();
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullAudioEncodeEngine::Drain()
+    {
+        //  Output is produced synchronously in SubmitInput(), there is nothing to drain
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullAudioEncodeEngine::GetExtraData(amf::AMFBuffer** pExtraData) const
+    {
+        AMF_RETURN_IF_FALSE(pExtraData != nullptr, AMF_INVALID_ARG, L"GetExtraData(pExtraData) parameter must not be NULL");
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"Encoder is not initialized");
+        AMF_RESULT result = m_Context->AllocBuffer(amf::AMF_MEMORY_HOST, sizeof(NullAudioExtraData), pExtraData);
+        AMF_RETURN_IF_FAILED(result, L"Failed to allocate extra data buffer, result=%s", amf::AMFGetResultText(result));
+        NullAudioExtraData* extraData = static_cast<NullAudioExtraData*>((*pExtraData)->GetNative());
+        extraData->m_Magic = NULL_AUDIO_EXTRADATA_MAGIC;
+        extraData->m_Version = NULL_AUDIO_BITSTREAM_VERSION;
+        extraData->m_SamplingRate = m_SamplingRate;
+        extraData->m_Channels = m_Channels;
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullAudioEncodeEngine::SetProperty(const wchar_t* /*name*/, const amf::AMFVariant& /*value*/)
+    {
+        return AMF_NOT_FOUND;
+    }
+
+    AMF_RESULT NullAudioEncodeEngine::GetProperty(const wchar_t* /*name*/, amf::AMFVariant& /*value*/) const
+    {
+        return AMF_NOT_FOUND;
+    }
+
+    const char* NullAudioEncodeEngine::GetCodecName() const noexcept
+    {
+        return CODEC_NULL;
+    }
+
+    const char* NullAudioEncodeEngine::GetCodecID() const noexcept
+    {
+        return CODEC_ID_NULL;
+    }
+
+    AMF_RESULT NullAudioEncodeEngine::UpdateBitrate(int32_t bitrate)
+    {
+        AMF_RETURN_IF_FALSE(bitrate > 0, AMF_INVALID_ARG, L"UpdateBitrate(): invalid bitrate %d", bitrate);
+        amf::AMFLock lock(&m_Guard);
+        return AudioEncodeEngine::UpdateBitrate(bitrate);
+    }
+}
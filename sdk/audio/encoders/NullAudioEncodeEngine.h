@@ -0,0 +1,87 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include "AudioEncodeEngine.h"
+#include "../NullAudioBitstream.h"
+
+#include "amf/public/common/Thread.h"
+
+#include <deque>
+
+namespace ssdk::audio
+{
+    //  An audio encoder which does not depend on FFmpeg: every input buffer produces one packet whose size
+    //  matches the target bitrate and which carries a sequence number, the pts and the time it was produced.
+    class NullAudioEncodeEngine : public AudioEncodeEngine
+    {
+    public:
+        NullAudioEncodeEngine(amf::AMFContext* context);
+        virtual ~NullAudioEncodeEngine();
+
+        virtual AMF_RESULT Init(int32_t samplingRate, int32_t channels, int32_t layout, int32_t bitrate) override;
+        virtual void Terminate() override;
+
+        virtual AMF_RESULT SubmitInput(amf::AMFAudioBuffer* input) override;
+        virtual AMF_RESULT QueryOutput(amf::AMFBuffer** outputBuffer) override;
+        virtual AMF_RESULT Flush() override;
+        virtual AMF_RESULT Drain() override;
+
+        virtual AMF_RESULT GetExtraData(amf::AMFBuffer** pExtraData) const override;
+
+        virtual AMF_RESULT SetProperty(const wchar_t* name, const amf::AMFVariant& value) override;
+        virtual AMF_RESULT GetProperty(const wchar_t* name, amf::AMFVariant& value) const override;
+
+        virtual const char* GetCodecName() const noexcept override;
+        virtual const char* GetCodecID() const noexcept override;
+
+        virtual AMF_RESULT UpdateBitrate(int32_t bitrate) override;
+
+    private:
+        typedef std::deque<amf::AMFBufferPtr>   OutputQueue;
+
+        mutable amf::AMFCriticalSection m_Guard;
+        amf::AMFContextPtr      m_Context;
+        OutputQueue             m_OutputQueue;
+        uint64_t                m_SequenceNumber = 0;
+        bool                    m_Initialized = false;
+    };
+}
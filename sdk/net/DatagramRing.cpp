@@ -0,0 +1,571 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "DatagramRing.h"
+#include "amf/public/common/TraceAdapter.h"
+#include "amf/public/common/Thread.h"
+#include <algorithm>
+#include <memory>
+
+#if defined(__linux)
+#include <sys/mman.h>
+#include <netinet/in.h>
+#include <errno.h>
+#include <string.h>
+#include <atomic>
+#endif
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::net::DatagramRing";
+
+namespace ssdk::net
+{
+#if defined(__linux)
+    static constexpr const uint64_t CANCEL_USER_DATA = ~uint64_t(0);
+    static constexpr const int CANCEL_TIMEOUT_MS = 100;     //  How long a timed out batch may take to be cancelled before the ring is torn down
+    static constexpr const unsigned int RECEIVE_RING_ENTRIES = 8;
+    static constexpr const uint16_t RECEIVE_BUFFER_GROUP = 0;
+
+    static inline size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    //  Socket timeouts are in seconds and 0 means no timeout, like in Socket::Send()
+    static inline int ToTimeoutMs(int timeoutSec)
+    {
+        return timeoutSec > 0 ? timeoutSec * 1000 : -1;
+    }
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //  DatagramSendRing
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    DatagramSendRing::DatagramSendRing()
+    {
+    }
+
+    DatagramSendRing::~DatagramSendRing()
+    {
+#if defined(__linux)
+        m_Ring.Close();
+        if (m_Buffer != nullptr)
+        {
+            ::munmap(m_Buffer, BUFFER_SIZE);
+        }
+#endif
+    }
+
+    DatagramSendRing* DatagramSendRing::GetThreadInstance()
+    {
+#if defined(__linux)
+        //  A thread which fails to set up its ring keeps sending with select() and sendto()
+        static thread_local std::unique_ptr<DatagramSendRing> instance = []()
+        {
+            std::unique_ptr<DatagramSendRing> ring;
+            if (IoUring::IsAvailable() == true)
+            {
+                ring.reset(new DatagramSendRing());
+                if (ring->Init() == false)
+                {
+                    ring.reset();
+                }
+            }
+            return ring;
+        }();
+        return instance.get();
+#else
+        return nullptr;
+#endif
+    }
+
+#if defined(__linux)
+    bool DatagramSendRing::Init()
+    {
+        if (m_Buffer == nullptr)
+        {
+            void* buffer = ::mmap(nullptr, BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (buffer == MAP_FAILED)
+            {
+                return false;
+            }
+            m_Buffer = static_cast<uint8_t*>(buffer);
+            m_Pending.resize(MAX_BATCH);
+        }
+        if (m_Ring.Init(MAX_BATCH) == false)
+        {
+            return false;
+        }
+        //  Registration pins the buffer and counts against RLIMIT_MEMLOCK on older kernels, zero-copy sends work without it too
+        int result = m_Ring.RegisterBuffer(m_Buffer, BUFFER_SIZE);
+        m_BufferRegistered = result == 0;
+        if (m_BufferRegistered == false)
+        {
+            AMFTraceDebug(AMF_FACILITY, L"DatagramSendRing: buffer registration failed, errno=%d", -result);
+        }
+        m_SendZeroCopy = m_Ring.IsOpSupported(IoUring::OP_SEND_ZC);
+        m_SendMsgZeroCopy = m_Ring.IsOpSupported(IoUring::OP_SENDMSG_ZC);
+        return m_Ring.IsOpSupported(IORING_OP_SENDMSG) == true && m_Ring.IsOpSupported(IORING_OP_ASYNC_CANCEL) == true;
+    }
+
+    void DatagramSendRing::Reset()
+    {
+        //  Closing the ring cancels whatever the kernel still holds, the buffer is kept
+        m_Ring.Close();
+        m_PendingCount = 0;
+        m_BufferUsed = 0;
+        m_TimeoutSec = 0;
+        if (Init() == false)
+        {
+            AMFTraceError(AMF_FACILITY, L"DatagramSendRing: failed to recreate the ring");
+        }
+    }
+#endif
+
+    Socket::Result DatagramSendRing::Add(DatagramSocket* socket, const void* buf, size_t size, const Socket::Address& to, int flags, Socket::TrafficClass trafficClass)
+    {
+#if defined(__linux)
+        Socket::Result result = Socket::Result::OK;
+        if (socket == nullptr || buf == nullptr || size == 0)
+        {
+            result = Socket::Result::INVALID_ARG;
+            AMFTraceError(AMF_FACILITY, L"Add() err=%s", Socket::GetErrorString(result));
+            return result;
+        }
+        else if (socket->GetNativeHandle() == INVALID_SOCKET)
+        {
+            result = Socket::Result::SOCKET_NOT_OPEN;
+            AMFTraceError(AMF_FACILITY, L"Add() err=%s", Socket::GetErrorString(result));
+            return result;
+        }
+        else if (to.GetAddressFamily() != socket->GetAddressFamily())
+        {
+            result = Socket::Result::INVALID_ARG;
+            AMFTraceError(AMF_FACILITY, L"Add() invalid address family err=%s", Socket::GetErrorString(result));
+            return result;
+        }
+        else if (size > BUFFER_SIZE)
+        {
+            return Socket::Result::MESSAGE_TOO_BIG;
+        }
+
+        size_t offset = AlignUp(m_BufferUsed, alignof(std::max_align_t));
+        if (m_PendingCount == MAX_BATCH || offset + size > BUFFER_SIZE)
+        {
+            if ((result = Flush()) != Socket::Result::OK)
+            {
+                return result;
+            }
+            offset = 0;
+        }
+        io_uring_sqe* sqe = m_Ring.GetSqe();
+        if (sqe == nullptr)
+        {   //  The ring could not be recreated after an error
+            return Socket::Result::NO_BUFFER_SPACE;
+        }
+
+        uint8_t* data = m_Buffer + offset;
+        memcpy(data, buf, size);
+        m_BufferUsed = offset + size;
+
+        Pending& pending = m_Pending[m_PendingCount];
+        memcpy(&pending.m_To, &to.ToSockAddr(), to.GetSize());
+
+        bool marked = trafficClass != socket->GetTrafficClass() &&
+                      (socket->GetAddressFamily() == Socket::AddressFamily::ADDR_IP || socket->GetAddressFamily() == Socket::AddressFamily::ADDR_IP6);
+        bool zeroCopy = size >= ZERO_COPY_THRESHOLD && (marked == true ? m_SendMsgZeroCopy : m_SendZeroCopy);
+
+        sqe->fd = socket->GetNativeHandle();
+        sqe->msg_flags = (uint32_t)flags;
+        sqe->user_data = m_PendingCount;
+        if (zeroCopy == true && marked == false)
+        {   //  The destination goes with the entry itself, no msghdr to set up
+            sqe->opcode = IoUring::OP_SEND_ZC;
+            sqe->addr = reinterpret_cast<uint64_t>(data);
+            sqe->len = (uint32_t)size;
+            sqe->addr2 = reinterpret_cast<uint64_t>(&pending.m_To);
+            IoUring::SetAddrLen(sqe, (uint16_t)to.GetSize());
+            if (m_BufferRegistered == true)
+            {
+                sqe->ioprio |= IORING_RECVSEND_FIXED_BUF;
+                sqe->buf_index = 0;
+            }
+        }
+        else
+        {
+            pending.m_Iov = { data, size };
+            pending.m_Msg = {};
+            pending.m_Msg.msg_name = &pending.m_To;
+            pending.m_Msg.msg_namelen = (socklen_t)to.GetSize();
+            pending.m_Msg.msg_iov = &pending.m_Iov;
+            pending.m_Msg.msg_iovlen = 1;
+            if (marked == true)
+            {   //  Same as DatagramSocket::SendTo(): mark just this datagram
+                memset(pending.m_Control, 0, sizeof(pending.m_Control));
+                pending.m_Msg.msg_control = pending.m_Control;
+                pending.m_Msg.msg_controllen = sizeof(pending.m_Control);
+                cmsghdr* cmsg = CMSG_FIRSTHDR(&pending.m_Msg);
+                cmsg->cmsg_level = socket->GetAddressFamily() == Socket::AddressFamily::ADDR_IP ? IPPROTO_IP : IPPROTO_IPV6;
+                cmsg->cmsg_type = socket->GetAddressFamily() == Socket::AddressFamily::ADDR_IP ? IP_TOS : IPV6_TCLASS;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+                int tos = Socket::GetTypeOfService(trafficClass);
+                memcpy(CMSG_DATA(cmsg), &tos, sizeof(tos));
+            }
+            sqe->opcode = zeroCopy == true ? IoUring::OP_SENDMSG_ZC : (uint8_t)IORING_OP_SENDMSG;
+            sqe->addr = reinterpret_cast<uint64_t>(&pending.m_Msg);
+            sqe->len = 1;
+        }
+        m_TimeoutSec = std::max(m_TimeoutSec, socket->GetTimeout());
+        ++m_PendingCount;
+        return result;
+#else
+        (void)socket; (void)buf; (void)size; (void)to; (void)flags; (void)trafficClass;
+        return Socket::Result::OPERATION_NOT_SUPPORTED;
+#endif
+    }
+
+    Socket::Result DatagramSendRing::Flush()
+    {
+#if defined(__linux)
+        if (m_PendingCount == 0)
+        {
+            return Socket::Result::OK;
+        }
+        unsigned int batch = (unsigned int)m_PendingCount;
+        int timeoutMs = ToTimeoutMs(m_TimeoutSec);
+        m_PendingCount = 0;
+        m_BufferUsed = 0;
+        m_TimeoutSec = 0;
+
+        int submitted = m_Ring.Submit(batch, timeoutMs);
+        if (submitted < 0)
+        {
+            Socket::Result result = DatagramSocket::GetError(-submitted);
+            AMFTraceError(AMF_FACILITY, L"Flush() io_uring_enter() failed err=%s", Socket::GetErrorString(result));
+            Reset();
+            return result;
+        }
+        Socket::Result result = Complete((unsigned int)submitted, timeoutMs);
+        if (result == Socket::Result::OK && (unsigned int)submitted < batch)
+        {
+            result = Socket::Result::NO_BUFFER_SPACE;
+        }
+        if ((unsigned int)submitted < batch)
+        {   //  Drop the entries the kernel did not take
+            Reset();
+        }
+        return result;
+#else
+        return Socket::Result::OPERATION_NOT_SUPPORTED;
+#endif
+    }
+
+#if defined(__linux)
+    Socket::Result DatagramSendRing::Complete(unsigned int inFlight, int timeoutMs)
+    {
+        Socket::Result result = Socket::Result::OK;
+        amf_pts deadline = timeoutMs >= 0 ? amf_high_precision_clock() + timeoutMs * AMF_MILLISECOND : 0;
+        bool cancelled = false;
+        while (inFlight > 0)
+        {
+            io_uring_cqe* cqe = nullptr;
+            while (inFlight > 0 && (cqe = m_Ring.PeekCqe()) != nullptr)
+            {
+                //  A zero-copy send completes twice: when it is queued, with IORING_CQE_F_MORE set, and when the kernel
+                //  no longer needs the buffer, with IORING_CQE_F_NOTIF
+                if ((cqe->flags & IORING_CQE_F_NOTIF) == 0 && cqe->user_data != CANCEL_USER_DATA && cqe->res < 0 && result == Socket::Result::OK)
+                {
+                    result = cqe->res == -ECANCELED ? Socket::Result::CONNECTION_TIMEOUT : DatagramSocket::GetError(-cqe->res);
+                    AMFTraceError(AMF_FACILITY, L"Flush() send failed err=%s", Socket::GetErrorString(result));
+                }
+                if ((cqe->flags & IORING_CQE_F_MORE) != 0)
+                {
+                    ++inFlight;
+                }
+                --inFlight;
+                m_Ring.SeenCqe();
+            }
+            if (inFlight == 0)
+            {
+                break;
+            }
+
+            int waitMs = -1;
+            if (deadline != 0)
+            {
+                amf_pts now = amf_high_precision_clock();
+                waitMs = now < deadline ? int((deadline - now + AMF_MILLISECOND - 1) / AMF_MILLISECOND) : 0;
+            }
+            if (waitMs == 0)
+            {
+                if (cancelled == true)
+                {
+                    AMFTraceError(AMF_FACILITY, L"Flush() timed out sends could not be cancelled, recreating the ring");
+                    Reset();
+                    break;
+                }
+                //  The sockets are not writable, take back what has not been sent yet
+                AMFTraceWarning(AMF_FACILITY, L"Send timed out");
+                if (result == Socket::Result::OK)
+                {
+                    result = Socket::Result::CONNECTION_TIMEOUT;
+                }
+                io_uring_sqe* sqe = m_Ring.GetSqe();
+                if (sqe == nullptr)
+                {   //  Closing the ring cancels them as well
+                    Reset();
+                    break;
+                }
+                sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                sqe->fd = -1;
+                sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+                sqe->user_data = CANCEL_USER_DATA;
+                ++inFlight;
+                cancelled = true;
+                deadline = amf_high_precision_clock() + CANCEL_TIMEOUT_MS * AMF_MILLISECOND;
+                waitMs = CANCEL_TIMEOUT_MS;
+            }
+            if (m_Ring.Submit(1, waitMs) < 0)
+            {
+                result = result == Socket::Result::OK ? Socket::Result::UNKNOWN_ERROR : result;
+                Reset();
+                break;
+            }
+        }
+        return result;
+    }
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //  DatagramReceiveRing
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    DatagramReceiveRing::DatagramReceiveRing()
+    {
+    }
+
+    DatagramReceiveRing::~DatagramReceiveRing()
+    {
+        Close();
+    }
+
+    Socket::Result DatagramReceiveRing::Init(DatagramSocket* socket, size_t maxDatagramSize)
+    {
+#if defined(__linux)
+        Close();
+        if (socket == nullptr || maxDatagramSize == 0)
+        {
+            return Socket::Result::INVALID_ARG;
+        }
+        if (IoUring::IsAvailable() == false || m_Ring.Init(RECEIVE_RING_ENTRIES) == false || m_Ring.IsOpSupported(IORING_OP_RECVMSG) == false)
+        {
+            Close();
+            return Socket::Result::OPERATION_NOT_SUPPORTED;
+        }
+
+        //  Each buffer receives an io_uring_recvmsg_out header, then msg_namelen bytes for the address and msg_controllen bytes
+        //  for the ancillary data, whether they are used or not, and then the payload
+        m_Msg = {};
+        m_Msg.msg_namelen = sizeof(sockaddr_storage);
+        m_Msg.msg_controllen = socket->m_CountReceiveDrops == true ? CMSG_SPACE(sizeof(uint32_t)) : 0;
+        m_BufferSize = AlignUp(sizeof(IoUring::RecvMsgOut) + m_Msg.msg_namelen + m_Msg.msg_controllen + maxDatagramSize, 64);
+        m_BuffersSize = m_BufferSize * BUFFER_COUNT;
+        void* buffers = ::mmap(nullptr, m_BuffersSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (buffers == MAP_FAILED)
+        {
+            Close();
+            return Socket::Result::NO_BUFFER_SPACE;
+        }
+        m_Buffers = static_cast<uint8_t*>(buffers);
+
+        if ((m_BufferRing = m_Ring.RegisterBufferRing(RECEIVE_BUFFER_GROUP, BUFFER_COUNT)) == nullptr)
+        {
+            Close();
+            return Socket::Result::OPERATION_NOT_SUPPORTED;
+        }
+        m_BufferTail = 0;
+        for (unsigned int i = 0; i < BUFFER_COUNT; ++i)
+        {
+            ProvideBuffer(uint16_t(i));
+        }
+        PublishBuffers();
+        m_Socket = socket;
+        return Socket::Result::OK;
+#else
+        (void)socket; (void)maxDatagramSize;
+        return Socket::Result::OPERATION_NOT_SUPPORTED;
+#endif
+    }
+
+    void DatagramReceiveRing::Close()
+    {
+#if defined(__linux)
+        m_Ring.Close();
+        m_BufferRing = nullptr;
+        if (m_Buffers != nullptr)
+        {
+            ::munmap(m_Buffers, m_BuffersSize);
+            m_Buffers = nullptr;
+        }
+        m_Armed = false;
+        m_Received = false;
+#endif
+        m_Socket = nullptr;
+    }
+
+#if defined(__linux)
+    bool DatagramReceiveRing::Arm()
+    {
+        io_uring_sqe* sqe = m_Ring.GetSqe();
+        if (sqe == nullptr)
+        {
+            return false;
+        }
+        sqe->opcode = IORING_OP_RECVMSG;
+        sqe->fd = m_Socket->GetNativeHandle();
+        sqe->addr = reinterpret_cast<uint64_t>(&m_Msg);
+        sqe->len = 1;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = RECEIVE_BUFFER_GROUP;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        m_Armed = true;
+        return true;
+    }
+
+    void DatagramReceiveRing::ProvideBuffer(uint16_t id)
+    {
+        //  Only the address, length and ID: the tail the kernel reads shares its location with the reserved field of entry 0
+        IoUring::Buffer* buf = m_BufferRing + (m_BufferTail & (BUFFER_COUNT - 1));
+        buf->addr = reinterpret_cast<uint64_t>(m_Buffers + size_t(id) * m_BufferSize);
+        buf->len = (uint32_t)m_BufferSize;
+        buf->bid = id;
+        ++m_BufferTail;
+    }
+
+    void DatagramReceiveRing::PublishBuffers()
+    {
+        std::atomic_ref<uint16_t>(m_BufferRing[0].resv).store(m_BufferTail, std::memory_order_release);
+    }
+#endif
+
+    Socket::Result DatagramReceiveRing::Receive(int timeoutMs, const Handler& handler, size_t* received)
+    {
+#if defined(__linux)
+        if (IsOpen() == false)
+        {
+            return Socket::Result::SOCKET_NOT_OPEN;
+        }
+        if (m_Armed == false && Arm() == false)
+        {
+            return Socket::Result::NO_BUFFER_SPACE;
+        }
+        int submitted = m_Ring.Submit(1, timeoutMs);
+        if (submitted < 0)
+        {
+            Socket::Result result = DatagramSocket::GetError(-submitted);
+            AMFTraceError(AMF_FACILITY, L"Receive() io_uring_enter() failed err=%s", Socket::GetErrorString(result));
+            return result;
+        }
+
+        Socket::Result result = Socket::Result::OK;
+        size_t count = 0;
+        io_uring_cqe* cqe = nullptr;
+        while ((cqe = m_Ring.PeekCqe()) != nullptr)
+        {
+            if ((cqe->flags & IORING_CQE_F_MORE) == 0)
+            {   //  The multishot receive has ended, for example because all buffers were in use. Re-armed on the next call
+                m_Armed = false;
+            }
+            if (cqe->res >= 0 && (cqe->flags & IORING_CQE_F_BUFFER) != 0)
+            {
+                m_Received = true;
+                uint16_t id = uint16_t(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+                uint8_t* buf = m_Buffers + size_t(id) * m_BufferSize;
+                const IoUring::RecvMsgOut* out = reinterpret_cast<const IoUring::RecvMsgOut*>(buf);
+                uint8_t* name = buf + sizeof(IoUring::RecvMsgOut);
+                uint8_t* control = name + m_Msg.msg_namelen;
+                uint8_t* payload = control + m_Msg.msg_controllen;
+                //  Like recvfrom(), a datagram larger than the buffer is truncated
+                size_t payloadSize = std::min<size_t>(out->payloadlen, size_t(cqe->res) - size_t(payload - buf));
+
+                Socket::Address from;
+                memcpy(&from.ToSockAddr(), name, std::min<size_t>(out->namelen, sizeof(sockaddr_storage)));
+
+                if (out->controllen > 0)
+                {
+                    msghdr msg = {};
+                    msg.msg_control = control;
+                    msg.msg_controllen = std::min<size_t>(out->controllen, m_Msg.msg_controllen);
+                    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg))
+                    {
+                        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+                        {
+                            uint32_t drops = 0;
+                            memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+                            m_Socket->m_ReceiveDrops = drops;
+                        }
+                    }
+                }
+
+                handler(payload, payloadSize, from);
+                ++count;
+                ProvideBuffer(id);
+            }
+            else if (cqe->res == -EINVAL && m_Received == false)
+            {   //  Multishot receive requires Linux 6.0
+                result = Socket::Result::OPERATION_NOT_SUPPORTED;
+            }
+            else if (cqe->res < 0 && cqe->res != -ENOBUFS && result == Socket::Result::OK)
+            {
+                result = DatagramSocket::GetError(-cqe->res);
+                AMFTraceError(AMF_FACILITY, L"Receive() recvmsg failed err=%s", Socket::GetErrorString(result));
+            }
+            m_Ring.SeenCqe();
+        }
+        PublishBuffers();
+
+        if (received != nullptr)
+        {
+            *received = count;
+        }
+        return result;
+#else
+        (void)timeoutMs; (void)handler;
+        if (received != nullptr)
+        {
+            *received = 0;
+        }
+        return Socket::Result::OPERATION_NOT_SUPPORTED;
+#endif
+    }
+}
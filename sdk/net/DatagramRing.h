@@ -0,0 +1,159 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+#pragma once
+
+#include "DatagramSocket.h"
+#include "IoUring.h"
+#include <functional>
+#include <vector>
+
+#if defined(__linux)
+#include <sys/socket.h>
+#endif
+
+namespace ssdk::net
+{
+    //  DatagramSendRing - sends a batch of datagrams with a single io_uring_enter() instead of a select() and a sendto()
+    //  per datagram. Every datagram is copied into a buffer registered with the ring when it is added, large ones are
+    //  sent from there with IORING_OP_SEND_ZC where the kernel supports it.
+    //
+    //  One instance per thread, see GetThreadInstance(). Flush() waits until the kernel is done with every datagram of
+    //  the batch, so the caller can reuse its buffers as soon as Add() returns
+    class DatagramSendRing
+    {
+    public:
+        static constexpr const size_t BUFFER_SIZE = 1024 * 1024;           //  Datagrams a batch can hold, a full buffer is flushed by Add()
+        static constexpr const unsigned int MAX_BATCH = 256;
+        static constexpr const size_t ZERO_COPY_THRESHOLD = 8 * 1024;      //  Smaller datagrams are cheaper to copy than to pin
+
+    public:
+        ~DatagramSendRing();
+
+        static DatagramSendRing* GetThreadInstance();   //  nullptr when io_uring is not available, send with DatagramSocket::SendTo() instead
+
+        //  Errors of datagrams added earlier are only reported by the Add() or Flush() which sends them
+        Socket::Result Add(DatagramSocket* socket, const void* buf, size_t size, const Socket::Address& to, int flags = 0,
+                           Socket::TrafficClass trafficClass = Socket::TrafficClass::BEST_EFFORT);
+        Socket::Result Flush();                         //  Sends everything added since the last Flush() and returns the first error.
+                                                        //  Fails with CONNECTION_TIMEOUT when the sockets are not writable within their timeout
+
+        inline size_t GetPendingCount() const noexcept { return m_PendingCount; }
+#if defined(__linux)
+        inline uint64_t GetSyscallCount() const noexcept { return m_Ring.GetEnterCount(); }
+#else
+        inline uint64_t GetSyscallCount() const noexcept { return 0; }
+#endif
+
+    private:
+        DatagramSendRing();
+        DatagramSendRing(const DatagramSendRing&) = delete;
+        DatagramSendRing& operator=(const DatagramSendRing&) = delete;
+
+#if defined(__linux)
+        bool Init();
+        void Reset();
+        Socket::Result Complete(unsigned int inFlight, int timeoutMs);
+
+    private:
+        struct Pending
+        {
+            msghdr              m_Msg;
+            iovec               m_Iov;
+            sockaddr_storage    m_To;
+            alignas(cmsghdr) uint8_t m_Control[CMSG_SPACE(sizeof(int))];
+        };
+
+        IoUring                 m_Ring;
+        uint8_t*                m_Buffer = nullptr;
+        size_t                  m_BufferUsed = 0;
+        bool                    m_BufferRegistered = false;
+        bool                    m_SendZeroCopy = false;     //  IORING_OP_SEND_ZC, Linux 6.0
+        bool                    m_SendMsgZeroCopy = false;  //  IORING_OP_SENDMSG_ZC, Linux 6.1
+        std::vector<Pending>    m_Pending;
+        int                     m_TimeoutSec = 0;           //  The longest timeout of the sockets in the batch
+#endif
+        size_t                  m_PendingCount = 0;
+    };
+
+    //  DatagramReceiveRing - receives datagrams with a multishot IORING_OP_RECVMSG into a ring of buffers provided to the
+    //  kernel, so that a single io_uring_enter() returns every datagram which arrived since the previous one
+    class DatagramReceiveRing
+    {
+    public:
+        typedef std::function<void(uint8_t* buf, size_t size, const Socket::Address& from)> Handler;
+
+        static constexpr const unsigned int BUFFER_COUNT = 64;
+
+    public:
+        DatagramReceiveRing();
+        ~DatagramReceiveRing();
+
+        Socket::Result Init(DatagramSocket* socket, size_t maxDatagramSize);    //  OPERATION_NOT_SUPPORTED when io_uring or any of the features is not available
+        void Close();
+        inline bool IsOpen() const noexcept { return m_Socket != nullptr; }
+
+        //  Waits up to timeoutMs for datagrams and passes each one to handler, which may modify it but must not keep it.
+        //  Returns OK when the timeout elapses without datagrams, OPERATION_NOT_SUPPORTED when the kernel rejects multishot receive
+        Socket::Result Receive(int timeoutMs, const Handler& handler, size_t* received = nullptr);
+
+#if defined(__linux)
+        inline uint64_t GetSyscallCount() const noexcept { return m_Ring.GetEnterCount(); }
+#else
+        inline uint64_t GetSyscallCount() const noexcept { return 0; }
+#endif
+
+    private:
+        DatagramReceiveRing(const DatagramReceiveRing&) = delete;
+        DatagramReceiveRing& operator=(const DatagramReceiveRing&) = delete;
+
+#if defined(__linux)
+        bool Arm();
+        void ProvideBuffer(uint16_t id);                    //  Hands the buffer back to the kernel on the next PublishBuffers()
+        void PublishBuffers();
+
+    private:
+        IoUring                 m_Ring;
+        IoUring::Buffer*        m_BufferRing = nullptr;
+        uint16_t                m_BufferTail = 0;
+        uint8_t*                m_Buffers = nullptr;
+        size_t                  m_BuffersSize = 0;
+        size_t                  m_BufferSize = 0;
+        msghdr                  m_Msg = {};                 //  Tells the kernel how to lay out the name, control data and payload in each buffer
+        bool                    m_Armed = false;
+        bool                    m_Received = false;         //  Multishot receive has delivered at least once, so the kernel supports it
+#endif
+        DatagramSocket::Ptr     m_Socket;
+    };
+}
@@ -56,31 +56,137 @@ namespace ssdk::net
 
     }
 
-    void DatagramServer::SelectorTimeout()
+    void DatagramServer::ScheduleSessionTimers(const DatagramServerSession::Ptr& session)
     {
-        DatagramServerSession::Ptr session;
+        SessionTimers& timers = m_SessionTimers[session];
+        timers.m_Tick = m_Timers.Schedule(COMM_SELECTOR_FLUSH_INTERVAL_IN_MS * AMF_MILLISECOND, [this, session]() { OnSessionTick(session); },
+                                          COMM_SELECTOR_FLUSH_INTERVAL_IN_MS * AMF_MILLISECOND);
+        timers.m_Expiry = m_Timers.Schedule(m_DisconnectTimeout * AMF_SECOND, [this, session]() { OnSessionExpiry(session); });
+    }
+
+    void DatagramServer::OnSessionTick(const DatagramServerSession::Ptr& session)
+    {
+        if (session->IsTerminated() == true)
+        {
+            RemoveSession(session, true);
+        }
+        else if (session->GetElapsedTimeSinceLastRequest() < m_DisconnectTimeout)
+        {
+            session->OnTickNotify();
+        }
+    }
+
+    void DatagramServer::OnSessionExpiry(const DatagramServerSession::Ptr& session)
+    {
+        SessionTimerMap::iterator it = m_SessionTimers.find(session);
+        if (it == m_SessionTimers.end())
+        {
+            return;
+        }
+
+        time_t elapsed = session->GetElapsedTimeSinceLastRequest();
+        if (elapsed > m_DisconnectTimeout && m_sessionTimeoutEnabled == true)
+        {
+            AMFTraceInfo(AMF_FACILITY, L"Session timed out");
+            session->OnSessionTimeout();
+            RemoveSession(session, false);
+        }
+        else
+        {   //  The session has been touched since the timer was set, check again when it could expire at the earliest
+            time_t remaining = elapsed <= m_DisconnectTimeout ? m_DisconnectTimeout - elapsed + 1 : m_DisconnectTimeout;
+            it->second.m_Expiry = m_Timers.Schedule(remaining * AMF_SECOND, [this, session]() { OnSessionExpiry(session); });
+        }
+    }
+
+    void DatagramServer::RemoveSession(Session* session, bool close)
+    {
+        SessionTimerMap::iterator it = m_SessionTimers.find(session);
+        if (it != m_SessionTimers.end())
+        {
+            m_Timers.Cancel(it->second.m_Tick);
+            m_Timers.Cancel(it->second.m_Expiry);
+            m_SessionTimers.erase(it);
+        }
+        if (m_Sessions.erase(Session::Ptr(session)) > 0 && close == true)
+        {
+            session->OnSessionClose();
+        }
+    }
 
-        for (SessionSet::const_iterator sessionIt = m_Sessions.begin(); sessionIt != m_Sessions.end(); ++sessionIt)
+    void DatagramServer::Post(const DatagramServerSession::Ptr& session, const uint8_t* datagram, size_t size, const Socket::Address& receivedFrom, DatagramServer* receivedBy)
+    {
+        InboxItem item;
+        item.m_Session = session;
+        item.m_HandOver = datagram == nullptr;
+        if (datagram != nullptr)
         {
-            session = DatagramServerSession::Ptr(*sessionIt);
-            if (session->GetElapsedTimeSinceLastRequest() < m_DisconnectTimeout)
+            item.m_Datagram.assign(datagram, datagram + size);
+        }
+        item.m_ReceivedFrom = receivedFrom;
+        item.m_ReceivedBy = receivedBy;
+
+        amf::AMFLock lock(&m_InboxGuard);
+        m_Inbox.push_back(std::move(item));
+        m_InboxPending = true;
+    }
+
+    void DatagramServer::ProcessInbox()
+    {
+        if (m_InboxPending == true)
+        {
+            std::vector<InboxItem> inbox;
             {
-                session->OnTickNotify();
+                amf::AMFLock lock(&m_InboxGuard);
+                inbox.swap(m_Inbox);
+                m_InboxPending = false;
             }
-            else
+            for (InboxItem& item : inbox)
             {
-                 // Nothing to do here.
+                if (item.m_HandOver == true)
+                {   //  Handed over by the server the session used to live in, which no longer runs it
+                    AMFTraceInfo(AMF_FACILITY, L"Migrated session taken over from another receive shard");
+                    if (RegisterSession(item.m_Session) == SessionManager::Result::OK)
+                    {
+                        ScheduleSessionTimers(item.m_Session);
+                    }
+                }
+                else if (item.m_Session->GetOwner() == this && m_Sessions.find(Session::Ptr(item.m_Session)) != m_Sessions.end())
+                {
+                    ProcessMigratingDatagram(item.m_Session, item.m_Datagram.data(), item.m_Datagram.size(), item.m_ReceivedFrom, item.m_ReceivedBy);
+                }
+            }
+        }
+    }
+
+    void DatagramServer::ProcessMigratingDatagram(const DatagramServerSession::Ptr& session, uint8_t* buf, size_t size, const Socket::Address& receivedFrom, DatagramServer* receivedBy)
+    {
+        if (session->ValidatePeerAddress(buf, size, receivedFrom) == true)
+        {
+            session->Touch();
+            session->OnDataReceived(buf, size, receivedFrom);
+            if (receivedBy != this)
+            {   //  The client is now hashed to the server which received the datagram, its thread runs the session from here on
+                RemoveSession(session, false);
+                session->m_Owner = receivedBy;
+                receivedBy->Post(session, nullptr, 0, receivedFrom, this);
             }
         }
     }
 
     SessionManager::Result DatagramServer::ProcessIncomingMessages(uint8_t* buf)
     {
-        SessionManager::Result res = SessionManager::Result::OK;
-		DatagramServerSession::Ptr session;
 		size_t bytesReceived = 0;
 		Socket::Address receivedFrom;
 		Socket::Result sockResult = m_Socket->ReceiveFrom(buf, m_ReceiveBufferSize, &receivedFrom, &bytesReceived);
+        return ProcessDatagram(buf, bytesReceived, receivedFrom, sockResult);
+    }
+
+    SessionManager::Result DatagramServer::ProcessDatagram(uint8_t* buf, size_t bytesReceived, const Socket::Address& receivedFrom, Socket::Result sockResult)
+    {
+        SessionManager::Result res = SessionManager::Result::OK;
+		DatagramServerSession::Ptr session;
+        DatagramServerSession::ConnectionID connectionID = DatagramServerSession::INVALID_CONNECTION_ID;
+        bool hasConnectionID = bytesReceived > 0 && ExtractConnectionID(buf, bytesReceived, connectionID) == true;
 
         bool sessionFound = false;
         // If during the terminte process, return SERVER_SHUTDOWN - used to be SESSION_CREATE_FAILED.
@@ -91,6 +197,7 @@ namespace ssdk::net
         }
         else
         {
+            ProcessInbox();     //  A session handed over to this server has to be known before its datagrams are looked up
             for (SessionSet::const_iterator sessionIt = m_Sessions.begin(); sessionIt != m_Sessions.end(); ++sessionIt)
             {
                 if ((*sessionIt)->GetPeerAddress() == receivedFrom)
@@ -101,6 +208,25 @@ namespace ssdk::net
                 }
             }
 
+            //  The peer address of the session has changed (NAT rebinding, roaming), or the session lives in another receive shard
+            if (sessionFound == false && hasConnectionID == true)
+            {
+                DatagramServerSession::Ptr migrating = FindSession(connectionID);
+                if (migrating != nullptr && migrating->IsTerminated() == false)
+                {
+                    sessionFound = true;    //  Never create a new session for a datagram of an existing connection
+                    DatagramServer* owner = migrating->GetOwner();
+                    if (owner == this)
+                    {
+                        ProcessMigratingDatagram(migrating, buf, bytesReceived, receivedFrom, this);
+                    }
+                    else if (owner != nullptr && bytesReceived > 0)
+                    {
+                        owner->Post(migrating, buf, bytesReceived, receivedFrom, this);
+                    }
+                }
+            }
+
             if (bytesReceived > 0)
             {
                 //  Find the session the datagram should be routed to based on the From address if it exists
@@ -118,6 +244,11 @@ namespace ssdk::net
                                 AMFTraceError(AMF_FACILITY, L"Failed to register session");
                                 session = nullptr;
                             }
+                            else
+                            {
+                                session->m_Owner = this;
+                                ScheduleSessionTimers(session);
+                            }
                         }
                         else
                         {
@@ -133,7 +264,7 @@ namespace ssdk::net
                 if (session != nullptr) //  Route the message to the session - either existing or newly created
                 {
                     session->Touch();
-                    session->OnDataReceived(buf, bytesReceived, session->GetPeerAddress());
+                    session->OnDataReceived(buf, bytesReceived, receivedFrom);
                 }
             }
             else
@@ -156,10 +287,60 @@ namespace ssdk::net
         return res;
     }
 
+    static inline bool KeepAccepting(SessionManager::Result res)
+    {
+        return res == SessionManager::Result::OK || res == SessionManager::Result::CLIENT_DISCONNECTED || res == SessionManager::Result::SESSION_CREATE_FAILED;
+    }
+
+    bool DatagramServer::AcceptConnectionsFromRing(DatagramReceiveRing& ring, SessionManager::Result& res)
+    {
+        //  Same as the select() loop of AcceptConnections(), except that every wakeup delivers all datagrams which arrived since the previous one
+        DatagramReceiveRing::Handler handler = [this, &res](uint8_t* buf, size_t size, const Socket::Address& receivedFrom)
+        {
+            if (m_Terminate == false && KeepAccepting(res) == true)
+            {
+                res = ProcessDatagram(buf, size, receivedFrom, Socket::Result::OK);
+                if (res == SessionManager::Result::CLIENT_DISCONNECTED)
+                {
+                    AMFTraceDebug(AMF_FACILITY, L"DatagramServer::AcceptConnections() - client disconnected");
+                }
+            }
+        };
+        do
+        {
+            amf::AMFLock	lock(&m_Guard);
+            if (m_Terminate == true)
+            {
+                break;
+            }
+            Socket::Result ringResult = ring.Receive(COMM_SELECTOR_FLUSH_INTERVAL_IN_MS, handler);
+            if (ringResult == Socket::Result::OPERATION_NOT_SUPPORTED)
+            {
+                return false;
+            }
+            else if (ringResult != Socket::Result::OK)
+            {
+                AMFTraceInfo(AMF_FACILITY, L"AcceptConnections err=%s", Socket::GetErrorString(ringResult));
+            }
+            ProcessInbox();
+            m_Timers.Advance(amf_high_precision_clock());
+        } while (KeepAccepting(res) == true);
+        return true;
+    }
+
     SessionManager::Result DatagramServer::AcceptConnections()
     {
         SessionManager::Result res = SessionManager::Result::NO_LISTENING_SOCKET;
         res = SessionManager::Result::OK;
+        if (m_IoUring == true)
+        {
+            DatagramReceiveRing ring;
+            if (ring.Init(m_Socket, m_ReceiveBufferSize) == Socket::Result::OK && AcceptConnectionsFromRing(ring, res) == true)
+            {
+                return res;
+            }
+            AMFTraceWarning(AMF_FACILITY, L"DatagramServer::AcceptConnections() - io_uring is not available, falling back to select()");
+        }
         std::unique_ptr<uint8_t[]> readBuf(new uint8_t[m_ReceiveBufferSize]);
         uint8_t* rawBuffer = readBuf.get();
         Selector selector;
@@ -196,7 +377,6 @@ namespace ssdk::net
                 }
                 break;
                 case Selector::Result::TIMEOUT:
-                    SelectorTimeout();
                     //AMFTraceDebug(AMF_FACILITY, L"DatagramServer::AcceptConnections() - select timed out(%d)", timeout);
                     break;
                 default:
@@ -204,9 +384,10 @@ namespace ssdk::net
 
                     break;
                 }
-                CleanupTimedoutSessions(m_DisconnectTimeout);
+                ProcessInbox();
+                m_Timers.Advance(amf_high_precision_clock());
             }
-        } while ((res == SessionManager::Result::OK || res == SessionManager::Result::CLIENT_DISCONNECTED || res == SessionManager::Result::SESSION_CREATE_FAILED));
+        } while (KeepAccepting(res) == true);
         return res;
     }
 }
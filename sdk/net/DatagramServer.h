@@ -36,8 +36,13 @@ THE SOFTWARE.
 
 #include "Server.h"
 #include "DatagramSocket.h"
+#include "DatagramRing.h"
 #include "DatagramServerSession.h"
+#include "TimerWheel.h"
+#include <atomic>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace ssdk::net
 {
@@ -55,18 +60,66 @@ namespace ssdk::net
 		inline DatagramSocket::Ptr GetSocket() const { return m_Socket; }
 		inline void SetSocket(DatagramSocket* socket) { m_Socket = socket; }
 
+        //  Receive with DatagramReceiveRing instead of select() and recvfrom(), falls back to them when io_uring is not available
+        inline void EnableIoUring(bool enable) { m_IoUring = enable; }
+        inline bool IsIoUringEnabled() const noexcept { return m_IoUring; }
+
+    protected:
+        //  Connection migration: when the datagram carries the ID of the connection it belongs to, strip it and return true
+        virtual bool AMF_STD_CALL ExtractConnectionID(uint8_t* /*buf*/, size_t& /*bufSize*/, DatagramServerSession::ConnectionID& /*connectionID*/) { return false; }
+        //  The session may belong to another server sharing the port, see SO_REUSEPORT
+        virtual DatagramServerSession::Ptr AMF_STD_CALL FindSession(DatagramServerSession::ConnectionID /*connectionID*/) { return nullptr; }
+
+        //  Sessions are only ever run by the thread of the server which owns them. Datagrams of a migrating session which arrive at another
+        //  server sharing the port are posted to the owner, which validates the new address and then hands the session over to the receiver.
+        //  A null datagram hands the session itself over.
+        void Post(const DatagramServerSession::Ptr& session, const uint8_t* datagram, size_t size, const Socket::Address& receivedFrom, DatagramServer* receivedBy);
+
     private:
         DatagramServer(const DatagramServer&) = delete;
         DatagramServer& operator=(const DatagramServer&) = delete;
 
-        void SelectorTimeout();
+        //  Housekeeping of every session runs off its own timers rather than by scanning all sessions
+        void ScheduleSessionTimers(const DatagramServerSession::Ptr& session);
+        void OnSessionTick(const DatagramServerSession::Ptr& session);
+        void OnSessionExpiry(const DatagramServerSession::Ptr& session);
+        void RemoveSession(Session* session, bool close);
+
+        void ProcessInbox();
+        void ProcessMigratingDatagram(const DatagramServerSession::Ptr& session, uint8_t* buf, size_t size, const Socket::Address& receivedFrom, DatagramServer* receivedBy);
 
         SessionManager::Result ProcessIncomingMessages(uint8_t* buf);
+        SessionManager::Result ProcessDatagram(uint8_t* buf, size_t bytesReceived, const Socket::Address& receivedFrom, Socket::Result sockResult);
+        bool AcceptConnectionsFromRing(DatagramReceiveRing& ring, SessionManager::Result& res);   //  false when the kernel turns out not to support the ring
 
     protected:
 		DatagramSocket::Ptr		m_Socket;
         size_t                  m_ReceiveBufferSize;
         size_t                  m_MaxConnections;
         time_t                  m_DisconnectTimeout;
+        bool                    m_IoUring = false;
+
+        class SessionTimers
+        {
+        public:
+            TimerWheel::TimerID m_Tick = TimerWheel::INVALID_TIMER;
+            TimerWheel::TimerID m_Expiry = TimerWheel::INVALID_TIMER;
+        };
+        typedef std::unordered_map<Session*, SessionTimers> SessionTimerMap;
+        TimerWheel              m_Timers;           //  Advanced by the AcceptConnections() loop
+        SessionTimerMap         m_SessionTimers;
+
+        class InboxItem
+        {
+        public:
+            DatagramServerSession::Ptr  m_Session;
+            bool                        m_HandOver = false; //  The session itself is handed over, there is no datagram
+            std::vector<uint8_t>        m_Datagram;
+            Socket::Address             m_ReceivedFrom;
+            DatagramServer*             m_ReceivedBy = nullptr;
+        };
+        amf::AMFCriticalSection m_InboxGuard;
+        std::vector<InboxItem>  m_Inbox;
+        std::atomic<bool>       m_InboxPending{ false };
     };
 }
@@ -36,12 +36,20 @@ THE SOFTWARE.
 
 #include "Session.h"
 
+#include <atomic>
+
 namespace ssdk::net
 {
+    class DatagramServer;
+
     class DatagramServerSession :
         public Session
     {
+        friend class DatagramServer;
     public:
+        typedef uint32_t ConnectionID;     //  Identifies the session independently of the peer address, see DatagramServer
+        static constexpr const ConnectionID INVALID_CONNECTION_ID = 0;
+
 		DatagramServerSession(const Socket::Address& peer);
         virtual ~DatagramServerSession();
 
@@ -54,5 +62,21 @@ namespace ssdk::net
         virtual bool   AMF_STD_CALL OnTickNotify() = 0;
 		virtual Result AMF_STD_CALL OnDataReceived(const void* request, size_t requestSize, const Socket::Address& receivedFrom) = 0;
         virtual Socket::Result  AMF_STD_CALL Send(const void* buf, size_t size, size_t* const bytesSent, int flags) = 0;
+
+        //  Called for datagrams carrying the connection ID of the session which arrived from an address other than the known peer.
+        //  Return true when receivedFrom is, or has just been validated as, the peer address and the datagram is to be delivered.
+        virtual bool   AMF_STD_CALL ValidatePeerAddress(const void* /*datagram*/, size_t /*datagramSize*/, const Socket::Address& /*receivedFrom*/) { return false; }
+
+        inline ConnectionID GetConnectionID() const { return m_ConnectionID; }
+        inline void SetConnectionID(ConnectionID connectionID) { m_ConnectionID = connectionID; }
+
+        //  The server whose thread runs the session, changes when a migrated client is hashed to another receive shard
+        inline DatagramServer* GetOwner() const { return m_Owner; }
+
+    protected:
+        ConnectionID    m_ConnectionID = INVALID_CONNECTION_ID;
+
+    private:
+        std::atomic<DatagramServer*>    m_Owner{ nullptr };
     };
 }
@@ -63,6 +63,7 @@ static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::net::DatagramSocket
 #include <stdlib.h>
 #include <errno.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/socket.h>
 #include <net/if_arp.h>
 #include <netinet/in.h>
@@ -658,7 +659,7 @@ namespace ssdk::net
 //        EnumerateNICs();
     }
 
-    DatagramSocket::Result DatagramSocket::SendTo(const void* buf, size_t size, const Socket::Address& to, size_t* bytesSent, int flags)
+    DatagramSocket::Result DatagramSocket::SendTo(const void* buf, size_t size, const Socket::Address& to, size_t* bytesSent, int flags, TrafficClass trafficClass)
     {
         DatagramSocket::Result result = DatagramSocket::Result::OK;
         int sentCount = 0;
@@ -683,6 +684,35 @@ namespace ssdk::net
             result = Socket::Result::INVALID_ARG;
             AMFTraceError(AMF_FACILITY, L"SendTo() invalid address family err=%s", GetErrorString(result));
         }
+#if defined(__linux__)
+        else if (trafficClass != m_TrafficClass && (m_AddrFamily == AddressFamily::ADDR_IP || m_AddrFamily == AddressFamily::ADDR_IP6))
+        {   //  Mark just this datagram, so that a single socket can carry channels of different classes
+            iovec iov = { const_cast<void*>(buf), size };
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+            msghdr msg = {};
+            msg.msg_name = const_cast<sockaddr*>(&to.ToSockAddr());
+            msg.msg_namelen = (socklen_t)to.GetSize();
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = m_AddrFamily == AddressFamily::ADDR_IP ? IPPROTO_IP : IPPROTO_IPV6;
+            cmsg->cmsg_type = m_AddrFamily == AddressFamily::ADDR_IP ? IP_TOS : IPV6_TCLASS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+            int tos = GetTypeOfService(trafficClass);
+            memcpy(CMSG_DATA(cmsg), &tos, sizeof(tos));
+            if ((sentCount = (int)::sendmsg(m_Socket, &msg, flags)) <= 0)
+            {
+                result = GetError(GetSocketOSError());
+                AMFTraceError(AMF_FACILITY, L"SendTo() sendmsg() failed err=%s", GetErrorString(result));
+            }
+            else if (bytesSent != nullptr)
+            {
+                *bytesSent = sentCount;
+            }
+        }
+#endif
         else if ((sentCount = ::sendto(m_Socket, reinterpret_cast<const char*>(buf), (int)size, flags, &to.ToSockAddr(), (int)to.GetSize())) <= 0)
         {
             result = GetError(GetSocketOSError());
@@ -719,27 +749,132 @@ namespace ssdk::net
         else
         {
             struct sockaddr* fromAddr = nullptr;
-            socklen_t addrSize = 0;
+            socklen_t addrCapacity = 0;
             if (from != nullptr)
-            {
+            {   //  The whole storage, the family and therefore the size of the sender is not known before the datagram is received
                 fromAddr = &(from->ToSockAddr());
-                addrSize = (int)from->GetSize();
+                addrCapacity = (socklen_t)sizeof(sockaddr_storage);
             }
-            if ((receivedCount = ::recvfrom(m_Socket, reinterpret_cast<char*>(buf), (int)size, flags, fromAddr, &addrSize)) <= 0)
+            socklen_t addrSize = addrCapacity;
+#if defined(__linux__)
+            if (m_CountReceiveDrops == true)
+            {   //  The kernel attaches its running drop counter to the datagrams queued after a drop, only recvmsg() gets at it
+                iovec iov = { buf, size };
+                alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint32_t))] = {};
+                msghdr msg = {};
+                msg.msg_name = fromAddr;
+                msg.msg_namelen = addrSize;
+                msg.msg_iov = &iov;
+                msg.msg_iovlen = 1;
+                msg.msg_control = control;
+                msg.msg_controllen = sizeof(control);
+                receivedCount = (int)::recvmsg(m_Socket, &msg, flags);
+                addrSize = msg.msg_namelen;
+                if (receivedCount > 0)
+                {
+                    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg))
+                    {
+                        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+                        {
+                            uint32_t drops = 0;
+                            memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+                            m_ReceiveDrops = drops;
+                        }
+                    }
+                }
+            }
+            else
+#endif
+            {
+                receivedCount = ::recvfrom(m_Socket, reinterpret_cast<char*>(buf), (int)size, flags, fromAddr, &addrSize);
+            }
+            if (receivedCount <= 0)
             {
                 int errcode = GetSocketOSError();
                 result = GetError(errcode);
                 AMFTraceError(AMF_FACILITY, L"ReceiveFrom() recvfrom() failed: err=%s socketerr=%d", GetErrorString(result), errcode);
             }
-            else if (bytesReceived != nullptr)
+            else
             {
-                //AMFTraceDebug(AMF_FACILITY, L"DatagramSocket::ReceiveFrom() receivedCount=%d", receivedCount);
-                *bytesReceived = receivedCount;
+                if (fromAddr != nullptr && addrSize < addrCapacity)
+                {   //  Clear what is left of a longer address received before, Address::operator<() compares the whole storage
+                    memset(reinterpret_cast<char*>(fromAddr) + addrSize, 0, addrCapacity - addrSize);
+                }
+                if (bytesReceived != nullptr)
+                {
+                    //AMFTraceDebug(AMF_FACILITY, L"DatagramSocket::ReceiveFrom() receivedCount=%d", receivedCount);
+                    *bytesReceived = receivedCount;
+                }
             }
         }
         return result;
     }
 
+    Socket::Result DatagramSocket::SetDontFragment(bool dontFragment)
+    {
+#if defined(WIN32)
+        DWORD value = dontFragment ? TRUE : FALSE;
+        return SetSocketOpt(IPPROTO_IP, IP_DONTFRAGMENT, &value, sizeof(value));
+#elif defined(__linux__)
+        //  IP_PMTUDISC_PROBE sets DF without clamping sends to the path MTU cached by the kernel, so that probes larger than it still go out
+        int value = dontFragment ? IP_PMTUDISC_PROBE : IP_PMTUDISC_WANT;
+        return SetSocketOpt(IPPROTO_IP, IP_MTU_DISCOVER, &value, sizeof(value));
+#else
+        (void)dontFragment;
+        return Result::OPERATION_NOT_SUPPORTED;
+#endif
+    }
+
+    Socket::Result DatagramSocket::SetCountReceiveDrops(bool countDrops)
+    {
+#if defined(__linux__)
+        int value = countDrops ? 1 : 0;
+        Result result = SetSocketOpt(SOL_SOCKET, SO_RXQ_OVFL, &value, sizeof(value));
+        if (result == Result::OK)
+        {
+            m_CountReceiveDrops = countDrops;
+        }
+        return result;
+#else
+        (void)countDrops;
+        return Result::OPERATION_NOT_SUPPORTED;
+#endif
+    }
+
+    Socket::Result DatagramSocket::Rebind()
+    {
+#if defined(__linux__)
+        //  dup2() swaps the socket atomically, so that threads blocked on the handle or about to use it are not disturbed
+        Socket_t replacement = ::socket(static_cast<int>(m_AddrFamily), static_cast<int>(m_SocketType), static_cast<int>(m_Protocol));
+        if (replacement == INVALID_SOCKET)
+        {
+            return GetError(GetSocketOSError());
+        }
+        //  File status flags and buffer sizes belong to the socket, not to the descriptor - carry them over
+        ::fcntl(replacement, F_SETFL, ::fcntl(m_Socket, F_GETFL));
+        int optNames[] = { SO_RCVBUF, SO_SNDBUF };
+        for (int optName : optNames)
+        {
+            int value = 0;
+            socklen_t valueSize = sizeof(value);
+            if (::getsockopt(m_Socket, SOL_SOCKET, optName, &value, &valueSize) == 0)
+            {
+                ::setsockopt(replacement, SOL_SOCKET, optName, &value, valueSize);
+            }
+        }
+        Result result = Result::OK;
+        if (::dup2(replacement, m_Socket) < 0)
+        {
+            result = GetError(GetSocketOSError());
+            AMFTraceError(AMF_FACILITY, L"Rebind() - dup2() failed err=%s", GetErrorString(result));
+        }
+        ::close(replacement);
+        return result;
+#else
+        return Result::OPERATION_NOT_SUPPORTED;
+#endif
+    }
+
     void DatagramSocket::SetNICDataExpiration(time_t expirationSec)
     {
         amf::AMFLock    lock(&m_Guard);
@@ -36,6 +36,7 @@ THE SOFTWARE.
 
 #include <vector>
 #include <ctime>
+#include <atomic>
 #include "Socket.h"
 
 namespace ssdk::net
@@ -55,23 +56,43 @@ namespace ssdk::net
     public:
         DatagramSocket(AddressFamily addrFamily = Socket::AddressFamily::ADDR_IP, Protocol protocol = Socket::Protocol::PROTO_UDP);
 
-        virtual Result SendTo(const void* buf, size_t size, const Socket::Address& to, size_t* bytesSent, int flags = 0);
+        //  A trafficClass other than the one of the socket is attached to the datagram as IP_TOS ancillary data on Linux and ignored elsewhere
+        virtual Result SendTo(const void* buf, size_t size, const Socket::Address& to, size_t* bytesSent, int flags = 0, TrafficClass trafficClass = TrafficClass::BEST_EFFORT);
         virtual Result ReceiveFrom(void* buf, size_t size, Socket::Address* from, size_t* bytesReceived, int flags = 0);
 
         virtual Result Broadcast(const void* buf, size_t size, unsigned short port, size_t* bytesSent, int flags = 0);
 
+        Result SetDontFragment(bool dontFragment);  //  Set the DF bit on outgoing IPv4 datagrams, required for path MTU probing.
+                                                    //  Returns OPERATION_NOT_SUPPORTED on platforms where it cannot be set.
+
+        Result SetCountReceiveDrops(bool countDrops);   //  Count datagrams the kernel dropped because the receive buffer was full (SO_RXQ_OVFL).
+                                                        //  Returns OPERATION_NOT_SUPPORTED on platforms other than Linux.
+        inline uint32_t GetReceiveDrops() const { return m_ReceiveDrops; }  //  Total since the socket was opened, as of the last ReceiveFrom()
+
+        Result Rebind();    //  Replace the OS socket behind the handle with a new one, which is bound to a new ephemeral port on the next send.
+                            //  To the peer this looks like a NAT rebinding. Only the file status flags and buffer sizes are carried over.
+                            //  Returns OPERATION_NOT_SUPPORTED on platforms other than Linux.
+
+        virtual bool SupportsSendRing() const { return true; }  //  Whether datagrams may bypass SendTo() through DatagramSendRing
+
         static void SetNICDataExpiration(time_t expirationSec); //  Set how frequently Broadcast should check for changes in NICs
                                                                 //  Setting it to 0 forces it to check for changes on every call.
                                                                 //  Use 0 carefully as it might take up to 25ms on Windows, so
                                                                 //  set to a higher value when broadcasting a lot of data. Default 1 sec
 
     private:
+        friend class DatagramSendRing;
+        friend class DatagramReceiveRing;
+
         DatagramSocket(const DatagramSocket&) = delete;
         DatagramSocket& operator=(const DatagramSocket&) = delete;
 
         bool EnumerateNICs();
 
     private:
+        bool                    m_CountReceiveDrops = false;
+        std::atomic<uint32_t>   m_ReceiveDrops{ 0 };
+
         typedef std::vector<Socket::Address>    AddressVector;
         static AddressVector   m_MyNICs;
         static amf::AMFCriticalSection m_Guard;
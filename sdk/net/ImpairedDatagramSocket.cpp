@@ -0,0 +1,166 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+#include "ImpairedDatagramSocket.h"
+#include "amf/public/common/TraceAdapter.h"
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::net::ImpairedDatagramSocket";
+
+static constexpr const amf_pts IDLE_WAIT = 100 * AMF_MILLISECOND;
+
+namespace ssdk::net
+{
+    ImpairedDatagramSocket::ImpairedDatagramSocket(const NetworkImpairment::Params& params, AddressFamily addrFamily, Protocol protocol) :
+        DatagramSocket(addrFamily, protocol),
+        m_Impairment(params),
+        m_DeliveryThread(*this)
+    {
+        m_DeliveryThread.Start();
+    }
+
+    ImpairedDatagramSocket::~ImpairedDatagramSocket()
+    {
+        m_DeliveryThread.RequestStop();
+        m_PendingEvent.SetEvent();
+        m_DeliveryThread.WaitForStop();
+    }
+
+    Socket::Result ImpairedDatagramSocket::SendTo(const void* buf, size_t size, const Socket::Address& to, size_t* bytesSent, int flags, TrafficClass trafficClass)
+    {
+        if (buf == nullptr || size == 0)
+        {
+            return DatagramSocket::SendTo(buf, size, to, bytesSent, flags, trafficClass);  //  Let the real socket report the error
+        }
+
+        {
+            amf::AMFLock lock(&m_ImpairmentGuard);
+            size_t mtu = m_Impairment.GetParams().m_Mtu;
+            if (mtu != 0 && size > mtu)
+            {
+                return Result::MESSAGE_TOO_BIG;
+            }
+            amf_pts now = amf_high_precision_clock();
+            amf_pts departures[NetworkImpairment::MAX_COPIES];
+            size_t copies = m_Impairment.Schedule(size, now, departures);
+            if (copies == 1 && departures[0] <= now && m_Pending.empty() == true && m_Delivering == false)
+            {
+                //  Nothing to wait for and nothing to overtake, send it under the lock so that later datagrams stay behind it
+                return DatagramSocket::SendTo(buf, size, to, bytesSent, flags, trafficClass);
+            }
+            for (size_t i = 0; i < copies; ++i)
+            {
+                PendingDatagram datagram;
+                datagram.m_Departure = departures[i];
+                datagram.m_Sequence = m_Sequence++;
+                datagram.m_Data.assign(static_cast<const uint8_t*>(buf), static_cast<const uint8_t*>(buf) + size);
+                datagram.m_To = to;
+                datagram.m_Flags = flags;
+                datagram.m_TrafficClass = trafficClass;
+                m_Pending.push(std::move(datagram));
+            }
+        }
+        m_PendingEvent.SetEvent();
+
+        if (bytesSent != nullptr)
+        {
+            *bytesSent = size;
+        }
+        return Result::OK;
+    }
+
+    Socket::Result ImpairedDatagramSocket::Close()
+    {
+        {
+            amf::AMFLock lock(&m_ImpairmentGuard);
+            m_Pending = PendingQueue();
+        }
+        return DatagramSocket::Close();
+    }
+
+    NetworkImpairment::Stats ImpairedDatagramSocket::GetStats() const
+    {
+        amf::AMFLock lock(&m_ImpairmentGuard);
+        return m_Impairment.GetStats();
+    }
+
+    amf_pts ImpairedDatagramSocket::DeliverDue()
+    {
+        amf_pts now = amf_high_precision_clock();
+        std::vector<PendingDatagram> due;
+        amf_pts wait = -1;
+        {
+            amf::AMFLock lock(&m_ImpairmentGuard);
+            while (m_Pending.empty() == false && m_Pending.top().m_Departure <= now)
+            {
+                due.push_back(std::move(const_cast<PendingDatagram&>(m_Pending.top())));
+                m_Pending.pop();
+            }
+            m_Delivering = due.empty() == false;
+            if (m_Pending.empty() == false)
+            {
+                wait = m_Pending.top().m_Departure - now;
+            }
+        }
+
+        for (const PendingDatagram& datagram : due)
+        {
+            size_t bytesSent = 0;
+            Result result = DatagramSocket::SendTo(datagram.m_Data.data(), datagram.m_Data.size(), datagram.m_To, &bytesSent, datagram.m_Flags, datagram.m_TrafficClass);
+            if (result != Result::OK)
+            {
+                AMFTraceDebug(AMF_FACILITY, L"Delayed datagram of %d bytes could not be sent, err=%s", (int)datagram.m_Data.size(), GetErrorString(result));
+            }
+        }
+        if (due.empty() == false)
+        {
+            amf::AMFLock lock(&m_ImpairmentGuard);
+            m_Delivering = false;
+        }
+        return wait;
+    }
+
+    void ImpairedDatagramSocket::DeliveryThread::Run()
+    {
+        while (StopRequested() == false)
+        {
+            amf_pts wait = m_Socket.DeliverDue();
+            if (wait < 0)
+            {
+                wait = IDLE_WAIT;
+            }
+            //  Round up so that the thread does not spin on sub-millisecond waits
+            m_Socket.m_PendingEvent.Lock(static_cast<amf_ulong>((wait + AMF_MILLISECOND - 1) / AMF_MILLISECOND));
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+#pragma once
+
+#include "DatagramSocket.h"
+#include "NetworkImpairment.h"
+#include "amf/public/common/Thread.h"
+
+#include <queue>
+#include <vector>
+
+namespace ssdk::net
+{
+    //  A datagram socket which passes everything it sends through a NetworkImpairment model.
+    //  Datagrams that survive the model are held by a delivery thread until their departure time and then sent
+    //  through the real socket. Receiving is not affected, impair the sending side of both peers to impair both directions.
+    //  Datagrams which are neither delayed nor queued behind others are sent immediately, so that the caller sees the
+    //  real socket's result for them.
+    class ImpairedDatagramSocket :
+        public DatagramSocket
+    {
+    public:
+        typedef amf::AMFInterfacePtr_T<ImpairedDatagramSocket> Ptr;
+
+    public:
+        ImpairedDatagramSocket(const NetworkImpairment::Params& params, AddressFamily addrFamily = Socket::AddressFamily::ADDR_IP, Protocol protocol = Socket::Protocol::PROTO_UDP);
+        virtual ~ImpairedDatagramSocket();
+
+        //  Returns MESSAGE_TOO_BIG for datagrams larger than the model's MTU and the real socket's result for datagrams sent
+        //  immediately. Delayed datagrams are reported as sent, whether they are delivered is decided by the impairment model
+        virtual Result SendTo(const void* buf, size_t size, const Socket::Address& to, size_t* bytesSent, int flags = 0, TrafficClass trafficClass = TrafficClass::BEST_EFFORT) override;
+        virtual Socket::Result Close() override;
+        virtual bool SupportsSendRing() const override { return false; }  //  Everything sent has to go through the impairment model
+
+        NetworkImpairment::Stats GetStats() const;
+
+    private:
+        ImpairedDatagramSocket(const ImpairedDatagramSocket&) = delete;
+        ImpairedDatagramSocket& operator=(const ImpairedDatagramSocket&) = delete;
+
+        struct PendingDatagram
+        {
+            amf_pts                 m_Departure = 0;
+            uint64_t                m_Sequence = 0;     //  Keeps datagrams with the same departure time in order
+            std::vector<uint8_t>    m_Data;
+            Socket::Address         m_To;
+            int                     m_Flags = 0;
+            TrafficClass            m_TrafficClass = TrafficClass::BEST_EFFORT;
+
+            inline bool operator>(const PendingDatagram& other) const
+            {
+                return m_Departure != other.m_Departure ? m_Departure > other.m_Departure : m_Sequence > other.m_Sequence;
+            }
+        };
+        typedef std::priority_queue<PendingDatagram, std::vector<PendingDatagram>, std::greater<PendingDatagram>> PendingQueue;
+
+        class DeliveryThread : public amf::AMFThread
+        {
+        public:
+            DeliveryThread(ImpairedDatagramSocket& socket) : m_Socket(socket) {}
+
+        protected:
+            virtual void Run() override;
+
+        private:
+            ImpairedDatagramSocket& m_Socket;
+        };
+        friend class DeliveryThread;
+
+        amf_pts DeliverDue();   //  Sends all datagrams which are due and returns the time until the next one, or -1 when none are pending
+
+    private:
+        mutable amf::AMFCriticalSection m_ImpairmentGuard;
+        NetworkImpairment               m_Impairment;
+        PendingQueue                    m_Pending;
+        uint64_t                        m_Sequence = 0;
+        bool                            m_Delivering = false;   //  The delivery thread is sending datagrams taken off m_Pending
+        amf::AMFEvent                   m_PendingEvent;
+        DeliveryThread                  m_DeliveryThread;
+    };
+}
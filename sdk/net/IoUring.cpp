@@ -0,0 +1,369 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "IoUring.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#if defined(__linux)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <linux/time_types.h>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::net::IoUring";
+
+namespace ssdk::net
+{
+    static int io_uring_setup(unsigned int entries, io_uring_params* params)
+    {
+        int result = (int)::syscall(__NR_io_uring_setup, entries, params);
+        return result < 0 ? -errno : result;
+    }
+
+    static int io_uring_enter(int fd, unsigned int toSubmit, unsigned int minComplete, unsigned int flags, void* arg, size_t argSize)
+    {
+        int result = (int)::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize);
+        return result < 0 ? -errno : result;
+    }
+
+    static int io_uring_register(int fd, unsigned int opcode, void* arg, unsigned int argCount)
+    {
+        int result = (int)::syscall(__NR_io_uring_register, fd, opcode, arg, argCount);
+        return result < 0 ? -errno : result;
+    }
+
+    //  The queue indices are shared with the kernel, which reads and writes them concurrently
+    static inline unsigned int LoadAcquire(const unsigned int* p)
+    {
+        return std::atomic_ref<const unsigned int>(*p).load(std::memory_order_acquire);
+    }
+
+    static inline void StoreRelease(unsigned int* p, unsigned int value)
+    {
+        std::atomic_ref<unsigned int>(*p).store(value, std::memory_order_release);
+    }
+
+    IoUring::IoUring()
+    {
+    }
+
+    IoUring::~IoUring()
+    {
+        Close();
+    }
+
+    bool IoUring::IsAvailable()
+    {
+        static const bool available = []()
+        {
+            IoUring ring;
+            return ring.Init(2);
+        }();
+        return available;
+    }
+
+    bool IoUring::Init(unsigned int entries)
+    {
+        Close();
+
+        //  Task work is deferred to the next io_uring_enter() of the submitting thread, so completions are batched with the
+        //  submissions instead of interrupting the thread. Older kernels reject these flags, retry without them
+        static constexpr const unsigned int PREFERRED_FLAGS = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+        io_uring_params params = {};
+        params.flags = PREFERRED_FLAGS | IORING_SETUP_CQSIZE;
+        params.cq_entries = entries * 4;    //  Zero-copy sends and multishot receives post several completions per entry
+        int fd = io_uring_setup(entries, &params);
+        if (fd == -EINVAL)
+        {
+            params = {};
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = entries * 4;
+            fd = io_uring_setup(entries, &params);
+        }
+        if (fd < 0)
+        {
+            AMFTraceDebug(AMF_FACILITY, L"Init() - io_uring_setup() failed, errno=%d", -fd);
+            return false;
+        }
+        m_Fd = fd;
+        m_SetupFlags = params.flags;
+
+        if ((params.features & IORING_FEAT_EXT_ARG) == 0)
+        {   //  Waiting with a timeout requires Linux 5.11
+            AMFTraceDebug(AMF_FACILITY, L"Init() - IORING_FEAT_EXT_ARG is not supported");
+            Close();
+            return false;
+        }
+
+        m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+        {
+            m_SqRingSize = m_CqRingSize = std::max(m_SqRingSize, m_CqRingSize);
+        }
+        m_SqRing = ::mmap(nullptr, m_SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Fd, IORING_OFF_SQ_RING);
+        if (m_SqRing == MAP_FAILED)
+        {
+            m_SqRing = nullptr;
+            Close();
+            return false;
+        }
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+        {
+            m_CqRing = m_SqRing;
+        }
+        else
+        {
+            m_CqRing = ::mmap(nullptr, m_CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Fd, IORING_OFF_CQ_RING);
+            if (m_CqRing == MAP_FAILED)
+            {
+                m_CqRing = nullptr;
+                Close();
+                return false;
+            }
+        }
+        m_SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, m_SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+        {
+            Close();
+            return false;
+        }
+        m_Sqes = static_cast<io_uring_sqe*>(sqes);
+
+        uint8_t* sq = static_cast<uint8_t*>(m_SqRing);
+        m_SqHead = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+        m_SqTail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+        m_SqMask = *reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+        m_SqEntries = params.sq_entries;
+        //  Submission entries are always used in order, so the indirection array is the identity
+        unsigned int* sqArray = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+        for (unsigned int i = 0; i < m_SqEntries; ++i)
+        {
+            sqArray[i] = i;
+        }
+        m_SqeHead = m_SqeTail = *m_SqTail;
+
+        uint8_t* cq = static_cast<uint8_t*>(m_CqRing);
+        m_CqHead = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+        m_CqTail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+        m_CqMask = *reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+        m_Cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        ProbeOps();
+        return true;
+    }
+
+    void IoUring::Close()
+    {
+        //  Closing the ring cancels whatever is still in flight
+        if (m_Fd >= 0)
+        {
+            ::close(m_Fd);
+            m_Fd = -1;
+        }
+        if (m_BufferRing != nullptr)
+        {
+            ::munmap(m_BufferRing, m_BufferRingSize);
+            m_BufferRing = nullptr;
+            m_BufferRingSize = 0;
+        }
+        if (m_Sqes != nullptr)
+        {
+            ::munmap(m_Sqes, m_SqesSize);
+            m_Sqes = nullptr;
+        }
+        if (m_CqRing != nullptr && m_CqRing != m_SqRing)
+        {
+            ::munmap(m_CqRing, m_CqRingSize);
+        }
+        m_CqRing = nullptr;
+        if (m_SqRing != nullptr)
+        {
+            ::munmap(m_SqRing, m_SqRingSize);
+            m_SqRing = nullptr;
+        }
+        m_SqHead = m_SqTail = nullptr;
+        m_CqHead = m_CqTail = nullptr;
+        m_Cqes = nullptr;
+        m_SqeHead = m_SqeTail = 0;
+        memset(m_SupportedOps, 0, sizeof(m_SupportedOps));
+    }
+
+    void IoUring::ProbeOps()
+    {
+        static constexpr const unsigned int MAX_OPS = 256;
+        std::vector<uint8_t> buf(sizeof(io_uring_probe) + MAX_OPS * sizeof(io_uring_probe_op));
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buf.data());
+        if (io_uring_register(m_Fd, IORING_REGISTER_PROBE, probe, MAX_OPS) < 0)
+        {
+            return;
+        }
+        for (unsigned int i = 0; i < probe->ops_len && i < MAX_OPS; ++i)
+        {
+            if ((probe->ops[i].flags & IO_URING_OP_SUPPORTED) != 0)
+            {
+                m_SupportedOps[probe->ops[i].op / 64] |= uint64_t(1) << (probe->ops[i].op % 64);
+            }
+        }
+    }
+
+    bool IoUring::IsOpSupported(uint8_t opcode) const noexcept
+    {
+        return (m_SupportedOps[opcode / 64] & (uint64_t(1) << (opcode % 64))) != 0;
+    }
+
+    io_uring_sqe* IoUring::GetSqe()
+    {
+        if (m_Fd < 0 || m_SqeTail - LoadAcquire(m_SqHead) >= m_SqEntries)
+        {
+            return nullptr;
+        }
+        io_uring_sqe* sqe = &m_Sqes[m_SqeTail & m_SqMask];
+        memset(sqe, 0, sizeof(*sqe));
+        ++m_SqeTail;
+        return sqe;
+    }
+
+    int IoUring::Submit(unsigned int waitFor, int timeoutMs)
+    {
+        if (m_Fd < 0)
+        {
+            return -EBADF;
+        }
+        StoreRelease(m_SqTail, m_SqeTail);
+
+        unsigned int flags = 0;
+        //  Deferred task work only runs when the thread asks for completions
+        if (waitFor > 0 || (m_SetupFlags & IORING_SETUP_DEFER_TASKRUN) != 0)
+        {
+            flags |= IORING_ENTER_GETEVENTS;
+        }
+        __kernel_timespec ts = {};
+        io_uring_getevents_arg arg = {};
+        arg.sigmask_sz = _NSIG / 8;
+        if (waitFor > 0 && timeoutMs >= 0)
+        {
+            ts.tv_sec = timeoutMs / 1000;
+            ts.tv_nsec = (timeoutMs % 1000) * 1000000LL;
+            arg.ts = reinterpret_cast<uint64_t>(&ts);
+        }
+        flags |= IORING_ENTER_EXT_ARG;
+
+        int result = 0;
+        do
+        {
+            ++m_EnterCount;
+            result = io_uring_enter(m_Fd, m_SqeTail - m_SqeHead, waitFor, flags, &arg, sizeof(arg));
+            m_SqeHead = LoadAcquire(m_SqHead);
+        } while (result == -EINTR);
+
+        if (result == -ETIME || result == -EBUSY)
+        {   //  EBUSY: the completion queue is full and has to be drained before more can be submitted
+            result = 0;
+        }
+        return result;
+    }
+
+    io_uring_cqe* IoUring::PeekCqe()
+    {
+        if (m_Fd < 0)
+        {
+            return nullptr;
+        }
+        unsigned int head = *m_CqHead;
+        return head != LoadAcquire(m_CqTail) ? &m_Cqes[head & m_CqMask] : nullptr;
+    }
+
+    void IoUring::SeenCqe()
+    {
+        StoreRelease(m_CqHead, *m_CqHead + 1);
+    }
+
+    int IoUring::RegisterBuffer(void* buf, size_t size)
+    {
+        iovec iov = { buf, size };
+        return io_uring_register(m_Fd, IORING_REGISTER_BUFFERS, &iov, 1);
+    }
+
+    void IoUring::SetAddrLen(io_uring_sqe* sqe, uint16_t addrLen)
+    {
+        memcpy(reinterpret_cast<uint8_t*>(sqe) + offsetof(io_uring_sqe, splice_fd_in), &addrLen, sizeof(addrLen));
+    }
+
+    IoUring::Buffer* IoUring::RegisterBufferRing(uint16_t group, unsigned int entries)
+    {
+        if (m_Fd < 0 || m_BufferRing != nullptr || entries == 0 || (entries & (entries - 1)) != 0)
+        {
+            return nullptr;
+        }
+        size_t size = entries * sizeof(Buffer);
+        void* ring = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ring == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        //  struct io_uring_buf_reg (5.19)
+        struct
+        {
+            uint64_t    ring_addr;
+            uint32_t    ring_entries;
+            uint16_t    bgid;
+            uint16_t    flags;
+            uint64_t    resv[3];
+        } reg = {};
+        reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+        reg.ring_entries = entries;
+        reg.bgid = group;
+        int result = io_uring_register(m_Fd, REGISTER_PBUF_RING, &reg, 1);
+        if (result < 0)
+        {   //  Provided buffer rings require Linux 5.19
+            AMFTraceDebug(AMF_FACILITY, L"RegisterBufferRing() failed, errno=%d", -result);
+            ::munmap(ring, size);
+            return nullptr;
+        }
+        m_BufferRing = static_cast<Buffer*>(ring);
+        m_BufferRingSize = size;
+        return m_BufferRing;
+    }
+}
+#endif
@@ -0,0 +1,166 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux)
+#include <linux/io_uring.h>
+
+//  Flags newer than the 5.15 kernel headers of Ubuntu 22.04, with the values of the kernel which introduced them. Whether the
+//  running kernel supports them is found out at runtime, builds against older headers fall back to select() like older kernels
+#ifndef IORING_SETUP_SUBMIT_ALL
+#define IORING_SETUP_SUBMIT_ALL         (1U << 7)       //  5.18
+#endif
+#ifndef IORING_SETUP_COOP_TASKRUN
+#define IORING_SETUP_COOP_TASKRUN       (1U << 8)       //  5.19
+#endif
+#ifndef IORING_SETUP_SINGLE_ISSUER
+#define IORING_SETUP_SINGLE_ISSUER      (1U << 12)      //  6.0
+#endif
+#ifndef IORING_SETUP_DEFER_TASKRUN
+#define IORING_SETUP_DEFER_TASKRUN      (1U << 13)      //  6.1
+#endif
+#ifndef IORING_ASYNC_CANCEL_ANY
+#define IORING_ASYNC_CANCEL_ANY         (1U << 2)       //  5.19
+#endif
+#ifndef IORING_RECV_MULTISHOT
+#define IORING_RECV_MULTISHOT           (1U << 1)       //  6.0
+#endif
+#ifndef IORING_RECVSEND_FIXED_BUF
+#define IORING_RECVSEND_FIXED_BUF       (1U << 2)       //  6.0
+#endif
+#ifndef IORING_CQE_F_NOTIF
+#define IORING_CQE_F_NOTIF              (1U << 3)       //  6.0
+#endif
+
+namespace ssdk::net
+{
+    //  IoUring - a minimal wrapper around one io_uring instance: the submission and completion queues mapped into the
+    //  process, a registered buffer and a provided buffer ring. The system calls are made directly, liburing is not required.
+    //
+    //  An instance must only be used by the thread which initialized it, the ring is created with IORING_SETUP_SINGLE_ISSUER
+    //  when the kernel supports it. Completions of such a ring are only reaped inside Submit()
+    class IoUring
+    {
+    public:
+        //  Opcodes are enumerators in the kernel headers, so they cannot be tested with #ifdef
+        static constexpr const uint8_t OP_SEND_ZC = 47;                 //  IORING_OP_SEND_ZC, 6.0
+        static constexpr const uint8_t OP_SENDMSG_ZC = 48;              //  IORING_OP_SENDMSG_ZC, 6.1
+        static constexpr const unsigned int REGISTER_PBUF_RING = 22;    //  IORING_REGISTER_PBUF_RING, 5.19
+
+        //  struct io_uring_buf (5.19). A provided buffer ring is an array of these, the kernel reads the tail of the ring
+        //  from the reserved field of entry 0
+        struct Buffer
+        {
+            uint64_t    addr;
+            uint32_t    len;
+            uint16_t    bid;
+            uint16_t    resv;
+        };
+
+        //  struct io_uring_recvmsg_out (6.0), which precedes the name, control data and payload in each buffer of a multishot receive
+        struct RecvMsgOut
+        {
+            uint32_t    namelen;
+            uint32_t    controllen;
+            uint32_t    payloadlen;
+            uint32_t    flags;
+        };
+
+        //  sqe->addr_len (6.0) shares its location with splice_fd_in, which older headers declare instead
+        static void SetAddrLen(io_uring_sqe* sqe, uint16_t addrLen);
+
+    public:
+        IoUring();
+        ~IoUring();
+
+        bool Init(unsigned int entries);                        //  Fails when the kernel lacks io_uring or it is disabled by io_uring_disabled or seccomp
+        void Close();
+        inline bool IsOpen() const noexcept { return m_Fd >= 0; }
+
+        static bool IsAvailable();                              //  Probed once per process
+        bool IsOpSupported(uint8_t opcode) const noexcept;
+
+        io_uring_sqe* GetSqe();                                 //  A zeroed entry, nullptr when the submission queue is full
+        inline unsigned int GetUnsubmitted() const noexcept { return m_SqeTail - m_SqeHead; }
+        int Submit(unsigned int waitFor = 0, int timeoutMs = -1);   //  Submits all entries and waits up to timeoutMs for waitFor completions.
+                                                                    //  Returns the number of entries submitted or -errno, a timeout is not an error
+        io_uring_cqe* PeekCqe();                                //  nullptr when no completion is ready
+        void SeenCqe();                                         //  Releases the completion returned by PeekCqe()
+
+        int RegisterBuffer(void* buf, size_t size);             //  Registers buf as fixed buffer 0, returns 0 or -errno
+        Buffer* RegisterBufferRing(uint16_t group, unsigned int entries);   //  entries must be a power of 2, returns nullptr on failure
+
+        inline uint64_t GetEnterCount() const noexcept { return m_EnterCount; }   //  io_uring_enter() calls made so far, for benchmarking
+
+    private:
+        IoUring(const IoUring&) = delete;
+        IoUring& operator=(const IoUring&) = delete;
+
+        void ProbeOps();
+
+    private:
+        int                 m_Fd = -1;
+        unsigned int        m_SetupFlags = 0;
+
+        void*               m_SqRing = nullptr;
+        size_t              m_SqRingSize = 0;
+        void*               m_CqRing = nullptr;             //  Same as m_SqRing with IORING_FEAT_SINGLE_MMAP
+        size_t              m_CqRingSize = 0;
+        io_uring_sqe*       m_Sqes = nullptr;
+        size_t              m_SqesSize = 0;
+
+        unsigned int*       m_SqHead = nullptr;
+        unsigned int*       m_SqTail = nullptr;
+        unsigned int        m_SqMask = 0;
+        unsigned int        m_SqEntries = 0;
+        unsigned int        m_SqeHead = 0;                  //  Entries between m_SqeHead and m_SqeTail have not been consumed by the kernel yet
+        unsigned int        m_SqeTail = 0;
+
+        unsigned int*       m_CqHead = nullptr;
+        unsigned int*       m_CqTail = nullptr;
+        unsigned int        m_CqMask = 0;
+        io_uring_cqe*       m_Cqes = nullptr;
+
+        Buffer*             m_BufferRing = nullptr;
+        size_t              m_BufferRingSize = 0;
+
+        uint64_t            m_SupportedOps[4] = {};         //  Bit per IORING_OP_*
+        uint64_t            m_EnterCount = 0;
+    };
+}
+#endif
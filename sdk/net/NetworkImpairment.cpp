@@ -0,0 +1,276 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+#include "NetworkImpairment.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace ssdk::net
+{
+    static bool ParsePercent(const std::string& value, double& probability)
+    {
+        char* end = nullptr;
+        double percent = std::strtod(value.c_str(), &end);
+        bool result = end != value.c_str() && *end == '\0' && percent >= 0 && percent <= 100;
+        if (result == true)
+        {
+            probability = percent / 100.0;
+        }
+        return result;
+    }
+
+    static bool ParseNumber(const std::string& value, double& number)
+    {
+        char* end = nullptr;
+        number = std::strtod(value.c_str(), &end);
+        return end != value.c_str() && *end == '\0' && number >= 0;
+    }
+
+    bool NetworkImpairment::Params::Parse(const std::string& spec)
+    {
+        std::istringstream stream(spec);
+        std::string item;
+        while (std::getline(stream, item, ','))
+        {
+            if (item.empty() == true)
+            {
+                continue;
+            }
+            size_t eq = item.find('=');
+            if (eq == std::string::npos)
+            {
+                return false;
+            }
+            std::string key = item.substr(0, eq);
+            std::string value = item.substr(eq + 1);
+            double number = 0;
+            bool valid = true;
+            if (key == "loss")
+            {
+                valid = ParsePercent(value, m_LossGood);
+                m_GoodToBad = 0;
+            }
+            else if (key == "ge")
+            {
+                std::istringstream geStream(value);
+                std::string geValue;
+                double* geParams[] = { &m_GoodToBad, &m_BadToGood, &m_LossGood, &m_LossBad };
+                size_t count = 0;
+                while (valid == true && std::getline(geStream, geValue, ':'))
+                {
+                    valid = count < 4 && ParsePercent(geValue, *geParams[count++]);
+                }
+                valid = valid == true && count == 4;
+            }
+            else if (key == "delay")
+            {
+                valid = ParseNumber(value, number);
+                m_Delay = amf_pts(number * AMF_MILLISECOND);
+            }
+            else if (key == "jitter")
+            {
+                valid = ParseNumber(value, number);
+                m_Jitter = amf_pts(number * AMF_MILLISECOND);
+            }
+            else if (key == "dist")
+            {
+                if (value == "uniform")
+                {
+                    m_Distribution = Distribution::UNIFORM;
+                }
+                else if (value == "normal")
+                {
+                    m_Distribution = Distribution::NORMAL;
+                }
+                else if (value == "pareto")
+                {
+                    m_Distribution = Distribution::PARETO;
+                }
+                else
+                {
+                    valid = false;
+                }
+            }
+            else if (key == "rate")
+            {
+                valid = ParseNumber(value, number);
+                m_Rate = int64_t(number * 1000 / 8);
+            }
+            else if (key == "burst")
+            {
+                valid = ParseNumber(value, number);
+                m_Burst = int64_t(number);
+            }
+            else if (key == "queue")
+            {
+                valid = ParseNumber(value, number);
+                m_QueueLimit = int64_t(number);
+            }
+            else if (key == "reorder")
+            {
+                valid = ParsePercent(value, m_Reorder);
+            }
+            else if (key == "reorder_gap")
+            {
+                valid = ParseNumber(value, number);
+                m_ReorderGap = amf_pts(number * AMF_MILLISECOND);
+            }
+            else if (key == "duplicate")
+            {
+                valid = ParsePercent(value, m_Duplicate);
+            }
+            else if (key == "mtu")
+            {
+                valid = ParseNumber(value, number);
+                m_Mtu = size_t(number);
+            }
+            else if (key == "seed")
+            {
+                valid = ParseNumber(value, number);
+                m_Seed = uint64_t(number);
+            }
+            else
+            {
+                valid = false;
+            }
+
+            if (valid == false)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    NetworkImpairment::NetworkImpairment(const Params& params) :
+        m_Params(params),
+        m_Rng(params.m_Seed),
+        m_Tokens(double(params.m_Burst))
+    {
+    }
+
+    size_t NetworkImpairment::Schedule(size_t size, amf_pts now, amf_pts departures[MAX_COPIES])
+    {
+        ++m_Stats.m_Submitted;
+        if (IsLost() == true)
+        {
+            ++m_Stats.m_LostRandom;
+            return 0;
+        }
+
+        //  Token bucket: negative tokens are the backlog waiting for the link
+        amf_pts departure = now;
+        if (m_Params.m_Rate > 0)
+        {
+            if (m_LastRefill != 0)
+            {
+                m_Tokens = std::min(double(m_Params.m_Burst), m_Tokens + double(now - m_LastRefill) * m_Params.m_Rate / AMF_SECOND);
+            }
+            m_LastRefill = now;
+            if (m_Tokens - double(size) < -double(m_Params.m_QueueLimit))
+            {
+                ++m_Stats.m_LostQueue;
+                return 0;
+            }
+            m_Tokens -= double(size);
+            if (m_Tokens < 0)
+            {
+                departure += amf_pts(-m_Tokens * AMF_SECOND / m_Params.m_Rate);
+            }
+        }
+
+        departure += SampleDelay();
+        if (m_Params.m_Reorder > 0 && Chance(m_Params.m_Reorder) == true)
+        {
+            ++m_Stats.m_Reordered;
+            departure += m_Params.m_ReorderGap;
+        }
+        else
+        {   //  Jitter alone never reorders, just like a single queue on the path
+            departure = std::max(departure, m_LastDeparture);
+            m_LastDeparture = departure;
+        }
+
+        size_t copies = 0;
+        departures[copies++] = departure;
+        if (m_Params.m_Duplicate > 0 && Chance(m_Params.m_Duplicate) == true)
+        {
+            ++m_Stats.m_Duplicated;
+            departures[copies++] = departure;
+        }
+        m_Stats.m_BytesDelivered += size * copies;
+        return copies;
+    }
+
+    bool NetworkImpairment::Chance(double probability)
+    {
+        return probability > 0 && m_Uniform(m_Rng) < probability;
+    }
+
+    bool NetworkImpairment::IsLost()
+    {
+        bool lost = Chance(m_BadState == true ? m_Params.m_LossBad : m_Params.m_LossGood);
+        m_BadState = m_BadState == true ? Chance(m_Params.m_BadToGood) == false : Chance(m_Params.m_GoodToBad);
+        return lost;
+    }
+
+    amf_pts NetworkImpairment::SampleDelay()
+    {
+        double delay = double(m_Params.m_Delay);
+        if (m_Params.m_Jitter > 0)
+        {
+            double jitter = double(m_Params.m_Jitter);
+            switch (m_Params.m_Distribution)
+            {
+            case Distribution::UNIFORM:
+                delay += (m_Uniform(m_Rng) * 2.0 - 1.0) * jitter;
+                break;
+            case Distribution::NORMAL:
+                delay += std::normal_distribution<double>(0.0, jitter)(m_Rng);
+                break;
+            case Distribution::PARETO:
+                {   //  Heavy tail with shape 3, the mean extra delay equals the jitter
+                    static constexpr const double SHAPE = 3.0;
+                    double u = 1.0 - m_Uniform(m_Rng);
+                    delay += jitter * (SHAPE - 1.0) * (std::pow(u, -1.0 / SHAPE) - 1.0);
+                }
+                break;
+            }
+        }
+        return delay > 0 ? amf_pts(delay) : 0;
+    }
+}
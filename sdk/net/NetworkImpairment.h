@@ -0,0 +1,133 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+#pragma once
+
+#include "amf/public/include/core/Platform.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+namespace ssdk::net
+{
+    //  NetworkImpairment - a seeded model of a lossy network path used to reproduce loss, reordering, jitter, duplication
+    //  and bandwidth limits in-process, without tc netem. Schedule() decides the fate of each datagram, the caller is
+    //  responsible for holding it until the returned departure time. Not thread-safe.
+    //
+    //  The model is configured with a comma-separated string, all keys are optional:
+    //      loss=<%>                    Bernoulli loss, shorthand for a Gilbert-Elliott model which never leaves the good state
+    //      ge=<p%>:<r%>:<k%>:<h%>      Gilbert-Elliott loss: p - good to bad transition, r - bad to good transition,
+    //                                  k - loss probability in the good state, h - loss probability in the bad state
+    //      delay=<ms>                  Constant one-way delay
+    //      jitter=<ms>                 Delay variation, distributed according to dist
+    //      dist=uniform|normal|pareto  Jitter distribution, default = uniform
+    //      rate=<kbit/s>               Token bucket rate, 0 = unlimited
+    //      burst=<bytes>               Token bucket depth, default = 16 KB
+    //      queue=<bytes>               Maximum backlog behind the token bucket before tail drop, default = 256 KB
+    //      reorder=<%>                 Probability of a datagram being held back by reorder_gap and overtaken by the following ones
+    //      reorder_gap=<ms>            Default = 10
+    //      duplicate=<%>               Probability of a datagram being sent twice
+    //      mtu=<bytes>                 Largest datagram the path accepts, larger ones are rejected by the sender
+    //                                  with MESSAGE_TOO_BIG like on a link with DF set, 0 = unlimited (default)
+    //      seed=<n>                    RNG seed, default = 1
+    //  For example: "ge=1:30:0:50,delay=20,jitter=5,dist=normal,rate=20000,reorder=0.5,seed=42"
+    class NetworkImpairment
+    {
+    public:
+        enum class Distribution
+        {
+            UNIFORM,
+            NORMAL,
+            PARETO
+        };
+
+        struct Params
+        {
+            double          m_GoodToBad = 0;            //  Gilbert-Elliott p
+            double          m_BadToGood = 1;            //  Gilbert-Elliott r
+            double          m_LossGood = 0;             //  Gilbert-Elliott k
+            double          m_LossBad = 0;              //  Gilbert-Elliott h
+            amf_pts         m_Delay = 0;
+            amf_pts         m_Jitter = 0;
+            Distribution    m_Distribution = Distribution::UNIFORM;
+            int64_t         m_Rate = 0;                 //  bytes per second, 0 = unlimited
+            int64_t         m_Burst = 16 * 1024;
+            int64_t         m_QueueLimit = 256 * 1024;
+            double          m_Reorder = 0;
+            amf_pts         m_ReorderGap = 10 * AMF_MILLISECOND;
+            double          m_Duplicate = 0;
+            size_t          m_Mtu = 0;                  //  0 = unlimited
+            uint64_t        m_Seed = 1;
+
+            bool Parse(const std::string& spec);        //  Returns false on unknown keys or malformed values
+        };
+
+        struct Stats
+        {
+            uint64_t        m_Submitted = 0;
+            uint64_t        m_LostRandom = 0;           //  Dropped by the loss model
+            uint64_t        m_LostQueue = 0;            //  Tail-dropped by the token bucket
+            uint64_t        m_Duplicated = 0;
+            uint64_t        m_Reordered = 0;
+            uint64_t        m_BytesDelivered = 0;
+        };
+
+        static constexpr const size_t MAX_COPIES = 2;
+
+    public:
+        NetworkImpairment(const Params& params);
+
+        //  Returns the number of copies of a datagram of size bytes submitted at now which have to be sent, 0 when it is dropped.
+        //  departures receives the time each copy has to leave
+        size_t Schedule(size_t size, amf_pts now, amf_pts departures[MAX_COPIES]);
+
+        inline const Params&    GetParams() const noexcept { return m_Params; }
+        inline const Stats&     GetStats() const noexcept { return m_Stats; }
+
+    private:
+        bool    Chance(double probability);
+        bool    IsLost();
+        amf_pts SampleDelay();
+
+        Params                                  m_Params;
+        Stats                                   m_Stats;
+        std::mt19937_64                         m_Rng;
+        std::uniform_real_distribution<double>  m_Uniform{ 0.0, 1.0 };
+        bool                                    m_BadState = false;
+        double                                  m_Tokens = 0;
+        amf_pts                                 m_LastRefill = 0;
+        amf_pts                                 m_LastDeparture = 0;   //  Of the last datagram which was not reordered, keeps the rest FIFO
+    };
+}
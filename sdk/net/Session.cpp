@@ -59,6 +59,12 @@ namespace ssdk::net
 		AMFTraceDebug(AMF_FACILITY, L"Session destroyed");
     }
 
+    Socket::Address AMF_STD_CALL Session::GetPeerAddress() const
+    {
+        amf::AMFLock lock(&m_PeerGuard);
+        return m_Peer;
+    }
+
     time_t AMF_STD_CALL Session::GetElapsedTimeSinceLastRequest()
     {
         time_t now;
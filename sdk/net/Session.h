@@ -37,6 +37,7 @@ THE SOFTWARE.
 
 #include "Socket.h"
 #include "amf/public/common/InterfaceImpl.h"
+#include "amf/public/common/Thread.h"
 
 #include <memory>
 
@@ -77,7 +78,7 @@ namespace ssdk::net
         // interface
         virtual  void             AMF_STD_CALL Terminate();
 
-        const Socket::Address&      AMF_STD_CALL GetPeerAddress() const { return m_Peer; }
+        Socket::Address             AMF_STD_CALL GetPeerAddress() const;    //  A copy, the peer of a datagram session changes when the client migrates
         time_t                      AMF_STD_CALL GetLastRequestTime() const  { return m_LastReceivedTime; }
         time_t               AMF_STD_CALL GetElapsedTimeSinceLastRequest();
         bool                        AMF_STD_CALL IsTerminated() const { return m_bTerminated; }
@@ -99,6 +100,7 @@ namespace ssdk::net
 
 
     protected:
+        mutable amf::AMFCriticalSection m_PeerGuard;    //  Guards m_Peer, which is read by the threads of other receive shards
         Socket::Address m_Peer;
         time_t          m_LastReceivedTime;
         bool            m_bTerminated;
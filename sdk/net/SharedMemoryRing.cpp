@@ -0,0 +1,234 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "SharedMemoryRing.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#if defined(__linux)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::net::SharedMemoryRing";
+
+namespace ssdk::net
+{
+    static constexpr const uint32_t RING_MAGIC = 0x52444D53;   //  "SMDR"
+    static constexpr const size_t HEADER_SIZE = 4096;           //  The data starts on a page boundary
+
+    SharedMemoryRing::SharedMemoryRing()
+    {
+    }
+
+    SharedMemoryRing::~SharedMemoryRing()
+    {
+        Close();
+    }
+
+    SharedMemoryRing::Result SharedMemoryRing::Create(size_t capacity)
+    {
+        Close();
+        if (capacity == 0)
+        {
+            return Result::INVALID_ARG;
+        }
+        int fd = memfd_create("ssdk-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (fd == -1)
+        {
+            AMFTraceError(AMF_FACILITY, L"Create(): memfd_create() failed, errno=%d", errno);
+            return Result::SYSTEM_ERROR;
+        }
+        size_t mappingSize = HEADER_SIZE + capacity;
+        if (ftruncate(fd, off_t(mappingSize)) != 0)
+        {
+            AMFTraceError(AMF_FACILITY, L"Create(): failed to resize the ring to %zu bytes, errno=%d", mappingSize, errno);
+            close(fd);
+            return Result::SYSTEM_ERROR;
+        }
+        //  The consumer gets the same file, it must not be able to shrink it under the producer's mapping
+        if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+        {
+            AMFTraceError(AMF_FACILITY, L"Create(): failed to seal the ring, errno=%d", errno);
+            close(fd);
+            return Result::SYSTEM_ERROR;
+        }
+        Result result = Map(fd, mappingSize);
+        if (result == Result::OK)
+        {
+            m_Capacity = capacity;
+            m_WritePosition = 0;
+            m_Header->m_Magic = RING_MAGIC;
+            m_Header->m_Reserved = 0;
+            m_Header->m_Capacity = capacity;
+            m_Header->m_WritePosition.store(0, std::memory_order_relaxed);
+            m_Header->m_ReadPosition.store(0, std::memory_order_release);
+        }
+        return result;
+    }
+
+    SharedMemoryRing::Result SharedMemoryRing::Attach(int fd)
+    {
+        Close();
+        struct stat st = {};
+        if (fd == -1)
+        {
+            return Result::INVALID_ARG;
+        }
+        else if (fstat(fd, &st) != 0 || size_t(st.st_size) <= HEADER_SIZE)
+        {
+            AMFTraceError(AMF_FACILITY, L"Attach(): invalid ring handle");
+            close(fd);
+            return Result::INVALID_ARG;
+        }
+        Result result = Map(fd, size_t(st.st_size));
+        if (result == Result::OK && (m_Header->m_Magic != RING_MAGIC || m_Header->m_Capacity != m_MappingSize - HEADER_SIZE))
+        {
+            AMFTraceError(AMF_FACILITY, L"Attach(): ring header is corrupt");
+            Close();
+            result = Result::INVALID_ARG;
+        }
+        else if (result == Result::OK)
+        {
+            m_Capacity = m_MappingSize - HEADER_SIZE;
+        }
+        return result;
+    }
+
+    SharedMemoryRing::Result SharedMemoryRing::Map(int fd, size_t mappingSize)
+    {
+        void* mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            AMFTraceError(AMF_FACILITY, L"Map(): mmap() of %zu bytes failed, errno=%d", mappingSize, errno);
+            close(fd);
+            return Result::SYSTEM_ERROR;
+        }
+        m_Fd = fd;
+        m_Mapping = mapping;
+        m_MappingSize = mappingSize;
+        m_Header = static_cast<Header*>(mapping);
+        m_Data = static_cast<uint8_t*>(mapping) + HEADER_SIZE;
+        return Result::OK;
+    }
+
+    void SharedMemoryRing::Close()
+    {
+        if (m_Mapping != nullptr)
+        {
+            munmap(m_Mapping, m_MappingSize);
+            m_Mapping = nullptr;
+            m_MappingSize = 0;
+            m_Header = nullptr;
+            m_Data = nullptr;
+        }
+        m_Capacity = 0;
+        m_WritePosition = 0;
+        if (m_Fd != -1)
+        {
+            close(m_Fd);
+            m_Fd = -1;
+        }
+    }
+
+    SharedMemoryRing::Result SharedMemoryRing::Write(const void* buf, size_t size, uint64_t* position)
+    {
+        if (m_Header == nullptr)
+        {
+            return Result::NOT_OPEN;
+        }
+        uint64_t capacity = m_Capacity;
+        if (buf == nullptr || position == nullptr || size == 0 || size > capacity)
+        {
+            return Result::INVALID_ARG;
+        }
+
+        uint64_t writePosition = m_WritePosition;
+        uint64_t readPosition = m_Header->m_ReadPosition.load(std::memory_order_acquire);
+        if (readPosition > writePosition || writePosition - readPosition > capacity)
+        {
+            AMFTraceError(AMF_FACILITY, L"Write(): invalid read position %llu, write position %llu", static_cast<unsigned long long>(readPosition), static_cast<unsigned long long>(writePosition));
+            return Result::CORRUPT;
+        }
+        if (readPosition == writePosition)
+        {   //  Everything has been released, start over at the beginning so that skipping the tail cannot put the
+            //  write position more than the capacity ahead. The consumer has nothing left to release meanwhile
+            writePosition = 0;
+            m_Header->m_ReadPosition.store(0, std::memory_order_relaxed);
+        }
+        uint64_t offset = writePosition % capacity;
+        if (offset + size > capacity)
+        {
+            writePosition += capacity - offset;     //  Skip the tail, messages never wrap around
+        }
+        if (writePosition + size - readPosition > capacity)   //  The skipped tail counts as used until the consumer catches up
+        {
+            return Result::NO_SPACE;
+        }
+        memcpy(m_Data + writePosition % capacity, buf, size);
+        m_WritePosition = writePosition + size;
+        m_Header->m_WritePosition.store(m_WritePosition, std::memory_order_release);
+        *position = writePosition;
+        return Result::OK;
+    }
+
+    const uint8_t* SharedMemoryRing::Read(uint64_t position, size_t size) const
+    {
+        if (m_Header == nullptr)
+        {
+            return nullptr;
+        }
+        //  Neither the side channel nor the header shared with the producer is trusted, the capacity was validated by Attach()
+        uint64_t capacity = m_Capacity;
+        uint64_t writePosition = m_Header->m_WritePosition.load(std::memory_order_acquire);
+        uint64_t readPosition = m_Header->m_ReadPosition.load(std::memory_order_relaxed);
+        if (size == 0 || size > capacity || position < readPosition || position + size > writePosition || position % capacity + size > capacity)
+        {
+            return nullptr;
+        }
+        return m_Data + position % capacity;
+    }
+
+    void SharedMemoryRing::Release(uint64_t position, size_t size)
+    {
+        if (m_Header != nullptr)
+        {
+            m_Header->m_ReadPosition.store(position + size, std::memory_order_release);
+        }
+    }
+}
+#endif
@@ -0,0 +1,117 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#if defined(__linux)
+namespace ssdk::net
+{
+    //  SharedMemoryRing - a single-producer, single-consumer byte ring in a memfd mapping, used to pass bulk payloads
+    //  between processes on the same host without copying them through a socket. The producer creates the ring and
+    //  passes its file descriptor to the consumer, for example with UnixStreamSocket::SendFd(). Every message is stored
+    //  contiguously, the producer skips the tail of the ring when a message does not fit before the wrap-around.
+    //
+    //  Message positions are monotonically increasing byte counters, the producer tells the consumer where each message
+    //  is through a side channel. The consumer must release messages in the order they were written.
+    //
+    //  Each side can write the shared header, so neither trusts what the other one stores there: the capacity and its own
+    //  position are kept in private members, the position of the peer is validated before it is used
+    class SharedMemoryRing
+    {
+    public:
+        typedef std::shared_ptr<SharedMemoryRing>   Ptr;
+
+        enum class Result
+        {
+            OK,
+            INVALID_ARG,
+            NOT_OPEN,
+            NO_SPACE,
+            CORRUPT,            //  The peer stored a position in the header it could not have reached
+            SYSTEM_ERROR
+        };
+
+    public:
+        SharedMemoryRing();
+        ~SharedMemoryRing();
+
+        Result Create(size_t capacity);                                     //  Producer: allocate a new ring
+        Result Attach(int fd);                                              //  Consumer: map a ring created by the producer, takes ownership of fd
+        void Close();
+
+        inline bool IsOpen() const noexcept { return m_Header != nullptr; }
+        inline int GetHandle() const noexcept { return m_Fd; }
+        inline size_t GetCapacity() const noexcept { return m_Capacity; }
+
+        //  Producer:
+        Result Write(const void* buf, size_t size, uint64_t* position);     //  Copies buf into the ring, fails with NO_SPACE when the consumer is too far behind
+                                                                            //  and with CORRUPT when the consumer's read position is not valid
+
+        //  Consumer:
+        const uint8_t* Read(uint64_t position, size_t size) const;         //  Returns nullptr when [position, position + size) is not a valid unreleased message
+        void Release(uint64_t position, size_t size);                      //  Hands the space up to position + size back to the producer
+
+    private:
+        struct Header
+        {
+            uint32_t                m_Magic;
+            uint32_t                m_Reserved;
+            uint64_t                m_Capacity;
+            std::atomic<uint64_t>   m_WritePosition;
+            std::atomic<uint64_t>   m_ReadPosition;
+        };
+        static_assert(std::atomic<uint64_t>::is_always_lock_free == true, "SharedMemoryRing requires lock-free 64-bit atomics");
+
+        Result Map(int fd, size_t mappingSize);
+
+    private:
+        SharedMemoryRing(const SharedMemoryRing&) = delete;
+        SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+    private:
+        int             m_Fd = -1;
+        void*           m_Mapping = nullptr;
+        size_t          m_MappingSize = 0;
+        Header*         m_Header = nullptr;
+        uint8_t*        m_Data = nullptr;
+        size_t          m_Capacity = 0;                 //  Never read back from the header after Create() or Attach()
+        uint64_t        m_WritePosition = 0;            //  Producer only
+    };
+}
+#endif
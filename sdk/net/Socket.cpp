@@ -588,6 +588,93 @@ namespace ssdk::net
         return result;
     }
 
+    Socket::Result Socket::GetSocketOpt(int level, int option, void* value, size_t* valueSize) const
+    {
+        Socket::Result result = Result::OK;
+        if (m_Socket == INVALID_SOCKET)
+        {
+            result = Result::SOCKET_NOT_OPEN;
+            AMFTraceError(AMF_FACILITY, L"GetSocketOpt() err=%s ", GetErrorString(result));
+        }
+        else if (value == nullptr || valueSize == nullptr)
+        {
+            result = Result::INVALID_ARG;
+            AMFTraceError(AMF_FACILITY, L"GetSocketOpt() err=%s ", GetErrorString(result));
+        }
+        else
+        {
+            socklen_t size = (socklen_t)*valueSize;
+            if (::getsockopt(m_Socket, level, option, static_cast<char*>(value), &size) != 0)
+            {
+                int errcode = GetSocketOSError();
+                result = GetError(errcode);
+                AMFTraceError(AMF_FACILITY, L"GetSocketOpt() getsockopt() failed: err=%s socketerr=%d", GetErrorString(result), errcode);
+            }
+            else
+            {
+                *valueSize = size;
+            }
+        }
+        return result;
+    }
+
+    uint8_t Socket::GetTypeOfService(TrafficClass trafficClass)
+    {
+        static constexpr const uint8_t DSCP_CS0 = 0;
+        static constexpr const uint8_t DSCP_AF41 = 34;
+        static constexpr const uint8_t DSCP_EF = 46;
+
+        uint8_t dscp = DSCP_CS0;
+        switch (trafficClass)
+        {
+        case TrafficClass::VIDEO:
+            dscp = DSCP_AF41;
+            break;
+        case TrafficClass::INTERACTIVE:
+            dscp = DSCP_EF;
+            break;
+        default:
+            break;
+        }
+        return uint8_t(dscp << 2);
+    }
+
+    Socket::Result Socket::SetTrafficClass(TrafficClass trafficClass)
+    {
+#if defined(_WIN32)
+        //  Windows ignores IP_TOS unless the DisableUserTOSSetting policy is changed, marking has to go through qWAVE
+        (void)trafficClass;
+        return Result::OPERATION_NOT_SUPPORTED;
+#else
+        Socket::Result result = Result::OK;
+        int tos = GetTypeOfService(trafficClass);
+        if (m_AddrFamily == AddressFamily::ADDR_IP)
+        {
+            result = SetSocketOpt(IPPROTO_IP, IP_TOS, &tos, sizeof(tos));
+        }
+        else if (m_AddrFamily == AddressFamily::ADDR_IP6)
+        {
+            result = SetSocketOpt(IPPROTO_IPV6, IPV6_TCLASS, &tos, sizeof(tos));
+        }
+        else
+        {
+            result = Result::OPERATION_NOT_SUPPORTED;
+        }
+#if defined(__linux)
+        if (result == Result::OK)
+        {   //  Also picks the queue in the local qdisc and the WMM access category on Wi-Fi, which the DSCP alone does not on every driver
+            int priority = trafficClass == TrafficClass::INTERACTIVE ? 6 : (trafficClass == TrafficClass::VIDEO ? 5 : 0);
+            SetSocketOpt(SOL_SOCKET, SO_PRIORITY, &priority, sizeof(priority));
+        }
+#endif
+        if (result == Result::OK)
+        {
+            m_TrafficClass = trafficClass;
+        }
+        return result;
+#endif
+    }
+
     void Socket::SetTimeout(int seconds)
     {
         m_Timeout = seconds;
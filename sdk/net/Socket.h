@@ -34,6 +34,7 @@ THE SOFTWARE.
 */
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <map>
 #include <set>
@@ -143,6 +144,14 @@ namespace ssdk::net
             PROTO_UDP = IPPROTO_UDP
         };
 
+        //  DiffServ class outgoing traffic is marked with, see SetTrafficClass() and DatagramSocket::SendTo()
+        enum class TrafficClass
+        {
+            BEST_EFFORT,    //  DSCP CS0
+            VIDEO,          //  DSCP AF41, interactive video
+            INTERACTIVE     //  DSCP EF, small latency-critical messages such as audio and input
+        };
+
         class Address
         {
         public:
@@ -306,6 +315,13 @@ namespace ssdk::net
         virtual Socket::Result Receive(void* buf, size_t size, size_t* bytesReceived, int flags = 0);	//	Reads whatever is available and returns. Equivalent to recv()
 
         virtual Socket::Result SetSocketOpt(int level, int option, const void* value, size_t valueSize);
+        virtual Socket::Result GetSocketOpt(int level, int option, void* value, size_t* valueSize) const;
+
+        Socket::Result SetTrafficClass(TrafficClass trafficClass);  //  Set the DSCP (and SO_PRIORITY on Linux) of everything sent through the socket.
+                                                                    //  Returns OPERATION_NOT_SUPPORTED on Windows, where marking requires qWAVE
+        inline TrafficClass GetTrafficClass() const throw() { return m_TrafficClass; }
+
+        static uint8_t GetTypeOfService(TrafficClass trafficClass); //  IP_TOS/IPV6_TCLASS byte: the DSCP shifted past the ECN bits
 
         void SetTimeout(int seconds);
         inline int GetTimeout() const { return m_Timeout; }
@@ -334,5 +350,6 @@ namespace ssdk::net
         Protocol        m_Protocol;
         Address::Ptr    m_PeerAddress;
         int				m_Timeout = 0;
+        TrafficClass    m_TrafficClass = TrafficClass::BEST_EFFORT;
     };
 }
\ No newline at end of file
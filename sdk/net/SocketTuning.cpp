@@ -0,0 +1,126 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "SocketTuning.h"
+#include "DatagramSocket.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#include <algorithm>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::net::SocketTuning";
+
+namespace ssdk::net
+{
+    int SocketTuning::GetBufferSizeFor(int64_t maxBitrate, amf_pts frameInterval)
+    {
+        int64_t averageFrameSize = maxBitrate > 0 && frameInterval > 0 ? maxBitrate / 8 * frameInterval / AMF_SECOND : 0;
+        return int(std::clamp<int64_t>(averageFrameSize * KEY_FRAME_BURST, MIN_BUFFER_SIZE, MAX_BUFFER_SIZE));
+    }
+
+    Socket::Result SocketTuning::Apply(Socket* socket) const
+    {
+        AMF_RETURN_IF_FALSE(socket != nullptr, Socket::Result::INVALID_ARG, L"Apply() - socket must not be NULL");
+        AMF_RETURN_IF_FALSE(socket->GetNativeHandle() != INVALID_SOCKET, Socket::Result::SOCKET_NOT_OPEN, L"Apply() - socket is not open");
+
+#if defined(__linux)
+        SetBufferSize(socket, SO_RCVBUF, SO_RCVBUFFORCE, m_ReceiveBufferSize, L"receive");
+        SetBufferSize(socket, SO_SNDBUF, SO_SNDBUFFORCE, m_SendBufferSize, L"send");
+
+        if (m_BusyPoll > 0)
+        {   //  Raising it above net.core.busy_read requires CAP_NET_ADMIN
+            int busyPoll = m_BusyPoll;
+            if (socket->SetSocketOpt(SOL_SOCKET, SO_BUSY_POLL, &busyPoll, sizeof(busyPoll)) != Socket::Result::OK)
+            {
+                AMFTraceWarning(AMF_FACILITY, L"Apply() - unable to set SO_BUSY_POLL to %dus", busyPoll);
+            }
+        }
+#else
+        SetBufferSize(socket, SO_RCVBUF, SO_RCVBUF, m_ReceiveBufferSize, L"receive");
+        SetBufferSize(socket, SO_SNDBUF, SO_SNDBUF, m_SendBufferSize, L"send");
+#endif
+
+        if (m_TrafficClass != socket->GetTrafficClass())
+        {
+            Socket::Result result = socket->SetTrafficClass(m_TrafficClass);
+            if (result == Socket::Result::OPERATION_NOT_SUPPORTED)
+            {
+                AMFTraceDebug(AMF_FACILITY, L"Apply() - traffic marking is not supported on this platform");
+            }
+            else if (result != Socket::Result::OK)
+            {
+                AMFTraceWarning(AMF_FACILITY, L"Apply() - unable to mark traffic, err=%s", Socket::GetErrorString(result));
+            }
+        }
+
+        if (m_CountReceiveDrops == true)
+        {
+            DatagramSocket::Ptr datagramSocket(socket);
+            if (datagramSocket != nullptr && datagramSocket->SetCountReceiveDrops(true) != Socket::Result::OK)
+            {
+                AMFTraceDebug(AMF_FACILITY, L"Apply() - receive drops are not counted on this platform");
+            }
+        }
+        return Socket::Result::OK;
+    }
+
+    void SocketTuning::SetBufferSize(Socket* socket, int option, int forceOption, int size, const wchar_t* name) const
+    {
+        if (size <= 0)
+        {
+            return;
+        }
+        //  Linux silently caps SO_RCVBUF/SO_SNDBUF at net.core.rmem_max/wmem_max, the FORCE variants ignore the cap
+        //  but need CAP_NET_ADMIN. Try those quietly first, as failing is the normal case for an unprivileged process
+        if (forceOption == option ||
+            ::setsockopt(socket->GetNativeHandle(), SOL_SOCKET, forceOption, reinterpret_cast<const char*>(&size), sizeof(size)) != 0)
+        {
+            socket->SetSocketOpt(SOL_SOCKET, option, &size, sizeof(size));
+        }
+
+        int effective = 0;
+        size_t effectiveSize = sizeof(effective);
+        if (socket->GetSocketOpt(SOL_SOCKET, option, &effective, &effectiveSize) == Socket::Result::OK)
+        {
+#if defined(__linux)
+            effective /= 2;     //  Reported doubled to account for the kernel's bookkeeping overhead
+#endif
+            if (effective < size)
+            {
+                AMFTraceWarning(AMF_FACILITY, L"Socket %s buffer is %d bytes instead of %d, key frame bursts may be dropped. Raise the system limit to fix",
+                                name, effective, size);
+            }
+        }
+    }
+}
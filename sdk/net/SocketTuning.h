@@ -0,0 +1,85 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+#pragma once
+
+#include "Socket.h"
+#include "amf/public/include/core/Platform.h"
+
+namespace ssdk::net
+{
+    //  SocketTuning - the kernel settings a streaming socket is created with: buffers large enough to absorb a key frame
+    //  burst, optional busy polling of the NIC queue and the DiffServ class of its traffic. Apply() sets whatever the
+    //  platform supports and traces a warning for the rest, a socket that cannot be tuned still works, just worse
+    class SocketTuning
+    {
+    public:
+        static constexpr const int MIN_BUFFER_SIZE = 256 * 1024;
+        static constexpr const int MAX_BUFFER_SIZE = 32 * 1024 * 1024;
+        static constexpr const int KEY_FRAME_BURST = 16;    //  A key frame at 4K is up to this many average frames in size, and is sent at once
+
+    public:
+        SocketTuning() = default;
+
+        //  Buffer size holding one key frame burst at the peak bitrate, within MIN_BUFFER_SIZE and MAX_BUFFER_SIZE
+        static int GetBufferSizeFor(int64_t maxBitrate, amf_pts frameInterval);
+
+        inline int GetReceiveBufferSize() const noexcept { return m_ReceiveBufferSize; }
+        inline void SetReceiveBufferSize(int size) noexcept { m_ReceiveBufferSize = size; }     //  0 leaves the system default
+
+        inline int GetSendBufferSize() const noexcept { return m_SendBufferSize; }
+        inline void SetSendBufferSize(int size) noexcept { m_SendBufferSize = size; }           //  0 leaves the system default
+
+        inline int GetBusyPoll() const noexcept { return m_BusyPoll; }
+        inline void SetBusyPoll(int microseconds) noexcept { m_BusyPoll = microseconds; }       //  SO_BUSY_POLL, 0 disables. Linux only
+
+        inline Socket::TrafficClass GetTrafficClass() const noexcept { return m_TrafficClass; }
+        inline void SetTrafficClass(Socket::TrafficClass trafficClass) noexcept { m_TrafficClass = trafficClass; }
+
+        inline bool GetCountReceiveDrops() const noexcept { return m_CountReceiveDrops; }
+        inline void SetCountReceiveDrops(bool countDrops) noexcept { m_CountReceiveDrops = countDrops; }    //  SO_RXQ_OVFL on datagram sockets. Linux only
+
+        Socket::Result Apply(Socket* socket) const;     //  Fails only when the socket is not open
+
+    private:
+        void SetBufferSize(Socket* socket, int option, int forceOption, int size, const wchar_t* name) const;
+
+    private:
+        int                     m_ReceiveBufferSize = 0;
+        int                     m_SendBufferSize = 0;
+        int                     m_BusyPoll = 0;
+        Socket::TrafficClass    m_TrafficClass = Socket::TrafficClass::BEST_EFFORT;
+        bool                    m_CountReceiveDrops = false;
+    };
+}
@@ -0,0 +1,263 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "TimerWheel.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#include <algorithm>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::net::TimerWheel";
+
+namespace ssdk::net
+{
+    static constexpr const uint64_t SLOT_MASK = TimerWheel::SLOTS - 1;
+    static constexpr const uint64_t MAX_TICKS = (uint64_t(1) << (TimerWheel::SLOT_BITS * TimerWheel::LEVELS)) - 1;
+
+    TimerWheel::TimerWheel(amf_pts resolution) :
+        m_Resolution(resolution > 0 ? resolution : DEFAULT_RESOLUTION)
+    {
+    }
+
+    TimerWheel::TimerID TimerWheel::Schedule(amf_pts delay, Callback callback, amf_pts period)
+    {
+        AMF_RETURN_IF_FALSE(callback != nullptr, INVALID_TIMER, L"Schedule() - callback must not be empty");
+
+        amf::AMFLock lock(&m_Guard);
+        TimerID id = ++m_NextID;
+        Timer& timer = m_Timers[id];
+        timer.m_Expires = m_CurrentTick + ToTicks(delay);     //  Rounded up, a timer never fires early
+        timer.m_Period = period > 0 ? std::max<uint64_t>(ToTicks(period), 1) : 0;
+        timer.m_Callback = std::move(callback);
+        Link(id, timer);
+        return id;
+    }
+
+    bool TimerWheel::Cancel(TimerID timer)
+    {
+        amf::AMFLock lock(&m_Guard);
+        Timers::iterator it = m_Timers.find(timer);
+        if (it == m_Timers.end())
+        {
+            return false;
+        }
+        Unlink(it->second);
+        m_Timers.erase(it);
+        return true;
+    }
+
+    void TimerWheel::Clear()
+    {
+        amf::AMFLock lock(&m_Guard);
+        for (size_t level = 0; level < LEVELS; ++level)
+        {
+            for (size_t slot = 0; slot < SLOTS; ++slot)
+            {
+                m_Wheel[level][slot].clear();
+            }
+        }
+        m_Timers.clear();
+    }
+
+    size_t TimerWheel::GetTimerCount() const noexcept
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_Timers.size();
+    }
+
+    size_t TimerWheel::Advance(amf_pts now)
+    {
+        std::vector<TimerID> due;
+        {
+            amf::AMFLock lock(&m_Guard);
+            if (m_Origin < 0)
+            {
+                m_Origin = now;
+            }
+            if (now < m_Origin)
+            {
+                return 0;
+            }
+            uint64_t target = uint64_t(now - m_Origin) / m_Resolution;
+
+            while (m_CurrentTick <= target)
+            {
+                if (m_Timers.empty() == true)
+                {   //  Nothing to cascade or fire, skip the idle ticks
+                    m_CurrentTick = target + 1;
+                    break;
+                }
+
+                size_t index = size_t(m_CurrentTick & SLOT_MASK);
+                if (index == 0)
+                {
+                    for (size_t level = 1; level < LEVELS && Cascade(level) == true; ++level)
+                    {
+                    }
+                }
+
+                std::list<TimerID> expired;
+                expired.swap(m_Wheel[0][index]);
+                for (TimerID id : expired)
+                {
+                    Timer& timer = m_Timers[id];
+                    timer.m_Slot = nullptr;
+                    if (timer.m_Period > 0)
+                    {   //  Missed periods are skipped rather than fired in a burst
+                        timer.m_Expires += timer.m_Period;
+                        if (timer.m_Expires <= target)
+                        {
+                            timer.m_Expires = target + timer.m_Period;
+                        }
+                        Link(id, timer);
+                    }
+                    due.push_back(id);
+                }
+                ++m_CurrentTick;
+            }
+        }
+
+        //  Callbacks are called without holding the lock, a timer cancelled by an earlier callback is not fired
+        size_t fired = 0;
+        for (TimerID id : due)
+        {
+            Callback callback;
+            {
+                amf::AMFLock lock(&m_Guard);
+                Timers::iterator it = m_Timers.find(id);
+                if (it == m_Timers.end())
+                {
+                    continue;
+                }
+                if (it->second.m_Period > 0)
+                {
+                    callback = it->second.m_Callback;
+                }
+                else
+                {
+                    callback = std::move(it->second.m_Callback);
+                    m_Timers.erase(it);
+                }
+            }
+            callback();
+            ++fired;
+        }
+        return fired;
+    }
+
+    void TimerWheel::Link(TimerID id, Timer& timer)
+    {
+        if (timer.m_Expires < m_CurrentTick)
+        {
+            timer.m_Expires = m_CurrentTick;
+        }
+        else if (timer.m_Expires - m_CurrentTick > MAX_TICKS)
+        {
+            timer.m_Expires = m_CurrentTick + MAX_TICKS;
+        }
+
+        uint64_t delta = timer.m_Expires - m_CurrentTick;
+        size_t level = 0;
+        while (level < LEVELS - 1 && delta >= (uint64_t(1) << ((level + 1) * SLOT_BITS)))
+        {
+            ++level;
+        }
+        timer.m_Slot = &m_Wheel[level][(timer.m_Expires >> (level * SLOT_BITS)) & SLOT_MASK];
+        timer.m_Position = timer.m_Slot->insert(timer.m_Slot->end(), id);
+    }
+
+    void TimerWheel::Unlink(Timer& timer)
+    {
+        if (timer.m_Slot != nullptr)
+        {
+            timer.m_Slot->erase(timer.m_Position);
+            timer.m_Slot = nullptr;
+        }
+    }
+
+    bool TimerWheel::Cascade(size_t level)
+    {
+        size_t index = size_t((m_CurrentTick >> (level * SLOT_BITS)) & SLOT_MASK);
+        std::list<TimerID> timers;
+        timers.swap(m_Wheel[level][index]);
+        for (TimerID id : timers)
+        {
+            Link(id, m_Timers[id]);
+        }
+        return index == 0;
+    }
+
+    uint64_t TimerWheel::ToTicks(amf_pts duration) const noexcept
+    {
+        return duration > 0 ? uint64_t((duration + m_Resolution - 1) / m_Resolution) : 0;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+    TimerService::TimerService(amf_pts resolution) :
+        TimerWheel(resolution),
+        m_Thread(*this)
+    {
+    }
+
+    TimerService::~TimerService()
+    {
+        Stop();
+    }
+
+    bool TimerService::Start()
+    {
+        return m_Thread.IsRunning() == true || m_Thread.Start() == true;
+    }
+
+    void TimerService::Stop()
+    {
+        if (m_Thread.IsRunning() == true)
+        {
+            m_Thread.RequestStop();
+            m_Thread.WaitForStop();
+        }
+    }
+
+    void TimerService::TimerThread::Run()
+    {
+        amf_uint32 sleepMs = std::max<amf_uint32>(amf_uint32(m_Object.GetResolution() / AMF_MILLISECOND), 1);
+        AMFTraceDebug(AMF_FACILITY, L"TimerService thread started, resolution %u ms", sleepMs);
+        while (StopRequested() == false)
+        {
+            m_Object.Advance(amf_high_precision_clock());
+            amf_sleep(sleepMs);
+        }
+        AMFTraceDebug(AMF_FACILITY, L"TimerService thread terminated");
+    }
+}
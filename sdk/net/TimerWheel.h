@@ -0,0 +1,136 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+#pragma once
+
+#include "amf/public/include/core/Platform.h"
+#include "amf/public/common/Thread.h"
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace ssdk::net
+{
+    //  TimerWheel - a hierarchical timing wheel for housekeeping timeouts, scheduling and cancelling a timer are O(1)
+    //  regardless of how many timers are pending. Time advances in ticks of the wheel's resolution; the first level
+    //  holds the timers due within SLOTS ticks, every next level covers SLOTS times the span of the previous one and its
+    //  slots are cascaded into the lower levels as the time reaches them.
+    //
+    //  The wheel has no thread of its own: whoever owns it calls Advance() with the current time, and the callbacks of
+    //  all timers due by then run on the calling thread outside of the wheel's lock, so they may schedule and cancel
+    //  timers. Delays are counted from the time passed to the last Advance()
+    class TimerWheel
+    {
+    public:
+        typedef uint64_t                TimerID;
+        typedef std::function<void()>   Callback;
+
+        static constexpr const TimerID INVALID_TIMER = 0;
+        static constexpr const amf_pts DEFAULT_RESOLUTION = 10 * AMF_MILLISECOND;
+        static constexpr const size_t SLOT_BITS = 6;
+        static constexpr const size_t SLOTS = size_t(1) << SLOT_BITS;
+        static constexpr const size_t LEVELS = 4;                               //  64^4 ticks, over 46 hours at 10ms resolution
+
+    public:
+        TimerWheel(amf_pts resolution = DEFAULT_RESOLUTION);
+        virtual ~TimerWheel() = default;
+
+        TimerID Schedule(amf_pts delay, Callback callback, amf_pts period = 0); //  Periodic when period is not 0, fires at most once per Advance()
+        bool Cancel(TimerID timer);                                             //  Returns false when the timer has already fired or was cancelled
+        void Clear();
+
+        size_t Advance(amf_pts now);                                            //  Fires all timers due by now, returns how many have fired
+
+        inline amf_pts GetResolution() const noexcept { return m_Resolution; }
+        size_t GetTimerCount() const noexcept;
+
+    private:
+        class Timer
+        {
+        public:
+            uint64_t                        m_Expires = 0;  //  In ticks
+            uint64_t                        m_Period = 0;   //  In ticks, 0 for a one-shot timer
+            Callback                        m_Callback;
+            std::list<TimerID>*             m_Slot = nullptr;
+            std::list<TimerID>::iterator    m_Position;
+        };
+        typedef std::unordered_map<TimerID, Timer>  Timers;
+
+        void Link(TimerID id, Timer& timer);
+        void Unlink(Timer& timer);
+        bool Cascade(size_t level);
+        uint64_t ToTicks(amf_pts duration) const noexcept;
+
+    private:
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+    private:
+        mutable amf::AMFCriticalSection m_Guard;
+        const amf_pts                   m_Resolution;
+        amf_pts                         m_Origin = -1;      //  Time of the first Advance(), tick 0
+        uint64_t                        m_CurrentTick = 0;  //  Next tick to be processed
+        TimerID                         m_NextID = INVALID_TIMER;
+        Timers                          m_Timers;
+        std::list<TimerID>              m_Wheel[LEVELS][SLOTS];
+    };
+
+    //  TimerService - a TimerWheel driven by its own thread, for owners that have no loop of their own to advance it in
+    class TimerService : public TimerWheel
+    {
+    public:
+        TimerService(amf_pts resolution = DEFAULT_RESOLUTION);
+        virtual ~TimerService();
+
+        bool Start();
+        void Stop();
+        inline bool IsRunning() { return m_Thread.IsRunning(); }
+
+    private:
+        class TimerThread : public amf::AMFThread
+        {
+        public:
+            TimerThread(TimerService& obj) : m_Object(obj) {}
+
+            virtual void Run() override;
+
+        private:
+            TimerService& m_Object;
+        };
+        TimerThread m_Thread;
+    };
+}
@@ -129,6 +129,23 @@ namespace ssdk::net
 		return Result::UNKNOWN_ERROR;
 	}
 
+	Socket::Result UnixStreamSocket::GetPeerUid(uid_t* uid)
+	{
+		struct ucred cred = {};
+		socklen_t credSize = sizeof(cred);
+		if (uid == nullptr)
+		{
+			return Result::INVALID_ARG;
+		}
+		if (getsockopt(m_Socket, SOL_SOCKET, SO_PEERCRED, &cred, &credSize) != 0 || credSize != sizeof(cred))
+		{
+			AMFTraceError(AMF_FACILITY, L"getsockopt(SO_PEERCRED) failed, error=%S", strerror(errno));
+			return Result::UNKNOWN_ERROR;
+		}
+		*uid = cred.uid;
+		return Result::OK;
+	}
+
 	StreamSocket::Ptr UnixStreamSocket::CreateSocket(Socket::Socket_t handle, Socket::Address::Ptr peerAddress)
 	{
 		return StreamSocket::Ptr(new UnixStreamSocket(handle, peerAddress));
@@ -56,6 +56,7 @@ namespace ssdk::net
 
         virtual Socket::Result SendFd(int fd);
         virtual Socket::Result RecvFd(int* fd);
+        virtual Socket::Result GetPeerUid(uid_t* uid);     //  Effective user of the connected peer process, from SO_PEERCRED
     protected:
         UnixStreamSocket(Socket_t handle, Socket::Address::Ptr peerAddress);
         virtual StreamSocket::Ptr CreateSocket(Socket::Socket_t handle, Socket::Address::Ptr peerAddress) override;
@@ -96,6 +96,15 @@ namespace ssdk::net
             {
                 Trace(L"Url::Init()", url, result);
             }
+            else if (IsLocal() == true)
+            {
+                m_Port = 0;
+                m_PortStr.clear();
+                if ((result = FindLocalPath(url, &m_Host)) != Result::OK)
+                {
+                    Trace(L"Url::Init()", url, result);
+                }
+            }
             else if ((result = FindPort(url, defaultPort, &m_PortStr, &m_Port)) != Result::OK)
             {
                 Trace(L"Url::Init()", url, result);
@@ -231,14 +240,32 @@ namespace ssdk::net
         return result;
     }
 
+    Url::Result Url::FindLocalPath(const std::string& url, std::string* path) const
+    {
+        Url::Result result = Result::INVALID_HOST;
+        std::string::size_type startPos = url.find(PROTOCOL_DELIM);
+        if (startPos != url.npos)
+        {
+            path->assign(url, startPos + PROTOCOL_DELIM_LEN, url.npos);
+            if (path->empty() == false)
+            {
+                result = Result::OK;
+            }
+        }
+        return result;
+    }
+
 	const std::string Url::GetUrl() const throw()
 	{
 		std::string url;
 		url += m_Protocol;
 		url += "://";
 		url += m_Host;
-		url += ":";
-		url += m_PortStr;
+		if (IsLocal() == false)
+		{
+			url += ":";
+			url += m_PortStr;
+		}
 		return url;
 	}
 
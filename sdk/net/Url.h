@@ -42,6 +42,8 @@ namespace ssdk::net
     class Url
     {
     public:
+        static constexpr const char* PROTOCOL_LOCAL = "LOCAL";
+
         enum class Result
         {
             OK,
@@ -70,6 +72,11 @@ namespace ssdk::net
 		void SetPort(unsigned short port) throw();
 
         inline const std::string& GetPortAsString() const throw() { return m_PortStr; }
+
+        //  local://<name> or local:///<path> - a same-host connection over a Unix domain socket, the host holds the name or the path
+        //  and there is no port. Names which do not start with '/' are in the Linux abstract socket namespace
+        inline bool IsLocal() const throw() { return m_Protocol == PROTOCOL_LOCAL; }
+
          bool operator==(const Url& rhs) const;
          bool operator!=(const Url& rhs) const;
 
@@ -79,6 +86,7 @@ namespace ssdk::net
         Result FindProtocol(const std::string& url, const std::string& defaultProtocol, std::string* protocol) const;
         Result FindPort(const std::string& url, unsigned short defaultPort, std::string* portStr, unsigned short* port) const;
         Result FindHost(const std::string& url, std::string* host) const;
+        Result FindLocalPath(const std::string& url, std::string* path) const;
 
         void Trace(const std::wstring& message, const std::string& url, Url::Result error) const;
 
@@ -0,0 +1,141 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "AudioRedundancy.h"
+
+#include <cstring>
+
+namespace ssdk::transport_amd
+{
+    //  A frame this far behind the last one is taken for a restarted sequence rather than a late frame
+    static constexpr int64_t LATE_FRAMES_WINDOW = 64;
+
+    void AudioRedundancyHistory::SetDepth(size_t depth)
+    {
+        m_Depth = depth;
+        while (m_Frames.size() > m_Depth)
+        {
+            m_Frames.pop_front();
+        }
+    }
+
+    void AudioRedundancyHistory::Push(int64_t sequenceNumber, amf_pts pts, amf_pts duration, const void* data, size_t size)
+    {
+        if (m_Depth == 0)
+        {
+            return;
+        }
+        if (m_Frames.empty() == false)
+        {
+            if (sequenceNumber <= m_Frames.back().sequenceNumber && sequenceNumber >= m_Frames.front().sequenceNumber)
+            {
+                return;     //  Already stored when the frame was sent to another session
+            }
+            if (sequenceNumber < m_Frames.back().sequenceNumber)
+            {
+                m_Frames.clear();   //  The sequence restarted
+            }
+        }
+        //  The newest frame is only needed once the next one is sent, keep one extra
+        if (m_Frames.size() > m_Depth)
+        {
+            m_Frames.pop_front();
+        }
+        Frame frame;
+        frame.sequenceNumber = sequenceNumber;
+        frame.pts = pts;
+        frame.duration = duration;
+        frame.payload.resize(size);
+        memcpy(frame.payload.data(), data, size);
+        m_Frames.push_back(std::move(frame));
+    }
+
+    void AudioRedundancyHistory::Collect(int64_t sequenceNumber, Frames& frames) const
+    {
+        frames.clear();
+        for (const Frame& frame : m_Frames)
+        {
+            if (frame.sequenceNumber < sequenceNumber && frame.sequenceNumber >= sequenceNumber - int64_t(m_Depth))
+            {
+                frames.push_back(&frame);
+            }
+        }
+    }
+
+    void AudioRedundancyHistory::Reset() noexcept
+    {
+        m_Frames.clear();
+    }
+
+    bool AudioLossRecovery::OnFrame(int64_t sequenceNumber, bool discontinuity, const std::vector<int64_t>& redundantSequenceNumbers, std::vector<size_t>& recover)
+    {
+        recover.clear();
+        ++m_Stats.received;
+        if (m_Started == false || discontinuity == true || sequenceNumber < m_LastSequenceNumber - LATE_FRAMES_WINDOW)
+        {   //  Nothing to compare against
+            m_Started = true;
+            m_LastSequenceNumber = sequenceNumber;
+            return true;
+        }
+        if (sequenceNumber <= m_LastSequenceNumber)
+        {   //  A late or retransmitted frame: a redundant copy was played in its place, or it was concealed or skipped
+            return false;
+        }
+        int64_t missing = sequenceNumber - m_LastSequenceNumber - 1;
+        if (missing > 0)
+        {
+            m_Stats.lost += missing;
+            int64_t next = m_LastSequenceNumber + 1;
+            for (size_t i = 0; i < redundantSequenceNumbers.size(); ++i)
+            {   //  Redundant copies are sent oldest first, so a single pass delivers them in order
+                if (redundantSequenceNumbers[i] >= next && redundantSequenceNumbers[i] < sequenceNumber)
+                {
+                    recover.push_back(i);
+                    next = redundantSequenceNumbers[i] + 1;
+                    ++m_Stats.recovered;
+                }
+            }
+        }
+        m_LastSequenceNumber = sequenceNumber;
+        return true;
+    }
+
+    void AudioLossRecovery::Reset() noexcept
+    {
+        m_Started = false;
+        m_LastSequenceNumber = 0;
+        m_Stats = {};
+    }
+}
@@ -0,0 +1,112 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "amf/public/include/core/Platform.h"
+
+#include <deque>
+#include <vector>
+
+namespace ssdk::transport_amd
+{
+    static constexpr const char* OPTION_AUDIO_REDUNDANCY = "AudioRedundancy";     // HELLO response option, uint32_t, frames repeated in every audio message
+
+    //  Audio redundancy in the spirit of RFC 2198: every AUDIO_OUT data message carries copies of the compressed
+    //  payloads of the previous few frames, so that a client can replace a lost frame from the next message that
+    //  arrives instead of waiting for a retransmission that would come too late to be played.
+
+    //  AudioRedundancyHistory: the server side, keeps the most recent compressed frames of one audio stream.
+    //  The same frame is sent to every session, so pushing a sequence number that is already stored is a no-op.
+    class AudioRedundancyHistory
+    {
+    public:
+        class Frame
+        {
+        public:
+            int64_t                 sequenceNumber = 0;
+            amf_pts                 pts = 0;
+            amf_pts                 duration = 0;
+            std::vector<uint8_t>    payload;
+        };
+        typedef std::vector<const Frame*> Frames;
+
+    public:
+        AudioRedundancyHistory() = default;
+
+        void SetDepth(size_t depth);
+        inline size_t GetDepth() const noexcept { return m_Depth; }
+
+        void Push(int64_t sequenceNumber, amf_pts pts, amf_pts duration, const void* data, size_t size);
+        void Collect(int64_t sequenceNumber, Frames& frames) const;     //  Frames preceding sequenceNumber within the depth, oldest first
+        void Reset() noexcept;
+
+    private:
+        std::deque<Frame>   m_Frames;
+        size_t              m_Depth = 0;
+    };
+
+    //  AudioLossRecovery: the client side, detects lost frames of one audio stream by sequence number
+    //  and picks the redundant copies to deliver in their place. When the server advertises OPTION_AUDIO_REDUNDANCY,
+    //  data messages are delivered without waiting out a gap before them, a frame arriving after a later one is then
+    //  dropped: it was concealed or replaced by the time it comes.
+    class AudioLossRecovery
+    {
+    public:
+        class Stats
+        {
+        public:
+            int64_t received = 0;
+            int64_t lost = 0;           //  Frames missing from the sequence when a later frame arrived
+            int64_t recovered = 0;      //  Lost frames replaced by a redundant copy
+        };
+
+    public:
+        AudioLossRecovery() = default;
+
+        //  Call for every data message received. redundantSequenceNumbers lists the redundant copies the message carries.
+        //  Returns false when the primary frame should not be delivered because it is not newer than the last frame.
+        //  recover receives the indices into redundantSequenceNumbers of the copies to deliver, in order, before the primary frame.
+        bool OnFrame(int64_t sequenceNumber, bool discontinuity, const std::vector<int64_t>& redundantSequenceNumbers, std::vector<size_t>& recover);
+
+        inline const Stats& GetStats() const noexcept { return m_Stats; }
+        void Reset() noexcept;
+
+    private:
+        bool                m_Started = false;
+        int64_t             m_LastSequenceNumber = 0;
+        Stats               m_Stats;
+    };
+}
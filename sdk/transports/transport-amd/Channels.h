@@ -74,7 +74,9 @@ namespace ssdk::transport_amd
         PROFILING_NACK,// deprecated
         TERMINATE_SESSION,
         SERVER_STAT,
-        CODECS_UPDATE
+        CODECS_UPDATE,
+        CLOCK_SYNC,     // Client to Server and back, see messages/service/ClockSync.h
+        RESUME          // Client to Server and back, see messages/service/Resume.h
     };
 
     enum class SENSOR_OP_CODE
@@ -99,7 +101,8 @@ namespace ssdk::transport_amd
         CURSOR,
         FORCE_UPDATE, // replacement for VIDEO_OP_CODE::FORCE_IDR in the correct channel
         INIT_REQUEST,
-        INIT_ACK
+        INIT_ACK,
+        CURSOR_CACHE_MISS
     };
 
     enum class AUDIO_OP_CODE
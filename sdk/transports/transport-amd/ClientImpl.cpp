@@ -36,7 +36,12 @@ THE SOFTWARE.
 #include "ClientImpl.h"
 #include "ClientSessionImpl.h"
 #include "ServerDiscovery.h"
+#include "PathMtuDiscovery.h"
 #include "Misc.h"
+#include "LocalTransport.h"
+#include "AudioRedundancy.h"
+#include "Channels.h"
+#include "net/UnixStreamSocket.h"
 
 #include "amf/public/common/TraceAdapter.h"
 #include "amf/public/include/core/PropertyStorage.h"
@@ -90,7 +95,7 @@ namespace ssdk::transport_amd
             {
                 session->SetTimeout(timeout);
 
-                DatagramClientSessionFlowCtrl::Result resDiscovery = session->EnumerateServers(callback, numOfServers, this);
+                DatagramClientSessionFlowCtrl::Result resDiscovery = session->EnumerateServers(callback, numOfServers, this, &m_DiscoveryCache);
                 m_ServersEnumerated = true;
                 switch (resDiscovery)
                 {
@@ -165,7 +170,7 @@ namespace ssdk::transport_amd
             {
                 session->SetTimeout(timeoutSec);
 
-                DatagramClientSessionFlowCtrl::Result resDiscovery = session->QueryServerInfo(callback, this);
+                DatagramClientSessionFlowCtrl::Result resDiscovery = session->QueryServerInfo(callback, this, &m_DiscoveryCache);
                 m_ServersEnumerated = true;
                 switch (resDiscovery)
                 {
@@ -208,14 +213,28 @@ namespace ssdk::transport_amd
             m_ConnectionStatus = transport_common::Result::SERVERS_NOT_ENUMERATED;
             net::Url url(serverUrl, "UDP", m_DiscoveryPort);
             m_CurrentServerUrl = url;
+            {
+                amf::AMFLock lock(&m_CritSect);
+                m_HeldMessages.clear();
+            }
 
             ClientSessionImpl::Ptr sessionImpl;
             AMFTraceDebug(AMF_FACILITY, L"Connect to server %S", url.GetUrl().c_str());
 
+            // Datagram sessions acknowledge path MTU probes in DgramFlowCtrlProtocol, tell the server so in HELLO
+            SetProperty(ID_PATH_MTU_PROBING, url.GetProtocol() == "UDP");
+            // Datagram sessions can follow a change of the client address when their datagrams carry a connection ID
+            SetProperty(ID_CONNECTION_MIGRATION, url.GetProtocol() == "UDP");
             if (url.GetProtocol() == "UDP")
             {
                 result = EstablishUDPConnection(url, &sessionImpl, FlowCtrlProtocol::MAX_DATAGRAM_SIZE);
             }
+#if defined(__linux)
+            else if (url.IsLocal() == true)
+            {
+                result = EstablishLocalConnection(url, &sessionImpl);
+            }
+#endif
             else
             {
                 result = EstablishTCPConnection(url, &sessionImpl);
@@ -224,6 +243,7 @@ namespace ssdk::transport_amd
             {
                 sessionImpl->RegisterReceiverCallback(this);
                 m_WaitForHelloResponse = true;
+                m_HelloAnswered = false;
                 m_Terminated = false;
                 time_t startTime = time(nullptr);
                 do
@@ -261,8 +281,23 @@ namespace ssdk::transport_amd
 
                 if (m_Terminated == false && sessionImpl != nullptr && m_CurrentServer != nullptr)
                 {
+                    size_t txMaxFragmentSize = m_TxMaxFragmentSize;
+                    uint32_t connectionID = 0;
+                    DatagramClientSessionFlowCtrl::Ptr datagramSession(sessionImpl);
+                    if (datagramSession != nullptr && m_CurrentServer->GetOptionUInt32(OPTION_CONNECTION_ID, connectionID) == true && connectionID != 0)
+                    {
+                        datagramSession->SetConnectionID(connectionID);
+                        txMaxFragmentSize -= FlowCtrlProtocol::CONNECTION_ID_TRAILER_SIZE;  //  Room for the connection ID trailer
+                        AMFTraceDebug(AMF_FACILITY, L"Connection ID %u assigned by the server", connectionID);
+                    }
+                    uint32_t audioRedundancy = 0;
+                    if (datagramSession != nullptr && m_CurrentServer->GetOptionUInt32(OPTION_AUDIO_REDUNDANCY, audioRedundancy) == true && audioRedundancy > 0)
+                    {   //  Audio data messages carry copies of the frames before them, AudioInit and the other messages stay in order
+                        datagramSession->SetReorderableOpCode(static_cast<uint8_t>(Channel::AUDIO_OUT), static_cast<int16_t>(AUDIO_OP_CODE::DATA));
+                        AMFTraceDebug(AMF_FACILITY, L"Audio redundancy of %u frames, audio data is delivered past gaps", audioRedundancy);
+                    }
                     // Recieve buf is set to max - no need for adjustments
-                    net::ClientSession::Ptr(sessionImpl)->SetTxMaxFragmentSize(m_TxMaxFragmentSize);
+                    net::ClientSession::Ptr(sessionImpl)->SetTxMaxFragmentSize(txMaxFragmentSize);
 
                     sessionImpl->SetServerParameters(m_CurrentServer);
                     sessionImpl->RegisterReceiverCallback(nullptr);
@@ -298,10 +333,35 @@ namespace ssdk::transport_amd
         return result;
     }
 
-    void AMF_STD_CALL ClientImpl::OnMessageReceived(Session* session, Channel channel, int /*msgID*/, const void* message, size_t messageSize)
+    void ClientImpl::DeliverHeldMessages(Session* session, ReceiverCallback* callback)
+    {
+        std::list<HeldMessage> heldMessages;
+        {
+            amf::AMFLock lock(&m_CritSect);
+            heldMessages.swap(m_HeldMessages);
+        }
+        for (const HeldMessage& held : heldMessages)
+        {
+            if (held.m_ClearText == true)
+            {
+                callback->OnClearTextMessageReceived(session, held.m_Channel, held.m_MsgID, held.m_Message.data(), held.m_Message.size());
+            }
+            else
+            {
+                callback->OnMessageReceived(session, held.m_Channel, held.m_MsgID, held.m_Message.data(), held.m_Message.size());
+            }
+        }
+    }
+
+    void AMF_STD_CALL ClientImpl::OnMessageReceived(Session* session, Channel channel, int msgID, const void* message, size_t messageSize)
     {
         static const size_t flowctrlFragmentsHeaderSize = FlowCtrlProtocol::Fragment::GetSizeOfFragmentHeader();
-        if (channel == Channel::SERVICE)
+        if (channel == Channel::SERVICE && m_HelloAnswered == true && IsHandshakeResponse(message, messageSize) == false)
+        {   // Whatever follows the HELLO response belongs to the transport and may be encrypted, e.g. the resume ticket
+            amf::AMFLock lock(&m_CritSect);
+            m_HeldMessages.push_back({ channel, msgID, std::vector<uint8_t>((const uint8_t*)message, (const uint8_t*)message + messageSize), false });
+        }
+        else if (channel == Channel::SERVICE)
         {
             uint8_t optCode = *((const uint8_t*)message);
             AMFTraceDebug(AMF_FACILITY, L"ClientImpl::OnMessageReceived() OptCode = %d", optCode);
@@ -324,6 +384,7 @@ namespace ssdk::transport_amd
 
                         session->UpgradeProtocol(serverVersion);
                         m_CurrentServer = new ServerParametersImpl(resp, m_CurrentServerUrl);
+                        m_HelloAnswered = true;
                     }
                     m_WaitForHelloResponse = false;
                     break;
@@ -341,6 +402,24 @@ namespace ssdk::transport_amd
                 break;
             }
         }
+        else if (messageSize > 0)
+        {   // The server can start streaming right behind the HELLO response, hold these until the transport takes over the session
+            amf::AMFLock lock(&m_CritSect);
+            m_HeldMessages.push_back({ channel, msgID, std::vector<uint8_t>((const uint8_t*)message, (const uint8_t*)message + messageSize), false });
+        }
+    }
+
+    bool ClientImpl::IsHandshakeResponse(const void* message, size_t messageSize)
+    {   //  Repeated HELLO requests are each answered, the extra responses are clear text JSON behind the op code
+        const uint8_t* data = static_cast<const uint8_t*>(message);
+        return messageSize > 1 && (data[0] == uint8_t(SERVICE_OP_CODE::HELLO) || data[0] == uint8_t(SERVICE_OP_CODE::DISCOVERY) || data[0] == uint8_t(SERVICE_OP_CODE::CONNECTION_REFUSED)) && data[1] == '{';
+    }
+
+    void AMF_STD_CALL ClientImpl::OnClearTextMessageReceived(Session* /*session*/, Channel channel, int msgID, const void* message, size_t messageSize)
+    {
+        //  Only bulk payloads are passed in the clear, never service messages
+        amf::AMFLock lock(&m_CritSect);
+        m_HeldMessages.push_back({ channel, msgID, std::vector<uint8_t>((const uint8_t*)message, (const uint8_t*)message + messageSize), true });
     }
 
     void AMF_STD_CALL ClientImpl::OnTerminate(Session* /*session*/, TerminationReason reason)
@@ -384,6 +463,11 @@ namespace ssdk::transport_amd
                     *session = static_cast<DatagramClientSessionImpl*>(clientSession.GetPtr());
                     (*session)->Acquire();
                     clientSession->SetTimeout(m_Timeout);
+                    if (m_Recorder != nullptr)
+                    {
+                        DatagramClientSessionFlowCtrl::Ptr(clientSession)->SetRecorder(m_Recorder);
+                    }
+                    DatagramClientSessionFlowCtrl::Ptr(clientSession)->EnableIoUring(m_IoUring);
                 }
             }
         }
@@ -429,6 +513,44 @@ namespace ssdk::transport_amd
         return result;
     }
 
+#if defined(__linux)
+    transport_common::Result AMF_STD_CALL ClientImpl::EstablishLocalConnection(const net::Url& serverUrl, ClientSessionImpl** session)
+    {
+        transport_common::Result result = transport_common::Result::OK;
+        if (session == nullptr || serverUrl.GetHost().length() == 0)
+        {
+            result = transport_common::Result::INVALID_ARG;
+            AMFTraceError(AMF_FACILITY, L"session == NULL || server == NULL");
+        }
+        else
+        {
+            amf::AMFLock    lock(&m_CritSect);
+            m_Transport = net::Url::PROTOCOL_LOCAL;
+            net::ClientSession::Ptr clientSession(nullptr);
+            LocalClient* client = new LocalClient(this);
+            m_Client = net::Client::Ptr(client);
+            clientSession = client->Connect(serverUrl, nullptr);
+
+            if (clientSession == nullptr)
+            {
+                result = transport_common::Result::FAIL;
+                AMFTraceError(AMF_FACILITY, L"Failed to connect to local socket %S", serverUrl.GetHost().c_str());
+            }
+            else
+            {
+                //  The server shares the ring right after accepting, before any framed message
+                LocalClientSessionImpl* localSession = static_cast<LocalClientSessionImpl*>(clientSession.GetPtr());
+                if ((result = localSession->AttachRing()) == transport_common::Result::OK)
+                {
+                    *session = localSession;
+                    (*session)->Acquire();
+                    clientSession->SetTimeout(m_Timeout);
+                }
+            }
+        }
+        return result;
+    }
+#endif
 
     transport_common::Result     ClientImpl::SetTimeout(time_t timeoutSec)
     {
@@ -578,4 +700,35 @@ namespace ssdk::transport_amd
         return new amf::AMFInterfaceMultiImpl<StreamClientSessionImpl, net::ClientSession, ClientImpl*, net::Socket*, const net::Socket::Address&, size_t>(m_ClientImpl, connectSocket, peer, params != nullptr ? reinterpret_cast<size_t>(params) : size_t(FlowCtrlProtocol::MAX_DATAGRAM_SIZE));
 
     }
+
+#if defined(__linux)
+    /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ClientImpl::LocalClient::LocalClient(ClientImpl* clientImpl) :
+        m_ClientImpl(clientImpl)
+    {
+
+    }
+
+    ClientImpl::LocalClient::~LocalClient()
+    {
+
+    }
+
+    net::ClientSession::Ptr ClientImpl::LocalClient::Connect(const net::Url& url, void* params)
+    {
+        net::ClientSession::Ptr session;
+        net::Socket::UnixDomainAddress address(GetLocalSocketAddress(url.GetHost()));
+        m_ConnectSocket = net::StreamSocket::Ptr(new net::UnixStreamSocket());
+        if (m_ConnectSocket->Connect(address) == net::Socket::Result::OK)
+        {
+            session = net::StreamClient::Connect(address, m_ConnectSocket, params);
+        }
+        return session;
+    }
+
+    net::ClientSession::Ptr ClientImpl::LocalClient::OnCreateSession(net::Client& /*client*/, const net::Socket::Address& peer, net::Socket* connectSocket, void* params)
+    {
+        return new amf::AMFInterfaceMultiImpl<LocalClientSessionImpl, net::ClientSession, ClientImpl*, net::Socket*, const net::Socket::Address&, size_t>(m_ClientImpl, connectSocket, peer, params != nullptr ? reinterpret_cast<size_t>(params) : size_t(FlowCtrlProtocol::MAX_DATAGRAM_SIZE));
+    }
+#endif
 }
\ No newline at end of file
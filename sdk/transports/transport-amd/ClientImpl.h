@@ -94,6 +94,21 @@ namespace ssdk::transport_amd
             ClientImpl* m_ClientImpl;
         };
 
+#if defined(__linux)
+        class LocalClient : public net::StreamClient
+        {
+        public:
+            LocalClient(ClientImpl* clientImpl);
+            virtual ~LocalClient();
+
+            virtual net::ClientSession::Ptr AMF_STD_CALL Connect(const net::Url& url, void* params) override;
+            virtual net::ClientSession::Ptr AMF_STD_CALL OnCreateSession(Client& client, const net::Socket::Address& peer, net::Socket* connectSocket, void* params) override;
+
+        private:
+            ClientImpl* m_ClientImpl;
+        };
+#endif
+
     public:
         AMF_BEGIN_INTERFACE_MAP
             AMF_INTERFACE_ENTRY(Client)
@@ -125,8 +140,13 @@ namespace ssdk::transport_amd
         // helpers
         void SetSession(ClientSessionImpl* session);
         void SetDatagramSize(size_t datagramSize);
+        inline void SetDiscoveryCacheFile(const std::string& fileName) { m_DiscoveryCache.SetFileName(fileName); }
+        inline void SetRecorder(StreamRecorder::Ptr recorder) { m_Recorder = recorder; }     // Applied to datagram sessions established afterwards
+        inline void SetIoUring(bool ioUring) { m_IoUring = ioUring; }                        // Applied to datagram sessions established afterwards
+        void DeliverHeldMessages(Session* session, ReceiverCallback* callback);
 
         virtual void AMF_STD_CALL OnMessageReceived(Session* session, Channel channel, int msgID, const void* message, size_t messageSize) override;
+        virtual void AMF_STD_CALL OnClearTextMessageReceived(Session* session, Channel channel, int msgID, const void* message, size_t messageSize) override;
         virtual void AMF_STD_CALL OnTerminate(Session* session, TerminationReason reason) override;
 
     protected:
@@ -137,6 +157,10 @@ namespace ssdk::transport_amd
 
         transport_common::Result AMF_STD_CALL EstablishUDPConnection(const net::Url& url, ClientSessionImpl** session, size_t datagramSize = 0);
         transport_common::Result AMF_STD_CALL EstablishTCPConnection(const net::Url& url, ClientSessionImpl** session);
+#if defined(__linux)
+        transport_common::Result AMF_STD_CALL EstablishLocalConnection(const net::Url& url, ClientSessionImpl** session);
+#endif
+        static bool IsHandshakeResponse(const void* message, size_t messageSize);
 
         //net::DatagramClient interface
 //        virtual net::ClientSession* AMF_STD_CALL OnCreateSession(Client& client, const net::Socket::Address& peer, net::Socket::Ptr& connectSocket, void* params);
@@ -145,9 +169,13 @@ namespace ssdk::transport_amd
         mutable amf::AMFCriticalSection     m_CritSect;
         ServerParametersImpl::Collection    m_Servers;
         bool                                m_ServersEnumerated = false;
+        DiscoveryCache                      m_DiscoveryCache;
+        StreamRecorder::Ptr                 m_Recorder;
+        bool                                m_IoUring = false;
         ClientSessionImpl*                  m_Session = nullptr;
         volatile bool                       m_WaitingForIncoming = false;
         volatile bool                       m_WaitForHelloResponse = false;
+        volatile bool                       m_HelloAnswered = false;
         unsigned short                      m_DiscoveryPort = 0;
         time_t                              m_Timeout = 0;
         size_t                              m_DatagramSize = 0;
@@ -163,5 +191,15 @@ namespace ssdk::transport_amd
 
         std::vector<VideoCodec>             m_VideoCodecs;
         std::vector<AudioCodec>             m_AudioCodecs;
+
+        // Messages which arrive between the HELLO response and the transport taking over the session, e.g. the encrypted resume ticket
+        struct HeldMessage
+        {
+            Channel                         m_Channel;
+            int                             m_MsgID;
+            std::vector<uint8_t>            m_Message;
+            bool                            m_ClearText;
+        };
+        std::list<HeldMessage>              m_HeldMessages;
     };
 }
@@ -37,6 +37,8 @@ THE SOFTWARE.
 #include "ClientImpl.h"
 #include "ServerDiscovery.h"
 #include "Misc.h"
+#include "net/UnixStreamSocket.h"
+#include "net/SocketTuning.h"
 #include "amf/public/common/TraceAdapter.h"
 
 static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::transport_amd::ClientSessionImpl";
@@ -123,8 +125,11 @@ namespace ssdk::transport_amd
         int recvBufSize = SOCKET_BUF_SIZE_RCV;
         int sendBufSize = SOCKET_BUF_SIZE_SND;
     #endif
-        sock->SetSocketOpt(SOL_SOCKET, SO_RCVBUF, &recvBufSize, sizeof(recvBufSize));
-        sock->SetSocketOpt(SOL_SOCKET, SO_SNDBUF, &sendBufSize, sizeof(sendBufSize));
+        //  Every datagram is marked with the traffic class of its channel in DatagramClientSessionFlowCtrl, the socket stays best effort
+        net::SocketTuning tuning;
+        tuning.SetReceiveBufferSize(recvBufSize);
+        tuning.SetSendBufferSize(sendBufSize);
+        tuning.Apply(sock);
     }
 
     DatagramClientSessionImpl::~DatagramClientSessionImpl ()
@@ -223,7 +228,10 @@ namespace ssdk::transport_amd
         net::StreamClientSession(sock, peer, receiveBufSize)
     {
         int yes = 1;
-        sock->SetSocketOpt(IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        if (sock->GetProtocol() == net::Socket::Protocol::PROTO_TCP)    //  Also used for Unix domain sockets by LocalClientSessionImpl
+        {
+            sock->SetSocketOpt(IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        }
 
     #if defined(__APPLE__)
         // Disconnecting from TCP will raise SIGPIPE on apple and linux.
@@ -242,8 +250,14 @@ namespace ssdk::transport_amd
         int sendBufSize = SOCKET_BUF_SIZE_SND;
     #endif
 
-        sock->SetSocketOpt(SOL_SOCKET, SO_RCVBUF, &recvBufSize, sizeof(recvBufSize));
-        sock->SetSocketOpt(SOL_SOCKET, SO_SNDBUF, &sendBufSize, sizeof(sendBufSize));
+        net::SocketTuning tuning;
+        tuning.SetReceiveBufferSize(recvBufSize);
+        tuning.SetSendBufferSize(sendBufSize);
+        if (sock->GetProtocol() == net::Socket::Protocol::PROTO_TCP)
+        {   //  What the client sends over the stream is mostly input
+            tuning.SetTrafficClass(net::Socket::TrafficClass::INTERACTIVE);
+        }
+        tuning.Apply(sock);
 
         sock->SetTimeout(5);
     }
@@ -356,13 +370,84 @@ namespace ssdk::transport_amd
         }
         else
         {
-            if (msgIsComplete == true && m_Callback != nullptr)
+            if (msgIsComplete == true)
             {
-                m_Callback->OnMessageReceived(this, m_FlowCtrl.GetChannel(), m_FlowCtrl.GetMsgID(), m_FlowCtrl.GetReceiveBuffer(), m_FlowCtrl.GetReceiveSize());
+                OnCompleteMessage(m_FlowCtrl.GetChannel(), m_FlowCtrl.GetMsgID(), m_FlowCtrl.GetReceiveBuffer(), m_FlowCtrl.GetReceiveSize());
             }
             Touch();
             result = net::Session::Result::OK;
         }
         return result;
     }
+
+    void StreamClientSessionImpl::OnCompleteMessage(Channel channel, FlowCtrlProtocol::MessageID msgID, const void* buf, size_t size)
+    {
+        if (m_Callback != nullptr)
+        {
+            m_Callback->OnMessageReceived(this, channel, msgID, buf, size);
+        }
+    }
+
+#if defined(__linux)
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    LocalClientSessionImpl::LocalClientSessionImpl(ClientImpl* client, net::Socket* sock, const net::Socket::Address& peer, size_t receiveBufSize) :
+        StreamClientSessionImpl(client, sock, peer, receiveBufSize)
+    {
+    }
+
+    LocalClientSessionImpl::~LocalClientSessionImpl()
+    {
+    }
+
+    transport_common::Result LocalClientSessionImpl::AttachRing()
+    {
+        transport_common::Result result = transport_common::Result::FAIL;
+        net::UnixStreamSocket::Ptr socket(GetSocket());
+        int fd = -1;
+        if (socket == nullptr)
+        {
+            result = transport_common::Result::INVALID_ARG;
+        }
+        else if (socket->RecvFd(&fd) != net::Socket::Result::OK)
+        {
+            AMFTraceError(AMF_FACILITY, L"AttachRing(): server did not share the ring");
+        }
+        else if (m_Ring.Attach(fd) != net::SharedMemoryRing::Result::OK)
+        {
+            AMFTraceError(AMF_FACILITY, L"AttachRing(): failed to map the ring");
+        }
+        else
+        {
+            result = transport_common::Result::OK;
+        }
+        return result;
+    }
+
+    void LocalClientSessionImpl::OnCompleteMessage(Channel channel, FlowCtrlProtocol::MessageID msgID, const void* buf, size_t size)
+    {
+        if (channel == Channel::SYSTEM && size == sizeof(LocalRingMessage))
+        {
+            LocalRingMessage ringMsg;
+            memcpy(&ringMsg, buf, sizeof(ringMsg));
+            const uint8_t* payload = m_Ring.Read(ringMsg.m_Position, ringMsg.m_Size);
+            if (payload == nullptr)
+            {
+                AMFTraceError(AMF_FACILITY, L"OnCompleteMessage(): invalid ring reference, position %llu size %u", static_cast<unsigned long long>(ringMsg.m_Position), ringMsg.m_Size);
+            }
+            else
+            {
+                //  The payload is consumed in place, receivers copy whatever they need to keep before returning. It is not encrypted
+                if (m_Callback != nullptr)
+                {
+                    m_Callback->OnClearTextMessageReceived(this, static_cast<Channel>(ringMsg.m_Channel), msgID, payload, ringMsg.m_Size);
+                }
+                m_Ring.Release(ringMsg.m_Position, ringMsg.m_Size);
+            }
+        }
+        else
+        {
+            StreamClientSessionImpl::OnCompleteMessage(channel, msgID, buf, size);
+        }
+    }
+#endif
 }
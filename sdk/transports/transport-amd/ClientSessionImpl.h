@@ -43,8 +43,10 @@ THE SOFTWARE.
 
 #include "TransportClient.h"
 #include "DgramClientSessionFlowCtrl.h"
+#include "LocalTransport.h"
 
 #include "net/StreamClientSession.h"
+#include "net/SharedMemoryRing.h"
 
 #include "amf/public/common/InterfaceImpl.h"
 #include "amf/public/common/Thread.h"
@@ -168,8 +170,30 @@ namespace ssdk::transport_amd
 
         virtual transport_common::Result   AMF_STD_CALL Send(Channel channel, const void* msg, size_t msgLen) override;
 
+    protected:
+        virtual void OnCompleteMessage(Channel channel, FlowCtrlProtocol::MessageID msgID, const void* buf, size_t size);
+
     private:
         StreamFlowCtrlProtocol	m_FlowCtrl;
     };
 
+#if defined(__linux)
+    //  A stream session over a Unix domain socket to a server on the same host, see LocalTransport.h
+    class LocalClientSessionImpl :
+        public StreamClientSessionImpl
+    {
+    public:
+        LocalClientSessionImpl(ClientImpl* client, net::Socket* sock, const net::Socket::Address& peer, size_t receiveBufSize);
+        virtual ~LocalClientSessionImpl();
+
+        transport_common::Result AttachRing();     //  Receive the ring from the server, must be called before anything else is read from the socket
+
+    protected:
+        virtual void OnCompleteMessage(Channel channel, FlowCtrlProtocol::MessageID msgID, const void* buf, size_t size) override;
+
+    private:
+        net::SharedMemoryRing   m_Ring;
+    };
+#endif
+
 }
@@ -38,6 +38,8 @@ THE SOFTWARE.
 #include "messages/audio/AudioInit.h"
 #include "messages/audio/AudioData.h"
 #include "messages/sensors/DeviceEvent.h"
+#include "messages/service/ClockSync.h"
+#include "messages/service/Resume.h"
 #include "messages/service/StartStop.h"
 #include "messages/service/Stats.h"
 #include "messages/video/Cursor.h"
@@ -48,6 +50,8 @@ THE SOFTWARE.
 #include "controllers/UserInput.h"
 
 #include "util/stats/ClientStatsManager.h"
+#include "util/trace/PipelineTrace.h"
+#include "util/memory/BufferPool.h"
 
 #include "amf/public/common/TraceAdapter.h"
 
@@ -136,6 +140,34 @@ namespace ssdk::transport_amd
         AMFTraceInfo(AMF_FACILITY, L"TurnaroundLatencyThread terminated");
     }
 
+    void ClientTransportImpl::ClockSyncThread::Run()
+    {
+        AMFTraceInfo(AMF_FACILITY, L"ClockSyncThread started");
+
+        if (nullptr == m_pTransport || nullptr == m_pClockSync)
+        {
+            AMFTraceInfo(AMF_FACILITY, L"ClockSyncThread stopped prematurely becase transport is missing");
+            return;
+        }
+
+        while (StopRequested() == false)
+        {
+            ClockSyncMessage request(amf_high_precision_clock());
+            m_pTransport->SendMsg(Channel::SERVICE, request.GetSendData(), request.GetSendSize());
+
+            // the interval grows once the estimate has settled, sleep in small steps to stop promptly
+            amf_pts sendTime = amf_high_precision_clock();
+            while (StopRequested() == false && amf_high_precision_clock() - sendTime < m_pClockSync->GetRequestInterval())
+            {
+                amf_sleep(10);
+            }
+        }
+
+        m_pTransport = nullptr;
+
+        AMFTraceInfo(AMF_FACILITY, L"ClockSyncThread terminated");
+    }
+
     Result ClientTransportImpl::Start(const ClientInitParameters& params)
     {
         Result result = Result::FAIL;
@@ -168,6 +200,20 @@ namespace ssdk::transport_amd
         {
             m_pClient = new ClientImpl();
             m_pClient->SetDatagramSize(m_clientInitParameters.GetDatagramSize());
+            m_pClient->SetDiscoveryCacheFile(m_clientInitParameters.GetDiscoveryCacheFile());
+            m_pClient->SetIoUring(m_clientInitParameters.GetIoUring());
+            if (m_clientInitParameters.GetCaptureFile().empty() == false)
+            {
+                m_Recorder = std::make_shared<StreamRecorder>();
+                if (m_Recorder->Open(m_clientInitParameters.GetCaptureFile(), m_clientInitParameters.GetCaptureRedacted()) == true)
+                {
+                    m_pClient->SetRecorder(m_Recorder);
+                }
+                else
+                {
+                    m_Recorder = nullptr;
+                }
+            }
             m_pCipher = cipherPassphrase.empty() ? nullptr : ssdk::util::AESPSKCipher::Ptr(new ssdk::util::AESPSKCipher(cipherPassphrase.c_str()));
             result = Result::OK;
         }
@@ -187,6 +233,11 @@ namespace ssdk::transport_amd
         m_pClient = nullptr;
         m_pContext = nullptr;
         m_pCipher = nullptr;
+        if (m_Recorder != nullptr)
+        {
+            m_Recorder->Close();
+            m_Recorder = nullptr;
+        }
         return result;
     }
 
@@ -224,6 +275,7 @@ namespace ssdk::transport_amd
             amf::AMFLock lock(&m_CCCGuard);
             pClient = m_pClient;
             pCipher = m_pCipher;
+            m_CursorCache.Clear(); // a new server will resend all cursor bitmaps
         }
         AMF_RETURN_IF_FALSE(nullptr != pClient, Result::FAIL, L"Connect() Client object missing");
 
@@ -243,6 +295,29 @@ namespace ssdk::transport_amd
             pClient->SetProperty(ID_SESSION_ID, emptySessionID);
         }
 
+        // Advertise the cursor cache, the server will then send the bitmap of each cursor shape only once
+        if (nullptr != m_clientInitParameters.GetCursorCallback())
+        {
+            pClient->SetProperty(ID_CURSOR_CACHE_SIZE, DEFAULT_CURSOR_CACHE_SIZE);
+        }
+
+        // Present the ticket from the previous session with the same server, it then restores the subscriptions and codec inits without a START round trip.
+        // Only the ticket ID goes out with HELLO, the secret never leaves the client
+        std::string resumeTicket;
+        std::string resumeSecret;
+        {
+            amf::AMFLock resumeLock(&m_ResumeGuard);
+            if (m_clientInitParameters.GetSessionResumption() == true && nullptr != pCipher && m_ResumeServerUrl == url)
+            {
+                resumeTicket = m_ResumeTicket;
+                resumeSecret = m_ResumeSecret;
+            }
+            m_ConnectServerUrl = url;
+        }
+        bool presentTicket = resumeTicket.empty() == false && resumeSecret.empty() == false;
+        pClient->SetProperty(ID_RESUME_TICKET, presentTicket == true ? resumeTicket.c_str() : "");
+        m_Resumed = false;
+
         result = pClient->ConnectToServerAndQueryParameters(url, ID, (Session**)&m_pSession, &serverParameters);
 
         if (nullptr != m_clientInitParameters.GetConnectionManagerCallback())
@@ -275,7 +350,12 @@ namespace ssdk::transport_amd
         else
         {
             AMFTraceInfo(AMF_FACILITY, L"Connect() ConnectToServerAndQueryParameters(%S)  - succeeded", url);
+
+            std::string challenge;
+            bool challenged = presentTicket == true && serverParameters->GetOptionString(OPTION_RESUME_CHALLENGE, challenge) == true && challenge.empty() == false;
+
             m_pSession->RegisterReceiverCallback(this);
+            pClient->DeliverHeldMessages(m_pSession, this);   // The resume ticket can arrive right behind the HELLO response
             result = pClient->Activate();
 
             if (Result::OK != result)
@@ -285,6 +365,23 @@ namespace ssdk::transport_amd
             else
             {
                 AMFTraceInfo(AMF_FACILITY, L"Connect() Client (re)activated");
+
+                if (challenged == true && ResumeSession(resumeTicket, resumeSecret, challenge, ID) == true)
+                {
+                    m_Resumed = true;
+                    AMFTraceInfo(AMF_FACILITY, L"Connect() Session resumed, %d video and %d audio streams restored by the server", (int)m_ResumeVideoStreams.size(), (int)m_ResumeAudioStreams.size());
+                    m_SubscribedVideoStreams = m_ResumeVideoStreams;
+                    m_SubscribedAudioStreams = m_ResumeAudioStreams;
+                }
+                m_ResumeVideoStreams.clear();
+                m_ResumeAudioStreams.clear();
+
+                // a new server has an unrelated clock
+                m_ClockSyncThread.RequestStop();
+                m_ClockSyncThread.WaitForStop();
+                m_ClockSync->Reset();
+                m_ClockSyncThread.Init(this, m_ClockSync);
+                m_ClockSyncThread.Start();
             }
         }
 
@@ -299,13 +396,17 @@ namespace ssdk::transport_amd
 
         m_TurnaroundLatencyThread.RequestStop();
         m_TurnaroundLatencyThread.WaitForStop();
+        m_ClockSyncThread.RequestStop();
+        m_ClockSyncThread.WaitForStop();
 
         if (nullptr != m_clientInitParameters.GetConnectionManagerCallback())
         {
             m_clientInitParameters.GetConnectionManagerCallback()->OnConnectionTerminated(ConnectionManagerCallback::TerminationReason::CLOSED_BY_CLIENT);
         }
 
-        //  Unsubscribe from all video and audio streams
+        //  Unsubscribe from all video and audio streams, the server keeps them in the resumption ticket
+        m_ResumeVideoStreams = m_SubscribedVideoStreams;
+        m_ResumeAudioStreams = m_SubscribedAudioStreams;
         for (auto& it : m_SubscribedVideoStreams)
         {
             StopRequest stopRequest(it, INVALID_STREAM);
@@ -374,7 +475,15 @@ namespace ssdk::transport_amd
             static_cast<int32_t>(m_clientInitParameters.GetDisplayClientHeight()),
             StreamID, INVALID_STREAM
         );
-        result = SendMsg(Channel::SERVICE, startRequest.GetSendData(), startRequest.GetSendSize());
+        if (m_Resumed == true && m_SubscribedVideoStreams.find(StreamID) != m_SubscribedVideoStreams.end())
+        {   // Sending START again would make the server reinitialize the stream it has already restored
+            AMFTraceInfo(AMF_FACILITY, L"SubscribeToVideoStream(%lld) stream restored on session resumption", StreamID);
+            result = Result::OK;
+        }
+        else
+        {
+            result = SendMsg(Channel::SERVICE, startRequest.GetSendData(), startRequest.GetSendSize());
+        }
         if (Result::OK != result)
         {
             AMFTraceError(AMF_FACILITY, L"SubscribeToVideoStream(%lld) Failed to send Start Request err=%d", StreamID, (int)result);
@@ -420,7 +529,15 @@ namespace ssdk::transport_amd
             static_cast<int32_t>(m_clientInitParameters.GetDisplayClientHeight()),
             INVALID_STREAM, StreamID
         );
-        result = SendMsg(Channel::SERVICE, startRequest.GetSendData(), startRequest.GetSendSize());
+        if (m_Resumed == true && m_SubscribedAudioStreams.find(StreamID) != m_SubscribedAudioStreams.end())
+        {
+            AMFTraceInfo(AMF_FACILITY, L"SubscribeToAudioStream(%lld) stream restored on session resumption", StreamID);
+            result = Result::OK;
+        }
+        else
+        {
+            result = SendMsg(Channel::SERVICE, startRequest.GetSendData(), startRequest.GetSendSize());
+        }
         if (Result::OK != result)
         {
             AMFTraceError(AMF_FACILITY, L"SubscribeToAudioStream(%lld) Failed to send Start Request err=%d", StreamID, (int)result);
@@ -620,17 +737,38 @@ namespace ssdk::transport_amd
         return SendMsg(Channel::USER_DEFINED, msg, size);
     }
 
+    Result ClientTransportImpl::RebindSocket()
+    {
+        ClientSessionImpl::Ptr session;
+        {
+            amf::AMFLock lock(&m_SessionGuard);
+            session = m_pSession;
+        }
+        DatagramClientSessionFlowCtrl::Ptr datagramSession(session);
+        if (datagramSession == nullptr)
+        {
+            return Result::SESSION_NOT_READY;
+        }
+        return datagramSession->RebindSocket() == net::Socket::Result::OK ? Result::OK : Result::FAIL;
+    }
+
     // ReceiverCallback methods:
     void ClientTransportImpl::OnMessageReceived(Session* session, Channel channel, int msgID, const void* msg, size_t messageSize)
     {
         ssdk::util::AESPSKCipher::Ptr pCipher = nullptr;
         amf::AMFContextPtr pContext = nullptr;
         ssdk::util::ClientStatsManager::Ptr statsManager;
+        StreamRecorder::Ptr recorder;
         {
             amf::AMFLock lock(&m_CCCGuard);
             pCipher = m_pCipher;
             pContext = m_pContext;
             statsManager = m_StatsManager;
+            recorder = m_Recorder;
+        }
+        if (recorder != nullptr)
+        {
+            recorder->RecordMessage(StreamCapture::Direction::INCOMING, channel, msgID, msg, messageSize);
         }
 
         if (nullptr == session)
@@ -659,6 +797,7 @@ namespace ssdk::transport_amd
                 size_t clearTextSize;
                 bool bSuccess = pCipher->Decrypt(msg, messageSize, clearTextBuffer->GetNative(), &clearTextOfs, &clearTextSize);
                 amf_pts decryptPts = amf_high_precision_clock() - startDecryptPts;
+                SSDK_TRACE_DEFER(DECRYPT, startDecryptPts);
                 if (!bSuccess)
                 {
                     AMFTraceError(AMF_FACILITY, L"OnMessageReceived() - decryption failed");
@@ -685,6 +824,23 @@ namespace ssdk::transport_amd
         }
     }
 
+    void ClientTransportImpl::OnClearTextMessageReceived(Session* session, Channel channel, int msgID, const void* msg, size_t messageSize)
+    {
+        StreamRecorder::Ptr recorder;
+        {
+            amf::AMFLock lock(&m_CCCGuard);
+            recorder = m_Recorder;
+        }
+        if (recorder != nullptr)
+        {
+            recorder->RecordMessage(StreamCapture::Direction::INCOMING, channel, msgID, msg, messageSize);
+        }
+        if (session != nullptr)
+        {
+            ProcessMessage(session, channel, msgID, msg, messageSize);
+        }
+    }
+
     void ClientTransportImpl::OnTerminate(Session* /*session*/, ReceiverCallback::TerminationReason reason)
     {
         ConnectionManagerCallback::TerminationReason terminationReason = ConnectionManagerCallback::TerminationReason::CLOSED_BY_SERVER;;
@@ -712,6 +868,8 @@ namespace ssdk::transport_amd
 
         m_TurnaroundLatencyThread.RequestStop();
         m_TurnaroundLatencyThread.WaitForStop();
+        m_ClockSyncThread.RequestStop();
+        m_ClockSyncThread.WaitForStop();
     }
 
     //  Own methods:
@@ -799,6 +957,7 @@ namespace ssdk::transport_amd
 
     void ClientTransportImpl::OnServiceMessage(Session* session, const void* msg, size_t messageSize)
     {
+        amf_pts receiveTime = amf_high_precision_clock();
         uint8_t opCode = *((const uint8_t*)msg);
         switch (SERVICE_OP_CODE(opCode))
         {
@@ -810,6 +969,12 @@ namespace ssdk::transport_amd
             AMFTraceInfo(AMF_FACILITY, L"OnServiceMessage() - SERVER_STAT from %S", session->GetPeerUrl());
             OnServiceServerStat(session, msg, messageSize);
             break;
+        case SERVICE_OP_CODE::CLOCK_SYNC:
+            OnServiceClockSync(msg, messageSize, receiveTime);
+            break;
+        case SERVICE_OP_CODE::RESUME:
+            OnServiceResume(msg, messageSize);
+            break;
         case SERVICE_OP_CODE::CODECS_UPDATE:
         case SERVICE_OP_CODE::TRACKABLE_DEVICE_CAPS:
             // This message is ignored here, and sensors thread is managed by controller manager
@@ -829,12 +994,78 @@ namespace ssdk::transport_amd
 
         m_TurnaroundLatencyThread.RequestStop();
         m_TurnaroundLatencyThread.WaitForStop();
+        m_ClockSyncThread.RequestStop();
+        m_ClockSyncThread.WaitForStop();
     }
 
     void ClientTransportImpl::OnServiceForceIDRFrame(Session* /*session*/)
     {
     }
 
+    void ClientTransportImpl::OnServiceClockSync(const void* msg, size_t messageSize, amf_pts receiveTime)
+    {
+        ClockSyncMessage response;
+        if (response.ParseBuffer(msg, messageSize) == false)
+        {
+            AMFTraceError(AMF_FACILITY, L"OnServiceClockSync - invalid JSON: %S", msg);
+        }
+        else if (response.IsResponse() == true)
+        {
+            m_ClockSync->AddSample(response.GetOriginate(), response.GetReceive(), response.GetTransmit(), receiveTime);
+        }
+    }
+
+    bool ClientTransportImpl::ResumeSession(const std::string& ticket, const std::string& secret, const std::string& challenge, const char* deviceID)
+    {
+        static constexpr const amf_ulong RESUME_TIMEOUT_MS = 1000;
+
+        {   // A ticket is only good for one attempt, whatever the outcome the server issues a new one
+            amf::AMFLock lock(&m_ResumeGuard);
+            m_ResumeTicket.clear();
+            m_ResumeSecret.clear();
+            m_ResumeAnswered = false;
+            m_ResumeAccepted = false;
+            m_ResumeEvent.ResetEvent();
+        }
+
+        ResumeMessage request(ticket, ComputeResumeProof(secret, challenge, deviceID));
+        if (SendMsg(Channel::SERVICE, request.GetSendData(), request.GetSendSize()) != Result::OK)
+        {
+            AMFTraceError(AMF_FACILITY, L"ResumeSession() failed to send the resume request");
+            return false;
+        }
+
+        amf_pts deadline = amf_high_precision_clock() + RESUME_TIMEOUT_MS * AMF_MILLISECOND;
+        while (amf_high_precision_clock() < deadline)
+        {
+            m_ResumeEvent.Lock(RESUME_TIMEOUT_MS);
+            amf::AMFLock lock(&m_ResumeGuard);
+            if (m_ResumeAnswered == true)
+            {
+                return m_ResumeAccepted;
+            }
+        }
+        AMFTraceWarning(AMF_FACILITY, L"ResumeSession() the server did not answer the resume request, continuing as a new session");
+        return false;
+    }
+
+    void ClientTransportImpl::OnServiceResume(const void* msg, size_t messageSize)
+    {
+        ResumeMessage response;
+        if (response.ParseBuffer(msg, messageSize) == false || response.IsRequest() == true)
+        {
+            AMFTraceError(AMF_FACILITY, L"OnServiceResume - invalid resume message");
+            return;
+        }
+        amf::AMFLock lock(&m_ResumeGuard);
+        m_ResumeTicket = response.GetTicket();
+        m_ResumeSecret = response.GetSecret();
+        m_ResumeServerUrl = m_ConnectServerUrl;
+        m_ResumeAnswered = true;
+        m_ResumeAccepted = response.IsResumed();
+        m_ResumeEvent.SetEvent();
+    }
+
     void ClientTransportImpl::OnServiceServerStat(Session* /*session*/, const void* msg, size_t messageSize)
     {
         ServerStat request;
@@ -920,6 +1151,7 @@ namespace ssdk::transport_amd
     // todo:  add server code to limit frequency of IDR requests sent to 4 per second.
     void ClientTransportImpl::OnVideoOutData(Session* /*session*/, const void* msg, size_t messageSize)
     {
+        amf_pts receiveTime = amf_high_precision_clock();
         amf::AMFContextPtr pContext = nullptr;
         ssdk::util::ClientStatsManager::Ptr statsManager = nullptr;
         {
@@ -935,6 +1167,8 @@ namespace ssdk::transport_amd
         }
         else if (nullptr != m_clientInitParameters.GetVideoReceiverCallback())
         {
+            SSDK_TRACE_KEY_SCOPE(videoData.GetPts());     //  Claims the reassembly and decryption spans of this message
+            SSDK_TRACE_SPAN(RECEIVE, videoData.GetPts());
             ReceivableVideoFrame frame(pContext, videoData.GetViewType(), videoData.GetOriginPts(), videoData.GetFrameNum(), videoData.GetDiscontinuity());
 
             size_t frameBlockOfs = strlen((char*)msg + 1) + 2;// skip opt code
@@ -998,6 +1232,10 @@ namespace ssdk::transport_amd
                 {
                     statsManager->UpdateServerLatency(videoData.GetServerLatency());
                     statsManager->UpdateEncoderLatency(videoData.GetEncoderLatency());
+                    if (videoData.GetSendTime() != 0 && m_ClockSync->IsSynchronized() == true)
+                    {
+                        statsManager->UpdateNetworkLatency(receiveTime - m_ClockSync->RemoteToLocal(videoData.GetSendTime()));
+                    }
                 }
             }
         }
@@ -1034,9 +1272,29 @@ namespace ssdk::transport_amd
                 int width = cursorData.GetWidth();
                 int height = cursorData.GetHeight();
                 int pitch = cursorData.GetPitch();
+                uint64_t hash = cursorData.GetHash();
 
                 amf::AMFSurfacePtr pSurface = nullptr;
-                if (0 < width && 0 < height && 0 < pitch)
+                if (true == cursorData.IsCached())
+                {
+                    {
+                        amf::AMFLock lock(&m_CCCGuard);
+                        amf::AMFSurfacePtr* pCachedSurface = m_CursorCache.Find(hash);
+                        if (nullptr != pCachedSurface)
+                        {
+                            pSurface = *pCachedSurface;
+                        }
+                    }
+                    if (nullptr == pSurface)
+                    {
+                        // The server only sends the hash when it believes we have the bitmap, ask for it - the server will resend the complete cursor
+                        AMFTraceDebug(AMF_FACILITY, L"OnVideoOutCursor - cursor %llx is not in the cache, requesting bitmap", hash);
+                        CursorCacheMiss miss(hash);
+                        SendMsg(Channel::VIDEO_OUT, miss.GetSendData(), miss.GetSendSize());
+                        return;
+                    }
+                }
+                else if (0 < width && 0 < height && 0 < pitch)
                 {
                     AMF_RESULT result = pContext->AllocSurface(amf::AMF_MEMORY_HOST, amf::AMF_SURFACE_BGRA, width, height, &pSurface);
                     if (AMF_OK == result)
@@ -1052,13 +1310,24 @@ namespace ssdk::transport_amd
                                 (amf_uint8*)videoDataPtr + pitch * i,
                                 pitch);
                         }
+
+                        if (0 != hash)
+                        {
+                            amf::AMFLock lock(&m_CCCGuard);
+                            m_CursorCache.Insert(hash, pSurface);
+                        }
                     }
+                }
+
+                if (0 < width && 0 < height && 0 < pitch)
+                {
                     AMFPoint hotspot = { cursorData.GetHotspotX(), cursorData.GetHotspotY() };
                     AMFSize resolution = { cursorData.GetCaptureResolutionX(), cursorData.GetCaptureResolutionY() };
                     Cursor::Type type = cursorData.GetMonochrome() ? Cursor::Type::MONOCHROME : Cursor::Type::COLOR;
 
                     // consider passing pContext and cursorData to Cursor cosntructor the same way we do for VideoData
                     // instead of allocating memory in the transport class.
+                    // Cached surfaces are shared between cursor changes, the callback must not modify the bitmap.
                     Cursor cursor(pSurface, hotspot, resolution, type);
                     m_clientInitParameters.GetCursorCallback()->OnCursorChanged(cursor);
                 }
@@ -1096,6 +1365,7 @@ namespace ssdk::transport_amd
         {
             InitID initID = audioInit.GetID();
             StreamID streamID = audioInit.GetStreamID();
+            m_AudioInitIDs[streamID] = initID;
             bool result = false;
             if (nullptr != m_clientInitParameters.GetAudioReceiverCallback())
             {
@@ -1133,36 +1403,82 @@ namespace ssdk::transport_amd
         {
             AMFTraceError(AMF_FACILITY, L"OnAudioOutData - Context is missing");
         }
+        else if (audioData.GetInitID() != INVALID_INIT_ID &&
+                 (m_AudioInitIDs.find(audioData.GetStreamID()) == m_AudioInitIDs.end() || m_AudioInitIDs[audioData.GetStreamID()] != audioData.GetInitID()))
+        {   //  Delivered ahead of its AudioInit, which was lost and is still being retransmitted
+            AMFTraceDebug(AMF_FACILITY, L"OnAudioOutData - frame %lld of stream %lld dropped, waiting for init ID %lld",
+                          audioData.GetSequenceNumber(), audioData.GetStreamID(), audioData.GetInitID());
+        }
         else if (nullptr != m_clientInitParameters.GetAudioReceiverCallback())
         {
             size_t messageLen = strlen((char*)msg + 1) + 1;
-            const void* audioDataPtr = static_cast<const amf_uint8*>(msg) + messageLen + 1;
+            const amf_uint8* audioDataPtr = static_cast<const amf_uint8*>(msg) + messageLen + 1;
             size_t audioDataSize = messageSize - messageLen - 1;
             amf_size sizeToDecode = audioData.IsSizePresent() ? (amf_size)audioData.GetSize() : audioDataSize;
+            StreamID streamID = audioData.GetStreamID();
 
-            amf::AMFBufferPtr pBuffer;
-            if (AMF_OK != pContext->AllocBuffer(amf::AMF_MEMORY_HOST, sizeToDecode, &pBuffer))
+            //  Detect lost frames by sequence number and find the redundant copies this message carries for them
+            const AudioData::RedundantBlocks& redundantBlocks = audioData.GetRedundantBlocks();
+            std::vector<int64_t> redundantSequenceNumbers;
+            std::vector<size_t> redundantOffsets;
+            size_t offset = sizeToDecode;
+            for (const AudioData::RedundantBlock& block : redundantBlocks)
             {
-                AMFTraceError(AMF_FACILITY, L"AllocBuffer(%d) failed", (int)sizeToDecode);
-                return;
+                if (offset + block.size > audioDataSize)
+                {
+                    AMFTraceWarning(AMF_FACILITY, L"OnAudioOutData - redundant audio blocks exceed the message size, ignored");
+                    redundantSequenceNumbers.clear();
+                    break;
+                }
+                redundantSequenceNumbers.push_back(block.sequenceNumber);
+                redundantOffsets.push_back(offset);
+                offset += block.size;
             }
+            std::vector<size_t> recover;
+            AudioLossRecovery& lossRecovery = m_AudioLossRecovery[streamID];
+            bool deliverPrimary = lossRecovery.OnFrame(audioData.GetSequenceNumber(), audioData.GetDiscontinuity(), redundantSequenceNumbers, recover);
 
-            memcpy(pBuffer->GetNative(), audioDataPtr, sizeToDecode);
-
-            pBuffer->SetPts(audioData.GetPts());
-            if (audioData.GetDuration() > 0)
+            for (size_t idx : recover)
             {
-                pBuffer->SetDuration(audioData.GetDuration());
+                const AudioData::RedundantBlock& block = redundantBlocks[idx];
+                DeliverAudioBuffer(pContext, streamID, audioDataPtr + redundantOffsets[idx], block.size, block.pts, block.duration, block.sequenceNumber, false);
             }
+            if (recover.empty() == false)
+            {
+                const AudioLossRecovery::Stats& stats = lossRecovery.GetStats();
+                AMFTraceDebug(AMF_FACILITY, L"OnAudioOutData - recovered %d audio frame(s) before frame %lld, %lld of %lld lost frames recovered so far",
+                              int(recover.size()), audioData.GetSequenceNumber(), stats.recovered, stats.lost);
+            }
+            if (deliverPrimary == true)
+            {
+                DeliverAudioBuffer(pContext, streamID, audioDataPtr, sizeToDecode, audioData.GetPts(), audioData.GetDuration(), audioData.GetSequenceNumber(), audioData.GetDiscontinuity());
+            }
+        }
+    }
 
-            // consider passing m_pContext and AudioData to ReceivableAudioBuffer cosntructor the same way we do for VideoData
-            // instead of allocating memory in the transport class.
-            ReceivableAudioBuffer buffer(pBuffer, audioData.GetSequenceNumber(), audioData.GetDiscontinuity());
+    void ClientTransportImpl::DeliverAudioBuffer(amf::AMFContext* pContext, StreamID streamID, const void* data, size_t size, amf_pts pts, amf_pts duration,
+                                                 int64_t sequenceNumber, bool discontinuity)
+    {
+        amf::AMFBufferPtr pBuffer;
+        if (AMF_OK != pContext->AllocBuffer(amf::AMF_MEMORY_HOST, size, &pBuffer))
+        {
+            AMFTraceError(AMF_FACILITY, L"AllocBuffer(%d) failed", (int)size);
+            return;
+        }
 
-            StreamID streamID = audioData.GetStreamID();
+        memcpy(pBuffer->GetNative(), data, size);
 
-            m_clientInitParameters.GetAudioReceiverCallback()->OnAudioBuffer(streamID, buffer);
+        pBuffer->SetPts(pts);
+        if (duration > 0)
+        {
+            pBuffer->SetDuration(duration);
         }
+
+        // consider passing m_pContext and AudioData to ReceivableAudioBuffer cosntructor the same way we do for VideoData
+        // instead of allocating memory in the transport class.
+        ReceivableAudioBuffer buffer(pBuffer, sequenceNumber, discontinuity);
+
+        m_clientInitParameters.GetAudioReceiverCallback()->OnAudioBuffer(streamID, buffer);
     }
 
     void ClientTransportImpl::OnAudioInMessage(Session* session, const void* msg, size_t /*messageSize*/)
@@ -1267,11 +1583,9 @@ namespace ssdk::transport_amd
         AMF_RETURN_IF_FALSE(nullptr != pSession, Result::FAIL, L"SendMsg(): transport contains nullptr session pointer");
 
         ssdk::util::AESPSKCipher::Ptr pCipher;
-        amf::AMFContextPtr pContext;
         {
             amf::AMFLock lock(&m_CCCGuard);
             pCipher = m_pCipher;
-            pContext = m_pContext;
         }
 
         if (nullptr == pCipher) // send unencoded message
@@ -1285,32 +1599,19 @@ namespace ssdk::transport_amd
             {
                 AMFTraceError(AMF_FACILITY, L"SendMsg(): Failed to allocate a zero-length buffer, msgLen: %ld", msgLen);
             }
-            else if (nullptr == pContext)
-            {
-                AMFTraceError(AMF_FACILITY, L"SendMsg(): Context is missing, can't allocate buffer");
-            }
             else
             {
-                AMF_RESULT res;
-                amf::AMFBufferPtr pSendBuffer;
-                res = pContext->AllocBuffer(amf::AMF_MEMORY_HOST, cipherTextBufferSize, &pSendBuffer);
-                if (res != AMF_OK)
+                ssdk::util::BufferPool::Lease sendBuffer = ssdk::util::BufferPool::GetInstance().Acquire(cipherTextBufferSize);
+                uint8_t* cipherText = sendBuffer.GetData();
+                size_t cipherTextSize;
+                if (pCipher->Encrypt(msg, msgLen, cipherText, &cipherTextSize))
                 {
-                    AMFTraceError(AMF_FACILITY, L"SendMsg(): Failed to allocate a buffer size: %ld, msgLen: %ld", cipherTextBufferSize, msgLen);
+                    result = pSession->Send(channel, cipherText, cipherTextBufferSize);
                 }
                 else
                 {
-                    uint8_t* cipherText = static_cast<uint8_t*>(pSendBuffer->GetNative());
-                    size_t cipherTextSize;
-                    if (pCipher->Encrypt(msg, msgLen, cipherText, &cipherTextSize))
-                    {
-                        result = pSession->Send(channel, cipherText, cipherTextBufferSize);
-                    }
-                    else
-                    {
-                        AMFTraceError(AMF_FACILITY, L"SendMsg(): ANSCipher::Encrypt failed");
-                        result = Result::INVALID_ARG;
-                    }
+                    AMFTraceError(AMF_FACILITY, L"SendMsg(): ANSCipher::Encrypt failed");
+                    result = Result::INVALID_ARG;
                 }
             }
         }
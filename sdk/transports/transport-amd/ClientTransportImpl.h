@@ -42,9 +42,13 @@ THE SOFTWARE.
 #endif
 
 #include "ClientImpl.h"
+#include "CursorCache.h"
+#include "AudioRedundancy.h"
+#include "SessionResumption.h"
 #include "transports/transport-common/ClientTransport.h"
 #include "util/encryption/AESPSKCipher.h"
 #include "sdk/util/stats/ClientStatsManager.h"
+#include "util/clock/ClockSync.h"
 
 #include <set>
 #include <map>
@@ -92,6 +96,13 @@ namespace ssdk::transport_amd
             inline uint16_t GetDiscoveryPort() const noexcept { return m_discoveryPort; }
             inline void SetDiscoveryPort(uint16_t port) noexcept { m_discoveryPort = port; }
 
+            inline const std::string GetDiscoveryCacheFile() const noexcept { return m_DiscoveryCacheFile; }
+            inline void SetDiscoveryCacheFile(const std::string& fileName) noexcept { m_DiscoveryCacheFile = fileName; }  // Servers found by discovery are remembered across restarts, empty - in memory only
+
+            inline const std::string GetCaptureFile() const noexcept { return m_CaptureFile; }
+            inline bool GetCaptureRedacted() const noexcept { return m_CaptureRedacted; }
+            inline void SetCaptureFile(const std::string& fileName, bool redactPayloads = false) noexcept { m_CaptureFile = fileName; m_CaptureRedacted = redactPayloads; }  // Records the stream for StreamReplay, empty - no capture
+
             int64_t GetDatagramSize() { return m_DatagramSize; };
             void SetDatagramSize(int64_t datagramSize) { m_DatagramSize = datagramSize; };
 
@@ -107,6 +118,12 @@ namespace ssdk::transport_amd
             inline const std::string GetPassphrase() const noexcept { return m_cipherPassphrase; }
             inline void SetPassphrase(const std::string& cipherPassphrase) noexcept { m_cipherPassphrase = cipherPassphrase; }
 
+            inline bool GetSessionResumption() const noexcept { return m_SessionResumption; }
+            inline void SetSessionResumption(bool enable) noexcept { m_SessionResumption = enable; }  // Reconnects to the same server present the ticket from the previous session
+
+            inline bool GetIoUring() const noexcept { return m_IoUring; }
+            inline void SetIoUring(bool enable) noexcept { m_IoUring = enable; }  // Send datagrams through io_uring, falls back to select() when the kernel does not support it. Linux only
+
             inline void SetConnectionManagerCallback(ConnectionManagerCallback* callback) noexcept { m_CMCallback = callback; }
             inline void SetVideoSenderCallback(VideoSenderCallback* callback) noexcept { m_VSCallback = callback; }
             inline void SetVideoReceiverCallback(VideoReceiverCallback* callback) noexcept { m_VRCallback = callback; }
@@ -127,11 +144,16 @@ namespace ssdk::transport_amd
             int32_t displayClientWidth = 0;
             int32_t displayClientHeight = 0;
             uint16_t m_discoveryPort = 0;
+            std::string m_DiscoveryCacheFile;
+            std::string m_CaptureFile;
+            bool m_CaptureRedacted = false;
             ServerEnumCallback* m_ServerEnumCallback = nullptr;
             amf::AMFContextPtr m_pContext = nullptr;
             amf_uint m_LatencyMessagePeriod = TURNAROUND_LATENCY_MESSAGE_PERIOD;
             std::string m_cipherPassphrase;
             int64_t m_DatagramSize{ 65507 };
+            bool m_SessionResumption = true;
+            bool m_IoUring = false;
         };
 
         class ServerDescriptorAMD : public ServerDescriptor
@@ -172,6 +194,23 @@ namespace ssdk::transport_amd
 
         };
 
+        class ClockSyncThread : public amf::AMFThread
+        {
+        public:
+            ClockSyncThread() {};
+            void Init(ClientTransportImpl* pTransport, ssdk::util::ClockSync::Ptr pClockSync)
+            {
+                m_pTransport = pTransport;
+                m_pClockSync = pClockSync;
+            }
+
+            virtual void Run();
+
+        protected:
+            ClientTransportImpl* m_pTransport = nullptr;
+            ssdk::util::ClockSync::Ptr m_pClockSync = nullptr;
+        };
+
         typedef std::unique_ptr<char[]> SendData;
 
     public:
@@ -212,10 +251,14 @@ namespace ssdk::transport_amd
 
         // ReceiverCallback methods:
         virtual void OnMessageReceived(Session* session, Channel channel, int msgID, const void* msg, size_t messageSize) override;
+        virtual void OnClearTextMessageReceived(Session* session, Channel channel, int msgID, const void* msg, size_t messageSize) override;
         virtual void OnTerminate(Session* session, TerminationReason reason) override;
 
         // own methods
         void SetStatsManager(ssdk::util::ClientStatsManager::Ptr statsManager);
+        inline ssdk::util::ClockSync::Ptr GetClockSync() const noexcept { return m_ClockSync; }    //  Maps server timestamps to the local clock
+        inline bool IsResumed() const noexcept { return m_Resumed; }    //  The server restored the subscriptions of the previous session
+        Result RebindSocket();      //  Move the datagram session to a new local port, the server migrates it when the connection ID is in use
     protected:
         
         Result SendMessageWithData(Channel channel, Message* message, const void* data, size_t dataSize);
@@ -224,6 +267,9 @@ namespace ssdk::transport_amd
         void OnServiceConnectionRefused();
         void OnServiceForceIDRFrame(Session* session);
         void OnServiceServerStat(Session* session, const void* msg, size_t messageSize);
+        void OnServiceClockSync(const void* msg, size_t messageSize, amf_pts receiveTime);
+        void OnServiceResume(const void* msg, size_t messageSize);
+        bool ResumeSession(const std::string& ticket, const std::string& secret, const std::string& challenge, const char* deviceID);
         void OnVideoOutMessage(Session* session, const void* msg, size_t messageSize);
         void OnVideoOutInit(Session* session, const void* msg, size_t messageSize);
         void OnVideoOutData(Session* session, const void* msg, size_t messageSize);
@@ -231,6 +277,7 @@ namespace ssdk::transport_amd
         void OnAudioOutMessage(Session* session, const void* msg, size_t messageSize);
         void OnAudioOutInit(Session* session, const void* msg, size_t messageSize);
         void OnAudioOutData(Session* session, const void* msg, size_t messageSize);
+        void DeliverAudioBuffer(amf::AMFContext* pContext, StreamID streamID, const void* data, size_t size, amf_pts pts, amf_pts duration, int64_t sequenceNumber, bool discontinuity);
         void OnAudioInMessage(Session* session, const void* msg, size_t messageSize);
         void OnSensorsInMessage(Session* session, const void* msg, size_t messageSize);
         void OnMiscOutMessage(Session* session, const void* msg, size_t messageSize);
@@ -246,15 +293,30 @@ namespace ssdk::transport_amd
         amf::AMFContextPtr m_pContext = nullptr;
         ssdk::util::AESPSKCipher::Ptr m_pCipher = nullptr;
         ssdk::util::ClientStatsManager::Ptr m_StatsManager = nullptr;
+        StreamRecorder::Ptr m_Recorder = nullptr;
         mutable amf::AMFCriticalSection m_CCCGuard; // CLient, Context, Cipher guard
 
         typedef std::set<StreamID> StreamIDSet;
         StreamIDSet                         m_SubscribedVideoStreams;
         StreamIDSet                         m_SubscribedAudioStreams;
 
+        mutable amf::AMFCriticalSection     m_ResumeGuard;
+        amf::AMFEvent                       m_ResumeEvent;              // signalled when the server sends a ResumeMessage
+        std::string                         m_ResumeTicket;             // ID and secret of the ticket issued by the server, received encrypted
+        std::string                         m_ResumeSecret;
+        std::string                         m_ResumeServerUrl;
+        std::string                         m_ConnectServerUrl;         // the server the next ticket comes from
+        bool                                m_ResumeAnswered = false;
+        bool                                m_ResumeAccepted = false;
+        StreamIDSet                         m_ResumeVideoStreams;       // subscriptions the server restores when the ticket is accepted
+        StreamIDSet                         m_ResumeAudioStreams;
+        bool                                m_Resumed = false;
+
         ClientSessionImpl::Ptr m_pSession = nullptr;
         mutable amf::AMFCriticalSection m_SessionGuard;
         TurnaroundLatencyThread m_TurnaroundLatencyThread;
+        ssdk::util::ClockSync::Ptr m_ClockSync = std::make_shared<ssdk::util::ClockSync>();
+        ClockSyncThread m_ClockSyncThread;
 
         class FrameLossInfo
         {
@@ -266,5 +328,9 @@ namespace ssdk::transport_amd
         };
         typedef std::map<StreamID, FrameLossInfo> FrameLossInfoMap;
         FrameLossInfoMap m_FrameLossInfoMap;
+
+        CursorCache<amf::AMFSurfacePtr> m_CursorCache{ size_t(DEFAULT_CURSOR_CACHE_SIZE) };   // guarded by m_CCCGuard
+        std::map<StreamID, AudioLossRecovery> m_AudioLossRecovery;                              // only accessed from OnAudioOutData()
+        std::map<StreamID, InitID> m_AudioInitIDs;                                              // last AudioInit received, only accessed on the AUDIO_OUT channel
     };
 }
@@ -0,0 +1,153 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace ssdk::transport_amd
+{
+    // HELLO option advertised by clients which keep decoded cursor bitmaps. The value is the number of cursors the client can hold,
+    // a server which does not find this option in the session properties will always send complete cursor bitmaps
+    static constexpr const wchar_t* ID_CURSOR_CACHE_SIZE = L"ANS_CursorCacheSize";   // int64_t
+    static constexpr const int64_t DEFAULT_CURSOR_CACHE_SIZE = 32;
+
+    // FNV-1a over the cursor shape, 0 is reserved for "no hash"
+    inline uint64_t HashCursorBitmap(const uint8_t* bitmap, int32_t width, int32_t height, int32_t pitch, bool monochrome)
+    {
+        static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+        static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+        uint64_t hash = FNV_OFFSET_BASIS;
+        auto hashBytes = [&hash](const uint8_t* data, size_t size)
+        {
+            for (size_t i = 0; i < size; i++)
+            {
+                hash ^= data[i];
+                hash *= FNV_PRIME;
+            }
+        };
+        const int32_t shape[] = { width, height, pitch, monochrome ? 1 : 0 };
+        hashBytes(reinterpret_cast<const uint8_t*>(shape), sizeof(shape));
+        hashBytes(bitmap, size_t(pitch) * height);
+        return hash != 0 ? hash : 1;
+    }
+
+    //----------------------------------------------------------------------------------------------
+    // CursorCache - a least recently used cache of cursors keyed by the 64-bit hash of the cursor bitmap.
+    // The server keeps one to mirror the content of each client's cache, the client keeps one with the decoded cursor surfaces.
+    // Not thread-safe, the owner is responsible for locking.
+    //----------------------------------------------------------------------------------------------
+    template <typename T>
+    class CursorCache
+    {
+    public:
+        CursorCache(size_t capacity = 0) : m_Capacity(capacity) {}
+
+        inline size_t GetCapacity() const noexcept { return m_Capacity; }
+        inline size_t GetSize() const noexcept { return m_Index.size(); }
+
+        void SetCapacity(size_t capacity)
+        {
+            m_Capacity = capacity;
+            Trim();
+        }
+
+        // Returns a pointer to the cached value and moves the entry to the front, nullptr when the hash is not in the cache
+        T* Find(uint64_t hash)
+        {
+            T* result = nullptr;
+            typename Index::iterator it = m_Index.find(hash);
+            if (it != m_Index.end())
+            {
+                m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+                result = &it->second->second;
+            }
+            return result;
+        }
+
+        void Insert(uint64_t hash, const T& value)
+        {
+            if (m_Capacity > 0)
+            {
+                typename Index::iterator it = m_Index.find(hash);
+                if (it != m_Index.end())
+                {
+                    it->second->second = value;
+                    m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+                }
+                else
+                {
+                    m_Entries.emplace_front(hash, value);
+                    m_Index[hash] = m_Entries.begin();
+                    Trim();
+                }
+            }
+        }
+
+        void Clear()
+        {
+            m_Entries.clear();
+            m_Index.clear();
+        }
+
+    private:
+        void Trim()
+        {
+            while (m_Entries.size() > m_Capacity)
+            {
+                m_Index.erase(m_Entries.back().first);
+                m_Entries.pop_back();
+            }
+        }
+
+    private:
+        typedef std::list<std::pair<uint64_t, T>> Entries;
+        typedef std::unordered_map<uint64_t, typename Entries::iterator> Index;
+
+        size_t  m_Capacity;
+        Entries m_Entries;
+        Index   m_Index;
+    };
+}
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "DgramClientSessionFlowCtrl.h"
 #include "net/Selector.h"
 #include "net/DatagramSocket.h"
+#include "Misc.h"
 #include "amf/public/common/TraceAdapter.h"
 #include <sstream>
 
@@ -63,6 +64,11 @@ namespace ssdk::transport_amd
         m_pFlowCtrlBroadcast = FlowCtrlProtocol::Ptr(new FlowCtrlProtocol(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT));
         m_SendCB.SetSession(this);
         m_BroadcastCB.SetSession(this);
+        m_UnicastCB.SetSession(this);
+        for (std::atomic<int16_t>& opCode : m_ReorderableOpCode)
+        {
+            opCode = FlowCtrlProtocol::NO_REORDERING;
+        }
 
         SetTimeout(timeout);
     }
@@ -77,13 +83,77 @@ namespace ssdk::transport_amd
         m_pFlowCtrl->EnableProfile(bEnable);
     }
 
-    net::Socket::Result DatagramClientSessionFlowCtrl::SendDatagram(const void* buf, size_t bufSize, size_t* const bytesSent, int flags)
+    void DatagramClientSessionFlowCtrl::SetRecorder(StreamRecorder::Ptr recorder)
+    {
+        m_Recorder = recorder;
+        for (FlowCtrlProtocolMap::iterator it = m_ReceiverFlowCtrl.begin(); it != m_ReceiverFlowCtrl.end(); ++it)
+        {
+            it->second->SetRecorder(recorder);
+        }
+        m_pFlowCtrl->SetRecorder(recorder);
+    }
+
+    void DatagramClientSessionFlowCtrl::SetReorderableOpCode(uint8_t channelID, int16_t opCode)
+    {   //  Called from the application thread, the receivers are updated on the receiving thread
+        m_ReorderableOpCode[channelID] = opCode;
+        m_ReorderingChanged = true;
+    }
+
+    void DatagramClientSessionFlowCtrl::ApplyReorderableOpCodes(FlowCtrlProtocol& flowCtrl) const
+    {
+        for (uint8_t channelID = 0; channelID < static_cast<uint8_t>(Channel::CHANNELS_COUNT); ++channelID)
+        {
+            flowCtrl.SetReorderableOpCode(channelID, m_ReorderableOpCode[channelID]);
+        }
+    }
+
+    net::Socket::Result DatagramClientSessionFlowCtrl::SendDatagram(const void* buf, size_t bufSize, size_t* const bytesSent, int flags, net::Socket::TrafficClass trafficClass)
+    {
+        return SendDatagramTo(GetPeerAddress(), buf, bufSize, bytesSent, flags, trafficClass);
+    }
+
+    net::DatagramSendRing* DatagramClientSessionFlowCtrl::GetSendRing()
+    {
+        return m_IoUring == true && net::DatagramSocket::Ptr(m_Socket)->SupportsSendRing() == true ? net::DatagramSendRing::GetThreadInstance() : nullptr;
+    }
+
+    net::Socket::Result DatagramClientSessionFlowCtrl::QueueDatagramTo(const net::Socket::Address& peer, const void* buf, size_t size, size_t* const bytesSent, int flags,
+                                                                       net::Socket::TrafficClass trafficClass, bool flush)
     {
-        return SendDatagramTo(GetPeerAddress(), buf, bufSize, bytesSent, flags);
+        net::DatagramSendRing* ring = GetSendRing();
+        if (ring == nullptr)
+        {
+            return SendDatagramTo(peer, buf, size, bytesSent, flags, trafficClass);
+        }
+        net::Socket::Result result = net::Socket::Result::OK;
+        FlowCtrlProtocol::ConnectionID connectionID = m_ConnectionID;
+        if (connectionID != 0)
+        {   //  The ring copies the datagram, the stamped copy can be reused right away
+            static thread_local std::vector<uint8_t> stamped;
+            size_t stampedSize = FlowCtrlProtocol::StampConnectionID(buf, size, connectionID, stamped);
+            result = ring->Add(net::DatagramSocket::Ptr(m_Socket), stamped.data(), stampedSize, peer, flags, trafficClass);
+        }
+        else
+        {
+            result = ring->Add(net::DatagramSocket::Ptr(m_Socket), buf, size, peer, flags, trafficClass);
+        }
+        if (result == net::Socket::Result::OK && flush == true)
+        {
+            result = ring->Flush();
+        }
+        if (result == net::Socket::Result::OK && bytesSent != nullptr)
+        {
+            *bytesSent = size;
+        }
+        return result;
     }
 
-    net::Socket::Result DatagramClientSessionFlowCtrl::SendDatagramTo(const net::Socket::Address& /*peer*/, const void* buf, size_t size, size_t* const bytesSent, int flags)
+    net::Socket::Result DatagramClientSessionFlowCtrl::SendDatagramTo(const net::Socket::Address& peer, const void* buf, size_t size, size_t* const bytesSent, int flags, net::Socket::TrafficClass trafficClass)
     {
+        if (GetSendRing() != nullptr)
+        {   //  No need to wait for the socket to become writable, the ring does
+            return QueueDatagramTo(peer, buf, size, bytesSent, flags, trafficClass, true);
+        }
         net::Socket::Result result = net::Socket::Result::UNKNOWN_ERROR;
         net::Selector selector;
         selector.AddWritableSocket(m_Socket);
@@ -99,7 +169,21 @@ namespace ssdk::transport_amd
             case net::Selector::Result::OK:
                 if (readyToSend.size() > 0)
                 {
-                    result = net::DatagramSocket::Ptr(m_Socket)->SendTo(buf, size, GetPeerAddress(), bytesSent, flags);
+                    FlowCtrlProtocol::ConnectionID connectionID = m_ConnectionID;
+                    if (connectionID != 0)
+                    {
+                        static thread_local std::vector<uint8_t> stamped;
+                        size_t stampedSize = FlowCtrlProtocol::StampConnectionID(buf, size, connectionID, stamped);
+                        result = net::DatagramSocket::Ptr(m_Socket)->SendTo(stamped.data(), stampedSize, peer, bytesSent, flags, trafficClass);
+                        if (bytesSent != nullptr && *bytesSent >= FlowCtrlProtocol::CONNECTION_ID_TRAILER_SIZE)
+                        {
+                            *bytesSent -= FlowCtrlProtocol::CONNECTION_ID_TRAILER_SIZE;
+                        }
+                    }
+                    else
+                    {
+                        result = net::DatagramSocket::Ptr(m_Socket)->SendTo(buf, size, peer, bytesSent, flags, trafficClass);
+                    }
                 }
                 else
                 {
@@ -163,6 +247,16 @@ namespace ssdk::transport_amd
         return result;
     }
 
+    net::Socket::Result DatagramClientSessionFlowCtrl::RebindSocket()
+    {
+        net::Socket::Result result = net::DatagramSocket::Ptr(m_Socket)->Rebind();
+        if (result == net::Socket::Result::OK)
+        {
+            AMFTraceInfo(AMF_FACILITY, L"Socket rebound to a new local port");
+        }
+        return result;
+    }
+
     void DatagramClientSessionFlowCtrl::UpgradeProtocol(uint32_t version)
     {
         for (FlowCtrlProtocolMap::iterator it = m_ReceiverFlowCtrl.begin(); it != m_ReceiverFlowCtrl.end(); ++it)
@@ -172,11 +266,13 @@ namespace ssdk::transport_amd
         m_pFlowCtrl->UpgradeProtocol(version);
     }
 
-    net::Socket::Result  DatagramClientSessionFlowCtrl::SendCB::OnFragmentReady(const FlowCtrlProtocol::Fragment& fragment, bool /*last*/)
+    net::Socket::Result  DatagramClientSessionFlowCtrl::SendCB::OnFragmentReady(const FlowCtrlProtocol::Fragment& fragment, bool last)
     {
         net::Socket::Result result;
         size_t bytesSent = 0;
-        if ((result = m_Session->SendDatagram(fragment.GetDataToSend(), fragment.GetSizeToSend(), &bytesSent, m_SocketFlags)) != net::Socket::Result::OK)
+        //  The fragments of a message are batched until the last one
+        if ((result = m_Session->QueueDatagramTo(m_Session->GetPeerAddress(), fragment.GetDataToSend(), fragment.GetSizeToSend(), &bytesSent, m_SocketFlags,
+                                                 GetChannelTrafficClass(fragment.GetChannelID()), last)) != net::Socket::Result::OK)
         {
             std::stringstream errMsg;
             errMsg << "Failed to send fragment: Socket::Result==" << int(result);
@@ -213,6 +309,24 @@ namespace ssdk::transport_amd
         m_Session->SetTxMaxFragmentSize(fragmentSize);
     }
 
+    net::Socket::Result DatagramClientSessionFlowCtrl::UnicastCB::OnFragmentReady(const FlowCtrlProtocol::Fragment& fragment, bool /*last*/)
+    {
+        net::Socket::Result result;
+        size_t bytesSent = 0;
+        if ((result = m_Session->SendDatagramTo(m_Destination, fragment.GetDataToSend(), fragment.GetSizeToSend(), &bytesSent, m_SocketFlags)) != net::Socket::Result::OK)
+        {
+            std::stringstream errMsg;
+            errMsg << "Failed to send fragment to " << m_Destination.GetParsedAddressAsString() << ": Socket::Result==" << int(result);
+            AMFTraceError(AMF_FACILITY, L"%S", errMsg.str().c_str());
+        }
+        return result;
+    }
+
+    void DatagramClientSessionFlowCtrl::UnicastCB::OnSetMaxFragmentSize(size_t fragmentSize)
+    {
+        m_Session->SetTxMaxFragmentSize(fragmentSize);
+    }
+
     net::Socket::Result DatagramClientSessionFlowCtrl::SendOrBroadcastMessage(const void* buf, size_t bufSize, uint8_t optional, size_t* const bytesSent, int flags, std::unique_ptr <FlowCtrlProtocol>& pFlowCtrl, OutgoingCB& callback)
     {
         callback.SetSocketFlags(flags);
@@ -240,6 +354,12 @@ namespace ssdk::transport_amd
         return SendOrBroadcastMessage(buf, bufSize, optional, bytesSent, flags, m_pFlowCtrlBroadcast, m_BroadcastCB);
     }
 
+    net::Socket::Result DatagramClientSessionFlowCtrl::Unicast(const net::Socket::Address& destination, const void* buf, size_t bufSize, uint8_t optional, size_t* const bytesSent, int flags)
+    {
+        m_UnicastCB.SetDestination(destination);
+        return SendOrBroadcastMessage(buf, bufSize, optional, bytesSent, flags, m_pFlowCtrlBroadcast, m_UnicastCB);
+    }
+
     bool DatagramClientSessionFlowCtrl::OnTickNotify()
     {
         bool messagePosted = false;
@@ -261,6 +381,15 @@ namespace ssdk::transport_amd
         {
             m_ReceiverFlowCtrl[receivedFrom] = FlowCtrlProtocol::Ptr(new FlowCtrlProtocol(3));
             flowCtrlForAddress = m_ReceiverFlowCtrl.find(receivedFrom);
+            flowCtrlForAddress->second->SetRecorder(m_Recorder);
+            ApplyReorderableOpCodes(*flowCtrlForAddress->second);
+        }
+        if (m_ReorderingChanged.exchange(false) == true)
+        {
+            for (FlowCtrlProtocolMap::iterator it = m_ReceiverFlowCtrl.begin(); it != m_ReceiverFlowCtrl.end(); ++it)
+            {
+                ApplyReorderableOpCodes(*it->second);
+            }
         }
 
         DatagramClientSessionFlowCtrl::Result result = DatagramClientSessionFlowCtrl::Result::OK;
@@ -277,6 +406,6 @@ namespace ssdk::transport_amd
     {
         size_t bytesSent = 0;
 
-        return SendDatagram(fragment.GetDataToSend(), fragment.GetSizeToSend(), &bytesSent);
+        return SendDatagram(fragment.GetDataToSend(), fragment.GetSizeToSend(), &bytesSent, 0, GetChannelTrafficClass(fragment.GetChannelID()));
     }
 }
\ No newline at end of file
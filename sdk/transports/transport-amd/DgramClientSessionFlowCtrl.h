@@ -44,9 +44,11 @@ THE SOFTWARE.
 
 #include "net/Socket.h"
 #include "net/DatagramClientSession.h"
+#include "net/DatagramRing.h"
 #include "transports/transport-amd/FlowCtrlProtocol.h"
 #include "transports/transport-amd/Channels.h"
 
+#include <atomic>
 #include <map>
 #include <memory>
 
@@ -107,20 +109,59 @@ namespace ssdk::transport_amd
         };
         friend class BroadcastCB;
 
+        class UnicastCB :
+            public OutgoingCB
+        {
+        public:
+            UnicastCB() {}
+
+            inline void SetDestination(const net::Socket::Address& destination) { m_Destination = destination; }
+
+        protected:
+            virtual net::Socket::Result OnFragmentReady(const FlowCtrlProtocol::Fragment& fragment, bool last) override;
+            virtual void OnSetMaxFragmentSize(size_t fragmentSize) override;
+
+        protected:
+            net::Socket::Address m_Destination;
+        };
+        friend class UnicastCB;
+
 
     protected:
         DatagramClientSessionFlowCtrl(net::Socket* sock, const net::Socket::Address& peer, size_t receiveBufSize, time_t timeout);
         virtual net::Socket::Result OnRequestFragment(const FlowCtrlProtocol::Fragment& fragment) override;
 
     public:
-        net::Socket::Result SendDatagram(const void* buf, size_t bufSize, size_t* const bytesSent = nullptr, int flags = 0);
-        net::Socket::Result SendDatagramTo(const net::Socket::Address& peer, const void* buf, size_t bufSize, size_t* const bytesSent = nullptr, int flags = 0);
+        net::Socket::Result SendDatagram(const void* buf, size_t bufSize, size_t* const bytesSent = nullptr, int flags = 0,
+                                         net::Socket::TrafficClass trafficClass = net::Socket::TrafficClass::BEST_EFFORT);
+        net::Socket::Result SendDatagramTo(const net::Socket::Address& peer, const void* buf, size_t bufSize, size_t* const bytesSent = nullptr, int flags = 0,
+                                           net::Socket::TrafficClass trafficClass = net::Socket::TrafficClass::BEST_EFFORT);
         net::Socket::Result BroadcastDatagram(const void* buf, size_t bufSize, size_t* const bytesSent = nullptr, int flags = 0);
 
         net::Socket::Result Send(const void* buf, size_t bufSize, uint8_t optional, size_t* const bytesSent = nullptr, int flags = 0);
         net::Socket::Result Broadcast(const void* buf, size_t bufSize, uint8_t optional, size_t* const bytesSent = nullptr, int flags = 0);
+        //  Sends a message to a host other than the peer, message IDs are shared with Broadcast()
+        net::Socket::Result Unicast(const net::Socket::Address& destination, const void* buf, size_t bufSize, uint8_t optional, size_t* const bytesSent = nullptr, int flags = 0);
+
+        //  Assigned by the server in the HELLO response, stamped on every datagram so that the session survives address changes
+        inline void SetConnectionID(FlowCtrlProtocol::ConnectionID connectionID) { m_ConnectionID = connectionID; }
+        inline FlowCtrlProtocol::ConnectionID GetConnectionID() const { return m_ConnectionID; }
+        net::Socket::Result RebindSocket();     //  Move to a new local port, as a NAT rebinding would
+
+        void SetRecorder(StreamRecorder::Ptr recorder);     //  Captures the fragments exchanged with the peer, set before any traffic
+        //  Messages received on the channel starting with the opcode skip gaps, see FlowCtrlProtocol::SetReorderableOpCode()
+        void SetReorderableOpCode(uint8_t channelID, int16_t opCode);
+
+        //  Send through the DatagramSendRing of the sending thread, the fragments of a message then go out in one batch.
+        //  Has no effect where io_uring is not available
+        inline void EnableIoUring(bool enable) { m_IoUring = enable; }
 
     private:
+        net::DatagramSendRing* GetSendRing();
+        void ApplyReorderableOpCodes(FlowCtrlProtocol& flowCtrl) const;
+        //  Adds the datagram to the send ring and flushes the ring when flush is true, sends it right away without a ring
+        net::Socket::Result QueueDatagramTo(const net::Socket::Address& peer, const void* buf, size_t bufSize, size_t* const bytesSent, int flags,
+                                            net::Socket::TrafficClass trafficClass, bool flush);
         net::Socket::Result SendOrBroadcastMessage(const void* buf, size_t bufSize, uint8_t optional, size_t* const bytesSent, int flags, std::unique_ptr <FlowCtrlProtocol>& pFlowCtrl, OutgoingCB& callback);
 
     protected:
@@ -134,8 +175,14 @@ namespace ssdk::transport_amd
         SendCB              m_SendCB;
         std::unique_ptr <FlowCtrlProtocol>  m_pFlowCtrlBroadcast;
         BroadcastCB         m_BroadcastCB;
+        UnicastCB           m_UnicastCB;
         typedef std::map<net::Socket::Address, std::unique_ptr<FlowCtrlProtocol>>   FlowCtrlProtocolMap;
         FlowCtrlProtocolMap m_ReceiverFlowCtrl;
+        std::atomic<FlowCtrlProtocol::ConnectionID> m_ConnectionID{ 0 };
+        StreamRecorder::Ptr m_Recorder;
+        std::atomic<int16_t> m_ReorderableOpCode[static_cast<size_t>(Channel::CHANNELS_COUNT)];
+        std::atomic<bool>   m_ReorderingChanged{ false };
+        bool                m_IoUring = false;
     };
 
 
@@ -34,12 +34,14 @@ THE SOFTWARE.
 */
 
 #include "FlowCtrlProtocol.h"
+#include "util/trace/PipelineTrace.h"
 #include "amf/public/include/core/Platform.h"
 #include "amf/public/common/Thread.h"
 #include "amf/public/common/TraceAdapter.h"
 
 #include <time.h>
 #include <queue>
+#include <vector>
 
 //#define PRINT_EXTRA_LOGS
 namespace ssdk::transport_amd
@@ -85,6 +87,7 @@ namespace ssdk::transport_amd
         {
             m_CurMessageID[ch] = 1;
             m_LastMessageID[ch] = 0;
+            m_ReorderableOpCode[ch] = NO_REORDERING;
         }
         Init(version);
     }
@@ -131,6 +134,10 @@ namespace ssdk::transport_amd
         {
             msg.clear();
         }
+        for (MessageTimesMap& delivered : m_DeliveredAhead)
+        {
+            delivered.clear();
+        }
     }
     //--------------------------------------------------------------------------------------------------------------------
     uint32_t FlowCtrlProtocol::MaxSupportedVersion(uint32_t minLocal, uint32_t maxLocal, uint32_t minRemote, uint32_t maxRemote) const noexcept
@@ -178,6 +185,20 @@ namespace ssdk::transport_amd
         {
             amf::AMFLock lock(&m_incomingCs);
             FlowCtrlProtocol::MessageID currentID = m_LastMessageID[channelID];
+            bool reorderable = m_ReorderableOpCode[channelID] != NO_REORDERING;
+
+            //  Reorderable messages do not overtake the first complete message which has to wait for the gap
+            bool blocked = false;
+            MessageID blockedID = 0;
+            for (MessageMap::iterator it = m_IncomingMessages[channelID].begin(); reorderable == true && it != m_IncomingMessages[channelID].end(); it++)
+            {
+                if (it->second->GetBytesRemaining() == 0 && IsReorderable(channelID, it->second) == false &&
+                    CalcDistance(m_LastMessageID[channelID], it->first) > 0 && (blocked == false || CalcDistance(it->first, blockedID) > 0))
+                {
+                    blocked = true;
+                    blockedID = it->first;
+                }
+            }
 
             currentID++;
     #ifdef PRINT_EXTRA_LOGS
@@ -187,26 +208,45 @@ namespace ssdk::transport_amd
     #endif
             for (MessageMap::iterator it = m_IncomingMessages[channelID].begin(); it != m_IncomingMessages[channelID].end();)
             {
-                if (it->second->GetBytesRemaining() == 0 && (currentID == it->first || GetEnableProfile()))
+                MessageID messageID = it->first;
+                bool complete = it->second->GetBytesRemaining() == 0;
+                bool inOrder = complete == true && (currentID == messageID || GetEnableProfile());
+                bool ahead = complete == true && inOrder == false && IsReorderable(channelID, it->second) == true &&
+                    CalcDistance(m_LastMessageID[channelID], messageID) > 0 && (blocked == false || CalcDistance(messageID, blockedID) > 0);
+                if (inOrder == true || ahead == true)
                 {
-                    m_LastMessageID[channelID] = it->first;
+                    if (inOrder == true)
+                    {
+                        m_LastMessageID[channelID] = messageID;
+                    }
+                    else
+                    {   //  The last message ID stays before the gap, so that messages in the gap are still delivered in order
+                        m_DeliveredAhead[channelID].insert({ messageID, amf_high_precision_clock() });
+                    }
                     fragmentBuffer = it->second;
                     it = m_IncomingMessages[channelID].erase(it);
 
                     if (fragmentBuffer != nullptr)
                     {
     #ifdef PRINT_EXTRA_LOGS
-                        AMFTraceInfo(TRACE_SCOPE, L"PromoteMessage. ver %d channelID %d LastMessageID=%d size=%d %s",
-                            m_version, channelID, (int)(uint32_t)m_LastMessageID[channelID], fragmentBuffer->GetSize(),
+                        AMFTraceInfo(TRACE_SCOPE, L"PromoteMessage. ver %d channelID %d MessageID=%d size=%d %s",
+                            m_version, channelID, (int)(uint32_t)messageID, fragmentBuffer->GetSize(),
                             m_bEnableProfile ? L"Profile" : L"");
     #endif
-                        callback.OnCompleteMessage(m_LastMessageID[channelID], fragmentBuffer->GetData(), fragmentBuffer->GetSize(), fragmentBuffer->GetPeerAddress(), fragmentBuffer->GetChannelID());
+                        SSDK_TRACE_DEFER(REASSEMBLE, fragmentBuffer->GetCreationTime());     //  Keyed if the receiver finds a frame in the message
+                        callback.OnCompleteMessage(messageID, fragmentBuffer->GetData(), fragmentBuffer->GetSize(), fragmentBuffer->GetPeerAddress(), fragmentBuffer->GetChannelID());
+                        SSDK_TRACE_FLUSH();
                         m_lastMsgRecievedClock = amf_high_precision_clock();
+                        if (inOrder == true)
+                        {
+                            SkipDeliveredAhead(channelID);
+                        }
+                        currentID = m_LastMessageID[channelID];
                         currentID++;
                         sent = true;
                     }
                 }
-                else if (sent)
+                else if (sent == true && reorderable == false)
                 {
                     break;
                 }
@@ -240,8 +280,30 @@ namespace ssdk::transport_amd
         }
         else
         {
+            Record(StreamCapture::Direction::INCOMING, fragment);
             bool bMessageComplete = false;
             uint8_t channelID = fragment.GetChannelID();
+            PathMtuProbeType probeType = PathMtuProbeType::PROBE;
+            uint32_t probeSize = 0;
+            if (channelID == static_cast<uint8_t>(Channel::SYSTEM) && ParsePathMtuProbe(fragment, probeType, probeSize) == true)
+            {
+                return ProcessPathMtuProbe(fragment, probeType, probeSize, incomingCallback);
+            }
+            PathValidationType validationType = PathValidationType::CHALLENGE;
+            uint64_t token = 0;
+            if (channelID == static_cast<uint8_t>(Channel::SYSTEM) && ParsePathValidation(fragment, validationType, token) == true)
+            {   //  Responses are consumed by the server before the session sees them, or arrive late once the path has been validated
+                if (validationType == PathValidationType::CHALLENGE)
+                {
+                    Fragment response = CreatePathValidation(PathValidationType::RESPONSE, token);
+                    Record(StreamCapture::Direction::OUTGOING, response);
+                    if (incomingCallback.OnRequestFragment(response) != net::Socket::Result::OK)
+                    {
+                        result = FlowCtrlProtocol::Result::FAIL;
+                    }
+                }
+                return result;
+            }
             {
                 amf::AMFLock lock(&m_incomingCs);
 
@@ -260,7 +322,9 @@ namespace ssdk::transport_amd
                 }
 
                 int distance = CalcDistance(m_LastMessageID[channelID], messageID);
-                if (distance > 0 || GetEnableProfile())// only if message is newer then last sent
+                bool reorderable = m_ReorderableOpCode[channelID] != NO_REORDERING;
+                bool deliveredAhead = m_DeliveredAhead[channelID].find(messageID) != m_DeliveredAhead[channelID].end();
+                if ((distance > 0 || GetEnableProfile()) && deliveredAhead == false)// only if message is newer then last sent
                 {
                     MessageMap::iterator msgIt = m_IncomingMessages[channelID].find(messageID);
                     if (msgIt == m_IncomingMessages[channelID].end())
@@ -291,8 +355,9 @@ namespace ssdk::transport_amd
                     // Check for whole missing message(s) and request to resend them again
                     // If found gap or waiting for requested missing message(s)
                     if ((distance > 1 && distance < 0x7FFF) || WaitingForRequestedMessages(channelID))
-                    {
-                        bMessageComplete = RequestMissingMessages(channelID, messageID, bMessageComplete, incomingCallback);
+                    {   //  A complete message may still be reorderable past the gap
+                        bool bStopWaiting = RequestMissingMessages(channelID, messageID, bMessageComplete, incomingCallback);
+                        bMessageComplete = bStopWaiting == true || (bMessageComplete == true && reorderable == true);
                     }
                 }
                 else
@@ -345,7 +410,11 @@ namespace ssdk::transport_amd
             Fragment fragment(messageID, message, messageSize, messageSize - bytesRemaining, curFragmentSize, channelID);
             bytesRemaining -= curFragmentSize;
 
-            res = onFragmentReadyCB.OnFragmentReady(fragment, bytesRemaining != 0);
+            Record(StreamCapture::Direction::OUTGOING, fragment);
+            {
+                SSDK_TRACE_SCOPE_SPAN(FRAGMENT_SEND);
+                res = onFragmentReadyCB.OnFragmentReady(fragment, bytesRemaining == 0);
+            }
     #ifdef PRINT_EXTRA_LOGS
             AMFTraceInfo(TRACE_SCOPE, L"===> Fragment sent ver %d channelID %d seqId=%d messageSize=%d fragmentSize=%d",
                 m_version, channelID, (int)fragment.GetMessageID(), (int)fragment.GetMessageSize(), (int)fragment.GetFragmentSize());
@@ -388,7 +457,11 @@ namespace ssdk::transport_amd
             bytesRemaining -= curFragmentSize;
             fragmentOffset += curFragmentSize;
 
-            res = onFragmentReadyCB.OnFragmentReady(fragment, bytesRemaining != 0);
+            Record(StreamCapture::Direction::OUTGOING, fragment);
+            {
+                SSDK_TRACE_SPAN(FRAGMENT_RESEND, ssdk::util::PipelineTrace::NO_KEY);
+                res = onFragmentReadyCB.OnFragmentReady(fragment, bytesRemaining == 0);
+            }
 
             if (res != net::Socket::Result::OK)
             {
@@ -418,7 +491,7 @@ namespace ssdk::transport_amd
         {
             amf::AMFLock lock(&m_incomingCs);
 
-            if (m_IncomingMessages[channelID].empty())
+            if (m_IncomingMessages[channelID].empty() && m_DeliveredAhead[channelID].empty())
             {
                 return false;
             }
@@ -447,7 +520,30 @@ namespace ssdk::transport_amd
                 }
             }
 
-            if (found != m_IncomingMessages[channelID].end() && distanceTime >= FlowCtrlProtocol::msgFlushTimeoutInPts)
+            // a gap before messages delivered ahead of it is given up on the same way
+            bool foundDelivered = false;
+            MessageID deliveredID = 0;
+            for (MessageTimesMap::iterator it = m_DeliveredAhead[channelID].begin(); it != m_DeliveredAhead[channelID].end(); it++)
+            {
+                int distID = CalcDistance(m_LastMessageID[channelID], it->first);
+                if (distID >= 0 && distID < distanceID)
+                {
+                    distanceTime = now - it->second;
+                    distanceID = distID;
+                    foundDelivered = true;
+                    deliveredID = it->first;
+                }
+            }
+
+            if (foundDelivered == true && distanceTime >= FlowCtrlProtocol::msgFlushTimeoutInPts)
+            {
+                AMFTraceInfo(TRACE_SCOPE, L"Gap before message delivered ahead skipped (channelID=%d). lastMsgId=%d newID=%d timediff=%5.2fms idDiff=%d", channelID,
+                    (int)(uint32_t)(m_LastMessageID[channelID]), (int)(uint32_t)deliveredID, distanceTime / 10000.f, distanceID);
+                m_LastMessageID[channelID] = deliveredID;
+                m_LastMessageID[channelID]--;
+                SkipDeliveredAhead(channelID);
+            }
+            else if (foundDelivered == false && found != m_IncomingMessages[channelID].end() && distanceTime >= FlowCtrlProtocol::msgFlushTimeoutInPts)
             {
                 AMFTraceInfo(TRACE_SCOPE, L"Message sent from gap (channelID=%d). lastMsgId=%d newID=%d timediff=%5.2fms idDiff=%d queue=%d", channelID,
                     (int)(uint32_t)(m_LastMessageID[channelID]), (int)(uint32_t)found->first, distanceTime / 10000.f, distanceID, (int)m_IncomingMessages[channelID].size());
@@ -522,6 +618,7 @@ namespace ssdk::transport_amd
             Fragment fragment(messageID, message, messageSize, messageSize - bytesRemaining, curFragmentSize, (unsigned char)Channel::SYSTEM);
             bytesRemaining -= curFragmentSize;
 
+            Record(StreamCapture::Direction::OUTGOING, fragment);
             net::Socket::Result res = processIncomingCallback.OnRequestFragment(fragment);
 
     #ifdef PRINT_EXTRA_LOGS
@@ -606,7 +703,8 @@ namespace ssdk::transport_amd
             for (MessageID missingID = lastMessageID + 1; missingID < currMessageID; ++missingID)
             {
                 if (m_RequestedMissingID[channelID].find(missingID) == m_RequestedMissingID[channelID].end() && // if not requested before
-                    m_IncomingMessages[channelID].find(missingID) == m_IncomingMessages[channelID].end())       // and if not came before
+                    m_IncomingMessages[channelID].find(missingID) == m_IncomingMessages[channelID].end() &&     // and if not came before
+                    m_DeliveredAhead[channelID].find(missingID) == m_DeliveredAhead[channelID].end())
                 {
                     missingChunks.AddChunk(channelID, missingID, 0, 0);
                     m_RequestedMissingID[channelID].insert({ missingID, false });
@@ -629,6 +727,45 @@ namespace ssdk::transport_amd
         return bStopWaiting;
     }
 
+    //-------------------------------------------------------------------------------------------------------
+    void FlowCtrlProtocol::SetReorderableOpCode(uint8_t channelID, int16_t opCode)
+    {
+        amf::AMFLock lock(&m_incomingCs);
+        m_ReorderableOpCode[channelID] = opCode;
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    bool FlowCtrlProtocol::IsReorderable(uint8_t channelID, const Buffer::Ptr& message) const
+    {
+        return m_ReorderableOpCode[channelID] != NO_REORDERING && message->GetSize() > 0 &&
+            message->GetData()[0] == static_cast<unsigned char>(m_ReorderableOpCode[channelID]);
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    void FlowCtrlProtocol::SkipDeliveredAhead(uint8_t channelID)
+    {
+        // Move the last message ID past the messages already delivered ahead of the gap it has just closed
+        MessageTimesMap& delivered = m_DeliveredAhead[channelID];
+        MessageID nextID = m_LastMessageID[channelID];
+        nextID++;
+        while (delivered.erase(nextID) > 0)
+        {
+            m_LastMessageID[channelID] = nextID;
+            nextID++;
+        }
+        for (MessageTimesMap::iterator it = delivered.begin(); it != delivered.end();)
+        {
+            if (CalcDistance(m_LastMessageID[channelID], it->first) <= 0)
+            {
+                it = delivered.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+
     //-------------------------------------------------------------------------------------------------------
     bool FlowCtrlProtocol::WaitingForRequestedMessages(uint8_t channelID) const
     {
@@ -701,6 +838,146 @@ namespace ssdk::transport_amd
         return result;
     }
 
+    //-------------------------------------------------------------------------------------------------------
+    FlowCtrlProtocol::Result FlowCtrlProtocol::ProcessPathMtuProbe(const Fragment& fragment, PathMtuProbeType type, uint32_t probeSize, ProcessIncomingCallback& incomingCallback)
+    {
+        FlowCtrlProtocol::Result result = FlowCtrlProtocol::Result::OK;
+        switch (type)
+        {
+        case PathMtuProbeType::PROBE:
+            // A probe which arrived truncated or was padded by someone else does not confirm anything
+            if (fragment.GetSizeToSend() == probeSize)
+            {
+                Fragment ack = CreatePathMtuProbe(fragment.GetMessageID(), PathMtuProbeType::ACK, probeSize);
+                Record(StreamCapture::Direction::OUTGOING, ack);
+                if (incomingCallback.OnRequestFragment(ack) != net::Socket::Result::OK)
+                {
+                    result = FlowCtrlProtocol::Result::FAIL;
+                }
+            }
+            break;
+        case PathMtuProbeType::ACK:
+            incomingCallback.OnPathMtuProbeAck(fragment.GetMessageID(), probeSize);
+            break;
+        default:
+            break;
+        }
+        return result;
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    void FlowCtrlProtocol::Record(StreamCapture::Direction direction, const Fragment& fragment)
+    {
+        if (m_Recorder != nullptr)
+        {
+            m_Recorder->RecordFragment(direction, fragment.GetChannelID(), fragment.GetMessageID(), fragment.GetDataToSend(), fragment.GetSizeToSend(), Fragment::GetSizeOfFragmentHeader());
+        }
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    FlowCtrlProtocol::Fragment FlowCtrlProtocol::CreatePathMtuProbe(MessageID probeID, PathMtuProbeType type, uint32_t probeSize, size_t datagramSize)
+    {
+        size_t payloadSize = sizeof(PathMtuProbeHeader);
+        if (datagramSize > sizeof(FragmentHeader) + sizeof(PathMtuProbeHeader))
+        {
+            payloadSize = datagramSize - sizeof(FragmentHeader);
+        }
+        std::vector<uint8_t> payload(payloadSize, 0);
+        PathMtuProbeHeader* header = reinterpret_cast<PathMtuProbeHeader*>(payload.data());
+        header->m_Magic[0] = 'P';
+        header->m_Magic[1] = 'M';
+        header->m_Magic[2] = 'T';
+        header->m_Magic[3] = 'U';
+        header->m_Type = static_cast<uint8_t>(type);
+        header->m_ProbeSize = htonl(probeSize);
+        return Fragment(probeID, payload.data(), static_cast<uint32_t>(payloadSize), 0, static_cast<uint32_t>(payloadSize), static_cast<uint8_t>(Channel::SYSTEM));
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    bool FlowCtrlProtocol::ParsePathMtuProbe(const Fragment& fragment, PathMtuProbeType& type, uint32_t& probeSize)
+    {
+        bool result = false;
+        if (fragment.GetFragmentOffset() == 0 && fragment.GetFragmentSize() == fragment.GetMessageSize() && fragment.GetFragmentSize() >= sizeof(PathMtuProbeHeader))
+        {
+            const PathMtuProbeHeader* header = reinterpret_cast<const PathMtuProbeHeader*>(fragment.GetFragmentData());
+            if (header->m_Magic[0] == 'P' && header->m_Magic[1] == 'M' && header->m_Magic[2] == 'T' && header->m_Magic[3] == 'U')
+            {
+                type = static_cast<PathMtuProbeType>(header->m_Type);
+                probeSize = ntohl(header->m_ProbeSize);
+                result = true;
+            }
+        }
+        return result;
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    FlowCtrlProtocol::Fragment FlowCtrlProtocol::CreatePathValidation(PathValidationType type, uint64_t token)
+    {
+        PathValidationHeader header = {};
+        header.m_Magic[0] = 'P';
+        header.m_Magic[1] = 'A';
+        header.m_Magic[2] = 'T';
+        header.m_Magic[3] = 'H';
+        header.m_Type = static_cast<uint8_t>(type);
+        header.m_Token = token;
+        return Fragment(0, &header, static_cast<uint32_t>(sizeof(header)), 0, static_cast<uint32_t>(sizeof(header)), static_cast<uint8_t>(Channel::SYSTEM));
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    bool FlowCtrlProtocol::ParsePathValidation(const Fragment& fragment, PathValidationType& type, uint64_t& token)
+    {
+        bool result = false;
+        if (fragment.GetFragmentOffset() == 0 && fragment.GetFragmentSize() == fragment.GetMessageSize() && fragment.GetFragmentSize() == sizeof(PathValidationHeader))
+        {
+            const PathValidationHeader* header = reinterpret_cast<const PathValidationHeader*>(fragment.GetFragmentData());
+            if (header->m_Magic[0] == 'P' && header->m_Magic[1] == 'A' && header->m_Magic[2] == 'T' && header->m_Magic[3] == 'H')
+            {
+                type = static_cast<PathValidationType>(header->m_Type);
+                token = header->m_Token;
+                result = true;
+            }
+        }
+        return result;
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    size_t FlowCtrlProtocol::StampConnectionID(const void* datagram, size_t datagramSize, ConnectionID connectionID, std::vector<uint8_t>& stamped)
+    {
+        if (datagramSize < sizeof(FragmentHeader))
+        {
+            stamped.assign(reinterpret_cast<const uint8_t*>(datagram), reinterpret_cast<const uint8_t*>(datagram) + datagramSize);
+            return datagramSize;
+        }
+        stamped.resize(datagramSize + CONNECTION_ID_TRAILER_SIZE);
+        memcpy(stamped.data(), datagram, datagramSize);
+        FragmentHeader* header = reinterpret_cast<FragmentHeader*>(stamped.data());
+        stamped[datagramSize] = header->m_ChannelID;
+        header->m_ChannelID = STAMPED_CHANNEL_ID;
+        ConnectionID networkOrder = htonl(connectionID);
+        memcpy(stamped.data() + datagramSize + sizeof(uint8_t), &networkOrder, sizeof(networkOrder));
+        return stamped.size();
+    }
+
+    //-------------------------------------------------------------------------------------------------------
+    bool FlowCtrlProtocol::StripConnectionID(uint8_t* datagram, size_t& datagramSize, ConnectionID& connectionID)
+    {
+        bool result = false;
+        if (datagramSize >= sizeof(FragmentHeader) + CONNECTION_ID_TRAILER_SIZE)
+        {
+            FragmentHeader* header = reinterpret_cast<FragmentHeader*>(datagram);
+            if (header->m_ChannelID == STAMPED_CHANNEL_ID)
+            {
+                datagramSize -= CONNECTION_ID_TRAILER_SIZE;
+                header->m_ChannelID = datagram[datagramSize];
+                ConnectionID networkOrder = 0;
+                memcpy(&networkOrder, datagram + datagramSize + sizeof(uint8_t), sizeof(networkOrder));
+                connectionID = ntohl(networkOrder);
+                result = true;
+            }
+        }
+        return result;
+    }
+
     //-------------------------------------------------------------------------------------------------------
     net::Socket::Result FlowCtrlProtocol::SendMissingFragments(const void* chunksData, ProcessOutgoingCallback& onFragmentReadyCB)
     {
@@ -840,6 +1117,7 @@ namespace ssdk::transport_amd
         m_Size(size),
         m_BytesRemaining(size),
         m_LastUpdated(0),
+        m_CreationTime(amf_high_precision_clock()),
         m_ReceivedFrom(receivedFrom),
         m_Buf(nullptr),
         m_ChannelID(channelID)
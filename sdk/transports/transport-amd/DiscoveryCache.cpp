@@ -0,0 +1,137 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "DiscoveryCache.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::transport_amd::DiscoveryCache";
+
+namespace ssdk::transport_amd
+{
+    void DiscoveryCache::SetFileName(const std::string& fileName)
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_FileName = fileName;
+        m_Entries.clear();
+        if (m_FileName.empty() == false)
+        {
+            Load();
+        }
+    }
+
+    DiscoveryCache::Entries DiscoveryCache::GetRecent() const
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_Entries;
+    }
+
+    void DiscoveryCache::Update(const net::Socket::Address& server)
+    {
+        net::Socket::IPv4Address address(server);
+        Entry entry;
+        entry.m_Address = address.GetAddressAsString();
+        entry.m_Port = address.GetPort();
+        entry.m_LastSeen = time(nullptr);
+
+        amf::AMFLock lock(&m_Guard);
+        for (Entries::iterator it = m_Entries.begin(); it != m_Entries.end(); ++it)
+        {
+            if (it->m_Address == entry.m_Address && it->m_Port == entry.m_Port)
+            {
+                m_Entries.erase(it);
+                break;
+            }
+        }
+        m_Entries.insert(m_Entries.begin(), entry);
+        Trim(entry.m_LastSeen);
+        Save();
+    }
+
+    void DiscoveryCache::Load()
+    {
+        std::ifstream file(m_FileName);
+        if (file.is_open() == false)
+        {
+            AMFTraceDebug(AMF_FACILITY, L"Discovery cache %S not found, starting with an empty cache", m_FileName.c_str());
+            return;
+        }
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream fields(line);
+            Entry entry;
+            long long lastSeen = 0;
+            if (fields >> entry.m_Address >> entry.m_Port >> lastSeen)
+            {
+                entry.m_LastSeen = static_cast<time_t>(lastSeen);
+                m_Entries.push_back(entry);
+            }
+        }
+        std::stable_sort(m_Entries.begin(), m_Entries.end(), [](const Entry& a, const Entry& b) { return a.m_LastSeen > b.m_LastSeen; });
+        Trim(time(nullptr));
+        AMFTraceDebug(AMF_FACILITY, L"Loaded %d server(s) from discovery cache %S", (int)m_Entries.size(), m_FileName.c_str());
+    }
+
+    void DiscoveryCache::Save() const
+    {
+        if (m_FileName.empty() == true)
+        {
+            return;
+        }
+        std::ofstream file(m_FileName, std::ios::trunc);
+        if (file.is_open() == false)
+        {
+            AMFTraceWarning(AMF_FACILITY, L"Failed to save discovery cache %S", m_FileName.c_str());
+            return;
+        }
+        for (const Entry& entry : m_Entries)
+        {
+            file << entry.m_Address << ' ' << entry.m_Port << ' ' << static_cast<long long>(entry.m_LastSeen) << '\n';
+        }
+    }
+
+    void DiscoveryCache::Trim(time_t now)
+    {
+        while (m_Entries.empty() == false && (m_Entries.size() > MAX_ENTRIES || now - m_Entries.back().m_LastSeen > MAX_AGE))
+        {
+            m_Entries.pop_back();
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include "net/Socket.h"
+#include "amf/public/common/Thread.h"
+
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace ssdk::transport_amd
+{
+    //----------------------------------------------------------------------------------------------
+    // DiscoveryCache - servers which answered discovery recently. They are probed by unicast in parallel with the broadcast,
+    // which finds them when the broadcast is lost or does not reach their subnet. When a file is specified the cache survives
+    // client restarts, it is a plain text file with one "<ip address> <discovery port> <last seen, seconds since the epoch>" per line.
+    //----------------------------------------------------------------------------------------------
+    class DiscoveryCache
+    {
+    public:
+        static constexpr const size_t MAX_ENTRIES = 16;
+        static constexpr const time_t MAX_AGE = 30 * 24 * 60 * 60;     // Servers not seen for that long are forgotten, in seconds
+
+        struct Entry
+        {
+            std::string                 m_Address;
+            unsigned short              m_Port = 0;
+            time_t                      m_LastSeen = 0;
+        };
+        typedef std::vector<Entry> Entries;
+
+    public:
+        DiscoveryCache() = default;
+
+        void SetFileName(const std::string& fileName);     // Loads the cache from the file, an empty name keeps the cache in memory only
+        Entries GetRecent() const;                          // Most recently seen first
+        void Update(const net::Socket::Address& server);    // Called for every discovery response, saves the cache to the file
+
+    private:
+        void Load();
+        void Save() const;
+        void Trim(time_t now);
+
+    private:
+        mutable amf::AMFCriticalSection m_Guard;
+        std::string                     m_FileName;
+        Entries                         m_Entries;          // Most recently seen first
+    };
+}
@@ -45,16 +45,21 @@ THE SOFTWARE.
 #include "net/Socket.h"
 #include "net/StreamSocket.h"
 #include "transports/transport-amd/Channels.h"
+#include "transports/transport-amd/StreamCapture.h"
 #include "amf/public/common/Thread.h"
 
 #include <map>
 #include <memory>
 #include <stdint.h>
 #include <unordered_set>
+#include <vector>
 
 
 namespace ssdk::transport_amd
 {
+    static constexpr const wchar_t* ID_CONNECTION_MIGRATION = L"ANS_ConnectionMigration";  // bool; the client stamps its datagrams with the connection ID from HELLO
+    static constexpr const char* OPTION_CONNECTION_ID = "ConnectionID";                     // HELLO response option, uint32_t
+
     class FlowCtrlProtocol
     {
     public:
@@ -91,8 +96,43 @@ namespace ssdk::transport_amd
             uint32_t            m_FragmentSize;     //  Size of the current fragment
             uint8_t             m_ChannelID;        //  Channel ID (CHANNEL_AUDIO_OUT, CHANNEL_VIDEO_OUT, ...)
         };
+
+        //  Path MTU probes and their acknowledgements are single-fragment messages on the SYSTEM channel,
+        //  the magic is never a valid start of a missing fragments request
+        enum class PathMtuProbeType : uint8_t
+        {
+            PROBE = 1,
+            ACK = 2
+        };
+        struct PathMtuProbeHeader
+        {
+            uint8_t             m_Magic[4];         //  'P', 'M', 'T', 'U'
+            uint8_t             m_Type;             //  PathMtuProbeType
+            uint32_t            m_ProbeSize;        //  Size of the probe datagram including the fragment header
+        };
+
+        //  Before a connection is migrated to a new client address the server sends a challenge there, which the client echoes back.
+        //  Same framing as the path MTU probes
+        enum class PathValidationType : uint8_t
+        {
+            CHALLENGE = 1,
+            RESPONSE = 2
+        };
+        struct PathValidationHeader
+        {
+            uint8_t             m_Magic[4];         //  'P', 'A', 'T', 'H'
+            uint8_t             m_Type;             //  PathValidationType
+            uint64_t            m_Token;            //  Random, echoed as is
+        };
 #pragma pack(pop)
 
+        //  Datagrams of a client which received a connection ID in the HELLO response carry STAMPED_CHANNEL_ID in the channel ID,
+        //  followed at the end of the datagram by the original channel ID and the connection ID in network byte order,
+        //  so that the server finds the session when the client address changes
+        typedef uint32_t ConnectionID;
+        static constexpr const uint8_t STAMPED_CHANNEL_ID = 254;     //  Never used by a channel, see Channel::SYSTEM
+        static constexpr const size_t CONNECTION_ID_TRAILER_SIZE = sizeof(uint8_t) + sizeof(ConnectionID);
+
     public:
 //        static std::unique_ptr<FlowCtrlProtocol> FlowCtrlProtocolFactory(uint32_t version = 1);
         uint32_t MaxSupportedVersion(uint32_t minLocal, uint32_t maxLocal, uint32_t minRemote, uint32_t maxRemote) const noexcept;
@@ -103,6 +143,11 @@ namespace ssdk::transport_amd
         virtual ~FlowCtrlProtocol() noexcept;
         inline void     EnableProfile(bool bEnable) { m_bEnableProfile = bEnable; }
         inline bool     GetEnableProfile() const { return m_bEnableProfile; }
+        inline void     SetRecorder(StreamRecorder::Ptr recorder) { m_Recorder = recorder; }     // Set before any traffic, records every fragment received and sent
+        //  Complete messages on the channel starting with the opcode are delivered without waiting out a gap before them,
+        //  all other messages on the channel stay in order and are not overtaken. NO_REORDERING (default) keeps the channel in order
+        static constexpr const int16_t NO_REORDERING = -1;
+        void SetReorderableOpCode(uint8_t channelID, int16_t opCode);
         uint32_t GetVersion() { return m_version; };
         void UpgradeProtocol(uint32_t upgradeVersion);
 
@@ -140,6 +185,18 @@ namespace ssdk::transport_amd
             bool                m_Allocated = false;
         };
 
+        //  Creates a probe padded to datagramSize bytes, or an acknowledgement of a probe of probeSize bytes when datagramSize is 0
+        static Fragment CreatePathMtuProbe(MessageID probeID, PathMtuProbeType type, uint32_t probeSize, size_t datagramSize = 0);
+        static bool ParsePathMtuProbe(const Fragment& fragment, PathMtuProbeType& type, uint32_t& probeSize);
+
+        static Fragment CreatePathValidation(PathValidationType type, uint64_t token);
+        static bool ParsePathValidation(const Fragment& fragment, PathValidationType& type, uint64_t& token);
+
+        //  Copies the datagram to stamped with the connection ID appended, returns the size of the stamped datagram
+        static size_t StampConnectionID(const void* datagram, size_t datagramSize, ConnectionID connectionID, std::vector<uint8_t>& stamped);
+        //  Removes the connection ID from a stamped datagram in place, returns false if the datagram is not stamped
+        static bool StripConnectionID(uint8_t* datagram, size_t& datagramSize, ConnectionID& connectionID);
+
         class ProcessIncomingCallback;
         class Buffer
         {
@@ -161,6 +218,7 @@ namespace ssdk::transport_amd
             inline const unsigned char* GetData()const { return m_Buf; }
             inline size_t               GetSize() const { return m_Size; }
             inline amf_pts              GetLastUpdateTime() const { return m_LastUpdated; }
+            inline amf_pts              GetCreationTime() const { return m_CreationTime; }      //  Arrival of the first fragment
             inline size_t               GetBytesRemaining() const { return m_BytesRemaining; }
             inline uint8_t              GetChannelID() const { return m_ChannelID; }
             inline void                 UpdateTime(amf_pts pts) { m_LastUpdated = pts; }
@@ -181,6 +239,7 @@ namespace ssdk::transport_amd
             size_t                              m_Size = 0;
             size_t                              m_BytesRemaining = 0;
             amf_pts                             m_LastUpdated = 0;
+            amf_pts                             m_CreationTime = 0;
             ssdk::net::Socket::Address          m_ReceivedFrom;
             uint8_t                             m_ChannelID = 0;
             BufferChunks                        m_BufferChunks; // contains buffer offsets and sizes
@@ -228,6 +287,7 @@ namespace ssdk::transport_amd
         public:
             virtual void OnCompleteMessage(MessageID msgID, const void* buf, size_t size, const ssdk::net::Socket::Address& receivedFrom, uint8_t optional) = 0;
             virtual ssdk::net::Socket::Result OnRequestFragment(const Fragment& fragment) = 0;
+            virtual void OnPathMtuProbeAck(MessageID /*probeID*/, uint32_t /*probeSize*/) {}
         };
         class ProcessOutgoingCallback
         {
@@ -307,13 +367,18 @@ namespace ssdk::transport_amd
         void RequestMissingChunks(uint8_t channelID, MessageID currMessageID, ProcessIncomingCallback& processIncomingCallback);
         bool RequestMissingMessages(uint8_t channelID, MessageID currMessageID, bool bMessageComplete, ProcessIncomingCallback& incomingCallback);
         bool WaitingForRequestedMessages(uint8_t channelID) const;
+        bool IsReorderable(uint8_t channelID, const Buffer::Ptr& message) const;
+        void SkipDeliveredAhead(uint8_t channelID);
         Result ProcessMissingFragmentsRequest(const Fragment& fragment, ProcessOutgoingCallback* outgoingCallback);
+        Result ProcessPathMtuProbe(const Fragment& fragment, PathMtuProbeType type, uint32_t probeSize, ProcessIncomingCallback& incomingCallback);
         ssdk::net::Socket::Result SendMissingFragments(const void* chunksData, ProcessOutgoingCallback& onFragmentReadyCB);
+        void Record(StreamCapture::Direction direction, const Fragment& fragment);
 
         static const amf_pts msgFlushTimeoutInPts = 150 * AMF_MILLISECOND;
         typedef std::map<MessageID, Buffer::Ptr> MessageMap;
         typedef std::list<MessageMap::iterator> MessageMapIts;
         typedef std::map<MessageID, bool> MessageMarksMap;
+        typedef std::map<MessageID, amf_pts> MessageTimesMap;
 
         // Array of channel ids.
         // Channel 0 is used for common stream
@@ -329,6 +394,8 @@ namespace ssdk::transport_amd
         MessageMap  m_OutgoingMessages[static_cast<size_t>(Channel::CHANNELS_COUNT)];        // This will be used to resend a lost message when receiver requests.
         MessageMapIts m_OutgoingMessagesIts[static_cast<size_t>(Channel::CHANNELS_COUNT)];   // This is used for keeping correct sequesnce of sent messages
         MessageMarksMap  m_RequestedMissingID[static_cast<size_t>(Channel::CHANNELS_COUNT)]; // Used for tracking requested messages and avoid requesting more than once
+        MessageTimesMap  m_DeliveredAhead[static_cast<size_t>(Channel::CHANNELS_COUNT)];     // Reorderable messages delivered past a gap, skipped once the gap is closed
+        int16_t     m_ReorderableOpCode[static_cast<size_t>(Channel::CHANNELS_COUNT)];
         bool                    m_bEnableProfile = false;
         uint32_t                m_version = 0;
         amf::AMFCriticalSection m_outgoingCs;
@@ -338,6 +405,7 @@ namespace ssdk::transport_amd
         size_t                  m_MaxFragmentSize;
         BufferFragment          m_FragmentBuffer;
         MessageMonitor          m_MessageMonitor;
+        StreamRecorder::Ptr     m_Recorder;
     };
 
 
@@ -0,0 +1,172 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include "TransportServerImpl.h"
+#include "ServerSessionImpl.h"
+#include "LocalServerSessionImpl.h"
+#include "LocalTransport.h"
+#include "Misc.h"
+#include "amf/public/common/TraceAdapter.h"
+#include "transports/transport-amd/ServerTransportImpl.h"
+#include "net/UnixStreamSocket.h"
+
+#if defined(__linux)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::transport_amd::ServerImpl";
+
+static constexpr const time_t DISCONNECT_TIMEOUT = 5;
+static constexpr const size_t MAX_CONCURRENT_CONNECTIONS = 10;
+
+#if defined(__linux)
+namespace ssdk::transport_amd
+{
+    ServerImpl::LocalServer::LocalServer(const std::string& path, size_t maxFragmentSize, ServerImpl& server) :
+        net::StreamServer(new net::UnixStreamSocket, maxFragmentSize, MAX_CONCURRENT_CONNECTIONS, DISCONNECT_TIMEOUT),
+        m_Server(server),
+        m_Path(path)
+    {
+    }
+
+    ServerImpl::LocalServer::~LocalServer()
+    {
+        StopServer();
+    }
+
+    net::Session::Ptr ServerImpl::LocalServer::OnCreateSession(const net::Socket::Address& peer, net::Socket* socket, uint8_t* /*buf*/, size_t /*bufSize*/)
+    {
+        //  Unix domain clients are normally unnamed, the path the server listens on is more useful in the logs
+        net::Url url;
+        url.SetProtocol(net::Url::PROTOCOL_LOCAL);
+        url.SetHost(m_Path);
+
+        LocalServerSessionImpl* localSession = new amf::AMFInterfaceMultiImpl<LocalServerSessionImpl, net::Session, ServerImpl*, net::StreamSocket::Ptr, const net::Socket::Address&>(&m_Server, net::StreamSocket::Ptr(socket), peer);
+        net::Session::Ptr session(localSession);
+        localSession->SetPeerAddress(url.GetUrl());
+
+        if (localSession->ShareRing() != net::Socket::Result::OK)
+        {
+            session = nullptr;
+            AMFTraceError(AMF_FACILITY, L"LocalServer::OnCreateSession: failed to share the ring with the client");
+        }
+        else if (m_Server.m_pConnectCallback->OnClientConnected(localSession) != transport_common::Result::OK)
+        {
+            session = nullptr;
+            AMFTraceError(AMF_FACILITY, L"LocalServer::OnCreateSession: failed to create a local session");
+        }
+        else
+        {
+            if (m_Server.m_pServerTransport != nullptr)
+            {
+                m_Server.m_pServerTransport->NewClientSessionCreated(localSession);
+            }
+            AMFTraceInfo(AMF_FACILITY, L"LocalServer::OnCreateSession: local session created on %S", m_Path.c_str());
+        }
+        return session;
+    }
+
+    void ServerImpl::LocalServer::Run()
+    {
+        RunServer();
+    }
+
+    transport_common::Result ServerImpl::LocalServer::StartServer()
+    {
+        transport_common::Result result = transport_common::Result::FAIL;
+        net::StreamSocket::Ptr socket(GetSocket());
+
+        if (socket->Bind(GetLocalSocketAddress(m_Path)) != net::Socket::Result::OK)
+        {
+            SetSocket(nullptr);
+            result = transport_common::Result::PORT_BUSY;
+        }
+        else if (m_Path.empty() == false && m_Path[0] == '/' && chmod(m_Path.c_str(), S_IRUSR | S_IWUSR) != 0)
+        {   //  Before listen(), so nobody else gets to connect in between
+            AMFTraceError(AMF_FACILITY, L"LocalServer::StartServer: failed to restrict access to %S", m_Path.c_str());
+            SetSocket(nullptr);
+            unlink(m_Path.c_str());
+        }
+        else if (socket->Listen() != net::Socket::Result::OK)
+        {
+            SetSocket(nullptr);
+            result = transport_common::Result::PORT_BUSY;
+        }
+        else
+        {
+            Start();
+            result = transport_common::Result::OK;
+        }
+        return result;
+    }
+
+    transport_common::Result ServerImpl::LocalServer::StopServer()
+    {
+        transport_common::Result result = transport_common::Result::OK;
+        {
+            amf::AMFLock    lock(&m_CritSect);
+            if (IsServerRunning() != true)
+            {
+                result = transport_common::Result::NOT_RUNNING;
+            }
+        }
+        if (result == transport_common::Result::OK)
+        {
+            ShutdownServer();
+            net::StreamSocket::Ptr socket(GetSocket());
+
+            if (socket != nullptr)
+            {
+                socket->Close();
+            }
+            RequestStop();
+            WaitForStop();
+            SetSocket(nullptr);
+            if (m_Path.empty() == false && m_Path[0] == '/')
+            {
+                unlink(m_Path.c_str());
+            }
+        }
+        return result;
+    }
+}
+#endif
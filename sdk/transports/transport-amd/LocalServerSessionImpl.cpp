@@ -0,0 +1,115 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "LocalServerSessionImpl.h"
+#include "net/UnixStreamSocket.h"
+
+#include "public/common/TraceAdapter.h"
+
+#if defined(__linux)
+#include <unistd.h>
+#endif
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::transport_amd::LocalServerSessionImpl";
+
+#if defined(__linux)
+namespace ssdk::transport_amd
+{
+    LocalServerSessionImpl::LocalServerSessionImpl(ServerImpl* server, net::StreamSocket* sock, const net::Socket::Address& peer) :
+        TCPServerSessionImpl(server, sock, peer)
+    {
+    }
+
+    LocalServerSessionImpl::~LocalServerSessionImpl()
+    {
+        if (m_InlineSends > 0)
+        {
+            AMFTraceInfo(AMF_FACILITY, L"%llu bulk messages were sent inline because the ring was full", static_cast<unsigned long long>(m_InlineSends));
+        }
+    }
+
+    net::Socket::Result LocalServerSessionImpl::ShareRing()
+    {
+        net::Socket::Result result = net::Socket::Result::NO_BUFFER_SPACE;
+        net::UnixStreamSocket::Ptr socket(GetSocket());
+        uid_t peerUid = 0;
+        if (socket == nullptr)
+        {
+            result = net::Socket::Result::SOCKET_TYPE_NOT_SUPPORTED;
+        }
+        else if ((result = socket->GetPeerUid(&peerUid)) != net::Socket::Result::OK)
+        {
+            AMFTraceError(AMF_FACILITY, L"ShareRing(): failed to identify the client, %s", net::Socket::GetErrorString(result));
+        }
+        else if (peerUid != geteuid() && peerUid != 0)
+        {   //  Ring payloads are not encrypted, only the user the server runs as may read them
+            result = net::Socket::Result::ACCESS_DENIED;
+            AMFTraceError(AMF_FACILITY, L"ShareRing(): rejected a client running as uid %u, the server runs as %u", unsigned(peerUid), unsigned(geteuid()));
+        }
+        else if (m_Ring.Create(LOCAL_RING_SIZE) != net::SharedMemoryRing::Result::OK)
+        {
+            result = net::Socket::Result::NO_BUFFER_SPACE;
+            AMFTraceError(AMF_FACILITY, L"ShareRing(): failed to create a %zu byte ring", LOCAL_RING_SIZE);
+        }
+        else if ((result = socket->SendFd(m_Ring.GetHandle())) != net::Socket::Result::OK)
+        {
+            AMFTraceError(AMF_FACILITY, L"ShareRing(): failed to pass the ring to the client, %s", net::Socket::GetErrorString(result));
+        }
+        return result;
+    }
+
+    bool LocalServerSessionImpl::SendClearText(Channel channel, const void* msg, size_t msgLen, transport_common::Result* result)
+    {
+        if ((channel != Channel::VIDEO_OUT && channel != Channel::AUDIO_OUT) || msgLen < LOCAL_RING_MIN_MESSAGE_SIZE || result == nullptr)
+        {
+            return false;
+        }
+        //  The ring must be filled in the same order the references to it are sent, hence the lock around both
+        amf::AMFLock lock(&m_SendCS);
+        uint64_t position = 0;
+        if (m_Ring.Write(msg, msgLen, &position) != net::SharedMemoryRing::Result::OK)
+        {   //  Sent inline and encrypted like any other message
+            if (m_InlineSends++ == 0)
+            {
+                AMFTraceWarning(AMF_FACILITY, L"SendClearText(): the ring is full, falling back to sending %zu bytes over the socket", msgLen);
+            }
+            return false;
+        }
+        LocalRingMessage ringMsg = { static_cast<uint8_t>(channel), position, static_cast<uint32_t>(msgLen) };
+        *result = TCPServerSessionImpl::Send(Channel::SYSTEM, &ringMsg, sizeof(ringMsg));
+        return true;
+    }
+}
+#endif
@@ -0,0 +1,70 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+#pragma once
+
+#include "Channels.h"
+#include "net/Socket.h"
+
+#include <string>
+
+#if defined(__linux)
+namespace ssdk::transport_amd
+{
+    //  Local transport: same-host clients connect with a local://<name> URL to a Unix domain socket the server listens on.
+    //  The socket carries the usual stream-framed messages, but VIDEO_OUT and AUDIO_OUT payloads are written into a shared
+    //  memory ring (net::SharedMemoryRing) passed to the client right after accept(), and the socket only carries
+    //  a LocalRingMessage on Channel::SYSTEM pointing at them. There is no fragmentation, and the client consumes
+    //  the payloads in place. Ring payloads never leave the host and are not encrypted, everything sent over the socket
+    //  still is. Only clients running as the same user as the server (or root) are given the ring, a socket in the
+    //  filesystem is also created accessible to its owner only.
+    static constexpr const size_t LOCAL_RING_SIZE = 32 * 1024 * 1024;      //  Per session, enough for several 4K IDR frames
+    static constexpr const size_t LOCAL_RING_MIN_MESSAGE_SIZE = 1024;      //  Smaller messages are cheaper to send inline
+
+#pragma pack(push, 1)
+    struct LocalRingMessage
+    {
+        uint8_t     m_Channel;      //  Channel of the referenced message
+        uint64_t    m_Position;     //  Position in the ring as returned by net::SharedMemoryRing::Write()
+        uint32_t    m_Size;
+    };
+#pragma pack(pop)
+
+    //  Names not starting with '/' are placed in the abstract namespace, so no file is left behind
+    inline net::Socket::UnixDomainAddress GetLocalSocketAddress(const std::string& name)
+    {
+        return net::Socket::UnixDomainAddress(name.empty() == false && name[0] == '/' ? name : ':' + name);
+    }
+}
+#endif
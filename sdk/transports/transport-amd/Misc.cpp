@@ -39,3 +39,28 @@ const uint16_t DEFAULT_PORT = 1235;
 
 const int SOCKET_BUF_SIZE_SND = (5 * 1024 * 1024);
 const int SOCKET_BUF_SIZE_RCV = (5 * 1024 * 1024);
+
+namespace ssdk::transport_amd
+{
+    net::Socket::TrafficClass GetChannelTrafficClass(uint8_t channelID)
+    {
+        net::Socket::TrafficClass trafficClass = net::Socket::TrafficClass::BEST_EFFORT;
+        switch (static_cast<Channel>(channelID))
+        {
+        case Channel::VIDEO_OUT:
+        case Channel::VIDEO_IN:
+            trafficClass = net::Socket::TrafficClass::VIDEO;
+            break;
+        case Channel::AUDIO_OUT:
+        case Channel::AUDIO_IN:
+        case Channel::SENSORS_IN:
+        case Channel::SENSORS_OUT:
+        case Channel::CONTROLLER_IN:
+            trafficClass = net::Socket::TrafficClass::INTERACTIVE;
+            break;
+        default:
+            break;
+        }
+        return trafficClass;
+    }
+}
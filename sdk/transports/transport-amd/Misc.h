@@ -35,6 +35,9 @@ THE SOFTWARE.
 
 #pragma once
 
+#include "Channels.h"
+#include "net/Socket.h"
+
 #include <cstdint>
 
 //#define SOCKET_BUF_SIZE (5 * 1024 * 1024)		//	Internal buffers to send/receive 1 sec of video at 50Mbps
@@ -47,4 +50,8 @@ extern const uint16_t DEFAULT_PORT;
 
 //#define SOCKET_BUF_SIZE (100 * 1024)		//	Internal buffers to send/receive 1 sec of video at 50Mbps
 
-
+namespace ssdk::transport_amd
+{
+    //  DiffServ class the datagrams of a channel are marked with: AF41 for video, EF for audio and input, best effort for the rest
+    net::Socket::TrafficClass GetChannelTrafficClass(uint8_t channelID);
+}
@@ -0,0 +1,223 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "PathMtuDiscovery.h"
+
+namespace ssdk::transport_amd
+{
+    void PathMtuDiscovery::Start(size_t maxPlpmtu, amf_pts now)
+    {
+        m_MaxPlpmtu = maxPlpmtu < BASE_PLPMTU ? BASE_PLPMTU : (maxPlpmtu > MAX_PLPMTU ? MAX_PLPMTU : maxPlpmtu);
+        m_Plpmtu = BASE_PLPMTU;
+        m_State = State::BASE;
+        ResetProbe(BASE_PLPMTU);
+        m_NextSearchTime = now;
+    }
+
+    void PathMtuDiscovery::Stop()
+    {
+        m_State = State::DISABLED;
+        m_Plpmtu = BASE_PLPMTU;
+        m_ProbeOutstanding = false;
+    }
+
+    bool PathMtuDiscovery::GetNextProbe(amf_pts now, size_t& probeSize, FlowCtrlProtocol::MessageID& probeID)
+    {
+        switch (m_State)
+        {
+        case State::DISABLED:
+            return false;
+        case State::SEARCH_COMPLETE:
+            if (now < m_NextSearchTime)
+            {
+                return false;
+            }
+            StartSearch(now);
+            break;
+        case State::BASE_ERROR:
+            if (now < m_NextSearchTime)
+            {
+                return false;
+            }
+            m_State = State::BASE;
+            ResetProbe(BASE_PLPMTU);
+            break;
+        default:
+            break;
+        }
+
+        if (m_ProbeOutstanding == true)
+        {
+            if (now < m_ProbeDeadline)
+            {
+                return false;
+            }
+            m_ProbeOutstanding = false;
+            if (m_ProbeCount >= MAX_PROBES)
+            {
+                ProbeFailed(now);
+                if (m_State != State::BASE && m_State != State::SEARCHING)
+                {
+                    return false;
+                }
+            }
+        }
+
+        ++m_ProbeCount;
+        m_ProbeOutstanding = true;
+        m_ProbeDeadline = now + PROBE_TIMEOUT;
+        probeSize = m_ProbeSize;
+        probeID = ++m_ProbeID;
+        return true;
+    }
+
+    amf_pts PathMtuDiscovery::GetNextProbeTime() const noexcept
+    {
+        amf_pts result = 0;
+        switch (m_State)
+        {
+        case State::DISABLED:
+            result = NO_PROBE;
+            break;
+        case State::SEARCH_COMPLETE:
+        case State::BASE_ERROR:
+            result = m_NextSearchTime;
+            break;
+        default:
+            result = m_ProbeOutstanding == true ? m_ProbeDeadline : 0;
+            break;
+        }
+        return result;
+    }
+
+    bool PathMtuDiscovery::OnProbeAcknowledged(FlowCtrlProtocol::MessageID probeID, size_t probeSize, amf_pts now)
+    {
+        //  Only the most recent probe counts, acknowledgements of earlier probes of the same size are fine too
+        if (m_ProbeOutstanding == false || probeSize != m_ProbeSize || (m_State != State::BASE && m_State != State::SEARCHING) ||
+            static_cast<FlowCtrlProtocol::MessageID>(m_ProbeID - probeID) >= MAX_PROBES)
+        {
+            return false;
+        }
+        m_ProbeOutstanding = false;
+
+        size_t prevPlpmtu = m_Plpmtu;
+        m_Plpmtu = probeSize;
+        if (m_State == State::BASE)
+        {
+            StartSearch(now);
+        }
+        else
+        {
+            m_SearchLow = probeSize;
+            SelectNextProbeSize(now);
+        }
+        return m_Plpmtu != prevPlpmtu;
+    }
+
+    bool PathMtuDiscovery::OnPacketTooBig(size_t probeSize, amf_pts now)
+    {
+        if (m_ProbeOutstanding == false || probeSize != m_ProbeSize)
+        {
+            return false;
+        }
+        m_ProbeOutstanding = false;
+
+        size_t prevPlpmtu = m_Plpmtu;
+        ProbeFailed(now);
+        return m_Plpmtu != prevPlpmtu;
+    }
+
+    bool PathMtuDiscovery::OnBlackHoleSuspected(amf_pts now)
+    {
+        if (m_Plpmtu <= BASE_PLPMTU || (m_State != State::SEARCHING && m_State != State::SEARCH_COMPLETE))
+        {
+            return false;
+        }
+        m_Plpmtu = BASE_PLPMTU;
+        m_State = State::BASE;
+        ResetProbe(BASE_PLPMTU);
+        m_NextSearchTime = now;
+        return true;
+    }
+
+    void PathMtuDiscovery::StartSearch(amf_pts now)
+    {
+        m_State = State::SEARCHING;
+        m_SearchLow = m_Plpmtu;
+        m_SearchHigh = m_MaxPlpmtu;
+        m_EthernetProbed = false;
+        SelectNextProbeSize(now);
+    }
+
+    void PathMtuDiscovery::ProbeFailed(amf_pts now)
+    {
+        if (m_State == State::BASE)
+        {   //  Even the base did not get through, fall back to the minimum and keep retrying
+            m_State = State::BASE_ERROR;
+            m_Plpmtu = MIN_PLPMTU;
+            m_NextSearchTime = now + BASE_RETRY_INTERVAL;
+        }
+        else if (m_State == State::SEARCHING)
+        {
+            m_SearchHigh = m_ProbeSize - 1;
+            SelectNextProbeSize(now);
+        }
+    }
+
+    void PathMtuDiscovery::SelectNextProbeSize(amf_pts now)
+    {
+        if (m_EthernetProbed == false && m_SearchLow < ETHERNET_PLPMTU && ETHERNET_PLPMTU <= m_SearchHigh)
+        {   //  Most paths are plain Ethernet, try it before bisecting
+            m_EthernetProbed = true;
+            ResetProbe(ETHERNET_PLPMTU);
+        }
+        else if (m_SearchHigh < m_SearchLow + SEARCH_GRANULARITY)
+        {
+            m_State = State::SEARCH_COMPLETE;
+            m_NextSearchTime = now + PMTU_RAISE_INTERVAL;
+        }
+        else
+        {
+            ResetProbe(m_SearchLow + (m_SearchHigh - m_SearchLow + 1) / 2);
+        }
+    }
+
+    void PathMtuDiscovery::ResetProbe(size_t probeSize)
+    {
+        m_ProbeSize = probeSize;
+        m_ProbeCount = 0;
+        m_ProbeOutstanding = false;
+    }
+}
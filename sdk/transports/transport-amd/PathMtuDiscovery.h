@@ -0,0 +1,125 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include "FlowCtrlProtocol.h"
+#include "amf/public/include/core/Platform.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+namespace ssdk::transport_amd
+{
+    // HELLO option advertised by clients which acknowledge path MTU probes. A server which does not find this option
+    // in the session properties never probes and keeps the session at the base PLPMTU when path MTU discovery is enabled
+    static constexpr const wchar_t* ID_PATH_MTU_PROBING = L"ANS_PathMtuProbing";   // bool
+
+    //----------------------------------------------------------------------------------------------
+    // PathMtuDiscovery - datagram packetization layer path MTU discovery (DPLPMTUD, RFC 8899) state machine.
+    // All sizes are UDP payload sizes, i.e. the largest datagram the flow control protocol is allowed to send including its fragment header.
+    // The class does not send anything itself: the owner asks for the next probe with GetNextProbe(), sends it and reports back
+    // acknowledgements and failures. Time is passed in explicitly so that the state machine can be driven without a network.
+    // Not thread-safe, the owner is responsible for locking.
+    //----------------------------------------------------------------------------------------------
+    class PathMtuDiscovery
+    {
+    public:
+        enum class State
+        {
+            DISABLED,           //  Not started, the PLPMTU is BASE_PLPMTU
+            BASE,               //  Confirming that BASE_PLPMTU gets through
+            SEARCHING,          //  Probing for a larger PLPMTU
+            SEARCH_COMPLETE,    //  PLPMTU found, a new search is started after PMTU_RAISE_INTERVAL
+            BASE_ERROR          //  BASE_PLPMTU could not be confirmed, PLPMTU is MIN_PLPMTU until the base is confirmed again
+        };
+
+        static constexpr const size_t MIN_PLPMTU = FlowCtrlProtocol::UDP_MSS_SIZE;                                  //  Guaranteed by IPv4, never probed
+        static constexpr const size_t BASE_PLPMTU = size_t(1200);                                                   //  RFC 8899 section 5.1.2
+        static constexpr const size_t ETHERNET_PLPMTU = FlowCtrlProtocol::UDP_MAX_MSS_SIZE_WITH_NO_FRAGMENTATION;  //  Probed first as the most likely outcome
+        static constexpr const size_t MAX_PLPMTU = size_t(9000 - 28);                                               //  Jumbo frame minus IPv4 and UDP headers
+        static constexpr const size_t SEARCH_GRANULARITY = size_t(16);                                              //  Stop the binary search when the range is narrower than this
+        static constexpr const uint32_t MAX_PROBES = 3;                                                             //  Probes of the same size sent before the size is considered failed
+        static constexpr const amf_pts PROBE_TIMEOUT = 250 * AMF_MILLISECOND;
+        static constexpr const amf_pts BASE_RETRY_INTERVAL = 10 * AMF_SECOND;
+        static constexpr const amf_pts PMTU_RAISE_INTERVAL = 600 * AMF_SECOND;                                     //  RFC 8899 PMTU_RAISE_TIMER
+        static constexpr const amf_pts NO_PROBE = std::numeric_limits<amf_pts>::max();
+
+    public:
+        PathMtuDiscovery() = default;
+
+        void Start(size_t maxPlpmtu, amf_pts now);          //  Start with confirming BASE_PLPMTU, the search never goes above maxPlpmtu
+        void Stop();
+
+        //  Returns true when a probe of probeSize bytes has to be sent now. Handles probe timeouts, so it has to be called periodically
+        bool GetNextProbe(amf_pts now, size_t& probeSize, FlowCtrlProtocol::MessageID& probeID);
+        amf_pts GetNextProbeTime() const noexcept;          //  GetNextProbe() has nothing to do before this time, NO_PROBE while disabled
+
+        //  The following return true when the PLPMTU has changed and the new value should be applied
+        bool OnProbeAcknowledged(FlowCtrlProtocol::MessageID probeID, size_t probeSize, amf_pts now);
+        bool OnPacketTooBig(size_t probeSize, amf_pts now); //  A probe could not be sent because it is larger than the local interface MTU
+        bool OnBlackHoleSuspected(amf_pts now);             //  Datagrams of the current PLPMTU appear to be lost, restart from the base
+
+        inline State    GetState() const noexcept { return m_State; }
+        inline size_t   GetPlpmtu() const noexcept { return m_Plpmtu; }
+        inline bool     IsActive() const noexcept { return m_State != State::DISABLED; }
+
+    private:
+        void StartSearch(amf_pts now);
+        void ProbeFailed(amf_pts now);
+        void SelectNextProbeSize(amf_pts now);
+        void ResetProbe(size_t probeSize);
+
+        State                       m_State = State::DISABLED;
+        size_t                      m_Plpmtu = BASE_PLPMTU;
+        size_t                      m_MaxPlpmtu = BASE_PLPMTU;
+        size_t                      m_SearchLow = BASE_PLPMTU;      //  Largest confirmed size
+        size_t                      m_SearchHigh = BASE_PLPMTU;     //  Largest size not known to fail
+        bool                        m_EthernetProbed = false;
+        size_t                      m_ProbeSize = BASE_PLPMTU;
+        uint32_t                    m_ProbeCount = 0;
+        bool                        m_ProbeOutstanding = false;
+        FlowCtrlProtocol::MessageID m_ProbeID = 0;
+        amf_pts                     m_ProbeDeadline = 0;
+        amf_pts                     m_NextSearchTime = 0;
+    };
+}
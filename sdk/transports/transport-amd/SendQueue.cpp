@@ -0,0 +1,344 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "SendQueue.h"
+
+#include <algorithm>
+#include <vector>
+
+static constexpr const amf_pts IDLE_WAIT = 100 * AMF_MILLISECOND;
+static constexpr const amf_pts PACING_BURST = 20 * AMF_MILLISECOND;    //  Video sent back to back after the queue has been idle
+
+namespace ssdk::transport_amd
+{
+    SendQueue::SendQueue(Sender& sender, size_t maxDepth, amf_pts maxAge) :
+        m_Sender(sender),
+        m_MaxDepth(maxDepth),
+        m_MaxAge(maxAge),
+        m_SenderThread(*this)
+    {
+    }
+
+    SendQueue::~SendQueue()
+    {
+        Stop();
+    }
+
+    void SendQueue::Start()
+    {
+        m_SenderThread.Start();
+    }
+
+    void SendQueue::Stop()
+    {
+        m_SenderThread.RequestStop();
+        m_PendingEvent.SetEvent();
+        m_SenderThread.WaitForStop();
+
+        amf::AMFLock lock(&m_Guard);
+        m_Queue.clear();
+    }
+
+    bool SendQueue::Push(Channel channel, const void* msg, size_t msgLen, MessageClass messageClass, amf_pts frameID)
+    {
+        return Push(channel, ssdk::util::BufferPool::GetInstance().Acquire(msg, msgLen), messageClass, frameID);
+    }
+
+    bool SendQueue::Push(Channel channel, const ssdk::util::BufferPool::Lease& msg, MessageClass messageClass, amf_pts frameID)
+    {
+        bool queued = true;
+        {
+            amf::AMFLock lock(&m_Guard);
+            amf_pts now = amf_high_precision_clock();
+            bool video = messageClass == MessageClass::VIDEO_KEY || messageClass == MessageClass::VIDEO_REFERENCE || messageClass == MessageClass::VIDEO_NON_REFERENCE;
+            bool newFrame = video == true && (frameID == NO_FRAME || frameID != m_PushFrameID);
+            if (newFrame == true)
+            {
+                m_PushFrameID = frameID;
+                m_PushFrameDropped = false;
+            }
+            //  Decisions which concern a whole frame are made on its first slice
+            DropStale(now, newFrame == true ? messageClass : MessageClass::CONTROL);
+            if (newFrame == true && messageClass == MessageClass::VIDEO_KEY)
+            {
+                m_WaitForKeyFrame = false;
+            }
+            while (m_Queue.size() >= m_MaxDepth && MakeRoom() == true)
+            {
+            }
+
+            if (video == true && frameID != NO_FRAME && frameID == m_PushFrameID && m_PushFrameDropped == true)
+            {   //  The rest of a frame which has been dropped, already counted
+                queued = false;
+            }
+            else if (newFrame == true && m_WaitForKeyFrame == true && messageClass != MessageClass::VIDEO_KEY)
+            {   //  Depends on a frame which has been dropped, useless until the next key frame
+                ++m_Stats.droppedVideo;
+                m_PushFrameDropped = true;
+                queued = false;
+            }
+            else
+            {
+                QueuedMessage message;
+                message.m_Channel = channel;
+                message.m_Class = messageClass;
+                message.m_QueuedTime = now;
+                message.m_TraceKey = ssdk::util::PipelineTrace::GetKey();
+                message.m_FrameID = frameID;
+                message.m_Data = msg;
+                m_Queue.push_back(std::move(message));
+            }
+        }
+        if (queued == true)
+        {
+            m_PendingEvent.SetEvent();
+        }
+        return queued;
+    }
+
+    bool SendQueue::TakeKeyFrameRequest()
+    {
+        amf::AMFLock lock(&m_Guard);
+        bool requested = m_KeyFrameRequested;
+        m_KeyFrameRequested = false;
+        return requested;
+    }
+
+    void SendQueue::SetPacingBitrate(int64_t bitrate)
+    {
+        {
+            amf::AMFLock lock(&m_Guard);
+            if (bitrate != m_PacingBitrate)
+            {
+                m_PacingBitrate = std::max(bitrate, int64_t(0));
+                m_PacingBudget = std::min(m_PacingBudget, int64_t(0));
+                m_PacingTime = amf_high_precision_clock();
+            }
+        }
+        m_PendingEvent.SetEvent();
+    }
+
+    SendQueue::Stats SendQueue::GetStats(bool reset)
+    {
+        amf::AMFLock lock(&m_Guard);
+        Stats stats = m_Stats;
+        stats.depth = m_Queue.size();
+        if (reset == true)
+        {
+            m_Stats = Stats();
+        }
+        return stats;
+    }
+
+    bool SendQueue::Pop(QueuedMessage& message, amf_pts& wait)
+    {
+        amf::AMFLock lock(&m_Guard);
+        bool result = false;
+        wait = 0;
+        if (m_PacingBitrate != 0)
+        {   //  Refill the token bucket, the clock only moves on once a whole bit has been earned so that frequent calls lose nothing
+            amf_pts now = amf_high_precision_clock();
+            int64_t earned = m_PacingBitrate * int64_t(std::min(now - m_PacingTime, amf_pts(AMF_SECOND))) / int64_t(AMF_SECOND);
+            if (earned > 0)
+            {
+                int64_t burst = m_PacingBitrate * int64_t(PACING_BURST) / int64_t(AMF_SECOND);
+                m_PacingBudget = std::min(m_PacingBudget + earned, burst);
+                m_PacingTime = now;
+            }
+        }
+        Queue::iterator next = m_Queue.begin();
+        if (m_PacingBitrate != 0 && m_PacingBudget < 0)
+        {   //  Video waits for the budget, other messages overtake it
+            next = std::find_if(m_Queue.begin(), m_Queue.end(), [](const QueuedMessage& queued) { return queued.IsVideo() == false; });
+            if (next == m_Queue.end() && m_Queue.empty() == false)
+            {
+                wait = std::max(amf_pts(-m_PacingBudget * AMF_SECOND / m_PacingBitrate), amf_pts(AMF_MILLISECOND));
+            }
+        }
+        if (next != m_Queue.end())
+        {
+            message = std::move(*next);
+            m_Queue.erase(next);
+            if (message.IsVideo() == true)
+            {
+                m_SendingFrameID = message.m_FrameID;
+                if (m_PacingBitrate != 0)
+                {
+                    m_PacingBudget -= int64_t(message.m_Data.GetSize()) * 8;
+                }
+            }
+
+            amf_pts age = amf_high_precision_clock() - message.m_QueuedTime;
+            m_Stats.totalAge += age;
+            m_Stats.maxAge = std::max(m_Stats.maxAge, age);
+            ++m_Stats.sent;
+            result = true;
+        }
+        return result;
+    }
+
+    void SendQueue::DropStale(amf_pts now, MessageClass incoming)
+    {
+        //  Non-reference frames which have been waiting for too long are not worth sending any more
+        DropFrames(0, m_Queue.size(), [this, now](const QueuedMessage& message)
+            {
+                return message.m_Class == MessageClass::VIDEO_NON_REFERENCE && now - message.m_QueuedTime > m_MaxAge;
+            });
+
+        if (incoming == MessageClass::VIDEO_KEY)
+        {   //  The receiver is behind, a new key frame supersedes every video frame still waiting
+            Queue::iterator oldestVideo = std::find_if(m_Queue.begin(), m_Queue.end(), [](const QueuedMessage& message) { return message.IsVideo(); });
+            if (oldestVideo != m_Queue.end() && now - oldestVideo->m_QueuedTime > m_MaxAge)
+            {
+                DropFrames(0, m_Queue.size(), [](const QueuedMessage& /*message*/) { return true; });
+            }
+        }
+    }
+
+    bool SendQueue::MakeRoom()
+    {
+        //  1. The oldest non-reference frame, nothing depends on it
+        Queue::iterator found = std::find_if(m_Queue.begin(), m_Queue.end(), [this](const QueuedMessage& message)
+            {
+                return message.m_Class == MessageClass::VIDEO_NON_REFERENCE && IsSending(message) == false;
+            });
+        if (found != m_Queue.end())
+        {
+            size_t idx = size_t(std::distance(m_Queue.begin(), found));
+            DropFrames(idx, idx + 1, [](const QueuedMessage& /*message*/) { return true; });
+            return true;
+        }
+
+        //  2. Collapse to the newest queued key frame, everything before it is superseded
+        Queue::reverse_iterator newestKey = std::find_if(m_Queue.rbegin(), m_Queue.rend(), [](const QueuedMessage& message) { return message.m_Class == MessageClass::VIDEO_KEY; });
+        if (newestKey != m_Queue.rend())
+        {
+            amf_pts keyFrameID = newestKey->m_FrameID;
+            size_t idx = size_t(std::distance(m_Queue.begin(), std::prev(newestKey.base())));
+            if (DropFrames(0, idx, [keyFrameID](const QueuedMessage& message) { return keyFrameID == NO_FRAME || message.m_FrameID != keyFrameID; }) > 0)
+            {
+                return true;
+            }
+        }
+
+        //  3. Reference frames, unless a key frame is queued: the frames after it stay decodable and are kept.
+        //  Otherwise the following frames cannot be decoded either, so wait for a key frame
+        if (newestKey == m_Queue.rend() &&
+            DropFrames(0, m_Queue.size(), [](const QueuedMessage& message) { return message.m_Class != MessageClass::VIDEO_KEY; }) > 0)
+        {
+            m_WaitForKeyFrame = true;
+            m_KeyFrameRequested = true;
+            return true;
+        }
+
+        //  4. Audio, only once there is no video left to drop
+        found = std::find_if(m_Queue.begin(), m_Queue.end(), [](const QueuedMessage& message) { return message.m_Class == MessageClass::AUDIO; });
+        if (found != m_Queue.end())
+        {
+            m_Queue.erase(found);
+            ++m_Stats.droppedAudio;
+            return true;
+        }
+        return false;   //  Only control messages, the frame being sent and a key frame with its dependents are queued, let the queue grow
+    }
+
+    bool SendQueue::IsSending(const QueuedMessage& message) const noexcept
+    {
+        return message.m_FrameID != NO_FRAME && message.m_FrameID == m_SendingFrameID;
+    }
+
+    size_t SendQueue::DropFrames(size_t begin, size_t end, const std::function<bool(const QueuedMessage&)>& predicate)
+    {
+        //  Pick the video messages in [begin, end) to drop, then every other slice of their frames wherever it is queued
+        std::vector<bool> drop(m_Queue.size(), false);
+        std::vector<amf_pts> frames;
+        size_t dropped = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const QueuedMessage& message = m_Queue[i];
+            if (message.IsVideo() == true && IsSending(message) == false && predicate(message) == true)
+            {
+                drop[i] = true;
+                if (message.m_FrameID == NO_FRAME)
+                {
+                    ++dropped;
+                }
+                else if (std::find(frames.begin(), frames.end(), message.m_FrameID) == frames.end())
+                {
+                    frames.push_back(message.m_FrameID);
+                    ++dropped;
+                }
+            }
+        }
+        if (dropped > 0)
+        {
+            Queue remaining;
+            for (size_t i = 0; i < m_Queue.size(); ++i)
+            {
+                const QueuedMessage& message = m_Queue[i];
+                if (drop[i] == false && (message.IsVideo() == false || message.m_FrameID == NO_FRAME || std::find(frames.begin(), frames.end(), message.m_FrameID) == frames.end()))
+                {
+                    remaining.push_back(std::move(m_Queue[i]));
+                }
+            }
+            m_Queue.swap(remaining);
+            if (m_PushFrameID != NO_FRAME && std::find(frames.begin(), frames.end(), m_PushFrameID) != frames.end())
+            {   //  The slices of the frame being pushed which are still to come go too
+                m_PushFrameDropped = true;
+            }
+            m_Stats.droppedVideo += int64_t(dropped);
+        }
+        return dropped;
+    }
+
+    void SendQueue::SenderThread::Run()
+    {
+        while (StopRequested() == false)
+        {
+            QueuedMessage message;
+            amf_pts wait = 0;
+            if (m_Queue.Pop(message, wait) == true)
+            {
+                SSDK_TRACE_COMPLETE(SEND_QUEUE, message.m_TraceKey, message.m_QueuedTime);
+                SSDK_TRACE_KEY_SCOPE(message.m_TraceKey);
+                m_Queue.m_Sender.SendQueuedMessage(message.m_Channel, message.m_Data.GetData(), message.m_Data.GetSize());
+            }
+            else
+            {
+                m_Queue.m_PendingEvent.Lock(static_cast<amf_ulong>((wait > 0 ? std::min(wait, IDLE_WAIT) : IDLE_WAIT) / AMF_MILLISECOND));
+            }
+        }
+    }
+}
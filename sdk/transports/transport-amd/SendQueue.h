@@ -0,0 +1,163 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "Channels.h"
+#include "transports/transport-common/Transport.h"
+#include "util/trace/PipelineTrace.h"
+#include "util/memory/BufferPool.h"
+#include "amf/public/common/Thread.h"
+
+#include <deque>
+#include <functional>
+
+namespace ssdk::transport_amd
+{
+    //  SendQueue: a bounded outbound queue with its own sender thread, so that a receiver which cannot keep up
+    //  only delays its own messages instead of blocking the thread producing them for everyone.
+    //  When the queue is full or frames get stale, messages are dropped in an order that respects frame dependencies:
+    //  non-reference video frames first, then everything before the newest key frame, then, when no key frame
+    //  is queued, the remaining dependent video frames until the next key frame arrives. A key frame queued with
+    //  the frames depending on it is never broken up. Audio is dropped only when no video is queued,
+    //  other messages are never dropped.
+    //  A frame sent in slices is pushed as several messages with the same frame ID, every slice of a key frame as VIDEO_KEY.
+    //  Frames are dropped whole: the slices of a dropped frame still to come are dropped on arrival, and a frame
+    //  the sender thread has started on is never dropped.
+    //  With a pacing bitrate set, video is held in the queue until a token bucket allows it to go out, so a receiver
+    //  slower than the encoder gets its frames late rather than not at all, until they get stale.
+    class SendQueue
+    {
+    public:
+        static constexpr const amf_pts NO_FRAME = -1;       //  Frame ID of a video message which is a frame on its own
+
+        enum class MessageClass
+        {
+            CONTROL,                //  Never dropped
+            AUDIO,
+            VIDEO_KEY,              //  IDR or other recovery point
+            VIDEO_REFERENCE,
+            VIDEO_NON_REFERENCE
+        };
+
+        //  Implemented by the owner, called on the sender thread
+        class Sender
+        {
+        public:
+            virtual transport_common::Result SendQueuedMessage(Channel channel, const void* msg, size_t msgLen) = 0;
+        };
+
+        class Stats
+        {
+        public:
+            size_t      depth = 0;                  //  Messages currently queued
+            amf_pts     totalAge = 0;               //  Sum of the time spent in the queue by the messages sent
+            amf_pts     maxAge = 0;
+            int64_t     sent = 0;
+            int64_t     droppedVideo = 0;           //  Frames, however many slices they were sent in
+            int64_t     droppedAudio = 0;
+        };
+
+    public:
+        SendQueue(Sender& sender, size_t maxDepth, amf_pts maxAge);
+        ~SendQueue();
+
+        void Start();
+        void Stop();
+
+        //  Returns false when the message was dropped on arrival. The queue keeps a reference to a leased message
+        //  rather than a copy, so one buffer can be queued for several subscribers
+        bool Push(Channel channel, const void* msg, size_t msgLen, MessageClass messageClass, amf_pts frameID = NO_FRAME);
+        bool Push(Channel channel, const ssdk::util::BufferPool::Lease& msg, MessageClass messageClass, amf_pts frameID = NO_FRAME);
+
+        bool TakeKeyFrameRequest();                 //  True once after dependent video frames were dropped and a key frame is needed
+        void SetPacingBitrate(int64_t bitrate);     //  In bps, 0 - video is sent as fast as the sender allows
+        Stats GetStats(bool reset);
+
+    private:
+        SendQueue(const SendQueue&) = delete;
+        SendQueue& operator=(const SendQueue&) = delete;
+
+        struct QueuedMessage
+        {
+            Channel                 m_Channel = Channel::SERVICE;
+            MessageClass            m_Class = MessageClass::CONTROL;
+            amf_pts                 m_QueuedTime = 0;
+            amf_pts                 m_TraceKey = ssdk::util::PipelineTrace::NO_KEY;
+            amf_pts                 m_FrameID = NO_FRAME;
+            ssdk::util::BufferPool::Lease   m_Data;
+
+            inline bool IsVideo() const noexcept { return m_Class == MessageClass::VIDEO_KEY || m_Class == MessageClass::VIDEO_REFERENCE || m_Class == MessageClass::VIDEO_NON_REFERENCE; }
+        };
+        typedef std::deque<QueuedMessage> Queue;
+
+        class SenderThread : public amf::AMFThread
+        {
+        public:
+            SenderThread(SendQueue& queue) : m_Queue(queue) {}
+
+        protected:
+            virtual void Run() override;
+
+        private:
+            SendQueue& m_Queue;
+        };
+        friend class SenderThread;
+
+        bool Pop(QueuedMessage& message, amf_pts& wait);    //  wait receives the time until paced video may go out
+        void DropStale(amf_pts now, MessageClass incoming);
+        bool MakeRoom();
+        bool IsSending(const QueuedMessage& message) const noexcept;
+        size_t DropFrames(size_t begin, size_t end, const std::function<bool(const QueuedMessage&)>& predicate);
+
+    private:
+        mutable amf::AMFCriticalSection m_Guard;
+        Sender&                         m_Sender;
+        const size_t                    m_MaxDepth;
+        const amf_pts                   m_MaxAge;
+        Queue                           m_Queue;
+        bool                            m_WaitForKeyFrame = false;
+        bool                            m_KeyFrameRequested = false;
+        amf_pts                         m_SendingFrameID = NO_FRAME;    //  Frame of the last video message handed to the sender
+        amf_pts                         m_PushFrameID = NO_FRAME;       //  Frame of the last video message pushed
+        bool                            m_PushFrameDropped = false;     //  Slices of it have been dropped, the rest follows
+        int64_t                         m_PacingBitrate = 0;
+        int64_t                         m_PacingBudget = 0;             //  In bits, negative while video has to wait
+        amf_pts                         m_PacingTime = 0;
+        Stats                           m_Stats;
+        amf::AMFEvent                   m_PendingEvent;
+        SenderThread                    m_SenderThread;
+    };
+}
@@ -36,9 +36,16 @@ THE SOFTWARE.
 #include "ServerDiscovery.h"
 #include "ClientImpl.h"
 #include "ClientSessionImpl.h"
+#include "net/Selector.h"
 #include "amf/public/common/TraceAdapter.h"
 
+#include <algorithm>
+#include <cstring>
+
 static constexpr const time_t DISCOVERY_TIMEOUT = 10;
+static constexpr const amf_pts FIRST_RETRY_DELAY = 50 * AMF_MILLISECOND;     //  Requests are sent at 0, 50, 200, 800, 3200... ms
+static constexpr const amf_pts RETRY_BACKOFF = 4;
+static constexpr const amf_pts DISCOVERY_QUIET_PERIOD = AMF_SECOND;         //  Enumeration ends when no new server responded for that long
 
 static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::transport_amd::ServerDiscovery";
 
@@ -169,55 +176,107 @@ namespace ssdk::transport_amd
         m_Peer = peer;
     }
 
-    DatagramClientSessionFlowCtrl::Result ServerDiscoverySession::EnumerateServers(ServerEnumCallback* callback, size_t* size, amf::AMFPropertyStoragePtr options)
+    DatagramClientSessionFlowCtrl::Result ServerDiscoverySession::EnumerateServers(ServerEnumCallback* callback, size_t* size, amf::AMFPropertyStoragePtr options, DiscoveryCache* cache)
     {
         DatagramClientSessionFlowCtrl::Result res = DatagramClientSessionFlowCtrl::Result::OK;
         m_LastResult = DatagramClientSessionFlowCtrl::Result::OK;
         DiscoveryRequest helloRequest(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT, FlowCtrlProtocol::PROTOCOL_VERSION_MIN, m_ClientDeviceID.c_str(), m_ReceiveBufSize, options);
-        Broadcast(helloRequest.GetSendData(), helloRequest.GetSendSize(), uint8_t(Channel::SERVICE));
-        time_t startTime;
-        time(&startTime);
-        time_t curTime;
-        time_t timeout = GetTimeout();
+        DiscoveryCache::Entries cachedServers;
+        if (cache != nullptr)
+        {
+            cachedServers = cache->GetRecent();
+        }
         m_Callback = callback;
+        m_Cache = cache;
         m_KeepLooking = ServerEnumCallback::DiscoveryCtrl::CONTINUE;
+        m_LastServerFoundTime = 0;
+
+        amf_pts startTime = amf_high_precision_clock();
+        amf_pts deadline = startTime + GetTimeout() * AMF_SECOND;
+        amf_pts nextRequestTime = startTime;
+        amf_pts lastRequestTime = startTime;
+        amf_pts retryDelay = FIRST_RETRY_DELAY;
+        int requests = 0;
 #pragma warning(disable:4127)
         while (true)
 #pragma warning(default:4127)
         {
-            WaitForIncoming();
+            amf_pts now = amf_high_precision_clock();
+            if (now >= nextRequestTime)
+            {   //  Either the request or the response could have been lost, the broadcast might not reach the subnet of a cached server
+                Broadcast(helloRequest.GetSendData(), helloRequest.GetSendSize(), uint8_t(Channel::SERVICE));
+                for (const DiscoveryCache::Entry& server : cachedServers)
+                {
+                    Unicast(net::Socket::IPv4Address(server.m_Address, server.m_Port), helloRequest.GetSendData(), helloRequest.GetSendSize(), uint8_t(Channel::SERVICE));
+                }
+                ++requests;
+                lastRequestTime = now;
+                nextRequestTime = now + retryDelay;
+                retryDelay *= RETRY_BACKOFF;
+            }
+            if (WaitForIncomingUntil(std::min(nextRequestTime, deadline)) == DatagramClientSessionFlowCtrl::Result::CONNECTION_TERMINATED)
+            {
+                break;
+            }
             if (m_KeepLooking != ServerEnumCallback::DiscoveryCtrl::CONTINUE)
             {
                 res = m_LastResult;
                 AMFTraceDebug(AMF_FACILITY, L"Was instructed to stop looking for new servers");
                 break;
             }
-            time(&curTime);
-            if ((curTime - startTime) > timeout)
+            now = amf_high_precision_clock();
+            if (now >= deadline)
             {
                 AMFTraceDebug(AMF_FACILITY, L"Stopped looking for new servers due to timeout");
                 break;
             }
+            if (m_Servers.size() > 0 && now - std::max(lastRequestTime, m_LastServerFoundTime) >= DISCOVERY_QUIET_PERIOD)
+            {
+                AMFTraceDebug(AMF_FACILITY, L"No new servers responded for %d ms", (int)(DISCOVERY_QUIET_PERIOD / AMF_MILLISECOND));
+                break;
+            }
         }
-        AMFTraceDebug(AMF_FACILITY, L"Exited the discovery loop");
+        AMFTraceDebug(AMF_FACILITY, L"Exited the discovery loop after %d ms, %d request(s) sent, %d server(s) cached",
+                      (int)((amf_high_precision_clock() - startTime) / AMF_MILLISECOND), requests, (int)cachedServers.size());
         if ((*size = m_Servers.size()) == 0)
         {
             res = DatagramClientSessionFlowCtrl::Result::TIMEOUT;
         }
         m_Callback = nullptr;
+        m_Cache = nullptr;
         return res;
     }
 
-    DatagramClientSessionFlowCtrl::Result ServerDiscoverySession::QueryServerInfo(ServerEnumCallback* callback, amf::AMFPropertyStoragePtr options)
+    DatagramClientSessionFlowCtrl::Result ServerDiscoverySession::QueryServerInfo(ServerEnumCallback* callback, amf::AMFPropertyStoragePtr options, DiscoveryCache* cache)
     {
         DatagramClientSessionFlowCtrl::Result res = DatagramClientSessionFlowCtrl::Result::OK;
         m_LastResult = DatagramClientSessionFlowCtrl::Result::OK;
         DiscoveryRequest helloRequest(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT, FlowCtrlProtocol::PROTOCOL_VERSION_MIN, m_ClientDeviceID.c_str(), m_ReceiveBufSize, options);
-        Send(helloRequest.GetSendData(), helloRequest.GetSendSize(), uint8_t(Channel::SERVICE));
         m_Callback = callback;
+        m_Cache = cache;
         m_KeepLooking = ServerEnumCallback::DiscoveryCtrl::ABORT;
 
-        WaitForIncoming();
+        amf_pts deadline = amf_high_precision_clock() + GetTimeout() * AMF_SECOND;
+        amf_pts nextRequestTime = 0;
+        amf_pts retryDelay = FIRST_RETRY_DELAY;
+        while (m_Servers.size() == 0 && m_LastResult == DatagramClientSessionFlowCtrl::Result::OK)
+        {
+            amf_pts now = amf_high_precision_clock();
+            if (now >= deadline)
+            {
+                break;
+            }
+            if (now >= nextRequestTime)
+            {
+                Send(helloRequest.GetSendData(), helloRequest.GetSendSize(), uint8_t(Channel::SERVICE));
+                nextRequestTime = now + retryDelay;
+                retryDelay *= RETRY_BACKOFF;
+            }
+            if (WaitForIncomingUntil(std::min(nextRequestTime, deadline)) == DatagramClientSessionFlowCtrl::Result::CONNECTION_TERMINATED)
+            {
+                break;
+            }
+        }
 
         res = m_LastResult;
 
@@ -229,10 +288,60 @@ namespace ssdk::transport_amd
         }
 
         m_Callback = nullptr;
+        m_Cache = nullptr;
 
         return res;
     }
 
+    DatagramClientSessionFlowCtrl::Result ServerDiscoverySession::WaitForIncomingUntil(amf_pts deadline)
+    {
+        //  Unlike WaitForIncoming(), returns as soon as the deadline expires or a datagram has been processed
+        net::Selector selector;
+        selector.AddReadableSocket(m_Socket);
+        net::Socket::Set readableSockets;
+        do
+        {
+            {
+                std::lock_guard<std::recursive_mutex> lock(m_Guard);
+                if (m_Terminated == true)
+                {
+                    return DatagramClientSessionFlowCtrl::Result::CONNECTION_TERMINATED;
+                }
+            }
+            amf_pts remaining = std::max<amf_pts>(deadline - amf_high_precision_clock(), 0);
+            struct timeval timeout_tv = {};
+            timeout_tv.tv_sec = static_cast<long>(remaining / AMF_SECOND);
+            timeout_tv.tv_usec = static_cast<long>(remaining % AMF_SECOND * 1000000 / AMF_SECOND);
+            switch (selector.WaitToRead(timeout_tv, readableSockets))
+            {
+            case net::Selector::Result::OK:
+                if (readableSockets.size() > 0)
+                {
+                    return ProcessIncomingMessages();
+                }
+                break;
+            case net::Selector::Result::TIMEOUT:
+                OnTickNotify();
+                return DatagramClientSessionFlowCtrl::Result::TIMEOUT;
+            default:
+                return DatagramClientSessionFlowCtrl::Result::RECEIVE_FAILED;
+            }
+        } while (amf_high_precision_clock() < deadline);
+        return DatagramClientSessionFlowCtrl::Result::TIMEOUT;
+    }
+
+    bool ServerDiscoverySession::IsServerKnown(const char* url) const
+    {
+        for (const ServerParameters::Ptr& server : m_Servers)
+        {
+            if (strcmp(server->GetUrl(), url) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
     DatagramClientSessionFlowCtrl::Result ServerDiscoverySession::OnInit()
     {
         return DatagramClientSessionFlowCtrl::Result::OK;
@@ -251,11 +360,20 @@ namespace ssdk::transport_amd
                 unsigned char serverVersion = static_cast<unsigned char>(resp.GetProtocolVersion());
                 if (serverVersion >= FlowCtrlProtocol::PROTOCOL_VERSION_MIN)
                 {
+                    if (m_Cache != nullptr)
+                    {
+                        m_Cache->Update(receivedFrom);
+                    }
                     const std::vector<std::string>& transports(resp.GetSupportedTransports());
                     for (std::vector<std::string>::const_iterator it = transports.begin(); it != transports.end(); ++it)
                     {
                         ServerParameters::Ptr    server(new ServerParametersImpl(resp, *it, receivedFrom));
+                        if (IsServerKnown(server->GetUrl()) == true)
+                        {   //  Answers to a repeated request, or to both the broadcast and the unicast to a cached server
+                            continue;
+                        }
                         m_Servers.push_back(server);
+                        m_LastServerFoundTime = amf_high_precision_clock();
                         if (m_Callback != nullptr)
                         {
                             m_KeepLooking = m_Callback->OnServerDiscovered(server);
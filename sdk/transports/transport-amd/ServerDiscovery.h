@@ -47,6 +47,7 @@ THE SOFTWARE.
 #include "net/DatagramClient.h"
 #include "net/Url.h"
 #include "DgramClientSessionFlowCtrl.h"
+#include "DiscoveryCache.h"
 #include "public/common/InterfaceImpl.h"
 #include <vector>
 #include <map>
@@ -116,8 +117,11 @@ namespace ssdk::transport_amd
     public:
         ServerDiscoverySession(const std::string& deviceID, net::Socket* sock, const net::Socket::Address& peer, size_t receiveBufSize, ServerParametersImpl::Collection& servers, unsigned short port);
 
-        Result EnumerateServers(ServerEnumCallback* callback, size_t *size, amf::AMFPropertyStoragePtr options);
-        Result QueryServerInfo(ServerEnumCallback* callback, amf::AMFPropertyStoragePtr options);
+        //  Discovery requests are repeated with an exponential backoff until the timeout expires. Servers are reported to the callback
+        //  as their responses arrive, once at least one has been found EnumerateServers() returns early when no new one shows up for a while.
+        //  When a cache is specified the servers in it are also queried by unicast, and every server which responds is added to it.
+        Result EnumerateServers(ServerEnumCallback* callback, size_t *size, amf::AMFPropertyStoragePtr options, DiscoveryCache* cache = nullptr);
+        Result QueryServerInfo(ServerEnumCallback* callback, amf::AMFPropertyStoragePtr options, DiscoveryCache* cache = nullptr);
 
     protected:
         virtual Result AMF_STD_CALL OnInit() override;
@@ -125,6 +129,10 @@ namespace ssdk::transport_amd
         virtual Result AMF_STD_CALL OnSessionTimeout() override;
         virtual net::Session::Result   AMF_STD_CALL OnSessionClose() override;
         virtual Result OnTerminate();
+    private:
+        Result WaitForIncomingUntil(amf_pts deadline);
+        bool IsServerKnown(const char* url) const;
+
     private:
         ServerParametersImpl::Collection&               m_Servers;
         ServerEnumCallback*                             m_Callback = nullptr;
@@ -132,6 +140,8 @@ namespace ssdk::transport_amd
         volatile DatagramClientSessionFlowCtrl::Result  m_LastResult = DatagramClientSessionFlowCtrl::Result::OK;
         std::string                                     m_ClientDeviceID;
         size_t                                          m_ReceiveBufSize = 0;
+        DiscoveryCache*                                 m_Cache = nullptr;
+        amf_pts                                         m_LastServerFoundTime = 0;
     };
     //---------------------------------------------------------------------------------------------
     class DiscoveryClient :
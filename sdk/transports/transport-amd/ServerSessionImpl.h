@@ -77,6 +77,10 @@ namespace ssdk::transport_amd
         inline void SetPeerAddress(const std::string& address) { m_PeerAddress = address; }
 
         virtual ssdk::transport_common::SessionHandle AMF_STD_CALL GetSessionHandle() const noexcept override { return m_SessionHandle; };
+
+        //  Sends a message unencrypted when it never leaves the host, see LocalTransport.h. Returns false when the message
+        //  has to be encrypted and sent with Send() instead
+        virtual bool SendClearText(Channel /*channel*/, const void* /*msg*/, size_t /*msgLen*/, transport_common::Result* /*result*/) { return false; }
     protected:
         void TimeoutNotify();
         void TerminateNotify();
@@ -42,6 +42,8 @@ THE SOFTWARE.
 #include "ServerTransportImpl.h"
 #include "transports/transport-amd/messages/service/StartStop.h"
 #include "transports/transport-amd/messages/service/Update.h"
+#include "transports/transport-amd/messages/service/ClockSync.h"
+#include "transports/transport-amd/messages/service/Resume.h"
 #include "transports/transport-amd/messages/video/VideoInit.h"
 #include "transports/transport-amd/messages/video/VideoData.h"
 #include "transports/transport-amd/messages/audio/AudioInit.h"
@@ -53,14 +55,18 @@ THE SOFTWARE.
 #include "controllers/TouchEvent.h"
 #include "transports/transport-amd/messages/service/GenericMessage.h"
 #include "sdk/video/Defines.h"
+#include "sdk/util/trace/PipelineTrace.h"
+#include <algorithm>
 #include <sstream>
 #include <chrono>
+#include <memory>
 
 // Default parameter values
 static constexpr const int64_t DATAGRAM_MSG_INTERVAL = 10;
 static constexpr const int64_t DATAGRAM_LOST_MSG_THRESHOLD = 10;
 static constexpr const int64_t DATAGRAM_TURNING_POINT_THRESHOLD = 20;
 static constexpr const int64_t SUBSCRIBER_CONNECTION_TIMEOUT = 30;
+static constexpr const int64_t RESUME_TICKET_LIFETIME = 30;     // seconds after the session a ticket was issued to has ended
 
 namespace ssdk::transport_amd
 {
@@ -76,13 +82,13 @@ namespace ssdk::transport_amd
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// ServerTransport interface implementation
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-    ServerTransportImpl::ServerTransportImpl() :
-        m_SessionMonitor(*this)
+    ServerTransportImpl::ServerTransportImpl()
     {
     }
 
     ServerTransportImpl::~ServerTransportImpl()
     {
+        m_Timers.Stop();    //  Timer callbacks use the members destroyed before m_Timers
     }
 
     Result ServerTransportImpl::Start(const ServerInitParameters& params)
@@ -149,6 +155,15 @@ namespace ssdk::transport_amd
             m_pServer->SetProperty(DATAGRAM_MSG_INTERVAL, 10);
             m_pServer->SetProperty(DATAGRAM_LOST_MSG_THRESHOLD, 10);
             m_pServer->SetProperty(DATAGRAM_TURNING_POINT_THRESHOLD, 10);
+            m_pServer->SetProperty(DATAGRAM_PATH_MTU_DISCOVERY, true);
+            m_pServer->SetProperty(DATAGRAM_NETWORK_IMPAIRMENT, m_InitParams.GetNetworkImpairment().c_str());
+            m_pServer->SetProperty(LOCAL_SOCKET_PATH, m_InitParams.GetLocalSocketPath().c_str());
+            m_pServer->SetProperty(DATAGRAM_RECEIVE_SHARDS, m_InitParams.GetReceiveShards());
+            m_pServer->SetProperty(DATAGRAM_DSCP_MARKING, m_InitParams.GetDscpMarking());
+            m_pServer->SetProperty(SOCKET_MAX_BITRATE, m_InitParams.GetSocketMaxBitrate());
+            m_pServer->SetProperty(SOCKET_FRAME_RATE, m_InitParams.GetSocketFrameRate());
+            m_pServer->SetProperty(SOCKET_BUSY_POLL, m_InitParams.GetSocketBusyPoll());
+            m_pServer->SetProperty(DATAGRAM_IO_URING, m_InitParams.GetIoUring());
 
             Result serverStatus = m_pServer->Activate(url.str().c_str(), this);
             AMF_RETURN_IF_FALSE(serverStatus == Result::OK, Result::FAIL, L"Unable to start Server Service, Acticate() failed err = %d", (int)serverStatus);
@@ -195,11 +210,8 @@ namespace ssdk::transport_amd
 
         DisconnectAllSessions();
 
-        if (m_SessionMonitor.IsRunning() == true)
-        {
-            m_SessionMonitor.RequestStop();
-            m_SessionMonitor.WaitForStop();
-        }
+        m_Timers.Stop();
+        m_Timers.Clear();
 
         pDiscoverySession = nullptr;
         pContext = nullptr;
@@ -212,6 +224,7 @@ namespace ssdk::transport_amd
             amf::AMFLock lock(&m_Guard);
             m_Ciphers.clear();
         }
+        m_ResumptionCache.Clear();
 
 #ifdef WIN32
         ::WSACleanup();
@@ -233,6 +246,19 @@ namespace ssdk::transport_amd
                 pSubscriber->WaitForVideoInitAck(start.IsVideoInitAckRequired());
                 pSubscriber->WaitForAudioInitAck(start.IsAudioInitAckRequired());
 
+                ResumptionState::Ptr pState = pSubscriber->GetResumptionState();
+                if (pState != nullptr)
+                {
+                    if (start.GetVideoStreamID() != INVALID_STREAM)
+                    {
+                        pState->Subscribe(Channel::VIDEO_OUT, start.GetVideoStreamID(), start.IsVideoInitAckRequired());
+                    }
+                    if (start.GetAudioStreamID() != INVALID_STREAM)
+                    {
+                        pState->Subscribe(Channel::AUDIO_OUT, start.GetAudioStreamID(), start.IsAudioInitAckRequired());
+                    }
+                }
+
                 VideoSenderCallback* pVSCallback = m_InitParams.GetVideoSenderCallback();
                 AudioSenderCallback* pASCallback = m_InitParams.GetAudioSenderCallback();
                 SessionHandle hSession = session->GetSessionHandle();
@@ -378,6 +404,7 @@ namespace ssdk::transport_amd
         ConnectionManagerCallback* pCMCallback = m_InitParams.GetConnectionManagerCallback();
         for (Subscribers::iterator it = m_Subscribers.begin(); it != m_Subscribers.end(); it++)
         {
+            ReleaseResumeTicket(it->second);
             if (pCMCallback != nullptr)
             {
                 SessionHandle hSession = it->first->GetSessionHandle();
@@ -420,6 +447,7 @@ namespace ssdk::transport_amd
 
     void ServerTransportImpl::OnServiceMessage(Session* session, uint8_t opcode, const void* msg, size_t len, Subscriber::Ptr pSubscriber)
     {
+        amf_pts receiveTime = amf_high_precision_clock();
         if (pSubscriber != nullptr)
         {
             switch (SERVICE_OP_CODE(opcode))
@@ -446,6 +474,13 @@ namespace ssdk::transport_amd
             case SERVICE_OP_CODE::TRACKABLE_DEVICE_CAPS:
                 AMFTraceInfo(AMF_FACILITY, L"OnServiceMessage - SERVICE_OP_CODE_TRACKABLE_DEVICE_CAPS from %S at %S", pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress());
                 break;
+            case SERVICE_OP_CODE::CLOCK_SYNC:
+                OnServiceClockSync(msg, len, receiveTime, pSubscriber);
+                break;
+            case SERVICE_OP_CODE::RESUME:
+                AMFTraceDebug(AMF_FACILITY, L"OnServiceMessage - SERVICE_OP_CODE_RESUME from %S at %S", pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress());
+                OnServiceResume(session, msg, len, pSubscriber);
+                break;
             default:
                 AMFTraceError(AMF_FACILITY, L"OnServiceMessage - invalid opcode %d from %S at %S", opcode, pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress());
             }
@@ -456,6 +491,20 @@ namespace ssdk::transport_amd
         }
     }
 
+    void ServerTransportImpl::OnServiceClockSync(const void* msg, size_t len, amf_pts receiveTime, Subscriber::Ptr pSubscriber)
+    {
+        ClockSyncMessage request;
+        if (request.ParseBuffer(msg, len) == false || request.IsResponse() == true)
+        {
+            AMFTraceError(AMF_FACILITY, L"OnServiceClockSync - invalid clock sync request from %S", pSubscriber->GetSubscriberIPAddress());
+        }
+        else
+        {   //  Echo the client's timestamp back with ours, the transmit time is taken as late as possible
+            ClockSyncMessage response(request.GetOriginate(), receiveTime, amf_high_precision_clock());
+            pSubscriber->TransmitMessage(Channel::SERVICE, response.GetSendData(), response.GetSendSize());
+        }
+    }
+
     void ServerTransportImpl::ForceKeyFrame(Session* session, const void* msg, size_t len, Subscriber::Ptr pSubscriber)
     {
         AMFTraceInfo(AMF_FACILITY, L"Key/IDR frame requested");
@@ -485,6 +534,11 @@ namespace ssdk::transport_amd
     }
 
     void ServerTransportImpl::TransmitMessageToAllSubscribers(Channel channel, const void* msg, size_t msgLen)
+    {
+        TransmitMessageToAllSubscribers(channel, ssdk::util::BufferPool::GetInstance().Acquire(msg, msgLen));
+    }
+
+    void ServerTransportImpl::TransmitMessageToAllSubscribers(Channel channel, const ssdk::util::BufferPool::Lease& msg)
     {
         Subscribers subscribers;
         {
@@ -493,7 +547,7 @@ namespace ssdk::transport_amd
         }
         for (Subscribers::iterator it = subscribers.begin(); it != subscribers.end(); it++)
         {
-            it->second->TransmitMessage(channel, msg, msgLen);
+            it->second->TransmitMessage(channel, msg);
         }
     }
 
@@ -681,6 +735,36 @@ namespace ssdk::transport_amd
                 AMFTraceInfo(AMF_FACILITY, L"OnVideoOutMessage - VIDEO_OP_CODE FORCE_UPDATE received from client %S at %S", pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress());
                 ForceKeyFrame(session, msg, len, pSubscriber);
                 break;
+            case VIDEO_OP_CODE::CURSOR_CACHE_MISS:
+                {
+                    CursorCacheMiss miss;
+                    if (miss.ParseBuffer(msg, len) == false)
+                    {
+                        AMFTraceError(AMF_FACILITY, L"OnVideoOutMessage::CURSOR_CACHE_MISS - Invalid JSON");
+                    }
+                    else
+                    {
+                        ssdk::util::BufferPool::Lease fullMsg;
+                        {
+                            amf::AMFLock lock(&m_Guard);
+                            ssdk::util::BufferPool::Lease* pCachedMsg = m_CursorMessages.Find(miss.GetHash());
+                            if (pCachedMsg != nullptr)
+                            {
+                                fullMsg = *pCachedMsg;
+                            }
+                        }
+                        if (fullMsg.IsValid() == true)
+                        {
+                            pSubscriber->TransmitMessage(Channel::VIDEO_OUT, fullMsg);
+                            pSubscriber->SetCursorCached(miss.GetHash());
+                        }
+                        else
+                        {
+                            AMFTraceWarning(AMF_FACILITY, L"OnVideoOutMessage - cursor %llx requested by client %S at %S is no longer cached", miss.GetHash(), pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress());
+                        }
+                    }
+                }
+                break;
             case VIDEO_OP_CODE::INIT_REQUEST:
                 {
                     VideoInitRequest request;
@@ -692,6 +776,7 @@ namespace ssdk::transport_amd
                     {
                         AMFTraceInfo(AMF_FACILITY, L"OnVideoOutMessage - VIDEO_OP_CODE INIT_REQUEST received from client %S at %S", pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress());
                         // Send extradata to client from SendVideoInit(). Application calls SendVideoInit() when receives OnVideoRequestInit() callback
+                        pSubscriber->TakeInitReplayed(Channel::VIDEO_OUT, request.GetStreamID());   // The client asked for it, so it must be sent even if it was replayed
                         if (pVSCallback != nullptr)
                         {
                             pVSCallback->OnVideoRequestInit(session->GetSessionHandle(), request.GetStreamID());
@@ -752,6 +837,7 @@ namespace ssdk::transport_amd
                     {
                         AMFTraceInfo(AMF_FACILITY, L"OnVideoOutMessage - VIDEO_OP_CODE INIT_REQUEST received from client %S at %S", pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress());
                         // Send extradata to client from SendVideoInit(). Application calls SendVideoInit() when receives OnVideoRequestInit() callback
+                        pSubscriber->TakeInitReplayed(Channel::AUDIO_OUT, request.GetStreamID());
                         if (pASCallback != nullptr)
                         {
                             pASCallback->OnAudioRequestInit(session->GetSessionHandle(), request.GetStreamID());
@@ -779,8 +865,7 @@ namespace ssdk::transport_amd
         {
             // Send extradata to client. Application calls SendVideoInit() when receives OnVideoRequestInit() callback
             VideoInit videoInit(initID, codec, streamResolution.width, streamResolution.height, viewport, foveated, bitDepth, streamID);
-            AMFByteArray videoExtradata;
-            videoExtradata.SetSize(videoInit.GetSendSize() + 1 + initBlockSize);
+            ssdk::util::BufferPool::Lease videoExtradata = ssdk::util::BufferPool::GetInstance().Acquire(videoInit.GetSendSize() + 1 + initBlockSize);
             uint8_t* data = videoExtradata.GetData();
             memcpy(data, videoInit.GetSendData(), videoInit.GetSendSize());
             data += videoInit.GetSendSize();
@@ -795,12 +880,23 @@ namespace ssdk::transport_amd
                 amf::AMFLock lock(&m_Guard);
                 pSubscriber = FindSubscriber(m_Sessions[session]);
             }
-            if (pSubscriber != nullptr)
+            ResumptionState::Ptr pState = pSubscriber != nullptr ? pSubscriber->GetResumptionState() : nullptr;
+            if (pSubscriber != nullptr && pSubscriber->TakeInitReplayed(Channel::VIDEO_OUT, streamID) == true && pState != nullptr &&
+                pState->IsInitCached(Channel::VIDEO_OUT, streamID, videoExtradata.GetData(), videoExtradata.GetSize()) == true)
+            {
+                pSubscriber->SetEncoderStereo(stereoscopic);
+                AMFTraceInfo(AMF_FACILITY, L"SendVideoInit: Video init block for stream %lld, init ID %lld was already replayed to client %S at %S on resumption", streamID, initID, pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress());
+            }
+            else if (pSubscriber != nullptr)
             {
+                if (pState != nullptr)
+                {
+                    pState->SetInit(Channel::VIDEO_OUT, streamID, initID, videoExtradata.GetData(), videoExtradata.GetSize());
+                }
                 pSubscriber->SetVideoInitSentTime(amf_high_precision_clock());
                 pSubscriber->WaitForIDR(true);
                 pSubscriber->SetEncoderStereo(stereoscopic);
-                pSubscriber->TransmitMessage(Channel::VIDEO_OUT, videoExtradata.GetData(), videoExtradata.GetSize());
+                pSubscriber->TransmitMessage(Channel::VIDEO_OUT, videoExtradata);
                 AMFTraceInfo(AMF_FACILITY, L"SendVideoInit: Sent video init block to client %S at %S for stream %lld, init ID %lld", pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress(), streamID, initID);
                 VideoSenderCallback* pVSCallback = m_InitParams.GetVideoSenderCallback();
                 if (pSubscriber->WaitForVideoInitAck() == false && pVSCallback != nullptr)
@@ -813,7 +909,7 @@ namespace ssdk::transport_amd
         return result;
     }
 
-    Result ServerTransportImpl::SendVideoFrame(SessionHandle session, StreamID /*streamID*/, const TransmittableVideoFrame& frame)
+    Result ServerTransportImpl::SendVideoFrame(SessionHandle session, StreamID streamID, const TransmittableVideoFrame& frame)
     {
         // Calculate frame buffer
         size_t frameBufSize = frame.CalculateRequiredBufferSize();
@@ -821,6 +917,8 @@ namespace ssdk::transport_amd
         // Create video data
         amf_pts pts = frame.GetPts();
         amf_pts originPts = frame.GetOriginPts();
+        SSDK_TRACE_SPAN(TRANSMIT, pts);
+        SSDK_TRACE_KEY_SCOPE(pts);     //  Follows the frame into the send queue and down to the fragments
         amf_pts ptsServerLatency = 0, ptsEncoderLatency = 0, ptsLastSendDuration = 0;
 
         { // Todo: move this elsewhere, ServerTransportImpl should not depend on the application;  Don't forget to remove Defines.h include
@@ -842,9 +940,8 @@ namespace ssdk::transport_amd
         bool discontinuity = frame.IsDiscontinuity();
         VideoData videoData(pts, originPts, ptsServerLatency, ptsEncoderLatency, compressedFrameSize, eViewType, eSubframeType, ptsLastSendDuration, uiFrameNum, discontinuity);
 
-        // Copy video data to buffer
-        AMFByteArray bufToSend;
-        bufToSend.SetSize(videoData.GetSendSize() + 1 + frameBufSize);
+        // Copy video data to a pooled buffer, the send queue keeps it until the frame has been sent
+        ssdk::util::BufferPool::Lease bufToSend = ssdk::util::BufferPool::GetInstance().Acquire(videoData.GetSendSize() + 1 + frameBufSize);
         amf_uint8* dataPtr = bufToSend.GetData();
         memcpy(dataPtr, videoData.GetSendData(), videoData.GetSendSize());
 
@@ -860,7 +957,27 @@ namespace ssdk::transport_amd
         Subscriber::Ptr pSubscriber = FindSubscriber(m_Sessions[session]);
         if (pSubscriber != nullptr)
         {
-            result = pSubscriber->TransmitMessage(Channel::VIDEO_OUT, bufToSend.GetData(), bufToSend.GetSize());
+            //  Slices of a frame share its pts and the key frame flag, the type of a sliced frame comes with its last slice
+            SendQueue::MessageClass messageClass = SendQueue::MessageClass::VIDEO_REFERENCE;
+            if (frame.IsKeyFrame() == true)
+            {
+                messageClass = SendQueue::MessageClass::VIDEO_KEY;
+            }
+            else if (frame.GetSubframeCount() > 0 && frame.GetSubframeType(frame.GetSubframeCount() - 1) == VideoFrame::SubframeType::B)
+            {
+                messageClass = SendQueue::MessageClass::VIDEO_NON_REFERENCE;
+            }
+            result = pSubscriber->TransmitMessage(Channel::VIDEO_OUT, bufToSend, messageClass, pts);
+
+            if (pSubscriber->TakeKeyFrameRequest() == true)
+            {   //  The send queue had to drop frames other frames depend on, the client needs a key frame to recover
+                AMFTraceInfo(AMF_FACILITY, L"Send queue of %S at %S overflowed, requesting a key frame", pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress());
+                VideoSenderCallback* pVSCallback = m_InitParams.GetVideoSenderCallback();
+                if (pVSCallback != nullptr)
+                {
+                    pVSCallback->OnForceUpdateRequest(streamID);
+                }
+            }
         }
 
         return result;
@@ -871,8 +988,7 @@ namespace ssdk::transport_amd
     {
         // Send extradata to client. Application calls SendAudioInit() when receives OnAudioRequestInit() callback
         AudioInit audioInit(initID, codec, format, samplingRate, channels, layout, streamID);
-        AMFByteArray audioExtradata;
-        audioExtradata.SetSize(audioInit.GetSendSize() + 1 + initBlockSize);
+        ssdk::util::BufferPool::Lease audioExtradata = ssdk::util::BufferPool::GetInstance().Acquire(audioInit.GetSendSize() + 1 + initBlockSize);
         amf_uint8* data = audioExtradata.GetData();
         memcpy(data, audioInit.GetSendData(), audioInit.GetSendSize());
         data += audioInit.GetSendSize();
@@ -887,10 +1003,21 @@ namespace ssdk::transport_amd
             amf::AMFLock lock(&m_Guard);
             pSubscriber = FindSubscriber(m_Sessions[session]);
         }
-        if (pSubscriber != nullptr)
+        ResumptionState::Ptr pState = pSubscriber != nullptr ? pSubscriber->GetResumptionState() : nullptr;
+        if (pSubscriber != nullptr && pSubscriber->TakeInitReplayed(Channel::AUDIO_OUT, streamID) == true && pState != nullptr &&
+            pState->IsInitCached(Channel::AUDIO_OUT, streamID, audioExtradata.GetData(), audioExtradata.GetSize()) == true)
+        {
+            AMFTraceInfo(AMF_FACILITY, L"SendAudioInit: Audio init block for stream %lld, init ID %lld was already replayed to client %S at %S on resumption", streamID, initID, pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress());
+        }
+        else if (pSubscriber != nullptr)
         {
+            if (pState != nullptr)
+            {
+                pState->SetInit(Channel::AUDIO_OUT, streamID, initID, audioExtradata.GetData(), audioExtradata.GetSize());
+            }
             pSubscriber->SetAudioInitSentTime(amf_high_precision_clock());
-            pSubscriber->TransmitMessage(Channel::AUDIO_OUT, audioExtradata.GetData(), audioExtradata.GetSize());
+            pSubscriber->SetAudioInitID(streamID, initID);
+            pSubscriber->TransmitMessage(Channel::AUDIO_OUT, audioExtradata);
             AMFTraceInfo(AMF_FACILITY, L"OnAudioExtraData: Sent audio init block to client %S at %S for stream %lld, init ID %lld", pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress(), streamID, initID);
             AudioSenderCallback* pASCallback = m_InitParams.GetAudioSenderCallback();
             if (pSubscriber->WaitForAudioInitAck() == false && pASCallback != nullptr)
@@ -917,11 +1044,38 @@ namespace ssdk::transport_amd
         size_t bufSize = buffer->GetSize();
         int64_t sequenceNumber = buf.GetSequenceNumber();
         bool discontinuity = buf.IsDiscontinuity();
-        AudioData audioData(pts, duration, uint32_t(bufSize), sequenceNumber, discontinuity, streamID);
 
-        // Copy audio data to buffer
-        AMFByteArray bufToSend;
-        bufToSend.SetSize(audioData.GetSendSize() + 1 + bufSize);
+        // Collect the previous frames to repeat for loss recovery
+        Subscriber::Ptr pSubscriber = FindSubscriber(m_Sessions[session]);
+        AudioData::RedundantBlocks redundantBlocks;
+        std::vector<uint8_t> redundantPayload;
+        InitID initID = INVALID_INIT_ID;
+        {
+            amf::AMFLock lock(&m_Guard);
+            size_t redundancy = size_t(std::max(m_InitParams.GetAudioRedundancy(), int64_t(0)));
+            if (redundancy > 0)
+            {   //  The client delivers audio data ahead of a lost AudioInit then, the init ID lets it drop such frames
+                initID = pSubscriber != nullptr ? pSubscriber->GetAudioInitID(streamID) : INVALID_INIT_ID;
+                AudioRedundancyHistory& history = m_AudioRedundancy[streamID];
+                history.SetDepth(redundancy);
+                if (discontinuity == true)
+                {
+                    history.Reset();
+                }
+                history.Push(sequenceNumber, pts, duration, buffer->GetNative(), bufSize);
+                AudioRedundancyHistory::Frames frames;
+                history.Collect(sequenceNumber, frames);
+                for (const AudioRedundancyHistory::Frame* frame : frames)
+                {
+                    redundantBlocks.push_back({ frame->sequenceNumber, frame->pts, frame->duration, uint32_t(frame->payload.size()) });
+                    redundantPayload.insert(redundantPayload.end(), frame->payload.begin(), frame->payload.end());
+                }
+            }
+        }
+        AudioData audioData(pts, duration, uint32_t(bufSize), sequenceNumber, discontinuity, streamID, redundantBlocks, initID);
+
+        // Copy audio data to a pooled buffer
+        ssdk::util::BufferPool::Lease bufToSend = ssdk::util::BufferPool::GetInstance().Acquire(audioData.GetSendSize() + 1 + bufSize + redundantPayload.size());
         amf_uint8* dataPtr = bufToSend.GetData();
         memcpy(dataPtr, audioData.GetSendData(), audioData.GetSendSize());
 
@@ -929,16 +1083,19 @@ namespace ssdk::transport_amd
         dataPtr += audioData.GetSendSize();
         *dataPtr++ = 0;
 
-        // Add audio buffer
+        // Add audio buffer followed by the redundant copies
         memcpy(dataPtr, buffer->GetNative(), bufSize);
+        if (redundantPayload.empty() == false)
+        {
+            memcpy(dataPtr + bufSize, redundantPayload.data(), redundantPayload.size());
+        }
 
         // Find subscriber and send audio data to client
         Result result = Result::FAIL;
-        Subscriber::Ptr pSubscriber = FindSubscriber(m_Sessions[session]);
         amf::AMFLock lock(&m_Guard);
         if (pSubscriber != nullptr)
         {
-            result = pSubscriber->TransmitMessage(Channel::AUDIO_OUT, bufToSend.GetData(), bufToSend.GetSize());
+            result = pSubscriber->TransmitMessage(Channel::AUDIO_OUT, bufToSend);
         }
 
         return result;
@@ -961,8 +1118,6 @@ namespace ssdk::transport_amd
 
     Result ServerTransportImpl::SetCursor(const Cursor& cursor)
     {
-        AMFByteArray buff;
-
         bool visible = false;
         bool monochrome = false;
         int width = 0;
@@ -970,6 +1125,8 @@ namespace ssdk::transport_amd
         int pitch = 0;
         AMFPoint hs = {};
         AMFSize screenSize = { 0, 0 };
+        std::vector<amf_uint8> bitmap;
+        uint64_t hash = 0;
 
         // if null is passed in as bitmap, it means the cursor is invisible
         amf::AMFSurfacePtr pCursorBitmap;
@@ -985,31 +1142,65 @@ namespace ssdk::transport_amd
 
             monochrome = (cursor.GetType() == Cursor::Type::MONOCHROME);
             screenSize = cursor.GetServerDisplayResolution();
+
+            bitmap.resize(size_t(pitch) * height);
+            for (int i = 0; i < height; i++)
+            {
+                memcpy(bitmap.data() + (i * pitch), (amf_uint8*)p->GetNative() + (i * p->GetHPitch()), pitch);
+            }
+            if (bitmap.empty() == false)
+            {
+                hash = HashCursorBitmap(bitmap.data(), width, height, pitch, monochrome);
+            }
         }
 
+        // The complete message carries the bitmap after the JSON and is understood by all clients, the cached one only
+        // references the bitmap by its hash and is sent to clients which already have this cursor in their cache
+        CursorData cursorData(width, height, pitch, hs.x, hs.y, screenSize.width, screenSize.height, visible, monochrome, hash, false);
+        //  Both are pooled and shared by all subscribers, the complete one also by the cursor cache
+        ssdk::util::BufferPool& pool = ssdk::util::BufferPool::GetInstance();
+        ssdk::util::BufferPool::Lease fullMsg = pool.Acquire(cursorData.GetSendSize() + 1 + bitmap.size());
+        memcpy(fullMsg.GetData(), cursorData.GetSendData(), cursorData.GetSendSize());
+        fullMsg.GetData()[cursorData.GetSendSize()] = 0;
+        if (bitmap.empty() == false)
         {
-            amf::AMFLock lock(&m_Guard);
-
-            CursorData cursorData(width, height, pitch, hs.x, hs.y, screenSize.width, screenSize.height, visible, monochrome);
-
-            int bitmapSize = pitch * height;
-            buff.SetSize(cursorData.GetSendSize() + 1 + bitmapSize);
-            amf_uint8* dataPtr = buff.GetData();
-            memcpy(dataPtr, cursorData.GetSendData(), cursorData.GetSendSize());
+            memcpy(fullMsg.GetData() + cursorData.GetSendSize() + 1, bitmap.data(), bitmap.size());
+        }
 
-            dataPtr += cursorData.GetSendSize();
-            *dataPtr++ = 0;
+        Subscribers subscribers;
+        {
+            amf::AMFLock lock(&m_Guard);
+            if (hash != 0)
+            {
+                m_CursorMessages.Insert(hash, fullMsg);
+            }
+            subscribers = m_Subscribers;
+        }
 
-            if (bitmapSize > 0)
+        if (hash == 0)
+        {
+            for (Subscribers::iterator it = subscribers.begin(); it != subscribers.end(); it++)
             {
-                amf::AMFPlane* p = pCursorBitmap->GetPlaneAt(0);
-                for (int i = 0; i < p->GetHeight(); i++)
+                it->second->TransmitMessage(Channel::VIDEO_OUT, fullMsg);
+            }
+        }
+        else
+        {
+            CursorData cachedCursorData(width, height, pitch, hs.x, hs.y, screenSize.width, screenSize.height, visible, monochrome, hash, true);
+            ssdk::util::BufferPool::Lease cachedMsg = pool.Acquire(cachedCursorData.GetSendData(), cachedCursorData.GetSendSize());
+            for (Subscribers::iterator it = subscribers.begin(); it != subscribers.end(); it++)
+            {
+                if (it->second->IsCursorCached(hash) == true)
+                {
+                    it->second->TransmitMessage(Channel::VIDEO_OUT, cachedMsg);
+                }
+                else
                 {
-                    memcpy(dataPtr + (i * pitch), (amf_uint8*)p->GetNative() + (i * p->GetHPitch()), pitch);
+                    it->second->TransmitMessage(Channel::VIDEO_OUT, fullMsg);
+                    it->second->SetCursorCached(hash);
                 }
             }
         }
-        TransmitMessageToAllSubscribers(Channel::VIDEO_OUT, buff.GetData(), buff.GetSize());
 
         return Result::OK;
     }
@@ -1033,12 +1224,7 @@ namespace ssdk::transport_amd
         amf::AMFLock lock(&m_Guard);
         CursorData cursorData(0, 0, 0, 0, 0, 0, 0, false, false);
 
-        AMFByteArray buff;
-        buff.SetSize(cursorData.GetSendSize());
-        amf_uint8* dataPtr = buff.GetData();
-        memcpy(dataPtr, cursorData.GetSendData(), cursorData.GetSendSize());
-
-        TransmitMessageToAllSubscribers(Channel::VIDEO_OUT, buff.GetData(), buff.GetSize());
+        TransmitMessageToAllSubscribers(Channel::VIDEO_OUT, cursorData.GetSendData(), cursorData.GetSendSize());
 
         return Result::OK;
     }
@@ -1133,18 +1319,41 @@ namespace ssdk::transport_amd
         return result;
     }
 
+    Result ServerTransportImpl::SetSessionPacing(SessionHandle session, int64_t bitrate)
+    {
+        Subscriber::Ptr pSubscriber;
+        {
+            amf::AMFLock lock(&m_Guard);
+            pSubscriber = FindSubscriber(m_Sessions[session]);
+        }
+        if (pSubscriber == nullptr)
+        {
+            return Result::NOT_FOUND;
+        }
+        return pSubscriber->SetPacingBitrate(bitrate) == true ? Result::OK : Result::FAIL;
+    }
+
     Result ServerTransportImpl::SetSessionSecurity(SessionHandle session, const char* cipherPassphrase)
     {
         amf::AMFLock lock(&m_Guard);
 
-        if (cipherPassphrase != nullptr && m_Ciphers.find(session) == m_Ciphers.end())
+        if (cipherPassphrase != nullptr)
         {
-            m_Ciphers[session] = SessionSecurityParams(ssdk::util::AESPSKCipher::Ptr(new ssdk::util::AESPSKCipher(cipherPassphrase)));
-
-            if (m_SessionMonitor.IsRunning() == false)
+            SessionToCipherMap::iterator it = m_Ciphers.find(session);
+            if (it == m_Ciphers.end())
+            {
+                it = m_Ciphers.emplace(session, SessionSecurityParams(ssdk::util::AESPSKCipher::Ptr(new ssdk::util::AESPSKCipher(cipherPassphrase)))).first;
+            }
+            else
             {
-                m_SessionMonitor.Start();
+                m_Timers.Cancel(it->second.GetExpiryTimer());
             }
+            // The session gets SUBSCRIBER_CONNECTION_TIMEOUT from the latest call to subscribe. A cancelled timer may already
+            // be on its way, so the callback passes on its own ID and only the timer armed last expires the cipher
+            std::shared_ptr<net::TimerWheel::TimerID> pTimer = std::make_shared<net::TimerWheel::TimerID>(net::TimerWheel::INVALID_TIMER);
+            *pTimer = m_Timers.Schedule(SUBSCRIBER_CONNECTION_TIMEOUT * AMF_SECOND, [this, session, pTimer]() { ExpireSessionSecurity(session, *pTimer); });
+            it->second.SetExpiryTimer(*pTimer);
+            m_Timers.Start();
         }
         return Result::OK;
     }
@@ -1376,7 +1585,7 @@ namespace ssdk::transport_amd
         }
     }
 
-    transport_common::Result ServerTransportImpl::OnFillOptions(bool /*discovery*/, Session* /*session*/, HelloResponse::Options* options)
+    transport_common::Result ServerTransportImpl::OnFillOptions(bool discovery, Session* session, HelloResponse::Options* options)
     {
         amf::JSONParser::Ptr parser;
         CreateJSONParser(&parser);
@@ -1390,10 +1599,196 @@ namespace ssdk::transport_amd
         FillStreamDeclarations(parser, options);
 
         options->SetBool("Cipher", m_Ciphers.size() > 0);
+        if (m_InitParams.GetAudioRedundancy() > 0)
+        {   //  Tells the client that audio data messages need not wait out gaps, see AudioRedundancy.h
+            options->SetUInt32(OPTION_AUDIO_REDUNDANCY, uint32_t(m_InitParams.GetAudioRedundancy()));
+        }
+
+        if (discovery == false && session != nullptr)
+        {
+            ChallengeResumeTicket(session, options);
+        }
 
         return Result::OK;
     }
 
+    void ServerTransportImpl::ChallengeResumeTicket(Session* session, HelloResponse::Options* options)
+    {
+        Subscriber::Ptr pSubscriber = FindSubscriber(session);
+        if (pSubscriber == nullptr)
+        {
+            return;
+        }
+        ssdk::util::AESPSKCipher::Ptr pCipher;
+        pSubscriber->GetCipher(&pCipher);
+        if (pCipher == nullptr)
+        {   // The ticket's secret can only be handed over encrypted
+            return;
+        }
+
+        // HELLO is repeated until the client receives the response, answer every repetition with the same challenge
+        std::string challenge;
+        if (pSubscriber->GetResumeChallenge(&challenge) == true)
+        {
+            options->SetString(OPTION_RESUME_CHALLENGE, challenge);
+            return;
+        }
+        if (pSubscriber->GetResumeTicket().empty() == false)
+        {
+            return;
+        }
+
+        // The ticket ID came in the clear, nothing is restored or disconnected until the client proves it holds the ticket's secret
+        amf::AMFPropertyStoragePtr sessionProperties(session);
+        amf::AMFVariant presentedTicket;
+        if (sessionProperties != nullptr && sessionProperties->GetProperty(ID_RESUME_TICKET, &presentedTicket) == AMF_OK &&
+            presentedTicket.type == amf::AMF_VARIANT_STRING && presentedTicket.ToString().c_str()[0] != '\0')
+        {
+            std::string ticket = presentedTicket.ToString().c_str();
+            if (m_ResumptionCache.IsRedeemable(ticket, pSubscriber->GetID()) == true)
+            {
+                challenge = MakeResumeChallenge();
+                pSubscriber->SetResumeChallenge(ticket, challenge);
+                options->SetString(OPTION_RESUME_CHALLENGE, challenge);
+            }
+            else
+            {
+                AMFTraceInfo(AMF_FACILITY, L"Resume ticket presented by client %S at %S is not valid, starting a new session", pSubscriber->GetID(), session->GetPeerUrl());
+            }
+        }
+    }
+
+    void ServerTransportImpl::OnServiceResume(Session* session, const void* msg, size_t len, Subscriber::Ptr pSubscriber)
+    {
+        ResumeMessage request;
+        std::string ticket;
+        std::string challenge;
+        if (request.ParseBuffer(msg, len) == false || request.IsRequest() == false)
+        {
+            AMFTraceError(AMF_FACILITY, L"OnServiceResume - invalid resume request from %S", pSubscriber->GetSubscriberIPAddress());
+            return;
+        }
+        if (pSubscriber->TakeResumeChallenge(&ticket, &challenge) == false || ticket != request.GetTicket())
+        {
+            AMFTraceWarning(AMF_FACILITY, L"OnServiceResume - unsolicited resume request from %S at %S", pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress());
+            return;
+        }
+
+        SessionHandle hSession = session->GetSessionHandle();
+        SessionHandle hPreviousSession = INVALID_SESSION_HANDLE;
+        ResumptionState::Ptr pState = m_ResumptionCache.Redeem(ticket, pSubscriber->GetID(), challenge, request.GetProof(), &hPreviousSession);
+        if (pState == nullptr)
+        {
+            AMFTraceWarning(AMF_FACILITY, L"Client %S at %S failed to prove it holds the resume ticket, starting a new session", pSubscriber->GetID(), session->GetPeerUrl());
+            ssdk::util::AESPSKCipher::Ptr pCipher;
+            pSubscriber->GetCipher(&pCipher);
+            SendResumeTicket(session, pSubscriber, ResumptionState::Ptr(new ResumptionState(pSubscriber->GetID(), pCipher)), false);
+            return;
+        }
+
+        // The previous session is still there when the client moved to another network before it timed out
+        if (hPreviousSession != INVALID_SESSION_HANDLE && IsSessionActive(hPreviousSession) == true)
+        {
+            AMFTraceInfo(AMF_FACILITY, L"Session %lld is replaced by resumed session %lld", hPreviousSession, hSession);
+            Disconnect(hPreviousSession);
+        }
+        ssdk::util::AESPSKCipher::Ptr pCipher = pState->GetCipher();
+        if (pCipher != nullptr)
+        {
+            amf::AMFLock lock(&m_Guard);
+            SessionToCipherMap::iterator itCipher = m_Ciphers.find(hSession);
+            if (itCipher != m_Ciphers.end())
+            {
+                m_Timers.Cancel(itCipher->second.GetExpiryTimer());     // The session has subscribed, its cipher does not expire
+            }
+            m_Ciphers[hSession] = SessionSecurityParams(pCipher);
+            pSubscriber->SetCipher(pCipher);
+        }
+        pSubscriber->SetResumed();
+        AMFTraceInfo(AMF_FACILITY, L"Session %lld of client %S at %S resumed", hSession, pSubscriber->GetID(), session->GetPeerUrl());
+
+        // The client learns it was resumed before the replayed inits arrive
+        SendResumeTicket(session, pSubscriber, pState, true);
+        RestoreSubscriptions(session, pSubscriber, pState);
+    }
+
+    void ServerTransportImpl::SendResumeTicket(Session* session, Subscriber::Ptr pSubscriber, ResumptionState::Ptr pState, bool resumed)
+    {
+        std::string secret;
+        std::string ticket = m_ResumptionCache.Issue(session->GetSessionHandle(), pState, &secret);
+        pSubscriber->SetResumptionState(pState);
+        pSubscriber->SetResumeTicket(ticket);
+
+        ResumeMessage response(ticket, secret, resumed);
+        pSubscriber->TransmitMessage(Channel::SERVICE, response.GetSendData(), response.GetSendSize());
+    }
+
+    void ServerTransportImpl::RestoreSubscriptions(Session* session, Subscriber::Ptr pSubscriber, ResumptionState::Ptr pState)
+    {
+        // The cached init messages go out right behind the HELLO response, the application is told about the subscription
+        // as if the client had sent START and does not need to produce the init blocks again
+        SessionHandle hSession = session->GetSessionHandle();
+        VideoSenderCallback* pVSCallback = m_InitParams.GetVideoSenderCallback();
+        AudioSenderCallback* pASCallback = m_InitParams.GetAudioSenderCallback();
+
+        ResumptionState::Streams streams = pState->GetStreams(Channel::VIDEO_OUT);
+        for (ResumptionState::Streams::const_iterator it = streams.begin(); it != streams.end(); ++it)
+        {
+            const ResumptionState::Stream& stream = it->second;
+            pSubscriber->WaitForVideoInitAck(stream.m_InitAckRequired);
+            if (stream.m_InitMessage.empty() == false)
+            {
+                pSubscriber->SetVideoInitSentTime(amf_high_precision_clock());
+                pSubscriber->WaitForIDR(true);
+                pSubscriber->SetInitReplayed(Channel::VIDEO_OUT, it->first);
+                pSubscriber->TransmitMessage(Channel::VIDEO_OUT, stream.m_InitMessage.data(), stream.m_InitMessage.size());
+            }
+            if (pVSCallback != nullptr)
+            {
+                pVSCallback->OnVideoStreamSubscribed(hSession, it->first);
+                if (stream.m_InitMessage.empty() == false && stream.m_InitAckRequired == false)
+                {
+                    pVSCallback->OnReadyToReceiveVideo(hSession, it->first, stream.m_InitID);
+                }
+            }
+            AMFTraceInfo(AMF_FACILITY, L"RestoreSubscriptions: Restored video stream %lld for client %S at %S, init ID %lld", it->first, pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress(), stream.m_InitID);
+        }
+
+        streams = pState->GetStreams(Channel::AUDIO_OUT);
+        for (ResumptionState::Streams::const_iterator it = streams.begin(); it != streams.end(); ++it)
+        {
+            const ResumptionState::Stream& stream = it->second;
+            pSubscriber->WaitForAudioInitAck(stream.m_InitAckRequired);
+            if (stream.m_InitMessage.empty() == false)
+            {
+                pSubscriber->SetAudioInitSentTime(amf_high_precision_clock());
+                pSubscriber->SetAudioInitID(it->first, stream.m_InitID);
+                pSubscriber->SetInitReplayed(Channel::AUDIO_OUT, it->first);
+                pSubscriber->TransmitMessage(Channel::AUDIO_OUT, stream.m_InitMessage.data(), stream.m_InitMessage.size());
+            }
+            if (pASCallback != nullptr)
+            {
+                pASCallback->OnAudioStreamSubscribed(hSession, it->first);
+                if (stream.m_InitMessage.empty() == false && stream.m_InitAckRequired == false)
+                {
+                    pASCallback->OnReadyToReceiveAudio(hSession, it->first, stream.m_InitID);
+                }
+            }
+            AMFTraceInfo(AMF_FACILITY, L"RestoreSubscriptions: Restored audio stream %lld for client %S at %S, init ID %lld", it->first, pSubscriber->GetID(), pSubscriber->GetSubscriberIPAddress(), stream.m_InitID);
+        }
+    }
+
+    void ServerTransportImpl::ReleaseResumeTicket(Subscriber::Ptr pSubscriber)
+    {
+        std::string ticket = pSubscriber->GetResumeTicket();
+        if (ticket.empty() == false)
+        {
+            m_ResumptionCache.Release(ticket, RESUME_TICKET_LIFETIME * AMF_SECOND);
+            m_Timers.Schedule(RESUME_TICKET_LIFETIME * AMF_SECOND, [this]() { m_ResumptionCache.Expire(); });
+            m_Timers.Start();
+        }
+    }
+
     transport_common::Result ServerTransportImpl::OnDiscovery(Session* /*session*/)
     {
         //todo
@@ -1406,6 +1801,22 @@ namespace ssdk::transport_amd
         return Result::OK;
     }
 
+    void ServerTransportImpl::OnConnectionAccepted(Session* session)
+    {
+        //  Sessions which presented a ticket get theirs once they answer the challenge, see OnServiceResume()
+        Subscriber::Ptr pSubscriber = FindSubscriber(session);
+        std::string challenge;
+        if (pSubscriber != nullptr && pSubscriber->GetResumeTicket().empty() == true && pSubscriber->GetResumeChallenge(&challenge) == false)
+        {
+            ssdk::util::AESPSKCipher::Ptr pCipher;
+            pSubscriber->GetCipher(&pCipher);
+            if (pCipher != nullptr)
+            {
+                SendResumeTicket(session, pSubscriber, ResumptionState::Ptr(new ResumptionState(pSubscriber->GetID(), pCipher)), false);
+            }
+        }
+    }
+
     bool ServerTransportImpl::AuthorizeDiscoveryRequest(Session* session, const char* deviceID)
     {
         bool result = true;
@@ -1510,6 +1921,10 @@ namespace ssdk::transport_amd
             {
                 Subscriber::Ptr pSubscriber(new Subscriber(session, m_pContext));
                 pSubscriber->SetCipher(FindCipherForSession(session->GetSessionHandle()));
+                if (m_InitParams.GetSendQueueDepth() > 0)
+                {
+                    pSubscriber->EnableSendQueue(size_t(m_InitParams.GetSendQueueDepth()), m_InitParams.GetSendQueueMaxAge());
+                }
 
                 result = AddSubscriber(session, pSubscriber);
                 session->RegisterReceiverCallback(this);
@@ -1546,6 +1961,7 @@ namespace ssdk::transport_amd
     {
         ConnectionManagerCallback* pCMCallback = nullptr;
         SessionHandle hSession = session->GetSessionHandle();
+        Subscriber::Ptr pSubscriber;
         bool result = false;
         {
             amf::AMFLock lock(&m_Guard);
@@ -1553,13 +1969,17 @@ namespace ssdk::transport_amd
             Subscribers::iterator it = m_Subscribers.find(session);
             if (it != m_Subscribers.end())
             {
-                Subscriber::Ptr pSubscriber = it->second;
+                pSubscriber = it->second;
                 m_Subscribers.erase(it);
 
                 pCMCallback = m_InitParams.GetConnectionManagerCallback();
                 result = true;
             }
         }
+        if (pSubscriber != nullptr)
+        {
+            ReleaseResumeTicket(pSubscriber);
+        }
         if (pCMCallback != nullptr)
         {
             pCMCallback->OnClientDisconnected(hSession, reason == TerminationReason::DISCONNECT ? ConnectionManagerCallback::DisconnectReason::CLIENT_DISCONNECTED : ConnectionManagerCallback::DisconnectReason::TIMEOUT);
@@ -1581,28 +2001,19 @@ namespace ssdk::transport_amd
     }
 
     //-------------------------------------------------------------------------------------------------
-    void ServerTransportImpl::CleanupExpiredSessionIDs()
+    void ServerTransportImpl::ExpireSessionSecurity(SessionHandle session, net::TimerWheel::TimerID timer)
     {
-        time_t now = time(nullptr);
         amf::AMFLock lock(&m_Guard);
-        for (SessionToCipherMap::iterator it = m_Ciphers.begin(); it != m_Ciphers.end(); ++it)
+        SessionToCipherMap::iterator it = m_Ciphers.find(session);
+        if (it != m_Ciphers.end() && it->second.GetExpiryTimer() == timer)
         {
-            if (it->second.GetCreationTime() - now > SUBSCRIBER_CONNECTION_TIMEOUT)
+            Sessions::const_iterator itSession = m_Sessions.find(session);
+            if (itSession == m_Sessions.end() || FindSubscriber(itSession->second) == nullptr)
             {
-                AMFTraceInfo(AMF_FACILITY, L"Stale session %d has expired", it->first);
+                AMFTraceInfo(AMF_FACILITY, L"Stale session %lld has expired", static_cast<int64_t>(session));
                 m_Ciphers.erase(it);
-                it = m_Ciphers.begin();
             }
         }
     }
-    //-------------------------------------------------------------------------------------------------
-    void ServerTransportImpl::ExpiredSessionMonitor::Run()
-    {
-        while (StopRequested() == true)
-        {
-            m_Object.CleanupExpiredSessionIDs();
-            amf_sleep(50);
-        }
-    }
 
 } // namespace ssdk::transport_amd
@@ -46,8 +46,13 @@ THE SOFTWARE.
 #include "amf/public/common/Thread.h"
 #include "TransportServerImpl.h"
 #include "Subscriber.h"
+#include "CursorCache.h"
+#include "AudioRedundancy.h"
+#include "SessionResumption.h"
+#include "net/TimerWheel.h"
 
 #include <unordered_map>
+#include <vector>
 
 namespace ssdk::transport_amd
 {
@@ -94,6 +99,48 @@ namespace ssdk::transport_amd
             inline const std::string& GetPassphrase() const noexcept { return m_cipherPassphrase; }
             inline void SetPassphrase(const std::string& cipherPassphrase) noexcept { m_cipherPassphrase = cipherPassphrase; }
 
+            //  See net::NetworkImpairment for the format, empty disables the impairment
+            inline const std::string& GetNetworkImpairment() const noexcept { return m_NetworkImpairment; }
+            inline void SetNetworkImpairment(const std::string& networkImpairment) noexcept { m_NetworkImpairment = networkImpairment; }
+
+            //  Unix domain socket for same-host clients connecting with local://<path>, empty disables it. Linux only
+            inline const std::string& GetLocalSocketPath() const noexcept { return m_LocalSocketPath; }
+            inline void SetLocalSocketPath(const std::string& localSocketPath) noexcept { m_LocalSocketPath = localSocketPath; }
+
+            //  Number of UDP sockets sharing the port, each received on its own thread, see DATAGRAM_RECEIVE_SHARDS. Linux only
+            inline int64_t GetReceiveShards() const noexcept { return m_ReceiveShards; }
+            inline void SetReceiveShards(int64_t receiveShards) noexcept { m_ReceiveShards = receiveShards; }
+
+            //  Peak bitrate and frame rate the socket buffers are sized for, see net::SocketTuning. A bitrate of 0 keeps the default size
+            inline int64_t GetSocketMaxBitrate() const noexcept { return m_SocketMaxBitrate; }
+            inline void SetSocketMaxBitrate(int64_t maxBitrate) noexcept { m_SocketMaxBitrate = maxBitrate; }
+            inline int64_t GetSocketFrameRate() const noexcept { return m_SocketFrameRate; }
+            inline void SetSocketFrameRate(int64_t frameRate) noexcept { m_SocketFrameRate = frameRate; }
+
+            //  SO_BUSY_POLL in microseconds, 0 disables. Linux only
+            inline int64_t GetSocketBusyPoll() const noexcept { return m_SocketBusyPoll; }
+            inline void SetSocketBusyPoll(int64_t busyPoll) noexcept { m_SocketBusyPoll = busyPoll; }
+
+            //  Receive and send datagrams through io_uring, falls back to select() when the kernel does not support it. Linux only
+            inline bool GetIoUring() const noexcept { return m_IoUring; }
+            inline void SetIoUring(bool ioUring) noexcept { m_IoUring = ioUring; }
+
+            //  Mark video with DSCP AF41 and audio and input with EF, see DATAGRAM_DSCP_MARKING
+            inline bool GetDscpMarking() const noexcept { return m_DscpMarking; }
+            inline void SetDscpMarking(bool dscpMarking) noexcept { m_DscpMarking = dscpMarking; }
+
+            //  Video and audio are queued per client and sent from a dedicated thread, see SendQueue.h. 0 sends them synchronously
+            inline int64_t GetSendQueueDepth() const noexcept { return m_SendQueueDepth; }
+            inline void SetSendQueueDepth(int64_t sendQueueDepth) noexcept { m_SendQueueDepth = sendQueueDepth; }
+
+            //  Queued non-reference frames older than this are dropped, a new key frame replaces older queued frames
+            inline amf_pts GetSendQueueMaxAge() const noexcept { return m_SendQueueMaxAge; }
+            inline void SetSendQueueMaxAge(amf_pts sendQueueMaxAge) noexcept { m_SendQueueMaxAge = sendQueueMaxAge; }
+
+            //  Number of previous audio frames repeated in every audio message for loss recovery, see AudioRedundancy.h. 0 disables redundancy
+            inline int64_t GetAudioRedundancy() const noexcept { return m_AudioRedundancy; }
+            inline void SetAudioRedundancy(int64_t audioRedundancy) noexcept { m_AudioRedundancy = audioRedundancy; }
+
         protected:
             amf::AMFContextPtr  m_pContext;
             bool                m_bNetwork{ true };
@@ -104,6 +151,17 @@ namespace ssdk::transport_amd
             std::string         m_HostName{ "" };
             int64_t             m_AppInitTime{};
             std::string         m_cipherPassphrase;
+            std::string         m_NetworkImpairment;
+            std::string         m_LocalSocketPath;
+            int64_t             m_ReceiveShards{ 1 };
+            int64_t             m_SocketMaxBitrate{ 0 };
+            int64_t             m_SocketFrameRate{ 60 };
+            int64_t             m_SocketBusyPoll{ 0 };
+            bool                m_IoUring{ false };
+            bool                m_DscpMarking{ true };
+            int64_t             m_SendQueueDepth{ 64 };
+            amf_pts             m_SendQueueMaxAge{ 100 * AMF_MILLISECOND };
+            int64_t             m_AudioRedundancy{ 0 };
         };
 
         ServerTransportImpl();
@@ -146,6 +204,7 @@ namespace ssdk::transport_amd
         virtual Result SendApplicationMessage(SessionHandle session, const void* msg, size_t size) override;
 
         virtual Result SetSessionSecurity(SessionHandle session, const char* cipherPassphrase) override; // When cipher is not set or set to nullptr, no encryption is used
+        virtual Result SetSessionPacing(SessionHandle session, int64_t bitrate) override;               // Delays video in the session's send queue, FAIL when send queues are disabled
 
         // ReceiverCallback interface
         virtual void OnMessageReceived(Session* session, Channel channel, int msgID, const void* message, size_t messageSize) override;
@@ -159,6 +218,7 @@ namespace ssdk::transport_amd
         virtual transport_common::Result AMF_STD_CALL OnClientConnected(Session* session) override;
         virtual bool                     AMF_STD_CALL AuthorizeDiscoveryRequest(Session* session, const char* deviceID) override;
         virtual bool                     AMF_STD_CALL AuthorizeConnectionRequest(Session* session, const char* deviceID) override;
+        virtual void                     AMF_STD_CALL OnConnectionAccepted(Session* session) override;
 
 
     protected:
@@ -166,6 +226,8 @@ namespace ssdk::transport_amd
         void OnServiceStop(Session* session);
         void OnServiceUpdate(Session* session, const void* msg, size_t len, Subscriber::Ptr pSubscriber);
         void OnServiceStatLatency(Session* session, const void* msg, size_t len);
+        void OnServiceClockSync(const void* msg, size_t len, amf_pts receiveTime, Subscriber::Ptr pSubscriber);
+        void OnServiceResume(Session* session, const void* msg, size_t len, Subscriber::Ptr pSubscriber);
         void StopStreaming();
         void OnServiceMessage(Session* session, uint8_t opcode, const void* msg, size_t len, Subscriber::Ptr pSubscriber);
         void OnSensorsInMessage(Session* session, uint8_t opcode, const void* msg, size_t len, Subscriber::Ptr pSubscriber);
@@ -173,6 +235,7 @@ namespace ssdk::transport_amd
         void OnAudioOutMessage(Session* session, uint8_t opcode, const void* msg, size_t len, Subscriber::Ptr pSubscriber);
         void ProcessMessage(Session* session, Channel channel, int msgID, const void* message, size_t messageSize, Subscriber::Ptr pSubscriber);
         void TransmitMessageToAllSubscribers(Channel channel, const void* msg, size_t msgLen);
+        void TransmitMessageToAllSubscribers(Channel channel, const ssdk::util::BufferPool::Lease& msg);
 
         bool Decrypt(amf::AMFContextPtr pContext, ssdk::util::AESPSKCipher::Ptr pCipher, Session* session, Channel channel, int msgID,
                      const void* message, size_t messageSize, Subscriber::Ptr pSubscriber);
@@ -183,10 +246,15 @@ namespace ssdk::transport_amd
         bool DeleteSubscriber(Session* session, TerminationReason reason);
 
         ssdk::util::AESPSKCipher::Ptr FindCipherForSession(SessionHandle session);
-        void CleanupExpiredSessionIDs();
+        void ExpireSessionSecurity(SessionHandle session, net::TimerWheel::TimerID timer);
 
         void ForceKeyFrame(Session* session, const void* msg, size_t len, Subscriber::Ptr pSubscriber);
 
+        void ChallengeResumeTicket(Session* session, HelloResponse::Options* options);
+        void SendResumeTicket(Session* session, Subscriber::Ptr pSubscriber, ResumptionState::Ptr pState, bool resumed);
+        void RestoreSubscriptions(Session* session, Subscriber::Ptr pSubscriber, ResumptionState::Ptr pState);
+        void ReleaseResumeTicket(Subscriber::Ptr pSubscriber);
+
         void FillLegacyOptions(amf::JSONParser* parser, HelloResponse::Options* options);
         void FillStreamDeclarations(amf::JSONParser* parser, HelloResponse::Options* options);
 
@@ -199,25 +267,21 @@ namespace ssdk::transport_amd
 
             ssdk::util::AESPSKCipher::Ptr GetCipher() const { return m_pCipher; }
             time_t GetCreationTime() const { return m_CreationTime; }
+            net::TimerWheel::TimerID GetExpiryTimer() const { return m_ExpiryTimer; }
+            void SetExpiryTimer(net::TimerWheel::TimerID timer) { m_ExpiryTimer = timer; }
         private:
             ssdk::util::AESPSKCipher::Ptr m_pCipher;
             time_t m_CreationTime;
+            net::TimerWheel::TimerID m_ExpiryTimer = net::TimerWheel::INVALID_TIMER;    // Only the timer armed last may expire the cipher
         };
         typedef std::map<SessionHandle, SessionSecurityParams> SessionToCipherMap;
         SessionToCipherMap m_Ciphers;
 
-        // Session monitor thread classe
-        class ExpiredSessionMonitor : public amf::AMFThread
-        {
-        public:
-            ExpiredSessionMonitor(ServerTransportImpl& obj) : m_Object(obj) {}
-
-            virtual void Run() override;
+        // Housekeeping timers, such as expiry of the security parameters of sessions that never connected
+        net::TimerService m_Timers;
 
-        private:
-            ServerTransportImpl& m_Object;
-        };
-        ExpiredSessionMonitor m_SessionMonitor;
+        // Tickets issued to connected clients, see SessionResumption.h
+        ResumptionCache m_ResumptionCache;
 
     private:
         typedef std::map<Session*, Subscriber::Ptr> Subscribers;
@@ -242,5 +306,7 @@ namespace ssdk::transport_amd
         amf_pts                         m_AverageSensorProcTime = 0;
         amf_pts                         m_LastSensorTime = 0;
         amf_int64                       m_SensorDataCount = 0;
+        CursorCache<ssdk::util::BufferPool::Lease> m_CursorMessages{ size_t(DEFAULT_CURSOR_CACHE_SIZE) };    // complete cursor messages to answer cache misses
+        std::map<StreamID, AudioRedundancyHistory> m_AudioRedundancy;                                  // recent audio frames per stream, repeated in following audio messages
     }; // class ServerTransportImpl
 } // namespace ssdk::transport_amd
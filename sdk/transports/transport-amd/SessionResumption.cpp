@@ -0,0 +1,222 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "SessionResumption.h"
+#include "mbedtls/include/mbedtls/md.h"
+
+#include <cstring>
+#include <random>
+
+namespace ssdk::transport_amd
+{
+    static constexpr const char HEX_DIGITS[] = "0123456789abcdef";
+
+    //  Ticket IDs, secrets and challenges come from the system's entropy source rather than a seeded generator
+    static std::string MakeRandomToken()
+    {
+        static constexpr const size_t TOKEN_WORDS = 4;      // 128 bits
+
+        std::random_device entropy;
+        std::string token;
+        token.reserve(TOKEN_WORDS * 8);
+        for (size_t i = 0; i < TOKEN_WORDS; ++i)
+        {
+            uint32_t word = entropy();
+            for (size_t nibble = 0; nibble < 8; ++nibble, word >>= 4)
+            {
+                token += HEX_DIGITS[word & 0xF];
+            }
+        }
+        return token;
+    }
+
+    //  Takes the same time wherever the strings differ, so that a forged proof cannot be guessed byte by byte
+    static bool ConstantTimeEquals(const std::string& a, const std::string& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        uint8_t diff = 0;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            diff |= uint8_t(a[i] ^ b[i]);
+        }
+        return diff == 0;
+    }
+
+    std::string MakeResumeChallenge()
+    {
+        return MakeRandomToken();
+    }
+
+    std::string ComputeResumeProof(const std::string& secret, const std::string& challenge, const char* deviceID)
+    {
+        std::string input = challenge + (deviceID != nullptr ? deviceID : "");
+        uint8_t mac[32];
+        if (mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), reinterpret_cast<const uint8_t*>(secret.data()), secret.size(),
+                            reinterpret_cast<const uint8_t*>(input.data()), input.size(), mac) != 0)
+        {
+            return "";
+        }
+        std::string proof;
+        proof.reserve(sizeof(mac) * 2);
+        for (uint8_t byte : mac)
+        {
+            proof += HEX_DIGITS[byte >> 4];
+            proof += HEX_DIGITS[byte & 0xF];
+        }
+        return proof;
+    }
+
+    ResumptionState::ResumptionState(const char* deviceID, ssdk::util::AESPSKCipher::Ptr pCipher) :
+        m_DeviceID(deviceID != nullptr ? deviceID : ""),
+        m_pCipher(pCipher)
+    {
+    }
+
+    void ResumptionState::Subscribe(Channel channel, transport_common::StreamID streamID, bool initAckRequired)
+    {
+        amf::AMFLock lock(&m_Guard);
+        Streams& streams = channel == Channel::VIDEO_OUT ? m_VideoStreams : m_AudioStreams;
+        streams[streamID].m_InitAckRequired = initAckRequired;
+    }
+
+    void ResumptionState::SetInit(Channel channel, transport_common::StreamID streamID, transport_common::InitID initID, const void* msg, size_t msgLen)
+    {
+        amf::AMFLock lock(&m_Guard);
+        Streams& streams = channel == Channel::VIDEO_OUT ? m_VideoStreams : m_AudioStreams;
+        Streams::iterator it = streams.find(streamID);
+        if (it != streams.end())    // Only the streams the client subscribed to are restored
+        {
+            it->second.m_InitID = initID;
+            it->second.m_InitMessage.assign(static_cast<const uint8_t*>(msg), static_cast<const uint8_t*>(msg) + msgLen);
+        }
+    }
+
+    ResumptionState::Streams ResumptionState::GetStreams(Channel channel) const
+    {
+        amf::AMFLock lock(&m_Guard);
+        return channel == Channel::VIDEO_OUT ? m_VideoStreams : m_AudioStreams;
+    }
+
+    bool ResumptionState::IsInitCached(Channel channel, transport_common::StreamID streamID, const void* msg, size_t msgLen) const
+    {
+        amf::AMFLock lock(&m_Guard);
+        const Streams& streams = channel == Channel::VIDEO_OUT ? m_VideoStreams : m_AudioStreams;
+        Streams::const_iterator it = streams.find(streamID);
+        return it != streams.end() && it->second.m_InitMessage.size() == msgLen &&
+               (msgLen == 0 || memcmp(it->second.m_InitMessage.data(), msg, msgLen) == 0);
+    }
+
+    std::string ResumptionCache::Issue(transport_common::SessionHandle session, ResumptionState::Ptr pState, std::string* secret)
+    {
+        std::string ticket = MakeRandomToken();
+        *secret = MakeRandomToken();
+
+        amf::AMFLock lock(&m_Guard);
+        Ticket& entry = m_Tickets[ticket];
+        entry.m_Session = session;
+        entry.m_pState = pState;
+        entry.m_Secret = *secret;
+        entry.m_ExpiryTime = 0;
+        return ticket;
+    }
+
+    bool ResumptionCache::IsValid(const Ticket& entry, const char* deviceID) const
+    {
+        bool expired = entry.m_ExpiryTime != 0 && amf_high_precision_clock() >= entry.m_ExpiryTime;
+        return expired == false && entry.m_pState->GetDeviceID() == (deviceID != nullptr ? deviceID : "");
+    }
+
+    bool ResumptionCache::IsRedeemable(const std::string& ticket, const char* deviceID) const
+    {
+        amf::AMFLock lock(&m_Guard);
+        Tickets::const_iterator it = m_Tickets.find(ticket);
+        return it != m_Tickets.end() && IsValid(it->second, deviceID) == true;
+    }
+
+    ResumptionState::Ptr ResumptionCache::Redeem(const std::string& ticket, const char* deviceID, const std::string& challenge, const std::string& proof,
+                                                 transport_common::SessionHandle* previousSession)
+    {
+        ResumptionState::Ptr pState;
+        transport_common::SessionHandle session = transport_common::INVALID_SESSION_HANDLE;
+        {
+            amf::AMFLock lock(&m_Guard);
+            Tickets::iterator it = m_Tickets.find(ticket);
+            if (it != m_Tickets.end())
+            {
+                const Ticket& entry = it->second;
+                if (IsValid(entry, deviceID) == true && proof.empty() == false && ConstantTimeEquals(ComputeResumeProof(entry.m_Secret, challenge, deviceID), proof) == true)
+                {
+                    pState = entry.m_pState;
+                    session = entry.m_ExpiryTime == 0 ? entry.m_Session : transport_common::INVALID_SESSION_HANDLE;
+                }
+                m_Tickets.erase(it);    // A failed attempt burns the ticket as well
+            }
+        }
+        if (previousSession != nullptr)
+        {
+            *previousSession = session;
+        }
+        return pState;
+    }
+
+    void ResumptionCache::Release(const std::string& ticket, amf_pts lifetime)
+    {
+        amf::AMFLock lock(&m_Guard);
+        Tickets::iterator it = m_Tickets.find(ticket);
+        if (it != m_Tickets.end())
+        {
+            it->second.m_ExpiryTime = amf_high_precision_clock() + lifetime;
+        }
+    }
+
+    void ResumptionCache::Expire()
+    {
+        amf_pts now = amf_high_precision_clock();
+        amf::AMFLock lock(&m_Guard);
+        for (Tickets::iterator it = m_Tickets.begin(); it != m_Tickets.end();)
+        {
+            it = (it->second.m_ExpiryTime != 0 && now >= it->second.m_ExpiryTime) ? m_Tickets.erase(it) : std::next(it);
+        }
+    }
+
+    void ResumptionCache::Clear()
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_Tickets.clear();
+    }
+}
@@ -0,0 +1,145 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include "Channels.h"
+#include "transports/transport-common/Transport.h"
+#include "util/encryption/AESPSKCipher.h"
+#include "amf/public/common/Thread.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ssdk::transport_amd
+{
+    // Session resumption lets a client which lost its connection, for instance after a Wi-Fi roam, get back to streaming without
+    // subscribing, waiting for the application to produce the codec init blocks and deriving the cipher key again:
+    // 1. Once a session is established the server sends the client a ticket ID and a secret in an encrypted ResumeMessage.
+    // 2. The client presents the ticket ID with the HELLO of its next connection. The ID alone proves nothing, HELLO is not encrypted.
+    // 3. The server answers with a random challenge in the HELLO response.
+    // 4. The client proves it holds the secret with an encrypted ResumeMessage carrying HMAC-SHA256(secret, challenge + device ID).
+    // 5. Only then does the server disconnect the previous session if it is still there, restore the subscriptions, replay the cached
+    //    VideoInit/AudioInit messages and send the ticket for the next connection.
+    // Resumption needs encryption, without a passphrase no tickets are issued.
+    static constexpr const wchar_t* ID_RESUME_TICKET = L"ANS_ResumeTicket";     // string, HELLO option, ID of the ticket received from the server
+    static constexpr const char* OPTION_RESUME_CHALLENGE = "ResumeChallenge";    // string, HELLO response option, present when the ticket ID is known
+
+    std::string MakeResumeChallenge();
+    std::string ComputeResumeProof(const std::string& secret, const std::string& challenge, const char* deviceID);
+
+    //----------------------------------------------------------------------------------------------
+    // ResumptionState - what a session has negotiated since it connected. Shared by the subscriber, which keeps it up to date,
+    // and the ticket issued for it, which keeps it alive after the session is gone.
+    //----------------------------------------------------------------------------------------------
+    class ResumptionState
+    {
+    public:
+        typedef std::shared_ptr<ResumptionState> Ptr;
+
+        struct Stream
+        {
+            bool                        m_InitAckRequired = false;
+            transport_common::InitID    m_InitID = transport_common::INVALID_INIT_ID;
+            std::vector<uint8_t>        m_InitMessage;      // Complete INIT message including the init block, empty until one was sent
+        };
+        typedef std::map<transport_common::StreamID, Stream> Streams;
+
+    public:
+        ResumptionState(const char* deviceID, ssdk::util::AESPSKCipher::Ptr pCipher);
+
+        inline const std::string& GetDeviceID() const noexcept { return m_DeviceID; }
+        inline ssdk::util::AESPSKCipher::Ptr GetCipher() const noexcept { return m_pCipher; }
+
+        // channel is either Channel::VIDEO_OUT or Channel::AUDIO_OUT
+        void Subscribe(Channel channel, transport_common::StreamID streamID, bool initAckRequired);
+        void SetInit(Channel channel, transport_common::StreamID streamID, transport_common::InitID initID, const void* msg, size_t msgLen);
+        Streams GetStreams(Channel channel) const;
+        bool IsInitCached(Channel channel, transport_common::StreamID streamID, const void* msg, size_t msgLen) const;
+
+    private:
+        mutable amf::AMFCriticalSection m_Guard;
+        std::string                     m_DeviceID;
+        ssdk::util::AESPSKCipher::Ptr   m_pCipher;
+        Streams                         m_VideoStreams;
+        Streams                         m_AudioStreams;
+    };
+
+    //----------------------------------------------------------------------------------------------
+    // ResumptionCache - the tickets issued by the server. A ticket can be redeemed while the session it was issued to is still
+    // connected, which is what usually happens when the client changes networks before the old session times out, and for the
+    // specified lifetime after that session has ended. Every ticket can only be redeemed once, the resumed session gets a new one.
+    // Redeeming requires the proof computed from the ticket's secret, a wrong proof burns the ticket.
+    //----------------------------------------------------------------------------------------------
+    class ResumptionCache
+    {
+    public:
+        ResumptionCache() = default;
+
+        std::string Issue(transport_common::SessionHandle session, ResumptionState::Ptr pState, std::string* secret);
+        bool IsRedeemable(const std::string& ticket, const char* deviceID) const;
+        // Returns nullptr when the ticket is unknown, expired, was issued to a different device or the proof does not match the
+        // challenge. previousSession receives the session the ticket was issued to if that session is still connected,
+        // INVALID_SESSION_HANDLE otherwise
+        ResumptionState::Ptr Redeem(const std::string& ticket, const char* deviceID, const std::string& challenge, const std::string& proof,
+                                    transport_common::SessionHandle* previousSession);
+        void Release(const std::string& ticket, amf_pts lifetime);     // Called when the session the ticket was issued to has ended
+        void Expire();
+        void Clear();
+
+    private:
+        struct Ticket
+        {
+            transport_common::SessionHandle m_Session = transport_common::INVALID_SESSION_HANDLE;
+            ResumptionState::Ptr            m_pState;
+            std::string                     m_Secret;
+            amf_pts                         m_ExpiryTime = 0;   // 0 while the session the ticket was issued to is connected
+        };
+        typedef std::map<std::string, Ticket> Tickets;
+
+        bool IsValid(const Ticket& entry, const char* deviceID) const;
+
+        mutable amf::AMFCriticalSection m_Guard;
+        Tickets                         m_Tickets;
+    };
+}
@@ -0,0 +1,308 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "StreamCapture.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::transport_amd::StreamCapture";
+
+namespace ssdk::transport_amd
+{
+    const char StreamCapture::FILE_MAGIC[8] = { 'S', 'S', 'D', 'K', 'C', 'A', 'P', '\0' };
+    const char StreamCapture::INDEX_MAGIC[8] = { 'S', 'S', 'D', 'K', 'I', 'D', 'X', '\0' };
+
+    //----------------------------------------------------------------------------------------------
+    // StreamRecorder
+    //----------------------------------------------------------------------------------------------
+    StreamRecorder::~StreamRecorder()
+    {
+        Close();
+    }
+
+    bool StreamRecorder::Open(const std::string& fileName, bool redactPayloads)
+    {
+        amf::AMFLock lock(&m_Guard);
+        if (m_File.is_open() == true)
+        {
+            AMFTraceError(AMF_FACILITY, L"Open(): capture is already open");
+            return false;
+        }
+        m_File.open(fileName, std::ios::binary | std::ios::trunc);
+        if (m_File.is_open() == false)
+        {
+            AMFTraceError(AMF_FACILITY, L"Open(): failed to create %S", fileName.c_str());
+            return false;
+        }
+
+        StreamCapture::FileHeader header = {};
+        memcpy(header.m_Magic, StreamCapture::FILE_MAGIC, sizeof(header.m_Magic));
+        header.m_Version = StreamCapture::VERSION;
+        header.m_Flags = redactPayloads == true ? StreamCapture::FLAG_REDACTED : 0;
+        header.m_CreationTime = static_cast<int64_t>(time(nullptr));
+        m_File.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        m_Redact = redactPayloads;
+        m_StartTime = amf_high_precision_clock();
+        m_Offset = sizeof(header);
+        m_RecordCount = 0;
+        m_Index.clear();
+        AMFTraceInfo(AMF_FACILITY, L"Capturing to %S%s", fileName.c_str(), redactPayloads == true ? L", payloads redacted" : L"");
+        return true;
+    }
+
+    void StreamRecorder::Close()
+    {
+        amf::AMFLock lock(&m_Guard);
+        if (m_File.is_open() == true)
+        {
+            StreamCapture::IndexTrailer trailer = {};
+            trailer.m_IndexOffset = m_Offset;
+            trailer.m_Count = static_cast<uint32_t>(m_Index.size());
+            memcpy(trailer.m_Magic, StreamCapture::INDEX_MAGIC, sizeof(trailer.m_Magic));
+            if (m_Index.empty() == false)
+            {
+                m_File.write(reinterpret_cast<const char*>(m_Index.data()), m_Index.size() * sizeof(StreamCapture::IndexEntry));
+            }
+            m_File.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+            m_File.close();
+            AMFTraceInfo(AMF_FACILITY, L"Capture closed, %llu records", static_cast<unsigned long long>(m_RecordCount));
+        }
+        m_Index.clear();
+    }
+
+    bool StreamRecorder::IsOpen() const
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_File.is_open();
+    }
+
+    void StreamRecorder::RecordFragment(StreamCapture::Direction direction, uint8_t channelID, int32_t msgID, const void* datagram, size_t size, size_t headerSize)
+    {
+        Record(StreamCapture::RecordType::FRAGMENT, direction, channelID, msgID, datagram, size, headerSize);
+    }
+
+    void StreamRecorder::RecordMessage(StreamCapture::Direction direction, Channel channel, int32_t msgID, const void* message, size_t size)
+    {
+        Record(StreamCapture::RecordType::MESSAGE, direction, static_cast<uint8_t>(channel), msgID, message, size, 0);
+    }
+
+    void StreamRecorder::Record(StreamCapture::RecordType type, StreamCapture::Direction direction, uint8_t channelID, int32_t msgID, const void* payload, size_t size, size_t headerSize)
+    {
+        amf::AMFLock lock(&m_Guard);
+        if (m_File.is_open() == false)
+        {
+            return;
+        }
+        amf_pts now = amf_high_precision_clock();     //  Under the lock to keep timestamps monotonic in the file
+
+        StreamCapture::RecordHeader header = {};
+        header.m_Type = static_cast<uint8_t>(type);
+        header.m_Direction = static_cast<uint8_t>(direction);
+        header.m_ChannelID = channelID;
+        header.m_MsgID = msgID;
+        header.m_Timestamp = now - m_StartTime;
+        header.m_Size = static_cast<uint32_t>(size);
+        header.m_StoredSize = m_Redact == true ? std::min(header.m_Size, static_cast<uint32_t>(headerSize)) : header.m_Size;
+
+        if (m_RecordCount % StreamCapture::INDEX_INTERVAL == 0)
+        {
+            m_Index.push_back({ header.m_Timestamp, m_Offset });
+        }
+        m_File.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (payload != nullptr && header.m_StoredSize > 0)
+        {
+            m_File.write(reinterpret_cast<const char*>(payload), header.m_StoredSize);
+        }
+        if (m_File.good() == false)
+        {
+            AMFTraceError(AMF_FACILITY, L"Record(): write failed, capture stopped");
+            m_File.close();
+            return;
+        }
+        m_Offset += sizeof(header) + header.m_StoredSize;
+        ++m_RecordCount;
+    }
+
+    //----------------------------------------------------------------------------------------------
+    // CaptureReader
+    //----------------------------------------------------------------------------------------------
+    bool CaptureReader::Open(const std::string& fileName)
+    {
+        Close();
+        m_File.open(fileName, std::ios::binary);
+        if (m_File.is_open() == false)
+        {
+            AMFTraceError(AMF_FACILITY, L"Open(): failed to open %S", fileName.c_str());
+            return false;
+        }
+        m_File.seekg(0, std::ios::end);
+        uint64_t fileSize = static_cast<uint64_t>(m_File.tellg());
+        m_File.seekg(0, std::ios::beg);
+
+        if (m_File.read(reinterpret_cast<char*>(&m_Header), sizeof(m_Header)).good() == false ||
+            memcmp(m_Header.m_Magic, StreamCapture::FILE_MAGIC, sizeof(m_Header.m_Magic)) != 0)
+        {
+            AMFTraceError(AMF_FACILITY, L"Open(): %S is not a capture file", fileName.c_str());
+            Close();
+            return false;
+        }
+        if (m_Header.m_Version > StreamCapture::VERSION)
+        {
+            AMFTraceError(AMF_FACILITY, L"Open(): capture version %u is not supported", m_Header.m_Version);
+            Close();
+            return false;
+        }
+        if (LoadIndex(fileSize) == false)
+        {
+            AMFTraceWarning(AMF_FACILITY, L"Open(): %S has no index, the capture was not closed", fileName.c_str());
+            m_EndOfRecords = fileSize;
+            m_Index.clear();
+        }
+        return Rewind();
+    }
+
+    void CaptureReader::Close()
+    {
+        if (m_File.is_open() == true)
+        {
+            m_File.close();
+        }
+        m_Header = {};
+        m_EndOfRecords = 0;
+        m_Index.clear();
+    }
+
+    bool CaptureReader::LoadIndex(uint64_t fileSize)
+    {
+        StreamCapture::IndexTrailer trailer = {};
+        if (fileSize < sizeof(StreamCapture::FileHeader) + sizeof(trailer))
+        {
+            return false;
+        }
+        m_File.seekg(fileSize - sizeof(trailer), std::ios::beg);
+        if (m_File.read(reinterpret_cast<char*>(&trailer), sizeof(trailer)).good() == false ||
+            memcmp(trailer.m_Magic, StreamCapture::INDEX_MAGIC, sizeof(trailer.m_Magic)) != 0 ||
+            trailer.m_IndexOffset + uint64_t(trailer.m_Count) * sizeof(StreamCapture::IndexEntry) + sizeof(trailer) != fileSize)
+        {
+            m_File.clear();
+            return false;
+        }
+        m_Index.resize(trailer.m_Count);
+        m_File.seekg(trailer.m_IndexOffset, std::ios::beg);
+        if (trailer.m_Count > 0 && m_File.read(reinterpret_cast<char*>(m_Index.data()), m_Index.size() * sizeof(StreamCapture::IndexEntry)).good() == false)
+        {
+            m_File.clear();
+            return false;
+        }
+        m_EndOfRecords = trailer.m_IndexOffset;
+        return true;
+    }
+
+    bool CaptureReader::Rewind()
+    {
+        if (m_File.is_open() == false)
+        {
+            return false;
+        }
+        m_File.clear();
+        m_File.seekg(sizeof(StreamCapture::FileHeader), std::ios::beg);
+        return m_File.good();
+    }
+
+    bool CaptureReader::ReadNext(Record& record)
+    {
+        if (m_File.is_open() == false || static_cast<uint64_t>(m_File.tellg()) + sizeof(StreamCapture::RecordHeader) > m_EndOfRecords)
+        {
+            return false;
+        }
+        StreamCapture::RecordHeader header = {};
+        if (m_File.read(reinterpret_cast<char*>(&header), sizeof(header)).good() == false ||
+            header.m_StoredSize > header.m_Size ||
+            static_cast<uint64_t>(m_File.tellg()) + header.m_StoredSize > m_EndOfRecords)
+        {   //  A truncated last record of a capture which was not closed
+            return false;
+        }
+        record.m_Type = static_cast<StreamCapture::RecordType>(header.m_Type);
+        record.m_Direction = static_cast<StreamCapture::Direction>(header.m_Direction);
+        record.m_ChannelID = header.m_ChannelID;
+        record.m_MsgID = header.m_MsgID;
+        record.m_Timestamp = header.m_Timestamp;
+        record.m_Redacted = header.m_StoredSize < header.m_Size;
+        record.m_Payload.assign(header.m_Size, 0);
+        if (header.m_StoredSize > 0)
+        {
+            m_File.read(reinterpret_cast<char*>(record.m_Payload.data()), header.m_StoredSize);
+        }
+        return m_File.good();
+    }
+
+    bool CaptureReader::Seek(amf_pts timestamp)
+    {
+        if (Rewind() == false)
+        {
+            return false;
+        }
+        //  Start from the last indexed record before the timestamp, then scan forward
+        for (std::vector<StreamCapture::IndexEntry>::const_reverse_iterator it = m_Index.rbegin(); it != m_Index.rend(); ++it)
+        {
+            if (it->m_Timestamp < timestamp)
+            {
+                m_File.seekg(it->m_Offset, std::ios::beg);
+                break;
+            }
+        }
+        StreamCapture::RecordHeader header = {};
+        while (static_cast<uint64_t>(m_File.tellg()) + sizeof(header) <= m_EndOfRecords)
+        {
+            std::streampos position = m_File.tellg();
+            if (m_File.read(reinterpret_cast<char*>(&header), sizeof(header)).good() == false)
+            {
+                return false;
+            }
+            if (header.m_Timestamp >= timestamp)
+            {
+                m_File.seekg(position, std::ios::beg);
+                return true;
+            }
+            m_File.seekg(header.m_StoredSize, std::ios::cur);
+        }
+        return false;
+    }
+}
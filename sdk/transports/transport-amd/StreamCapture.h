@@ -0,0 +1,200 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include "transports/transport-amd/Channels.h"
+#include "amf/public/include/core/Platform.h"
+#include "amf/public/common/Thread.h"
+
+#include <fstream>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ssdk::transport_amd
+{
+    //----------------------------------------------------------------------------------------------
+    // StreamCapture - layout of a capture file. All fields are in the host byte order, fragment payloads keep the network order
+    // of the wire. A file is a FileHeader followed by records, each one is a RecordHeader followed by m_StoredSize bytes of payload.
+    // When the recorder is closed cleanly an index of every INDEX_INTERVAL-th record and an IndexTrailer are appended,
+    // a file without the trailer (the process died) is still readable sequentially.
+    //----------------------------------------------------------------------------------------------
+    class StreamCapture
+    {
+    public:
+        enum class RecordType : uint8_t
+        {
+            FRAGMENT,       // A datagram as seen by FlowCtrlProtocol, fragment header included
+            MESSAGE,        // A complete message as seen by ReceiverCallback::OnMessageReceived()
+        };
+
+        enum class Direction : uint8_t
+        {
+            INCOMING,
+            OUTGOING,
+        };
+
+        static constexpr const uint32_t VERSION = 1;
+        static constexpr const uint32_t FLAG_REDACTED = 0x00000001;     // Only the fragment headers are stored, the payloads read back as zeroes
+        static constexpr const uint32_t INDEX_INTERVAL = 256;
+
+#pragma pack(push, 1)
+        struct FileHeader
+        {
+            char        m_Magic[8];
+            uint32_t    m_Version;
+            uint32_t    m_Flags;
+            int64_t     m_CreationTime;     // Seconds since the epoch
+        };
+
+        struct RecordHeader
+        {
+            uint8_t     m_Type;
+            uint8_t     m_Direction;
+            uint8_t     m_ChannelID;
+            uint8_t     m_Reserved;
+            int32_t     m_MsgID;
+            int64_t     m_Timestamp;        // amf_pts since the beginning of the capture
+            uint32_t    m_Size;             // Original size of the payload
+            uint32_t    m_StoredSize;       // Bytes of payload following the header, less than m_Size when redacted, which keeps only the protocol header
+        };
+
+        struct IndexEntry
+        {
+            int64_t     m_Timestamp;
+            uint64_t    m_Offset;           // Of the RecordHeader from the beginning of the file
+        };
+
+        struct IndexTrailer
+        {
+            uint64_t    m_IndexOffset;
+            uint32_t    m_Count;
+            char        m_Magic[8];
+        };
+#pragma pack(pop)
+
+        static const char FILE_MAGIC[8];
+        static const char INDEX_MAGIC[8];
+    };
+
+    //----------------------------------------------------------------------------------------------
+    // StreamRecorder - writes a capture file, can be shared by the fragment and the message layers and called from any thread
+    //----------------------------------------------------------------------------------------------
+    class StreamRecorder
+    {
+    public:
+        typedef std::shared_ptr<StreamRecorder> Ptr;
+
+    public:
+        StreamRecorder() = default;
+        ~StreamRecorder();
+
+        bool Open(const std::string& fileName, bool redactPayloads);
+        void Close();
+        bool IsOpen() const;
+
+        //  headerSize bytes at the start of the datagram are the fragment header, the only part of a payload stored when redacting.
+        //  Messages are stored without any payload then, their channel, ID and size are in the record header
+        void RecordFragment(StreamCapture::Direction direction, uint8_t channelID, int32_t msgID, const void* datagram, size_t size, size_t headerSize);
+        void RecordMessage(StreamCapture::Direction direction, Channel channel, int32_t msgID, const void* message, size_t size);
+
+    private:
+        StreamRecorder(const StreamRecorder&) = delete;
+        StreamRecorder& operator=(const StreamRecorder&) = delete;
+
+        void Record(StreamCapture::RecordType type, StreamCapture::Direction direction, uint8_t channelID, int32_t msgID, const void* payload, size_t size, size_t headerSize);
+
+    private:
+        mutable amf::AMFCriticalSection m_Guard;
+        std::ofstream                   m_File;
+        bool                            m_Redact = false;
+        amf_pts                         m_StartTime = 0;
+        uint64_t                        m_Offset = 0;
+        uint64_t                        m_RecordCount = 0;
+        std::vector<StreamCapture::IndexEntry>  m_Index;
+    };
+
+    //----------------------------------------------------------------------------------------------
+    // CaptureReader - reads a capture file record by record
+    //----------------------------------------------------------------------------------------------
+    class CaptureReader
+    {
+    public:
+        struct Record
+        {
+            StreamCapture::RecordType   m_Type = StreamCapture::RecordType::FRAGMENT;
+            StreamCapture::Direction    m_Direction = StreamCapture::Direction::INCOMING;
+            uint8_t                     m_ChannelID = 0;
+            int32_t                     m_MsgID = 0;
+            amf_pts                     m_Timestamp = 0;
+            bool                        m_Redacted = false;
+            std::vector<uint8_t>        m_Payload;      // Always of the original size, redacted bytes are zeroes
+        };
+
+    public:
+        CaptureReader() = default;
+
+        bool Open(const std::string& fileName);
+        void Close();
+
+        inline uint32_t GetFlags() const noexcept { return m_Header.m_Flags; }
+        inline int64_t GetCreationTime() const noexcept { return m_Header.m_CreationTime; }
+
+        bool ReadNext(Record& record);          // false at the end of the capture
+        bool Seek(amf_pts timestamp);           // Positions at the first record at or after the timestamp
+        bool Rewind();
+
+    private:
+        CaptureReader(const CaptureReader&) = delete;
+        CaptureReader& operator=(const CaptureReader&) = delete;
+
+        bool LoadIndex(uint64_t fileSize);
+
+    private:
+        std::ifstream                   m_File;
+        StreamCapture::FileHeader       m_Header = {};
+        uint64_t                        m_EndOfRecords = 0;
+        std::vector<StreamCapture::IndexEntry>  m_Index;
+    };
+}
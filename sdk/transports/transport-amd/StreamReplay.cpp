@@ -0,0 +1,155 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include "StreamReplay.h"
+#include "amf/public/common/TraceAdapter.h"
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::transport_amd::StreamReplay";
+
+namespace ssdk::transport_amd
+{
+    StreamReplay::StreamReplay(ReceiverCallback* callback, Session* session) :
+        m_Callback(callback),
+        m_Session(session)
+    {
+        if (m_Session == nullptr)
+        {
+            m_Session = new ReplaySession(m_Stats);
+        }
+    }
+
+    StreamReplay::~StreamReplay()
+    {
+    }
+
+    bool StreamReplay::Open(const std::string& fileName)
+    {
+        return m_Reader.Open(fileName);
+    }
+
+    bool StreamReplay::Run(Layer layer, double speed, amf_pts from)
+    {
+        AMF_RETURN_IF_FALSE(m_Callback != nullptr, false, L"Run(): no receiver callback");
+        if ((from > 0 ? m_Reader.Seek(from) : m_Reader.Rewind()) == false)
+        {
+            AMFTraceError(AMF_FACILITY, L"Run(): capture is not open or has no records after %lld", from);
+            return false;
+        }
+
+        StreamCapture::RecordType type = layer == Layer::FRAGMENT ? StreamCapture::RecordType::FRAGMENT : StreamCapture::RecordType::MESSAGE;
+        m_Speed = speed > 0 ? speed : 0;
+        m_Stats = {};
+        m_Stop = false;
+        m_ReplayStart = amf_high_precision_clock();
+        amf_pts firstTimestamp = -1;
+        CaptureReader::Record record;
+        while (m_Stop == false && m_Reader.ReadNext(record) == true)
+        {
+            if (record.m_Type != type || record.m_Direction != StreamCapture::Direction::INCOMING)
+            {
+                continue;
+            }
+            if (firstTimestamp < 0)
+            {
+                firstTimestamp = record.m_Timestamp;
+            }
+            m_Stats.m_CaptureDuration = record.m_Timestamp - firstTimestamp;
+            WaitUntil(m_Stats.m_CaptureDuration);
+
+            ++m_Stats.m_Records;
+            if (record.m_Redacted == true)
+            {
+                ++m_Stats.m_RedactedRecords;
+            }
+            if (layer == Layer::FRAGMENT)
+            {
+                if (m_FlowCtrl.ProcessFragment(record.m_Payload.data(), static_cast<uint32_t>(record.m_Payload.size()), m_Peer, *this) != FlowCtrlProtocol::Result::OK)
+                {
+                    ++m_Stats.m_InvalidFragments;
+                }
+                m_FlowCtrl.TickNotify(*this);
+            }
+            else
+            {
+                ++m_Stats.m_Messages;
+                m_Stats.m_Bytes += record.m_Payload.size();
+                m_Callback->OnMessageReceived(m_Session, static_cast<Channel>(record.m_ChannelID), record.m_MsgID, record.m_Payload.data(), record.m_Payload.size());
+            }
+        }
+        m_Stats.m_ReplayDuration = amf_high_precision_clock() - m_ReplayStart;
+        AMFTraceInfo(AMF_FACILITY, L"Replayed %llu records, %llu messages in %lld ms, capture duration %lld ms",
+            static_cast<unsigned long long>(m_Stats.m_Records), static_cast<unsigned long long>(m_Stats.m_Messages),
+            m_Stats.m_ReplayDuration / AMF_MILLISECOND, m_Stats.m_CaptureDuration / AMF_MILLISECOND);
+        return true;
+    }
+
+    void StreamReplay::WaitUntil(amf_pts captureTime)
+    {
+        if (m_Speed == 0)
+        {
+            return;
+        }
+        amf_pts deadline = m_ReplayStart + static_cast<amf_pts>(captureTime / m_Speed);
+        for (amf_pts now = amf_high_precision_clock(); now < deadline && m_Stop == false; now = amf_high_precision_clock())
+        {
+            amf_pts remaining = deadline - now;
+            if (remaining >= AMF_MILLISECOND)
+            {
+                amf_sleep(static_cast<amf_uint32>(remaining / AMF_MILLISECOND));
+            }
+            m_FlowCtrl.TickNotify(*this);   //  Flushes incomplete messages on the same timeouts as a live session
+        }
+    }
+
+    void StreamReplay::OnCompleteMessage(FlowCtrlProtocol::MessageID msgID, const void* buf, size_t size, const net::Socket::Address& /*receivedFrom*/, uint8_t optional)
+    {
+        ++m_Stats.m_Messages;
+        m_Stats.m_Bytes += size;
+        m_Callback->OnMessageReceived(m_Session, static_cast<Channel>(optional), msgID, buf, size);
+    }
+
+    net::Socket::Result StreamReplay::OnRequestFragment(const FlowCtrlProtocol::Fragment& /*fragment*/)
+    {
+        ++m_Stats.m_FragmentRequests;
+        return net::Socket::Result::OK;
+    }
+
+    transport_common::Result AMF_STD_CALL StreamReplay::ReplaySession::Send(Channel /*channel*/, const void* /*msg*/, size_t /*msgLen*/)
+    {
+        ++m_Stats.m_Responses;
+        return transport_common::Result::OK;
+    }
+}
@@ -0,0 +1,136 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include "StreamCapture.h"
+#include "FlowCtrlProtocol.h"
+#include "TransportSession.h"
+#include "amf/public/common/InterfaceImpl.h"
+
+#include <atomic>
+#include <string>
+
+namespace ssdk::transport_amd
+{
+    //----------------------------------------------------------------------------------------------
+    // StreamReplay - feeds the incoming records of a capture into a ReceiverCallback, such as ClientTransportImpl or ServerTransportImpl,
+    // at the original or at a scaled timing. Fragments go through a private FlowCtrlProtocol instance, so reassembly and missing
+    // fragment requests behave as they did on the wire, messages are delivered directly. Replay runs on the calling thread.
+    //----------------------------------------------------------------------------------------------
+    class StreamReplay :
+        protected FlowCtrlProtocol::ProcessIncomingCallback
+    {
+    public:
+        enum class Layer
+        {
+            FRAGMENT,
+            MESSAGE,
+        };
+
+        struct Stats
+        {
+            uint64_t    m_Records = 0;              // Incoming records of the replayed layer
+            uint64_t    m_RedactedRecords = 0;
+            uint64_t    m_InvalidFragments = 0;
+            uint64_t    m_Messages = 0;             // Delivered to the callback
+            uint64_t    m_Bytes = 0;
+            uint64_t    m_FragmentRequests = 0;     // Missing fragment requests the flow control would have sent
+            uint64_t    m_Responses = 0;            // Messages the callback sent back through the session
+            amf_pts     m_CaptureDuration = 0;
+            amf_pts     m_ReplayDuration = 0;
+        };
+
+    public:
+        //  When no session is given, the callback receives a session which discards everything sent through it
+        StreamReplay(ReceiverCallback* callback, Session* session = nullptr);
+        ~StreamReplay();
+
+        bool Open(const std::string& fileName);
+
+        //  speed: 1 - original timing, 2 - twice as fast, 0 - as fast as possible
+        bool Run(Layer layer, double speed = 1.0, amf_pts from = 0);
+        inline void Stop() noexcept { m_Stop = true; }      // Can be called from another thread or from the callback
+
+        inline const Stats& GetStats() const noexcept { return m_Stats; }
+
+    protected:
+        virtual void OnCompleteMessage(FlowCtrlProtocol::MessageID msgID, const void* buf, size_t size, const net::Socket::Address& receivedFrom, uint8_t optional) override;
+        virtual net::Socket::Result OnRequestFragment(const FlowCtrlProtocol::Fragment& fragment) override;
+
+    private:
+        StreamReplay(const StreamReplay&) = delete;
+        StreamReplay& operator=(const StreamReplay&) = delete;
+
+        void WaitUntil(amf_pts replayTime);
+
+        class ReplaySession : public amf::AMFInterfaceImpl<Session>
+        {
+        public:
+            ReplaySession(Stats& stats) : m_Stats(stats) {}
+
+            virtual void AMF_STD_CALL UpgradeProtocol(uint32_t /*version*/) override {}
+            virtual void AMF_STD_CALL RegisterReceiverCallback(ReceiverCallback* /*callback*/) override {}
+            virtual void AMF_STD_CALL Terminate() override { m_Terminated = true; }
+            virtual bool AMF_STD_CALL IsTerminated() const noexcept override { return m_Terminated; }
+            virtual transport_common::Result AMF_STD_CALL Send(Channel channel, const void* msg, size_t msgLen) override;
+            virtual const char* AMF_STD_CALL GetPeerPlatform() const noexcept override { return "replay"; }
+            virtual const char* AMF_STD_CALL GetPeerUrl() const noexcept override { return "replay://"; }
+            virtual ssdk::transport_common::SessionHandle AMF_STD_CALL GetSessionHandle() const noexcept override { return 1; }
+
+        private:
+            Stats&  m_Stats;
+            bool    m_Terminated = false;
+        };
+
+    private:
+        ReceiverCallback*   m_Callback = nullptr;
+        Session::Ptr        m_Session;
+        CaptureReader       m_Reader;
+        FlowCtrlProtocol    m_FlowCtrl{ FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT };
+        net::Socket::IPv4Address    m_Peer;
+        std::atomic<bool>   m_Stop{ false };
+        double              m_Speed = 1.0;
+        amf_pts             m_ReplayStart = 0;
+        Stats               m_Stats;
+    };
+}
@@ -43,9 +43,12 @@ THE SOFTWARE.
 #include "public/common/TraceAdapter.h"
 #include "public/common/PropertyStorageImpl.h"
 #include "transports/transport-amd/TransportServerImpl.h"
+#include "transports/transport-amd/UDPServerSessionImpl.h"
 #include "transports/transport-amd/messages/audio/AudioInit.h"
 #include "transports/transport-amd/messages/audio/AudioData.h"
+#include "transports/transport-amd/messages/video/VideoData.h"
 #include "controllers/UserInput.h"
+#include "util/trace/PipelineTrace.h"
 
 #include <sstream>
 #include <iomanip>
@@ -54,6 +57,58 @@ namespace ssdk::transport_amd
 {
     static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::transport_amd::Subscriber";
     static constexpr const float STATS_UPDATE_PERIOD = float(AMF_SECOND * 3);
+    static constexpr const char* const CHANNEL_METRICS_NAMES[] = { "video", "audio", "ctrl", "user", "other" };
+
+    static std::atomic<uint64_t> s_LastSubscriberOrdinal{ 0 };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    /// Subscriber::ChannelMetrics implementation
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    Subscriber::ChannelStats Subscriber::ChannelStats::operator-(const ChannelStats& other) const
+    {
+        ChannelStats result;
+        result.m_BytesTx = m_BytesTx - other.m_BytesTx;
+        result.m_BytesRx = m_BytesRx - other.m_BytesRx;
+        result.m_MessagesTx = m_MessagesTx - other.m_MessagesTx;
+        result.m_MessagesRx = m_MessagesRx - other.m_MessagesRx;
+        result.m_SendTime = m_SendTime - other.m_SendTime;
+        return result;
+    }
+
+    void Subscriber::ChannelMetrics::Init(const std::string& subscriber, const char* channel)
+    {
+        ssdk::util::MetricsRegistry& registry = ssdk::util::MetricsRegistry::GetInstance();
+        ssdk::util::MetricsRegistry::Labels labels = { { "subscriber", subscriber }, { "channel", channel } };
+        m_BytesTx = registry.GetCounter("ssdk_server_sent_bytes", "Bytes sent to the subscriber, after encryption", labels);
+        m_BytesRx = registry.GetCounter("ssdk_server_received_bytes", "Bytes received from the subscriber", labels);
+        m_MessagesTx = registry.GetCounter("ssdk_server_sent_messages", "Messages sent to the subscriber", labels);
+        m_MessagesRx = registry.GetCounter("ssdk_server_received_messages", "Messages received from the subscriber", labels);
+        m_SendTime = registry.GetCounter("ssdk_server_send_seconds", "Time spent in Session::Send()", labels, 1.0 / AMF_SECOND);
+    }
+
+    void Subscriber::ChannelMetrics::OnSent(size_t bytes, amf_pts sendTime) noexcept
+    {
+        m_BytesTx->Add(bytes);
+        m_MessagesTx->Increment();
+        m_SendTime->Add(uint64_t(sendTime));
+    }
+
+    void Subscriber::ChannelMetrics::OnReceived(size_t bytes) noexcept
+    {
+        m_BytesRx->Add(bytes);
+        m_MessagesRx->Increment();
+    }
+
+    Subscriber::ChannelStats Subscriber::ChannelMetrics::GetStats() const noexcept
+    {
+        ChannelStats stats;
+        stats.m_BytesTx = m_BytesTx->Get();
+        stats.m_BytesRx = m_BytesRx->Get();
+        stats.m_MessagesTx = m_MessagesTx->Get();
+        stats.m_MessagesRx = m_MessagesRx->Get();
+        stats.m_SendTime = amf_pts(m_SendTime->Get());
+        return stats;
+    }
 
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     /// Subscriber implementation
@@ -64,10 +119,25 @@ namespace ssdk::transport_amd
     {
         m_pStatistics = new amf::AMFInterfaceImpl<amf::AMFPropertyStorageImpl<amf::AMFPropertyStorage>>();
         m_StatTime = amf_high_precision_clock();
+
+        //  The IDs arrive later in the handshake, metrics are labeled with an ordinal unique within the process instead
+        std::string subscriber = std::to_string(++s_LastSubscriberOrdinal);
+        for (int i = 0; i < ChannelMetrics::COUNT; ++i)
+        {
+            m_ChannelMetrics[i].Init(subscriber, CHANNEL_METRICS_NAMES[i]);
+        }
+        ssdk::util::MetricsRegistry& registry = ssdk::util::MetricsRegistry::GetInstance();
+        ssdk::util::MetricsRegistry::Labels labels = { { "subscriber", subscriber } };
+        m_VideoFramesTx = registry.GetCounter("ssdk_server_video_frames_sent", "Video frames sent to the subscriber", labels);
+        m_AudioFramesTx = registry.GetCounter("ssdk_server_audio_frames_sent", "Audio frames sent to the subscriber", labels);
+        m_SlowSends = registry.GetCounter("ssdk_server_slow_sends", "Calls to Session::Send() which took longer than 100 ms", labels);
+        m_EncryptTime = registry.GetCounter("ssdk_server_encrypt_seconds", "Time spent encrypting messages for the subscriber", labels, 1.0 / AMF_SECOND);
+        m_SendDuration = registry.GetHistogram("ssdk_server_send_duration_seconds", "Duration of Session::Send() calls", ssdk::util::MetricsRegistry::LATENCY_BUCKETS, labels);
     }
 
     Subscriber::~Subscriber()
     {
+        m_pSendQueue = nullptr;     //  Stops the sender thread before anything it uses goes away
         m_pCipher = nullptr;
     }
 
@@ -146,15 +216,152 @@ namespace ssdk::transport_amd
         return TransmitMessage(Channel::USER_DEFINED, msg, msgLength);
     }
 
+    static SendQueue::MessageClass ClassifyMessage(Channel channel, const void* msg, size_t msgLen)
+    {
+        SendQueue::MessageClass messageClass = SendQueue::MessageClass::CONTROL;
+        if (channel == Channel::AUDIO_OUT && msgLen > 0 && AUDIO_OP_CODE(static_cast<const uint8_t*>(msg)[0]) == AUDIO_OP_CODE::DATA)
+        {
+            messageClass = SendQueue::MessageClass::AUDIO;
+        }
+        return messageClass;
+    }
+
     ssdk::transport_common::Result Subscriber::TransmitMessage(Channel channel, const void* msg, size_t msgLen)
+    {
+        return TransmitMessage(channel, msg, msgLen, ClassifyMessage(channel, msg, msgLen), SendQueue::NO_FRAME);
+    }
+
+    ssdk::transport_common::Result Subscriber::TransmitMessage(Channel channel, const void* msg, size_t msgLen, SendQueue::MessageClass messageClass, amf_pts frameID)
+    {
+        SendQueue* pSendQueue = nullptr;
+        {
+            amf::AMFLock lock(&m_Guard);
+            pSendQueue = m_pSendQueue.get();
+        }
+        //  Everything on the media channels goes through the queue to keep init blocks and cursors in order with the frames
+        if (pSendQueue != nullptr && (channel == Channel::VIDEO_OUT || channel == Channel::AUDIO_OUT))
+        {
+            pSendQueue->Push(channel, msg, msgLen, messageClass, frameID);
+            return ssdk::transport_common::Result::OK;
+        }
+        return SendMessage(channel, msg, msgLen);
+    }
+
+    ssdk::transport_common::Result Subscriber::TransmitMessage(Channel channel, const ssdk::util::BufferPool::Lease& msg)
+    {
+        return TransmitMessage(channel, msg, ClassifyMessage(channel, msg.GetData(), msg.GetSize()), SendQueue::NO_FRAME);
+    }
+
+    ssdk::transport_common::Result Subscriber::TransmitMessage(Channel channel, const ssdk::util::BufferPool::Lease& msg, SendQueue::MessageClass messageClass, amf_pts frameID)
+    {
+        SendQueue* pSendQueue = nullptr;
+        {
+            amf::AMFLock lock(&m_Guard);
+            pSendQueue = m_pSendQueue.get();
+        }
+        if (pSendQueue != nullptr && (channel == Channel::VIDEO_OUT || channel == Channel::AUDIO_OUT))
+        {
+            pSendQueue->Push(channel, msg, messageClass, frameID);
+            return ssdk::transport_common::Result::OK;
+        }
+        return SendMessage(channel, msg.GetData(), msg.GetSize());
+    }
+
+    void Subscriber::EnableSendQueue(size_t maxDepth, amf_pts maxAge)
+    {
+        amf::AMFLock lock(&m_Guard);
+        if (m_pSendQueue == nullptr)
+        {
+            m_pSendQueue = std::unique_ptr<SendQueue>(new SendQueue(*this, maxDepth, maxAge));
+            m_pSendQueue->Start();
+        }
+    }
+
+    bool Subscriber::TakeKeyFrameRequest()
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_pSendQueue != nullptr && m_pSendQueue->TakeKeyFrameRequest() == true;
+    }
+
+    bool Subscriber::SetPacingBitrate(int64_t bitrate)
+    {
+        amf::AMFLock lock(&m_Guard);
+        if (m_pSendQueue == nullptr)
+        {
+            return false;
+        }
+        m_pSendQueue->SetPacingBitrate(bitrate);
+        return true;
+    }
+
+    void Subscriber::SetResumeChallenge(const std::string& ticket, const std::string& challenge)
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_ChallengedTicket = ticket;
+        m_ResumeChallenge = challenge;
+    }
+
+    bool Subscriber::GetResumeChallenge(std::string* challenge) const
+    {
+        amf::AMFLock lock(&m_Guard);
+        *challenge = m_ResumeChallenge;
+        return m_ResumeChallenge.empty() == false;
+    }
+
+    bool Subscriber::TakeResumeChallenge(std::string* ticket, std::string* challenge)
+    {
+        amf::AMFLock lock(&m_Guard);
+        bool pending = m_ResumeChallenge.empty() == false;
+        *ticket = m_ChallengedTicket;
+        *challenge = m_ResumeChallenge;
+        m_ChallengedTicket.clear();
+        m_ResumeChallenge.clear();
+        return pending;
+    }
+
+    void Subscriber::SetInitReplayed(Channel channel, ssdk::transport_common::StreamID streamID)
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_ReplayedInits.emplace(channel, streamID);
+    }
+
+    bool Subscriber::TakeInitReplayed(Channel channel, ssdk::transport_common::StreamID streamID)
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_ReplayedInits.erase(std::make_pair(channel, streamID)) > 0;
+    }
+
+    void Subscriber::SetAudioInitID(ssdk::transport_common::StreamID streamID, ssdk::transport_common::InitID initID)
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_AudioInitIDs[streamID] = initID;
+    }
+
+    ssdk::transport_common::InitID Subscriber::GetAudioInitID(ssdk::transport_common::StreamID streamID) const
+    {
+        amf::AMFLock lock(&m_Guard);
+        std::map<ssdk::transport_common::StreamID, ssdk::transport_common::InitID>::const_iterator it = m_AudioInitIDs.find(streamID);
+        return it != m_AudioInitIDs.end() ? it->second : ssdk::transport_common::INVALID_INIT_ID;
+    }
+
+    ssdk::transport_common::Result Subscriber::SendQueuedMessage(Channel channel, const void* msg, size_t msgLen)
+    {
+        if (channel == Channel::VIDEO_OUT)
+        {   //  Frames are copied to a buffer of their own for each subscriber, so the time spent in the queue can be left out
+            //  of the client's network latency by stamping the send time only now
+            VideoData::StampSendTime(const_cast<void*>(msg), msgLen, amf_high_precision_clock());
+        }
+        return SendMessage(channel, msg, msgLen);
+    }
+
+    ssdk::transport_common::Result Subscriber::SendMessage(Channel channel, const void* msg, size_t msgLen)
     {
         uint8_t* cipherText = nullptr;
         uint8_t* msgToSend = static_cast<uint8_t*>(const_cast<void*>(msg));
         size_t bytesToSend = msgLen;
         Session::Ptr pSession;
         ssdk::util::AESPSKCipher::Ptr pCipher;
-        amf::AMFContextPtr pContext;
-        amf::AMFBufferPtr pSendBuffer;
+        ssdk::util::BufferPool::Lease sendBuffer;
         uint8_t commandCode = msgToSend[0];
 
         {
@@ -165,75 +372,74 @@ namespace ssdk::transport_amd
                 return ssdk::transport_common::Result::FAIL;
             }
             pCipher = m_pCipher;
-            pContext = m_pContext;
         }
 
-        if (pCipher != nullptr && pContext != nullptr)
+        //  Payloads passed to a same-host client through shared memory are not encrypted, see LocalTransport.h
+        ServerSessionImpl* serverSession = dynamic_cast<ServerSessionImpl*>(pSession.GetPtr());
+        ssdk::transport_common::Result resOut = ssdk::transport_common::Result::OK;
+        amf_pts sendStart = amf_high_precision_clock();
+        bool clearText = serverSession != nullptr && serverSession->SendClearText(channel, msg, msgLen, &resOut) == true;
+        if (clearText == false && pCipher != nullptr)
         {
+            SSDK_TRACE_SCOPE_SPAN(ENCRYPT);
             amf_pts encryptStartTime = amf_high_precision_clock();
             size_t cipherTextBufferSize = pCipher->GetCipherTextBufferSize(msgLen);
             AMF_RETURN_IF_FALSE(cipherTextBufferSize != 0, ssdk::transport_common::Result::FAIL, L"Failed to allocate a zero-length buffer for Cipher::Encrypt, msgLen: %ld", msgLen);
-            AMF_RESULT res;
-            res = pContext->AllocBuffer(amf::AMF_MEMORY_HOST, cipherTextBufferSize, &pSendBuffer);
-            AMF_RETURN_IF_FALSE(res == AMF_OK, ssdk::transport_common::Result::FAIL, L"Failed to allocate a buffer for ANSCipher::Encrypt, size: %ld, msgLen: %ld", cipherTextBufferSize, msgLen);
-            cipherText = static_cast<uint8_t*>(pSendBuffer->GetNative());
+            sendBuffer = ssdk::util::BufferPool::GetInstance().Acquire(cipherTextBufferSize);
+            cipherText = sendBuffer.GetData();
             size_t cipherTextSize;
             bool bOk = pCipher->Encrypt(msg, msgLen, cipherText, &cipherTextSize);
             AMF_RETURN_IF_FALSE(bOk == true, ssdk::transport_common::Result::INVALID_ARG, L"ANSCipher::Encrypt failed");
             msgToSend = cipherText;
             bytesToSend = cipherTextBufferSize;
-            m_EncryptTimeAccum += amf_high_precision_clock() - encryptStartTime;
+            m_EncryptTime->Add(uint64_t(amf_high_precision_clock() - encryptStartTime));
+        }
+        if (clearText == false)
+        {
+            sendStart = amf_high_precision_clock();
+            resOut = pSession->Send(channel, msgToSend, bytesToSend);
         }
-        amf_pts sendStart = amf_high_precision_clock();
-        ssdk::transport_common::Result resOut = pSession->Send(channel, msgToSend, bytesToSend);
         amf_pts sendDuration = amf_high_precision_clock() - sendStart;
         {   // Statistics:
-            amf::AMFLock lock(&m_Guard);
-
-            m_TotalBytesTx += bytesToSend;
-            m_TotalTxTimeAccum += sendDuration;
-            ++m_TotalTxCnt;
-
+            ChannelMetrics::Index index = ChannelMetrics::OTHER;
             switch (channel)
             {
             case Channel::VIDEO_OUT:
-                m_VideoBytesTx += bytesToSend;
-                m_VideoTxTimeAccum += sendDuration;
+                index = ChannelMetrics::VIDEO;
                 if (VIDEO_OP_CODE(commandCode) == VIDEO_OP_CODE::DATA)
                 {
-                    ++m_VideoTxCnt;
+                    m_VideoFramesTx->Increment();
                 }
                 break;
             case Channel::AUDIO_OUT:
-                m_AudioBytesTx += bytesToSend;
-                m_AudioTxTimeAccum += sendDuration;
+                index = ChannelMetrics::AUDIO;
                 if (AUDIO_OP_CODE(commandCode) == AUDIO_OP_CODE::DATA)
                 {
-                    ++m_AudioTxCnt;
+                    m_AudioFramesTx->Increment();
                 }
                 break;
             case Channel::SENSORS_OUT:
-                m_CtrlBytesTx += bytesToSend;
-                m_CtrlTxTimeAccum += sendDuration;
-                ++m_CtrlTxCnt;
+                index = ChannelMetrics::CTRL;
                 break;
             case Channel::USER_DEFINED:
-                m_UserBytesTx += bytesToSend;
-                m_UserTxTimeAccum += sendDuration;
-                ++m_UserTxCnt;
+                index = ChannelMetrics::USER;
                 break;
             default:
                 break;
             }
-            if (m_WorstSendTime < sendDuration)
-            {
-                m_WorstSendTime = sendDuration;
-            }
+            m_ChannelMetrics[index].OnSent(bytesToSend, sendDuration);
+            m_SendDuration->Observe(double(sendDuration) / AMF_SECOND);
             if (sendDuration > AMF_SECOND / 10) // 100 ms
             {
-                m_SlowSendCnt++;
+                m_SlowSends->Increment();
                 AMFTraceWarning(AMF_FACILITY, L"calling Send() took %5.2f ms msgLen=%d", sendDuration / 10000., (int)msgLen);
             }
+
+            amf::AMFLock lock(&m_Guard);
+            if (m_WorstSendTime < sendDuration)
+            {
+                m_WorstSendTime = sendDuration;
+            }
             UpdateLocalStats();
         }
         return resOut;
@@ -242,8 +448,7 @@ namespace ssdk::transport_amd
     ssdk::transport_common::Result Subscriber::OnEvent(DeviceEvent& data, size_t dataSize)
     {
         // Statistics:
-        m_CtrlBytesRx += dataSize;
-        ++m_CtrlRxCnt;
+        m_ChannelMetrics[ChannelMetrics::CTRL].OnReceived(dataSize);
 
         AddRemoteTimestamp(data);
 
@@ -287,45 +492,86 @@ namespace ssdk::transport_amd
             float actualTimeSinceStatUpdateInSeconds = float(actualTimeSinceStatUpdate) / 10000000.f;
             int eyeCount = (m_EncoderStereo == true) ? 2 : 1;
 
-            float RxBandwidth = float((m_AudioBytesRx + m_CtrlBytesRx + m_UserBytesRx) * 8) / actualTimeSinceStatUpdateInSeconds;
-            float TxBandwidth = float(m_TotalBytesTx * 8) / actualTimeSinceStatUpdateInSeconds;
+            //  Everything below is the increase of the exported counters since the previous update
+            ChannelStats stats[ChannelMetrics::COUNT];
+            ChannelStats total;
+            for (int i = 0; i < ChannelMetrics::COUNT; ++i)
+            {
+                ChannelStats current = m_ChannelMetrics[i].GetStats();
+                stats[i] = current - m_LastChannelStats[i];
+                m_LastChannelStats[i] = current;
+
+                total.m_BytesTx += stats[i].m_BytesTx;
+                total.m_BytesRx += stats[i].m_BytesRx;
+                total.m_MessagesTx += stats[i].m_MessagesTx;
+                total.m_MessagesRx += stats[i].m_MessagesRx;
+                total.m_SendTime += stats[i].m_SendTime;
+            }
+            const ChannelStats& video = stats[ChannelMetrics::VIDEO];
+            const ChannelStats& audio = stats[ChannelMetrics::AUDIO];
+            const ChannelStats& ctrl = stats[ChannelMetrics::CTRL];
+            const ChannelStats& user = stats[ChannelMetrics::USER];
+
+            uint64_t videoFramesTx = m_VideoFramesTx->Get();
+            uint64_t audioFramesTx = m_AudioFramesTx->Get();
+            uint64_t slowSends = m_SlowSends->Get();
+            amf_pts encryptTime = amf_pts(m_EncryptTime->Get());
+
+            float RxBandwidth = float(total.m_BytesRx * 8) / actualTimeSinceStatUpdateInSeconds;
+            float TxBandwidth = float(total.m_BytesTx * 8) / actualTimeSinceStatUpdateInSeconds;
 
             m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_TOTAL_IN, RxBandwidth);
             m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_TOTAL_OUT, TxBandwidth);
             m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_ESTIMATE, TxBandwidth + RxBandwidth);
-            m_pStatistics->SetProperty(STATISTICS_TOTAL_SEND_TIME, float(m_TotalTxTimeAccum) / float(m_TotalTxCnt) / float(AMF_MILLISECOND));
+            m_pStatistics->SetProperty(STATISTICS_TOTAL_SEND_TIME, float(total.m_SendTime) / float(total.m_MessagesTx) / float(AMF_MILLISECOND));
 
-            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_VIDEO_OUT, float(m_VideoBytesTx * 8) / actualTimeSinceStatUpdateInSeconds);
-            m_pStatistics->SetProperty(STATISTICS_VIDEO_SEND_TIME, float(m_VideoTxTimeAccum) / float(m_VideoTxCnt) / float(AMF_SECOND));
+            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_VIDEO_OUT, float(video.m_BytesTx * 8) / actualTimeSinceStatUpdateInSeconds);
+            m_pStatistics->SetProperty(STATISTICS_VIDEO_SEND_TIME, float(video.m_SendTime) / float(videoFramesTx - m_LastVideoFramesTx) / float(AMF_SECOND));
 
-            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_AUDIO_IN, float(m_AudioBytesRx * 8) / actualTimeSinceStatUpdateInSeconds);
-            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_AUDIO_OUT, float(m_AudioBytesTx * 8) / actualTimeSinceStatUpdateInSeconds);
-            m_pStatistics->SetProperty(STATISTICS_AUDIO_SEND_TIME, float(m_AudioTxTimeAccum) / float(m_AudioTxCnt) / float(AMF_SECOND));
+            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_AUDIO_IN, float(audio.m_BytesRx * 8) / actualTimeSinceStatUpdateInSeconds);
+            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_AUDIO_OUT, float(audio.m_BytesTx * 8) / actualTimeSinceStatUpdateInSeconds);
+            m_pStatistics->SetProperty(STATISTICS_AUDIO_SEND_TIME, float(audio.m_SendTime) / float(audioFramesTx - m_LastAudioFramesTx) / float(AMF_SECOND));
 
-            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_CTRL_IN, float(m_CtrlBytesRx * 8) / actualTimeSinceStatUpdateInSeconds);
-            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_CTRL_OUT, float(m_CtrlBytesTx * 8) / actualTimeSinceStatUpdateInSeconds);
-            m_pStatistics->SetProperty(STATISTICS_CTRL_SEND_TIME, float(m_CtrlTxTimeAccum) / float(m_CtrlTxCnt) / float(AMF_SECOND));
+            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_CTRL_IN, float(ctrl.m_BytesRx * 8) / actualTimeSinceStatUpdateInSeconds);
+            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_CTRL_OUT, float(ctrl.m_BytesTx * 8) / actualTimeSinceStatUpdateInSeconds);
+            m_pStatistics->SetProperty(STATISTICS_CTRL_SEND_TIME, float(ctrl.m_SendTime) / float(ctrl.m_MessagesTx) / float(AMF_SECOND));
 
-            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_USER_IN, float(m_UserBytesRx * 8) / actualTimeSinceStatUpdateInSeconds);
-            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_USER_OUT, float(m_UserBytesTx * 8) / actualTimeSinceStatUpdateInSeconds);
-            m_pStatistics->SetProperty(STATISTICS_USER_SEND_TIME, float(m_UserTxTimeAccum) / float(m_UserTxCnt) / float(AMF_SECOND));
+            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_USER_IN, float(user.m_BytesRx * 8) / actualTimeSinceStatUpdateInSeconds);
+            m_pStatistics->SetProperty(STATISTICS_BANDWIDTH_USER_OUT, float(user.m_BytesTx * 8) / actualTimeSinceStatUpdateInSeconds);
+            m_pStatistics->SetProperty(STATISTICS_USER_SEND_TIME, float(user.m_SendTime) / float(user.m_MessagesTx) / float(AMF_SECOND));
 
-            m_pStatistics->SetProperty(STATISTICS_VIDEO_FPS_AT_TX, float(m_VideoTxCnt) / actualTimeSinceStatUpdateInSeconds / eyeCount);
+            m_pStatistics->SetProperty(STATISTICS_VIDEO_FPS_AT_TX, float(videoFramesTx - m_LastVideoFramesTx) / actualTimeSinceStatUpdateInSeconds / eyeCount);
 
             m_pStatistics->SetProperty(STATISTICS_DECRYPTION_LATENCY, float(m_DecryptTimeAccum) / float(m_TotalRxCnt) / float(AMF_MILLISECOND));
-            m_pStatistics->SetProperty(STATISTICS_ENCRYPTION_LATENCY, float(m_EncryptTimeAccum) / float(m_TotalTxCnt) / float(AMF_MILLISECOND));
+            m_pStatistics->SetProperty(STATISTICS_ENCRYPTION_LATENCY, float(encryptTime - m_LastEncryptTime) / float(total.m_MessagesTx) / float(AMF_MILLISECOND));
 
-            m_pStatistics->SetProperty(STATISTICS_SLOW_SEND_COUNT, m_SlowSendCnt);
+            m_pStatistics->SetProperty(STATISTICS_SLOW_SEND_COUNT, int64_t(slowSends - m_LastSlowSends));
             m_pStatistics->SetProperty(STATISTICS_WORST_SEND_TIME, float(m_WorstSendTime) / float(AMF_MILLISECOND));
 
+            if (m_pSendQueue != nullptr)
+            {
+                SendQueue::Stats queueStats = m_pSendQueue->GetStats(true);
+                m_pStatistics->SetProperty(STATISTICS_SEND_QUEUE_DEPTH, int64_t(queueStats.depth));
+                m_pStatistics->SetProperty(STATISTICS_SEND_QUEUE_AGE, queueStats.sent > 0 ? float(queueStats.totalAge) / float(queueStats.sent) / float(AMF_MILLISECOND) : 0.0f);
+                m_pStatistics->SetProperty(STATISTICS_SEND_QUEUE_MAX_AGE, float(queueStats.maxAge) / float(AMF_MILLISECOND));
+                m_pStatistics->SetProperty(STATISTICS_SEND_QUEUE_DROPPED_VIDEO, queueStats.droppedVideo);
+                m_pStatistics->SetProperty(STATISTICS_SEND_QUEUE_DROPPED_AUDIO, queueStats.droppedAudio);
+            }
+
+            const UDPServerSessionImpl* udpSession = dynamic_cast<const UDPServerSessionImpl*>(m_pClientSession.GetPtr());
+            if (udpSession != nullptr)
+            {
+                m_pStatistics->SetProperty(STATISTICS_SOCKET_RX_DROPS, int64_t(udpSession->GetReceiveDrops()));
+            }
+
             m_pStatistics->SetProperty(STATISTICS_LOCAL_UPDATE_TIME, now);
 
-            m_TotalBytesTx = m_VideoBytesTx = m_AudioBytesTx = m_CtrlBytesTx = m_UserBytesTx = 0;
-            m_TotalTxTimeAccum = m_VideoTxTimeAccum = m_AudioTxTimeAccum = m_CtrlTxTimeAccum = m_UserTxTimeAccum = m_EncryptTimeAccum = m_DecryptTimeAccum = 0;
-            m_TotalTxCnt = m_VideoTxCnt = m_AudioTxCnt = m_CtrlTxCnt = m_UserTxCnt = m_TotalRxCnt = 0;
-            m_AudioBytesRx = m_CtrlBytesRx = m_UserBytesRx = 0;
-            m_AudioRxCnt = m_CtrlRxCnt = m_UserRxCnt = 0;
-            m_SlowSendCnt = 0;
+            m_LastVideoFramesTx = videoFramesTx;
+            m_LastAudioFramesTx = audioFramesTx;
+            m_LastSlowSends = slowSends;
+            m_LastEncryptTime = encryptTime;
+            m_DecryptTimeAccum = 0;
+            m_TotalRxCnt = 0;
             m_WorstSendTime = 0;
             m_StatTime = now;
         }
@@ -349,6 +595,29 @@ namespace ssdk::transport_amd
         m_pStatistics->SetProperty(STATISTICS_UPDATE_TIME, amf_high_precision_clock());
     }
 
+    bool Subscriber::IsCursorCached(uint64_t hash)
+    {
+        amf::AMFLock lock(&m_Guard);
+        if (m_CursorCacheNegotiated == false && m_pClientSession != nullptr)
+        {
+            // The cache size arrives with the HELLO options which might not have been processed yet when the first cursor is sent
+            amf::AMFPropertyStoragePtr sessionProperties(m_pClientSession.GetPtr());
+            int64_t cacheSize = 0;
+            if (sessionProperties != nullptr && sessionProperties->GetProperty(ID_CURSOR_CACHE_SIZE, &cacheSize) == AMF_OK)
+            {
+                m_CursorCache.SetCapacity(cacheSize > 0 ? size_t(cacheSize) : 0);
+                m_CursorCacheNegotiated = true;
+            }
+        }
+        return m_CursorCache.Find(hash) != nullptr;
+    }
+
+    void Subscriber::SetCursorCached(uint64_t hash)
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_CursorCache.Insert(hash, true);
+    }
+
     ssdk::transport_common::Result Subscriber::GetSessionStatistics(amf::AMFPropertyStorage** pStatistics)
     {
         if (nullptr == pStatistics)
@@ -457,15 +726,13 @@ namespace ssdk::transport_amd
             break;
         }
         //  Statistics:
-        m_AudioBytesRx += len;
-        ++m_AudioRxCnt;
+        m_ChannelMetrics[ChannelMetrics::AUDIO].OnReceived(len);
     }
 
     void Subscriber::OnUserDefinedMessage(const void* /*message*/, size_t messageSize)
     {
         // Statistics:
-        m_UserBytesRx += messageSize;
-        ++m_UserRxCnt;
+        m_ChannelMetrics[ChannelMetrics::USER].OnReceived(messageSize);
     }
 
     ssdk::transport_common::Result Subscriber::SendEvent(const char* id, const ssdk::ctls::CtlEvent* pEvent)
@@ -44,18 +44,27 @@ THE SOFTWARE.
 #include "transports/transport-common/ServerTransport.h"
 #include "TransportSession.h"
 #include "util/encryption/AESPSKCipher.h"
+#include "util/metrics/MetricsRegistry.h"
 #include "amf/public/common/Thread.h"
 #include "transports/transport-amd/messages/service/Stats.h"
 #include "transports/transport-amd/messages/sensors/DeviceEvent.h"
 #include "transports/transport-amd/messages/sensors/TrackableDeviceCaps.h"
+#include "CursorCache.h"
+#include "SendQueue.h"
+#include "SessionResumption.h"
 #include <list>
+#include <map>
+#include <memory>
+#include <set>
 
 namespace ssdk::transport_amd
 {
     //----------------------------------------------------------------------------------------------
     // Subscriber class
     //----------------------------------------------------------------------------------------------
-    class Subscriber : public ssdk::transport_common::Transport
+    class Subscriber :
+        public ssdk::transport_common::Transport,
+        public SendQueue::Sender
     {
     public:
         Subscriber(Session::Ptr pClientSession, amf::AMFContextPtr pContext);
@@ -76,6 +85,10 @@ namespace ssdk::transport_amd
         // Miscellaneous
         virtual ssdk::transport_common::Result TransmitMessage(const void* msg, size_t msgLength); // Send a subscriber-defined message to the client
         virtual ssdk::transport_common::Result TransmitMessage(Channel channel, const void* msg, size_t msgLen);
+        virtual ssdk::transport_common::Result TransmitMessage(Channel channel, const void* msg, size_t msgLen, SendQueue::MessageClass messageClass, amf_pts frameID);
+        //  A leased message is queued by reference, several subscribers can share one buffer
+        virtual ssdk::transport_common::Result TransmitMessage(Channel channel, const ssdk::util::BufferPool::Lease& msg);
+        virtual ssdk::transport_common::Result TransmitMessage(Channel channel, const ssdk::util::BufferPool::Lease& msg, SendQueue::MessageClass messageClass, amf_pts frameID);
         inline transport_common::ServerTransport::ConnectionManagerCallback::ClientRole GetRole() const noexcept { return m_Role; }
         virtual ssdk::transport_common::Result GetSessionStatistics(amf::AMFPropertyStorage** pStatistics); // Receive streaming statistics for this subscriber session
         virtual ssdk::transport_common::Result OnEvent(DeviceEvent& data, size_t dataSize);
@@ -112,15 +125,90 @@ namespace ssdk::transport_amd
         inline void SetVideoInitSentTime(amf_pts timestamp) { amf::AMFLock lock(&m_Guard); m_LastVideoInitSentTime = timestamp; }
 
         inline void SetAudioInitSentTime(amf_pts timestamp) { amf::AMFLock lock(&m_Guard); m_LastAudioInitSentTime = timestamp; }
+        // The init ID of the last AudioInit sent on the stream, stamped on audio data the client may receive ahead of the init
+        void SetAudioInitID(ssdk::transport_common::StreamID streamID, ssdk::transport_common::InitID initID);
+        ssdk::transport_common::InitID GetAudioInitID(ssdk::transport_common::StreamID streamID) const;
 
         inline void SetEncoderStereo(bool stereo) { amf::AMFLock lock(&m_Guard); m_EncoderStereo = stereo; }
 
         void UpdateStatsFromClient(const Statistics& stat);
 
+        //  Video and audio are sent from a dedicated thread through a bounded queue once enabled, see SendQueue.h
+        void EnableSendQueue(size_t maxDepth, amf_pts maxAge);
+        bool TakeKeyFrameRequest();
+        bool SetPacingBitrate(int64_t bitrate);     //  False without a send queue, see SendQueue::SetPacingBitrate()
+
+        // SendQueue::Sender interface
+        virtual ssdk::transport_common::Result SendQueuedMessage(Channel channel, const void* msg, size_t msgLen) override;
+
+        // Cursor cache mirror: tracks which cursor bitmaps the client is holding, always empty for clients without a cursor cache
+        bool IsCursorCached(uint64_t hash);
+        void SetCursorCached(uint64_t hash);
+
+        // Session resumption, see SessionResumption.h. The state is shared with the ticket issued to this subscriber
+        inline ResumptionState::Ptr GetResumptionState() const { amf::AMFLock lock(&m_Guard); return m_pResumptionState; }
+        inline void SetResumptionState(ResumptionState::Ptr pState) { amf::AMFLock lock(&m_Guard); m_pResumptionState = pState; }
+        inline std::string GetResumeTicket() const { amf::AMFLock lock(&m_Guard); return m_ResumeTicket; }
+        inline void SetResumeTicket(const std::string& ticket) { amf::AMFLock lock(&m_Guard); m_ResumeTicket = ticket; }
+        inline bool IsResumed() const { amf::AMFLock lock(&m_Guard); return m_Resumed; }
+        inline void SetResumed() { amf::AMFLock lock(&m_Guard); m_Resumed = true; }
+        // The challenge sent in the HELLO response for the ticket the client presented, taken once the client answers it
+        void SetResumeChallenge(const std::string& ticket, const std::string& challenge);
+        bool GetResumeChallenge(std::string* challenge) const;
+        bool TakeResumeChallenge(std::string* ticket, std::string* challenge);
+
+        // An init replayed on resumption is not sent again when the application sends the same one in response to the restored subscription
+        void SetInitReplayed(Channel channel, ssdk::transport_common::StreamID streamID);
+        bool TakeInitReplayed(Channel channel, ssdk::transport_common::StreamID streamID);
+
     protected:
         void AddRemoteTimestamp(const DeviceEvent& event);
         void AddRemoteTimestamp(amf_pts local, amf_pts remote);
         void UpdateLocalStats();
+        ssdk::transport_common::Result SendMessage(Channel channel, const void* msg, size_t msgLen);
+
+        //  Traffic of one channel since the subscriber was created
+        class ChannelStats
+        {
+        public:
+            ChannelStats operator-(const ChannelStats& other) const;
+
+            uint64_t    m_BytesTx = 0;
+            uint64_t    m_BytesRx = 0;
+            uint64_t    m_MessagesTx = 0;
+            uint64_t    m_MessagesRx = 0;
+            amf_pts     m_SendTime = 0;
+        };
+
+        //  Per-channel counters exported through ssdk::util::MetricsRegistry, labeled with the subscriber and the channel.
+        //  The periodic statistics are computed from their increase since the previous update
+        class ChannelMetrics
+        {
+        public:
+            enum Index
+            {
+                VIDEO,
+                AUDIO,
+                CTRL,
+                USER,
+                OTHER,
+                COUNT
+            };
+
+        public:
+            void Init(const std::string& subscriber, const char* channel);
+
+            void OnSent(size_t bytes, amf_pts sendTime) noexcept;
+            void OnReceived(size_t bytes) noexcept;
+            ChannelStats GetStats() const noexcept;
+
+        private:
+            ssdk::util::MetricsRegistry::Counter::Ptr m_BytesTx;
+            ssdk::util::MetricsRegistry::Counter::Ptr m_BytesRx;
+            ssdk::util::MetricsRegistry::Counter::Ptr m_MessagesTx;
+            ssdk::util::MetricsRegistry::Counter::Ptr m_MessagesRx;
+            ssdk::util::MetricsRegistry::Counter::Ptr m_SendTime;
+        };
 
         class LocalToRemoteTimeMapping
         {
@@ -146,6 +234,16 @@ namespace ssdk::transport_amd
         Session::Ptr                        m_pClientSession;
         ssdk::util::AESPSKCipher::Ptr       m_pCipher;
         LocalToRemoteTimeMapping::Collection m_LocalToRemoteTimeMap;
+        CursorCache<bool>                   m_CursorCache;
+        bool                                m_CursorCacheNegotiated = false;
+        std::unique_ptr<SendQueue>          m_pSendQueue;
+        ResumptionState::Ptr                m_pResumptionState;
+        std::string                         m_ResumeTicket;
+        std::string                         m_ChallengedTicket;
+        std::string                         m_ResumeChallenge;
+        bool                                m_Resumed = false;
+        std::set<std::pair<Channel, ssdk::transport_common::StreamID>> m_ReplayedInits;
+        std::map<ssdk::transport_common::StreamID, ssdk::transport_common::InitID> m_AudioInitIDs;
 
         std::string                         m_ID;
         std::string                         m_SessionID;
@@ -159,42 +257,25 @@ namespace ssdk::transport_amd
 
         // Statistics:
         amf::AMFPropertyStoragePtr          m_pStatistics;
-        amf_pts                             m_VideoTxTimeAccum = 0;
-        uint64_t                            m_VideoTxCnt = 0;
-        uint64_t                            m_VideoBytesTx = 0;
-
-        amf_pts                             m_AudioTxTimeAccum = 0;
-        uint64_t                            m_AudioTxCnt = 0;
-        uint64_t                            m_AudioRxCnt = 0;
-        uint64_t                            m_AudioBytesTx = 0;
-        uint64_t                            m_AudioBytesRx = 0;
-
-        amf_pts                             m_CtrlTxTimeAccum = 0;
-        uint64_t                            m_CtrlTxCnt = 0;
-        uint64_t                            m_CtrlRxCnt = 0;
-        uint64_t                            m_CtrlBytesTx = 0;
-        uint64_t                            m_CtrlBytesRx = 0;
-
-        amf_pts                             m_UserTxTimeAccum = 0;
-        uint64_t                            m_UserTxCnt = 0;
-        uint64_t                            m_UserRxCnt = 0;
-        uint64_t                            m_UserBytesTx = 0;
-        uint64_t                            m_UserBytesRx = 0;
-
-        amf_pts                             m_TotalTxTimeAccum = 0;
-        uint64_t                            m_TotalTxCnt = 0;
-        uint64_t                            m_TotalRxCnt = 0;
-        uint64_t                            m_TotalBytesTx = 0;
-
-        int64_t                             m_SlowSendCnt = 0;
+        ChannelMetrics                      m_ChannelMetrics[ChannelMetrics::COUNT];
+        ChannelStats                        m_LastChannelStats[ChannelMetrics::COUNT];
+        ssdk::util::MetricsRegistry::Counter::Ptr m_VideoFramesTx;
+        ssdk::util::MetricsRegistry::Counter::Ptr m_AudioFramesTx;
+        ssdk::util::MetricsRegistry::Counter::Ptr m_SlowSends;
+        ssdk::util::MetricsRegistry::Counter::Ptr m_EncryptTime;
+        ssdk::util::MetricsRegistry::Histogram::Ptr m_SendDuration;
+        uint64_t                            m_LastVideoFramesTx = 0;
+        uint64_t                            m_LastAudioFramesTx = 0;
+        uint64_t                            m_LastSlowSends = 0;
+        amf_pts                             m_LastEncryptTime = 0;
         amf_pts                             m_WorstSendTime = 0;
 
         amf_pts                             m_StatTime = 0;
 
         bool                                m_EncoderStereo = false;
 
-        amf_pts                             m_EncryptTimeAccum = 0;
         amf_pts                             m_DecryptTimeAccum = 0;
+        uint64_t                            m_TotalRxCnt = 0;
 
         int64_t                             m_ForceIDRReqCnt = 0;
         bool                                m_WaitingForIDR = true;
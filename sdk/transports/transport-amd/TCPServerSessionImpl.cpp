@@ -51,13 +51,25 @@ namespace ssdk::transport_amd
         net::StreamServerSession(sock),
         m_Peer(peer)
     {
-        int yes = 1;
-        sock->SetSocketOpt(IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        net::SocketTuning tuning = server->GetSocketTuning();
+        if (sock->GetProtocol() == net::Socket::Protocol::PROTO_TCP)    //  Also used for Unix domain sockets by LocalServerSessionImpl
+        {
+            int yes = 1;
+            sock->SetSocketOpt(IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
 
-        int recvBufSize = SOCKET_BUF_SIZE_RCV;
-        sock->SetSocketOpt(SOL_SOCKET, SO_RCVBUF, &recvBufSize, sizeof(recvBufSize));
-        int sendBufSize = SOCKET_BUF_SIZE_SND;
-        sock->SetSocketOpt(SOL_SOCKET, SO_SNDBUF, &sendBufSize, sizeof(sendBufSize));
+            //  A stream carries all channels in order, so the whole connection is marked as video
+            bool dscpMarking = true;
+            server->GetProperty(DATAGRAM_DSCP_MARKING, &dscpMarking);
+            if (dscpMarking == true)
+            {
+                tuning.SetTrafficClass(net::Socket::TrafficClass::VIDEO);
+            }
+        }
+        else
+        {
+            tuning.SetBusyPoll(0);  //  No NIC queue behind a Unix domain socket
+        }
+        tuning.Apply(sock);
         sock->SetTimeout(5);
     }
 
@@ -71,7 +83,7 @@ namespace ssdk::transport_amd
     transport_common::Result AMF_STD_CALL TCPServerSessionImpl::Send(Channel channel, const void* msg, size_t msgLen)
     {
         static FlowCtrlProtocol::MessageID msgID = 0;
-        transport_common::Result result = transport_common::Result::FAIL;
+        transport_common::Result result = transport_common::Result::OK;
         net::StreamSocket::Ptr socket(GetSocket());
         amf::AMFLock lock(&m_SendCS);	//  GK: This lock is necessary for TCP as Send can be called from different threads. Datagrams are atomic, but
                                         //  with TCP messages can get mixed up and confuse the parser on the receiving end
@@ -154,9 +166,8 @@ namespace ssdk::transport_amd
                     ConnectRequest helloRequest;
                     if (helloRequest.ParseBuffer(m_FlowCtrl.GetReceiveBuffer(), m_FlowCtrl.GetReceiveSize()))
                     {
-                        net::Socket::IPv4Address peer(*socket->GetPeerAddress());
                         std::string debugMsg = "HelloRequest command received from ";
-                        debugMsg += peer.GetAddressAsString();
+                        debugMsg += GetPeerUrl();
                         if (helloRequest.GetProtocolVersion() >= FlowCtrlProtocol::PROTOCOL_VERSION_MIN)
                         {
                             AMFTraceInfo(AMF_FACILITY, L"%S", debugMsg.c_str());
@@ -170,6 +181,7 @@ namespace ssdk::transport_amd
                                 m_Server->FillOptions(false, this, &resp.GetOptions());
                                 resp.UpdateData();
                                 Send(Channel::SERVICE, resp.GetSendData(), resp.GetSendSize());
+                                m_Server->ConnectionAccepted(this);
                             }
                             else
                             {
@@ -83,7 +83,7 @@ namespace ssdk::transport_amd
         virtual net::Session::Result AMF_STD_CALL OnSessionTimeout() override;
         virtual net::Session::Result AMF_STD_CALL OnSessionClose() override;
 
-    private:
+    protected:
         mutable amf::AMFCriticalSection m_SendCS;
         net::Socket::Address	        m_Peer;
         StreamFlowCtrlProtocol	        m_FlowCtrl;
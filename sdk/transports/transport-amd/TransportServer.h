@@ -62,6 +62,7 @@ namespace ssdk::transport_amd
         virtual transport_common::Result AMF_STD_CALL OnClientConnected(Session* session) = 0;
         virtual bool                     AMF_STD_CALL AuthorizeDiscoveryRequest(Session* session, const char* deviceID) = 0;
         virtual bool                     AMF_STD_CALL AuthorizeConnectionRequest(Session* session, const char* deviceID) = 0;
+        virtual void                     AMF_STD_CALL OnConnectionAccepted(Session* session) = 0;     // Called after the HELLO response has been sent
     };
     //---------------------------------------------------------------------------------------------
     class Server : public amf::AMFPropertyStorageEx
@@ -87,6 +88,15 @@ namespace ssdk::transport_amd
     extern const wchar_t* DATAGRAM_MSG_INTERVAL;            // amf_int64; default = 10; the interval in seconds for monitoring lost messages due to UDP Datagram size limitations
     extern const wchar_t* DATAGRAM_LOST_MSG_THRESHOLD;      // amf_int64; default = 10; the interval in seconds for monitoring lost messages due to UDP Datagram size limitations
     extern const wchar_t* DATAGRAM_TURNING_POINT_THRESHOLD; // amf_int64; default = 20; the turning point threshold for finding optimal max fragment size of messages sending by UDP
+    extern const wchar_t* DATAGRAM_PATH_MTU_DISCOVERY;      // bool; default = true; set DF on the UDP socket and probe each client for the largest datagram that gets through without IP fragmentation
+    extern const wchar_t* DATAGRAM_NETWORK_IMPAIRMENT;      // string; default = ""; when not empty, everything the UDP server sends goes through net::NetworkImpairment configured with this string. For testing only
+    extern const wchar_t* LOCAL_SOCKET_PATH;                // string; default = ""; when not empty, same-host clients can also connect with local://<path>, see LocalTransport.h. Linux only
+    extern const wchar_t* DATAGRAM_RECEIVE_SHARDS;          // amf_int64; default = 1; number of UDP sockets bound to the port with SO_REUSEPORT, each with its own receive thread and sessions. Linux only
+    extern const wchar_t* DATAGRAM_DSCP_MARKING;            // bool; default = true; mark video datagrams with DSCP AF41 and audio and input with EF, see net::Socket::TrafficClass
+    extern const wchar_t* SOCKET_MAX_BITRATE;               // amf_int64; default = 0; peak stream bitrate in bps the socket buffers are sized for, 0 keeps the default size
+    extern const wchar_t* SOCKET_FRAME_RATE;                // amf_int64; default = 60; frame rate the socket buffers are sized for together with SOCKET_MAX_BITRATE
+    extern const wchar_t* SOCKET_BUSY_POLL;                 // amf_int64; default = 0; SO_BUSY_POLL in microseconds on the server sockets, 0 disables. Linux only
+    extern const wchar_t* DATAGRAM_IO_URING;                // bool; default = false; receive and send datagrams through io_uring, see net::DatagramReceiveRing. Falls back to select() when unavailable. Linux only
 
     //----------------------------------------------------------------------------------------------
     // Statistics properties
@@ -126,6 +136,12 @@ namespace ssdk::transport_amd
     extern const wchar_t* STATISTICS_FORCE_IDR_REQ_COUNT;       // amf_int64; count of ForceIDR requests since last statistics
     extern const wchar_t* STATISTICS_SLOW_SEND_COUNT;           // amf_int64; count of sends that took longer than 50ms
     extern const wchar_t* STATISTICS_WORST_SEND_TIME;           // amf_float; worst send time in ms
+    extern const wchar_t* STATISTICS_SEND_QUEUE_DEPTH;          // amf_int64; number of messages waiting in the send queue
+    extern const wchar_t* STATISTICS_SEND_QUEUE_AGE;            // amf_float; average time messages spent in the send queue in ms
+    extern const wchar_t* STATISTICS_SEND_QUEUE_MAX_AGE;        // amf_float; longest time a message spent in the send queue in ms
+    extern const wchar_t* STATISTICS_SEND_QUEUE_DROPPED_VIDEO;  // amf_int64; count of video messages dropped by the send queue since last statistics
+    extern const wchar_t* STATISTICS_SEND_QUEUE_DROPPED_AUDIO;  // amf_int64; count of audio messages dropped by the send queue since last statistics
+    extern const wchar_t* STATISTICS_SOCKET_RX_DROPS;           // amf_int64; datagrams the kernel dropped since the server started because the socket receive buffer was full. Linux only
 
     extern const wchar_t* STATISTICS_AV_DESYNC;                 // amf_float; average audio-video desync (video-audio) in ms
 
@@ -62,6 +62,15 @@ namespace ssdk::transport_amd
     const wchar_t* DATAGRAM_MSG_INTERVAL = L"DGramInterval";                    // amf_int64; default = 10; the interval in seconds for monitoring lost messages due to UDP Datagram size limitations
     const wchar_t* DATAGRAM_LOST_MSG_THRESHOLD = L"DGramLostMsgCountThreshold"; // amf_int64; default = 10; the interval in seconds for monitoring lost messages due to UDP Datagram size limitations
     const wchar_t* DATAGRAM_TURNING_POINT_THRESHOLD = L"DGramDecisionThreshold";// amf_int64; default = 10; the interval in seconds for monitoring lost messages due to UDP Datagram size limitations
+    const wchar_t* DATAGRAM_PATH_MTU_DISCOVERY = L"DGramPathMtuDiscovery";      // bool; default = true; set DF on the UDP socket and probe each client for the largest datagram that gets through without IP fragmentation
+    const wchar_t* DATAGRAM_NETWORK_IMPAIRMENT = L"DGramNetworkImpairment";     // string; default = ""; when not empty, everything the UDP server sends goes through net::NetworkImpairment configured with this string. For testing only
+    const wchar_t* LOCAL_SOCKET_PATH = L"LocalSocketPath";                      // string; default = ""; when not empty, same-host clients can also connect with local://<path>, see LocalTransport.h. Linux only
+    const wchar_t* DATAGRAM_RECEIVE_SHARDS = L"DGramReceiveShards";             // amf_int64; default = 1; number of UDP sockets bound to the port with SO_REUSEPORT, each with its own receive thread and sessions. Linux only
+    const wchar_t* DATAGRAM_DSCP_MARKING = L"DGramDscpMarking";                 // bool; default = true; mark video datagrams with DSCP AF41 and audio and input with EF, see net::Socket::TrafficClass
+    const wchar_t* SOCKET_MAX_BITRATE = L"SocketMaxBitrate";                    // amf_int64; default = 0; peak stream bitrate in bps the socket buffers are sized for, 0 keeps the default size
+    const wchar_t* SOCKET_FRAME_RATE = L"SocketFrameRate";                      // amf_int64; default = 60; frame rate the socket buffers are sized for together with SOCKET_MAX_BITRATE
+    const wchar_t* SOCKET_BUSY_POLL = L"SocketBusyPoll";                        // amf_int64; default = 0; SO_BUSY_POLL in microseconds on the server sockets, 0 disables. Linux only
+    const wchar_t* DATAGRAM_IO_URING = L"DGramIoUring";                         // bool; default = false; receive and send datagrams through io_uring, see net::DatagramReceiveRing. Falls back to select() when unavailable. Linux only
 
     //----------------------------------------------------------------------------------------------
     // Statistics properties
@@ -101,6 +110,12 @@ namespace ssdk::transport_amd
     const wchar_t* STATISTICS_FORCE_IDR_REQ_COUNT       = L"ForceIDRReqCnt";       // amf_int64; count of ForceIDR requests since last statistics
     const wchar_t* STATISTICS_SLOW_SEND_COUNT           = L"SlowSendCnt";          // amf_int64; count of sends that took longer than 50ms
     const wchar_t* STATISTICS_WORST_SEND_TIME           = L"WorstSendTime";        // amf_float; worst send time in ms
+    const wchar_t* STATISTICS_SEND_QUEUE_DEPTH          = L"SendQueueDepth";       // amf_int64; number of messages waiting in the send queue
+    const wchar_t* STATISTICS_SEND_QUEUE_AGE            = L"SendQueueAge";         // amf_float; average time messages spent in the send queue in ms
+    const wchar_t* STATISTICS_SEND_QUEUE_MAX_AGE        = L"SendQueueMaxAge";      // amf_float; longest time a message spent in the send queue in ms
+    const wchar_t* STATISTICS_SEND_QUEUE_DROPPED_VIDEO  = L"SendQueueDroppedVideo";// amf_int64; count of video messages dropped by the send queue since last statistics
+    const wchar_t* STATISTICS_SEND_QUEUE_DROPPED_AUDIO  = L"SendQueueDroppedAudio";// amf_int64; count of audio messages dropped by the send queue since last statistics
+    const wchar_t* STATISTICS_SOCKET_RX_DROPS           = L"SocketRxDrops";        // amf_int64; datagrams the kernel dropped since the server started because the socket receive buffer was full. Linux only
 
     const wchar_t* STATISTICS_AV_DESYNC                 = L"AVDesync";             // amf_float; average audio-video desync (video-audio) in ms
 
@@ -156,7 +171,7 @@ namespace ssdk::transport_amd
     {
         transport_common::Result result = transport_common::Result::OK;
         amf::AMFLock lock(&m_CritSect);
-        if (m_UDPServer != nullptr && m_UDPServer->IsServerRunning() == true)
+        if (IsUDPServerRunning() == true)
         {
             result = transport_common::Result::CANT_SET_WHILE_RUNNING;
         }
@@ -172,14 +187,43 @@ namespace ssdk::transport_amd
         return m_MaxFragmentSize;
     }
 
+    net::SocketTuning ServerImpl::GetSocketTuning()
+    {
+        net::SocketTuning tuning;
+        amf_int64 maxBitrate = 0;
+        amf_int64 frameRate = 60;
+        GetProperty(SOCKET_MAX_BITRATE, &maxBitrate);
+        GetProperty(SOCKET_FRAME_RATE, &frameRate);
+        if (maxBitrate > 0 && frameRate > 0)
+        {
+            int bufferSize = net::SocketTuning::GetBufferSizeFor(maxBitrate, AMF_SECOND / frameRate);
+            tuning.SetReceiveBufferSize(bufferSize);
+            tuning.SetSendBufferSize(bufferSize);
+        }
+        else
+        {
+            tuning.SetReceiveBufferSize(SOCKET_BUF_SIZE_RCV);
+            tuning.SetSendBufferSize(SOCKET_BUF_SIZE_SND);
+        }
+
+        amf_int64 busyPoll = 0;
+        GetProperty(SOCKET_BUSY_POLL, &busyPoll);
+        tuning.SetBusyPoll(int(busyPoll));
+        return tuning;
+    }
+
     //  Run the server in a thread
     transport_common::Result AMF_STD_CALL ServerImpl::Activate(const char* url, OnClientConnectCallback* connectCallback)
     {
         transport_common::Result result = transport_common::Result::OK;
 
         amf::AMFLock lock(&m_CritSect);
-        if ((m_UDPServer != nullptr && m_UDPServer->IsServerRunning() == true) ||
-            (m_TCPServer != nullptr && m_TCPServer->IsServerRunning() == true))
+        if (IsUDPServerRunning() == true ||
+            (m_TCPServer != nullptr && m_TCPServer->IsServerRunning() == true)
+#if defined(__linux)
+            || (m_LocalServer != nullptr && m_LocalServer->IsServerRunning() == true)
+#endif
+            )
         {
             result = transport_common::Result::ALREADY_RUNNING;
             AMFTraceWarning(AMF_FACILITY, L"StartService() already running");
@@ -191,8 +235,33 @@ namespace ssdk::transport_amd
             net::Url urlTemp(url, "udp", m_Port);
             m_Port = urlTemp.GetPort();
 
-            m_UDPServer = UDPServer::Ptr(new UDPServer(url, m_Port, m_MaxFragmentSize, *this/*, connectCallback*/));
-            result = m_UDPServer->StartServer();
+            size_t shardCount = 1;
+#if defined(__linux)
+            amf_int64 receiveShards = 1;
+            if (GetProperty(DATAGRAM_RECEIVE_SHARDS, &receiveShards) == AMF_OK && receiveShards > 1)
+            {
+                shardCount = static_cast<size_t>(receiveShards);
+            }
+#endif
+            for (size_t shard = 0; shard < shardCount; ++shard)
+            {
+                UDPServer::Ptr udpServer(new UDPServer(url, m_Port, m_MaxFragmentSize, *this, shard, shardCount));
+                result = udpServer->StartServer();
+                if (result == transport_common::Result::OK)
+                {
+                    m_UDPServers.push_back(udpServer);
+                }
+                else if (shard > 0)
+                {   //  The first shard is bound, carry on with the ones that could join its port
+                    AMFTraceWarning(AMF_FACILITY, L"StartService() Failed to start UDP receive shard %d, running with %d", (int)shard, (int)shard);
+                    result = transport_common::Result::OK;
+                    break;
+                }
+                else
+                {
+                    break;
+                }
+            }
             if (result != transport_common::Result::OK)
             {
                 AMFTraceError(AMF_FACILITY, L"StartService() Failed to start UDP server");
@@ -206,10 +275,27 @@ namespace ssdk::transport_amd
                 {
                     AMFTraceError(AMF_FACILITY, L"StartService() Failed to start TCP server. url=%S", urlTemp.GetUrl().c_str());
                     m_TCPServer = nullptr;
-                    m_UDPServer = nullptr;
+                    StopUDPServers();
+                    m_pConnectCallback = nullptr;
+                }
+            }
+#if defined(__linux)
+            amf::AMFVariant localPath;
+            if (result == transport_common::Result::OK &&
+                GetProperty(LOCAL_SOCKET_PATH, &localPath) == AMF_OK && localPath.type == amf::AMF_VARIANT_STRING && std::string(localPath.ToString().c_str()).empty() == false)
+            {
+                m_LocalServer = LocalServer::Ptr(new LocalServer(localPath.ToString().c_str(), m_MaxFragmentSize, *this));
+                result = m_LocalServer->StartServer();
+                if (result != transport_common::Result::OK)
+                {
+                    AMFTraceError(AMF_FACILITY, L"StartService() Failed to start local server at %S", localPath.ToString().c_str());
+                    m_LocalServer = nullptr;
+                    m_TCPServer = nullptr;
+                    StopUDPServers();
                     m_pConnectCallback = nullptr;
                 }
             }
+#endif
             if (result == transport_common::Result::OK)
             {
                 AMFTraceInfo(AMF_FACILITY, L"StartService() Network services started. url=%S", urlTemp.GetUrl().c_str());
@@ -224,19 +310,22 @@ namespace ssdk::transport_amd
         transport_common::Result result = transport_common::Result::NOT_RUNNING;
         {
             amf::AMFLock    lock(&m_CritSect);
-            if ((m_UDPServer != nullptr && m_UDPServer->IsServerRunning() == true) ||
-                (m_TCPServer != nullptr && m_TCPServer->IsServerRunning() == true))
+            if (IsUDPServerRunning() == true ||
+                (m_TCPServer != nullptr && m_TCPServer->IsServerRunning() == true)
+#if defined(__linux)
+                || (m_LocalServer != nullptr && m_LocalServer->IsServerRunning() == true)
+#endif
+                )
             {
                 result = transport_common::Result::OK;
             }
         }
         if (result == transport_common::Result::OK)
         {
-            if (m_UDPServer != nullptr)
+            if (m_UDPServers.empty() == false)
             {
                 AMFTraceInfo(AMF_FACILITY, L"StopService() UDP server shutdown");
-                m_UDPServer->StopServer();
-                m_UDPServer = nullptr;
+                StopUDPServers();
             }
             if (m_TCPServer != nullptr)
             {
@@ -244,6 +333,14 @@ namespace ssdk::transport_amd
                 m_TCPServer->StopServer();
                 m_TCPServer = nullptr;
             }
+#if defined(__linux)
+            if (m_LocalServer != nullptr)
+            {
+                AMFTraceInfo(AMF_FACILITY, L"StopService() local server shutdown");
+                m_LocalServer->StopServer();
+                m_LocalServer = nullptr;
+            }
+#endif
             amf::AMFLock    lock(&m_CritSect);
             m_pConnectCallback = nullptr;
         }
@@ -262,6 +359,34 @@ namespace ssdk::transport_amd
         m_Connected = val;
     }
 
+    bool ServerImpl::IsUDPServerRunning() const
+    {
+        for (const UDPServer::Ptr& udpServer : m_UDPServers)
+        {
+            if (udpServer->IsServerRunning() == true)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ServerImpl::StopUDPServers()
+    {
+        for (UDPServer::Ptr& udpServer : m_UDPServers)
+        {
+            udpServer->StopServer();
+        }
+        m_UDPServers.clear();
+
+        {
+            amf::AMFLock lock(&m_DiscoveryGuard);
+            m_RecentDiscoveries.clear();
+        }
+        amf::AMFLock lock(&m_ConnectionGuard);
+        m_Connections.clear();
+    }
+
     transport_common::Result     ServerImpl::SetOptionProvider(OnFillOptionsCallback* provider)
     {
         amf::AMFLock    lock(&m_CritSect);
@@ -271,14 +396,20 @@ namespace ssdk::transport_amd
 
     void ServerImpl::SetSessionTimeoutEnabled(bool timeoutEnabled)
     {
-        if (m_UDPServer != nullptr)
+        for (UDPServer::Ptr& udpServer : m_UDPServers)
         {
-            m_UDPServer->SetSessionTimeoutEnabled(timeoutEnabled);
+            udpServer->SetSessionTimeoutEnabled(timeoutEnabled);
         }
         if (m_TCPServer != nullptr)
         {
             m_TCPServer->SetSessionTimeoutEnabled(timeoutEnabled);
         }
+#if defined(__linux)
+        if (m_LocalServer != nullptr)
+        {
+            m_LocalServer->SetSessionTimeoutEnabled(timeoutEnabled);
+        }
+#endif
     }
 
     void ServerImpl::FillOptions(bool discovery, Session* session, HelloResponse::Options* options)
@@ -300,4 +431,47 @@ namespace ssdk::transport_amd
         amf::AMFLock lock(&m_CritSect);
         return m_pConnectCallback->AuthorizeConnectionRequest(session, deviceID.empty() == false ? deviceID.c_str() : nullptr);
     }
+
+    void ServerImpl::ConnectionAccepted(Session* session)
+    {
+        m_pConnectCallback->OnConnectionAccepted(session);
+    }
+
+    bool ServerImpl::ClaimDiscoveryRequest(const net::Socket::Address& peer)
+    {
+        static constexpr const amf_pts DISCOVERY_CLAIM_WINDOW = 500 * AMF_MILLISECOND;    //  Shorter than the interval clients repeat discovery at
+
+        amf_pts now = amf_high_precision_clock();
+        amf::AMFLock lock(&m_DiscoveryGuard);
+        for (std::map<net::Socket::Address, amf_pts>::iterator it = m_RecentDiscoveries.begin(); it != m_RecentDiscoveries.end();)
+        {
+            it = now - it->second > DISCOVERY_CLAIM_WINDOW ? m_RecentDiscoveries.erase(it) : std::next(it);
+        }
+        return m_RecentDiscoveries.emplace(peer, now).second;
+    }
+
+    net::DatagramServerSession::ConnectionID ServerImpl::RegisterConnection(net::DatagramServerSession* session)
+    {
+        amf::AMFLock lock(&m_ConnectionGuard);
+        net::DatagramServerSession::ConnectionID connectionID = net::DatagramServerSession::INVALID_CONNECTION_ID;
+        do
+        {
+            connectionID = static_cast<net::DatagramServerSession::ConnectionID>(m_ConnectionIDGenerator());
+        } while (connectionID == net::DatagramServerSession::INVALID_CONNECTION_ID || m_Connections.find(connectionID) != m_Connections.end());
+        m_Connections[connectionID] = net::DatagramServerSession::Ptr(session);
+        return connectionID;
+    }
+
+    void ServerImpl::UnregisterConnection(net::DatagramServerSession::ConnectionID connectionID)
+    {
+        amf::AMFLock lock(&m_ConnectionGuard);
+        m_Connections.erase(connectionID);
+    }
+
+    net::DatagramServerSession::Ptr ServerImpl::FindConnection(net::DatagramServerSession::ConnectionID connectionID)
+    {
+        amf::AMFLock lock(&m_ConnectionGuard);
+        std::map<net::DatagramServerSession::ConnectionID, net::DatagramServerSession::Ptr>::iterator it = m_Connections.find(connectionID);
+        return it != m_Connections.end() ? it->second : nullptr;
+    }
 }
\ No newline at end of file
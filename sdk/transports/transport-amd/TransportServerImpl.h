@@ -44,12 +44,16 @@ THE SOFTWARE.
 #include "TransportServer.h"
 #include "net/DatagramServer.h"
 #include "net/StreamServer.h"
+#include "net/SocketTuning.h"
 
 #include "amf/public/common/InterfaceImpl.h"
 #include "amf/public/common/Thread.h"
 #include "amf/public/common/PropertyStorageExImpl.h"
 
 #include <set>
+#include <map>
+#include <random>
+#include <vector>
 
 namespace ssdk::transport_amd
 {
@@ -66,7 +70,7 @@ namespace ssdk::transport_amd
             typedef std::shared_ptr<UDPServer>	Ptr;
 
         public:
-            UDPServer(const char* url, uint16_t defaultPort, size_t maxFragmentSize, ServerImpl& server);
+            UDPServer(const char* url, uint16_t defaultPort, size_t maxFragmentSize, ServerImpl& server, size_t shard, size_t shardCount);
             ~UDPServer();
 
             transport_common::Result StartServer();
@@ -75,13 +79,25 @@ namespace ssdk::transport_amd
             virtual net::Session::Ptr AMF_STD_CALL OnCreateSession(const net::Socket::Address& peer, net::Socket* socket, uint8_t* buf, size_t bufSize) override;   //  Create a session on the connection returned by OnAcceptConnection()
 
             virtual void Run() override;
+
+        protected:
+            virtual bool AMF_STD_CALL ExtractConnectionID(uint8_t* buf, size_t& bufSize, net::DatagramServerSession::ConnectionID& connectionID) override;
+            virtual net::DatagramServerSession::Ptr AMF_STD_CALL FindSession(net::DatagramServerSession::ConnectionID connectionID) override;
+
         private:
+            static net::DatagramSocket* CreateSocket(ServerImpl& server);
+
             mutable amf::AMFCriticalSection     m_CritSect;
             ServerImpl&						    m_Server;
             std::string							m_Url;
             uint16_t							m_Port;
             uint32_t							m_MaxFragmentSize;
+            bool								m_PathMtuDiscovery = false;
+            bool                                m_DscpMarking = true;
+            size_t                              m_Shard = 0;
+            size_t                              m_ShardCount = 1;   //  When more than 1, all shards bind the same port with SO_REUSEPORT
         };
+        typedef std::vector<UDPServer::Ptr> UDPServers;
 
         class TCPServer :
             public ssdk::net::StreamServer,
@@ -108,6 +124,31 @@ namespace ssdk::transport_amd
             size_t                          m_MaxFragmentSize;
         };
 
+#if defined(__linux)
+        class LocalServer :
+            public ssdk::net::StreamServer,
+            protected amf::AMFThread
+        {
+        public:
+            typedef std::shared_ptr<LocalServer>	Ptr;
+
+        public:
+            LocalServer(const std::string& path, size_t maxFragmentSize, ServerImpl& server);
+            ~LocalServer();
+
+            transport_common::Result StartServer();
+            transport_common::Result StopServer();
+
+            virtual net::Session::Ptr AMF_STD_CALL OnCreateSession(const net::Socket::Address& peer, net::Socket* socket, uint8_t* buf, size_t bufSize) override;   //  Create a session on the connection returned by OnAcceptConnection()
+
+            virtual void Run() override;
+        private:
+            mutable amf::AMFCriticalSection m_CritSect;
+            ServerImpl&                     m_Server;
+            std::string                     m_Path;
+        };
+#endif
+
     public:
         // {9D6BF699-7436-47A6-A248-A422C874722C}
         AMF_DECLARE_IID(0x9d6bf699, 0x7436, 0x47a6, 0xa2, 0x48, 0xa4, 0x22, 0xc8, 0x74, 0x72, 0x2c);
@@ -137,14 +178,25 @@ namespace ssdk::transport_amd
         const std::string& GetName() const noexcept;
         uint16_t GetPort() const noexcept;
         size_t GetDatagramSize() const noexcept;
+        net::SocketTuning GetSocketTuning();    //  From the SOCKET_* properties, for every socket the server sends media through
 
         void FillOptions(bool discovery, Session* session, HelloResponse::Options* options);
 
-        inline bool IsUDPSupported() const { return m_UDPServer != nullptr; }
+        inline bool IsUDPSupported() const { return m_UDPServers.empty() == false; }
         inline bool IsTCPSupported() const { return m_TCPServer != nullptr; }
+#if defined(__linux)
+        inline bool IsLocalSupported() const { return m_LocalServer != nullptr; }
+#endif
 
         bool AuthorizeDiscoveryRequest(Session* session, const std::string& deviceID);
         bool AuthorizeConnectionRequest(Session* session, const std::string& deviceID);
+        void ConnectionAccepted(Session* session);
+        bool ClaimDiscoveryRequest(const net::Socket::Address& peer);     //  A broadcast reaches every UDP shard, only the first one to claim it answers
+
+        //  Connection IDs are unique across the UDP shards, a migrated client may be hashed to a shard other than the one its session lives in
+        net::DatagramServerSession::ConnectionID RegisterConnection(net::DatagramServerSession* session);
+        void UnregisterConnection(net::DatagramServerSession::ConnectionID connectionID);
+        net::DatagramServerSession::Ptr FindConnection(net::DatagramServerSession::ConnectionID connectionID);
 
         void SetServerTransport(ServerTransportImpl* pServerTransport) { m_pServerTransport = pServerTransport; };
         ServerTransportImpl* GetServerTransport() { return m_pServerTransport; };
@@ -153,6 +205,8 @@ namespace ssdk::transport_amd
         // helpers
         bool IsConnected() const noexcept;
         void SetConnected(bool val) noexcept;
+        bool IsUDPServerRunning() const;
+        void StopUDPServers();
 
     private:
         ServerImpl(const ServerImpl&) = delete;
@@ -167,8 +221,16 @@ namespace ssdk::transport_amd
         size_t								m_MaxFragmentSize;  // Datagram size setting in configuration
         OnClientConnectCallback*            m_pConnectCallback = nullptr;
         OnFillOptionsCallback *             m_pOptionsProvider = nullptr;
-        UDPServer::Ptr						m_UDPServer;
+        UDPServers                          m_UDPServers;       //  One per receive shard
+        mutable amf::AMFCriticalSection     m_DiscoveryGuard;
+        std::map<net::Socket::Address, amf_pts> m_RecentDiscoveries;
+        mutable amf::AMFCriticalSection     m_ConnectionGuard;
+        std::map<net::DatagramServerSession::ConnectionID, net::DatagramServerSession::Ptr> m_Connections;
+        std::mt19937                        m_ConnectionIDGenerator{ std::random_device()() };
         TCPServer::Ptr						m_TCPServer;
+#if defined(__linux)
+        LocalServer::Ptr                    m_LocalServer;
+#endif
         ServerTransportImpl*                m_pServerTransport = nullptr;
 
         bool								m_PairingModeEnabled = false;
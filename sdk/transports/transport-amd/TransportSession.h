@@ -68,6 +68,11 @@ namespace ssdk::transport_amd
         //  DO NOT make any assumptions about the lifecycle of the buffer. If you need to preserve the data, either copy
         //  it to your own buffer, or manage buffers yourself through BufferAllocator.
         virtual void            AMF_STD_CALL OnMessageReceived(Session* session, Channel channel, int msgID, const void* message, size_t messageSize) = 0;
+        //  Called instead of OnMessageReceived() for a message the server did not encrypt because it never left the host, see LocalTransport.h
+        virtual void            AMF_STD_CALL OnClearTextMessageReceived(Session* session, Channel channel, int msgID, const void* message, size_t messageSize)
+        {
+            OnMessageReceived(session, channel, msgID, message, messageSize);
+        }
         virtual void            AMF_STD_CALL OnTerminate(Session* session, TerminationReason reason) = 0;
     };
 
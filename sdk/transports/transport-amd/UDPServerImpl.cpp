@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include "Misc.h"
 #include "amf/public/common/TraceAdapter.h"
 #include "transports/transport-amd/ServerTransportImpl.h"
+#include "net/ImpairedDatagramSocket.h"
 
 #include <iostream>
 
@@ -56,12 +57,14 @@ static constexpr const size_t MAX_CONCURRENT_CONNECTIONS = 10;
 
 namespace ssdk::transport_amd
 {
-    ServerImpl::UDPServer::UDPServer(const char* url, uint16_t defaultPort, size_t maxFragmentSize, ServerImpl& server) :
-        net::DatagramServer(new net::DatagramSocket(), maxFragmentSize, MAX_CONCURRENT_CONNECTIONS, DISCONNECT_TIMEOUT),
+    ServerImpl::UDPServer::UDPServer(const char* url, uint16_t defaultPort, size_t maxFragmentSize, ServerImpl& server, size_t shard, size_t shardCount) :
+        net::DatagramServer(CreateSocket(server), maxFragmentSize, MAX_CONCURRENT_CONNECTIONS, DISCONNECT_TIMEOUT),
         m_Server(server),
         m_Url(url),
         m_Port(defaultPort),
-        m_MaxFragmentSize(static_cast<uint32_t>(maxFragmentSize))
+        m_MaxFragmentSize(static_cast<uint32_t>(maxFragmentSize)),
+        m_Shard(shard),
+        m_ShardCount(shardCount)
     {
     }
 
@@ -70,6 +73,27 @@ namespace ssdk::transport_amd
         StopServer();
     }
 
+    net::DatagramSocket* ServerImpl::UDPServer::CreateSocket(ServerImpl& server)
+    {
+        std::string spec;
+        amf::AMFVariant impairment;
+        if (server.GetProperty(DATAGRAM_NETWORK_IMPAIRMENT, &impairment) == AMF_OK && impairment.type == amf::AMF_VARIANT_STRING)
+        {
+            spec = impairment.ToString().c_str();
+        }
+        if (spec.empty() == false)
+        {
+            net::NetworkImpairment::Params params;
+            if (params.Parse(spec) == true)
+            {
+                AMFTraceWarning(AMF_FACILITY, L"UDPServer: outgoing traffic is impaired with \"%S\"", spec.c_str());
+                return new net::ImpairedDatagramSocket(params);
+            }
+            AMFTraceError(AMF_FACILITY, L"UDPServer: invalid network impairment \"%S\", ignored", spec.c_str());
+        }
+        return new net::DatagramSocket();
+    }
+
     net::Session::Ptr ServerImpl::UDPServer::OnCreateSession(const net::Socket::Address& peer, net::Socket*, uint8_t* buf, size_t bufSize)
     {
         FlowCtrlProtocol::Fragment fragment;
@@ -85,6 +109,10 @@ namespace ssdk::transport_amd
         {
             if (optCode == static_cast<uint8_t>(SERVICE_OP_CODE::DISCOVERY))   //  Special case for discovery broadcast
             {
+                if (m_ShardCount > 1 && m_Server.ClaimDiscoveryRequest(peer) == false)
+                {
+                    return nullptr;     //  Already answered by another shard
+                }
                 AMFTraceInfo(AMF_FACILITY, L"UDPServer::OnCreateSession: Discovery session created, client IP: %S", peer.GetParsedAddressAsString().c_str());
                 session = new amf::AMFInterfaceMultiImpl<DiscoveryServerSessionImpl, net::Session, ServerImpl*, net::DatagramSocket::Ptr, const net::Socket::Address&, size_t >(&m_Server, GetSocket(), peer, bufSize);
                 static_cast<UDPServerSessionImpl*>(session.GetPtr())->SetPeerAddress(net::Socket::IPv4Address(peer).GetAddressAsString());
@@ -139,11 +167,31 @@ namespace ssdk::transport_amd
             m_Server.GetProperty(DATAGRAM_TURNING_POINT_THRESHOLD, &tpThreshold);
             amf::AMFVariantAssignInt64(&vsTpThreshold, tpThreshold);
             static_cast<UDPServerSessionImpl*>(session.GetPtr())->SetProperty(DATAGRAM_TURNING_POINT_THRESHOLD, vsTpThreshold);
+
+            static_cast<UDPServerSessionImpl*>(session.GetPtr())->SetProperty(DATAGRAM_PATH_MTU_DISCOVERY, m_PathMtuDiscovery);
+            static_cast<UDPServerSessionImpl*>(session.GetPtr())->SetProperty(DATAGRAM_DSCP_MARKING, m_DscpMarking);
+            static_cast<UDPServerSessionImpl*>(session.GetPtr())->SetProperty(DATAGRAM_IO_URING, IsIoUringEnabled());
+
+            if (optCode == static_cast<uint8_t>(SERVICE_OP_CODE::HELLO))
+            {   //  Offered to the client in the HELLO response if it supports connection migration
+                UDPServerSessionImpl* udpSession = static_cast<UDPServerSessionImpl*>(session.GetPtr());
+                udpSession->SetConnectionID(m_Server.RegisterConnection(udpSession));
+            }
         }
 
         return session;
     }
 
+    bool ServerImpl::UDPServer::ExtractConnectionID(uint8_t* buf, size_t& bufSize, net::DatagramServerSession::ConnectionID& connectionID)
+    {
+        return FlowCtrlProtocol::StripConnectionID(buf, bufSize, connectionID);
+    }
+
+    net::DatagramServerSession::Ptr ServerImpl::UDPServer::FindSession(net::DatagramServerSession::ConnectionID connectionID)
+    {
+        return m_Server.FindConnection(connectionID);
+    }
+
     void ServerImpl::UDPServer::Run()
     {
         RunServer();
@@ -158,10 +206,39 @@ namespace ssdk::transport_amd
         socket->SetSocketOpt(SOL_SOCKET, SO_BROADCAST, &yes, sizeof(yes));
         yes = 1;
         //	socket->SetSocketOpt(SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
-        int recvBufSize = SOCKET_BUF_SIZE_RCV;
-        socket->SetSocketOpt(SOL_SOCKET, SO_RCVBUF, &recvBufSize, sizeof(recvBufSize));
-        int sendBufSize = SOCKET_BUF_SIZE_SND;
-        socket->SetSocketOpt(SOL_SOCKET, SO_SNDBUF, &sendBufSize, sizeof(sendBufSize));
+        //  Sessions of all clients share the socket, so it stays best effort and each datagram is marked by its channel instead
+        net::SocketTuning tuning = m_Server.GetSocketTuning();
+        tuning.SetCountReceiveDrops(true);
+        tuning.Apply(socket);
+#if defined(__linux)
+        //  The kernel spreads the clients over the shards by the hash of their address and port, so each client always
+        //  lands on the same shard and its session lives in that shard's session table
+        if (m_ShardCount > 1)
+        {
+            yes = 1;
+            if (socket->SetSocketOpt(SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) != net::Socket::Result::OK)
+            {
+                AMFTraceError(AMF_FACILITY, L"UDPServer::StartServer: unable to set SO_REUSEPORT on shard %d", (int)m_Shard);
+                return transport_common::Result::FAIL;
+            }
+        }
+#endif
+
+        bool dscpMarking = true;
+        m_Server.GetProperty(DATAGRAM_DSCP_MARKING, &dscpMarking);
+        m_DscpMarking = dscpMarking;
+
+        bool ioUring = false;
+        m_Server.GetProperty(DATAGRAM_IO_URING, &ioUring);
+        EnableIoUring(ioUring);
+
+        bool pathMtuDiscovery = true;
+        m_Server.GetProperty(DATAGRAM_PATH_MTU_DISCOVERY, &pathMtuDiscovery);
+        m_PathMtuDiscovery = pathMtuDiscovery == true && socket->SetDontFragment(true) == net::Socket::Result::OK;
+        if (pathMtuDiscovery == true && m_PathMtuDiscovery == false)
+        {
+            AMFTraceWarning(AMF_FACILITY, L"UDPServer::StartServer: unable to set DF on the server socket, path MTU discovery disabled");
+        }
 
         net::Url urlTemp(m_Url, "udp", m_Port);
         net::Socket::Ptr   sock(m_Socket);
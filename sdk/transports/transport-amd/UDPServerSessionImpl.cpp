@@ -35,6 +35,7 @@ THE SOFTWARE.
 
 #include "UDPServerSessionImpl.h"
 #include "Channels.h"
+#include "Misc.h"
 #include "DgramClientSessionFlowCtrl.h"
 #include "messages/service/Connect.h"
 
@@ -43,8 +44,13 @@ THE SOFTWARE.
 #include "public/include/core/Platform.h"
 #include "public/common/TraceAdapter.h"
 
+#include <algorithm>
+#include <random>
+
 static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::transport_amd::UDPServerSessionImpl";
 
+static constexpr const amf_pts PATH_CHALLENGE_RESEND_INTERVAL = AMF_SECOND / 5;
+
 namespace ssdk::transport_amd
 {
     UDPServerSessionImpl::UDPServerSessionImpl(ServerImpl* server, net::DatagramSocket* sock, const net::Socket::Address& peer, uint32_t configMaxFragmentSize) :
@@ -63,6 +69,7 @@ namespace ssdk::transport_amd
             AMFTraceError(AMF_FACILITY, L"%S", infoMsg.str().c_str());
             m_TxMaxFragmentSize = FlowCtrlProtocol::MAX_DATAGRAM_SIZE;  //Set to max
         }
+        m_ConfigMaxFragmentSize = m_TxMaxFragmentSize;
 
         m_pFlowCtrl = FlowCtrlProtocol::Ptr(new FlowCtrlProtocol(FlowCtrlProtocol::PROTOCOL_VERSION_CURRENT));
 
@@ -89,25 +96,128 @@ namespace ssdk::transport_amd
 
     bool UDPServerSessionImpl::OnTickNotify()
     {
+        ProcessPathMtuDiscovery();
         return m_pFlowCtrl->TickNotify(*this);
     }
 
-    net::Socket::Result UDPServerSessionImpl::OnFragmentReady(const FlowCtrlProtocol::Fragment& fragment, bool /*last*/)
+    net::Socket::Result UDPServerSessionImpl::OnFragmentReady(const FlowCtrlProtocol::Fragment& fragment, bool last)
     {
         size_t bytesSent = 0;
-        return Send(fragment.GetDataToSend(), fragment.GetSizeToSend(), &bytesSent, 0);
+        net::Socket::TrafficClass trafficClass = m_DscpMarking == true ? GetChannelTrafficClass(fragment.GetChannelID()) : net::Socket::TrafficClass::BEST_EFFORT;
+        net::DatagramSendRing* ring = GetSendRing();
+        if (ring != nullptr)
+        {   //  The fragments of a message go out in one batch
+            net::Socket::Result result = ring->Add(m_Socket, fragment.GetDataToSend(), fragment.GetSizeToSend(), GetPeer(), 0, trafficClass);
+            return result == net::Socket::Result::OK && last == true ? ring->Flush() : result;
+        }
+        return Send(fragment.GetDataToSend(), fragment.GetSizeToSend(), &bytesSent, 0, trafficClass);
+    }
+
+    net::DatagramSendRing* UDPServerSessionImpl::GetSendRing() const
+    {
+        return m_IoUring == true && m_Socket->SupportsSendRing() == true ? net::DatagramSendRing::GetThreadInstance() : nullptr;
+    }
+
+    net::Socket::Address UDPServerSessionImpl::GetPeer()
+    {
+        amf::AMFLock lock(&m_PeerGuard);
+        return m_Peer;
     }
 
     void UDPServerSessionImpl::OnSetMaxFragmentSize(size_t fragmentSize)
     {
-        m_TxMaxFragmentSize = fragmentSize;
+        amf::AMFLock lock(&m_PathMtuGuard);
+        if (m_PathMtuDiscovery.IsActive() == true)
+        {   //  Losses of large messages while the PLPMTU is in use most likely mean that the path has changed
+            m_NextPathMtuProbeTime = 0;
+            if (m_PathMtuDiscovery.OnBlackHoleSuspected(amf_high_precision_clock()) == true)
+            {
+                m_TxMaxFragmentSize = std::min(m_ConfigMaxFragmentSize, m_PathMtuDiscovery.GetPlpmtu());
+                AMFTraceInfo(AMF_FACILITY, L"Path MTU black hole suspected, max fragment size reset to %d", (int)m_TxMaxFragmentSize);
+            }
+        }
+        else if (m_PathMtuDiscoveryEnabled == true)
+        {
+            m_TxMaxFragmentSize = std::min(fragmentSize, PathMtuDiscovery::BASE_PLPMTU);
+        }
+        else
+        {
+            m_TxMaxFragmentSize = fragmentSize;
+        }
+    }
+
+    void UDPServerSessionImpl::StartPathMtuDiscovery()
+    {
+        amf::AMFLock lock(&m_PathMtuGuard);
+        bool clientProbing = false;
+        if (m_PathMtuDiscoveryEnabled == true && GetProperty(ID_PATH_MTU_PROBING, &clientProbing) == AMF_OK && clientProbing == true)
+        {
+            m_PathMtuDiscovery.Start(m_ConfigMaxFragmentSize, amf_high_precision_clock());
+            m_NextPathMtuProbeTime = 0;
+            AMFTraceDebug(AMF_FACILITY, L"Path MTU discovery started, max fragment size: %d", (int)m_ConfigMaxFragmentSize);
+        }
+    }
+
+    void UDPServerSessionImpl::ProcessPathMtuDiscovery()
+    {
+        //  Called for every datagram received, most calls have nothing to do and must not contend for the lock
+        amf_pts now = amf_high_precision_clock();
+        if (now < m_NextPathMtuProbeTime)
+        {
+            return;
+        }
+
+        //  Probes are built under the lock but sent without it, Send() may block until the socket is writable
+        bool tooBig = false;
+        size_t probeSize = 0;
+        do
+        {
+            FlowCtrlProtocol::Fragment probe;
+            {
+                amf::AMFLock lock(&m_PathMtuGuard);
+                if (tooBig == true)
+                {   //  Larger than the MTU of the local interface, no need to wait for the probe to time out
+                    m_PathMtuDiscovery.OnPacketTooBig(probeSize, now);
+                }
+                FlowCtrlProtocol::MessageID probeID = 0;
+                if (m_PathMtuDiscovery.IsActive() == false || m_PathMtuDiscovery.GetNextProbe(now, probeSize, probeID) == false)
+                {
+                    break;
+                }
+                probe = FlowCtrlProtocol::CreatePathMtuProbe(probeID, FlowCtrlProtocol::PathMtuProbeType::PROBE, static_cast<uint32_t>(probeSize), probeSize);
+            }
+            size_t bytesSent = 0;
+            tooBig = Send(probe.GetDataToSend(), probe.GetSizeToSend(), &bytesSent, 0) == net::Socket::Result::MESSAGE_TOO_BIG;
+        } while (tooBig == true);
+
+        amf::AMFLock lock(&m_PathMtuGuard);
+        if (m_PathMtuDiscovery.IsActive() == true)
+        {
+            size_t fragmentSize = std::min(m_ConfigMaxFragmentSize, m_PathMtuDiscovery.GetPlpmtu());
+            if (fragmentSize != m_TxMaxFragmentSize)
+            {
+                m_TxMaxFragmentSize = fragmentSize;
+                AMFTraceInfo(AMF_FACILITY, L"Path MTU discovery: max fragment size set to %d", (int)m_TxMaxFragmentSize);
+            }
+        }
+        m_NextPathMtuProbeTime = m_PathMtuDiscovery.GetNextProbeTime();
     }
 
-    net::Socket::Result AMF_STD_CALL UDPServerSessionImpl::Send(const void* buf, size_t size, size_t* const bytesSent, int flags)
+    net::Socket::Result AMF_STD_CALL UDPServerSessionImpl::Send(const void* buf, size_t size, size_t* const bytesSent, int flags, net::Socket::TrafficClass trafficClass)
     {
         net::Socket::Result result = net::Socket::Result::UNKNOWN_ERROR;
         //    result = m_Socket->SendTo(buf, size, GetPeerAddress(), bytesSent); //Mm original code - has to use selector to check if buffer is ready.
 
+        net::DatagramSendRing* ring = GetSendRing();
+        if (ring != nullptr)
+        {   //  The ring waits for the socket to become writable itself
+            if ((result = ring->Add(m_Socket, buf, size, GetPeer(), flags, trafficClass)) == net::Socket::Result::OK &&
+                (result = ring->Flush()) == net::Socket::Result::OK && bytesSent != nullptr)
+            {
+                *bytesSent = size;
+            }
+        }
+        else
         {
             net::Selector selector;
             selector.AddWritableSocket(m_Socket);
@@ -124,7 +234,12 @@ namespace ssdk::transport_amd
                 case net::Selector::Result::OK:
                     if (readyToSend.size() > 0)
                     {
-                        result = m_Socket->SendTo(buf, size, GetPeerAddress(), bytesSent, flags);
+                        net::Socket::Address peer;
+                        {
+                            amf::AMFLock lock(&m_PeerGuard);
+                            peer = m_Peer;
+                        }
+                        result = m_Socket->SendTo(buf, size, peer, bytesSent, flags, trafficClass);
                     }
                     else
                     {
@@ -156,18 +271,75 @@ namespace ssdk::transport_amd
             AMFTraceWarning(AMF_FACILITY, L"Invalid message received");
             result = net::Session::Result::RECEIVE_FAILED;
         }
+        ProcessPathMtuDiscovery();
 
         return result;
     }
 
+    bool UDPServerSessionImpl::ValidatePeerAddress(const void* datagram, size_t datagramSize, const net::Socket::Address& receivedFrom)
+    {
+        {
+            amf::AMFLock lock(&m_PeerGuard);
+            if (m_Peer == receivedFrom)
+            {
+                return true;
+            }
+
+            //  A datagram carrying our connection ID is not enough to move the session - it could be spoofed or replayed.
+            //  The new address has to echo a random token sent to it first.
+            FlowCtrlProtocol::Fragment fragment;
+            FlowCtrlProtocol::PathValidationType type = FlowCtrlProtocol::PathValidationType::CHALLENGE;
+            uint64_t token = 0;
+            if (m_PathChallengeToken != 0 && m_PathChallengeAddress == receivedFrom &&
+                fragment.ParseFromBuffer(datagram, datagramSize) == FlowCtrlProtocol::Result::OK &&
+                FlowCtrlProtocol::ParsePathValidation(fragment, type, token) == true &&
+                type == FlowCtrlProtocol::PathValidationType::RESPONSE && token == m_PathChallengeToken)
+            {
+                AMFTraceInfo(AMF_FACILITY, L"Session migrated from %S to %S", m_Peer.GetParsedAddressAsString().c_str(), receivedFrom.GetParsedAddressAsString().c_str());
+                m_Peer = receivedFrom;
+                m_PathChallengeToken = 0;
+            }
+            else
+            {
+                amf_pts now = amf_high_precision_clock();
+                if (m_PathChallengeAddress != receivedFrom || now - m_PathChallengeSentTime >= PATH_CHALLENGE_RESEND_INTERVAL)
+                {
+                    static thread_local std::mt19937_64 tokenGenerator{ std::random_device()() };
+                    do
+                    {
+                        m_PathChallengeToken = tokenGenerator();
+                    } while (m_PathChallengeToken == 0);
+                    m_PathChallengeAddress = receivedFrom;
+                    m_PathChallengeSentTime = now;
+
+                    FlowCtrlProtocol::Fragment challenge = FlowCtrlProtocol::CreatePathValidation(FlowCtrlProtocol::PathValidationType::CHALLENGE, m_PathChallengeToken);
+                    size_t bytesSent = 0;
+                    m_Socket->SendTo(challenge.GetDataToSend(), challenge.GetSizeToSend(), receivedFrom, &bytesSent, 0);
+                    AMFTraceDebug(AMF_FACILITY, L"Path validation challenge sent to %S", receivedFrom.GetParsedAddressAsString().c_str());
+                }
+                return false;
+            }
+        }
+        StartPathMtuDiscovery();    //  The new path may have a different MTU
+        return true;
+    }
+
     net::Session::Result UDPServerSessionImpl::OnSessionTimeout()
     {
+        if (GetConnectionID() != INVALID_CONNECTION_ID)
+        {
+            m_Server->UnregisterConnection(GetConnectionID());
+        }
         TimeoutNotify();
         return net::Session::Result::OK;
     }
 
     net::Session::Result UDPServerSessionImpl::OnSessionClose()
     {
+        if (GetConnectionID() != INVALID_CONNECTION_ID)
+        {
+            m_Server->UnregisterConnection(GetConnectionID());
+        }
         //	TerminateNotify();
         return net::Session::Result::OK;
     }
@@ -226,9 +398,16 @@ namespace ssdk::transport_amd
                                 HelloResponse resp(m_Server->GetName().c_str(), (unsigned char)supportedVersion, FlowCtrlProtocol::PROTOCOL_VERSION_MIN,
                                                    m_Server->GetPort(), static_cast<uint32_t>(m_RxMaxFragmentSize));
                                 m_Server->FillOptions(false, this, &resp.GetOptions());
+                                bool connectionMigration = false;
+                                if (GetConnectionID() != INVALID_CONNECTION_ID && GetProperty(ID_CONNECTION_MIGRATION, &connectionMigration) == AMF_OK && connectionMigration == true)
+                                {
+                                    resp.GetOptions().SetUInt32(OPTION_CONNECTION_ID, GetConnectionID());
+                                }
                                 resp.UpdateData();
                                 Send(Channel::SERVICE, resp.GetSendData(), resp.GetSendSize());
                                 AMFTraceDebug(AMF_FACILITY, L"Send ===>> HelloResponse (max rx datagram size: %d)", m_RxMaxFragmentSize);
+                                m_Server->ConnectionAccepted(this);
+                                StartPathMtuDiscovery();
                             }
                             else
                             {
@@ -271,8 +450,18 @@ namespace ssdk::transport_amd
     net::Socket::Result UDPServerSessionImpl::OnRequestFragment(const FlowCtrlProtocol::Fragment& fragment)
     {
         size_t bytesSent = 0;
+        net::Socket::TrafficClass trafficClass = m_DscpMarking == true ? GetChannelTrafficClass(fragment.GetChannelID()) : net::Socket::TrafficClass::BEST_EFFORT;
+        return Send(fragment.GetDataToSend(), fragment.GetSizeToSend(), &bytesSent, 0, trafficClass);
+    }
 
-        return Send(fragment.GetDataToSend(), fragment.GetSizeToSend(), &bytesSent, 0);
+    void UDPServerSessionImpl::OnPathMtuProbeAck(FlowCtrlProtocol::MessageID probeID, uint32_t probeSize)
+    {
+        amf::AMFLock lock(&m_PathMtuGuard);
+        m_NextPathMtuProbeTime = 0;     //  The next probe is due right away
+        if (m_PathMtuDiscovery.OnProbeAcknowledged(probeID, probeSize, amf_high_precision_clock()) == true)
+        {
+            AMFTraceDebug(AMF_FACILITY, L"Path MTU probe of %d bytes acknowledged", (int)probeSize);
+        }
     }
 
     void AMF_STD_CALL UDPServerSessionImpl::OnPropertyChanged(const wchar_t* name)
@@ -310,6 +499,35 @@ namespace ssdk::transport_amd
                 m_pFlowCtrl->ModifyDecisionThreshold(tpThreshold);
             }
         }
+        else if (std::wcscmp(name, DATAGRAM_PATH_MTU_DISCOVERY) == 0)
+        {
+            bool pathMtuDiscovery = false;
+            GetProperty(DATAGRAM_PATH_MTU_DISCOVERY, &pathMtuDiscovery);
+
+            amf::AMFLock lock(&m_PathMtuGuard);
+            m_PathMtuDiscoveryEnabled = pathMtuDiscovery;
+            if (m_PathMtuDiscoveryEnabled == false)
+            {
+                m_PathMtuDiscovery.Stop();
+                m_TxMaxFragmentSize = m_ConfigMaxFragmentSize;
+            }
+            else if (m_PathMtuDiscovery.IsActive() == false)
+            {   //  DF is set on the socket, stay at the base PLPMTU until the client confirms a larger one
+                m_TxMaxFragmentSize = std::min(m_ConfigMaxFragmentSize, PathMtuDiscovery::BASE_PLPMTU);
+            }
+        }
+        else if (std::wcscmp(name, DATAGRAM_DSCP_MARKING) == 0)
+        {
+            bool dscpMarking = false;
+            GetProperty(DATAGRAM_DSCP_MARKING, &dscpMarking);
+            m_DscpMarking = dscpMarking;
+        }
+        else if (std::wcscmp(name, DATAGRAM_IO_URING) == 0)
+        {
+            bool ioUring = false;
+            GetProperty(DATAGRAM_IO_URING, &ioUring);
+            m_IoUring = ioUring;
+        }
     }
 
 }
\ No newline at end of file
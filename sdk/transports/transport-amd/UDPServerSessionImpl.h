@@ -43,10 +43,14 @@ THE SOFTWARE.
 
 #include "ServerSessionImpl.h"
 #include "TransportSession.h"
+#include "PathMtuDiscovery.h"
+#include "net/DatagramRing.h"
 
 #include "amf/public/common/PropertyStorageImpl.h"
 #include "amf/public/common/InterfaceImpl.h"
 
+#include <atomic>
+
 namespace ssdk::transport_amd
 {
     class UDPServerSessionImpl :
@@ -75,6 +79,8 @@ namespace ssdk::transport_amd
         virtual void                 AMF_STD_CALL Terminate() override;
         virtual void                 AMF_STD_CALL UpgradeProtocol(uint32_t version) override;
         virtual bool                 AMF_STD_CALL IsTerminated() const noexcept override;
+
+        inline uint32_t GetReceiveDrops() const { return m_Socket->GetReceiveDrops(); }    //  Of the socket shared with the other sessions of the receive shard the session was created in
     protected:
         // net::DatagramServerSession interface
         virtual net::Session::Result AMF_STD_CALL OnInit() override;
@@ -82,12 +88,15 @@ namespace ssdk::transport_amd
         virtual net::Session::Result AMF_STD_CALL OnDataReceived(const void* request, size_t requestSize, const net::Socket::Address& receivedFrom) override;
         virtual net::Session::Result AMF_STD_CALL OnSessionTimeout() override;
         virtual net::Session::Result AMF_STD_CALL OnSessionClose() override;
-        virtual net::Socket::Result  AMF_STD_CALL Send(const void* buf, size_t size, size_t* const bytesSent, int flags);
+        virtual bool                 AMF_STD_CALL ValidatePeerAddress(const void* datagram, size_t datagramSize, const net::Socket::Address& receivedFrom) override;
+        virtual net::Socket::Result  AMF_STD_CALL Send(const void* buf, size_t size, size_t* const bytesSent, int flags,
+                                                       net::Socket::TrafficClass trafficClass = net::Socket::TrafficClass::BEST_EFFORT);
 
 
         // FlowCtrlProtocol::ProcessIncomingCallback interface
         virtual void OnCompleteMessage(FlowCtrlProtocol::MessageID msgID, const void* buf, size_t size, const net::Socket::Address& receivedFrom, unsigned char optional) override;
         virtual net::Socket::Result OnRequestFragment(const FlowCtrlProtocol::Fragment& fragment) override;
+        virtual void OnPathMtuProbeAck(FlowCtrlProtocol::MessageID probeID, uint32_t probeSize) override;
 
         // FlowCtrlProtocol::ProcessOutgoingCallback interface
         virtual net::Socket::Result OnFragmentReady(const FlowCtrlProtocol::Fragment& fragment, bool last) override;
@@ -99,6 +108,12 @@ namespace ssdk::transport_amd
         UDPServerSessionImpl(const UDPServerSessionImpl&) = delete;
         UDPServerSessionImpl& operator=(const UDPServerSessionImpl&) = delete;
 
+        void StartPathMtuDiscovery();
+        void ProcessPathMtuDiscovery();
+
+        net::DatagramSendRing* GetSendRing() const;     //  nullptr when datagrams are sent with select() and sendto()
+        net::Socket::Address GetPeer();
+
         uint32_t m_SeqNum = 0;
 
     protected:
@@ -106,6 +121,18 @@ namespace ssdk::transport_amd
         FlowCtrlProtocol::Ptr       m_pFlowCtrl;
         size_t                      m_TxMaxFragmentSize = 0;        // Max payload supported by server (config setting)
         size_t                      m_RxMaxFragmentSize = 0;        // Max payload size received by server (sent by client)
+
+        amf::AMFCriticalSection     m_PathMtuGuard;
+        PathMtuDiscovery            m_PathMtuDiscovery;
+        std::atomic<amf_pts>        m_NextPathMtuProbeTime = 0;         // Checked without m_PathMtuGuard, 0 - state changed, check now
+        bool                        m_PathMtuDiscoveryEnabled = false;  // DF is set on the server socket, fragments must not exceed the PLPMTU
+        size_t                      m_ConfigMaxFragmentSize = 0;        // DatagramSize setting, upper bound for the discovered PLPMTU
+        bool                        m_DscpMarking = false;              // Mark each datagram with the traffic class of its channel
+        bool                        m_IoUring = false;                  // Send through the DatagramSendRing of the sending thread, see DATAGRAM_IO_URING
+
+        net::Socket::Address        m_PathChallengeAddress;             // Candidate peer address being validated
+        uint64_t                    m_PathChallengeToken = 0;
+        amf_pts                     m_PathChallengeSentTime = 0;
     };
 
 }
\ No newline at end of file
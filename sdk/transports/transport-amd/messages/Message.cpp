@@ -35,6 +35,8 @@ THE SOFTWARE.
 
 #include "Message.h"
 
+#include <cstring>
+
 namespace ssdk::transport_amd
 {
     Message::Message()
@@ -52,25 +54,39 @@ namespace ssdk::transport_amd
     bool Message::ParseBuffer(const void* data, size_t size)
     {
         bool result = true;
-        unsigned char* myData = (unsigned char*)data;
-        m_OpCode = *static_cast<const uint8_t*>(myData);
+        m_OpCode = *static_cast<const uint8_t*>(data);
         if (size > 1)
-        {
-            m_Data.assign((char*)data + 1, size - sizeof(m_OpCode));
-
-            amf::JSONParser::Ptr json;
-            if (CreateJSONParser(&json) == AMF_OK)
-            {
-                amf::JSONParser::Node::Ptr root;
-                json->Parse(m_Data, &root);
-                result = (root != nullptr) ? FromJSON(root) : false;
-            }
-            else
-            {
-                result = false;
-            }
+        {   //  Parsed from the thread's text buffer rather than a copy in m_Data, which only holds what is sent
+            amf::JSONParser::Node::Ptr root;
+            result = MessageParser::GetThreadInstance().Parse(static_cast<const uint8_t*>(data) + sizeof(m_OpCode), size - sizeof(m_OpCode), &root) == true ?
+                     FromJSON(root) : false;
         }
         return result;
     }
 
+    MessageParser& MessageParser::GetThreadInstance()
+    {
+        static thread_local MessageParser instance;
+        return instance;
+    }
+
+    MessageParser::MessageParser()
+    {
+        CreateJSONParser(&m_Parser);
+    }
+
+    bool MessageParser::Parse(const void* json, size_t size, amf::JSONParser::Node** root)
+    {
+        if (m_Parser == nullptr || root == nullptr)
+        {
+            return false;
+        }
+        //  Media messages carry their binary payload after the terminating 0 of the JSON, only the text needs to be copied
+        const char* text = static_cast<const char*>(json);
+        const char* end = static_cast<const char*>(memchr(text, 0, size));
+        m_Text.assign(text, end != nullptr ? size_t(end - text) : size);
+        m_Parser->Parse(m_Text, root);
+        return *root != nullptr;
+    }
+
 }
\ No newline at end of file
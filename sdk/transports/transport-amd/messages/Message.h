@@ -41,6 +41,30 @@ THE SOFTWARE.
 
 namespace ssdk::transport_amd
 {
+    //  MessageParser - the JSON parser and text buffer a thread parses and builds messages with. Creating a parser and
+    //  copying the payload into the message for every message received was a good part of the cost of the high-rate ones
+    //  (DeviceEvent, Statistics, QoS), so every thread creates them once and keeps reusing them.
+    //  Outgoing messages are still built as a node tree and serialized with Node::Stringify(), which returns a new string:
+    //  AMF's JSON API has no way to serialize into a caller's buffer, and a writer of our own would have to duplicate the
+    //  layout of every message type next to its FromJSON()
+    class MessageParser
+    {
+    public:
+        static MessageParser& GetThreadInstance();
+
+        inline amf::JSONParser* GetParser() const noexcept { return m_Parser; }
+        bool Parse(const void* json, size_t size, amf::JSONParser::Node** root);   //  The text buffer keeps its capacity between messages
+
+    private:
+        MessageParser();
+        MessageParser(const MessageParser&) = delete;
+        MessageParser& operator=(const MessageParser&) = delete;
+
+    private:
+        amf::JSONParser::Ptr    m_Parser;
+        std::string             m_Text;
+    };
+
     class Message
     {
     public:
@@ -57,6 +81,8 @@ namespace ssdk::transport_amd
 
         virtual bool FromJSON(amf::JSONParser::Node* root) = 0;
 
+        static inline amf::JSONParser* GetParser() { return MessageParser::GetThreadInstance().GetParser(); }
+
     protected:
         uint8_t m_OpCode = 0;  // SERVICE_OP_CODE or private operation
         std::string m_Data;
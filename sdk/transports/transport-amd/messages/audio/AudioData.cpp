@@ -44,13 +44,16 @@ namespace ssdk::transport_amd
     static constexpr const char* TAG_AUDIO_SEQUENCE_NUM = "idx";
     static constexpr const char* TAG_DISCONTINUITY = "discontinuity";
     static constexpr const char* TAG_STREAM_ID = "StreamID";
+    static constexpr const char* TAG_REDUNDANCY = "red";
+    static constexpr const char* TAG_INIT_ID = "InitID";
 
     AudioData::AudioData() :
         Message(uint8_t(AUDIO_OP_CODE::DATA))
     {
     }
 
-    AudioData::AudioData(amf_pts pts, amf_pts duration, uint32_t size, int64_t sequenceNumber, bool discontinuity, transport_common::StreamID streamID) :
+    AudioData::AudioData(amf_pts pts, amf_pts duration, uint32_t size, int64_t sequenceNumber, bool discontinuity, transport_common::StreamID streamID,
+                         const RedundantBlocks& redundantBlocks, transport_common::InitID initID) :
         Message(uint8_t(AUDIO_OP_CODE::DATA)),
         m_Pts(pts),
         m_Duration(duration),
@@ -58,10 +61,11 @@ namespace ssdk::transport_amd
         m_SizePresent(true),
         m_bDiscontinuity(discontinuity),
         m_SequenceNumber(sequenceNumber),
-        m_streamID(streamID)
+        m_streamID(streamID),
+        m_RedundantBlocks(redundantBlocks),
+        m_InitID(initID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -81,6 +85,26 @@ namespace ssdk::transport_amd
         {
             SetInt64Value(parser, root, TAG_STREAM_ID, m_streamID);
         }
+        if (m_RedundantBlocks.empty() == false)
+        {   //  Clients unaware of redundancy ignore the tag and the payloads following the primary one, which is bounded by TAG_AUDIO_PACKET_SIZE
+            amf::JSONParser::Array::Ptr blocks;
+            parser->CreateArray(&blocks);
+            for (const RedundantBlock& block : m_RedundantBlocks)
+            {
+                amf::JSONParser::Node::Ptr blockNode;
+                parser->CreateNode(&blockNode);
+                SetInt64Value(parser, blockNode, TAG_AUDIO_SEQUENCE_NUM, block.sequenceNumber);
+                SetInt64Value(parser, blockNode, TAG_AUDIO_TIMESTAMP, block.pts);
+                SetInt64Value(parser, blockNode, TAG_AUDIO_DURATION, block.duration);
+                SetUInt32Value(parser, blockNode, TAG_AUDIO_PACKET_SIZE, block.size);
+                blocks->AddElement(blockNode);
+            }
+            root->AddElement(TAG_REDUNDANCY, blocks);
+        }
+        if (m_InitID != transport_common::INVALID_INIT_ID)
+        {
+            SetInt64Value(parser, root, TAG_INIT_ID, m_InitID);
+        }
 
         m_Data += root->Stringify();
     }
@@ -96,6 +120,30 @@ namespace ssdk::transport_amd
         {
             m_streamID = transport_common::DEFAULT_STREAM;
         }
+        if (GetInt64Value(root, TAG_INIT_ID, m_InitID) == false)
+        {
+            m_InitID = transport_common::INVALID_INIT_ID;
+        }
+        m_RedundantBlocks.clear();
+        amf::JSONParser::Array::Ptr blocks(root->GetElementByName(TAG_REDUNDANCY));
+        if (blocks != nullptr)
+        {
+            size_t count = blocks->GetElementCount();
+            for (size_t i = 0; i < count; ++i)
+            {
+                amf::JSONParser::Node::Ptr blockNode(blocks->GetElementAt(i));
+                RedundantBlock block;
+                if (blockNode == nullptr ||
+                    GetInt64Value(blockNode, TAG_AUDIO_SEQUENCE_NUM, block.sequenceNumber) == false ||
+                    GetUInt32Value(blockNode, TAG_AUDIO_PACKET_SIZE, block.size) == false)
+                {
+                    return false;
+                }
+                GetInt64Value(blockNode, TAG_AUDIO_TIMESTAMP, block.pts);
+                GetInt64Value(blockNode, TAG_AUDIO_DURATION, block.duration);
+                m_RedundantBlocks.push_back(block);
+            }
+        }
         return true;
     }
 }
@@ -44,14 +44,29 @@ THE SOFTWARE.
 #include "transports/transport-amd/messages/Message.h"
 #include "transports/transport-common/Transport.h"
 #include <string>
+#include <vector>
 
 namespace ssdk::transport_amd
 {
     class AudioData : public Message
     {
+    public:
+        //  Copy of a previous frame's payload carried for loss recovery, see AudioRedundancy.h.
+        //  Redundant payloads follow the primary payload in the order they are listed.
+        class RedundantBlock
+        {
+        public:
+            int64_t     sequenceNumber = 0;
+            amf_pts     pts = 0;
+            amf_pts     duration = 0;
+            uint32_t    size = 0;
+        };
+        typedef std::vector<RedundantBlock> RedundantBlocks;
+
     public:
         AudioData();
-        AudioData(amf_pts pts, amf_pts duration, uint32_t size, int64_t sequenceNumber, bool discontinuity, transport_common::StreamID streamID);
+        AudioData(amf_pts pts, amf_pts duration, uint32_t size, int64_t sequenceNumber, bool discontinuity, transport_common::StreamID streamID,
+                  const RedundantBlocks& redundantBlocks = {}, transport_common::InitID initID = transport_common::INVALID_INIT_ID);
 
         virtual bool FromJSON(amf::JSONParser::Node* root) override;
 
@@ -62,6 +77,10 @@ namespace ssdk::transport_amd
         inline bool GetDiscontinuity() const noexcept { return m_bDiscontinuity; }
         inline int64_t GetSequenceNumber() const noexcept { return m_SequenceNumber; }
         inline transport_common::StreamID GetStreamID() const noexcept { return m_streamID; }
+        inline const RedundantBlocks& GetRedundantBlocks() const noexcept { return m_RedundantBlocks; }
+        //  The init the frame was encoded for, INVALID_INIT_ID when the server does not say. Set when audio messages
+        //  can be delivered ahead of a lost AudioInit, see FlowCtrlProtocol::SetReorderableOpCode()
+        inline transport_common::InitID GetInitID() const noexcept { return m_InitID; }
 
     private:
         amf_pts     m_Pts = 0;
@@ -71,6 +90,8 @@ namespace ssdk::transport_amd
         bool        m_bDiscontinuity = false;
         int64_t     m_SequenceNumber = 0;
         transport_common::StreamID m_streamID = transport_common::DEFAULT_STREAM;
+        RedundantBlocks m_RedundantBlocks;
+        transport_common::InitID m_InitID = transport_common::INVALID_INIT_ID;
     };
 
 }
@@ -63,8 +63,7 @@ namespace ssdk::transport_amd
         m_ID(id),
         m_StreamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -116,8 +115,7 @@ namespace ssdk::transport_amd
         m_Ack(ack),
         m_StreamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -146,8 +144,7 @@ namespace ssdk::transport_amd
     AudioInitRequest::AudioInitRequest() :
         Message(uint8_t(AUDIO_OP_CODE::INIT_REQUEST))
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -159,8 +156,7 @@ namespace ssdk::transport_amd
         Message(uint8_t(AUDIO_OP_CODE::INIT_REQUEST)),
         m_StreamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -254,14 +254,14 @@ namespace ssdk::transport_amd
     DeviceEvent::DeviceEvent() :
         Message(uint8_t(SENSOR_OP_CODE::DEVICE_EVENT))
     {
-        CreateJSONParser(&m_Parser);
+        m_Parser = GetParser();
     }
 
     DeviceEvent::DeviceEvent(transport_common::StreamID streamID) :
         Message(uint8_t(SENSOR_OP_CODE::DEVICE_EVENT)),
         m_StreamID(streamID)
     {
-        CreateJSONParser(&m_Parser);
+        m_Parser = GetParser();
     }
 
     std::string DeviceEvent::ToJSON() const
@@ -403,8 +403,7 @@ namespace ssdk::transport_amd
 
     std::string TrackableDeviceDisconnected::ToJSON() const
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
         SetStringValue(parser, root, TAG_ID, m_ID);
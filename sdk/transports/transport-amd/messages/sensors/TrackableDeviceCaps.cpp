@@ -141,8 +141,7 @@ namespace ssdk::transport_amd
 
     std::string TrackableDeviceCaps::ToJSON() const
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -125,8 +125,7 @@ namespace ssdk::transport_amd
         m_MaxDatagramSize(maxDatagramSize),
         m_PlatformInfo(PLATFORM)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -315,8 +314,7 @@ namespace ssdk::transport_amd
 
     void HelloResponse::ToJSON()
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
         m_Root = root;
@@ -412,8 +410,7 @@ namespace ssdk::transport_amd
     HelloRefused::HelloRefused() :
         Message(uint8_t(SERVICE_OP_CODE::CONNECTION_REFUSED))
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
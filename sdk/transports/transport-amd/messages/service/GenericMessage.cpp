@@ -49,8 +49,7 @@ namespace ssdk::transport_amd
         Message(uint8_t(SERVICE_OP_CODE::TRACKABLE_DEVICE_CAPS)),//MESSAGE in old)),
         m_Message(message)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -0,0 +1,92 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "Resume.h"
+#include "transports/transport-amd/Channels.h"
+
+
+namespace ssdk::transport_amd
+{
+    static constexpr const char* TAG_RESUME_TICKET = "Tkt";
+    static constexpr const char* TAG_RESUME_PROOF = "Prf";
+    static constexpr const char* TAG_RESUME_SECRET = "Sec";
+    static constexpr const char* TAG_RESUME_RESUMED = "Res";
+
+    ResumeMessage::ResumeMessage() :
+        Message(uint8_t(SERVICE_OP_CODE::RESUME))
+    {
+    }
+
+    ResumeMessage::ResumeMessage(const std::string& ticket, const std::string& proof) :
+        Message(uint8_t(SERVICE_OP_CODE::RESUME)),
+        m_Ticket(ticket),
+        m_Proof(proof)
+    {
+        amf::JSONParser::Ptr parser(GetParser());
+        amf::JSONParser::Node::Ptr root;
+        parser->CreateNode(&root);
+
+        SetStringValue(parser, root, TAG_RESUME_TICKET, m_Ticket.c_str());
+        SetStringValue(parser, root, TAG_RESUME_PROOF, m_Proof.c_str());
+
+        m_Data += root->Stringify();
+    }
+
+    ResumeMessage::ResumeMessage(const std::string& ticket, const std::string& secret, bool resumed) :
+        Message(uint8_t(SERVICE_OP_CODE::RESUME)),
+        m_Ticket(ticket),
+        m_Secret(secret),
+        m_Resumed(resumed)
+    {
+        amf::JSONParser::Ptr parser(GetParser());
+        amf::JSONParser::Node::Ptr root;
+        parser->CreateNode(&root);
+
+        SetStringValue(parser, root, TAG_RESUME_TICKET, m_Ticket.c_str());
+        SetStringValue(parser, root, TAG_RESUME_SECRET, m_Secret.c_str());
+        SetBoolValue(parser, root, TAG_RESUME_RESUMED, m_Resumed);
+
+        m_Data += root->Stringify();
+    }
+
+    bool ResumeMessage::FromJSON(amf::JSONParser::Node* root)
+    {
+        bool result = GetStringValue(root, TAG_RESUME_TICKET, m_Ticket);
+        GetStringValue(root, TAG_RESUME_PROOF, m_Proof);
+        GetStringValue(root, TAG_RESUME_SECRET, m_Secret);
+        GetBoolValue(root, TAG_RESUME_RESUMED, m_Resumed);
+        return result;
+    }
+}
@@ -96,8 +96,7 @@ namespace ssdk::transport_amd
             m_AudioCodec = audioCodec;
         }
 
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -207,8 +206,7 @@ namespace ssdk::transport_amd
         m_VideoStreamID(videoStreamID),
         m_AudioStreamID(audioStreamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -79,8 +79,7 @@ namespace ssdk::transport_amd
         m_FpsRx(fpsRx),
         m_StreamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -172,8 +171,7 @@ namespace ssdk::transport_amd
         m_cpuTemp(cpuTemp),
         m_StreamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
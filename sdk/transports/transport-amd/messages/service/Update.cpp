@@ -55,8 +55,7 @@ namespace ssdk::transport_amd
         m_FrameRate(framerate),
         m_StreamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -75,8 +74,7 @@ namespace ssdk::transport_amd
         m_Bitrate(bitrate),
         m_StreamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -97,8 +95,7 @@ namespace ssdk::transport_amd
         m_Bitrate(bitrate),
         m_StreamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -47,6 +47,8 @@ namespace ssdk::transport_amd
     static constexpr const char* TAG_CAPTURE_RESOLUTION_Y = "CaptureResolutionY";
     static constexpr const char* TAG_VISIBLE = "Visible";
     static constexpr const char* TAG_MONOCHROME = "Monochrome";
+    static constexpr const char* TAG_HASH = "Hash";
+    static constexpr const char* TAG_CACHED = "Cached";
 
     CursorData::CursorData() :
         Message(uint8_t(VIDEO_OP_CODE::CURSOR))
@@ -54,7 +56,8 @@ namespace ssdk::transport_amd
     }
 
     CursorData::CursorData(int32_t width, int32_t height, int32_t pitch, int32_t hotspotX, int32_t hotspotY,
-                           int32_t captureResolutionX, int32_t captureResolutionY, bool visible, bool monochrome) :
+                           int32_t captureResolutionX, int32_t captureResolutionY, bool visible, bool monochrome,
+                           uint64_t hash, bool cached) :
         Message(uint8_t(VIDEO_OP_CODE::CURSOR)),
         m_Width(width),
         m_Height(height),
@@ -64,10 +67,11 @@ namespace ssdk::transport_amd
         m_CaptureResolutionX(captureResolutionX),
         m_CaptureResolutionY(captureResolutionY),
         m_Visible(visible),
-        m_Monochrome(monochrome)
+        m_Monochrome(monochrome),
+        m_Hash(hash),
+        m_Cached(cached)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -80,6 +84,12 @@ namespace ssdk::transport_amd
         SetInt32Value(parser, root, TAG_CAPTURE_RESOLUTION_Y, m_CaptureResolutionY);
         SetBoolValue(parser, root, TAG_VISIBLE, m_Visible);
         SetBoolValue(parser, root, TAG_MONOCHROME, m_Monochrome);
+        // Older clients ignore these and expect the bitmap to always follow the JSON, which is the case unless they advertised a cursor cache
+        if (m_Hash != 0)
+        {
+            SetInt64Value(parser, root, TAG_HASH, static_cast<int64_t>(m_Hash));
+            SetBoolValue(parser, root, TAG_CACHED, m_Cached);
+        }
 
         m_Data += root->Stringify();
     }
@@ -102,7 +112,40 @@ namespace ssdk::transport_amd
 
         m_Visible = ((amf::JSONParser::Value*)root->GetElementByName(TAG_VISIBLE))->GetValueAsBool();
         m_Monochrome = ((amf::JSONParser::Value*)root->GetElementByName(TAG_MONOCHROME))->GetValueAsBool();
+
+        int64_t hash = 0;
+        m_Hash = GetInt64Value(root, TAG_HASH, hash) == true ? static_cast<uint64_t>(hash) : 0;
+        if (GetBoolValue(root, TAG_CACHED, m_Cached) == false)
+        {
+            m_Cached = false;
+        }
         return true;
     }
 
+    CursorCacheMiss::CursorCacheMiss() :
+        Message(uint8_t(VIDEO_OP_CODE::CURSOR_CACHE_MISS))
+    {
+    }
+
+    CursorCacheMiss::CursorCacheMiss(uint64_t hash) :
+        Message(uint8_t(VIDEO_OP_CODE::CURSOR_CACHE_MISS)),
+        m_Hash(hash)
+    {
+        amf::JSONParser::Ptr parser(GetParser());
+        amf::JSONParser::Node::Ptr root;
+        parser->CreateNode(&root);
+
+        SetInt64Value(parser, root, TAG_HASH, static_cast<int64_t>(m_Hash));
+
+        m_Data += root->Stringify();
+    }
+
+    bool CursorCacheMiss::FromJSON(amf::JSONParser::Node* root)
+    {
+        int64_t hash = 0;
+        bool result = GetInt64Value(root, TAG_HASH, hash);
+        m_Hash = static_cast<uint64_t>(hash);
+        return result;
+    }
+
 }
\ No newline at end of file
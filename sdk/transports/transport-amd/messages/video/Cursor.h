@@ -51,7 +51,8 @@ namespace ssdk::transport_amd
     public:
         CursorData();
         CursorData(int32_t width, int32_t height, int32_t pitch, int32_t hotspotX, int32_t hotspotY,
-            int32_t captureResolutionX, int32_t captureResolutionY, bool visible, bool monochrome);
+            int32_t captureResolutionX, int32_t captureResolutionY, bool visible, bool monochrome,
+            uint64_t hash = 0, bool cached = false);
 
         virtual bool FromJSON(amf::JSONParser::Node* root) override;
 
@@ -64,6 +65,8 @@ namespace ssdk::transport_amd
         inline int32_t GetCaptureResolutionY() const noexcept { return m_CaptureResolutionY; }
         inline bool GetVisible() const noexcept { return m_Visible; }
         inline bool GetMonochrome() const noexcept { return m_Monochrome; }
+        inline uint64_t GetHash() const noexcept { return m_Hash; }     // 0 when the server does not support cursor caching
+        inline bool IsCached() const noexcept { return m_Cached; }      // true when the bitmap is omitted and must be taken from the client's cache
 
     private:
         int32_t m_Width = 0;
@@ -75,5 +78,22 @@ namespace ssdk::transport_amd
         int32_t m_CaptureResolutionY = 0;
         bool m_Visible = true;
         bool m_Monochrome = false;
+        uint64_t m_Hash = 0;
+        bool m_Cached = false;
+    };
+
+    // Sent by the client when it receives a cached cursor which is no longer in its cache, the server responds with the complete bitmap
+    class CursorCacheMiss : public Message
+    {
+    public:
+        CursorCacheMiss();
+        CursorCacheMiss(uint64_t hash);
+
+        virtual bool FromJSON(amf::JSONParser::Node* root) override;
+
+        inline uint64_t GetHash() const noexcept { return m_Hash; }
+
+    private:
+        uint64_t m_Hash = 0;
     };
 }
\ No newline at end of file
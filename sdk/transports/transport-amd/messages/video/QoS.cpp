@@ -69,8 +69,7 @@ namespace ssdk::transport_amd
         m_AvgGlitch(avgGlitch),
         m_streamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
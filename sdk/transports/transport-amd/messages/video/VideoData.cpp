@@ -36,6 +36,11 @@ THE SOFTWARE.
 #include "VideoData.h"
 #include "transports/transport-amd/Channels.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
 namespace ssdk::transport_amd
 {
     static constexpr const char* TAG_PTS = "pts";
@@ -49,6 +54,15 @@ namespace ssdk::transport_amd
     static constexpr const char* TAG_PTS_FRAME_NUM = "frameNum";
     static constexpr const char* TAG_DISCONTINUITY = "discontinuity";
     static constexpr const char* TAG_STREAM_ID = "StreamID";
+    static constexpr const char* TAG_SEND_TIME = "sendTime";
+    static constexpr const size_t SEND_TIME_DIGITS = 16;        //  Hexadecimal, a JSON number could change its width
+
+    static std::string FormatSendTime(amf_pts sendTime)
+    {
+        char digits[SEND_TIME_DIGITS + 1] = {};
+        snprintf(digits, sizeof(digits), "%016llx", static_cast<unsigned long long>(sendTime));
+        return std::string(digits, SEND_TIME_DIGITS);
+    }
 
     VideoData::VideoData() :
         Message(uint8_t(VIDEO_OP_CODE::DATA))
@@ -69,10 +83,10 @@ namespace ssdk::transport_amd
         m_ptsLastSendDuration(ptsLastSendDuration),
         m_uiFrameNum(uiFrameNum),
         m_bDiscontinuity(discontinuity),
-        m_streamID(streamID)
+        m_streamID(streamID),
+        m_SendTime(amf_high_precision_clock())
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -85,6 +99,7 @@ namespace ssdk::transport_amd
         SetUInt32Value(parser, root, TAG_COMP_ENCODED_FRAME_TYPE, static_cast<uint32_t>(m_eSubframeType));
         SetInt64Value(parser, root, TAG_PTS_SEND_DURATION, m_ptsLastSendDuration);
         SetInt64Value(parser, root, TAG_PTS_FRAME_NUM, m_uiFrameNum);
+        SetStringValue(parser, root, TAG_SEND_TIME, FormatSendTime(m_SendTime));
         if (m_bDiscontinuity == true)
         {
             SetBoolValue(parser, root, TAG_DISCONTINUITY, m_bDiscontinuity);
@@ -106,6 +121,11 @@ namespace ssdk::transport_amd
         GetInt64Value(root, TAG_PTS_ENCODER_LAT, m_ptsEncoderLatency);
         GetInt64Value(root, TAG_PTS, m_pts);
         GetUInt32Value(root, TAG_COMP_FRAME_SIZE, m_CompressedFrameSize);
+        std::string sendTime;
+        if (GetStringValue(root, TAG_SEND_TIME, sendTime) == true && sendTime.length() == SEND_TIME_DIGITS)
+        {
+            m_SendTime = amf_pts(strtoull(sendTime.c_str(), nullptr, 16));
+        }
 
         uint32_t viewType = 0;
         if (GetUInt32Value(root, TAG_COMP_FRAME_TYPE, viewType) == true)
@@ -143,6 +163,31 @@ namespace ssdk::transport_amd
         return result;
     }
 
+    bool VideoData::StampSendTime(void* msg, size_t msgLen, amf_pts sendTime)
+    {
+        char* text = static_cast<char*>(msg);
+        if (msgLen < 2 || VIDEO_OP_CODE(uint8_t(text[0])) != VIDEO_OP_CODE::DATA)
+        {
+            return false;
+        }
+        //  Only the JSON header is searched, the frame follows its terminating 0
+        const char* end = static_cast<const char*>(memchr(text + 1, 0, msgLen - 1));
+        size_t headerLen = end != nullptr ? size_t(end - text) : msgLen;
+        const std::string tag = std::string("\"") + TAG_SEND_TIME + "\"";
+        char* found = std::search(text + 1, text + headerLen, tag.begin(), tag.end());
+        if (found == text + headerLen)
+        {
+            return false;
+        }
+        char* value = static_cast<char*>(memchr(found + tag.length(), '"', headerLen - size_t(found + tag.length() - text)));
+        if (value == nullptr || size_t(value - text) + SEND_TIME_DIGITS + 2 > headerLen || value[SEND_TIME_DIGITS + 1] != '"')
+        {
+            return false;
+        }
+        memcpy(value + 1, FormatSendTime(sendTime).c_str(), SEND_TIME_DIGITS);
+        return true;
+    }
+
 
     VideoForceUpdate::VideoForceUpdate() :
         Message(uint8_t(VIDEO_OP_CODE::FORCE_UPDATE)),
@@ -157,8 +202,7 @@ namespace ssdk::transport_amd
     {
         if (videoStreamID != transport_common::DEFAULT_STREAM)
         {
-            amf::JSONParser::Ptr parser;
-            CreateJSONParser(&parser);
+            amf::JSONParser::Ptr parser(GetParser());
             amf::JSONParser::Node::Ptr root;
             parser->CreateNode(&root);
 
@@ -56,6 +56,10 @@ namespace ssdk::transport_amd
 
         virtual bool FromJSON(amf::JSONParser::Node* root) override;
 
+        //  The send time is stored as a fixed width field so that it can be stamped in place when the message
+        //  leaves the send queue, right before it is encrypted. Returns false when msg is not a VideoData message
+        static bool StampSendTime(void* msg, size_t msgLen, amf_pts sendTime);
+
         inline amf_pts GetOriginPts() const noexcept { return m_originPts; }
         inline amf_pts GetServerLatency() const noexcept { return m_ptsServerLatency; }
         inline amf_pts GetEncoderLatency() const noexcept { return m_ptsEncoderLatency; }
@@ -67,6 +71,7 @@ namespace ssdk::transport_amd
         inline uint64_t GetFrameNum() const noexcept { return m_uiFrameNum; }
         inline bool GetDiscontinuity() const noexcept { return m_bDiscontinuity; }
         inline transport_common::StreamID GetStreamID() const noexcept { return m_streamID; }
+        inline amf_pts GetSendTime() const noexcept { return m_SendTime; }      //  Sender's clock when the message left its send queue, 0 when not sent by the peer
 
     private:
         amf_pts                                             m_originPts = 0;
@@ -80,6 +85,7 @@ namespace ssdk::transport_amd
         uint64_t                                            m_uiFrameNum = 0;
         bool                                                m_bDiscontinuity = true;
         transport_common::StreamID                          m_streamID = transport_common::DEFAULT_STREAM;
+        amf_pts                                             m_SendTime = 0;
     };
 
     class VideoForceUpdate : public Message
@@ -64,8 +64,7 @@ namespace ssdk::transport_amd
         m_iBitDepth(bitDepth),
         m_streamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -118,8 +117,7 @@ namespace ssdk::transport_amd
         m_Ack(ack),
         m_streamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -149,8 +147,7 @@ namespace ssdk::transport_amd
     VideoInitRequest::VideoInitRequest() :
         Message(uint8_t(VIDEO_OP_CODE::INIT_REQUEST))
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -162,8 +159,7 @@ namespace ssdk::transport_amd
         Message(uint8_t(VIDEO_OP_CODE::INIT_REQUEST)),
         m_streamID(streamID)
     {
-        amf::JSONParser::Ptr parser;
-        CreateJSONParser(&parser);
+        amf::JSONParser::Ptr parser(GetParser());
         amf::JSONParser::Node::Ptr root;
         parser->CreateNode(&root);
 
@@ -269,6 +269,11 @@ namespace ssdk::transport_common
         virtual Result SendApplicationMessage(SessionHandle session, const void* msg, size_t size) = 0;
 
         virtual Result SetSessionSecurity(SessionHandle session, const char* cipherPassphrase) = 0;   // When cipher is not set or set to nullptr, no encryption is used
+
+        //  Rate control:
+        //  Video to the session goes out no faster than the bitrate in bps, frames wait in the transport rather than being dropped
+        //  until they get stale. 0 removes the limit. Fails when the transport cannot hold frames back for a single session
+        virtual Result SetSessionPacing(SessionHandle session, int64_t bitrate) = 0;
     };
 
 }
\ No newline at end of file
@@ -116,6 +116,10 @@ namespace ssdk::transport_common
             else
             {
                 m_Subframes.push_back({ subframe, type });
+                if (type == SubframeType::IDR || type == SubframeType::I)
+                {
+                    m_KeyFrame = true;
+                }
             }
         }
         return result;
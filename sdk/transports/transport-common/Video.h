@@ -131,6 +131,11 @@ namespace ssdk::transport_common
 
         inline bool IsDiscontinuity() const noexcept { return m_Discontinuity; }
 
+        //  Slices of one frame are sent as separate frames sharing the PTS, all but the last one are of the SLICE type.
+        //  The key frame flag is valid on every slice, it is not transmitted.
+        inline bool IsKeyFrame() const noexcept { return m_KeyFrame; }
+        inline bool IsLeadingSlice() const noexcept { return m_Subframes.empty() == false && m_Subframes.back().m_Type == SubframeType::SLICE; }
+
     protected:
         amf_pts                 m_OriginPts = 0;
         Subframe::Collection    m_Subframes;
@@ -140,6 +145,7 @@ namespace ssdk::transport_common
         amf_pts                 m_Pts = -1;
         amf_pts                 m_Duration = -1;
         bool                    m_Discontinuity = false;
+        bool                    m_KeyFrame = false;
     };
 
     class TransmittableVideoFrame : public VideoFrame
@@ -149,6 +155,7 @@ namespace ssdk::transport_common
         explicit TransmittableVideoFrame(uint32_t viewIdx, amf_pts originPts, int64_t sequenceNumber, bool discontinuity);
 
         AMF_RESULT AddSubframe(SubframeType type, amf::AMFBuffer* subframe);
+        inline void SetKeyFrame(bool keyFrame) noexcept { m_KeyFrame = keyFrame; }     //  IDR and I subframes mark the frame as a key frame on their own
 
         size_t CalculateRequiredBufferSize() const noexcept;
         AMF_RESULT ConstructFrame(void* buf) const;
@@ -36,16 +36,33 @@ THE SOFTWARE.
 #include "QoS.h"
 #include "amf/public/common/TraceAdapter.h"
 
+#include <algorithm>
+
 static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::util::QoS";
 
 namespace ssdk::util
 {
+    QoS::QoS(QoSCallback* pQoSCB, ssdk::transport_common::StreamID streamID) :
+        m_pQoSCB(pQoSCB),
+        m_StreamID(streamID)
+    {
+        MetricsRegistry& registry = MetricsRegistry::GetInstance();
+        MetricsRegistry::Labels labels = { { "stream", std::to_string(streamID) } };
+        m_FramerateGauge = registry.GetGauge("ssdk_server_qos_framerate", "Frame rate measured by QoS at the encoder output", labels);
+        m_TargetFramerateGauge = registry.GetGauge("ssdk_server_qos_target_framerate", "Frame rate last requested by QoS", labels);
+        m_BitrateGauge = registry.GetGauge("ssdk_server_qos_bitrate_bps", "Bitrate measured by QoS at the encoder output", labels);
+        m_TargetBitrateGauge = registry.GetGauge("ssdk_server_qos_target_bitrate_bps", "Bitrate last requested by QoS", labels);
+        m_EncoderQueueDepthGauge = registry.GetGauge("ssdk_server_encoder_queue_depth", "Frames submitted to the encoder and not output yet", labels);
+        m_PanicGauge = registry.GetGauge("ssdk_server_qos_panic", "1 while QoS has dropped the stream to its minimum quality", labels);
+    }
+
     AMF_RESULT QoS::Init(InitParams initParams)
     {
         amf::AMFLock    lock(&m_Guard);
         if (m_Initialized == false)
         {
             m_InitParams = initParams;
+            m_RatePolicy.SetParams(initParams.ratePolicy);
             m_Initialized = true;
         }
         return AMF_OK;
@@ -136,11 +153,19 @@ namespace ssdk::util
                     {
                         static constexpr const int MAX_DECODER_OVERFLOW_EVENTS = 5;
                         static constexpr const int MAX_CONGESTION_EVENTS = 5;
+                        //  Unless the worst session drives the encoder, network problems of a session only lower that session's bitrate
+                        const bool perSession = m_InitParams.ratePolicy.mode != SessionRatePolicy::Mode::WORST_SESSION;
                         for (SessionInfoMap::iterator it = m_SessionInfoMap.begin(); it != m_SessionInfoMap.end(); ++it)
                         {
+                            bool sessionCongested = false;
                             // if any client's force IDR request count exceeds panicThresholdIDR, lower bitrate and panic
                             // if any client's force IDR request count exceeds thresholdIDR, lower bitrate
-                            if (it->second.m_ForceIDRReqCount > m_InitParams.panicThresholdIDR)
+                            if (perSession == true && it->second.m_ForceIDRReqCount > m_InitParams.thresholdIDR)
+                            {
+                                sessionCongested = true;
+                                AMFTraceInfo(AMF_FACILITY, L"Client of session %lld is requesting key frames, QoS is lowering its bitrate", it->first);
+                            }
+                            else if (it->second.m_ForceIDRReqCount > m_InitParams.panicThresholdIDR)
                             {   //  The number of Force IDR requests exceeded panic threshold
                                 panic = true;
                                 lowerVideoBitrate = true;
@@ -188,26 +213,39 @@ namespace ssdk::util
                             auto& sessionFramerateHistory = it->second.m_FramerateHistory;
                             if (sessionFramerateHistory.IsHistoryFull() == true)
                             {
-                                if (now - sessionFramerateHistory.GetLastUpdateTime() > m_InitParams.timeBeforePanic)
+                                if (perSession == true)
                                 {
-                                    panic = true;
-                                    reasonForPanic = QoSPanic::NO_CLIENT_DATA;
-                                    lowerVideoBitrate = true;
-                                    lowerFrameRate = true;
-                                    AMFTraceWarning(AMF_FACILITY, L"Have not received statistics from the client, QoS is panicing");
-                                    break;
+                                    float sessionFramerate = sessionFramerateHistory.GetAverage();
+                                    if (now - sessionFramerateHistory.GetLastUpdateTime() > m_InitParams.timeBeforePanic ||
+                                        (sessionFramerate != 0 && m_Framerate != 0 && m_Framerate > sessionFramerate * 1.15) ||
+                                        (m_Framerate != 0 && it->second.m_SendTime > (1000 / m_Framerate) * 2.0f))
+                                    {   //  No statistics, frames not arriving in time or send() stalling for this session
+                                        sessionCongested = true;
+                                    }
                                 }
-
-                                float sessionFramerate = sessionFramerateHistory.GetAverage();
-                                if (sessionFramerate != 0 && m_Framerate != 0 && m_Framerate > sessionFramerate * 1.15 && (now - m_LastFpsAdjustmentTime) > m_InitParams.framerateAdjustmentPeriod)
+                                else
                                 {
-                                    lowerVideoBitrate = true;
-                                    sessionFramerateHistory.Clear();
-                                    AMFTraceWarning(AMF_FACILITY, L"Frame rate reported by the receiver (%5.2f) is lower than frame rate measured at the server (%5.2f), possible network congestion, QoS is lowering bitrate", sessionFramerate, m_Framerate);
-                                    if (++it->second.m_CongestionCnt > MAX_CONGESTION_EVENTS)
+                                    if (now - sessionFramerateHistory.GetLastUpdateTime() > m_InitParams.timeBeforePanic)
                                     {
-                                        it->second.m_CongestionBitrate = m_Bitrate;
-                                        AMFTraceWarning(AMF_FACILITY, L"One or more of the clients has limited network bandwidth, QoS is limiting video bitrate to %lld to avoid congestion", targetBitrate);
+                                        panic = true;
+                                        reasonForPanic = QoSPanic::NO_CLIENT_DATA;
+                                        lowerVideoBitrate = true;
+                                        lowerFrameRate = true;
+                                        AMFTraceWarning(AMF_FACILITY, L"Have not received statistics from the client, QoS is panicing");
+                                        break;
+                                    }
+
+                                    float sessionFramerate = sessionFramerateHistory.GetAverage();
+                                    if (sessionFramerate != 0 && m_Framerate != 0 && m_Framerate > sessionFramerate * 1.15 && (now - m_LastFpsAdjustmentTime) > m_InitParams.framerateAdjustmentPeriod)
+                                    {
+                                        lowerVideoBitrate = true;
+                                        sessionFramerateHistory.Clear();
+                                        AMFTraceWarning(AMF_FACILITY, L"Frame rate reported by the receiver (%5.2f) is lower than frame rate measured at the server (%5.2f), possible network congestion, QoS is lowering bitrate", sessionFramerate, m_Framerate);
+                                        if (++it->second.m_CongestionCnt > MAX_CONGESTION_EVENTS)
+                                        {
+                                            it->second.m_CongestionBitrate = m_Bitrate;
+                                            AMFTraceWarning(AMF_FACILITY, L"One or more of the clients has limited network bandwidth, QoS is limiting video bitrate to %lld to avoid congestion", targetBitrate);
+                                        }
                                     }
                                 }
                             }
@@ -227,11 +265,17 @@ namespace ssdk::util
                                     targetBitrate = m_InitParams.minBitrate;
                                 }
                             }
+                            UpdateSessionRate(it->second, now, sessionCongested);
+                        }
+
+                        if (perSession == true && panic == false)
+                        {
+                            targetBitrate = ApplyRatePolicy();
                         }
 
                         if (panic == false)
                         {
-                            if (m_Framerate != 0 && lowerVideoBitrate == false)
+                            if (perSession == false && m_Framerate != 0 && lowerVideoBitrate == false)
                             {
                                 float frameTime = 1000 / m_Framerate;
                                 if (m_WorstSendTime > (frameTime * 2.0f) ||
@@ -313,20 +357,27 @@ namespace ssdk::util
                             AMFTraceDebug(AMF_FACILITY, L"QoS is decreasing video bitrate by %lld bps, actual bandwidth is %5.2f Mbps", m_InitParams.bitrateStep, float(m_BitrateHistory.GetAverage()) / 1024 / 1024);
                             AdjustVideoBitrate(m_Bitrate - m_InitParams.bitrateStep);
                         }
+                        else if (m_InitParams.ratePolicy.mode != SessionRatePolicy::Mode::WORST_SESSION && m_Bitrate > targetBitrate)    //  Sessions the encoder bitrate is based on have slowed down
+                        {
+                            AMFTraceDebug(AMF_FACILITY, L"QoS is decreasing video bitrate towards %lld bps, actual bandwidth is %5.2f Mbps", targetBitrate, float(m_BitrateHistory.GetAverage()) / 1024 / 1024);
+                            AdjustVideoBitrate(std::max(targetBitrate, m_Bitrate - m_InitParams.bitrateStep));
+                        }
                         else if (m_Bitrate < targetBitrate)   //  Increase video bitrate - things are improving
                         {
                             AMFTraceDebug(AMF_FACILITY, L"QoS is increasing video bitrate by %lld bps, actual bandwidth is %5.2f Mbps", m_InitParams.bitrateStep, float(m_BitrateHistory.GetAverage()) / 1024 / 1024);
-                            AdjustVideoBitrate(m_Bitrate + m_InitParams.bitrateStep);
+                            AdjustVideoBitrate(m_InitParams.ratePolicy.mode != SessionRatePolicy::Mode::WORST_SESSION ? std::min(targetBitrate, m_Bitrate + m_InitParams.bitrateStep) : m_Bitrate + m_InitParams.bitrateStep);
                         }
                     }
                 }
             }
+            UpdateMetrics();
         }
         return AMF_OK;
     }
 
     void QoS::UpdateSessionStats(ssdk::transport_common::SessionHandle session, amf_pts lastStatsTime, float framerate, int64_t forceIDRReqCount, float sendTime, int64_t decoderQueueDepth)
     {
+        amf::AMFLock    lock(&m_Guard);
         if (m_Initialized != true)
         {
             return;
@@ -336,6 +387,7 @@ namespace ssdk::util
 
         SessionInfo& sessionInfo = m_SessionInfoMap[session];
         sessionInfo.m_FramerateHistory.AddValue(framerate, lastStatsTime);
+        sessionInfo.m_SendTime = sendTime;
 
         if (sessionInfo.m_ForceIDRReqCountUpdateTime < lastStatsTime)
         {
@@ -373,9 +425,125 @@ namespace ssdk::util
         m_SessionInfoMap.clear();
         m_BitrateHistory.Clear();
         m_WorstSendTime = 0.0f;
+        m_Tiers.clear();
+        UpdateMetrics();
 
         NotifyCallback(QoSEvent::FPS_CHANGE, amf::AMFVariant(m_InitParams.maxFramerate));
         NotifyCallback(QoSEvent::VIDEO_BITRATE_CHANGED, amf::AMFVariant(m_InitParams.maxBitrate));
+        m_TargetFramerateGauge->Set(m_InitParams.maxFramerate);
+        m_TargetBitrateGauge->Set(double(m_InitParams.maxBitrate));
+    }
+
+    void QoS::UpdateSessionRate(SessionInfo& sessionInfo, amf_pts now, bool congested)
+    {
+        int64_t bitrate = sessionInfo.m_TargetBitrate;
+        if (bitrate == 0)
+        {   //  New session, start where the encoder is
+            bitrate = m_Bitrate != 0 ? m_Bitrate : m_InitParams.maxBitrate;
+            sessionInfo.m_LastRateAdjustmentTime = now;
+        }
+        else if (congested == true && now - sessionInfo.m_LastRateAdjustmentTime > m_InitParams.bitrateAdjustmentPeriod / 4)
+        {   //  Back off faster than we probe up
+            bitrate -= m_InitParams.bitrateStep;
+        }
+        else if (congested == false && now - sessionInfo.m_LastRateAdjustmentTime > m_InitParams.bitrateAdjustmentPeriod)
+        {
+            bitrate += m_InitParams.bitrateStep;
+        }
+        bitrate = std::min(std::max(bitrate, m_InitParams.minBitrate), m_InitParams.maxBitrate);
+
+        if (bitrate != sessionInfo.m_TargetBitrate)
+        {
+            sessionInfo.m_TargetBitrate = bitrate;
+            sessionInfo.m_LastRateAdjustmentTime = now;
+        }
+        sessionInfo.m_Congested = congested;
+    }
+
+    int64_t QoS::ApplyRatePolicy()
+    {
+        std::vector<SessionRateState> states;
+        states.reserve(m_SessionInfoMap.size());
+        for (const auto& it : m_SessionInfoMap)
+        {
+            SessionRateState state;
+            state.session = it.first;
+            state.targetBitrate = it.second.m_TargetBitrate;
+            state.congested = it.second.m_Congested;
+            states.push_back(state);
+        }
+
+        SessionRatePolicy::Decision decision = m_RatePolicy.Evaluate(states);
+        for (auto& it : m_SessionInfoMap)
+        {
+            SessionRatePolicy::Decision::SessionBitrates::const_iterator found = decision.deliveryBitrates.find(it.first);
+            it.second.m_DropFilter.SetBitrate(found != decision.deliveryBitrates.end() ? found->second : 0);
+        }
+        if (decision.tiers != m_Tiers)
+        {
+            m_Tiers = decision.tiers;
+            AMFTraceInfo(AMF_FACILITY, L"Sessions regrouped into %d bitrate tiers", int(m_Tiers.size()));
+            NotifyCallback(QoSEvent::ENCODER_TIERS_CHANGED, amf::AMFVariant(int64_t(m_Tiers.size())));
+        }
+        return decision.encoderBitrate;
+    }
+
+    bool QoS::ShouldSendFrame(transport_common::SessionHandle session, const transport_common::TransmittableVideoFrame& frame)
+    {
+        FrameDropFilter::Verdict verdict = FrameDropFilter::Verdict::SEND;
+        {
+            amf::AMFLock lock(&m_Guard);
+            if (m_Initialized == true &&
+                (m_InitParams.ratePolicy.mode == SessionRatePolicy::Mode::PERCENTILE || m_InitParams.ratePolicy.mode == SessionRatePolicy::Mode::SELECTIVE_DROP ||
+                 m_InitParams.ratePolicy.mode == SessionRatePolicy::Mode::ENCODER_PER_TIER))
+            {
+                SessionInfoMap::iterator found = m_SessionInfoMap.find(session);
+                if (found != m_SessionInfoMap.end())
+                {
+                    transport_common::VideoFrame::SubframeType type = frame.GetSubframeCount() > 0 ? frame.GetSubframeType(frame.GetSubframeCount() - 1) : transport_common::VideoFrame::SubframeType::UNKNOWN;
+                    verdict = found->second.m_DropFilter.Filter(amf_high_precision_clock(), frame.GetPts(), frame.CalculateRequiredBufferSize(), type, frame.IsKeyFrame());
+                    if (verdict == FrameDropFilter::Verdict::DROP_UNTIL_KEY_FRAME)
+                    {
+                        AMFTraceInfo(AMF_FACILITY, L"Session %lld is too far behind at %lld bps, dropping frames until the next key frame", session, found->second.m_DropFilter.GetBitrate());
+                    }
+                }
+            }
+        }
+        if (verdict == FrameDropFilter::Verdict::DROP_UNTIL_KEY_FRAME)
+        {   //  Called on the video output path, notify without holding the lock
+            NotifyCallback(QoSEvent::KEY_FRAME_REQUESTED, amf::AMFVariant(int64_t(session)));
+        }
+        return verdict == FrameDropFilter::Verdict::SEND;
+    }
+
+    int64_t QoS::GetSessionBitrate(transport_common::SessionHandle session) const
+    {
+        amf::AMFLock lock(&m_Guard);
+        SessionInfoMap::const_iterator found = m_SessionInfoMap.find(session);
+        return found != m_SessionInfoMap.end() ? found->second.m_TargetBitrate : 0;
+    }
+
+    int64_t QoS::GetDeliveryBitrate(transport_common::SessionHandle session) const
+    {
+        amf::AMFLock lock(&m_Guard);
+        SessionInfoMap::const_iterator found = m_SessionInfoMap.find(session);
+        return found != m_SessionInfoMap.end() ? found->second.m_DropFilter.GetBitrate() : 0;
+    }
+
+    void QoS::SetSessionPaced(transport_common::SessionHandle session, bool paced)
+    {
+        amf::AMFLock lock(&m_Guard);
+        SessionInfoMap::iterator found = m_SessionInfoMap.find(session);
+        if (found != m_SessionInfoMap.end())
+        {
+            found->second.m_DropFilter.SetPaced(paced);
+        }
+    }
+
+    SessionRatePolicy::Decision::Tiers QoS::GetEncoderTiers() const
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_Tiers;
     }
 
     void QoS::AdjustFramerate(float targetFps)
@@ -401,6 +569,7 @@ namespace ssdk::util
         {
             NotifyCallback(QoSEvent::FPS_CHANGE, amf::AMFVariant(targetFps));
             m_LastFpsAdjustmentTime = amf_high_precision_clock();
+            m_TargetFramerateGauge->Set(targetFps);
         }
     }
 
@@ -428,9 +597,18 @@ namespace ssdk::util
             NotifyCallback(QoSEvent::VIDEO_BITRATE_CHANGED, amf::AMFVariant(targetBitrate));
             m_LastVideoBitrateAdjustmentTime = amf_high_precision_clock();
             m_Bitrate = targetBitrate;
+            m_TargetBitrateGauge->Set(double(targetBitrate));
         }
     }
 
+    void QoS::UpdateMetrics()
+    {
+        m_FramerateGauge->Set(m_Framerate);
+        m_BitrateGauge->Set(double(m_BitrateHistory.GetAverage()));
+        m_EncoderQueueDepthGauge->Set(double(m_EncoderQueueDepth));
+        m_PanicGauge->Set(m_Panic == true ? 1 : 0);
+    }
+
     void QoS::NotifyCallback(QoSEvent event, const amf::AMFVariantStruct& value)
     {
         if (m_pQoSCB != nullptr)
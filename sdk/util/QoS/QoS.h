@@ -38,6 +38,8 @@ THE SOFTWARE.
 #include "transports/transport-common/ServerTransport.h"
 #include "amf/public/common/Thread.h"
 #include "ValueHistory.h"
+#include "SessionRatePolicy.h"
+#include "util/metrics/MetricsRegistry.h"
 
 #include <map>
 #include <set>
@@ -60,7 +62,9 @@ namespace ssdk::util
             VIDEO_BITRATE_CHANGED,                    //  QoS is about to change video bitrate to int64_t(value)
             VIDEO_BITRATE_REACHED_LOW_LIMIT,          //  Video bitrate has reached the low limit of int64_t(value)
             VIDEO_BITRATE_REACHED_HIGH_LIMIT,         //  Video bitrate has reached the high limit of int64_t(value)
-            VIDEO_ENCODER_QUEUE_THRESHOLD_EXCEEDED    //  Video encoder queue depth threshold has been exceeeded
+            VIDEO_ENCODER_QUEUE_THRESHOLD_EXCEEDED,   //  Video encoder queue depth threshold has been exceeeded
+            ENCODER_TIERS_CHANGED,                    //  Sessions were regrouped into bitrate tiers, value is int64_t(number of tiers), call GetEncoderTiers() for details
+            KEY_FRAME_REQUESTED                       //  Frames are being dropped for session int64_t(value) until the next key frame
         };
 
         enum class QoSPanic
@@ -105,6 +109,8 @@ namespace ssdk::util
             int64_t maxBitrate = 0;                         // maximum video bitrate QoS would go up to in bps
             int64_t bitrateStep = 0;                        // video bitrate adjustment step in bps
             amf_pts bitrateAdjustmentPeriod = 10;           // in amf_pts - frequency of video bitrate adjustments
+
+            SessionRatePolicy::Params ratePolicy;           // how per-session bitrates are combined, the worst session drives the encoder by default
         };
         
         class VideoOutputStats
@@ -117,7 +123,7 @@ namespace ssdk::util
         };
 
     public:
-        QoS(QoSCallback* pQoSCB, ssdk::transport_common::StreamID streamID) : m_pQoSCB(pQoSCB), m_StreamID(streamID) {};
+        QoS(QoSCallback* pQoSCB, ssdk::transport_common::StreamID streamID);
         ~QoS() {};
 
         AMF_RESULT Init(InitParams initParams);
@@ -128,11 +134,22 @@ namespace ssdk::util
             float framerate, int64_t forceIDRReqCount, float sendTime, int64_t decoderQueueDepth);
         void UnregisterSession(transport_common::SessionHandle session);
 
+        bool ShouldSendFrame(transport_common::SessionHandle session, const transport_common::TransmittableVideoFrame& frame);
+        int64_t GetSessionBitrate(transport_common::SessionHandle session) const;
+        int64_t GetDeliveryBitrate(transport_common::SessionHandle session) const;     // 0 when the session gets every frame the encoder produces
+        void SetSessionPaced(transport_common::SessionHandle session, bool paced);     // The transport holds video back to the delivery bitrate
+        SessionRatePolicy::Decision::Tiers GetEncoderTiers() const;
+
     private:
+        class SessionInfo;
+
         void ResetCounters();
+        void UpdateSessionRate(SessionInfo& sessionInfo, amf_pts now, bool congested);
+        int64_t ApplyRatePolicy();
         void AdjustFramerate(float targetFps);
         void AdjustVideoBitrate(int64_t targetBitrate);
         void NotifyCallback(QoSEvent event, const amf::AMFVariantStruct& value);
+        void UpdateMetrics();
         
     private:
         QoSCallback*            m_pQoSCB = nullptr;
@@ -157,6 +174,14 @@ namespace ssdk::util
         int64_t                     m_EncoderQueueDepth = 0;
         bool                        m_Panic = false;
         amf_pts                     m_LastPanicTime = 0;    
+
+        //  Exported through MetricsRegistry, labeled with the stream
+        MetricsRegistry::Gauge::Ptr m_FramerateGauge;
+        MetricsRegistry::Gauge::Ptr m_TargetFramerateGauge;
+        MetricsRegistry::Gauge::Ptr m_BitrateGauge;
+        MetricsRegistry::Gauge::Ptr m_TargetBitrateGauge;
+        MetricsRegistry::Gauge::Ptr m_EncoderQueueDepthGauge;
+        MetricsRegistry::Gauge::Ptr m_PanicGauge;
         
         // collected session stats updated in UpdateSessionStats  
         class SessionInfo
@@ -170,11 +195,20 @@ namespace ssdk::util
             float                       m_DecoderQueueOverflowFps = 0;
             int                         m_CongestionCnt = 0;
             int64_t                     m_CongestionBitrate = 0;
+            float                       m_SendTime = 0;
+
+            int64_t                     m_TargetBitrate = 0;
+            amf_pts                     m_LastRateAdjustmentTime = 0;
+            bool                        m_Congested = false;
+            FrameDropFilter             m_DropFilter;
         };
         
         typedef std::map<transport_common::SessionHandle, SessionInfo> SessionInfoMap;
         SessionInfoMap m_SessionInfoMap;
         float                       m_WorstSendTime = 0;
         ValueHistory<float, 5>      m_WorstSendTimeHistory;
+
+        SessionRatePolicy                   m_RatePolicy;
+        SessionRatePolicy::Decision::Tiers  m_Tiers;
     };
 }
@@ -0,0 +1,200 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include "SessionRatePolicy.h"
+
+#include <algorithm>
+
+namespace ssdk::util
+{
+    void SessionRatePolicy::SetParams(const Params& params)
+    {
+        m_Params = params;
+        m_Params.percentile = std::min(std::max(m_Params.percentile, 0.0f), 1.0f);
+        std::sort(m_Params.tierBitrates.begin(), m_Params.tierBitrates.end());
+    }
+
+    SessionRatePolicy::Decision SessionRatePolicy::Evaluate(const std::vector<SessionRateState>& sessions) const
+    {
+        Decision decision;
+        if (sessions.empty() == false)
+        {
+            std::vector<int64_t> bitrates;
+            bitrates.reserve(sessions.size());
+            for (const SessionRateState& state : sessions)
+            {
+                bitrates.push_back(state.targetBitrate);
+            }
+            std::sort(bitrates.begin(), bitrates.end());
+
+            switch (m_Params.mode)
+            {
+            case Mode::WORST_SESSION:
+                decision.encoderBitrate = bitrates.front();
+                break;
+            case Mode::PERCENTILE:
+                decision.encoderBitrate = bitrates[size_t(m_Params.percentile * (bitrates.size() - 1) + 0.5f)];
+                break;
+            case Mode::SELECTIVE_DROP:
+                decision.encoderBitrate = bitrates.back();
+                break;
+            case Mode::ENCODER_PER_TIER:
+                for (const SessionRateState& state : sessions)
+                {
+                    decision.tiers[GetTierBitrate(state.targetBitrate)].insert(state.session);
+                }
+                decision.encoderBitrate = decision.tiers.rbegin()->first;
+                for (const auto& tier : decision.tiers)
+                {   //  A single encoder serves every tier for now, sessions below the top one are paced to their tier
+                    if (tier.first < decision.encoderBitrate)
+                    {
+                        for (transport_common::SessionHandle session : tier.second)
+                        {
+                            decision.deliveryBitrates[session] = tier.first;
+                        }
+                    }
+                }
+                break;
+            }
+
+            if (m_Params.mode == Mode::PERCENTILE || m_Params.mode == Mode::SELECTIVE_DROP)
+            {   //  Sessions which cannot sustain the encoder bitrate are paced by dropping frames
+                for (const SessionRateState& state : sessions)
+                {
+                    if (state.targetBitrate < decision.encoderBitrate)
+                    {
+                        decision.deliveryBitrates[state.session] = state.targetBitrate;
+                    }
+                }
+            }
+        }
+        return decision;
+    }
+
+    int64_t SessionRatePolicy::GetTierBitrate(int64_t sessionBitrate) const
+    {
+        int64_t result = sessionBitrate;
+        if (m_Params.tierBitrates.empty() == false)
+        {   //  The highest tier the session can sustain, sessions below the lowest tier still get the lowest one
+            result = m_Params.tierBitrates.front();
+            for (int64_t tierBitrate : m_Params.tierBitrates)
+            {
+                if (tierBitrate <= sessionBitrate)
+                {
+                    result = tierBitrate;
+                }
+            }
+        }
+        return result;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    void FrameDropFilter::SetBitrate(int64_t bitrate) noexcept
+    {   //  Called on every policy evaluation, the budget survives as long as the session stays paced
+        if (bitrate != m_Bitrate)
+        {
+            if (m_Bitrate == 0 || bitrate == 0)
+            {
+                m_Budget = 0;
+            }
+            else
+            {
+                m_Budget = std::min(m_Budget, bitrate / 2);
+            }
+            m_Bitrate = bitrate;
+        }
+    }
+
+    FrameDropFilter::Verdict FrameDropFilter::Filter(amf_pts now, amf_pts frameID, size_t size, transport_common::VideoFrame::SubframeType type, bool keyFrame)
+    {
+        if (m_Bitrate != 0 && m_LastTime != 0 && now > m_LastTime)
+        {   //  Refill the budget, allowing at most half a second worth of burst
+            amf_pts elapsed = std::min(now - m_LastTime, amf_pts(AMF_SECOND));
+            m_Budget = std::min(m_Budget + int64_t(m_Bitrate * elapsed / AMF_SECOND), m_Bitrate / 2);
+        }
+        m_LastTime = now;
+
+        bool continuation = m_SliceOpen == true && frameID == m_SliceFrameID;
+        m_SliceOpen = type == transport_common::VideoFrame::SubframeType::SLICE;
+        m_SliceFrameID = frameID;
+
+        Verdict verdict = Verdict::SEND;
+        if (continuation == true)
+        {   //  The rest of a frame follows the verdict made on its first slice
+            verdict = m_SliceVerdict == Verdict::SEND ? Verdict::SEND : Verdict::DROP;
+        }
+        else if (keyFrame == true || type == transport_common::VideoFrame::SubframeType::IDR || type == transport_common::VideoFrame::SubframeType::I)
+        {   //  Key frames are always sent so that the session can resume decoding
+            m_WaitForKeyFrame = false;
+        }
+        else if (m_WaitForKeyFrame == true)
+        {
+            verdict = Verdict::DROP;
+        }
+        else if (m_Bitrate != 0 && m_Budget < 0)
+        {
+            if (type == transport_common::VideoFrame::SubframeType::B)
+            {   //  Nothing references B-frames, dropping them does not affect decoding of the following frames
+                verdict = Verdict::DROP;
+            }
+            else if (m_Paced == false && m_Budget < -m_Bitrate / 2)
+            {   //  More than half a second behind, skip to the next key frame
+                verdict = Verdict::DROP_UNTIL_KEY_FRAME;
+                m_WaitForKeyFrame = true;
+            }
+        }
+
+        if (verdict == Verdict::SEND)
+        {
+            if (m_Bitrate != 0)
+            {   //  A paced session is held back by the transport, a deficit beyond what it can hold only delays the recovery
+                m_Budget -= int64_t(size) * 8;
+                if (m_Paced == true)
+                {
+                    m_Budget = std::max(m_Budget, -m_Bitrate / 2);
+                }
+            }
+        }
+        else if (continuation == false)
+        {
+            ++m_DroppedFrames;
+        }
+        if (continuation == false)
+        {
+            m_SliceVerdict = verdict;
+        }
+        return verdict;
+    }
+}
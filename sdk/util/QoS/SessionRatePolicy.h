@@ -0,0 +1,143 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#include "transports/transport-common/ServerTransport.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ssdk::util
+{
+    //  Rate state QoS maintains for every session from the statistics reported by its client
+    class SessionRateState
+    {
+    public:
+        transport_common::SessionHandle session = 0;
+        int64_t targetBitrate = 0;                      // bitrate the session can currently sustain in bps
+        bool    congested = false;                      // the session showed signs of congestion during the last evaluation
+    };
+
+    //  SessionRatePolicy: turns per-session rate states into an encoder bitrate and per-session delivery decisions.
+    //  It is stateless and does not read the clock, so it can be driven by synthetic per-session stats.
+    class SessionRatePolicy
+    {
+    public:
+        enum class Mode
+        {
+            WORST_SESSION,                              //  Single encoder bitrate driven by the worst session, every viewer gets every frame
+            PERCENTILE,                                 //  Single encoder bitrate at a percentile of session bitrates, sessions below it have frames dropped
+            SELECTIVE_DROP,                             //  Encoder runs at the best session's bitrate, slower sessions have frames dropped
+            ENCODER_PER_TIER                            //  Sessions are grouped into bitrate tiers, the encoder runs at the top tier and sessions in lower tiers
+                                                        //  are paced to their tier bitrate until an encoder instance per tier exists
+        };
+
+        class Params
+        {
+        public:
+            Mode                    mode = Mode::WORST_SESSION;
+            float                   percentile = 0.5f;  // 0..1, used by PERCENTILE
+            std::vector<int64_t>    tierBitrates;       // in bps, used by ENCODER_PER_TIER
+        };
+
+        class Decision
+        {
+        public:
+            typedef std::map<transport_common::SessionHandle, int64_t>   SessionBitrates;
+            typedef std::map<int64_t, std::set<transport_common::SessionHandle>> Tiers;
+
+            int64_t         encoderBitrate = 0;         // bitrate of the primary encoder in bps
+            SessionBitrates deliveryBitrates;           // sessions which must be delivered fewer frames than the encoder produces, in bps
+            Tiers           tiers;                      // occupied tiers: tier bitrate -> sessions, ENCODER_PER_TIER only
+        };
+
+    public:
+        SessionRatePolicy() = default;
+
+        void SetParams(const Params& params);
+        inline const Params& GetParams() const noexcept { return m_Params; }
+
+        Decision Evaluate(const std::vector<SessionRateState>& sessions) const;
+
+    private:
+        int64_t GetTierBitrate(int64_t sessionBitrate) const;
+
+    private:
+        Params  m_Params;
+    };
+
+    //  FrameDropFilter: paces video frames sent to a single session to its delivery bitrate.
+    //  Non-reference frames are dropped first, reference frames only once the session falls far enough behind,
+    //  after which nothing but key frames is sent until the session has recovered.
+    //  When the transport paces the session itself, reference frames are always passed on and left to it to delay:
+    //  streams without B-frames, which is what the low latency encoders produce, would otherwise go straight
+    //  to dropping until a key frame whenever the session is behind.
+    //  Slices of one frame share its ID and the verdict made on the first slice, a frame is never sent partially.
+    class FrameDropFilter
+    {
+    public:
+        enum class Verdict
+        {
+            SEND,
+            DROP,
+            DROP_UNTIL_KEY_FRAME                        //  A reference frame was dropped, the session needs a key frame to resume decoding
+        };
+
+    public:
+        void SetBitrate(int64_t bitrate) noexcept;      // 0 - no limit
+        inline void SetPaced(bool paced) noexcept { m_Paced = paced; }
+        inline bool IsPaced() const noexcept { return m_Paced; }
+        inline int64_t GetBitrate() const noexcept { return m_Bitrate; }
+        inline int64_t GetBudget() const noexcept { return m_Budget; }
+        inline int64_t GetDroppedFrames() const noexcept { return m_DroppedFrames; }
+
+        //  frameID: PTS shared by all slices of a frame, keyFrame: the frame is a key frame, valid on every slice
+        Verdict Filter(amf_pts now, amf_pts frameID, size_t size, transport_common::VideoFrame::SubframeType type, bool keyFrame);
+
+    private:
+        int64_t     m_Bitrate = 0;
+        int64_t     m_Budget = 0;                       // in bits, goes negative when the session is behind
+        amf_pts     m_LastTime = 0;
+        bool        m_WaitForKeyFrame = false;
+        bool        m_Paced = false;
+        int64_t     m_DroppedFrames = 0;
+
+        bool        m_SliceOpen = false;                //  The last slice filtered was not the last one of its frame
+        amf_pts     m_SliceFrameID = 0;
+        Verdict     m_SliceVerdict = Verdict::SEND;
+    };
+}
@@ -89,5 +89,10 @@ namespace ssdk::util
         {
             return m_Count > 0 ? static_cast<float>(m_RunningSum) / m_Count : 0.0;
         }
+
+        size_t GetCount() const
+        {
+            return m_Count;
+        }
     };
 }
@@ -0,0 +1,592 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "PCMConverter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#if defined(__AVX__)
+#define SSDK_PCM_AVX
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SSDK_PCM_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SSDK_PCM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace ssdk::util
+{
+    static constexpr float S16_TO_FLOAT = 1.0f / 32768.0f;
+    static constexpr double RESAMPLER_KAISER_BETA = 9.0;
+    static constexpr double RESAMPLER_ROLLOFF = 0.92;          //  Cutoff as a fraction of the lower Nyquist frequency
+    static constexpr float CENTER_MIX_LEVEL = 0.70710678f;     //  -3dB
+    static constexpr float SURROUND_MIX_LEVEL = 0.70710678f;
+
+    //  Sample conversion matches FFmpeg's swresample: s16->flt scales by 1/32768, flt->s16 rounds to nearest and saturates
+    static void S16ToFloat(const int16_t* input, float* output, size_t count) noexcept
+    {
+        size_t i = 0;
+#if defined(SSDK_PCM_SSE2)
+        const __m128 scale = _mm_set1_ps(S16_TO_FLOAT);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);     //  Sign-extend to 32 bit
+            __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+            _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+        }
+#elif defined(SSDK_PCM_NEON)
+        const float32x4_t scale = vdupq_n_f32(S16_TO_FLOAT);
+        for (; i + 8 <= count; i += 8)
+        {
+            int16x8_t samples = vld1q_s16(input + i);
+            vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), scale));
+            vst1q_f32(output + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))), scale));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            output[i] = float(input[i]) * S16_TO_FLOAT;
+        }
+    }
+
+    static void FloatToS16(const float* input, int16_t* output, size_t count) noexcept
+    {
+        size_t i = 0;
+#if defined(SSDK_PCM_SSE2)
+        const __m128 scale = _mm_set1_ps(32768.0f);
+        const __m128 minValue = _mm_set1_ps(-32768.0f);
+        const __m128 maxValue = _mm_set1_ps(32767.0f);
+        for (; i + 8 <= count; i += 8)
+        {   //  Clamp before converting: out of range values convert to INT_MIN regardless of their sign
+            __m128 low = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(input + i), scale), minValue), maxValue);
+            __m128 high = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(input + i + 4), scale), minValue), maxValue);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(_mm_cvtps_epi32(low), _mm_cvtps_epi32(high)));
+        }
+#elif defined(SSDK_PCM_NEON)
+        const float32x4_t scale = vdupq_n_f32(32768.0f);
+        for (; i + 8 <= count; i += 8)
+        {
+            int32x4_t low = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(input + i), scale));      //  Saturating, round to nearest even
+            int32x4_t high = vcvtnq_s32_f32(vmulq_f32(vld1q_f32(input + i + 4), scale));
+            vst1q_s16(output + i, vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            float sample = std::nearbyint(input[i] * 32768.0f);
+            output[i] = int16_t(std::min(std::max(sample, -32768.0f), 32767.0f));
+        }
+    }
+
+    //  count is a multiple of 8
+    static inline float DotProduct(const float* a, const float* b, size_t count) noexcept
+    {
+#if defined(SSDK_PCM_AVX)
+        __m256 acc = _mm256_setzero_ps();
+        for (size_t i = 0; i < count; i += 8)
+        {
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        }
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum);
+#elif defined(SSDK_PCM_SSE2)
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        for (size_t i = 0; i < count; i += 8)
+        {
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+        __m128 sum = _mm_add_ps(acc0, acc1);
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum);
+#elif defined(SSDK_PCM_NEON)
+        float32x4_t acc0 = vdupq_n_f32(0);
+        float32x4_t acc1 = vdupq_n_f32(0);
+        for (size_t i = 0; i < count; i += 8)
+        {
+            acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+            acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        }
+        float32x4_t sum = vaddq_f32(acc0, acc1);
+        float32x2_t pair = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+        return vget_lane_f32(vpadd_f32(pair, pair), 0);
+#else
+        float acc[8] = {};
+        for (size_t i = 0; i < count; i += 8)
+        {
+            for (size_t j = 0; j < 8; ++j)
+            {
+                acc[j] += a[i + j] * b[i + j];
+            }
+        }
+        return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+#endif
+    }
+
+    static bool IsFormatSupported(amf::AMF_AUDIO_FORMAT format) noexcept
+    {
+        return format == amf::AMFAF_S16 || format == amf::AMFAF_S16P || format == amf::AMFAF_FLT || format == amf::AMFAF_FLTP;
+    }
+
+    static bool IsPlanar(amf::AMF_AUDIO_FORMAT format) noexcept
+    {
+        return format == amf::AMFAF_S16P || format == amf::AMFAF_FLTP;
+    }
+
+    static bool IsFloat(amf::AMF_AUDIO_FORMAT format) noexcept
+    {
+        return format == amf::AMFAF_FLT || format == amf::AMFAF_FLTP;
+    }
+
+    static int32_t CountBits(int32_t mask) noexcept
+    {
+        int32_t count = 0;
+        for (; mask != 0; mask &= mask - 1)
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    //  Layout to use when the stream does not specify one or specifies one inconsistent with its channel count
+    static int32_t GetEffectiveLayout(int32_t layout, int32_t channels) noexcept
+    {
+        if (layout != 0 && CountBits(layout) == channels)
+        {
+            return layout;
+        }
+        switch (channels)
+        {
+        case 1:
+            return amf::AMFACL_SPEAKER_FRONT_CENTER;
+        case 2:
+            return amf::AMFACL_SPEAKER_FRONT_LEFT | amf::AMFACL_SPEAKER_FRONT_RIGHT;
+        case 6:
+            return amf::AMFACL_SPEAKER_FRONT_LEFT | amf::AMFACL_SPEAKER_FRONT_RIGHT | amf::AMFACL_SPEAKER_FRONT_CENTER |
+                   amf::AMFACL_SPEAKER_LOW_FREQUENCY | amf::AMFACL_SPEAKER_BACK_LEFT | amf::AMFACL_SPEAKER_BACK_RIGHT;
+        default:
+            return 0;
+        }
+    }
+
+    static std::vector<int32_t> GetSpeakers(int32_t layout)
+    {
+        std::vector<int32_t> speakers;
+        for (int32_t bit = 0; bit < 31; ++bit)
+        {
+            if ((layout & (1 << bit)) != 0)
+            {
+                speakers.push_back(1 << bit);
+            }
+        }
+        return speakers;
+    }
+
+    static double BesselI0(double x) noexcept
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 50; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12)
+            {
+                break;
+            }
+        }
+        return sum;
+    }
+
+    bool PCMConverter::IsSupported(const Format& input, const Format& output)
+    {
+        if (IsFormatSupported(input.format) == false || IsFormatSupported(output.format) == false ||
+            input.channels < 1 || input.channels > 8 || output.channels < 1 || output.channels > 8 ||
+            input.samplingRate <= 0 || output.samplingRate <= 0)
+        {
+            return false;
+        }
+        if (GetEffectiveLayout(input.layout, input.channels) == 0 || GetEffectiveLayout(output.layout, output.channels) == 0)
+        {
+            return false;
+        }
+        int64_t divisor = std::gcd(int64_t(input.samplingRate), int64_t(output.samplingRate));
+        return output.samplingRate / divisor <= MAX_RESAMPLER_PHASES;
+    }
+
+    bool PCMConverter::Init(const Format& input, const Format& output)
+    {
+        m_Initialized = false;
+        if (IsSupported(input, output) == false)
+        {
+            return false;
+        }
+        m_Input = input;
+        m_Output = output;
+        m_Input.layout = GetEffectiveLayout(input.layout, input.channels);
+        m_Output.layout = GetEffectiveLayout(output.layout, output.channels);
+        ComputeMixMatrix();
+        BuildResampler();
+        m_Initialized = true;
+        return true;
+    }
+
+    void PCMConverter::Reset()
+    {
+        m_Position = 0;
+        std::fill(m_History.begin(), m_History.end(), 0.0f);
+    }
+
+    void PCMConverter::ComputeMixMatrix()
+    {
+        std::vector<int32_t> inputSpeakers = GetSpeakers(m_Input.layout);
+        std::vector<int32_t> outputSpeakers = GetSpeakers(m_Output.layout);
+        m_Remix = m_Input.layout != m_Output.layout;
+        m_MixMatrix.assign(outputSpeakers.size() * inputSpeakers.size(), 0.0f);
+        if (m_Remix == false)
+        {
+            return;
+        }
+        auto hasOutput = [this](int32_t speaker) { return (m_Output.layout & speaker) != 0; };
+        auto index = [&outputSpeakers](int32_t speaker) { return size_t(std::find(outputSpeakers.begin(), outputSpeakers.end(), speaker) - outputSpeakers.begin()); };
+        auto mix = [&](int32_t to, size_t from, float level)
+        {
+            if (hasOutput(to) == true)
+            {
+                m_MixMatrix[index(to) * inputSpeakers.size() + from] += level;
+            }
+        };
+        const int32_t FL = amf::AMFACL_SPEAKER_FRONT_LEFT, FR = amf::AMFACL_SPEAKER_FRONT_RIGHT, FC = amf::AMFACL_SPEAKER_FRONT_CENTER;
+        const int32_t BL = amf::AMFACL_SPEAKER_BACK_LEFT, BR = amf::AMFACL_SPEAKER_BACK_RIGHT, BC = amf::AMFACL_SPEAKER_BACK_CENTER;
+        const int32_t SL = amf::AMFACL_SPEAKER_SIDE_LEFT, SR = amf::AMFACL_SPEAKER_SIDE_RIGHT;
+        const int32_t FLC = amf::AMFACL_SPEAKER_FRONT_LEFT_OF_CENTER, FRC = amf::AMFACL_SPEAKER_FRONT_RIGHT_OF_CENTER;
+        for (size_t i = 0; i < inputSpeakers.size(); ++i)
+        {
+            int32_t speaker = inputSpeakers[i];
+            if (hasOutput(speaker) == true)
+            {
+                mix(speaker, i, 1.0f);
+                continue;
+            }
+            //  The speaker is missing from the output, fold it into the closest ones. LFE is dropped, as FFmpeg does by default
+            bool left = speaker == BL || speaker == SL || speaker == FLC;
+            bool right = speaker == BR || speaker == SR || speaker == FRC;
+            if (speaker == FL || speaker == FR)
+            {
+                mix(FC, i, CENTER_MIX_LEVEL);
+            }
+            else if (speaker == FC)
+            {
+                mix(FL, i, CENTER_MIX_LEVEL);
+                mix(FR, i, CENTER_MIX_LEVEL);
+            }
+            else if (left == true || right == true)
+            {
+                int32_t sameSide = left == true ? (speaker == BL ? SL : BL) : (speaker == BR ? SR : BR);
+                if (speaker != FLC && speaker != FRC && hasOutput(sameSide) == true)
+                {
+                    mix(sameSide, i, 1.0f);
+                }
+                else if (hasOutput(left == true ? FL : FR) == true)
+                {
+                    mix(left == true ? FL : FR, i, SURROUND_MIX_LEVEL);
+                }
+                else
+                {
+                    mix(FC, i, SURROUND_MIX_LEVEL);
+                }
+            }
+            else if (speaker == BC)
+            {
+                if (hasOutput(BL) == true || hasOutput(BR) == true)
+                {
+                    mix(BL, i, SURROUND_MIX_LEVEL);
+                    mix(BR, i, SURROUND_MIX_LEVEL);
+                }
+                else
+                {
+                    mix(FL, i, SURROUND_MIX_LEVEL * CENTER_MIX_LEVEL);
+                    mix(FR, i, SURROUND_MIX_LEVEL * CENTER_MIX_LEVEL);
+                }
+            }
+        }
+        //  Scale the whole matrix so that no output can clip, keeping the balance between channels
+        float maxGain = 0.0f;
+        for (size_t o = 0; o < outputSpeakers.size(); ++o)
+        {
+            float gain = 0.0f;
+            for (size_t i = 0; i < inputSpeakers.size(); ++i)
+            {
+                gain += m_MixMatrix[o * inputSpeakers.size() + i];
+            }
+            maxGain = std::max(maxGain, gain);
+        }
+        if (maxGain > 1.0f)
+        {
+            for (float& coefficient : m_MixMatrix)
+            {
+                coefficient /= maxGain;
+            }
+        }
+    }
+
+    void PCMConverter::BuildResampler()
+    {
+        int64_t divisor = std::gcd(int64_t(m_Input.samplingRate), int64_t(m_Output.samplingRate));
+        m_Interpolation = m_Output.samplingRate / divisor;
+        m_Decimation = m_Input.samplingRate / divisor;
+        m_Position = 0;
+        m_History.assign(size_t(m_Output.channels) * (RESAMPLER_TAPS - 1), 0.0f);
+        m_Coefficients.clear();
+        if (m_Interpolation == m_Decimation)
+        {
+            return;
+        }
+        //  Kaiser-windowed sinc low-pass at the interpolated rate, cut off below the lower of the two Nyquist frequencies
+        const int64_t length = int64_t(RESAMPLER_TAPS) * m_Interpolation;
+        const double cutoff = 0.5 * std::min(1.0, double(m_Interpolation) / double(m_Decimation)) * RESAMPLER_ROLLOFF;     //  In cycles per input sample
+        const double center = double(length - 1) / 2.0;
+        const double i0Beta = BesselI0(RESAMPLER_KAISER_BETA);
+        constexpr double PI = 3.14159265358979323846;
+        m_Coefficients.resize(size_t(length));
+        for (int64_t phase = 0; phase < m_Interpolation; ++phase)
+        {
+            float* coefficients = &m_Coefficients[size_t(phase * RESAMPLER_TAPS)];
+            double sum = 0.0;
+            for (size_t tap = 0; tap < RESAMPLER_TAPS; ++tap)
+            {   //  Stored in reverse so that the filter is applied as a forward dot product with the input
+                int64_t j = phase + int64_t(RESAMPLER_TAPS - 1 - tap) * m_Interpolation;
+                double t = (double(j) - center) / double(m_Interpolation);
+                double x = 2.0 * cutoff * t;
+                double sinc = x == 0.0 ? 1.0 : std::sin(PI * x) / (PI * x);
+                double w = 2.0 * double(j) / double(length - 1) - 1.0;
+                double window = BesselI0(RESAMPLER_KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - w * w))) / i0Beta;
+                double value = 2.0 * cutoff * sinc * window;
+                coefficients[tap] = float(value);
+                sum += value;
+            }
+            for (size_t tap = 0; tap < RESAMPLER_TAPS; ++tap)
+            {   //  Unity gain at DC for every phase
+                coefficients[tap] = float(coefficients[tap] / sum);
+            }
+        }
+    }
+
+    size_t PCMConverter::GetOutputSampleCount(size_t inputSampleCount) const noexcept
+    {
+        if (m_Interpolation == m_Decimation)
+        {
+            return inputSampleCount;
+        }
+        //  Outputs are produced at m_Position + k * m_Decimation for as long as they fall within the input
+        int64_t span = int64_t(inputSampleCount) * m_Interpolation - m_Position;
+        return span > 0 ? size_t((span + m_Decimation - 1) / m_Decimation) : 0;
+    }
+
+    amf_pts PCMConverter::GetOutputPtsOffset() const noexcept
+    {
+        if (m_Interpolation == m_Decimation)
+        {
+            return 0;
+        }
+        //  Output at position P weighs input sample n by coefficient P - n * m_Interpolation, so it stands for the input at P - center
+        const double center = double(int64_t(RESAMPLER_TAPS) * m_Interpolation - 1) / 2.0;
+        const double offset = (double(m_Position) - center) / double(m_Interpolation * m_Input.samplingRate);
+        return amf_pts(std::llround(offset * double(AMF_SECOND)));
+    }
+
+    size_t PCMConverter::Resample(size_t inputSampleCount, size_t maxOutputSampleCount)
+    {
+        //  m_Mixed holds the input planes, the output planes go to m_Resampled, each maxOutputSampleCount long
+        const size_t historySize = RESAMPLER_TAPS - 1;
+        const size_t workSize = historySize + inputSampleCount;
+        m_Window.resize(workSize);
+        float* work = m_Window.data();
+        size_t produced = 0;
+        int64_t position = m_Position;
+        m_Resampled.resize(size_t(m_Output.channels) * maxOutputSampleCount);
+        for (int32_t channel = 0; channel < m_Output.channels; ++channel)
+        {
+            float* history = &m_History[channel * historySize];
+            memcpy(work, history, historySize * sizeof(float));
+            memcpy(work + historySize, &m_Mixed[channel * inputSampleCount], inputSampleCount * sizeof(float));
+
+            float* output = &m_Resampled[channel * maxOutputSampleCount];
+            position = m_Position;
+            produced = 0;
+            for (int64_t base = position / m_Interpolation; base < int64_t(inputSampleCount) && produced < maxOutputSampleCount; base = position / m_Interpolation)
+            {
+                const float* coefficients = &m_Coefficients[size_t((position % m_Interpolation) * RESAMPLER_TAPS)];
+                output[produced++] = DotProduct(coefficients, work + base, RESAMPLER_TAPS);
+                position += m_Decimation;
+            }
+            memcpy(history, work + inputSampleCount, historySize * sizeof(float));
+        }
+        m_Position = position - int64_t(inputSampleCount) * m_Interpolation;
+        return produced;
+    }
+
+    size_t PCMConverter::Convert(const void* input, size_t inputSampleCount, void* output, size_t maxOutputSampleCount)
+    {
+        if (m_Initialized == false || input == nullptr || (output == nullptr && maxOutputSampleCount != 0) || inputSampleCount == 0)
+        {
+            return 0;
+        }
+        const size_t inputChannels = size_t(m_Input.channels);
+        const size_t outputChannels = size_t(m_Output.channels);
+        const size_t inputSamples = inputSampleCount * inputChannels;
+
+        //  Bring the input to float planar
+        const float* planes = nullptr;
+        if (m_Input.format == amf::AMFAF_FLTP)
+        {
+            planes = static_cast<const float*>(input);
+        }
+        else
+        {
+            m_Deinterleaved.resize(inputSamples);
+            const float* samples = static_cast<const float*>(input);
+            if (IsFloat(m_Input.format) == false)
+            {
+                m_Resampled.resize(inputSamples);
+                S16ToFloat(static_cast<const int16_t*>(input), IsPlanar(m_Input.format) ? m_Deinterleaved.data() : m_Resampled.data(), inputSamples);
+                samples = m_Resampled.data();
+            }
+            if (IsPlanar(m_Input.format) == false)
+            {
+                for (size_t channel = 0; channel < inputChannels; ++channel)
+                {
+                    float* plane = &m_Deinterleaved[channel * inputSampleCount];
+                    for (size_t i = 0; i < inputSampleCount; ++i)
+                    {
+                        plane[i] = samples[i * inputChannels + channel];
+                    }
+                }
+            }
+            planes = m_Deinterleaved.data();
+        }
+
+        //  Remix to the output layout
+        m_Mixed.resize(outputChannels * inputSampleCount);
+        if (m_Remix == true)
+        {
+            std::fill(m_Mixed.begin(), m_Mixed.end(), 0.0f);
+            for (size_t o = 0; o < outputChannels; ++o)
+            {
+                float* mixed = &m_Mixed[o * inputSampleCount];
+                for (size_t i = 0; i < inputChannels; ++i)
+                {
+                    float level = m_MixMatrix[o * inputChannels + i];
+                    if (level != 0.0f)
+                    {
+                        const float* plane = planes + i * inputSampleCount;
+                        for (size_t s = 0; s < inputSampleCount; ++s)
+                        {
+                            mixed[s] += plane[s] * level;
+                        }
+                    }
+                }
+            }
+        }
+        else
+        {
+            memcpy(m_Mixed.data(), planes, m_Mixed.size() * sizeof(float));
+        }
+
+        //  Resample
+        size_t outputSampleCount = inputSampleCount;
+        const float* outputPlanes = m_Mixed.data();
+        size_t planeStride = inputSampleCount;
+        if (m_Interpolation != m_Decimation)
+        {
+            planeStride = GetOutputSampleCount(inputSampleCount);
+            outputSampleCount = Resample(inputSampleCount, planeStride);
+            outputPlanes = m_Resampled.data();
+        }
+        outputSampleCount = std::min(outputSampleCount, maxOutputSampleCount);
+
+        //  Store in the output format
+        const bool planarOutput = IsPlanar(m_Output.format);
+        const bool floatOutput = IsFloat(m_Output.format);
+        if (planarOutput == true)
+        {
+            for (size_t channel = 0; channel < outputChannels; ++channel)
+            {
+                const float* plane = outputPlanes + channel * planeStride;
+                if (floatOutput == true)
+                {
+                    memcpy(static_cast<float*>(output) + channel * outputSampleCount, plane, outputSampleCount * sizeof(float));
+                }
+                else
+                {
+                    FloatToS16(plane, static_cast<int16_t*>(output) + channel * outputSampleCount, outputSampleCount);
+                }
+            }
+        }
+        else
+        {
+            float* interleaved = floatOutput == true ? static_cast<float*>(output) : nullptr;
+            if (interleaved == nullptr)
+            {
+                m_Deinterleaved.resize(outputSampleCount * outputChannels);
+                interleaved = m_Deinterleaved.data();
+            }
+            for (size_t channel = 0; channel < outputChannels; ++channel)
+            {
+                const float* plane = outputPlanes + channel * planeStride;
+                for (size_t i = 0; i < outputSampleCount; ++i)
+                {
+                    interleaved[i * outputChannels + channel] = plane[i];
+                }
+            }
+            if (floatOutput == false)
+            {
+                FloatToS16(interleaved, static_cast<int16_t*>(output), outputSampleCount * outputChannels);
+            }
+        }
+        return outputSampleCount;
+    }
+}
@@ -0,0 +1,112 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "amf/public/include/core/AudioBuffer.h"
+
+#include <vector>
+
+namespace ssdk::util
+{
+    //  PCMConverter: sample format, channel layout and sampling rate conversion of PCM audio for the common cases
+    //  (16-bit integer and 32-bit float samples, interleaved or planar, remixing between layouts, rational ratio resampling),
+    //  so that they can be done inline without the FFmpeg audio converter component.
+    //  Planar buffers hold the planes back to back, each sampleCount samples long, same as AMFAudioBuffer.
+    //  The converter is stateful when resampling and is not thread-safe.
+    class PCMConverter
+    {
+    public:
+        class Format
+        {
+        public:
+            amf::AMF_AUDIO_FORMAT   format = amf::AMFAF_UNKNOWN;
+            int32_t                 samplingRate = 0;
+            int32_t                 channels = 0;
+            int32_t                 layout = 0;         //  amf::AMF_AUDIO_CHANNEL_LAYOUT bit mask, channels are stored in the order of the bits
+        };
+
+        static constexpr size_t RESAMPLER_TAPS = 48;        //  Filter length per phase in input samples, a multiple of 8
+        static constexpr int32_t MAX_RESAMPLER_PHASES = 1024;
+
+    public:
+        PCMConverter() = default;
+
+        static bool IsSupported(const Format& input, const Format& output);
+
+        bool Init(const Format& input, const Format& output);
+        void Reset();   //  Drop the resampler history, call on discontinuity
+
+        inline const Format& GetInputFormat() const noexcept { return m_Input; }
+        inline const Format& GetOutputFormat() const noexcept { return m_Output; }
+
+        //  Exact number of samples per channel the next Convert() call will produce from inputSampleCount samples
+        size_t GetOutputSampleCount(size_t inputSampleCount) const noexcept;
+
+        //  Time of the first sample the next Convert() call will produce relative to the first sample of its input, in AMF units.
+        //  Negative when resampling: the filter is centered RESAMPLER_TAPS / 2 input samples back, add it to the input pts
+        amf_pts GetOutputPtsOffset() const noexcept;
+
+        //  Converts inputSampleCount samples per channel, returns the number of samples per channel written to output.
+        //  The input is always consumed, even when the output is too small to hold all of the converted samples
+        size_t Convert(const void* input, size_t inputSampleCount, void* output, size_t maxOutputSampleCount);
+
+    private:
+        void ComputeMixMatrix();
+        void BuildResampler();
+        size_t Resample(size_t inputSampleCount, size_t maxOutputSampleCount);
+
+    private:
+        Format                  m_Input;
+        Format                  m_Output;
+        bool                    m_Initialized = false;
+
+        //  Channel mixing, identity when the layouts match
+        bool                    m_Remix = false;
+        std::vector<float>      m_MixMatrix;            //  m_Output.channels rows of m_Input.channels coefficients
+
+        //  Polyphase resampler for rate m_Input.samplingRate * m_Interpolation / m_Decimation
+        int64_t                 m_Interpolation = 1;
+        int64_t                 m_Decimation = 1;
+        int64_t                 m_Position = 0;         //  Next output sample position in input samples * m_Interpolation relative to the history start
+        std::vector<float>      m_Coefficients;         //  m_Interpolation phases of RESAMPLER_TAPS coefficients in reverse order
+
+        //  Float planar working buffers
+        std::vector<float>      m_Deinterleaved;
+        std::vector<float>      m_Mixed;
+        std::vector<float>      m_History;              //  Per output channel: the last RESAMPLER_TAPS - 1 input samples
+        std::vector<float>      m_Window;               //  History followed by the current input of the channel being resampled
+        std::vector<float>      m_Resampled;
+    };
+}
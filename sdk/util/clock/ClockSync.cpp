@@ -0,0 +1,182 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "ClockSync.h"
+
+#include "amf/public/common/TraceAdapter.h"
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::util::ClockSync";
+
+namespace ssdk::util
+{
+    void ClockSync::AddSample(amf_pts originate, amf_pts receive, amf_pts transmit, amf_pts destination)
+    {
+        amf_pts delay = (destination - originate) - (transmit - receive);
+        if (destination < originate || transmit < receive || delay < 0)
+        {
+            AMFTraceDebug(AMF_FACILITY, L"AddSample(): inconsistent timestamps ignored");
+            return;
+        }
+        Sample sample;
+        sample.m_Local = originate + (destination - originate) / 2;
+        sample.m_Offset = ((receive - originate) + (transmit - destination)) / 2;
+        sample.m_Delay = delay;
+
+        amf::AMFLock lock(&m_Guard);
+        m_Filter.push_back(sample);
+        if (m_Filter.size() > FILTER_SIZE)
+        {
+            m_Filter.pop_front();
+        }
+        const Sample& best = *std::min_element(m_Filter.begin(), m_Filter.end(), [](const Sample& a, const Sample& b) { return a.m_Delay < b.m_Delay; });
+        if (m_History.empty() == false && best.m_Local <= m_History.back().m_Local)
+        {   //  The best sample has already been used
+            return;
+        }
+        if (m_Synchronized == true)
+        {
+            double predicted = m_Offset + m_Skew * double(best.m_Local - m_Reference);
+            if (std::abs(double(best.m_Offset) - predicted) > double(STEP_THRESHOLD))
+            {
+                AMFTraceWarning(AMF_FACILITY, L"Remote clock stepped by %5.2f ms, restarting synchronization", (double(best.m_Offset) - predicted) / AMF_MILLISECOND);
+                m_History.clear();
+                Sample last = m_Filter.back();
+                m_Filter.clear();
+                m_Filter.push_back(last);
+                m_History.push_back(last);
+                UpdateModel();
+                return;
+            }
+        }
+        m_History.push_back(best);
+        if (m_History.size() > HISTORY_SIZE)
+        {
+            m_History.pop_front();
+        }
+        UpdateModel();
+    }
+
+    void ClockSync::UpdateModel()
+    {
+        const Sample& latest = m_History.back();
+        m_Reference = latest.m_Local;
+        m_Offset = double(latest.m_Offset);
+        m_Skew = 0;
+        amf_pts span = latest.m_Local - m_History.front().m_Local;
+        if (span >= MIN_DRIFT_SPAN && m_History.size() >= 3)
+        {   //  Least squares fit of the offset against local time, relative to the latest sample to keep the precision
+            double n = double(m_History.size());
+            double sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+            for (const Sample& sample : m_History)
+            {
+                double x = double(sample.m_Local - m_Reference);
+                double y = double(sample.m_Offset - latest.m_Offset);
+                sumX += x;
+                sumY += y;
+                sumXX += x * x;
+                sumXY += x * y;
+            }
+            double denominator = n * sumXX - sumX * sumX;
+            if (denominator > 0)
+            {
+                m_Skew = std::min(std::max((n * sumXY - sumX * sumY) / denominator, -MAX_SKEW), MAX_SKEW);
+                m_Offset = double(latest.m_Offset) + (sumY - m_Skew * sumX) / n;
+            }
+        }
+        m_Synchronized = true;
+    }
+
+    void ClockSync::Reset()
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_Filter.clear();
+        m_History.clear();
+        m_Reference = 0;
+        m_Offset = 0;
+        m_Skew = 0;
+        m_Synchronized = false;
+    }
+
+    bool ClockSync::IsSynchronized() const noexcept
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_Synchronized;
+    }
+
+    amf_pts ClockSync::RemoteToLocal(amf_pts remote) const noexcept
+    {
+        amf::AMFLock lock(&m_Guard);
+        //  remote = local + m_Offset + m_Skew * (local - m_Reference), solved for local
+        double sinceReference = (double(remote - m_Reference) - m_Offset) / (1.0 + m_Skew);
+        return m_Reference + amf_pts(std::llround(sinceReference));
+    }
+
+    amf_pts ClockSync::LocalToRemote(amf_pts local) const noexcept
+    {
+        amf::AMFLock lock(&m_Guard);
+        return local + amf_pts(std::llround(m_Offset + m_Skew * double(local - m_Reference)));
+    }
+
+    amf_pts ClockSync::GetOffset() const noexcept
+    {
+        amf_pts now = amf_high_precision_clock();
+        return LocalToRemote(now) - now;
+    }
+
+    double ClockSync::GetSkewPpm() const noexcept
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_Skew * 1e6;
+    }
+
+    amf_pts ClockSync::GetRoundTripTime() const noexcept
+    {
+        amf::AMFLock lock(&m_Guard);
+        amf_pts roundTrip = 0;
+        if (m_Filter.empty() == false)
+        {
+            roundTrip = std::min_element(m_Filter.begin(), m_Filter.end(), [](const Sample& a, const Sample& b) { return a.m_Delay < b.m_Delay; })->m_Delay;
+        }
+        return roundTrip;
+    }
+
+    amf_pts ClockSync::GetRequestInterval() const noexcept
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_History.size() < FILTER_SIZE ? FAST_REQUEST_INTERVAL : REQUEST_INTERVAL;
+    }
+}
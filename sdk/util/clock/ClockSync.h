@@ -0,0 +1,102 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "amf/public/include/core/Platform.h"
+#include "amf/public/common/Thread.h"
+
+#include <deque>
+#include <memory>
+
+namespace ssdk::util
+{
+    //  ClockSync: NTP-style estimate of a remote clock relative to the local amf_high_precision_clock().
+    //  Each exchange yields four timestamps: request sent (local), request received and response sent (remote),
+    //  response received (local). The sample with the smallest round trip out of the last FILTER_SIZE is taken
+    //  as the least affected by queueing, and the offsets of these samples are fitted with a line to track the drift
+    //  between the two clocks. Asymmetric path delay cannot be observed from the exchange and biases the offset by half
+    //  the difference between the forward and the return delay.
+    class ClockSync
+    {
+    public:
+        typedef std::shared_ptr<ClockSync>  Ptr;
+
+        static constexpr const size_t FILTER_SIZE = 8;                              //  Exchanges the minimum round trip is picked from
+        static constexpr const size_t HISTORY_SIZE = 64;                            //  Filtered samples used for the drift estimate
+        static constexpr const amf_pts MIN_DRIFT_SPAN = 10 * AMF_SECOND;            //  Drift is assumed to be zero until the history spans this long
+        static constexpr const double MAX_SKEW = 500e-6;                            //  500ppm, the tolerance NTP assumes for a clock
+        static constexpr const amf_pts STEP_THRESHOLD = 128 * AMF_MILLISECOND;      //  An offset change larger than this is treated as a clock step
+        static constexpr const amf_pts FAST_REQUEST_INTERVAL = 100 * AMF_MILLISECOND;
+        static constexpr const amf_pts REQUEST_INTERVAL = AMF_SECOND;
+
+    public:
+        ClockSync() = default;
+
+        //  originate and destination are local times, receive and transmit are remote times
+        void AddSample(amf_pts originate, amf_pts receive, amf_pts transmit, amf_pts destination);
+        void Reset();
+
+        bool IsSynchronized() const noexcept;
+        amf_pts RemoteToLocal(amf_pts remote) const noexcept;
+        amf_pts LocalToRemote(amf_pts local) const noexcept;
+
+        amf_pts GetOffset() const noexcept;             //  Remote minus local time, now
+        double GetSkewPpm() const noexcept;             //  Positive when the remote clock runs faster than the local one
+        amf_pts GetRoundTripTime() const noexcept;      //  Smallest round trip in the current filter window, network only
+        amf_pts GetRequestInterval() const noexcept;    //  Exchanges are sent more often until the estimate settles
+
+    private:
+        class Sample
+        {
+        public:
+            amf_pts m_Local = 0;        //  Midpoint between sending the request and receiving the response
+            amf_pts m_Offset = 0;
+            amf_pts m_Delay = 0;
+        };
+
+        void UpdateModel();
+
+    private:
+        mutable amf::AMFCriticalSection m_Guard;
+        std::deque<Sample>  m_Filter;
+        std::deque<Sample>  m_History;
+
+        //  offset(local) = m_Offset + m_Skew * (local - m_Reference)
+        amf_pts             m_Reference = 0;
+        double              m_Offset = 0;
+        double              m_Skew = 0;
+        bool                m_Synchronized = false;
+    };
+}
@@ -0,0 +1,383 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "BufferPool.h"
+
+#include <bit>
+#include <cstring>
+#include <memory>
+
+namespace ssdk::util
+{
+    static constexpr size_t MIN_BLOCK_SHIFT = 8;                //  log2(MIN_BLOCK_SIZE)
+    static constexpr size_t STEPS_PER_GROUP = 4;                //  Classes per power of two, rounding wastes at most 25%
+
+    static_assert(BufferPool::MIN_BLOCK_SIZE == size_t(1) << MIN_BLOCK_SHIFT, "MIN_BLOCK_SHIFT does not match MIN_BLOCK_SIZE");
+
+    //  Set once the calling thread's cache has been destroyed on thread exit, releases after that go straight to the shared lists
+    static thread_local bool t_ThreadCacheGone = false;
+
+    class BufferPool::Block
+    {
+    public:
+        Block(BufferPool* pPool, size_t sizeClass, size_t capacity) :
+            m_pPool(pPool),
+            m_Class(sizeClass),
+            m_Capacity(capacity),
+            m_Data(new uint8_t[capacity])
+        {
+        }
+
+        BufferPool* const           m_pPool;
+        const size_t                m_Class;
+        const size_t                m_Capacity;
+        size_t                      m_Size = 0;
+        std::atomic<uint32_t>       m_RefCount{ 0 };
+        Block*                      m_pNext = nullptr;      //  Free list link
+        std::unique_ptr<uint8_t[]>  m_Data;
+    };
+
+    //-------------------------------------------------------------------------------------------------
+    BufferPool::Lease::Lease(const Lease& other) noexcept :
+        m_pBlock(other.m_pBlock)
+    {
+        if (m_pBlock != nullptr)
+        {
+            m_pBlock->m_RefCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    BufferPool::Lease::Lease(Lease&& other) noexcept :
+        m_pBlock(other.m_pBlock)
+    {
+        other.m_pBlock = nullptr;
+    }
+
+    BufferPool::Lease::~Lease()
+    {
+        Reset();
+    }
+
+    BufferPool::Lease& BufferPool::Lease::operator=(const Lease& other) noexcept
+    {
+        if (other.m_pBlock != nullptr)
+        {
+            other.m_pBlock->m_RefCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        Reset();
+        m_pBlock = other.m_pBlock;
+        return *this;
+    }
+
+    BufferPool::Lease& BufferPool::Lease::operator=(Lease&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_pBlock = other.m_pBlock;
+            other.m_pBlock = nullptr;
+        }
+        return *this;
+    }
+
+    uint8_t* BufferPool::Lease::GetData() const noexcept
+    {
+        return m_pBlock != nullptr ? m_pBlock->m_Data.get() : nullptr;
+    }
+
+    size_t BufferPool::Lease::GetSize() const noexcept
+    {
+        return m_pBlock != nullptr ? m_pBlock->m_Size : 0;
+    }
+
+    size_t BufferPool::Lease::GetCapacity() const noexcept
+    {
+        return m_pBlock != nullptr ? m_pBlock->m_Capacity : 0;
+    }
+
+    bool BufferPool::Lease::SetSize(size_t size) noexcept
+    {
+        bool result = false;
+        if (m_pBlock != nullptr && size <= m_pBlock->m_Capacity)
+        {
+            m_pBlock->m_Size = size;
+            result = true;
+        }
+        return result;
+    }
+
+    void BufferPool::Lease::Reset() noexcept
+    {
+        if (m_pBlock != nullptr && m_pBlock->m_RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            m_pBlock->m_pPool->Release(m_pBlock);
+        }
+        m_pBlock = nullptr;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+    BufferPool::ThreadCache::~ThreadCache()
+    {
+        t_ThreadCacheGone = true;
+        for (size_t sizeClass = 0; sizeClass < CLASS_COUNT; ++sizeClass)
+        {
+            for (size_t i = 0; i < m_Counts[sizeClass]; ++i)
+            {
+                m_Blocks[sizeClass][i]->m_pPool->ReleaseShared(m_Blocks[sizeClass][i]);
+            }
+            m_Counts[sizeClass] = 0;
+        }
+        m_Bytes = 0;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+    BufferPool& BufferPool::GetInstance()
+    {
+        static BufferPool s_Instance;
+        return s_Instance;
+    }
+
+    BufferPool::BufferPool()
+    {
+        MetricsRegistry& registry = MetricsRegistry::GetInstance();
+        m_Acquired = registry.GetCounter("ssdk_buffer_pool_acquired", "Buffers leased from the send buffer pool");
+        m_ThreadCacheHits = registry.GetCounter("ssdk_buffer_pool_hits", "Leases served from a released block", { { "cache", "thread" } });
+        m_SharedHits = registry.GetCounter("ssdk_buffer_pool_hits", "Leases served from a released block", { { "cache", "shared" } });
+        m_Allocations = registry.GetCounter("ssdk_buffer_pool_allocations", "Blocks allocated because no released block of the size class was available");
+        m_Discarded = registry.GetCounter("ssdk_buffer_pool_discarded", "Released blocks freed because the pool was full");
+        m_PooledBytesGauge = registry.GetGauge("ssdk_buffer_pool_pooled_bytes", "Memory held in the shared free lists");
+    }
+
+    BufferPool::~BufferPool()
+    {
+        for (size_t sizeClass = 0; sizeClass < CLASS_COUNT; ++sizeClass)
+        {
+            while (m_FreeLists[sizeClass] != nullptr)
+            {
+                Block* pBlock = m_FreeLists[sizeClass];
+                m_FreeLists[sizeClass] = pBlock->m_pNext;
+                delete pBlock;
+            }
+        }
+    }
+
+    size_t BufferPool::GetClass(size_t size) noexcept
+    {
+        size_t result = 0;
+        if (size > MIN_BLOCK_SIZE)
+        {
+            size_t last = size - 1;
+            size_t group = size_t(std::bit_width(last)) - MIN_BLOCK_SHIFT - 1;     //  (256, 512] is group 0, (512, 1024] group 1...
+            size_t step = (last - (MIN_BLOCK_SIZE << group)) / ((MIN_BLOCK_SIZE / STEPS_PER_GROUP) << group);
+            result = 1 + group * STEPS_PER_GROUP + step;
+        }
+        return result;
+    }
+
+    size_t BufferPool::GetClassSize(size_t sizeClass) noexcept
+    {
+        size_t result = MIN_BLOCK_SIZE;
+        if (sizeClass > 0)
+        {
+            size_t group = (sizeClass - 1) / STEPS_PER_GROUP;
+            size_t step = (sizeClass - 1) % STEPS_PER_GROUP;
+            result = (MIN_BLOCK_SIZE << group) + (step + 1) * ((MIN_BLOCK_SIZE / STEPS_PER_GROUP) << group);
+        }
+        return result;
+    }
+
+    size_t BufferPool::GetBlockSize(size_t size) noexcept
+    {
+        return size > MAX_BLOCK_SIZE ? size : GetClassSize(GetClass(size));
+    }
+
+    BufferPool::ThreadCache* BufferPool::GetThreadCache() noexcept
+    {
+        if (t_ThreadCacheGone == true)
+        {
+            return nullptr;
+        }
+        static thread_local ThreadCache s_Cache;
+        return &s_Cache;
+    }
+
+    BufferPool::Lease BufferPool::Acquire(size_t size)
+    {
+        m_Acquired->Increment();
+        Block* pBlock = nullptr;
+        if (size > MAX_BLOCK_SIZE)
+        {   //  Too rare to be worth keeping around
+            pBlock = new Block(this, OVERSIZED, size);
+            m_Allocations->Increment();
+        }
+        else
+        {
+            size_t sizeClass = GetClass(size);
+            ThreadCache* pCache = GetThreadCache();
+            if (pCache != nullptr && pCache->m_Counts[sizeClass] > 0)
+            {
+                pBlock = pCache->m_Blocks[sizeClass][--pCache->m_Counts[sizeClass]];
+                pCache->m_Bytes -= pBlock->m_Capacity;
+                m_ThreadCacheHits->Increment();
+            }
+            else
+            {
+                {
+                    amf::AMFLock lock(&m_Guard);
+                    pBlock = m_FreeLists[sizeClass];
+                    if (pBlock != nullptr)
+                    {
+                        m_FreeLists[sizeClass] = pBlock->m_pNext;
+                        m_PooledBytes -= pBlock->m_Capacity;
+                        m_PooledBytesGauge->Set(double(m_PooledBytes));
+                    }
+                }
+                if (pBlock != nullptr)
+                {
+                    pBlock->m_pNext = nullptr;
+                    m_SharedHits->Increment();
+                }
+                else
+                {
+                    pBlock = new Block(this, sizeClass, GetClassSize(sizeClass));
+                    m_Allocations->Increment();
+                }
+            }
+        }
+        pBlock->m_Size = size;
+        pBlock->m_RefCount.store(1, std::memory_order_relaxed);
+        return Lease(pBlock);
+    }
+
+    BufferPool::Lease BufferPool::Acquire(const void* data, size_t size)
+    {
+        Lease lease = Acquire(size);
+        if (data != nullptr && size > 0)
+        {
+            memcpy(lease.GetData(), data, size);
+        }
+        return lease;
+    }
+
+    void BufferPool::Release(Block* pBlock) noexcept
+    {
+        if (pBlock->m_Class == OVERSIZED)
+        {
+            delete pBlock;
+            return;
+        }
+        ThreadCache* pCache = GetThreadCache();
+        if (pCache != nullptr && pCache->m_Counts[pBlock->m_Class] < THREAD_CACHE_DEPTH && pCache->m_Bytes + pBlock->m_Capacity <= THREAD_CACHE_BYTES)
+        {
+            pCache->m_Blocks[pBlock->m_Class][pCache->m_Counts[pBlock->m_Class]++] = pBlock;
+            pCache->m_Bytes += pBlock->m_Capacity;
+        }
+        else
+        {
+            ReleaseShared(pBlock);
+        }
+    }
+
+    void BufferPool::ReleaseShared(Block* pBlock) noexcept
+    {
+        bool pooled = false;
+        {
+            amf::AMFLock lock(&m_Guard);
+            if (m_PooledBytes + pBlock->m_Capacity <= MAX_POOLED_BYTES)
+            {
+                pBlock->m_pNext = m_FreeLists[pBlock->m_Class];
+                m_FreeLists[pBlock->m_Class] = pBlock;
+                m_PooledBytes += pBlock->m_Capacity;
+                m_PooledBytesGauge->Set(double(m_PooledBytes));
+                pooled = true;
+            }
+        }
+        if (pooled == false)
+        {
+            m_Discarded->Increment();
+            delete pBlock;
+        }
+    }
+
+    BufferPool::Stats BufferPool::GetStats() const
+    {
+        Stats stats;
+        stats.acquired = m_Acquired->Get();
+        stats.threadCacheHits = m_ThreadCacheHits->Get();
+        stats.sharedHits = m_SharedHits->Get();
+        stats.allocations = m_Allocations->Get();
+        stats.discarded = m_Discarded->Get();
+        {
+            amf::AMFLock lock(&m_Guard);
+            stats.pooledBytes = m_PooledBytes;
+        }
+        return stats;
+    }
+
+    void BufferPool::Trim()
+    {
+        ThreadCache* pCache = GetThreadCache();
+        Block* blocks[CLASS_COUNT] = {};
+        {
+            amf::AMFLock lock(&m_Guard);
+            for (size_t sizeClass = 0; sizeClass < CLASS_COUNT; ++sizeClass)
+            {
+                blocks[sizeClass] = m_FreeLists[sizeClass];
+                m_FreeLists[sizeClass] = nullptr;
+            }
+            m_PooledBytes = 0;
+            m_PooledBytesGauge->Set(0);
+        }
+        for (size_t sizeClass = 0; sizeClass < CLASS_COUNT; ++sizeClass)
+        {
+            while (blocks[sizeClass] != nullptr)
+            {
+                Block* pBlock = blocks[sizeClass];
+                blocks[sizeClass] = pBlock->m_pNext;
+                delete pBlock;
+            }
+            if (pCache != nullptr)
+            {
+                for (size_t i = 0; i < pCache->m_Counts[sizeClass]; ++i)
+                {
+                    delete pCache->m_Blocks[sizeClass][i];
+                }
+                pCache->m_Counts[sizeClass] = 0;
+            }
+        }
+        if (pCache != nullptr)
+        {
+            pCache->m_Bytes = 0;
+        }
+    }
+}
@@ -0,0 +1,150 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "util/metrics/MetricsRegistry.h"
+#include "amf/public/common/Thread.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace ssdk::util
+{
+    //  BufferPool: process-wide pool of host memory blocks for outbound messages, so that sending a frame does not allocate.
+    //  Requests are rounded up to a size class, four classes per power of two from MIN_BLOCK_SIZE to MAX_BLOCK_SIZE, larger
+    //  requests bypass the pool. Each thread keeps a few released blocks of every class for itself, the rest go to the shared
+    //  free lists, which are capped at MAX_POOLED_BYTES. A Lease is a reference-counted handle to a block: copies share the same
+    //  memory, which returns to the pool when the last copy is gone, e.g. once every send queue holding a message has sent it.
+    class BufferPool
+    {
+    private:
+        class Block;
+
+    public:
+        static constexpr size_t MIN_BLOCK_SIZE = 256;
+        static constexpr size_t MAX_BLOCK_SIZE = size_t(8) * 1024 * 1024;
+        static constexpr size_t MAX_POOLED_BYTES = size_t(128) * 1024 * 1024;   //  Shared free lists
+        static constexpr size_t THREAD_CACHE_DEPTH = 4;                         //  Blocks per class cached by each thread
+        static constexpr size_t THREAD_CACHE_BYTES = size_t(16) * 1024 * 1024;
+
+        class Lease
+        {
+        public:
+            Lease() noexcept = default;
+            Lease(const Lease& other) noexcept;
+            Lease(Lease&& other) noexcept;
+            ~Lease();
+
+            Lease& operator=(const Lease& other) noexcept;
+            Lease& operator=(Lease&& other) noexcept;
+
+            uint8_t* GetData() const noexcept;
+            size_t GetSize() const noexcept;
+            size_t GetCapacity() const noexcept;
+            bool SetSize(size_t size) noexcept;             //  Within the capacity only, the contents are preserved
+            inline bool IsValid() const noexcept { return m_pBlock != nullptr; }
+
+            void Reset() noexcept;
+
+        private:
+            friend class BufferPool;
+            explicit Lease(Block* pBlock) noexcept : m_pBlock(pBlock) {}
+
+            Block*  m_pBlock = nullptr;
+        };
+
+        class Stats
+        {
+        public:
+            uint64_t    acquired = 0;
+            uint64_t    threadCacheHits = 0;
+            uint64_t    sharedHits = 0;
+            uint64_t    allocations = 0;                    //  Pool misses and oversized requests
+            uint64_t    discarded = 0;                      //  Blocks freed on release because the pool was full
+            size_t      pooledBytes = 0;                    //  Idle in the shared free lists
+
+            inline double GetHitRate() const noexcept { return acquired > 0 ? double(threadCacheHits + sharedHits) / acquired : 0; }
+        };
+
+    public:
+        static BufferPool& GetInstance();
+
+        Lease Acquire(size_t size);                         //  Uninitialized contents, GetSize() == size
+        Lease Acquire(const void* data, size_t size);       //  A pooled copy of data
+
+        Stats GetStats() const;
+        void Trim();                                        //  Frees the shared free lists and the calling thread's cache
+
+        static size_t GetBlockSize(size_t size) noexcept;   //  The capacity a request for size gets
+
+    private:
+        BufferPool();
+        ~BufferPool();
+        BufferPool(const BufferPool&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+
+        static constexpr size_t CLASS_COUNT = 61;           //  256 bytes, then 4 classes for each power of two up to MAX_BLOCK_SIZE
+        static constexpr size_t OVERSIZED = CLASS_COUNT;
+
+        static size_t GetClass(size_t size) noexcept;
+        static size_t GetClassSize(size_t sizeClass) noexcept;
+
+        class ThreadCache
+        {
+        public:
+            ~ThreadCache();
+
+            Block*  m_Blocks[CLASS_COUNT][THREAD_CACHE_DEPTH] = {};
+            size_t  m_Counts[CLASS_COUNT] = {};
+            size_t  m_Bytes = 0;
+        };
+        static ThreadCache* GetThreadCache() noexcept;  //  nullptr once destroyed on thread exit
+
+        void Release(Block* pBlock) noexcept;
+        void ReleaseShared(Block* pBlock) noexcept;
+
+    private:
+        mutable amf::AMFCriticalSection     m_Guard;
+        Block*                              m_FreeLists[CLASS_COUNT] = {};
+        size_t                              m_PooledBytes = 0;
+
+        MetricsRegistry::Counter::Ptr       m_Acquired;
+        MetricsRegistry::Counter::Ptr       m_ThreadCacheHits;
+        MetricsRegistry::Counter::Ptr       m_SharedHits;
+        MetricsRegistry::Counter::Ptr       m_Allocations;
+        MetricsRegistry::Counter::Ptr       m_Discarded;
+        MetricsRegistry::Gauge::Ptr         m_PooledBytesGauge;
+    };
+}
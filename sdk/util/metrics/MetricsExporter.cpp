@@ -0,0 +1,180 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "MetricsExporter.h"
+#include "net/Selector.h"
+#include "net/Url.h"
+#if defined(__linux)
+#include "net/UnixStreamSocket.h"
+#endif
+
+#include "amf/public/common/TraceAdapter.h"
+
+#include <sstream>
+
+namespace ssdk::util
+{
+    static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::util::MetricsExporter";
+    static constexpr const size_t MAX_REQUEST_SIZE = 4096;
+    static constexpr const int REQUEST_TIMEOUT = 2;            //  Seconds
+
+    MetricsExporter::MetricsExporter() :
+        m_ServiceThread(*this)
+    {
+    }
+
+    MetricsExporter::~MetricsExporter()
+    {
+        Terminate();
+    }
+
+    bool MetricsExporter::Init(const std::string& url)
+    {
+        net::Url parsedUrl;
+        if (parsedUrl.Init(url, "tcp", DEFAULT_PORT) != net::Url::Result::OK)
+        {
+            AMFTraceError(AMF_FACILITY, L"Invalid metrics endpoint URL %S", url.c_str());
+            return false;
+        }
+
+        net::StreamSocket::Ptr socket;
+        net::Socket::Result result = net::Socket::Result::OK;
+#if defined(__linux)
+        if (parsedUrl.IsLocal() == true)
+        {
+            socket = new net::UnixStreamSocket;
+            const std::string& name = parsedUrl.GetHost();
+            //  Same naming as the local transport: names not starting with '/' live in the abstract namespace
+            result = socket->Bind(net::Socket::UnixDomainAddress(name.empty() == false && name[0] == '/' ? name : ':' + name));
+        }
+        else
+#endif
+        {
+            socket = new net::StreamSocket;
+            int yes = 1;
+            socket->SetSocketOpt(SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+            result = socket->Bind(parsedUrl);
+        }
+        if (result != net::Socket::Result::OK || socket->Listen(8) != net::Socket::Result::OK)
+        {
+            AMFTraceError(AMF_FACILITY, L"Failed to listen for metrics scrapes on %S", parsedUrl.GetUrl().c_str());
+            return false;
+        }
+        m_ListeningSocket = socket;
+        m_ServiceThread.Start();
+        AMFTraceInfo(AMF_FACILITY, L"Serving metrics on %S", parsedUrl.GetUrl().c_str());
+        return true;
+    }
+
+    void MetricsExporter::Terminate()
+    {
+        m_ServiceThread.RequestStop();
+        m_ServiceThread.WaitForStop();
+        m_ListeningSocket = nullptr;
+    }
+
+    void MetricsExporter::ServeConnection(net::StreamSocket* connection)
+    {
+        connection->SetTimeout(REQUEST_TIMEOUT);
+
+        //  Only the request line matters, the headers are read to the blank line and ignored
+        std::string request;
+        char buffer[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.find("\n\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE)
+        {
+            size_t received = 0;
+            if (connection->Receive(buffer, sizeof(buffer), &received) != net::Socket::Result::OK || received == 0)
+            {
+                return;
+            }
+            request.append(buffer, received);
+        }
+
+        std::istringstream requestLine(request.substr(0, request.find_first_of("\r\n")));
+        std::string method, target;
+        requestLine >> method >> target;
+        std::string path = target.substr(0, target.find('?'));
+
+        std::string status;
+        std::string contentType = "text/plain; charset=utf-8";
+        std::string body;
+        if (method != "GET" && method != "HEAD")
+        {
+            status = "405 Method Not Allowed";
+            body = "Only GET is supported\n";
+        }
+        else if (path != "/metrics" && path != "/")
+        {
+            status = "404 Not Found";
+            body = "Metrics are served on /metrics\n";
+        }
+        else
+        {
+            status = "200 OK";
+            contentType = CONTENT_TYPE;
+            body = MetricsRegistry::GetInstance().Export();
+        }
+
+        std::ostringstream response;
+        response << "HTTP/1.0 " << status << "\r\n"
+                 << "Content-Type: " << contentType << "\r\n"
+                 << "Content-Length: " << body.size() << "\r\n"
+                 << "Connection: close\r\n\r\n";
+        if (method != "HEAD")
+        {
+            response << body;
+        }
+        std::string data = response.str();
+        connection->SendAll(data.data(), data.size());
+    }
+
+    void MetricsExporter::ServiceThread::Run()
+    {
+        net::Selector selector;
+        selector.AddReadableSocket(m_Exporter.m_ListeningSocket);
+        while (StopRequested() == false)
+        {
+            struct timeval timeout {};
+            timeout.tv_usec = 200000;   //  Bounds the time Terminate() waits for the thread
+            net::Socket::Set readable;
+            if (selector.WaitToRead(timeout, readable) == net::Selector::Result::OK && readable.empty() == false)
+            {
+                net::StreamSocket::Ptr connection;
+                if (m_Exporter.m_ListeningSocket->Accept(&connection) == net::Socket::Result::OK)
+                {
+                    m_Exporter.ServeConnection(connection);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "MetricsRegistry.h"
+#include "net/StreamSocket.h"
+
+#include "amf/public/common/Thread.h"
+
+#include <string>
+
+namespace ssdk::util
+{
+    //  MetricsExporter: a minimal HTTP/1.0 endpoint serving MetricsRegistry in the OpenMetrics text format on GET /metrics.
+    //  Listens on tcp://<host>:<port> or, on Linux, on local://<name> (a Unix domain socket, see net::Url). Connections are
+    //  served one at a time on the exporter's own thread and closed after every response, which is all a scraper needs.
+    //  Bind to a loopback address unless the metrics are meant to be reachable from other hosts: the endpoint has no authentication.
+    class MetricsExporter
+    {
+    public:
+        static constexpr const unsigned short DEFAULT_PORT = 9464;
+        static constexpr const char* const CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+    public:
+        MetricsExporter();
+        ~MetricsExporter();
+
+        bool Init(const std::string& url);
+        void Terminate();
+
+    protected:
+        void ServeConnection(net::StreamSocket* connection);
+
+        class ServiceThread : public amf::AMFThread
+        {
+        public:
+            ServiceThread(MetricsExporter& exporter) : m_Exporter(exporter) {}
+
+        protected:
+            virtual void Run() override;
+
+        private:
+            MetricsExporter& m_Exporter;
+        };
+        friend class ServiceThread;
+
+    private:
+        MetricsExporter(const MetricsExporter&) = delete;
+        MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    private:
+        net::StreamSocket::Ptr  m_ListeningSocket;
+        ServiceThread           m_ServiceThread;
+    };
+}
@@ -0,0 +1,306 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#include "MetricsRegistry.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <sstream>
+
+namespace ssdk::util
+{
+    static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::util::MetricsRegistry";
+
+    const std::vector<double> MetricsRegistry::LATENCY_BUCKETS = { 0.0005, 0.001, 0.002, 0.004, 0.008, 0.016, 0.033, 0.066, 0.1, 0.25, 0.5, 1.0 };
+
+    //-------------------------------------------------------------------------------------------------
+    MetricsRegistry::Histogram::Histogram(const std::vector<double>& bounds) :
+        m_Bounds(bounds),
+        m_Buckets(new std::atomic<uint64_t>[bounds.size() + 1]())
+    {
+    }
+
+    void MetricsRegistry::Histogram::Observe(double value) noexcept
+    {
+        //  Bucket lists are short, a linear scan beats a binary search here
+        size_t index = 0;
+        while (index < m_Bounds.size() && value > m_Bounds[index])
+        {
+            ++index;
+        }
+        m_Buckets[index].fetch_add(1, std::memory_order_relaxed);
+        m_Sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    //-------------------------------------------------------------------------------------------------
+    MetricsRegistry& MetricsRegistry::GetInstance()
+    {
+        static MetricsRegistry s_Instance;
+        return s_Instance;
+    }
+
+    MetricsRegistry::Entry* MetricsRegistry::FindEntry(const std::string& name, Type type, const std::string& help, const Labels& labels)
+    {
+        Entry* result = nullptr;
+        std::map<std::string, Family>::iterator it = m_Families.find(name);
+        if (it == m_Families.end())
+        {
+            it = m_Families.emplace(name, Family()).first;
+            it->second.m_Type = type;
+            it->second.m_Help = help;
+        }
+        if (it->second.m_Type != type)
+        {
+            AMFTraceError(AMF_FACILITY, L"Metric %S is already registered with a different type, the new one is not exported", name.c_str());
+        }
+        else
+        {
+            std::vector<Entry>& entries = it->second.m_Entries;
+            entries.erase(std::remove_if(entries.begin(), entries.end(), [&labels](const Entry& entry)
+                {
+                    return entry.IsReleased() == true && entry.m_Labels != labels;
+                }), entries.end());
+            std::vector<Entry>::iterator entry = std::find_if(entries.begin(), entries.end(), [&labels](const Entry& entry) { return entry.m_Labels == labels; });
+            if (entry == entries.end())
+            {
+                entry = entries.emplace(entries.end());
+                entry->m_Labels = labels;
+            }
+            result = &(*entry);
+        }
+        return result;
+    }
+
+    MetricsRegistry::Counter::Ptr MetricsRegistry::GetCounter(const std::string& name, const std::string& help, const Labels& labels, double scale)
+    {
+        amf::AMFLock lock(&m_Guard);
+        Entry* entry = FindEntry(name, Type::COUNTER, help, labels);
+        Counter::Ptr counter = entry != nullptr ? entry->m_Counter.lock() : nullptr;
+        if (counter == nullptr)
+        {
+            counter = std::make_shared<Counter>(scale);
+            if (entry != nullptr)
+            {
+                entry->m_Counter = counter;
+            }
+        }
+        return counter;
+    }
+
+    MetricsRegistry::Gauge::Ptr MetricsRegistry::GetGauge(const std::string& name, const std::string& help, const Labels& labels)
+    {
+        amf::AMFLock lock(&m_Guard);
+        Entry* entry = FindEntry(name, Type::GAUGE, help, labels);
+        Gauge::Ptr gauge = entry != nullptr ? entry->m_Gauge.lock() : nullptr;
+        if (gauge == nullptr)
+        {
+            gauge = std::make_shared<Gauge>();
+            if (entry != nullptr)
+            {
+                entry->m_Gauge = gauge;
+            }
+        }
+        return gauge;
+    }
+
+    MetricsRegistry::Histogram::Ptr MetricsRegistry::GetHistogram(const std::string& name, const std::string& help, const std::vector<double>& bounds, const Labels& labels)
+    {
+        amf::AMFLock lock(&m_Guard);
+        Entry* entry = FindEntry(name, Type::HISTOGRAM, help, labels);
+        Histogram::Ptr histogram = entry != nullptr ? entry->m_Histogram.lock() : nullptr;
+        if (histogram == nullptr)
+        {
+            histogram = std::make_shared<Histogram>(bounds);
+            if (entry != nullptr)
+            {
+                entry->m_Histogram = histogram;
+            }
+        }
+        return histogram;
+    }
+
+    size_t MetricsRegistry::GetSeriesCount()
+    {
+        amf::AMFLock lock(&m_Guard);
+        size_t count = 0;
+        for (const std::pair<const std::string, Family>& family : m_Families)
+        {
+            count += family.second.m_Entries.size();
+        }
+        return count;
+    }
+
+    //-------------------------------------------------------------------------------------------------
+    static void WriteEscaped(std::ostringstream& out, const std::string& text, bool escapeQuotes)
+    {
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '\\':
+                out << "\\\\";
+                break;
+            case '\n':
+                out << "\\n";
+                break;
+            case '"':
+                out << (escapeQuotes == true ? "\\\"" : "\"");
+                break;
+            default:
+                out << c;
+                break;
+            }
+        }
+    }
+
+    static void WriteLabels(std::ostringstream& out, const MetricsRegistry::Labels& labels, const char* extraName = nullptr, const std::string& extraValue = std::string())
+    {
+        if (labels.empty() == false || extraName != nullptr)
+        {
+            out << '{';
+            bool first = true;
+            for (const std::pair<std::string, std::string>& label : labels)
+            {
+                out << (first == true ? "" : ",") << label.first << "=\"";
+                WriteEscaped(out, label.second, true);
+                out << '"';
+                first = false;
+            }
+            if (extraName != nullptr)
+            {
+                out << (first == true ? "" : ",") << extraName << "=\"" << extraValue << '"';
+            }
+            out << '}';
+        }
+    }
+
+    //  Shortest representation which reads back to the same double, so 0.001 is not written as 0.0010000000000000000208
+    static std::string FormatValue(double value)
+    {
+        if (std::isnan(value) == true)
+        {
+            return "NaN";
+        }
+        else if (std::isinf(value) == true)
+        {
+            return value > 0 ? "+Inf" : "-Inf";
+        }
+        char buffer[32];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        return std::string(buffer, result.ptr);
+    }
+
+    std::string MetricsRegistry::Export()
+    {
+        std::ostringstream out;
+
+        amf::AMFLock lock(&m_Guard);
+        for (std::map<std::string, Family>::iterator itFamily = m_Families.begin(); itFamily != m_Families.end();)
+        {
+            const std::string& name = itFamily->first;
+            Family& family = itFamily->second;
+            //  Drop the metrics nobody owns any more before writing the family out
+            family.m_Entries.erase(std::remove_if(family.m_Entries.begin(), family.m_Entries.end(), [](const Entry& entry) { return entry.IsReleased(); }),
+                family.m_Entries.end());
+            if (family.m_Entries.empty() == true)
+            {
+                itFamily = m_Families.erase(itFamily);
+                continue;
+            }
+
+            static constexpr const char* TYPE_NAMES[] = { "counter", "gauge", "histogram" };
+            out << "# TYPE " << name << ' ' << TYPE_NAMES[static_cast<int>(family.m_Type)] << '\n';
+            out << "# HELP " << name << ' ';
+            WriteEscaped(out, family.m_Help, false);
+            out << '\n';
+
+            for (const Entry& entry : family.m_Entries)
+            {
+                switch (family.m_Type)
+                {
+                case Type::COUNTER:
+                    if (Counter::Ptr counter = entry.m_Counter.lock(); counter != nullptr)
+                    {
+                        out << name << "_total";
+                        WriteLabels(out, entry.m_Labels);
+                        out << ' ';
+                        if (counter->GetScale() == 1.0)
+                        {
+                            out << counter->Get() << '\n';
+                        }
+                        else
+                        {
+                            out << FormatValue(double(counter->Get()) * counter->GetScale()) << '\n';
+                        }
+                    }
+                    break;
+                case Type::GAUGE:
+                    if (Gauge::Ptr gauge = entry.m_Gauge.lock(); gauge != nullptr)
+                    {
+                        out << name;
+                        WriteLabels(out, entry.m_Labels);
+                        out << ' ' << FormatValue(gauge->Get()) << '\n';
+                    }
+                    break;
+                case Type::HISTOGRAM:
+                    if (Histogram::Ptr histogram = entry.m_Histogram.lock(); histogram != nullptr)
+                    {
+                        //  Buckets are read one by one while observations go on, the count is derived from the same reads
+                        //  so that the exposition stays self-consistent
+                        const std::vector<double>& bounds = histogram->GetBounds();
+                        uint64_t cumulative = 0;
+                        for (size_t i = 0; i <= bounds.size(); ++i)
+                        {
+                            cumulative += histogram->GetBucket(i);
+                            out << name << "_bucket";
+                            WriteLabels(out, entry.m_Labels, "le", FormatValue(i < bounds.size() ? bounds[i] : INFINITY));
+                            out << ' ' << cumulative << '\n';
+                        }
+                        out << name << "_count";
+                        WriteLabels(out, entry.m_Labels);
+                        out << ' ' << cumulative << '\n';
+                        out << name << "_sum";
+                        WriteLabels(out, entry.m_Labels);
+                        out << ' ' << FormatValue(histogram->GetSum()) << '\n';
+                    }
+                    break;
+                }
+            }
+            ++itFamily;
+        }
+        out << "# EOF\n";
+        return out.str();
+    }
+}
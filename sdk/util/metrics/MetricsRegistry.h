@@ -0,0 +1,170 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "amf/public/common/Thread.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ssdk::util
+{
+    //  MetricsRegistry: process-wide counters, gauges and histograms, exported in the OpenMetrics text format by MetricsExporter.
+    //  Updating a metric is a relaxed atomic operation, so the instrumented code never waits for a scrape. The guard only protects
+    //  the list of metrics, which changes when a metric is created or released. The registry holds weak references: a metric is
+    //  exported for as long as somebody owns it, so per-session metrics disappear together with their session.
+    class MetricsRegistry
+    {
+    public:
+        typedef std::vector<std::pair<std::string, std::string>> Labels;
+
+        //  Monotonic integer counter. scale converts the stored value to the exported unit, e.g. 1.0 / AMF_SECOND for amf_pts
+        class Counter
+        {
+        public:
+            typedef std::shared_ptr<Counter> Ptr;
+
+            Counter(double scale = 1.0) noexcept : m_Scale(scale) {}
+
+            inline void Add(uint64_t value) noexcept { m_Value.fetch_add(value, std::memory_order_relaxed); }
+            inline void Increment() noexcept { m_Value.fetch_add(1, std::memory_order_relaxed); }
+            inline uint64_t Get() const noexcept { return m_Value.load(std::memory_order_relaxed); }
+            inline double GetScale() const noexcept { return m_Scale; }
+
+        private:
+            Counter(const Counter&) = delete;
+            Counter& operator=(const Counter&) = delete;
+
+            std::atomic<uint64_t>   m_Value{ 0 };
+            const double            m_Scale;
+        };
+
+        class Gauge
+        {
+        public:
+            typedef std::shared_ptr<Gauge> Ptr;
+
+            Gauge() noexcept = default;
+
+            inline void Set(double value) noexcept { m_Value.store(value, std::memory_order_relaxed); }
+            inline void Add(double value) noexcept { m_Value.fetch_add(value, std::memory_order_relaxed); }
+            inline double Get() const noexcept { return m_Value.load(std::memory_order_relaxed); }
+
+        private:
+            Gauge(const Gauge&) = delete;
+            Gauge& operator=(const Gauge&) = delete;
+
+            std::atomic<double>     m_Value{ 0 };
+        };
+
+        //  Fixed buckets given by their ascending upper bounds, the +Inf bucket is implicit
+        class Histogram
+        {
+        public:
+            typedef std::shared_ptr<Histogram> Ptr;
+
+            Histogram(const std::vector<double>& bounds);
+
+            void Observe(double value) noexcept;
+
+            inline const std::vector<double>& GetBounds() const noexcept { return m_Bounds; }
+            inline uint64_t GetBucket(size_t index) const noexcept { return m_Buckets[index].load(std::memory_order_relaxed); }   //  Not cumulative, index == GetBounds().size() is +Inf
+            inline double GetSum() const noexcept { return m_Sum.load(std::memory_order_relaxed); }
+
+        private:
+            Histogram(const Histogram&) = delete;
+            Histogram& operator=(const Histogram&) = delete;
+
+            const std::vector<double>                   m_Bounds;
+            std::unique_ptr<std::atomic<uint64_t>[]>    m_Buckets;
+            std::atomic<double>                         m_Sum{ 0 };
+        };
+
+        static const std::vector<double> LATENCY_BUCKETS;     //  Seconds, 0.5 ms to 1 s
+
+    public:
+        static MetricsRegistry& GetInstance();
+
+        //  A metric with the same name and labels which is still owned by somebody else is shared rather than duplicated.
+        //  Names follow the OpenMetrics conventions: the "_total" suffix of counters is appended on export and must not be passed
+        Counter::Ptr GetCounter(const std::string& name, const std::string& help, const Labels& labels = {}, double scale = 1.0);
+        Gauge::Ptr GetGauge(const std::string& name, const std::string& help, const Labels& labels = {});
+        Histogram::Ptr GetHistogram(const std::string& name, const std::string& help, const std::vector<double>& bounds, const Labels& labels = {});
+
+        std::string Export();                                   //  The whole exposition, terminated with "# EOF"
+        size_t GetSeriesCount();                                //  Registered series, released ones are counted until they are pruned
+
+    private:
+        MetricsRegistry() = default;
+        MetricsRegistry(const MetricsRegistry&) = delete;
+        MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+        enum class Type
+        {
+            COUNTER,
+            GAUGE,
+            HISTOGRAM
+        };
+
+        class Entry
+        {
+        public:
+            Labels                      m_Labels;
+            std::weak_ptr<Counter>      m_Counter;
+            std::weak_ptr<Gauge>        m_Gauge;
+            std::weak_ptr<Histogram>    m_Histogram;
+
+            inline bool IsReleased() const noexcept { return m_Counter.expired() == true && m_Gauge.expired() == true && m_Histogram.expired() == true; }
+        };
+
+        class Family
+        {
+        public:
+            Type                m_Type = Type::COUNTER;
+            std::string         m_Help;
+            std::vector<Entry>  m_Entries;
+        };
+
+        //  Creates missing entries, nullptr on a type clash. Drops the released entries of the family on the way, so that
+        //  per-session metrics do not pile up under session churn when nobody scrapes the registry
+        Entry* FindEntry(const std::string& name, Type type, const std::string& help, const Labels& labels);
+
+    private:
+        amf::AMFCriticalSection             m_Guard;
+        std::map<std::string, Family>       m_Families;
+    };
+}
@@ -33,6 +33,7 @@
 
 #include "AVSynchronizer.h"
 #include "sdk/video/Defines.h"
+#include "sdk/util/trace/PipelineTrace.h"
 
 #include "amf/public/common/TraceAdapter.h"
 
@@ -129,6 +130,7 @@ namespace ssdk::util
         AMF_RETURN_IF_FALSE(input != nullptr, AMF_INVALID_ARG, L"AVSynchronizer::SubmitVideoInput received NULL input");
         amf::AMFSurfacePtr surface(input);
         AMF_RETURN_IF_FALSE(surface != nullptr, AMF_INVALID_ARG, L"AVSynchronizer::SubmitVideoInput received input that is not an AMFSurface");
+        SSDK_TRACE_SPAN(AV_SYNC, PipelineTrace::GetDataKey(surface));
         ssdk::util::ClientStatsManager::Ptr statsManager;
         {
             amf::AMFLock    lock(&m_Guard);
@@ -137,7 +139,12 @@ namespace ssdk::util
         }
         m_LastVideoPts = surface->GetPts();
 
-        AMF_RESULT result = m_VideoPresenter != nullptr ? m_VideoPresenter->SubmitInput(surface) : AMF_OK;
+        AMF_RESULT result = AMF_OK;
+        if (m_VideoPresenter != nullptr)
+        {
+            SSDK_TRACE_SPAN(PRESENT, PipelineTrace::GetDataKey(surface));
+            result = m_VideoPresenter->SubmitInput(surface);
+        }
 
         ssdk::transport_common::StreamID streamID = -1;
         surface->GetProperty(ssdk::video::STREAM_ID_PROPERTY, &streamID);
@@ -43,6 +43,18 @@ namespace ssdk::util
 {
     ClientStatsManager::ClientStatsManager()
     {
+        MetricsRegistry& registry = MetricsRegistry::GetInstance();
+        const std::vector<double>& buckets = MetricsRegistry::LATENCY_BUCKETS;
+        m_FramesMetric = registry.GetCounter("ssdk_client_frames", "Video frames received by the client");
+        m_FullLatencyMetric = registry.GetHistogram("ssdk_client_full_latency_seconds", "End-to-end latency of video frames", buckets);
+        m_ClientLatencyMetric = registry.GetHistogram("ssdk_client_client_latency_seconds", "Time video frames spend in the client", buckets);
+        m_ServerLatencyMetric = registry.GetHistogram("ssdk_client_server_latency_seconds", "Time video frames spend in the server, as reported by the server", buckets);
+        m_EncoderLatencyMetric = registry.GetHistogram("ssdk_client_encoder_latency_seconds", "Encoder latency of video frames, as reported by the server", buckets);
+        m_NetworkLatencyMetric = registry.GetHistogram("ssdk_client_network_latency_seconds", "One-way server to client latency, measured with synchronized clocks", buckets);
+        m_DecoderLatencyMetric = registry.GetHistogram("ssdk_client_decoder_latency_seconds", "Time video frames spend in the decoder", buckets);
+        m_DecryptMetric = registry.GetHistogram("ssdk_client_decrypt_seconds", "Decryption time of received messages", buckets);
+        m_AVDesyncMetric = registry.GetGauge("ssdk_client_av_desync_seconds", "Last measured offset between audio and video");
+        m_DecoderQueueDepthMetric = registry.GetGauge("ssdk_client_decoder_queue_depth", "Frames submitted to the decoder and not output yet");
     }
 
     void ClientStatsManager::SetTransport(ssdk::transport_common::ClientTransport* transport)
@@ -64,6 +76,7 @@ namespace ssdk::util
         m_ClientLatencyHistory.Clear();
         m_ServerLatencyHistory.Clear();
         m_EncoderLatencyHistory.Clear();
+        m_NetworkLatencyHistory.Clear();
         m_DecoderLatencyHistory.Clear();
 
         m_DecryptHistory.Clear();
@@ -80,6 +93,7 @@ namespace ssdk::util
         amf_pts now = amf_high_precision_clock();;
         m_DecoderQueueTimes[pts] = now;
         ++m_DecoderQueueDepth;
+        m_DecoderQueueDepthMetric->Set(m_DecoderQueueDepth);
     };
 
     void ClientStatsManager::DecrementDecoderQueueDepth(amf_pts pts)
@@ -92,9 +106,12 @@ namespace ssdk::util
         {
             amf_pts ptsStart = element->second;
             m_DecoderLatencyHistory.Add((float)(ptsEnd - ptsStart) / AMF_MILLISECOND);
+            m_DecoderLatencyMetric->Observe(double(ptsEnd - ptsStart) / AMF_SECOND);
             m_DecoderQueueTimes.erase(element);
         }
-        if (--m_DecoderQueueDepth > 0)
+        --m_DecoderQueueDepth;
+        m_DecoderQueueDepthMetric->Set(m_DecoderQueueDepth);
+        if (m_DecoderQueueDepth > 0)
         {
             SendStatistics();
         }
@@ -109,34 +126,48 @@ namespace ssdk::util
         m_FrameDurationHistory.Add(frameDuration);
         float fullLatency = (float)(fullLatencyPts) / AMF_MILLISECOND;
         m_FullLatencyHistory.Add(fullLatency);
+        m_FramesMetric->Increment();
+        m_FullLatencyMetric->Observe(double(fullLatencyPts) / AMF_SECOND);
     }
 
     void ClientStatsManager::UpdateClientLatency(amf_pts clientLatencyPts)
     {
         float clientLatency = (float)(clientLatencyPts) / AMF_MILLISECOND;
         m_ClientLatencyHistory.Add(clientLatency);
+        m_ClientLatencyMetric->Observe(double(clientLatencyPts) / AMF_SECOND);
     }
 
     void ClientStatsManager::UpdateServerLatency(amf_pts serverLatencyPts)
     {
         float serverLatency = (float)(serverLatencyPts) / AMF_MILLISECOND;
         m_ServerLatencyHistory.Add(serverLatency);
+        m_ServerLatencyMetric->Observe(double(serverLatencyPts) / AMF_SECOND);
     }
 
     void ClientStatsManager::UpdateEncoderLatency(amf_pts encoderLatencyPts)
     {
         float encoderLatency = (float)(encoderLatencyPts) / AMF_MILLISECOND;
         m_EncoderLatencyHistory.Add(encoderLatency);
+        m_EncoderLatencyMetric->Observe(double(encoderLatencyPts) / AMF_SECOND);
+    }
+
+    void ClientStatsManager::UpdateNetworkLatency(amf_pts networkLatencyPts)
+    {
+        float networkLatency = (float)(networkLatencyPts) / AMF_MILLISECOND;
+        m_NetworkLatencyHistory.Add(networkLatency);
+        m_NetworkLatencyMetric->Observe(double(networkLatencyPts) / AMF_SECOND);
     }
 
     void ClientStatsManager::UpdateAudioStatistics(amf_pts AVDesync)
     {
         m_AVDesyncHistory.Add((float)(AVDesync) / AMF_MILLISECOND );
+        m_AVDesyncMetric->Set(double(AVDesync) / AMF_SECOND);
     }
 
     void ClientStatsManager::UpdateDecryptStatistics(amf_pts decrypt)
     {
         m_DecryptHistory.Add((float)(decrypt) / AMF_MILLISECOND );
+        m_DecryptMetric->Observe(double(decrypt) / AMF_SECOND);
     }
 
     void ClientStatsManager::SendStatistics()
@@ -165,7 +196,9 @@ namespace ssdk::util
                 clientLatency = m_ClientLatencyHistory.GetAverageAndClear();
                 serverLatency = m_ServerLatencyHistory.GetAverageAndClear();
                 encoderLatency = m_EncoderLatencyHistory.GetAverageAndClear();
-                networkLatency = fullLatency - clientLatency - serverLatency;
+                // prefer the one-way latency measured against the synchronized server clock, the remainder of the
+                // full latency also contains the uplink of the turnaround message
+                networkLatency = m_NetworkLatencyHistory.GetCount() > 0 ? m_NetworkLatencyHistory.GetAverageAndClear() : fullLatency - clientLatency - serverLatency;
                 decoderLatency = m_DecoderLatencyHistory.GetAverageAndClear();
                 decrypt = m_DecryptHistory.GetAverageAndClear();
                 decoderQueueSize = m_DecoderQueueDepth;
@@ -35,6 +35,7 @@
 
 #include "transports/transport-common/ClientTransport.h"
 #include "util/QoS/ValueHistory.h"
+#include "util/metrics/MetricsRegistry.h"
 #include "amf/public/common/Thread.h"
 
 #include <map>
@@ -103,6 +104,7 @@ namespace ssdk::util
         void UpdateClientLatency(amf_pts clientLatencyPts);
         void UpdateServerLatency(amf_pts serverLatencyPts);
         void UpdateEncoderLatency(amf_pts encoderLatencyPts);
+        void UpdateNetworkLatency(amf_pts networkLatencyPts);   //  One-way server to client, measured with synchronized clocks
         void UpdateAudioStatistics(amf_pts AVDesync);
         void UpdateDecryptStatistics(amf_pts decrypt);
         void SendStatistics();
@@ -117,6 +119,7 @@ namespace ssdk::util
         FloatValueAverage m_ClientLatencyHistory;
         FloatValueAverage m_ServerLatencyHistory;
         FloatValueAverage m_EncoderLatencyHistory;
+        FloatValueAverage m_NetworkLatencyHistory;
         FloatValueAverage m_DecoderLatencyHistory;
         FloatValueAverage m_DecryptHistory;
         FloatValueAverage m_AVDesyncHistory;
@@ -127,5 +130,17 @@ namespace ssdk::util
         amf_pts m_LastFrameTime = 0;
         amf_pts m_LastSendStatsTime = 0;
 
+        //  Exported through MetricsRegistry
+        MetricsRegistry::Counter::Ptr   m_FramesMetric;
+        MetricsRegistry::Histogram::Ptr m_FullLatencyMetric;
+        MetricsRegistry::Histogram::Ptr m_ClientLatencyMetric;
+        MetricsRegistry::Histogram::Ptr m_ServerLatencyMetric;
+        MetricsRegistry::Histogram::Ptr m_EncoderLatencyMetric;
+        MetricsRegistry::Histogram::Ptr m_NetworkLatencyMetric;
+        MetricsRegistry::Histogram::Ptr m_DecoderLatencyMetric;
+        MetricsRegistry::Histogram::Ptr m_DecryptMetric;
+        MetricsRegistry::Gauge::Ptr     m_AVDesyncMetric;
+        MetricsRegistry::Gauge::Ptr     m_DecoderQueueDepthMetric;
+
     };
 }
\ No newline at end of file
@@ -0,0 +1,393 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "PipelineTrace.h"
+
+#include "amf/public/common/Thread.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::util::PipelineTrace";
+
+namespace ssdk::util
+{
+    static_assert((PipelineTrace::RING_SIZE & (PipelineTrace::RING_SIZE - 1)) == 0, "PipelineTrace::RING_SIZE must be a power of 2");
+
+    static const char* const EVENT_NAMES[] =
+    {
+        "Capture",
+        "Convert",
+        "Encoder submit",
+        "Encode",
+        "Encoder output",
+        "Transmit",
+        "Send queue",
+        "Encrypt",
+        "Fragment send",
+        "Fragment resend",
+        "Reassemble",
+        "Decrypt",
+        "Receive",
+        "Decoder submit",
+        "Decode",
+        "Decoder output",
+        "AV sync",
+        "Present"
+    };
+    static_assert(sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]) == size_t(PipelineTrace::Event::COUNT), "EVENT_NAMES does not match PipelineTrace::Event");
+
+    std::atomic<bool> PipelineTrace::s_Enabled(false);
+
+    //  Written only by the owning thread. SaveChromeTrace() reads it concurrently and discards the records which might
+    //  have been overwritten while it was copying them
+    class PipelineTrace::Ring
+    {
+    public:
+        Ring(uint32_t threadIndex) : m_Records(new Record[RING_SIZE]), m_ThreadIndex(threadIndex) {}
+
+        std::unique_ptr<Record[]>   m_Records;
+        std::atomic<uint64_t>       m_Head{ 0 };
+        const uint32_t              m_ThreadIndex;
+    };
+
+    //  Rings outlive their threads so that the records of the threads which have already exited make it into the dump
+    class PipelineTrace::Registry
+    {
+    public:
+        amf::AMFCriticalSection             m_Guard;
+        std::vector<std::shared_ptr<Ring>>  m_Rings;
+        uint32_t                            m_NextThreadIndex = 1;
+    };
+
+    class PipelineTrace::ThreadState
+    {
+    public:
+        class Deferred
+        {
+        public:
+            Event       m_Event = Event::COUNT;
+            amf_pts     m_Start = 0;
+            amf_pts     m_End = 0;
+        };
+
+        std::shared_ptr<Ring>   m_Ring;
+        amf_pts                 m_Key = NO_KEY;
+        Deferred                m_Deferred[MAX_DEFERRED];
+        size_t                  m_DeferredCount = 0;
+    };
+
+    void PipelineTrace::Enable(bool enable) noexcept
+    {
+        s_Enabled.store(enable, std::memory_order_relaxed);
+    }
+
+    void PipelineTrace::Clear()
+    {
+        Registry& registry = GetRegistry();
+        amf::AMFLock lock(&registry.m_Guard);
+        //  The ThreadState of a live thread holds the other reference to its ring
+        registry.m_Rings.erase(std::remove_if(registry.m_Rings.begin(), registry.m_Rings.end(), [](const std::shared_ptr<Ring>& ring) { return ring.use_count() == 1; }),
+                               registry.m_Rings.end());
+        for (std::shared_ptr<Ring>& ring : registry.m_Rings)
+        {
+            ring->m_Head.store(0, std::memory_order_release);
+        }
+    }
+
+    PipelineTrace::Registry& PipelineTrace::GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    PipelineTrace::ThreadState& PipelineTrace::GetThreadState()
+    {
+        static thread_local ThreadState state;
+        return state;
+    }
+
+    void PipelineTrace::Write(Event event, Phase phase, amf_pts key, amf_pts time, amf_pts duration)
+    {
+        ThreadState& state = GetThreadState();
+        if (state.m_Ring == nullptr)
+        {   //  First record on this thread
+            Registry& registry = GetRegistry();
+            amf::AMFLock lock(&registry.m_Guard);
+            state.m_Ring = std::make_shared<Ring>(registry.m_NextThreadIndex++);
+            registry.m_Rings.push_back(state.m_Ring);
+        }
+        Ring& ring = *state.m_Ring;
+        uint64_t head = ring.m_Head.load(std::memory_order_relaxed);
+        Record& record = ring.m_Records[head & (RING_SIZE - 1)];
+        record.m_Time = time;
+        record.m_Duration = duration;
+        record.m_Key = key;
+        record.m_Event = event;
+        record.m_Phase = phase;
+        ring.m_Head.store(head + 1, std::memory_order_release);
+    }
+
+    void PipelineTrace::Complete(Event event, amf_pts key, amf_pts start, amf_pts end)
+    {
+        if (IsEnabled() == true)
+        {
+            Write(event, Phase::COMPLETE, key, start, end - start);
+        }
+    }
+
+    void PipelineTrace::Instant(Event event, amf_pts key)
+    {
+        if (IsEnabled() == true)
+        {
+            Write(event, Phase::INSTANT, key, amf_high_precision_clock(), 0);
+        }
+    }
+
+    void PipelineTrace::Begin(Event event, amf_pts key)
+    {
+        if (IsEnabled() == true)
+        {
+            Write(event, Phase::ASYNC_BEGIN, key, amf_high_precision_clock(), 0);
+        }
+    }
+
+    void PipelineTrace::End(Event event, amf_pts key)
+    {
+        if (IsEnabled() == true)
+        {
+            Write(event, Phase::ASYNC_END, key, amf_high_precision_clock(), 0);
+        }
+    }
+
+    amf_pts PipelineTrace::GetKey() noexcept
+    {
+        return GetThreadState().m_Key;
+    }
+
+    void PipelineTrace::Defer(Event event, amf_pts start)
+    {
+        if (IsEnabled() == true)
+        {
+            ThreadState& state = GetThreadState();
+            if (state.m_DeferredCount == MAX_DEFERRED)
+            {   //  Nothing has claimed the oldest span, commit it without a key
+                const ThreadState::Deferred& oldest = state.m_Deferred[0];
+                Write(oldest.m_Event, Phase::COMPLETE, NO_KEY, oldest.m_Start, oldest.m_End - oldest.m_Start);
+                std::copy(state.m_Deferred + 1, state.m_Deferred + MAX_DEFERRED, state.m_Deferred);
+                --state.m_DeferredCount;
+            }
+            ThreadState::Deferred& deferred = state.m_Deferred[state.m_DeferredCount++];
+            deferred.m_Event = event;
+            deferred.m_Start = start;
+            deferred.m_End = amf_high_precision_clock();
+        }
+    }
+
+    void PipelineTrace::Flush()
+    {
+        CommitDeferred(GetThreadState(), NO_KEY);
+    }
+
+    void PipelineTrace::CommitDeferred(ThreadState& state, amf_pts key)
+    {
+        for (size_t i = 0; i < state.m_DeferredCount; ++i)
+        {
+            const ThreadState::Deferred& deferred = state.m_Deferred[i];
+            Write(deferred.m_Event, Phase::COMPLETE, key, deferred.m_Start, deferred.m_End - deferred.m_Start);
+        }
+        state.m_DeferredCount = 0;
+    }
+
+    amf_pts PipelineTrace::GetDataKey(amf::AMFPropertyStorage* data) noexcept
+    {
+        amf_pts key = NO_KEY;
+        if (IsEnabled() == true && data != nullptr && data->GetProperty(KEY_PROPERTY, &key) != AMF_OK)
+        {
+            key = NO_KEY;
+        }
+        return key;
+    }
+
+    void PipelineTrace::SetDataKey(amf::AMFPropertyStorage* data, amf_pts key) noexcept
+    {
+        if (IsEnabled() == true && data != nullptr && key != NO_KEY)
+        {
+            data->SetProperty(KEY_PROPERTY, key);
+        }
+    }
+
+    const char* PipelineTrace::GetEventName(Event event) noexcept
+    {
+        return event < Event::COUNT ? EVENT_NAMES[size_t(event)] : "Unknown";
+    }
+
+    //  Chrome trace timestamps are in microseconds, amf_pts is in 100ns units
+    static std::string FormatMicroseconds(amf_pts pts)
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%s%lld.%d", pts < 0 ? "-" : "", static_cast<long long>((pts < 0 ? -pts : pts) / 10), static_cast<int>((pts < 0 ? -pts : pts) % 10));
+        return buf;
+    }
+
+    static std::string EscapeJSON(const char* str)
+    {
+        std::string escaped;
+        for (; str != nullptr && *str != '\0'; ++str)
+        {
+            if (*str == '"' || *str == '\\')
+            {
+                escaped += '\\';
+            }
+            escaped += (static_cast<unsigned char>(*str) < 0x20) ? ' ' : *str;
+        }
+        return escaped;
+    }
+
+    bool PipelineTrace::SaveChromeTrace(const char* fileName, const char* processName, int32_t processID, amf_pts timeOffset)
+    {
+        std::vector<std::shared_ptr<Ring>> rings;
+        {
+            Registry& registry = GetRegistry();
+            amf::AMFLock lock(&registry.m_Guard);
+            rings = registry.m_Rings;
+        }
+
+        std::ofstream file(fileName, std::ios::out | std::ios::trunc);
+        if (file.is_open() == false)
+        {
+            AMFTraceError(AMF_FACILITY, L"Failed to create trace file %S", fileName);
+            return false;
+        }
+
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << processID << ",\"args\":{\"name\":\"" << EscapeJSON(processName) << "\"}}";
+
+        size_t eventCnt = 0;
+        std::vector<Record> records;
+        for (const std::shared_ptr<Ring>& ring : rings)
+        {
+            uint64_t head = ring->m_Head.load(std::memory_order_acquire);
+            uint64_t first = head > RING_SIZE ? head - RING_SIZE : 0;
+            records.clear();
+            for (uint64_t i = first; i < head; ++i)
+            {
+                records.push_back(ring->m_Records[i & (RING_SIZE - 1)]);
+            }
+            //  The owner might have wrapped around while the records were copied, one more record can be in the middle of being written
+            uint64_t headAfter = ring->m_Head.load(std::memory_order_acquire);
+            uint64_t firstValid = headAfter + 1 > RING_SIZE ? headAfter + 1 - RING_SIZE : 0;
+            size_t skip = size_t(std::min<uint64_t>(firstValid > first ? firstValid - first : 0, records.size()));
+
+            file << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << processID << ",\"tid\":" << ring->m_ThreadIndex
+                 << ",\"args\":{\"name\":\"Thread " << ring->m_ThreadIndex << "\"}}";
+            for (size_t i = skip; i < records.size(); ++i)
+            {
+                const Record& record = records[i];
+                file << ",\n{\"name\":\"" << GetEventName(record.m_Event) << "\",\"cat\":\"ssdk\",\"pid\":" << processID << ",\"tid\":" << ring->m_ThreadIndex
+                     << ",\"ts\":" << FormatMicroseconds(record.m_Time + timeOffset);
+                switch (record.m_Phase)
+                {
+                case Phase::COMPLETE:
+                    file << ",\"ph\":\"X\",\"dur\":" << FormatMicroseconds(record.m_Duration);
+                    break;
+                case Phase::INSTANT:
+                    file << ",\"ph\":\"i\",\"s\":\"t\"";
+                    break;
+                case Phase::ASYNC_BEGIN:
+                    file << ",\"ph\":\"b\",\"id\":\"" << record.m_Key << "\"";
+                    break;
+                case Phase::ASYNC_END:
+                    file << ",\"ph\":\"e\",\"id\":\"" << record.m_Key << "\"";
+                    break;
+                }
+                if (record.m_Key != NO_KEY)
+                {
+                    file << ",\"args\":{\"pts\":" << record.m_Key << "}";
+                }
+                file << "}";
+                ++eventCnt;
+            }
+        }
+        file << "\n]}\n";
+        file.close();
+        if (file.fail() == true)
+        {
+            AMFTraceError(AMF_FACILITY, L"Failed to write trace file %S", fileName);
+            return false;
+        }
+        AMFTraceInfo(AMF_FACILITY, L"Saved %zu trace events from %zu threads to %S", eventCnt, rings.size(), fileName);
+        return true;
+    }
+
+    PipelineTrace::Span::Span(Event event, amf_pts key) noexcept :
+        m_Event(event),
+        m_Key(key),
+        m_Start(IsEnabled() == true ? amf_high_precision_clock() : 0)
+    {
+    }
+
+    PipelineTrace::Span::Span(Event event) noexcept :
+        m_Event(event),
+        m_Key(IsEnabled() == true ? GetKey() : NO_KEY),
+        m_Start(IsEnabled() == true ? amf_high_precision_clock() : 0)
+    {
+    }
+
+    PipelineTrace::Span::~Span()
+    {
+        if (m_Start != 0)
+        {
+            Complete(m_Event, m_Key, m_Start, amf_high_precision_clock());
+        }
+    }
+
+    PipelineTrace::KeyScope::KeyScope(amf_pts key)
+    {
+        ThreadState& state = GetThreadState();
+        m_PrevKey = state.m_Key;
+        state.m_Key = key;
+        CommitDeferred(state, key);
+    }
+
+    PipelineTrace::KeyScope::~KeyScope()
+    {
+        GetThreadState().m_Key = m_PrevKey;
+    }
+}
@@ -0,0 +1,192 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+#pragma once
+
+#include "amf/public/include/core/Platform.h"
+#include "amf/public/include/core/PropertyStorage.h"
+
+#include <atomic>
+#include <stdint.h>
+
+namespace ssdk::util
+{
+    //  PipelineTrace: per-frame timeline of the streaming pipeline in the Chrome trace event format, which chrome://tracing
+    //  and ui.perfetto.dev load directly. Spans are keyed by the frame PTS assigned on the server, so a single frame can be
+    //  followed from capture to present across both processes.
+    //  Every thread writes into its own ring of RING_SIZE records without taking any locks, the oldest records are overwritten
+    //  when a ring wraps. Tracing is off until Enable(true) is called, a disabled span costs one relaxed atomic load.
+    //  The SSDK_TRACE_* macros below compile to nothing unless SSDK_PIPELINE_TRACE is defined (SSDK_PIPELINE_TRACE CMake option).
+    class PipelineTrace
+    {
+    public:
+        enum class Event : uint8_t
+        {
+            //  Server
+            CAPTURE,
+            CONVERT,
+            ENCODER_SUBMIT,
+            ENCODE,                 //  Asynchronous, from SubmitInput to the output of the same frame
+            ENCODER_OUTPUT,
+            TRANSMIT,
+            SEND_QUEUE,             //  Time a message waited in the subscriber's send queue
+            ENCRYPT,
+            FRAGMENT_SEND,
+            FRAGMENT_RESEND,        //  Retransmission requested by the receiver, not keyed
+            //  Client
+            REASSEMBLE,             //  From the first fragment of a message to its completion
+            DECRYPT,
+            RECEIVE,
+            DECODER_SUBMIT,
+            DECODE,                 //  Asynchronous, from SubmitInput to the output of the same frame
+            DECODER_OUTPUT,
+            AV_SYNC,
+            PRESENT,
+
+            COUNT
+        };
+
+        static constexpr const size_t RING_SIZE = 32768;                        //  Records per thread, must be a power of 2
+        static constexpr const size_t MAX_DEFERRED = 8;                         //  Spans per thread waiting for a key
+        static constexpr const amf_pts NO_KEY = -1;
+        static constexpr const wchar_t* const KEY_PROPERTY = L"amd.ssdk.TraceKey";  //  amf_pts: carries the key on frames across asynchronous components
+
+    public:
+        static void Enable(bool enable) noexcept;
+        static inline bool IsEnabled() noexcept { return s_Enabled.load(std::memory_order_relaxed); }
+        static void Clear();                                                    //  Call with tracing disabled
+
+        static void Complete(Event event, amf_pts key, amf_pts start, amf_pts end);
+        static void Instant(Event event, amf_pts key);
+        static void Begin(Event event, amf_pts key);                            //  Asynchronous span, Begin() and End() with the same event and key may
+        static void End(Event event, amf_pts key);                              //  be called on different threads
+
+        //  The key of the enclosing KeyScope on the calling thread, for code that does not see the frame, such as the transport
+        static amf_pts GetKey() noexcept;
+        //  Records a span ending now whose key is not known yet, it is committed with the key of the next KeyScope
+        //  opened on the same thread or without a key by Flush()
+        static void Defer(Event event, amf_pts start);
+        static void Flush();
+
+        static amf_pts GetDataKey(amf::AMFPropertyStorage* data) noexcept;
+        static void SetDataKey(amf::AMFPropertyStorage* data, amf_pts key) noexcept;
+
+        //  timeOffset is added to every timestamp, pass the offset from ClockSync on the client to put both processes on the server timeline
+        static bool SaveChromeTrace(const char* fileName, const char* processName, int32_t processID = 1, amf_pts timeOffset = 0);
+        static const char* GetEventName(Event event) noexcept;
+
+        class Span
+        {
+        public:
+            Span(Event event, amf_pts key) noexcept;
+            Span(Event event) noexcept;                                         //  Keyed by the enclosing KeyScope
+            ~Span();
+
+        private:
+            Span(const Span&) = delete;
+            Span& operator=(const Span&) = delete;
+
+            Event       m_Event;
+            amf_pts     m_Key;
+            amf_pts     m_Start;
+        };
+
+        class KeyScope
+        {
+        public:
+            KeyScope(amf_pts key);
+            ~KeyScope();
+
+        private:
+            KeyScope(const KeyScope&) = delete;
+            KeyScope& operator=(const KeyScope&) = delete;
+
+            amf_pts     m_PrevKey;
+        };
+
+    private:
+        enum class Phase : uint8_t
+        {
+            COMPLETE,
+            INSTANT,
+            ASYNC_BEGIN,
+            ASYNC_END
+        };
+
+        class Record
+        {
+        public:
+            amf_pts     m_Time = 0;
+            amf_pts     m_Duration = 0;
+            amf_pts     m_Key = NO_KEY;
+            Event       m_Event = Event::COUNT;
+            Phase       m_Phase = Phase::COMPLETE;
+        };
+
+        class Ring;
+        class Registry;
+        class ThreadState;
+
+        static Registry& GetRegistry();
+        static ThreadState& GetThreadState();
+        static void Write(Event event, Phase phase, amf_pts key, amf_pts time, amf_pts duration);
+        static void CommitDeferred(ThreadState& state, amf_pts key);
+
+    private:
+        static std::atomic<bool>    s_Enabled;
+    };
+}
+
+#if defined(SSDK_PIPELINE_TRACE)
+    #define SSDK_TRACE_CONCAT_IMPL(a, b)            a##b
+    #define SSDK_TRACE_CONCAT(a, b)                 SSDK_TRACE_CONCAT_IMPL(a, b)
+    #define SSDK_TRACE_SPAN(event, key)             ssdk::util::PipelineTrace::Span SSDK_TRACE_CONCAT(ssdkTraceSpan, __LINE__)(ssdk::util::PipelineTrace::Event::event, key)
+    #define SSDK_TRACE_SCOPE_SPAN(event)            ssdk::util::PipelineTrace::Span SSDK_TRACE_CONCAT(ssdkTraceSpan, __LINE__)(ssdk::util::PipelineTrace::Event::event)
+    #define SSDK_TRACE_KEY_SCOPE(key)               ssdk::util::PipelineTrace::KeyScope SSDK_TRACE_CONCAT(ssdkTraceKeyScope, __LINE__)(key)
+    #define SSDK_TRACE_COMPLETE(event, key, start)  do { if (ssdk::util::PipelineTrace::IsEnabled() == true) { ssdk::util::PipelineTrace::Complete(ssdk::util::PipelineTrace::Event::event, key, start, amf_high_precision_clock()); } } while (false)
+    #define SSDK_TRACE_INSTANT(event, key)          do { if (ssdk::util::PipelineTrace::IsEnabled() == true) { ssdk::util::PipelineTrace::Instant(ssdk::util::PipelineTrace::Event::event, key); } } while (false)
+    #define SSDK_TRACE_BEGIN(event, key)            do { if (ssdk::util::PipelineTrace::IsEnabled() == true) { ssdk::util::PipelineTrace::Begin(ssdk::util::PipelineTrace::Event::event, key); } } while (false)
+    #define SSDK_TRACE_END(event, key)              do { if (ssdk::util::PipelineTrace::IsEnabled() == true) { ssdk::util::PipelineTrace::End(ssdk::util::PipelineTrace::Event::event, key); } } while (false)
+    #define SSDK_TRACE_DEFER(event, start)          do { if (ssdk::util::PipelineTrace::IsEnabled() == true) { ssdk::util::PipelineTrace::Defer(ssdk::util::PipelineTrace::Event::event, start); } } while (false)
+    #define SSDK_TRACE_FLUSH()                      ssdk::util::PipelineTrace::Flush()
+#else
+    #define SSDK_TRACE_SPAN(event, key)
+    #define SSDK_TRACE_SCOPE_SPAN(event)
+    #define SSDK_TRACE_KEY_SCOPE(key)
+    #define SSDK_TRACE_COMPLETE(event, key, start)  do {} while (false)
+    #define SSDK_TRACE_INSTANT(event, key)          do {} while (false)
+    #define SSDK_TRACE_BEGIN(event, key)            do {} while (false)
+    #define SSDK_TRACE_END(event, key)              do {} while (false)
+    #define SSDK_TRACE_DEFER(event, start)          do {} while (false)
+    #define SSDK_TRACE_FLUSH()                      do {} while (false)
+#endif
@@ -40,4 +40,5 @@ namespace ssdk::video
     const char* const CODEC_H264 = "avc";
     const char* const CODEC_HEVC = "hevc";
     const char* const CODEC_AV1 = "av1";
+    const char* const CODEC_NULL = "null";
 }
@@ -40,10 +40,13 @@ namespace ssdk::video
     extern const char* const CODEC_H264;
     extern const char* const CODEC_HEVC;
     extern const char* const CODEC_AV1;
+    extern const char* const CODEC_NULL;        //  Synthetic bitstream produced by NullVideoEncodeEngine, no GPU required
 
     constexpr const wchar_t* const VIDEO_DISCONTINUITY = L"ssdk::video::VIDEO_DISCONTINUITY";    // bool: property set on the first frame after a PTS discontinuity
     constexpr const wchar_t* const ORIGIN_PTS_PROPERTY = L"amd.ssdk.video.OriginPTS";            // amf_pts
     constexpr const wchar_t* const STREAM_ID_PROPERTY = L"StreamID";                             // int 64
+    constexpr const wchar_t* const VIDEO_DIRTY_RECTS = L"amd.ssdk.video.DirtyRects";            // AMFBuffer of AMFRect: regions changed since the previous frame, set by capture sources that track them
+    constexpr const wchar_t* const VIDEO_KEY_FRAME = L"amd.ssdk.video.KeyFrame";                 // bool: set on every slice of a sliced key frame, only the last slice carries the frame type
 
     constexpr const wchar_t* const VIDEO_CLIENT_LATENCY_PTS = L"ClientLatencyPts";                  // amf_int64
     constexpr const wchar_t* const VIDEO_ENCODER_IN_PTS = L"EncoderInPts";                          // amf_pts
@@ -0,0 +1,276 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "FrameChangeDetector.h"
+#include "Defines.h"
+
+#include "amf/public/include/core/Buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SSDK_TILE_HASH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace ssdk::video
+{
+    //  Tiles are hashed with 4 independent 64-bit lanes consuming 32 bytes per step, using a 32x32->64 multiply-accumulate
+    //  round. The lanes have no dependencies between each other within a step, and the round maps onto the widening multiply
+    //  available in every SIMD instruction set (SSE2 pmuludq, AVX2 vpmuludq, NEON umull), so a tile's state stays in vector registers.
+    static constexpr size_t HASH_LANES = 4;
+    static constexpr size_t HASH_STEP = HASH_LANES * sizeof(uint64_t);
+    alignas(16) static constexpr uint64_t HASH_KEYS[HASH_LANES] = { 0xBE4BA423396CFEB8ULL, 0x1CAD21F72C81017CULL, 0xDB979083E96DD4DEULL, 0x1F67B3B7A4A44072ULL };
+    static constexpr uint64_t HASH_PRIME = 0x9E3779B185EBCA87ULL;
+
+    struct alignas(32) TileHashState
+    {
+        uint64_t lanes[HASH_LANES];
+    };
+
+    static inline void InitTileHash(TileHashState& state) noexcept
+    {
+        for (size_t i = 0; i < HASH_LANES; ++i)
+        {
+            state.lanes[i] = HASH_KEYS[i];
+        }
+    }
+
+    static inline void UpdateTileHash(TileHashState& state, const uint8_t* data, size_t size) noexcept
+    {
+        size_t offset = 0;
+#if defined(SSDK_TILE_HASH_SSE2)
+        //  Same round as the portable loop below, spelled out because compilers do not reliably turn the lane swap into a shuffle
+        const __m128i key0 = _mm_load_si128(reinterpret_cast<const __m128i*>(&HASH_KEYS[0]));
+        const __m128i key1 = _mm_load_si128(reinterpret_cast<const __m128i*>(&HASH_KEYS[2]));
+        __m128i acc0 = _mm_load_si128(reinterpret_cast<const __m128i*>(&state.lanes[0]));
+        __m128i acc1 = _mm_load_si128(reinterpret_cast<const __m128i*>(&state.lanes[2]));
+        for (; offset + HASH_STEP <= size; offset += HASH_STEP)
+        {
+            __m128i input0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+            __m128i input1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset + 16));
+            __m128i keyed0 = _mm_xor_si128(input0, key0);
+            __m128i keyed1 = _mm_xor_si128(input1, key1);
+            acc0 = _mm_add_epi64(acc0, _mm_add_epi64(_mm_shuffle_epi32(input0, 0x4E), _mm_mul_epu32(keyed0, _mm_srli_epi64(keyed0, 32))));
+            acc1 = _mm_add_epi64(acc1, _mm_add_epi64(_mm_shuffle_epi32(input1, 0x4E), _mm_mul_epu32(keyed1, _mm_srli_epi64(keyed1, 32))));
+        }
+        _mm_store_si128(reinterpret_cast<__m128i*>(&state.lanes[0]), acc0);
+        _mm_store_si128(reinterpret_cast<__m128i*>(&state.lanes[2]), acc1);
+#endif
+        TileHashState acc = state;  //  Keep the accumulators in registers for the duration of the row segment
+        for (; offset + HASH_STEP <= size; offset += HASH_STEP)
+        {
+            uint64_t input[HASH_LANES];
+            memcpy(input, data + offset, HASH_STEP);
+            for (size_t i = 0; i < HASH_LANES; ++i)
+            {
+                uint64_t keyed = input[i] ^ HASH_KEYS[i];
+                acc.lanes[i] += input[i ^ 1] + (keyed & 0xFFFFFFFFULL) * (keyed >> 32);
+            }
+        }
+        for (; offset < size; ++offset)  //  Tail of an edge tile narrower than a hash step
+        {
+            acc.lanes[offset % HASH_LANES] = (acc.lanes[offset % HASH_LANES] ^ data[offset]) * HASH_PRIME;
+        }
+        state = acc;
+    }
+
+    static inline uint64_t FinalizeTileHash(const TileHashState& state) noexcept
+    {
+        uint64_t hash = 0;
+        for (size_t i = 0; i < HASH_LANES; ++i)
+        {
+            hash = (hash ^ state.lanes[i]) * HASH_PRIME;
+            hash ^= hash >> 29;
+        }
+        return hash;
+    }
+
+    void FrameChangeDetector::HashTiles(const uint8_t* data, size_t widthInBytes, size_t height, size_t pitch,
+                                        size_t tileWidthInBytes, size_t tileHeight, std::vector<uint64_t>& hashes)
+    {
+        if (data == nullptr || widthInBytes == 0 || height == 0 || tileWidthInBytes == 0 || tileHeight == 0)
+        {
+            return;
+        }
+        size_t tilesPerRow = (widthInBytes + tileWidthInBytes - 1) / tileWidthInBytes;
+        std::vector<TileHashState> states(tilesPerRow);
+        //  Walk the plane row by row so that memory is read sequentially, feeding each row segment to its tile's hash
+        for (size_t bandTop = 0; bandTop < height; bandTop += tileHeight)
+        {
+            for (TileHashState& state : states)
+            {
+                InitTileHash(state);
+            }
+            size_t bandBottom = std::min(bandTop + tileHeight, height);
+            for (size_t y = bandTop; y < bandBottom; ++y)
+            {
+                const uint8_t* row = data + y * pitch;
+                for (size_t tile = 0; tile < tilesPerRow; ++tile)
+                {
+                    size_t offset = tile * tileWidthInBytes;
+                    UpdateTileHash(states[tile], row + offset, std::min(tileWidthInBytes, widthInBytes - offset));
+                }
+            }
+            for (const TileHashState& state : states)
+            {
+                hashes.push_back(FinalizeTileHash(state));
+            }
+        }
+    }
+
+    void FrameChangeDetector::SetParams(const Params& params)
+    {
+        m_Params = params;
+        m_Params.tileSize = std::max(m_Params.tileSize, 8U);
+        m_Params.idleFramerate = std::max(m_Params.idleFramerate, 0.0f);
+        Reset();
+    }
+
+    void FrameChangeDetector::Reset() noexcept
+    {
+        m_ForceChange = true;
+        m_TileHashes.clear();
+    }
+
+    FrameChangeDetector::Decision FrameChangeDetector::Evaluate(amf::AMFSurface* surface, amf_pts now)
+    {
+        Decision decision = Decision::SUBMIT;
+        if (m_Params.enabled == false || DetectChange(surface) == true)
+        {
+            m_RefinementFramesLeft = m_Params.refinementFrames;
+        }
+        else if (m_RefinementFramesLeft > 0)
+        {   //  Static content, but the encoder still gets a few frames to bring quality up
+            --m_RefinementFramesLeft;
+        }
+        else if (m_Params.idleFramerate > 0 && now - m_LastSubmitTime >= amf_pts(AMF_SECOND / m_Params.idleFramerate))
+        {
+            decision = Decision::REPEAT;
+        }
+        else
+        {
+            decision = Decision::SKIP;
+        }
+        if (decision != Decision::SKIP)
+        {
+            m_LastSubmitTime = now;
+        }
+        return decision;
+    }
+
+    bool FrameChangeDetector::DetectChange(amf::AMFSurface* surface)
+    {
+        bool changed = true;
+        m_ChangedTiles = 0;
+        m_Inspecting = true;
+        amf::AMFVariant dirtyRects;
+        if (surface->GetProperty(VIDEO_DIRTY_RECTS, &dirtyRects) == AMF_OK && dirtyRects.type == amf::AMF_VARIANT_INTERFACE)
+        {   //  The capture source tracks damage itself, trust it
+            amf::AMFBufferPtr rects(amf::AMFInterfacePtr(dirtyRects.pInterface));
+            m_ChangedTiles = rects != nullptr ? rects->GetSize() / sizeof(AMFRect) : 1;
+            changed = m_ChangedTiles > 0 || m_ForceChange == true;
+        }
+        else if (surface->GetMemoryType() == amf::AMF_MEMORY_HOST)
+        {
+            changed = CompareTiles(surface);
+        }
+        else if (m_Params.hashVideoMemory == true)
+        {   //  The original stays in video memory for the converter and the encoder
+            amf::AMFDataPtr hostCopy;
+            amf::AMFSurfacePtr hostSurface;
+            if (surface->Duplicate(amf::AMF_MEMORY_HOST, &hostCopy) == AMF_OK && (hostSurface = amf::AMFSurfacePtr(hostCopy)) != nullptr)
+            {
+                changed = CompareTiles(hostSurface);
+            }
+            else
+            {
+                m_Inspecting = false;
+            }
+        }
+        else
+        {
+            m_Inspecting = false;
+        }
+        m_ForceChange = false;
+        return changed;
+    }
+
+    bool FrameChangeDetector::CompareTiles(amf::AMFSurface* surface)
+    {
+        bool changed = true;
+        m_NewTileHashes.clear();
+        if (HashSurface(surface, m_NewTileHashes) == true)
+        {
+            if (m_NewTileHashes.size() != m_TileHashes.size())
+            {
+                m_ChangedTiles = m_NewTileHashes.size();
+            }
+            else
+            {
+                for (size_t i = 0; i < m_NewTileHashes.size(); ++i)
+                {
+                    m_ChangedTiles += m_NewTileHashes[i] != m_TileHashes[i] ? 1 : 0;
+                }
+            }
+            std::swap(m_TileHashes, m_NewTileHashes);
+            changed = m_ChangedTiles > 0 || m_ForceChange == true;
+        }
+        else
+        {
+            m_Inspecting = false;
+        }
+        return changed;
+    }
+
+    bool FrameChangeDetector::HashSurface(amf::AMFSurface* surface, std::vector<uint64_t>& hashes) const
+    {
+        size_t planeCount = surface->GetPlanesCount();
+        for (size_t i = 0; i < planeCount; ++i)
+        {
+            amf::AMFPlane* plane = surface->GetPlaneAt(i);
+            const uint8_t* data = plane != nullptr ? static_cast<const uint8_t*>(plane->GetNative()) : nullptr;
+            if (data == nullptr)
+            {
+                return false;
+            }
+            size_t pixelSize = size_t(plane->GetPixelSizeInBytes());
+            HashTiles(data + plane->GetOffsetY() * plane->GetHPitch() + plane->GetOffsetX() * pixelSize,
+                      size_t(plane->GetWidth()) * pixelSize, size_t(plane->GetHeight()), size_t(plane->GetHPitch()),
+                      m_Params.tileSize * pixelSize, m_Params.tileSize, hashes);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,99 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#include "amf/public/include/core/Surface.h"
+
+#include <vector>
+
+namespace ssdk::video
+{
+    //  FrameChangeDetector: decides whether a captured frame differs from the previously submitted one so that
+    //  unchanged desktop frames can be kept away from the encoder. Changes are detected from dirty rectangles
+    //  attached by the capture source (VIDEO_DIRTY_RECTS) when present, otherwise by hashing the surface in tiles.
+    //  Surfaces in video memory are only hashed with Params::hashVideoMemory set, which downloads every frame to host memory.
+    //  Surfaces that can be inspected neither way are always treated as changed, see IsInspecting().
+    class FrameChangeDetector
+    {
+    public:
+        enum class Decision
+        {
+            SUBMIT,     //  Content changed or is still being refined, encode the frame
+            REPEAT,     //  Content is static, but the idle frame rate floor requires a frame to be sent
+            SKIP        //  Content is static, do not encode the frame
+        };
+
+        class Params
+        {
+        public:
+            bool        enabled = false;
+            float       idleFramerate = 1.0f;       //  Minimum frame rate maintained while the content is static, 0 - send nothing while static
+            uint32_t    refinementFrames = 8;       //  Number of frames still encoded after the last change to let the encoder refine quality
+            uint32_t    tileSize = 64;              //  Tile width and height in pixels
+            bool        hashVideoMemory = false;    //  Download surfaces in video memory without dirty rectangles to hash them
+        };
+
+    public:
+        FrameChangeDetector() = default;
+
+        void SetParams(const Params& params);
+        inline const Params& GetParams() const noexcept { return m_Params; }
+
+        Decision Evaluate(amf::AMFSurface* surface, amf_pts now);
+        void Reset() noexcept;      //  Treat the next frame as changed, i.e. after reinitialization or a key frame
+
+        inline size_t GetChangedTileCount() const noexcept { return m_ChangedTiles; }
+        inline bool IsInspecting() const noexcept { return m_Inspecting; }     //  False when the last frame could not be inspected and was submitted as changed
+
+        //  Hashes a plane in tiles of tileWidthInBytes x tileHeight, appending one hash per tile to hashes in row-major order
+        static void HashTiles(const uint8_t* data, size_t widthInBytes, size_t height, size_t pitch,
+                              size_t tileWidthInBytes, size_t tileHeight, std::vector<uint64_t>& hashes);
+
+    private:
+        bool DetectChange(amf::AMFSurface* surface);
+        bool CompareTiles(amf::AMFSurface* surface);
+        bool HashSurface(amf::AMFSurface* surface, std::vector<uint64_t>& hashes) const;
+
+    private:
+        Params                  m_Params;
+        std::vector<uint64_t>   m_TileHashes;
+        std::vector<uint64_t>   m_NewTileHashes;
+        size_t                  m_ChangedTiles = 0;
+        bool                    m_Inspecting = true;
+        bool                    m_ForceChange = true;
+        uint32_t                m_RefinementFramesLeft = 0;
+        amf_pts                 m_LastSubmitTime = 0;
+    };
+}
@@ -35,6 +35,8 @@
 #include "decoders/UVDDecoderH264.h"
 #include "decoders/UVDDecoderHEVC.h"
 #include "decoders/UVDDecoderAV1.h"
+#include "decoders/NullVideoDecodeEngine.h"
+#include "util/trace/PipelineTrace.h"
 #include "amf/public/common/TraceAdapter.h"
 
 static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::video::MonoscopicVideoInput";
@@ -201,6 +203,10 @@ namespace ssdk::video
         {
             decoder = VideoDecodeEngine::Ptr(new UVDDecoderAV1(m_Context, m_HWInstance));
         }
+        else if (codecNameStr == CODEC_NULL)
+        {
+            decoder = VideoDecodeEngine::Ptr(new NullVideoDecodeEngine(m_Context));
+        }
         else
         {
             result = AMF_NOT_SUPPORTED;
@@ -215,6 +221,7 @@ namespace ssdk::video
         amf::AMFLock m_Lock(&m_Guard);
         AMF_RETURN_IF_FALSE(m_Decoder != nullptr, AMF_NOT_INITIALIZED, L"Video decoder has not be instantiated");
         AMF_RETURN_IF_FALSE(input != nullptr, AMF_INVALID_ARG, L"MonoscopicVideoInput::SubmitInput(): Video input cannot be NULL");
+        SSDK_TRACE_SPAN(DECODER_SUBMIT, ssdk::util::PipelineTrace::GetDataKey(input));
 
         amf::AMFLock m_LockInput(&m_InputGuard);
         if (discontinuity == true)
@@ -229,6 +236,7 @@ namespace ssdk::video
             result = m_Decoder->SubmitInput(m_InputQueue.front().m_Buffer, m_InputQueue.front().m_FrameType);
             if (result == AMF_OK || result == AMF_NEED_MORE_INPUT)
             {   //  Successfully submitted a frame to the decoder
+                SSDK_TRACE_BEGIN(DECODE, ssdk::util::PipelineTrace::GetDataKey(m_InputQueue.front().m_Buffer));
                 m_InputQueue.pop_front();
                 ++m_InputFrameCnt;
                 result = AMF_OK;
@@ -281,6 +289,7 @@ namespace ssdk::video
                             result = m_Decoder->SubmitInput(m_InputQueue.front().m_Buffer, m_InputQueue.front().m_FrameType);
                             if (result == AMF_OK || result == AMF_NEED_MORE_INPUT)
                             {   //  Successfully submitted a frame to the decoder
+                                SSDK_TRACE_BEGIN(DECODE, ssdk::util::PipelineTrace::GetDataKey(m_InputQueue.front().m_Buffer));
                                 m_InputQueue.pop_front();
                                 ++m_InputFrameCnt;
                             }
@@ -295,6 +304,8 @@ namespace ssdk::video
         }
         if (outputFrame != nullptr)
         {
+            SSDK_TRACE_END(DECODE, ssdk::util::PipelineTrace::GetDataKey(outputFrame));
+            SSDK_TRACE_SPAN(DECODER_OUTPUT, ssdk::util::PipelineTrace::GetDataKey(outputFrame));
             m_Sink.OnVideoFrame(outputFrame);
         }
     }
@@ -34,6 +34,7 @@
 #include "MonoscopicVideoOutput.h"
 #include "Defines.h"
 #include "transports/transport-common/Video.h"
+#include "util/trace/PipelineTrace.h"
 
 
 #include "amf/public/include/components/VideoConverter.h"
@@ -250,6 +251,19 @@ namespace ssdk::video
         return result;
     }
 
+    void MonoscopicVideoOutput::SetStaticContentDetection(const FrameChangeDetector::Params& params)
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_ChangeDetectorParams = params;
+        m_ChangeDetectorParamsUpdated = true;
+    }
+
+    FrameChangeDetector::Params MonoscopicVideoOutput::GetStaticContentDetection() const
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_ChangeDetectorParams;
+    }
+
     bool MonoscopicVideoOutput::IsKeyFrameRequested() noexcept
     {
         amf::AMFLock lock(&m_Guard);
@@ -263,6 +277,7 @@ namespace ssdk::video
         AMF_RESULT result = AMF_OK;
 
         bool needsCSC = false;
+        bool detectStaticContent = false;
         amf::AMFComponentPtr converter;
         amf::AMFDataPtr converterOutput;
         {
@@ -306,11 +321,23 @@ namespace ssdk::video
                 AMFTraceInfo(AMF_FACILITY, L"Video pipeline reinitialized, DCC: %s, EFC: %s, resolution %s, color primaries %s, input format %s",
                              bDCC == true ? L"yes" : L"no", needsCSC == false ? L"yes" : L"no",
                              resolutionChanged == true ? L"changed" : L"did not change", colorPrimariesChanged == true ? L"changed" : L"did not change", inputFormatChanged == true ? L"changed" : L"did not change");
+                m_ChangeDetector.Reset();
             }   //  Reinitialization successfull
             else
             {   //  No reinitialization necessary
                 needsCSC = m_NeedsCSC;   //  We only want to reinitialize under a lock, but not the actual submission
             }
+            if (m_ChangeDetectorParamsUpdated == true)
+            {
+                m_ChangeDetector.SetParams(m_ChangeDetectorParams);
+                m_ChangeDetectorParamsUpdated = false;
+                m_ChangeDetectorBlindReported = false;
+            }
+            detectStaticContent = m_ChangeDetectorParams.enabled;
+            if (m_ForceKeyFrame == true)
+            {
+                m_ChangeDetector.Reset();   //  A requested key frame must not be skipped
+            }
             converter = m_Converter;    //  Also saving a pointer to the converter in a local variable to avoid unnecessary locking, only using locals below.
                                         //  The encoder is always present because it's passed to a constructor, so no need to worry about it changing on the fly
 
@@ -335,6 +362,28 @@ namespace ssdk::video
             }
         }
 
+        if (detectStaticContent == true)
+        {   //  Frames are still counted above so that the encoder's frame rate reflects the capture rate rather than the idle rate
+            FrameChangeDetector::Decision decision = m_ChangeDetector.Evaluate(input, amf_high_precision_clock());
+            if (m_ChangeDetector.IsInspecting() == false && m_ChangeDetectorBlindReported == false)
+            {
+                AMFTraceWarning(AMF_FACILITY, L"Static content detection: captured frames are in video memory without dirty rectangles and hashVideoMemory is off, every frame is encoded");
+                m_ChangeDetectorBlindReported = true;
+            }
+            bool contentStatic = decision != FrameChangeDetector::Decision::SUBMIT;
+            if (contentStatic != m_ContentStatic)
+            {
+                AMFTraceDebug(AMF_FACILITY, L"Static content detection: content %s", contentStatic == true ? L"became static, idling" : L"changed, resuming");
+                m_ContentStatic = contentStatic;
+            }
+            if (decision == FrameChangeDetector::Decision::SKIP)
+            {
+                return AMF_OK;
+            }
+            //  REPEAT frames are submitted like any other: with the picture unchanged the encoder produces a near-empty
+            //  P-frame which keeps clients and QoS fed at the idle frame rate at a negligible bitrate
+        }
+
         input->SetProperty(ORIGIN_PTS_PROPERTY, originPts);
         input->SetProperty(VIDEO_IN_PTS, videoInPts);
         if (needsCSC == true && converter != nullptr)
@@ -344,6 +393,7 @@ namespace ssdk::video
             converter->SetProperty(AMF_VIDEO_CONVERTER_OUTPUT_HDR_METADATA, (res == AMF_OK) && (varBufMaster.type == amf::AMF_VARIANT_INTERFACE) ? varBufMaster : static_cast<amf::AMFInterface*>(nullptr));
 
             //  Do CSC/scaling to encoder's desired format and resolution:
+            SSDK_TRACE_SPAN(CONVERT, input->GetPts());
             amf::AMFDataPtr converterInput(input);
             result = converter->SubmitInput(converterInput);
             AMF_RETURN_IF_FAILED(result, L"Failed to submit a frame to video converter, result=%s", amf::AMFGetResultText(result));
@@ -369,6 +419,7 @@ namespace ssdk::video
                 AMFTraceInfo(AMF_FACILITY, L"Key/IDR frame requested from encoder");
             }
             //  Submit a frame to the encoder:
+            SSDK_TRACE_SPAN(ENCODER_SUBMIT, converterOutput->GetPts());
             do
             {
                 amf::AMFSurfacePtr encoderInput(converterOutput);
@@ -378,6 +429,7 @@ namespace ssdk::video
                 {
                 case AMF_OK:
                     m_FramesSubmitted++;
+                    SSDK_TRACE_BEGIN(ENCODE, converterOutput->GetPts());
                     break;
                 case AMF_INPUT_FULL:
                     amf_sleep(1);
@@ -450,6 +502,8 @@ namespace ssdk::video
         result = m_Encoder->QueryOutput(&compressedFrame, frameType);
         if (compressedFrame != nullptr)
         {   //  Encoder has produced some output - prepare and send the frame to all clients
+            SSDK_TRACE_END(ENCODE, compressedFrame->GetPts());
+            SSDK_TRACE_SPAN(ENCODER_OUTPUT, compressedFrame->GetPts());
             amf_pts originPts = 0;
             compressedFrame->GetProperty(ORIGIN_PTS_PROPERTY, &originPts);
             amf_pts encoderInPts = 0;
@@ -461,6 +515,11 @@ namespace ssdk::video
 
             transport_common::TransmittableVideoFrame frame(transport_common::TransmittableVideoFrame::ViewType::MONOSCOPIC, originPts, m_SequenceNumber++, false);
             frame.AddSubframe(frameType, compressedFrame);
+            bool keyFrame = false;
+            if (compressedFrame->GetProperty(VIDEO_KEY_FRAME, &keyFrame) == AMF_OK && keyFrame == true)
+            {
+                frame.SetKeyFrame(true);
+            }
 
 
             ssdk::util::QoS::VideoOutputStats videoOutputStats;
@@ -42,6 +42,7 @@
 
 #include "encoders/VideoEncodeEngine.h"
 #include "VideoTransmitterAdapter.h"
+#include "FrameChangeDetector.h"
 
 #include "amf/public/include/components/Component.h"
 #include "amf/public/common/Thread.h"
@@ -80,6 +81,11 @@ namespace ssdk::video
 
         inline bool IsEFCForcedOff() const noexcept { return m_ForceEFCOff; }
 
+        //  Static content detection: when enabled, frames identical to the previous one are not encoded, except for the
+        //  refinement frames following a change and the frames needed to maintain the idle frame rate
+        void SetStaticContentDetection(const FrameChangeDetector::Params& params);
+        FrameChangeDetector::Params GetStaticContentDetection() const;
+
     protected:
         AMF_RESULT InitializeEncoder(const AMFSize& streamResolution, int64_t bitrate, float frameRate, const ColorParameters& colorParams, int64_t intraRefreshPeriod);
         AMF_RESULT InitializeConverter(amf::AMF_SURFACE_FORMAT format, const AMFSize& inputResolution, const AMFSize& streamResolution, const ColorParameters& encoderInputColorParams);
@@ -153,5 +159,11 @@ namespace ssdk::video
         uint32_t                    m_FrameCnt = 0;
 
         bool                        m_ForceEFCOff = false;
+
+        FrameChangeDetector         m_ChangeDetector;           //  Only accessed from SubmitInput()
+        FrameChangeDetector::Params m_ChangeDetectorParams;
+        bool                        m_ChangeDetectorParamsUpdated = false;
+        bool                        m_ContentStatic = false;
+        bool                        m_ChangeDetectorBlindReported = false;
     };
 }
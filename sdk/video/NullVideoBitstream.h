@@ -0,0 +1,74 @@
+/*
+Notice Regarding Standards.  AMD does not provide a license or sublicense to
+any Intellectual Property Rights relating to any standards, including but not
+limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+(collectively, the "Media Technologies"). For clarity, you will pay any
+royalties due for such third party technologies, which may include the Media
+Technologies that are owed as a result of AMD providing the Software to you.
+
+This software uses libraries from the FFmpeg project under the LGPLv2.1.
+
+MIT license
+
+Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#pragma once
+
+#include <cstdint>
+
+namespace ssdk::video
+{
+    //  Bitstream produced by NullVideoEncodeEngine and consumed by NullVideoDecodeEngine.
+    //  Every slice starts with a NullVideoSliceHeader followed by filler bytes up to m_SliceSize, so a frame reassembled
+    //  from its slices can be walked and validated slice by slice. All fields are little-endian.
+    constexpr const uint32_t NULL_VIDEO_SLICE_MAGIC = 0x4C4C554E;       //  'NULL'
+    constexpr const uint32_t NULL_VIDEO_EXTRADATA_MAGIC = 0x5844564E;   //  'NVDX'
+    constexpr const uint32_t NULL_VIDEO_BITSTREAM_VERSION = 1;
+
+#pragma pack(push, 1)
+    struct NullVideoSliceHeader
+    {
+        uint32_t    m_Magic;
+        uint32_t    m_SliceSize;        //  Size of this slice in bytes, including the header
+        uint64_t    m_FrameNumber;
+        int64_t     m_Pts;              //  Frame pts, the same for all slices of a frame
+        int64_t     m_EncodeTime;       //  amf_high_precision_clock() when the frame was produced
+        uint16_t    m_SliceIndex;
+        uint16_t    m_SliceCount;
+        uint8_t     m_FrameType;        //  transport_common::VideoFrame::SubframeType of the whole frame
+        uint8_t     m_Reserved[3];
+    };
+
+    struct NullVideoExtraData
+    {
+        uint32_t    m_Magic;
+        uint32_t    m_Version;
+        int32_t     m_Width;
+        int32_t     m_Height;
+    };
+#pragma pack(pop)
+
+    constexpr const wchar_t* const NULL_VIDEO_FRAME_NUMBER = L"NullVideoFrameNumber";   //  int64: frame number embedded in the bitstream, set on decoded surfaces
+    constexpr const wchar_t* const NULL_VIDEO_ENCODE_TIME = L"NullVideoEncodeTime";     //  amf_pts: time the frame was produced by the encoder, set on decoded surfaces
+}
@@ -33,6 +33,7 @@
 
 #include "VideoDispatcher.h"
 #include "Defines.h"
+#include "util/trace/PipelineTrace.h"
 #include "amf/public/common/TraceAdapter.h"
 
 static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::video::VideoDispatcher";
@@ -108,6 +109,7 @@ namespace ssdk::video
                     inputFrame->SetProperty(ORIGIN_PTS_PROPERTY, frame.GetOriginPts());
                     inputFrame->SetProperty(STREAM_ID_PROPERTY, streamID);
                     inputFrame->SetProperty(VIDEO_CLIENT_LATENCY_PTS, amf_high_precision_clock());
+                    ssdk::util::PipelineTrace::SetDataKey(inputFrame, ssdk::util::PipelineTrace::GetKey());    //  Server PTS of the frame, carried through the decoder
                     AMF_RESULT result = pipeline->SubmitInput(inputFrame, subframeType, frame.IsDiscontinuity());
                     if (result != AMF_OK)
                     {
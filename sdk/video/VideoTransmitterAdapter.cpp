@@ -106,12 +106,20 @@ namespace ssdk::video
             amf::AMFLock lock(&m_Guard);
             sessions = m_SessionToInitIDMap;
             initID = m_InitID;
+            for (PacingBitrates::iterator it = m_PacingBitrates.begin(); it != m_PacingBitrates.end();)
+            {
+                it = sessions.find(it->first) == sessions.end() ? m_PacingBitrates.erase(it) : std::next(it);
+            }
         }
 
         transport_common::Result result = transport_common::Result::OK;
         for (auto it : sessions)
         {
-            if (it.second == initID)
+            if (m_QoS != nullptr)
+            {
+                UpdatePacing(it.first);
+            }
+            if (it.second == initID && (m_QoS == nullptr || m_QoS->ShouldSendFrame(it.first, frame) == true))
             {
                 transport_common::Result res = m_Transport->SendVideoFrame(it.first, m_StreamID, frame);
                 if (res != transport_common::Result::OK)
@@ -127,4 +135,22 @@ namespace ssdk::video
         }
         return result;
     }
+
+    void TransmitterAdapter::UpdatePacing(transport_common::SessionHandle session)
+    {
+        //  Sessions QoS delivers fewer frames to than the encoder produces are paced by the transport where it can,
+        //  otherwise the drop filter is all that keeps them from falling behind
+        int64_t bitrate = m_QoS->GetDeliveryBitrate(session);
+        {
+            amf::AMFLock lock(&m_Guard);
+            PacingBitrates::const_iterator found = m_PacingBitrates.find(session);
+            if (found != m_PacingBitrates.end() && found->second == bitrate)
+            {
+                return;
+            }
+            m_PacingBitrates[session] = bitrate;
+        }
+        transport_common::Result result = m_Transport->SetSessionPacing(session, bitrate);
+        m_QoS->SetSessionPaced(session, bitrate != 0 && result == transport_common::Result::OK);
+    }
 }
@@ -37,6 +37,7 @@
 #include "util/QoS/QoS.h"
 #include "transports/transport-common/ServerTransport.h"
 
+#include <map>
 #include <memory>
 
 namespace ssdk::video
@@ -57,6 +58,9 @@ namespace ssdk::video
 
         transport_common::Result SendInitToSession(transport_common::SessionHandle session);
 
+    protected:
+        void UpdatePacing(transport_common::SessionHandle session);
+
     protected:
         ssdk::util::QoS::Ptr    m_QoS;
         uint32_t                m_BitDepth = 0;
@@ -64,5 +68,8 @@ namespace ssdk::video
         AMFSize                 m_Resolution = {};
         bool                    m_Stereoscopic = false;
         bool                    m_Foveated = false;
+
+        typedef std::map<transport_common::SessionHandle, int64_t> PacingBitrates;
+        PacingBitrates          m_PacingBitrates;   //  Last delivery bitrate passed to the transport for every session
     };
 }
\ No newline at end of file
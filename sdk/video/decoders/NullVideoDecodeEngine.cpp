@@ -0,0 +1,190 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "NullVideoDecodeEngine.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#include <cstring>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::video::NullVideoDecodeEngine";
+
+//  Mimics the number of output surfaces a hardware decoder can hold before it stops accepting input
+static constexpr const size_t MAX_OUTPUT_QUEUE_DEPTH = 4;
+
+namespace ssdk::video
+{
+    NullVideoDecodeEngine::NullVideoDecodeEngine(amf::AMFContext* context) :
+        VideoDecodeEngine(context)
+    {
+    }
+
+    AMF_RESULT NullVideoDecodeEngine::Init(amf::AMF_SURFACE_FORMAT format, const AMFSize& resolution, float frameRate, amf::AMFBuffer* initBlock)
+    {
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Context != nullptr, AMF_NOT_INITIALIZED, L"NullVideoDecodeEngine::Init(): AMFContext must not be NULL");
+        if (initBlock != nullptr)
+        {
+            AMF_RETURN_IF_FALSE(initBlock->GetSize() >= sizeof(NullVideoExtraData), AMF_INVALID_ARG, L"NullVideoDecodeEngine::Init(): init block is too small (%llu bytes)", static_cast<unsigned long long>(initBlock->GetSize()));
+            const NullVideoExtraData* extraData = static_cast<const NullVideoExtraData*>(initBlock->GetNative());
+            AMF_RETURN_IF_FALSE(extraData->m_Magic == NULL_VIDEO_EXTRADATA_MAGIC, AMF_INVALID_ARG, L"NullVideoDecodeEngine::Init(): init block was not produced by the null video encoder");
+            AMF_RETURN_IF_FALSE(extraData->m_Version == NULL_VIDEO_BITSTREAM_VERSION, AMF_NOT_SUPPORTED, L"NullVideoDecodeEngine::Init(): unsupported bitstream version %u", extraData->m_Version);
+        }
+
+        m_Format = format;
+        m_Resolution = resolution;
+        m_FrameRate = frameRate;
+        m_OutputQueue.clear();
+        m_ExpectedFrameNumber = 0;
+        m_FramesDecoded = m_FramesLost = m_FramesCorrupt = 0;
+        m_Stats.Reset();
+        m_FirstFrameAfterInit = true;
+        m_Initialized = true;
+        AMFTraceInfo(AMF_FACILITY, L"Null video decoder initialized, format: %s, resolution: %dx%d", amf::AMFSurfaceGetFormatName(format), resolution.width, resolution.height);
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullVideoDecodeEngine::Terminate()
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_OutputQueue.clear();
+        m_Stats.Reset();
+        m_Initialized = false;
+        return AMF_OK;
+    }
+
+    const char* NullVideoDecodeEngine::GetCodecName() const noexcept
+    {
+        return CODEC_NULL;
+    }
+
+    bool NullVideoDecodeEngine::IsHDRSupported() const noexcept
+    {
+        return true;
+    }
+
+    uint64_t NullVideoDecodeEngine::GetFramesDecoded() const noexcept
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_FramesDecoded;
+    }
+
+    uint64_t NullVideoDecodeEngine::GetFramesLost() const noexcept
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_FramesLost;
+    }
+
+    uint64_t NullVideoDecodeEngine::GetFramesCorrupt() const noexcept
+    {
+        amf::AMFLock lock(&m_Guard);
+        return m_FramesCorrupt;
+    }
+
+    AMF_RESULT NullVideoDecodeEngine::SubmitFrame(amf::AMFBuffer* frame)
+    {
+        amf::AMFLock lock(&m_Guard);
+        if (m_OutputQueue.size() >= MAX_OUTPUT_QUEUE_DEPTH)
+        {
+            return AMF_INPUT_FULL;
+        }
+
+        NullVideoSliceHeader header = {};
+        if (ValidateFrame(frame, header) == false)
+        {   //  A hardware decoder would conceal the damage and carry on, so just drop the frame
+            ++m_FramesCorrupt;
+            return AMF_OK;
+        }
+        if (header.m_FrameNumber > m_ExpectedFrameNumber && m_FramesDecoded > 0)
+        {
+            m_FramesLost += header.m_FrameNumber - m_ExpectedFrameNumber;
+            AMFTraceDebug(AMF_FACILITY, L"Frames %llu to %llu were lost", static_cast<unsigned long long>(m_ExpectedFrameNumber), static_cast<unsigned long long>(header.m_FrameNumber - 1));
+        }
+        m_ExpectedFrameNumber = header.m_FrameNumber + 1;
+
+        amf::AMFSurfacePtr surface;
+        AMF_RESULT result = m_Context->AllocSurface(amf::AMF_MEMORY_HOST, m_Format, m_Resolution.width, m_Resolution.height, &surface);
+        AMF_RETURN_IF_FAILED(result, L"NullVideoDecodeEngine::SubmitFrame(): failed to allocate a %s %dx%d surface, result=%s", amf::AMFSurfaceGetFormatName(m_Format), m_Resolution.width, m_Resolution.height, amf::AMFGetResultText(result));
+        frame->CopyTo(surface, false);
+        surface->SetPts(frame->GetPts());
+        surface->SetDuration(frame->GetDuration());
+        surface->SetProperty(NULL_VIDEO_FRAME_NUMBER, static_cast<int64_t>(header.m_FrameNumber));
+        surface->SetProperty(NULL_VIDEO_ENCODE_TIME, header.m_EncodeTime);
+        m_OutputQueue.push_back(surface);
+        ++m_FramesDecoded;
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullVideoDecodeEngine::QueryFrame(amf::AMFData** output)
+    {
+        amf::AMFLock lock(&m_Guard);
+        if (m_OutputQueue.empty() == true)
+        {
+            return AMF_REPEAT;
+        }
+        *output = m_OutputQueue.front().Detach();
+        m_OutputQueue.pop_front();
+        return AMF_OK;
+    }
+
+    bool NullVideoDecodeEngine::ValidateFrame(amf::AMFBuffer* frame, NullVideoSliceHeader& firstSlice) const
+    {
+        const uint8_t* data = static_cast<const uint8_t*>(frame->GetNative());
+        size_t size = frame->GetSize();
+        size_t offset = 0;
+        uint16_t sliceCount = 0;
+        for (uint16_t sliceIdx = 0; sliceCount == 0 || sliceIdx < sliceCount; ++sliceIdx)
+        {
+            NullVideoSliceHeader header;
+            if (size - offset < sizeof(header))
+            {
+                AMFTraceWarning(AMF_FACILITY, L"Frame is truncated: %llu bytes, slice %u of %u is missing", static_cast<unsigned long long>(size), sliceIdx, sliceCount);
+                return false;
+            }
+            memcpy(&header, data + offset, sizeof(header));
+            if (header.m_Magic != NULL_VIDEO_SLICE_MAGIC || header.m_SliceSize < sizeof(header) || header.m_SliceSize > size - offset ||
+                header.m_SliceIndex != sliceIdx || header.m_SliceCount == 0 || (sliceCount != 0 && (header.m_SliceCount != sliceCount || header.m_FrameNumber != firstSlice.m_FrameNumber)))
+            {
+                AMFTraceWarning(AMF_FACILITY, L"Frame contains an invalid slice header at offset %llu", static_cast<unsigned long long>(offset));
+                return false;
+            }
+            if (sliceIdx == 0)
+            {
+                firstSlice = header;
+                sliceCount = header.m_SliceCount;
+            }
+            offset += header.m_SliceSize;
+        }
+        return true;
+    }
+}
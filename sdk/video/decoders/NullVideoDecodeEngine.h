@@ -0,0 +1,86 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include "VideoDecodeEngine.h"
+#include "../NullVideoBitstream.h"
+
+#include "amf/public/include/core/Surface.h"
+
+#include <deque>
+
+namespace ssdk::video
+{
+    //  Counterpart of NullVideoEncodeEngine: validates the synthetic bitstream and outputs a host memory surface
+    //  of the negotiated format and resolution for every frame. The frame number and the time the frame was produced
+    //  by the encoder are attached to the output surface as NULL_VIDEO_FRAME_NUMBER and NULL_VIDEO_ENCODE_TIME.
+    class NullVideoDecodeEngine : public VideoDecodeEngine
+    {
+    public:
+        NullVideoDecodeEngine(amf::AMFContext* context);
+
+        virtual AMF_RESULT Init(amf::AMF_SURFACE_FORMAT format, const AMFSize& resolution, float frameRate, amf::AMFBuffer* initBlock) override;
+        virtual AMF_RESULT Terminate() override;
+
+        virtual const char* GetCodecName() const noexcept override;
+
+        virtual bool IsHDRSupported() const noexcept override;
+
+        uint64_t GetFramesDecoded() const noexcept;
+        uint64_t GetFramesLost() const noexcept;
+        uint64_t GetFramesCorrupt() const noexcept;
+
+    protected:
+        virtual AMF_RESULT SubmitFrame(amf::AMFBuffer* frame) override;
+        virtual AMF_RESULT QueryFrame(amf::AMFData** output) override;
+
+        bool ValidateFrame(amf::AMFBuffer* frame, NullVideoSliceHeader& firstSlice) const;
+
+    private:
+        typedef std::deque<amf::AMFSurfacePtr>  OutputQueue;
+
+        OutputQueue             m_OutputQueue;
+        uint64_t                m_ExpectedFrameNumber = 0;
+        uint64_t                m_FramesDecoded = 0;
+        uint64_t                m_FramesLost = 0;
+        uint64_t                m_FramesCorrupt = 0;
+    };
+}
@@ -86,7 +86,6 @@ namespace ssdk::video
     AMF_RESULT VideoDecodeEngine::SubmitInput(amf::AMFBuffer* input, transport_common::VideoFrame::SubframeType frameType)
     {
         AMF_RESULT result = AMF_OK;
-        amf::AMFComponentPtr decoder;
         amf::AMFBufferPtr fullFrame;
 
         m_Stats.InputSubmitted(input->GetPts());
@@ -102,9 +101,7 @@ namespace ssdk::video
 
         {
             amf::AMFLock lock(&m_Guard);
-            AMF_RETURN_IF_FALSE(m_Decoder != nullptr, AMF_NOT_INITIALIZED, L"VideoDecodeEngine::SubmitFrame(): Video decoder has not been instantiated");
-            AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"VideoDecodeEngine::SubmitFrame(): Video decoder has not been initialized yet, submit the init block (SPS/PPS) first");
-            decoder = m_Decoder;
+            AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"VideoDecodeEngine::SubmitInput(): Video decoder has not been initialized yet, submit the init block (SPS/PPS) first");
         }
 
         {
@@ -160,7 +157,7 @@ namespace ssdk::video
                 }
                 else
                 {
-                    result = decoder->SubmitInput(fullFrame);
+                    result = SubmitFrame(fullFrame);
                     m_FirstFrameAfterInit = false;
                 }
             }
@@ -171,16 +168,13 @@ namespace ssdk::video
     AMF_RESULT VideoDecodeEngine::QueryOutput(amf::AMFSurface** output)
     {
         AMF_RESULT result = AMF_OK;
-        amf::AMFComponentPtr decoder;
         {
             amf::AMFLock lock(&m_Guard);
-            AMF_RETURN_IF_FALSE(m_Decoder != nullptr, AMF_NOT_INITIALIZED, L"VideoDecodeEngine::QueryOutput(): Video decoder has not been instantiated");
             AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"VideoDecodeEngine::QueryOutput(): Video decoder has not been initialized yet, submit the init block (SPS/PPS) first");
             AMF_RETURN_IF_FALSE(output != nullptr, AMF_INVALID_ARG, L"VideoDecodeEngine::QueryOutput(): Video decoder output should not be NULL");
-            decoder = m_Decoder;
         }
         amf::AMFDataPtr outData;
-        result = decoder->QueryOutput(&outData);
+        result = QueryFrame(&outData);
         if (outData != nullptr)
         {
             m_Stats.OutputObtained(outData->GetPts());
@@ -191,5 +185,25 @@ namespace ssdk::video
         return result;
     }
 
+    AMF_RESULT VideoDecodeEngine::SubmitFrame(amf::AMFBuffer* frame)
+    {
+        amf::AMFComponentPtr decoder;
+        {
+            amf::AMFLock lock(&m_Guard);
+            AMF_RETURN_IF_FALSE(m_Decoder != nullptr, AMF_NOT_INITIALIZED, L"VideoDecodeEngine::SubmitFrame(): Video decoder has not been instantiated");
+            decoder = m_Decoder;
+        }
+        return decoder->SubmitInput(frame);
+    }
 
+    AMF_RESULT VideoDecodeEngine::QueryFrame(amf::AMFData** output)
+    {
+        amf::AMFComponentPtr decoder;
+        {
+            amf::AMFLock lock(&m_Guard);
+            AMF_RETURN_IF_FALSE(m_Decoder != nullptr, AMF_NOT_INITIALIZED, L"VideoDecodeEngine::QueryFrame(): Video decoder has not been instantiated");
+            decoder = m_Decoder;
+        }
+        return decoder->QueryOutput(output);
+    }
 }
@@ -84,6 +84,12 @@ namespace ssdk::video
         AMF_RESULT SubmitInput(amf::AMFBuffer* input, transport_common::VideoFrame::SubframeType frameType);
         AMF_RESULT QueryOutput(amf::AMFSurface** output);
 
+    protected:
+        //  SubmitFrame() receives complete frames with all slices already combined, QueryFrame() returns decoded surfaces.
+        //  The defaults forward to the AMF decoder component, engines not backed by an AMF component override both.
+        virtual AMF_RESULT SubmitFrame(amf::AMFBuffer* frame);
+        virtual AMF_RESULT QueryFrame(amf::AMFData** output);
+
     protected:
         mutable amf::AMFCriticalSection     m_Guard;
         mutable amf::AMFCriticalSection     m_InputGuard;
@@ -0,0 +1,316 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#include "NullVideoEncodeEngine.h"
+#include "amf/public/common/TraceAdapter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cwchar>
+
+static constexpr const wchar_t* const AMF_FACILITY = L"ssdk::video::NullVideoEncodeEngine";
+
+//  Private surface property set by ForceKeyFrame()
+static constexpr const wchar_t* const NULL_VIDEO_ENCODER_FORCE_IDR = L"NullEncoderForceIDR";
+//  Mimics AMF_VIDEO_ENCODER_INPUT_QUEUE_SIZE used by the hardware encoders
+static constexpr const size_t MAX_QUEUED_FRAMES = 3;
+static constexpr const int64_t MAX_SLICES_PER_FRAME = 64;
+
+namespace ssdk::video
+{
+    NullVideoEncodeEngine::NullVideoEncodeEngine(amf::AMFContext* context) :
+        VideoEncodeEngine(context)
+    {
+        m_PreferredSDRFormat = amf::AMF_SURFACE_NV12;
+        m_PreferredHDRFormat = amf::AMF_SURFACE_P010;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::Init(const AMFSize& encoderResolution, int64_t bitrate, float frameRate, int64_t intraRefreshPeriod, const ColorParameters& inputColorParams, size_t instance)
+    {
+        AMF_RETURN_IF_FALSE(m_Context != nullptr, AMF_NOT_INITIALIZED, L"AMFContext passed to NullVideoEncodeEngine must not be NULL");
+        amf::AMFLock lock(&m_Guard);
+        VideoEncodeEngine::Init(encoderResolution, bitrate, frameRate, intraRefreshPeriod, inputColorParams, instance);
+        m_OutputQueue.clear();
+        m_FrameNumber = 0;
+        m_RandomGenerator.seed(static_cast<std::mt19937::result_type>(m_RandomSeed));
+        AMFTraceInfo(AMF_FACILITY, L"Null video encoder initialized, resolution: %dx%d, bitrate: %lld, frame rate: %5.2f, IDR period: %lld, IDR/P ratio: %5.2f, slices: %lld",
+            encoderResolution.width, encoderResolution.height, bitrate, double(frameRate), intraRefreshPeriod, m_IDRToPRatio, m_SlicesPerFrame);
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::SubmitInput(amf::AMFSurface* inputSurface)
+    {
+        AMF_RETURN_IF_INVALID_POINTER(inputSurface, L"NullVideoEncodeEngine::SubmitInput(): input surface must not be NULL");
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"NullVideoEncodeEngine::SubmitInput(): video encoder not initialized");
+
+        size_t slicesPerFrame = static_cast<size_t>(m_SlicesPerFrame);
+        if (m_OutputQueue.size() >= MAX_QUEUED_FRAMES * slicesPerFrame)
+        {
+            return AMF_INPUT_FULL;
+        }
+
+        bool idr = m_FrameNumber == 0 || (m_IntraRefreshPeriod > 0 && m_FrameNumber % m_IntraRefreshPeriod == 0);
+        bool forceIDR = false;
+        if (inputSurface->GetProperty(NULL_VIDEO_ENCODER_FORCE_IDR, &forceIDR) == AMF_OK && forceIDR == true)
+        {
+            idr = true;
+        }
+        transport_common::VideoFrame::SubframeType frameType = idr == true ? transport_common::VideoFrame::SubframeType::IDR : transport_common::VideoFrame::SubframeType::P;
+
+        size_t frameSize = CalculateFrameSize(idr);
+        size_t sliceSize = frameSize / slicesPerFrame;
+        amf_pts encodeTime = amf_high_precision_clock();
+        for (size_t i = 0; i < slicesPerFrame; ++i)
+        {
+            size_t curSliceSize = i < slicesPerFrame - 1 ? sliceSize : frameSize - sliceSize * i;
+            amf::AMFBufferPtr slice;
+            AMF_RESULT result = m_Context->AllocBuffer(amf::AMF_MEMORY_HOST, curSliceSize, &slice);
+            AMF_RETURN_IF_FAILED(result, L"NullVideoEncodeEngine::SubmitInput(): failed to allocate a %llu byte buffer, result=%s", static_cast<unsigned long long>(curSliceSize), amf::AMFGetResultText(result));
+
+            NullVideoSliceHeader header = {};
+            header.m_Magic = NULL_VIDEO_SLICE_MAGIC;
+            header.m_SliceSize = static_cast<uint32_t>(curSliceSize);
+            header.m_FrameNumber = m_FrameNumber;
+            header.m_Pts = inputSurface->GetPts();
+            header.m_EncodeTime = encodeTime;
+            header.m_SliceIndex = static_cast<uint16_t>(i);
+            header.m_SliceCount = static_cast<uint16_t>(slicesPerFrame);
+            header.m_FrameType = static_cast<uint8_t>(frameType);
+            uint8_t* data = static_cast<uint8_t*>(slice->GetNative());
+            memcpy(data, &header, sizeof(header));
+            memset(data + sizeof(header), 0, curSliceSize - sizeof(header));
+
+            //  Propagate the pipeline properties (origin pts, encoder input time, etc) the same way a hardware encoder does
+            inputSurface->CopyTo(slice, false);
+            slice->SetPts(inputSurface->GetPts());
+            slice->SetDuration(inputSurface->GetDuration());
+            slice->SetProperty(VIDEO_KEY_FRAME, idr);
+
+            //  Sliced frames are sent as a sequence of SLICE buffers with the last one marked with the type of the whole frame
+            m_OutputQueue.push_back({ slice, i < slicesPerFrame - 1 ? transport_common::VideoFrame::SubframeType::SLICE : frameType });
+        }
+        ++m_FrameNumber;
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::QueryOutput(amf::AMFBuffer** outputBuffer, transport_common::VideoFrame::SubframeType& frameType)
+    {
+        AMF_RETURN_IF_INVALID_POINTER(outputBuffer, L"NullVideoEncodeEngine::QueryOutput(): output must not be NULL");
+        amf::AMFLock lock(&m_Guard);
+        AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"NullVideoEncodeEngine::QueryOutput(): video encoder not initialized");
+        if (m_OutputQueue.empty() == true)
+        {
+            return AMF_REPEAT;
+        }
+        OutputSlice& slice = m_OutputQueue.front();
+        frameType = slice.m_Type;
+        *outputBuffer = slice.m_Buffer.Detach();
+        m_OutputQueue.pop_front();
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::Flush()
+    {
+        amf::AMFLock lock(&m_Guard);
+        m_OutputQueue.clear();
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::Drain()
+    {
+        //  Output is produced synchronously in SubmitInput(), there is nothing to drain
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::SetProperty(const wchar_t* name, const amf::AMFVariant& value)
+    {
+        AMF_RETURN_IF_INVALID_POINTER(name, L"NullVideoEncodeEngine::SetProperty(): property name must not be NULL");
+        amf::AMFLock lock(&m_Guard);
+        AMF_RESULT result = AMF_OK;
+        if (std::wcscmp(name, NULL_VIDEO_ENCODER_IDR_TO_P_RATIO) == 0)
+        {
+            double ratio = static_cast<double>(value);
+            AMF_RETURN_IF_FALSE(ratio >= 1.0, AMF_INVALID_ARG, L"%s must be at least 1, %5.2f specified", name, ratio);
+            m_IDRToPRatio = ratio;
+        }
+        else if (std::wcscmp(name, NULL_VIDEO_ENCODER_SLICES_PER_FRAME) == 0)
+        {
+            int64_t slices = static_cast<int64_t>(value);
+            AMF_RETURN_IF_FALSE(slices >= 1 && slices <= MAX_SLICES_PER_FRAME, AMF_INVALID_ARG, L"%s must be between 1 and %lld, %lld specified", name, MAX_SLICES_PER_FRAME, slices);
+            m_SlicesPerFrame = slices;
+        }
+        else if (std::wcscmp(name, NULL_VIDEO_ENCODER_SIZE_VARIANCE) == 0)
+        {
+            double variance = static_cast<double>(value);
+            AMF_RETURN_IF_FALSE(variance >= 0.0 && variance <= 1.0, AMF_INVALID_ARG, L"%s must be between 0 and 1, %5.2f specified", name, variance);
+            m_SizeVariance = variance;
+        }
+        else if (std::wcscmp(name, NULL_VIDEO_ENCODER_RANDOM_SEED) == 0)
+        {
+            m_RandomSeed = static_cast<int64_t>(value);
+            m_RandomGenerator.seed(static_cast<std::mt19937::result_type>(m_RandomSeed));
+        }
+        else
+        {
+            result = AMF_NOT_FOUND;
+        }
+        return result;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::GetProperty(const wchar_t* name, amf::AMFVariant& value) const
+    {
+        AMF_RETURN_IF_INVALID_POINTER(name, L"NullVideoEncodeEngine::GetProperty(): property name must not be NULL");
+        amf::AMFLock lock(&m_Guard);
+        AMF_RESULT result = AMF_OK;
+        if (std::wcscmp(name, NULL_VIDEO_ENCODER_IDR_TO_P_RATIO) == 0)
+        {
+            value = m_IDRToPRatio;
+        }
+        else if (std::wcscmp(name, NULL_VIDEO_ENCODER_SLICES_PER_FRAME) == 0)
+        {
+            value = m_SlicesPerFrame;
+        }
+        else if (std::wcscmp(name, NULL_VIDEO_ENCODER_SIZE_VARIANCE) == 0)
+        {
+            value = m_SizeVariance;
+        }
+        else if (std::wcscmp(name, NULL_VIDEO_ENCODER_RANDOM_SEED) == 0)
+        {
+            value = m_RandomSeed;
+        }
+        else
+        {
+            result = AMF_NOT_FOUND;
+        }
+        return result;
+    }
+
+    const char* NullVideoEncodeEngine::GetCodecName() const noexcept
+    {
+        return CODEC_NULL;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::GetNumOfEncoderInstances(size_t& numOfInstances) const
+    {
+        numOfInstances = 1;
+        return AMF_OK;
+    }
+
+    bool NullVideoEncodeEngine::IsFormatSupported(amf::AMF_SURFACE_FORMAT /*defaultFormat*/, bool /*hdr*/, amf::AMFSurface* /*pSurface*/) const
+    {
+        //  The pixels are never looked at, so any input can be submitted directly without a color space conversion
+        return true;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::UpdateBitrate(int64_t bitRate)
+    {
+        AMF_RETURN_IF_FALSE(bitRate > 0, AMF_INVALID_ARG, L"NullVideoEncodeEngine::UpdateBitrate(): invalid bitrate %lld", bitRate);
+        amf::AMFLock lock(&m_Guard);
+        m_Bitrate = bitRate;
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::UpdateFramerate(const AMFRate& rate)
+    {
+        AMF_RETURN_IF_FALSE(rate.num > 0 && rate.den > 0, AMF_INVALID_ARG, L"NullVideoEncodeEngine::UpdateFramerate(): invalid frame rate %u/%u", rate.num, rate.den);
+        amf::AMFLock lock(&m_Guard);
+        m_Framerate = float(rate.num) / float(rate.den);
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::GetExtraData(amf::AMFBuffer** pExtraData) const
+    {
+        AMF_RETURN_IF_FALSE(pExtraData != nullptr, AMF_INVALID_ARG, L"GetExtraData(pExtraData) parameter must not be NULL");
+        AMF_RETURN_IF_FALSE(m_Initialized == true, AMF_NOT_INITIALIZED, L"Encoder is not initialized");
+        AMF_RESULT result = m_Context->AllocBuffer(amf::AMF_MEMORY_HOST, sizeof(NullVideoExtraData), pExtraData);
+        AMF_RETURN_IF_FAILED(result, L"Failed to allocate extra data buffer, result=%s", amf::AMFGetResultText(result));
+        NullVideoExtraData* extraData = static_cast<NullVideoExtraData*>((*pExtraData)->GetNative());
+        extraData->m_Magic = NULL_VIDEO_EXTRADATA_MAGIC;
+        extraData->m_Version = NULL_VIDEO_BITSTREAM_VERSION;
+        extraData->m_Width = m_Resolution.width;
+        extraData->m_Height = m_Resolution.height;
+        return AMF_OK;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::ForceKeyFrame(amf::AMFData* pSurface, bool bSet)
+    {
+        AMF_RETURN_IF_INVALID_POINTER(pSurface, L"NullVideoEncodeEngine::ForceKeyFrame(): surface must not be NULL");
+        return pSurface->SetProperty(NULL_VIDEO_ENCODER_FORCE_IDR, bSet);
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::DetermineFrameType(amf::AMFBuffer* buffer, transport_common::VideoFrame::SubframeType& frameType) const
+    {
+        AMF_RETURN_IF_INVALID_POINTER(buffer, L"NullVideoEncodeEngine::DetermineFrameType(): buffer must not be NULL");
+        AMF_RETURN_IF_FALSE(buffer->GetSize() >= sizeof(NullVideoSliceHeader), AMF_INVALID_DATA_TYPE, L"Buffer is too small to contain a slice header");
+        const NullVideoSliceHeader* header = static_cast<const NullVideoSliceHeader*>(buffer->GetNative());
+        AMF_RETURN_IF_FALSE(header->m_Magic == NULL_VIDEO_SLICE_MAGIC, AMF_INVALID_DATA_TYPE, L"Buffer does not contain a null video slice");
+        frameType = header->m_SliceIndex + 1 < header->m_SliceCount ? transport_common::VideoFrame::SubframeType::SLICE : static_cast<transport_common::VideoFrame::SubframeType>(header->m_FrameType);
+        return AMF_OK;
+    }
+
+    bool NullVideoEncodeEngine::IsHDRSupported() const noexcept
+    {
+        return true;
+    }
+
+    bool NullVideoEncodeEngine::IsHDREnabled() const noexcept
+    {
+        return m_HDR;
+    }
+
+    AMF_RESULT NullVideoEncodeEngine::EnableHDR(bool enable) noexcept
+    {
+        m_HDR = enable;
+        return AMF_OK;
+    }
+
+    size_t NullVideoEncodeEngine::CalculateFrameSize(bool idr)
+    {
+        double averageFrameSize = double(m_Bitrate) / 8.0 / double(m_Framerate > 0 ? m_Framerate : 60.0f);
+        //  Split the budget of an IDR period between one IDR and (period - 1) P frames so that the average still matches the bitrate
+        double pFrameSize = averageFrameSize;
+        if (m_IntraRefreshPeriod > 0)
+        {
+            pFrameSize = averageFrameSize * double(m_IntraRefreshPeriod) / (m_IDRToPRatio + double(m_IntraRefreshPeriod - 1));
+        }
+        double frameSize = idr == true ? pFrameSize * m_IDRToPRatio : pFrameSize;
+        if (m_SizeVariance > 0)
+        {
+            std::uniform_real_distribution<double> deviation(-m_SizeVariance, m_SizeVariance);
+            frameSize *= 1.0 + deviation(m_RandomGenerator);
+        }
+        return std::max(static_cast<size_t>(frameSize), sizeof(NullVideoSliceHeader) * static_cast<size_t>(m_SlicesPerFrame));
+    }
+}
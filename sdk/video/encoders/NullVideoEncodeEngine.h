@@ -0,0 +1,118 @@
+//
+// Notice Regarding Standards.  AMD does not provide a license or sublicense to
+// any Intellectual Property Rights relating to any standards, including but not
+// limited to any audio and/or video codec technologies such as MPEG-2, MPEG-4;
+// AVC/H.264; HEVC/H.265; AAC decode/FFMPEG; AAC encode/FFMPEG; VC-1; and MP3
+// (collectively, the "Media Technologies"). For clarity, you will pay any
+// royalties due for such third party technologies, which may include the Media
+// Technologies that are owed as a result of AMD providing the Software to you.
+//
+// MIT license
+//
+//
+// Copyright (c) 2018 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+
+
+#pragma once
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include "VideoEncodeEngine.h"
+#include "../NullVideoBitstream.h"
+
+#include "amf/public/common/Thread.h"
+
+#include <deque>
+#include <random>
+
+namespace ssdk::video
+{
+    //  Configuration properties, set through SetProperty() before or after Init():
+    constexpr const wchar_t* const NULL_VIDEO_ENCODER_IDR_TO_P_RATIO = L"NullEncoderIDRToPRatio";     //  double: size of an IDR frame relative to a P frame, default 8
+    constexpr const wchar_t* const NULL_VIDEO_ENCODER_SLICES_PER_FRAME = L"NullEncoderSlicesPerFrame"; //  int64: number of slices each frame is split into, default 1
+    constexpr const wchar_t* const NULL_VIDEO_ENCODER_SIZE_VARIANCE = L"NullEncoderSizeVariance";     //  double [0..1]: maximum random deviation of a frame size from its target, default 0.1
+    constexpr const wchar_t* const NULL_VIDEO_ENCODER_RANDOM_SEED = L"NullEncoderRandomSeed";         //  int64: seed for frame size deviation, default 0
+
+    //  A GPU-less video encoder which produces a synthetic bitstream of the same shape as a real encoder would:
+    //  frame sizes follow the target bitrate and frame rate and react to UpdateBitrate()/UpdateFramerate(),
+    //  IDR frames are emitted on the first frame, every intraRefreshPeriod frames and when forced,
+    //  and each frame carries its frame number, pts and production time for end-to-end latency measurements.
+    class NullVideoEncodeEngine : public VideoEncodeEngine
+    {
+    public:
+        NullVideoEncodeEngine(amf::AMFContext* context);
+
+        virtual AMF_RESULT Init(const AMFSize& encoderResolution, int64_t bitrate, float frameRate, int64_t intraRefreshPeriod, const ColorParameters& inputColorParams, size_t instance = 0) override;
+
+        virtual AMF_RESULT SubmitInput(amf::AMFSurface* inputSurface) override;
+        virtual AMF_RESULT QueryOutput(amf::AMFBuffer** outputBuffer, transport_common::VideoFrame::SubframeType& frameType) override;
+        virtual AMF_RESULT Flush() override;
+        virtual AMF_RESULT Drain() override;
+
+        virtual AMF_RESULT SetProperty(const wchar_t* name, const amf::AMFVariant& value) override;
+        virtual AMF_RESULT GetProperty(const wchar_t* name, amf::AMFVariant& value) const override;
+
+        virtual const char* GetCodecName() const noexcept override;
+
+        virtual AMF_RESULT GetNumOfEncoderInstances(size_t& numOfInstances) const override;
+
+        virtual bool IsFormatSupported(amf::AMF_SURFACE_FORMAT defaultFormat, bool hdr, amf::AMFSurface* pSurface) const override;
+
+        virtual AMF_RESULT UpdateBitrate(int64_t bitRate) override;
+        virtual AMF_RESULT UpdateFramerate(const AMFRate& rate) override;
+
+        virtual AMF_RESULT GetExtraData(amf::AMFBuffer** pExtraData) const override;
+        virtual AMF_RESULT ForceKeyFrame(amf::AMFData* pSurface, bool bSet) override;
+
+        virtual bool IsHDRSupported() const noexcept override;
+        virtual bool IsHDREnabled() const noexcept override;
+        virtual AMF_RESULT EnableHDR(bool enable) noexcept override;
+
+    protected:
+        virtual AMF_RESULT DetermineFrameType(amf::AMFBuffer* buffer, transport_common::VideoFrame::SubframeType& frameType) const override;
+
+        size_t CalculateFrameSize(bool idr);
+
+    private:
+        struct OutputSlice
+        {
+            amf::AMFBufferPtr                               m_Buffer;
+            transport_common::VideoFrame::SubframeType      m_Type;
+        };
+        typedef std::deque<OutputSlice>  OutputQueue;
+
+        mutable amf::AMFCriticalSection m_Guard;
+        OutputQueue             m_OutputQueue;
+        uint64_t                m_FrameNumber = 0;
+        bool                    m_HDR = false;
+
+        double                  m_IDRToPRatio = 8.0;
+        int64_t                 m_SlicesPerFrame = 1;
+        double                  m_SizeVariance = 0.1;
+        int64_t                 m_RandomSeed = 0;
+        std::mt19937            m_RandomGenerator;
+    };
+}
@@ -93,12 +93,12 @@ namespace ssdk::video
         void Terminate();
 
         virtual AMF_RESULT SubmitInput(amf::AMFSurface* inputSurface);
-        AMF_RESULT QueryOutput(amf::AMFBuffer** outputBuffer, transport_common::VideoFrame::SubframeType& frameType);
-        AMF_RESULT Flush();
-        AMF_RESULT Drain();
+        virtual AMF_RESULT QueryOutput(amf::AMFBuffer** outputBuffer, transport_common::VideoFrame::SubframeType& frameType);
+        virtual AMF_RESULT Flush();
+        virtual AMF_RESULT Drain();
 
-        AMF_RESULT SetProperty(const wchar_t* name, const amf::AMFVariant& value);
-        AMF_RESULT GetProperty(const wchar_t* name, amf::AMFVariant& value) const;
+        virtual AMF_RESULT SetProperty(const wchar_t* name, const amf::AMFVariant& value);
+        virtual AMF_RESULT GetProperty(const wchar_t* name, amf::AMFVariant& value) const;
 
         virtual const char* GetCodecName() const noexcept = 0;
 